@@ -0,0 +1,11 @@
+if(HAVE_IO_URING)
+    # Multishot receives (6.0 headers) imply provided buffer rings and the extended wait argument
+    include(CheckSymbolExists)
+    check_symbol_exists(IORING_RECV_MULTISHOT "linux/io_uring.h" IO_URING_EXISTS)
+    if(IO_URING_EXISTS)
+        add_definitions(-DHAVE_IO_URING=1)
+        message(STATUS "io_uring is available")
+    else()
+        message(STATUS "io_uring is not available")
+    endif()
+endif()
@@ -4,6 +4,7 @@ option(USE_ASAN "USE_ASAN" OFF)
 option(ASN_DEBUG "ASN_DEBUG" OFF)
 
 option(HAVE_SPLICE "Enable splice() system call for zero-copy data transfer" ON)
+option(HAVE_IO_URING "Compile in the io_uring scheduler backend if the headers support it" ON)
 
 option(INCLUDE_GENERATOR_RTCM "Include RTCM generator" ON)
 option(INCLUDE_GENERATOR_SPARTN "Include SPARTN generator" ON)
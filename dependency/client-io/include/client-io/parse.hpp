@@ -1,6 +1,7 @@
 #pragma once
 #include <io/serial.hpp>
 #include <io/stream.hpp>
+#include <io/stream/serial.hpp>
 
 #include <string>
 #include <unordered_map>
@@ -17,6 +18,8 @@ io::StopBits  parse_stopbits(std::string const& str);
 io::ParityBit parse_paritybit(std::string const& str);
 
 io::ReadBufferConfig parse_read_config(Options const& options);
+/// `low_latency` with `read_min_bytes` > 1 needs `read_timeout_ms` to read a trailing frame.
+void                 check_low_latency(io::SerialConfig const& config);
 
 std::vector<std::string> parse_list(std::string const& str, char delimiter = '+');
 
@@ -0,0 +1,22 @@
+#pragma once
+#include <format/helper/parser.hpp>
+#include <io/stream.hpp>
+
+// ParserReadTarget: lets a stream read straight into the free space of a parser buffer.
+//
+// The stream still passes every chunk to the read callbacks, as a pointer into the parser buffer.
+// That data is already appended, check `Parser::contains` before appending it again.
+class ParserReadTarget : public io::ReadTarget {
+public:
+    EXPLICIT ParserReadTarget(format::helper::Parser& parser) NOEXCEPT : mParser(parser) {}
+
+    size_t read_space(uint8_t*& data) NOEXCEPT override { return mParser.write_space(data); }
+    void   commit_read(size_t length) NOEXCEPT override {
+        mParser.commit(static_cast<uint32_t>(length));
+    }
+
+    NODISCARD format::helper::Parser& parser() const NOEXCEPT { return mParser; }
+
+private:
+    format::helper::Parser& mParser;
+};
@@ -11,6 +11,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 struct OutputInterface {
@@ -45,25 +46,110 @@ struct OutputInterface {
     NODISCARD inline bool raw_support() const { return (entry.format & OUTPUT_FORMAT_RAW) != 0; }
     NODISCARD inline bool test_support() const { return (entry.format & OUTPUT_FORMAT_TEST) != 0; }
 
+    /// `tag` is a message tag id, see `tags::TagRegistry::id`.
     NODISCARD inline bool accept_tag(uint64_t tag) const {
-        return tags::TagMask::filter(include_tag_mask, exclude_tag_mask, tags::Tag(tag));
+        return tags::TagMask::filter(include_tag_mask, exclude_tag_mask, tags::mask(tag));
     }
 
     NODISCARD inline std::string reject_reason(uint64_t tag) const {
-        if (include_tag_mask.value != 0 && !(include_tag_mask.value & tag))
+        auto mask = tags::mask(tag);
+        if (!include_tag_mask.empty() && !include_tag_mask.intersects(mask))
             return "not in itags=" + tags::to_string(include_tag_mask);
-        if (exclude_tag_mask.value & tag) return "in otags=" + tags::to_string(exclude_tag_mask);
+        if (exclude_tag_mask.intersects(mask))
+            return "in otags=" + tags::to_string(exclude_tag_mask);
         return "unknown";
     }
 
     NODISCARD inline std::string tag_name(uint64_t tag) const {
-        auto name = tags::to_string(tags::TagMask(tag));
+        auto name = tags::to_string(tags::mask(tag));
         return name.empty() ? "untagged" : name;
     }
 };
 
+/// Contiguous list of outputs that a message of a given format and tag should be written to. The
+/// route holds indices into the routing table, which grows when a new tag id is routed, so a route
+/// can be iterated while other routes are looked up. It is invalidated when the table is compiled
+/// again, i.e. when the outputs change.
+struct OutputRoute {
+    class Iterator {
+    public:
+        Iterator(std::vector<OutputInterface const*> const* targets, size_t index)
+            : mTargets(targets), mIndex(index) {}
+
+        NODISCARD OutputInterface const* operator*() const { return (*mTargets)[mIndex]; }
+        Iterator&                        operator++() {
+            mIndex++;
+            return *this;
+        }
+        NODISCARD bool operator==(Iterator const& other) const { return mIndex == other.mIndex; }
+        NODISCARD bool operator!=(Iterator const& other) const { return mIndex != other.mIndex; }
+
+    private:
+        std::vector<OutputInterface const*> const* mTargets;
+        size_t                                     mIndex;
+    };
+
+    std::vector<OutputInterface const*> const* targets;
+    size_t                                     first;
+    size_t                                     last;
+
+    NODISCARD Iterator begin() const { return Iterator{targets, first}; }
+    NODISCARD Iterator end() const { return Iterator{targets, last}; }
+    NODISCARD bool     empty() const { return first == last; }
+    NODISCARD size_t   size() const { return last - first; }
+};
+
+/// Routing table from (output format, message tag id) to the outputs that accept it. The outputs
+/// supporting each format are collected once when the table is compiled. The tag filter of those
+/// candidates is evaluated the first time a tag id is seen, after that routing a message is a
+/// lookup of the id followed by an array index with the format, whatever the number of tags.
+class OutputRouter {
+public:
+    static constexpr size_t FORMAT_SLOTS = 64;
+
+    OutputRouter() : mOutputs(nullptr), mCompiledCount(0), mLastTag(0), mLastSlot(SIZE_MAX) {}
+
+    void compile(std::vector<OutputInterface> const& outputs);
+    NODISCARD bool compiled_for(std::vector<OutputInterface> const& outputs) const {
+        return mOutputs == &outputs && mCompiledCount == outputs.size();
+    }
+
+    NODISCARD OutputRoute route(OutputFormat format, uint64_t tag);
+
+private:
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    size_t resolve(uint64_t tag);
+
+    std::vector<OutputInterface> const*              mOutputs;
+    size_t                                           mCompiledCount;
+    std::vector<std::vector<OutputInterface const*>> mCandidates;
+    std::vector<OutputInterface const*>              mTargets;
+    std::vector<Range>                               mRanges;
+    std::unordered_map<uint64_t, size_t>             mSlots;
+    uint64_t                                         mLastTag;
+    size_t                                           mLastSlot;
+};
+
 struct ProgramOutput {
     std::vector<OutputInterface> outputs;
+
+    /// Build the routing table, call once all outputs have been configured.
+    void compile_routes() { mRouter.compile(outputs); }
+
+    /// Outputs accepting `format` messages with `tag`. The routing table is (re)compiled on first
+    /// use if `compile_routes` was not called or the outputs changed since, routes returned before
+    /// that must not be used anymore.
+    NODISCARD OutputRoute route(OutputFormat format, uint64_t tag) const {
+        if (!mRouter.compiled_for(outputs)) mRouter.compile(outputs);
+        return mRouter.route(format, tag);
+    }
+
+private:
+    mutable OutputRouter mRouter;
 };
 
 struct InputInterface {
@@ -15,6 +15,8 @@ public:
     NODISCARD bool cancel() NOEXCEPT;
 
     virtual void write(OutputFormat format, uint8_t const* buffer, size_t length) NOEXCEPT = 0;
+    /// Called after the last message of a generated batch (an epoch) has been written.
+    virtual void end_epoch() NOEXCEPT {}
 
 protected:
     NODISCARD virtual bool do_schedule(scheduler::Scheduler&) NOEXCEPT { return true; }
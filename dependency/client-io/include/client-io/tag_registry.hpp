@@ -1,64 +1,86 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #ifndef TAG_MAX_COUNT
-#define TAG_MAX_COUNT 64
+#define TAG_MAX_COUNT 256
 #endif
 
 namespace tags {
 
-struct Tag {
-#if TAG_MAX_COUNT <= 64
-    uint64_t value;
-    Tag() : value(0) {}
-    explicit Tag(uint64_t v) : value(v) {}
-    operator uint64_t() const { return value; }
-    bool operator==(Tag other) const { return value == other.value; }
-    bool operator!=(Tag other) const { return value != other.value; }
-#else
-#error "TAG_MAX_COUNT > 64 not yet implemented"
-#endif
-};
+static constexpr size_t TAG_WORDS = (TAG_MAX_COUNT + 63) / 64;
 
+/// Set of tags, one bit per registered tag. A single tag is a mask with one bit set.
+///
+/// Messages do not carry the mask through streamline, they carry a `uint64_t` tag id (see
+/// `TagRegistry::id`) so the number of tags is not limited by the width of the id.
 struct TagMask {
-#if TAG_MAX_COUNT <= 64
-    uint64_t value;
-    TagMask() : value(0) {}
-    explicit TagMask(uint64_t v) : value(v) {}
-    explicit TagMask(Tag tag) : value(tag.value) {}
-    operator uint64_t() const { return value; }
-
-    TagMask  operator|(TagMask other) const { return TagMask(value | other.value); }
-    TagMask  operator&(TagMask other) const { return TagMask(value & other.value); }
-    TagMask& operator|=(TagMask other) {
-        value |= other.value;
-        return *this;
+    uint64_t words[TAG_WORDS];
+
+    TagMask() : words{} {}
+
+    static TagMask bit(size_t index) {
+        TagMask mask;
+        mask.words[index / 64] = 1llu << (index % 64);
+        return mask;
     }
-    TagMask& operator&=(TagMask other) {
-        value &= other.value;
-        return *this;
+
+    bool empty() const {
+        for (auto word : words)
+            if (word) return false;
+        return true;
     }
-    bool operator==(TagMask other) const { return value == other.value; }
-    bool operator!=(TagMask other) const { return value != other.value; }
 
-    TagMask  operator|(Tag tag) const { return TagMask(value | tag.value); }
-    TagMask& operator|=(Tag tag) {
-        value |= tag.value;
+    bool intersects(TagMask const& other) const {
+        for (size_t i = 0; i < TAG_WORDS; i++)
+            if (words[i] & other.words[i]) return true;
+        return false;
+    }
+
+    TagMask operator|(TagMask const& other) const {
+        TagMask result = *this;
+        result |= other;
+        return result;
+    }
+    TagMask operator&(TagMask const& other) const {
+        TagMask result = *this;
+        result &= other;
+        return result;
+    }
+    TagMask operator~() const {
+        TagMask result;
+        for (size_t i = 0; i < TAG_WORDS; i++)
+            result.words[i] = ~words[i];
+        return result;
+    }
+    TagMask& operator|=(TagMask const& other) {
+        for (size_t i = 0; i < TAG_WORDS; i++)
+            words[i] |= other.words[i];
         return *this;
     }
+    TagMask& operator&=(TagMask const& other) {
+        for (size_t i = 0; i < TAG_WORDS; i++)
+            words[i] &= other.words[i];
+        return *this;
+    }
+    bool operator==(TagMask const& other) const {
+        for (size_t i = 0; i < TAG_WORDS; i++)
+            if (words[i] != other.words[i]) return false;
+        return true;
+    }
+    bool operator!=(TagMask const& other) const { return !(*this == other); }
 
-    static bool filter(TagMask include, TagMask exclude, Tag tag) {
-        return tag.value == 0 || (((include.value & tag.value) || include.value == 0) &&
-                                  !(exclude.value & tag.value));
+    static bool filter(TagMask const& include, TagMask const& exclude, TagMask const& tag) {
+        return tag.empty() ||
+               ((include.empty() || include.intersects(tag)) && !exclude.intersects(tag));
     }
-#else
-#error "TAG_MAX_COUNT > 64 not yet implemented"
-#endif
 };
 
+using Tag = TagMask;
+
 struct TagInfo {
     std::string              name;
     std::string              description;
@@ -69,7 +91,7 @@ struct TagInfo {
 
 class TagRegistry {
 public:
-    TagRegistry() : mNextBitMask(1) {}
+    TagRegistry() : mNextBit(0), mIdMasks(1) {}
 
     void register_tag(std::string const& name, std::string const& description,
                       std::string const& category = "general");
@@ -79,7 +101,12 @@ public:
     Tag     get_tag(std::string const& name) const;
     TagMask get_tag(std::vector<std::string> const& names) const;
 
-    std::string mask_to_string(TagMask mask) const;
+    /// Id of a set of tags, the same set always gets the same id and the empty set is 0. Ids are
+    /// assigned when the program is configured, resolving them back with `mask` is an index.
+    uint64_t id(TagMask const& mask);
+    TagMask  mask(uint64_t id) const;
+
+    std::string mask_to_string(TagMask const& mask) const;
 
     bool exists(std::string const& name) const;
 
@@ -91,10 +118,11 @@ public:
 private:
     std::string resolve_alias(std::string const& name) const;
 
-    uint64_t                                     mNextBitMask;
+    size_t                                       mNextBit;
     std::unordered_map<std::string, TagInfo>     mTags;
     std::unordered_map<std::string, Tag>         mNameToMask;
     std::unordered_map<std::string, std::string> mAliases;
+    std::vector<TagMask>                         mIdMasks;
 };
 
 TagRegistry& registry();
@@ -108,7 +136,11 @@ Tag get(std::string const& name);
 
 TagMask get(std::vector<std::string> const& names);
 
-std::string to_string(TagMask mask);
+uint64_t id(TagMask const& mask);
+
+TagMask mask(uint64_t id);
+
+std::string to_string(TagMask const& mask);
 
 bool exists(std::string const& name);
 
@@ -1,19 +1,25 @@
 #pragma once
 #include <client-io/input_format.hpp>
-#include <format/tbin/reader.hpp>
+#include <format/tbin/merger.hpp>
 #include <io/input.hpp>
 #include <scheduler/timeout.hpp>
 
 #include <functional>
-#include <queue>
 #include <string>
 #include <vector>
 
 // TbinInput: reads one or more .tbin files, delivers payload bytes in strict timestamp order.
 //
 // Each file has its own fixed format (from --input tbin:path=X,format=Y).
-// Multiple files are merged via a min-heap — messages are interleaved by timestamp.
+// Multiple files are merged by format::tbin::Merger, which reads ahead on a thread per file.
 // format_callback delivers each message with the format of the file it came from.
+//
+// Without realtime replay, up to BATCH_SIZE messages are delivered per scheduler tick and the
+// pending scheduler events are processed after each batch. In realtime mode all messages that are
+// due are delivered before waiting for the next one.
+//
+// With scheduler::VirtualClock enabled (and without realtime replay) the virtual time follows the
+// message timestamps, timers that are due expire before each message is delivered.
 class TbinInput : public io::Input {
 public:
     struct Source {
@@ -34,19 +40,16 @@ protected:
     NODISCARD bool do_cancel(scheduler::Scheduler&) NOEXCEPT override;
 
 private:
-    void deliver_next() NOEXCEPT;
+    static constexpr size_t BATCH_SIZE = 256;
 
-    struct Entry {
-        int64_t  timestamp_us;
-        uint32_t reader_index;
-        bool     operator>(Entry const& o) const { return timestamp_us > o.timestamp_us; }
-    };
+    void deliver_next() NOEXCEPT;
+    void deliver(size_t source, format::tbin::Message& msg) NOEXCEPT;
+    void complete() NOEXCEPT;
+    void drain() NOEXCEPT;
 
-    std::vector<format::tbin::Reader>                                   mReaders;
-    std::vector<format::tbin::Message>                                  mPending;
-    std::vector<InputFormat>                                            mFormats;
-    std::vector<int64_t>                                                mShifts;
-    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> mHeap;
+    format::tbin::Merger     mMerger;
+    std::vector<InputFormat> mFormats;
+    bool                     mOpen;
 
     bool    mRealtimeMode;
     int64_t mStopTimeUs       = 0;
@@ -1,22 +1,44 @@
 #pragma once
+#include <format/tbin/block.hpp>
+#include <format/tbin/writer.hpp>
+#include <io/output.hpp>
+
 #include <chrono>
 #include <cstring>
-#include <io/output.hpp>
 #include <memory>
 #include <string>
 #include <vector>
 
+// TbinOutput: wraps every written buffer in a TBIN record with the current time.
+//
+// Version 1 writes one record per buffer as it comes. Version 2 batches records into compressed
+// blocks that are written when full and when the output is cancelled, so it is meant for files
+// rather than live consumers.
+//
+// When appending to a file that already has a header (see `format::tbin::prepare_append`) pass
+// `has_header` so that no second header is written.
 class TbinOutput : public io::Output {
 public:
-    TbinOutput(std::unique_ptr<io::Output> inner, std::string const& stream_id) NOEXCEPT
+    TbinOutput(std::unique_ptr<io::Output> inner, std::string const& stream_id,
+               uint8_t version = format::tbin::VERSION_1, bool has_header = false) NOEXCEPT
         : mInner(std::move(inner)),
-          mHeaderWritten(false),
-          mStreamId(stream_id) {}
+          mHeaderWritten(has_header),
+          mStreamId(stream_id),
+          mVersion(version) {
+        if (mVersion == format::tbin::VERSION_2) {
+            mEncoder.reset(new format::tbin::BlockEncoder());
+        }
+    }
+
+    ~TbinOutput() NOEXCEPT override { flush(); }
 
     NODISCARD const char* name() const NOEXCEPT override { return "tbin"; }
 
     bool do_schedule(scheduler::Scheduler& s) NOEXCEPT override { return mInner->schedule(s); }
-    bool do_cancel(scheduler::Scheduler&) NOEXCEPT override { return mInner->cancel(); }
+    bool do_cancel(scheduler::Scheduler&) NOEXCEPT override {
+        flush();
+        return mInner->cancel();
+    }
 
     void write(uint8_t const* buffer, size_t length) NOEXCEPT override {
         if (!mHeaderWritten) {
@@ -30,15 +52,35 @@ public:
         auto ts  = static_cast<int64_t>(us);
         auto len = static_cast<uint32_t>(length);
 
-        // Write as single buffer to avoid TCP fragmentation
-        std::vector<uint8_t> frame(12 + length);
-        memcpy(frame.data(), &ts, 8);
-        memcpy(frame.data() + 8, &len, 4);
-        memcpy(frame.data() + 12, buffer, length);
-        mInner->write(frame.data(), frame.size());
+        if (mEncoder) {
+            mEncoder->add(ts, buffer, len);
+            if (mEncoder->full()) flush();
+            return;
+        }
+
+        // Write as single buffer to avoid TCP fragmentation, the frame buffer is reused
+        mFrame.resize(12 + length);
+        memcpy(mFrame.data(), &ts, 8);
+        memcpy(mFrame.data() + 8, &len, 4);
+        memcpy(mFrame.data() + 12, buffer, length);
+        mInner->write(mFrame.data(), mFrame.size());
+    }
+
+    void end_epoch() NOEXCEPT override { mInner->end_epoch(); }
+    void set_drop_policy(io::WriteBuffer::DropPolicy policy) NOEXCEPT override {
+        mInner->set_drop_policy(policy);
+    }
+    void record_output_latency(std::chrono::steady_clock::time_point read_time) NOEXCEPT override {
+        mInner->record_output_latency(read_time);
     }
 
 private:
+    void flush() NOEXCEPT {
+        if (!mEncoder || mEncoder->empty()) return;
+        auto& block = mEncoder->finish();
+        mInner->write(block.data(), block.size());
+    }
+
     void write_header() {
         uint8_t header[4 + 1 + 1 + 64];
         size_t  pos   = 0;
@@ -46,7 +88,7 @@ private:
         header[pos++] = 'B';
         header[pos++] = 'I';
         header[pos++] = 'N';
-        header[pos++] = 1;  // version
+        header[pos++] = mVersion;
         auto id_len   = std::min(mStreamId.size(), size_t{63});
         header[pos++] = static_cast<uint8_t>(id_len);
         memcpy(header + pos, mStreamId.data(), id_len);
@@ -54,7 +96,10 @@ private:
         mInner->write(header, pos);
     }
 
-    std::unique_ptr<io::Output> mInner;
-    bool                        mHeaderWritten;
-    std::string                 mStreamId;
+    std::unique_ptr<io::Output>                 mInner;
+    bool                                        mHeaderWritten;
+    std::string                                 mStreamId;
+    uint8_t                                     mVersion;
+    std::vector<uint8_t>                        mFrame;
+    std::unique_ptr<format::tbin::BlockEncoder> mEncoder;
 };
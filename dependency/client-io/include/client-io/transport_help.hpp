@@ -8,7 +8,8 @@
     "    baudrate=<baudrate>\n"                                                                    \
     "    databits=<5|6|7|8>\n"                                                                     \
     "    stopbits=<1|2>\n"                                                                         \
-    "    parity=<none|odd|even>\n"
+    "    parity=<none|odd|even>\n"                                                                 \
+    "    low_latency=<bool>\n"
 
 #define TRANSPORT_HELP_TCP_CLIENT                                                                  \
     "  tcp-client:\n"                                                                              \
@@ -27,13 +28,19 @@
     "  udp-client:\n"                                                                              \
     "    host=<host>\n"                                                                            \
     "    port=<port>\n"                                                                            \
-    "    path=<path>\n"
+    "    path=<path>\n"                                                                            \
+    "    fanout=<host>:<port>+...\n"                                                               \
+    "    segment=<bytes>\n"                                                                        \
+    "    read_datagrams=<count> (default=8)\n"                                                     \
+    "    read_datagram_size=<bytes> (default=65535)\n"
 
 #define TRANSPORT_HELP_UDP_SERVER                                                                  \
     "  udp-server:\n"                                                                              \
     "    listen=<addr> (default=0.0.0.0)\n"                                                        \
     "    port=<port>\n"                                                                            \
-    "    path=<path>\n"
+    "    path=<path>\n"                                                                            \
+    "    read_datagrams=<count> (default=8)\n"                                                     \
+    "    read_datagram_size=<bytes> (default=65535)\n"
 
 #define TRANSPORT_HELP_FILE_INPUT                                                                  \
     "  file:\n"                                                                                    \
@@ -44,4 +51,5 @@
     "  file:\n"                                                                                    \
     "    path=<path>\n"                                                                            \
     "    append=<bool>\n"                                                                          \
-    "    tbin=<bool>\n"
+    "    tbin=<bool>\n"                                                                            \
+    "    tbin-version=<1|2>\n"
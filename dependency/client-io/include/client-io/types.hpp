@@ -79,6 +79,8 @@ struct StreamsConfig {
     std::vector<StreamStdioConfig>     stdio;
     std::vector<StreamFdConfig>        fd;
     std::vector<StreamFileConfig>      file;
+    /// Log the stream statistics this often, zero disables it.
+    std::chrono::seconds               stats_interval{0};
 };
 
 // ── Generic input/output entries ──────────────────────────────────────────────
@@ -66,7 +66,8 @@ void add_udp_client(std::string const& id, io::UdpClientConfig const& config,
 }
 
 void add_udp_server(std::string const& id, std::string const& listen, uint16_t port,
-                    std::string const& path, io::StreamRegistry& registry, char const* source) {
+                    std::string const& path, io::ReadBufferConfig const& read_config,
+                    io::StreamRegistry& registry, char const* source) {
     if (registry.has(id)) return;
     DEBUGF("[%s] udp-server stream: id=%s listen=%s port=%u", source, id.c_str(), listen.c_str(),
            port);
@@ -76,7 +77,7 @@ void add_udp_server(std::string const& id, std::string const& listen, uint16_t p
     } else {
         listener = std::make_unique<scheduler::UdpInetListenerTask>(listen, port);
     }
-    registry.add(id, std::make_shared<io::UdpServerStream>(id, std::move(listener)));
+    registry.add(id, std::make_shared<io::UdpServerStream>(id, std::move(listener), read_config));
 }
 
 static std::shared_ptr<io::Stream> get_or_create_stdio(io::StreamRegistry& registry) {
@@ -102,7 +103,8 @@ void create_streams(StreamsConfig const& config, io::StreamRegistry& registry) {
     for (auto const& cfg : config.udp_client)
         add_udp_client(cfg.id, cfg.config, registry, "explicit");
     for (auto const& cfg : config.udp_server)
-        add_udp_server(cfg.id, cfg.listen, cfg.port, cfg.path, registry, "explicit");
+        add_udp_server(cfg.id, cfg.listen, cfg.port, cfg.path, cfg.read_config, registry,
+                       "explicit");
     for (auto const& cfg : config.pty) {
         if (registry.has(cfg.id)) continue;
         registry.add(cfg.id, std::make_shared<io::PtyStream>(cfg.id, cfg.config));
@@ -134,7 +136,17 @@ std::unique_ptr<io::Input> create_input(InputEntry const& entry, io::StreamRegis
 std::unique_ptr<io::Output> create_output(OutputEntry const& entry, io::StreamRegistry& registry) {
     for (auto const& handler : io_registry::output_types()) {
         if (handler.name == entry.type) {
-            return handler.create(entry.options, registry);
+            auto output = handler.create(entry.options, registry);
+            auto drop   = entry.options.find("drop");
+            if (output && drop != entry.options.end()) {
+                if (drop->second == "message")
+                    output->set_drop_policy(io::WriteBuffer::DropPolicy::Message);
+                else if (drop->second == "epoch")
+                    output->set_drop_policy(io::WriteBuffer::DropPolicy::Epoch);
+                else
+                    throw std::runtime_error("drop must be message or epoch");
+            }
+            return output;
         }
     }
     ERRORF("unknown output type: %s", entry.type.c_str());
@@ -162,6 +174,13 @@ static uint16_t get_port(Opts const& o, std::string const& k) {
     return static_cast<uint16_t>(std::stoul(o.at(k)));
 }
 
+static uint8_t get_tbin_version(Opts const& o) {
+    auto version = get(o, "tbin-version", "1");
+    if (version == "1") return format::tbin::VERSION_1;
+    if (version == "2") return format::tbin::VERSION_2;
+    throw std::runtime_error("tbin-version must be 1 or 2");
+}
+
 static std::string stream_id(std::string const& prefix, Opts const& o) {
     bool        unique = opt(o, "unique", false);
     std::string id;
@@ -204,7 +223,7 @@ io_registry::InputTypeHandler make_file_input_type() {
 }
 
 io_registry::InputTypeHandler make_serial_input_type() {
-    return {"serial", "    device=<device>\n    baudrate=<baudrate>\n",
+    return {"serial", "    device=<device>\n    baudrate=<baudrate>\n    low_latency=<bool>\n",
             [](Opts const& o, io::StreamRegistry& r) -> std::unique_ptr<io::Input> {
                 if (!o.count("device")) throw std::runtime_error("--input serial: missing device");
                 auto sid = stream_id("serial", o);
@@ -215,6 +234,9 @@ io_registry::InputTypeHandler make_serial_input_type() {
                     if (o.count("databits")) cfg.data_bits = parse_databits(o.at("databits"));
                     if (o.count("stopbits")) cfg.stop_bits = parse_stopbits(o.at("stopbits"));
                     if (o.count("parity")) cfg.parity_bit = parse_paritybit(o.at("parity"));
+                    cfg.low_latency = parse_bool(o, "low_latency", false);
+                    cfg.read_config = parse_read_config(o);
+                    check_low_latency(cfg);
                     r.add(sid, std::make_shared<io::SerialStream>(sid, cfg));
                 }
                 return std::make_unique<io::StreamInputAdapter>(r.get(sid));
@@ -255,14 +277,16 @@ io_registry::InputTypeHandler make_tcp_server_input_type() {
 }
 
 io_registry::InputTypeHandler make_udp_server_input_type() {
-    return {"udp-server", "    listen=<addr>\n    port=<port>\n",
+    return {"udp-server",
+            "    listen=<addr>\n    port=<port>\n    read_datagrams=<count>\n"
+            "    read_datagram_size=<bytes>\n",
             [](Opts const& o, io::StreamRegistry& r) -> std::unique_ptr<io::Input> {
                 auto sid = stream_id("udp-server", o);
                 if (!r.has(sid)) {
                     auto listen = get(o, "listen", "0.0.0.0");
                     auto port   = get_port(o, "port");
                     auto path   = get(o, "path");
-                    add_udp_server(sid, listen, port, path, r, "input");
+                    add_udp_server(sid, listen, port, path, parse_read_config(o), r, "input");
                 }
                 return std::make_unique<io::StreamInputAdapter>(r.get(sid));
             }};
@@ -285,7 +309,8 @@ io_registry::InputTypeHandler make_tbin_input_type() {
     return {"tbin",
             "    path=<path>\n"
             "    realtime=<bool> (default=false)\n"
-            "    shift=<seconds> (default=0, shift timestamps)\n",
+            "    shift=<seconds> (default=0, shift timestamps)\n"
+            "    virtual-clock=<bool> (default=false, timers and now() follow the timestamps)\n",
             [](Opts const& o, io::StreamRegistry&) -> std::unique_ptr<io::Input> {
                 if (!o.count("path")) throw std::runtime_error("--input tbin: missing path");
                 bool realtime =
@@ -307,7 +332,8 @@ io_registry::OutputTypeHandler make_stdout_output_type() {
 }
 
 io_registry::OutputTypeHandler make_file_output_type() {
-    return {"file", "    path=<path>\n    append=<bool>\n    tbin=<bool>\n",
+    return {"file",
+            "    path=<path>\n    append=<bool>\n    tbin=<bool>\n    tbin-version=<1|2>\n",
             [](Opts const& o, io::StreamRegistry& r) -> std::unique_ptr<io::Output> {
                 if (!o.count("path")) throw std::runtime_error("--output file: missing path");
                 auto           id = "file:" + o.at("path") + ":" + generate_unique_id();
@@ -318,18 +344,30 @@ io_registry::OutputTypeHandler make_file_output_type() {
                 cfg.append   = opt(o, "append", false);
                 cfg.truncate = !cfg.append;
                 cfg.create   = true;
-                auto stream  = std::make_shared<io::FileStream>(id, cfg);
+
+                auto tbin         = opt(o, "tbin", false);
+                auto tbin_version = tbin ? get_tbin_version(o) : format::tbin::VERSION_1;
+                bool has_header   = false;
+                if (tbin && cfg.append &&
+                    !format::tbin::prepare_append(cfg.path, tbin_version, has_header)) {
+                    throw std::runtime_error("--output file: cannot append tbin version " +
+                                             std::to_string(tbin_version) + " to " + cfg.path);
+                }
+
+                auto stream = std::make_shared<io::FileStream>(id, cfg);
                 r.add(id, stream);
-                if (opt(o, "tbin", false)) {
+                if (tbin) {
                     return std::make_unique<TbinOutput>(
-                        std::make_unique<io::StreamOutputAdapter>(stream), cfg.path);
+                        std::make_unique<io::StreamOutputAdapter>(stream), cfg.path, tbin_version,
+                        has_header);
                 }
                 return std::make_unique<io::StreamOutputAdapter>(stream);
             }};
 }
 
 io_registry::OutputTypeHandler make_tcp_server_output_type() {
-    return {"tcp-server", "    host=<addr>\n    port=<port>\n    tbin=<bool>\n",
+    return {"tcp-server",
+            "    host=<addr>\n    port=<port>\n    tbin=<bool>\n    tbin-version=<1|2>\n",
             [](Opts const& o, io::StreamRegistry&) -> std::unique_ptr<io::Output> {
                 std::unique_ptr<io::Output> inner;
                 if (o.count("path")) {
@@ -341,7 +379,8 @@ io_registry::OutputTypeHandler make_tcp_server_output_type() {
                 }
                 if (opt(o, "tbin", false)) {
                     auto name = get(o, "port");
-                    return std::make_unique<TbinOutput>(std::move(inner), name);
+                    return std::make_unique<TbinOutput>(std::move(inner), name,
+                                                        get_tbin_version(o));
                 }
                 return inner;
             }};
@@ -382,7 +421,8 @@ io_registry::OutputTypeHandler make_tcp_client_output_type() {
 }
 
 io_registry::OutputTypeHandler make_udp_client_output_type() {
-    return {"udp-client", "    host=<host>\n    port=<port>\n",
+    return {"udp-client",
+            "    host=<host>\n    port=<port>\n    fanout=<host>:<port>+...\n    segment=<bytes>\n",
             [](Opts const& o, io::StreamRegistry& r) -> std::unique_ptr<io::Output> {
                 auto sid = stream_id("udp-client", o);
                 if (!r.has(sid)) {
@@ -393,6 +433,8 @@ io_registry::OutputTypeHandler make_udp_client_output_type() {
                         cfg.host = o.at("host");
                         cfg.port = get_port(o, "port");
                     }
+                    if (o.count("fanout")) cfg.fanout = parse_list(o.at("fanout"), '+');
+                    if (o.count("segment")) cfg.segment_size = std::stoull(o.at("segment"));
                     r.add(sid, std::make_shared<io::UdpClientStream>(sid, cfg));
                 }
                 return std::make_unique<io::StreamOutputAdapter>(r.get(sid));
@@ -16,6 +16,64 @@ EXTERNAL_WARNINGS_PUSH
 #include <args.hxx>
 EXTERNAL_WARNINGS_POP
 
+void OutputRouter::compile(std::vector<OutputInterface> const& outputs) {
+    mOutputs       = &outputs;
+    mCompiledCount = outputs.size();
+    mCandidates.assign(FORMAT_SLOTS, {});
+    mTargets.clear();
+    mRanges.clear();
+    mSlots.clear();
+    mLastTag  = 0;
+    mLastSlot = SIZE_MAX;
+
+    for (auto const& output : outputs) {
+        for (size_t i = 0; i < FORMAT_SLOTS; i++) {
+            if (output.entry.format & (1llu << i)) {
+                mCandidates[i].push_back(&output);
+            }
+        }
+    }
+}
+
+size_t OutputRouter::resolve(uint64_t tag) {
+    auto it = mSlots.find(tag);
+    if (it != mSlots.end()) return it->second;
+
+    auto slot = mRanges.size() / FORMAT_SLOTS;
+    for (size_t i = 0; i < FORMAT_SLOTS; i++) {
+        Range range{static_cast<uint32_t>(mTargets.size()), 0};
+        for (auto output : mCandidates[i]) {
+            if (output->accept_tag(tag)) {
+                mTargets.push_back(output);
+            } else {
+                VERBOSEF("route: format 0x%llx tag %s rejected by %s: %s",
+                         static_cast<unsigned long long>(1llu << i), output->tag_name(tag).c_str(),
+                         output->entry.type.c_str(), output->reject_reason(tag).c_str());
+            }
+        }
+        range.end = static_cast<uint32_t>(mTargets.size());
+        mRanges.push_back(range);
+    }
+
+    DEBUGF("route: compiled tag %s (id %llu)", tags::to_string(tags::mask(tag)).c_str(),
+           static_cast<unsigned long long>(tag));
+    mSlots[tag] = slot;
+    return slot;
+}
+
+OutputRoute OutputRouter::route(OutputFormat format, uint64_t tag) {
+    if (format == 0 || mCompiledCount == 0) return OutputRoute{&mTargets, 0, 0};
+
+    if (mLastSlot == SIZE_MAX || mLastTag != tag) {
+        mLastSlot = resolve(tag);
+        mLastTag  = tag;
+    }
+
+    auto  index = static_cast<size_t>(__builtin_ctzll(format));
+    auto& range = mRanges[mLastSlot * FORMAT_SLOTS + index];
+    return OutputRoute{&mTargets, range.begin, range.end};
+}
+
 namespace output {
 
 static args::Group*                      gGroup = nullptr;
@@ -41,7 +99,8 @@ void setup(args::ArgumentParser& parser) {
     }
     help += "  itags=<tag>[+<tag>...]\n"
             "  otags=<tag>[+<tag>...]\n"
-            "  unique=<bool> (default=false)\n";
+            "  unique=<bool> (default=false)\n"
+            "  drop=message|epoch (default=message, what is dropped when writes back up)\n";
 
     gGroup = new args::Group{"Output:"};
     gArgs  = new args::ValueFlagList<std::string>{*gGroup, "output", help, {"output"}};
@@ -118,9 +118,29 @@ io::ReadBufferConfig parse_read_config(Options const& options) {
     if (it != options.end()) {
         config.timeout = std::chrono::milliseconds(std::stoll(it->second));
     }
+    config.timestamp = parse_bool(options, "read_timestamp", false);
+    it               = options.find("read_datagrams");
+    if (it != options.end()) {
+        config.datagrams = std::stoull(it->second);
+    }
+    it = options.find("read_datagram_size");
+    if (it != options.end()) {
+        config.datagram_size = std::stoull(it->second);
+        if (config.datagram_size == 0 || config.datagram_size > 65535) {
+            throw args::ValidationError("`read_datagram_size` must be between 1 and 65535, got `" +
+                                        it->second + "`");
+        }
+    }
     return config;
 }
 
+void check_low_latency(io::SerialConfig const& config) {
+    if (!config.low_latency || config.read_config.min_bytes <= 1) return;
+    if (config.read_config.timeout.count() > 0) return;
+    throw args::ValidationError(
+        "`low_latency` with `read_min_bytes` > 1 requires `read_timeout_ms`");
+}
+
 std::vector<std::string> parse_list(std::string const& str, char delimiter) {
     return core::split(str, delimiter);
 }
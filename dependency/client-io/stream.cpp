@@ -33,6 +33,13 @@ static args::ValueFlagList<std::string> gArgs{
     "    path=<path>\n",
     {"stream"},
 };
+static args::ValueFlag<int> gStats{
+    gGroup,
+    "seconds",
+    "Log stream statistics (read callback and input-to-output latency, pending and dropped "
+    "writes) every N seconds",
+    {"stream-stats"},
+};
 
 void setup(args::ArgumentParser& parser) {
     static args::GlobalOptions sGlobals{parser, gGroup};
@@ -59,7 +66,9 @@ static void parse_serial(std::string const& id, Options const& options, StreamsC
         cfg.config.parity_bit = parse_paritybit(options.at("parity"));
     }
     cfg.config.raw         = parse_bool(options, "raw", false);
+    cfg.config.low_latency = parse_bool(options, "low_latency", false);
     cfg.config.read_config = parse_read_config(options);
+    check_low_latency(cfg.config);
 
     streams.serial.push_back(std::move(cfg));
 }
@@ -118,6 +127,12 @@ static void parse_udp_client(std::string const& id, Options const& options,
         cfg.config.port = static_cast<uint16_t>(std::stoul(options.at("port")));
     }
     cfg.config.read_config = parse_read_config(options);
+    if (options.find("fanout") != options.end()) {
+        cfg.config.fanout = parse_list(options.at("fanout"), '+');
+    }
+    if (options.find("segment") != options.end()) {
+        cfg.config.segment_size = std::stoull(options.at("segment"));
+    }
 
     streams.udp_client.push_back(std::move(cfg));
 }
@@ -232,9 +247,17 @@ void parse(StreamsConfig& config) {
         auto options = parse_options(arg.substr(colon + 1));
         parse_stream(type, options, config);
     }
+
+    if (gStats) {
+        if (args::get(gStats) <= 0) {
+            throw args::ValidationError("--stream-stats: must be a positive number of seconds");
+        }
+        config.stats_interval = std::chrono::seconds(args::get(gStats));
+    }
 }
 
 void dump(StreamsConfig const& config) {
+    DEBUGF("stats_interval: %llds", static_cast<long long>(config.stats_interval.count()));
     for (auto const& c : config.serial) {
         DEBUGF("serial: id=%s device=%s", c.id.c_str(), c.config.device.c_str());
     }
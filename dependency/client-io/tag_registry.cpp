@@ -13,8 +13,8 @@ void TagRegistry::register_tag(std::string const& name, std::string const& descr
         return;
     }
 
-    if (mNextBitMask == 0) {
-        ERRORF("Tag registry full (64 tags maximum)");
+    if (mNextBit >= TAG_MAX_COUNT) {
+        ERRORF("Tag registry full (%d tags maximum)", TAG_MAX_COUNT);
         return;
     }
 
@@ -22,11 +22,11 @@ void TagRegistry::register_tag(std::string const& name, std::string const& descr
     info.name        = name;
     info.description = description;
     info.category    = category;
-    info.mask        = Tag(mNextBitMask);
+    info.mask        = Tag::bit(mNextBit);
 
     mTags[name]       = info;
-    mNameToMask[name] = Tag(mNextBitMask);
-    mNextBitMask      = mNextBitMask << 1;
+    mNameToMask[name] = info.mask;
+    mNextBit++;
 }
 
 void TagRegistry::add_alias(std::string const& tag, std::string const& alias) {
@@ -50,38 +50,54 @@ Tag TagRegistry::get_tag(std::string const& name) const {
 
     if (it == mNameToMask.end()) {
         WARNF("Unknown tag '%s'", name.c_str());
-        return Tag(0);
+        return Tag{};
     }
 
     return it->second;
 }
 
 TagMask TagRegistry::get_tag(std::vector<std::string> const& names) const {
-    uint64_t mask = 0;
+    TagMask mask;
     for (auto const& name : names) {
-        mask |= get_tag(name).value;
+        mask |= get_tag(name);
     }
-    return TagMask(mask);
+    return mask;
 }
 
-std::string TagRegistry::mask_to_string(TagMask mask) const {
-    if (mask.value == 0) return "";
+uint64_t TagRegistry::id(TagMask const& mask) {
+    // Only called while configuring, there are a handful of distinct sets
+    for (size_t i = 0; i < mIdMasks.size(); i++) {
+        if (mIdMasks[i] == mask) return i;
+    }
+    mIdMasks.push_back(mask);
+    return mIdMasks.size() - 1;
+}
+
+TagMask TagRegistry::mask(uint64_t id) const {
+    if (id >= mIdMasks.size()) {
+        WARNF("Unknown tag id %llu", static_cast<unsigned long long>(id));
+        return TagMask{};
+    }
+    return mIdMasks[id];
+}
+
+std::string TagRegistry::mask_to_string(TagMask const& mask) const {
+    if (mask.empty()) return "";
 
     std::string result;
-    uint64_t    named_bits = 0;
+    TagMask     named_bits;
     for (auto const& pair : mTags) {
-        if (pair.second.mask.value & mask.value) {
+        if (pair.second.mask.intersects(mask)) {
             if (!result.empty()) result += "+";
             result += pair.second.name;
-            named_bits |= pair.second.mask.value;
+            named_bits |= pair.second.mask;
         }
     }
-    uint64_t unnamed = mask.value & ~named_bits;
-    if (unnamed) {
+    auto unnamed = mask & ~named_bits;
+    for (size_t i = 0; i < TAG_MAX_COUNT; i++) {
+        if (!unnamed.intersects(TagMask::bit(i))) continue;
         if (!result.empty()) result += "+";
-        char buf[32];
-        snprintf(buf, sizeof(buf), "0x%llX", static_cast<unsigned long long>(unnamed));
-        result += buf;
+        result += "#" + std::to_string(i);
     }
     return result;
 }
@@ -113,9 +129,8 @@ void TagRegistry::dump() const {
     INFOF("Registered tags:");
     for (auto const& pair : mTags) {
         auto const& info = pair.second;
-        INFOF("  %-15s - %s (category: %s, mask: 0x%016llX)", info.name.c_str(),
-              info.description.c_str(), info.category.c_str(),
-              static_cast<unsigned long long>(info.mask.value));
+        INFOF("  %-15s - %s (category: %s)", info.name.c_str(), info.description.c_str(),
+              info.category.c_str());
         for (auto const& alias : info.aliases) {
             INFOF("    alias: %s", alias.c_str());
         }
@@ -143,7 +158,15 @@ TagMask get(std::vector<std::string> const& names) {
     return registry().get_tag(names);
 }
 
-std::string to_string(TagMask mask) {
+uint64_t id(TagMask const& mask) {
+    return registry().id(mask);
+}
+
+TagMask mask(uint64_t id) {
+    return registry().mask(id);
+}
+
+std::string to_string(TagMask const& mask) {
     return registry().mask_to_string(mask);
 }
 
@@ -1,5 +1,6 @@
 #include <client-io/tbin_input.hpp>
 #include <loglet/loglet.hpp>
+#include <scheduler/virtual_clock.hpp>
 
 #include <chrono>
 #include <ctime>
@@ -13,37 +14,47 @@ static int64_t now_us() {
 }
 
 TbinInput::TbinInput(std::vector<Source> sources, bool replay_realtime) NOEXCEPT
-    : mRealtimeMode(replay_realtime),
-      mTask(std::chrono::milliseconds(0)) {
-    mReaders.resize(sources.size());
-    mPending.resize(sources.size());
-    mFormats.resize(sources.size());
-    mShifts.resize(sources.size());
-
+    : mOpen(false),
+      mRealtimeMode(replay_realtime),
+      mTask(std::chrono::milliseconds(0), scheduler::TimerClock::Monotonic) {
     DEBUGF("tbin: %zu source(s), realtime=%s", sources.size(), replay_realtime ? "true" : "false");
+
+    std::vector<format::tbin::Merger::Source> merge_sources;
     for (size_t i = 0; i < sources.size(); i++) {
-        mFormats[i] = sources[i].format;
-        mShifts[i]  = sources[i].shift_us;
         DEBUGF("tbin: source[%zu] path=%s format=0x%llx shift=%llds", i, sources[i].path.c_str(),
                (unsigned long long)sources[i].format, (long long)(sources[i].shift_us / 1000000LL));
-        if (!mReaders[i].open(sources[i].path)) {
+
+        // Skip files that can't be opened instead of failing the whole input
+        format::tbin::Reader probe;
+        if (!probe.open(sources[i].path)) {
             ERRORF("tbin: failed to open %s", sources[i].path.c_str());
             continue;
         }
-        if (mReaders[i].next(mPending[i])) {
-            DEBUGF("tbin: source[%zu] first ts=%lld", i, (long long)mPending[i].timestamp_us);
-            mHeap.push({mPending[i].timestamp_us + mShifts[i], static_cast<uint32_t>(i)});
-        } else {
-            WARNF("tbin: source[%zu] empty or unreadable", i);
-        }
+
+        format::tbin::Merger::Source source{};
+        source.path     = sources[i].path;
+        source.shift_us = sources[i].shift_us;
+        merge_sources.push_back(source);
+        mFormats.push_back(sources[i].format);
+    }
+
+    mOpen = mMerger.open(merge_sources);
+    if (!mOpen) {
+        ERRORF("tbin: failed to open sources");
+    }
+
+    int64_t first_us;
+    if (mOpen && mMerger.peek(first_us)) {
+        DEBUGF("tbin: first ts=%lld", (long long)first_us);
+    } else {
+        WARNF("tbin: sources are empty or unreadable");
     }
-    DEBUGF("tbin: heap size=%zu after init", mHeap.size());
 }
 
 TbinInput::~TbinInput() NOEXCEPT = default;
 
 bool TbinInput::do_schedule(scheduler::Scheduler&) NOEXCEPT {
-    DEBUGF("tbin: scheduling, heap=%zu", mHeap.size());
+    DEBUGF("tbin: scheduling, sources=%zu", mMerger.size());
     mTask.callback = [this] {
         deliver_next();
     };
@@ -56,79 +67,91 @@ bool TbinInput::do_cancel(scheduler::Scheduler&) NOEXCEPT {
     return true;
 }
 
-void TbinInput::deliver_next() NOEXCEPT {
-    if (mHeap.empty()) {
-        if (on_complete) on_complete();
-        return;
-    }
+void TbinInput::complete() NOEXCEPT {
+    drain();
+    if (on_complete) on_complete();
+}
 
-next_message:
-    auto top = mHeap.top();
+// In non-realtime mode a batch is delivered much faster than the scheduler would run on its own.
+// Process the pending streamline queue events once per batch so that the queues (sized well above
+// BATCH_SIZE) do not overflow.
+void TbinInput::drain() NOEXCEPT {
+    if (mRealtimeMode) return;
+    while (scheduler::current().execute_once() == scheduler::ExecuteResult::ConditionMet) {
+    }
+}
 
-    // Stop if we've passed the stop time
-    if (mStopTimeUs > 0 && top.timestamp_us > mStopTimeUs) {
-        if (on_complete) on_complete();
+void TbinInput::deliver_next() NOEXCEPT {
+    if (!mOpen) {
+        complete();
         return;
     }
 
-    if (mRealtimeMode) {
-        if (!mStarted) {
-            mFirstTimestampUs = top.timestamp_us;
-            mStartWallUs      = now_us();
-            mStarted          = true;
+    size_t delivered = 0;
+    for (;;) {
+        int64_t timestamp_us;
+        if (!mMerger.peek(timestamp_us)) {
+            complete();
+            return;
+        }
+
+        // Stop if we've passed the stop time
+        if (mStopTimeUs > 0 && timestamp_us > mStopTimeUs) {
+            complete();
+            return;
         }
-        int64_t delay_us = (top.timestamp_us - mFirstTimestampUs) - (now_us() - mStartWallUs);
-        if (delay_us > 1000) {
-            mTask.set_duration(std::chrono::microseconds(delay_us));
+
+        if (mRealtimeMode) {
+            if (!mStarted) {
+                mFirstTimestampUs = timestamp_us;
+                mStartWallUs      = now_us();
+                mStarted          = true;
+            }
+            int64_t delay_us = (timestamp_us - mFirstTimestampUs) - (now_us() - mStartWallUs);
+            if (delay_us > 1000) {
+                mTask.set_duration(std::chrono::microseconds(delay_us));
+                mTask.restart();
+                return;
+            }
+        } else if (delivered >= BATCH_SIZE) {
+            // Give the other events a chance before the next batch
+            drain();
+            if (!mTask.is_scheduled()) return;
+            mTask.set_duration(std::chrono::nanoseconds(0));
             mTask.restart();
             return;
         }
-    }
 
-    mHeap.pop();
-    auto& msg = mPending[top.reader_index];
+        // Expire the timers that are due before the message, their callbacks may cancel the input
+        if (!mRealtimeMode && scheduler::VirtualClock::enabled()) {
+            scheduler::VirtualClock::advance_to(timestamp_us);
+            if (!mTask.is_scheduled()) return;
+        }
+
+        size_t source = 0;
+        auto   msg    = mMerger.next(&source);
+        deliver(source, *msg);
+        delivered++;
+
+        // A callback may have cancelled the input
+        if (!mTask.is_scheduled()) return;
+    }
+}
 
+void TbinInput::deliver(size_t source, format::tbin::Message& msg) NOEXCEPT {
     // Log progress every 60s of data time
-    if (top.timestamp_us - mLastLogUs >= 60LL * 1000000LL) {
-        auto t = static_cast<time_t>(top.timestamp_us / 1000000LL);
+    if (msg.timestamp_us - mLastLogUs >= 60LL * 1000000LL) {
+        auto t = static_cast<time_t>(msg.timestamp_us / 1000000LL);
         char buf[32];
         strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
         fprintf(stderr, "[tbin] replay at %s\n", buf);
-        mLastLogUs = top.timestamp_us;
+        mLastLogUs = msg.timestamp_us;
     }
 
-    if (!msg.data.empty()) {
-        InputFormat fmt = mFormats[top.reader_index];
-        if (format_callback)
-            format_callback(*this, fmt, msg.data.data(), msg.data.size());
-        else if (callback)
-            callback(*this, msg.data.data(), msg.data.size());
-
-        // In non-realtime mode drain all pending streamline queue events now,
-        // so queues don't overflow before the epoll loop gets a chance to run.
-        if (!mRealtimeMode) {
-            while (scheduler::current().execute_once() == scheduler::ExecuteResult::ConditionMet) {
-            }
-        }
-    }
-
-    if (mReaders[top.reader_index].next(mPending[top.reader_index])) {
-        mHeap.push({mPending[top.reader_index].timestamp_us + mShifts[top.reader_index],
-                    top.reader_index});
-    }
+    if (msg.data.empty()) return;
 
-    if (!mHeap.empty()) {
-        if (mRealtimeMode) {
-            int64_t delay_us =
-                (mHeap.top().timestamp_us - mFirstTimestampUs) - (now_us() - mStartWallUs);
-            mTask.set_duration(delay_us > 0 ? std::chrono::microseconds(delay_us) :
-                                              std::chrono::nanoseconds(1));
-            mTask.restart();
-        } else {
-            // Non-realtime: continue looping without going back through epoll
-            goto next_message;
-        }
-    } else {
-        if (on_complete) on_complete();
-    }
+    if (format_callback)
+        format_callback(*this, mFormats[source], msg.data.data(), msg.data.size());
+    else if (callback)
+        callback(*this, msg.data.data(), msg.data.size());
 }
@@ -1,10 +1,15 @@
 #include "antex.hpp"
 
 #include <algorithm>
-#include <fstream>
-#include <sstream>
+#include <atomic>
+#include <cstring>
+#include <thread>
 
+#include <format/helper/fixed.hpp>
+#include <format/helper/mapped_file.hpp>
+#include <format/helper/snapshot.hpp>
 #include <loglet/loglet.hpp>
+#include <msgpack/msgpack.hpp>
 #include <time/utc.hpp>
 
 LOGLET_MODULE2(format, antex);
@@ -18,81 +23,130 @@ CONSTEXPR static double PI         = 3.1415926535897932;
 CONSTEXPR static double RAD_TO_DEG = 180.0 / PI;
 CONSTEXPR static double MM_TO_M    = 1.0e-3;
 
-static bool is_comment(std::string const& line) {
-    // ends with "COMMENT             "
-    return line.size() == 80 && line.substr(60, 20) == "COMMENT             ";
-}
+// Antenna blocks are independent, below this many blocks a single thread is faster
+CONSTEXPR static size_t PARALLEL_MIN_BLOCKS = 64;
+
+// "ATX" and the snapshot payload version
+CONSTEXPR static uint32_t SNAPSHOT_MAGIC = 0x41545801;
+
+namespace {
+struct Line {
+    char const* data;
+    size_t      length;
+};
+
+// Lines of a memory range, without the line terminator
+class LineReader {
+public:
+    LineReader(char const* begin, char const* end) : mPosition(begin), mEnd(end) {}
+
+    bool next(Line& line) {
+        if (mPosition >= mEnd) return false;
+
+        auto remaining = static_cast<size_t>(mEnd - mPosition);
+        auto newline   = static_cast<char const*>(memchr(mPosition, '\n', remaining));
+        auto line_end  = newline ? newline : mEnd;
 
-static bool is_end_of_header(std::string const& line) {
-    // ends with "END OF HEADER"
-    return line.size() == 80 && line.substr(60, 20) == "END OF HEADER       ";
+        line.data   = mPosition;
+        line.length = static_cast<size_t>(line_end - mPosition);
+        if (line.length > 0 && line.data[line.length - 1] == '\r') line.length--;
+        mPosition = newline ? newline + 1 : mEnd;
+        return true;
+    }
+
+    NODISCARD char const* position() const { return mPosition; }
+
+private:
+    char const* mPosition;
+    char const* mEnd;
+};
+
+// The lines between "START OF ANTENNA" and "END OF ANTENNA"
+struct Block {
+    char const* begin;
+    char const* end;
+};
+
+enum class BlockResult : uint8_t {
+    Antenna,
+    Skipped,
+    Error,
+};
+
+struct FrequencyName {
+    char const*   name;
+    FrequencyType type;
+};
+}  // namespace
+
+static FrequencyName const FREQUENCY_NAMES[] = {
+    {"G01", FrequencyType::L1},  {"G02", FrequencyType::L2},  {"G05", FrequencyType::L5},
+    {"R01", FrequencyType::G1},  {"R02", FrequencyType::G2},  {"E01", FrequencyType::E1},
+    {"E05", FrequencyType::E5a}, {"E07", FrequencyType::E5b}, {"E08", FrequencyType::E5},
+    {"E06", FrequencyType::E6},  {"C01", FrequencyType::B1},  {"C02", FrequencyType::B2},
+    {"C06", FrequencyType::B3},  {"C05", FrequencyType::B2a}, {"C07", FrequencyType::B2b},
+    {"C08", FrequencyType::B2ab},
+};
+
+// The record label in columns 61-80
+static bool has_label(Line const& line, char const* label) {
+    return line.length >= 80 && memcmp(line.data + 60, label, 20) == 0;
 }
 
-static bool is_start_of_antenna(std::string const& line) {
-    // ends with "START OF ANTENNA    "
-    return line.size() == 80 && line.substr(60, 20) == "START OF ANTENNA    ";
+static bool is_comment(Line const& line) {
+    return has_label(line, "COMMENT             ");
 }
 
-static bool is_end_of_antenna(std::string const& line) {
-    // ends with "END OF ANTENNA      "
-    return line.size() == 80 && line.substr(60, 20) == "END OF ANTENNA      ";
+static bool is_end_of_header(Line const& line) {
+    return has_label(line, "END OF HEADER       ");
 }
 
-static bool is_type_serial_no(std::string const& line) {
-    // ends with "TYPE / SERIAL NO    "
-    return line.size() == 80 && line.substr(60, 20) == "TYPE / SERIAL NO    ";
+static bool is_start_of_antenna(Line const& line) {
+    return has_label(line, "START OF ANTENNA    ");
 }
 
-static bool is_method_by_date(std::string const& line) {
-    // ends with "METH / BY / # / DATE"
-    return line.size() == 80 && line.substr(60, 20) == "METH / BY / # / DATE";
+static bool is_end_of_antenna(Line const& line) {
+    return has_label(line, "END OF ANTENNA      ");
 }
 
-static bool is_dazi(std::string const& line) {
-    // starts with "DAZI"
-    return line.size() >= 80 && line.substr(60, 20) == "DAZI                ";
+static bool is_type_serial_no(Line const& line) {
+    return has_label(line, "TYPE / SERIAL NO    ");
 }
 
-static bool is_zen1_zen2_dzen(std::string const& line) {
-    // starts with "ZEN1 / ZEN2 / DZEN  "
-    return line.size() >= 80 && line.substr(60, 20) == "ZEN1 / ZEN2 / DZEN  ";
+static bool is_method_by_date(Line const& line) {
+    return has_label(line, "METH / BY / # / DATE");
 }
 
-static bool is_frequency_count(std::string const& line) {
-    // starts with "# OF FREQUENCIES    "
-    return line.size() >= 80 && line.substr(60, 20) == "# OF FREQUENCIES    ";
+static bool is_dazi(Line const& line) {
+    return has_label(line, "DAZI                ");
 }
 
-static bool is_valid_from(std::string const& line) {
-    // starts with "VALID FROM"
-    return line.size() >= 80 && line.substr(60, 20) == "VALID FROM          ";
+static bool is_zen1_zen2_dzen(Line const& line) {
+    return has_label(line, "ZEN1 / ZEN2 / DZEN  ");
 }
 
-static bool is_valid_until(std::string const& line) {
-    // starts with "VALID UNTIL"
-    return line.size() >= 80 && line.substr(60, 20) == "VALID UNTIL         ";
+static bool is_frequency_count(Line const& line) {
+    return has_label(line, "# OF FREQUENCIES    ");
 }
 
-static bool is_start_of_frequency(std::string const& line) {
-    return line.size() >= 80 && line.substr(60, 20) == "START OF FREQUENCY  ";
+static bool is_valid_from(Line const& line) {
+    return has_label(line, "VALID FROM          ");
 }
 
-static bool is_end_of_frequency(std::string const& line) {
-    return line.size() >= 80 && line.substr(60, 20) == "END OF FREQUENCY    ";
+static bool is_valid_until(Line const& line) {
+    return has_label(line, "VALID UNTIL         ");
 }
 
-#if 0
-static bool is_start_of_frequency_rms(std::string const& line) {
-    return line.size() >= 80 && line.substr(60, 20) == "START OF FREQ RMS   ";
+static bool is_start_of_frequency(Line const& line) {
+    return has_label(line, "START OF FREQUENCY  ");
 }
 
-static bool is_end_of_frequency_rms(std::string const& line) {
-    return line.size() >= 80 && line.substr(60, 20) == "END OF FREQ RMS     ";
+static bool is_end_of_frequency(Line const& line) {
+    return has_label(line, "END OF FREQUENCY    ");
 }
-#endif
 
-static bool is_north_east_up(std::string const& line) {
-    return line.size() >= 80 && line.substr(60, 20) == "NORTH / EAST / UP   ";
+static bool is_north_east_up(Line const& line) {
+    return has_label(line, "NORTH / EAST / UP   ");
 }
 
 static std::string trim(std::string const& str) {
@@ -102,440 +156,572 @@ static std::string trim(std::string const& str) {
     return str.substr(start, end - start + 1);
 }
 
-static bool parse_float(std::string const& str, double& value) {
-    try {
-        value = std::stod(str);
-        return true;
-    } catch (std::exception const&) {
+// The trimmed text of a fixed-width column
+static std::string field(Line const& line, size_t offset, size_t width) {
+    if (offset >= line.length) return "";
+    auto length = offset + width < line.length ? width : line.length - offset;
+    return trim(std::string(line.data + offset, length));
+}
+
+static bool parse_float(Line const& line, size_t offset, size_t width, double& value) {
+    return helper::column_double(line.data, line.length, offset, width, value);
+}
+
+static bool parse_int(Line const& line, size_t offset, size_t width, int64_t& value) {
+    return helper::column_int(line.data, line.length, offset, width, value);
+}
+
+static bool parse_epoch(Line const& line, char const* name, ts::Gps& time) {
+    int64_t year, month, day, hour, minute;
+    double  second;
+    if (!parse_int(line, 0, 6, year)) {
+        ERRORF("failed to parse %s year: %s", name, field(line, 0, 6).c_str());
+        return false;
+    } else if (!parse_int(line, 6, 6, month)) {
+        ERRORF("failed to parse %s month: %s", name, field(line, 6, 6).c_str());
+        return false;
+    } else if (!parse_int(line, 12, 6, day)) {
+        ERRORF("failed to parse %s day: %s", name, field(line, 12, 6).c_str());
+        return false;
+    } else if (!parse_int(line, 18, 6, hour)) {
+        ERRORF("failed to parse %s hour: %s", name, field(line, 18, 6).c_str());
+        return false;
+    } else if (!parse_int(line, 24, 6, minute)) {
+        ERRORF("failed to parse %s minute: %s", name, field(line, 24, 6).c_str());
+        return false;
+    } else if (!parse_float(line, 30, 13, second)) {
+        ERRORF("failed to parse %s second: %s", name, field(line, 30, 13).c_str());
         return false;
     }
+
+    time = ts::Gps::from_ymdhms(year, month, day, hour, minute, second);
+    VERBOSEF("  %s: %s", name, ts::Utc{time}.rtklib_time_string().c_str());
+    return true;
 }
 
-static bool parse_int(std::string const& str, int64_t& value) {
-    try {
-        value = std::stoll(str);
-        return true;
-    } catch (std::exception const&) {
+static void skip_to_end_of_frequency(LineReader& reader) {
+    Line line{};
+    while (reader.next(line)) {
+        if (is_end_of_frequency(line)) break;
+    }
+}
+
+static bool parse_frequency(LineReader& reader, Antenna const& antenna, Frequency& frequency) {
+    Line line{};
+    if (!reader.next(line)) {
+        ERRORF("failed to read north, east, and up");
+        return false;
+    } else if (!is_north_east_up(line)) {
+        ERRORF("expected frequency number");
+        return false;
+    }
+
+    TRACEF("  NEU: %.*s", static_cast<int>(line.length), line.data);
+    double north = 0.0, east = 0.0, up = 0.0;
+    if (parse_float(line, 0, 10, north) && parse_float(line, 10, 10, east) &&
+        parse_float(line, 20, 10, up)) {
+        frequency.eccentricities = Float3{north, east, up};
+    }
+
+    if (!reader.next(line)) {
+        ERRORF("failed to read no azimuth");
         return false;
     }
+
+    TRACEF("  NOAZI: %.*s", static_cast<int>(line.length), line.data);
+    if (line.length < 8 || memcmp(line.data, "   NOAZI", 8) != 0) {
+        ERRORF("expected no azimuth");
+        return false;
+    }
+
+    auto element_count = static_cast<size_t>((antenna.zen2 - antenna.zen1) / antenna.dzen) + 1;
+    auto expected_length = 8 + 8 * element_count;
+    TRACEF("  %f - %f = %f / %f, expected %zu", antenna.zen2, antenna.zen1,
+           antenna.zen2 - antenna.zen1, antenna.dzen, element_count);
+    if (line.length != expected_length) {
+        ERRORF("expected no azimuth length %zu, got %zu", expected_length, line.length);
+        return false;
+    }
+
+    frequency.no_azimuth.resize(element_count);
+    for (size_t i = 0; i < element_count; i++) {
+        if (!parse_float(line, 8 + 8 * i, 8, frequency.no_azimuth[i])) {
+            ERRORF("failed to parse no azimuth: %s", field(line, 8 + 8 * i, 8).c_str());
+            return false;
+        }
+    }
+
+    if (antenna.dazi > 0.0) {
+        auto dazi_count = static_cast<size_t>(360.0 / antenna.dazi) + 1;
+        frequency.azimuths.resize(dazi_count * element_count);
+        for (size_t i = 0; i < dazi_count; i++) {
+            if (!reader.next(line)) {
+                ERRORF("failed to read azimuth %zu", i);
+                return false;
+            }
+
+            TRACEF("  AZI: %.*s", static_cast<int>(line.length), line.data);
+            auto azimuth_value = 0.0;
+            if (!parse_float(line, 0, 8, azimuth_value)) {
+                ERRORF("failed to parse azimuth %zu: %s", i, field(line, 0, 8).c_str());
+                return false;
+            }
+
+            if (line.length != expected_length) {
+                ERRORF("expected azimuth length %zu, got %zu", expected_length, line.length);
+                return false;
+            }
+
+            auto values = frequency.azimuths.data() + i * element_count;
+            for (size_t j = 0; j < element_count; j++) {
+                if (!parse_float(line, 8 + 8 * j, 8, values[j])) {
+                    ERRORF("failed to parse value %zu %zu: %s", i, j,
+                           field(line, 8 + 8 * j, 8).c_str());
+                    return false;
+                }
+            }
+        }
+    }
+
+    while (reader.next(line)) {
+        if (is_end_of_frequency(line)) {
+            break;
+        } else {
+            TRACEF("unhandled: %.*s", static_cast<int>(line.length), line.data);
+        }
+    }
+    return true;
 }
 
-std::unique_ptr<Antex> Antex::from_string(std::string const& data) {
-    FUNCTION_SCOPE();
+static BlockResult parse_antenna(Block const& block, Antenna& antenna) {
+    LineReader reader{block.begin, block.end};
+    Line       line{};
+
+    if (!reader.next(line)) {
+        ERRORF("failed to read antenna type");
+        return BlockResult::Error;
+    } else if (!is_type_serial_no(line)) {
+        ERRORF("expected antenna type and serial number");
+        return BlockResult::Error;
+    }
+
+    auto antenna_type   = field(line, 0, 20);
+    auto satellite_code = field(line, 20, 20);
+    VERBOSEF("antenna type: %s, satellite code: %s", antenna_type.c_str(), satellite_code.c_str());
+
+    // Only process known satellite IDs
+    antenna.id = SatelliteId::from_string(satellite_code);
+    if (!antenna.id.is_valid()) return BlockResult::Skipped;
+
+    if (!reader.next(line)) {
+        ERRORF("failed to read antenna method");
+        return BlockResult::Error;
+    } else if (!is_method_by_date(line)) {
+        ERRORF("expected antenna method and date");
+        return BlockResult::Error;
+    }
+    TRACEF("antenna method: %.*s", static_cast<int>(line.length), line.data);
+
+    if (!reader.next(line)) {
+        ERRORF("failed to read dazi");
+        return BlockResult::Error;
+    } else if (!is_dazi(line)) {
+        ERRORF("expected dazi");
+        return BlockResult::Error;
+    } else if (!parse_float(line, 2, 6, antenna.dazi)) {
+        ERRORF("failed to parse dazi: %s", field(line, 2, 6).c_str());
+        return BlockResult::Error;
+    }
+
+    if (!reader.next(line)) {
+        ERRORF("failed to read zen1, zen2, dzen");
+        return BlockResult::Error;
+    } else if (!is_zen1_zen2_dzen(line)) {
+        ERRORF("expected zen1, zen2, dzen");
+        return BlockResult::Error;
+    } else if (!parse_float(line, 2, 6, antenna.zen1)) {
+        ERRORF("failed to parse zen1: %s", field(line, 2, 6).c_str());
+        return BlockResult::Error;
+    } else if (!parse_float(line, 8, 6, antenna.zen2)) {
+        ERRORF("failed to parse zen2: %s", field(line, 8, 6).c_str());
+        return BlockResult::Error;
+    } else if (!parse_float(line, 14, 6, antenna.dzen)) {
+        ERRORF("failed to parse dzen: %s", field(line, 14, 6).c_str());
+        return BlockResult::Error;
+    }
+
+    if (!reader.next(line)) {
+        ERRORF("failed to read frequency count");
+        return BlockResult::Error;
+    } else if (!is_frequency_count(line)) {
+        ERRORF("expected frequency count");
+        return BlockResult::Error;
+    } else if (!parse_int(line, 0, 6, antenna.frequency_count)) {
+        ERRORF("failed to parse frequency count: %s", field(line, 0, 6).c_str());
+        return BlockResult::Error;
+    }
+
+    DEBUGF("antenna: %s", antenna.id.name());
+    VERBOSEF("  dazi: %f", antenna.dazi);
+    VERBOSEF("  zen1: %f", antenna.zen1);
+    VERBOSEF("  zen2: %f", antenna.zen2);
+    VERBOSEF("  dzen: %f", antenna.dzen);
+    VERBOSEF("  frequency count: %ld", antenna.frequency_count);
+
+    while (reader.next(line)) {
+        TRACEF("line: %.*s", static_cast<int>(line.length), line.data);
+        if (is_valid_from(line)) {
+            if (!parse_epoch(line, "valid from", antenna.valid_from)) return BlockResult::Error;
+            antenna.valid_from_set = true;
+        } else if (is_valid_until(line)) {
+            if (!parse_epoch(line, "valid until", antenna.valid_until)) return BlockResult::Error;
+            antenna.valid_until_set = true;
+        } else if (is_start_of_frequency(line)) {
+            Frequency frequency{};
+            frequency.dazi = antenna.dazi;
+            frequency.zen1 = antenna.zen1;
+            frequency.zen2 = antenna.zen2;
+            frequency.dzen = antenna.dzen;
+
+            auto frequency_name = field(line, 3, 3);
+            auto known          = false;
+            for (auto const& entry : FREQUENCY_NAMES) {
+                if (frequency_name == entry.name) {
+                    frequency.type = entry.type;
+                    known          = true;
+                    break;
+                }
+            }
+
+            if (!known) {
+                WARNF("unhandled frequency number: %s", frequency_name.c_str());
+                skip_to_end_of_frequency(reader);
+                continue;
+            }
+
+            if (!parse_frequency(reader, antenna, frequency)) return BlockResult::Error;
+
+            auto it = std::find_if(antenna.frequencies.begin(), antenna.frequencies.end(),
+                                   [&](Frequency const& existing) {
+                                       return existing.type == frequency.type;
+                                   });
+            if (it != antenna.frequencies.end()) {
+                *it = std::move(frequency);
+            } else {
+                antenna.frequencies.push_back(std::move(frequency));
+            }
+        } else {
+            TRACEF("unhandled: %.*s", static_cast<int>(line.length), line.data);
+        }
+    }
 
-    auto               result = std::unique_ptr<Antex>(new Antex{});
-    std::istringstream stream(data);
-    std::string        line;
+    return BlockResult::Antenna;
+}
 
-    // Parse header
+static void parse_header(LineReader& reader, AntexHeader& header) {
     TRACEF("---------------- start of header ----------------");
-    while (std::getline(stream, line)) {
+    Line line{};
+    while (reader.next(line)) {
         if (is_comment(line)) {
-            TRACEF("comment: %s", line.c_str());
+            TRACEF("comment: %.*s", static_cast<int>(line.length), line.data);
             continue;
         }
         if (is_end_of_header(line)) {
             break;
         }
-        if (line.size() >= 60) {
-            auto label = line.substr(60);
+        if (line.length >= 60) {
+            auto text  = std::string(line.data, line.length);
+            auto label = text.substr(60);
             if (label.find("ANTEX VERSION / SYST") != std::string::npos) {
-                // Example parse for version/system
-                result->header.version = trim(line.substr(0, 8));
-                if (line.size() > 20) result->header.system = line.substr(20, 1);
-                VERBOSEF("version: %s, system: %s", result->header.version.c_str(),
-                         result->header.system.c_str());
+                header.version = trim(text.substr(0, 8));
+                if (text.size() > 20) header.system = text.substr(20, 1);
+                VERBOSEF("version: %s, system: %s", header.version.c_str(),
+                         header.system.c_str());
             } else if (label.find("PCV TYPE / REFANT") != std::string::npos) {
-                // Example parse for PCV type / reference antenna
-                if (line.size() >= 1) result->header.pcv_type = line.substr(0, 1);
-                if (line.size() >= 40) result->header.refant_type = trim(line.substr(20, 20));
-                if (line.size() >= 60) result->header.refant_serial = trim(line.substr(40, 20));
+                header.pcv_type      = text.substr(0, 1);
+                header.refant_type   = trim(text.substr(20, 20));
+                header.refant_serial = trim(text.substr(40, 20));
                 VERBOSEF("pcv_type: %s, refant_type: %s, refant_serial: %s",
-                         result->header.pcv_type.c_str(), result->header.refant_type.c_str(),
-                         result->header.refant_serial.c_str());
+                         header.pcv_type.c_str(), header.refant_type.c_str(),
+                         header.refant_serial.c_str());
             } else {
-                TRACEF("unhandled: %s", line.c_str());
+                TRACEF("unhandled: %s", text.c_str());
             }
         }
     }
     TRACEF("---------------- end of header ----------------");
+}
 
-    // Parse antennas
-    while (std::getline(stream, line)) {
-        if (is_comment(line)) {
-            TRACEF("comment: %s", line.c_str());
+static std::vector<Block> find_antenna_blocks(LineReader& reader) {
+    std::vector<Block> blocks;
+    Line               line{};
+    while (reader.next(line)) {
+        if (!is_start_of_antenna(line)) {
+            TRACEF("unhandled: %.*s", static_cast<int>(line.length), line.data);
             continue;
         }
-        if (is_start_of_antenna(line)) {
-            auto antenna = std::unique_ptr<Antenna>(new Antenna{});
-            TRACEF("---------------- start of antenna ----------------");
-
-            if (!std::getline(stream, line)) {
-                ERRORF("failed to read antenna type");
-                return nullptr;
-            } else if (!is_type_serial_no(line)) {
-                ERRORF("expected antenna type and serial number");
-                return nullptr;
-            }
 
-            auto antenna_type   = trim(line.substr(0, 20));
-            auto satellite_code = trim(line.substr(20, 20));
-            VERBOSEF("antenna type: %s, satellite code: %s", antenna_type.c_str(),
-                     satellite_code.c_str());
-
-            antenna->id = SatelliteId::from_string(satellite_code);
-            if (!antenna->id.is_valid()) {
-                // Only process known satellite IDs
-                while (std::getline(stream, line)) {
-                    if (is_end_of_antenna(line)) {
-                        break;
-                    }
-                }
-
-                TRACEF("---------------- end of antenna ----------------");
-                continue;
-            }
+        // A missing "END OF ANTENNA" ends the block at the end of the data
+        Block block{reader.position(), nullptr};
+        auto  end = reader.position();
+        while (reader.next(line)) {
+            if (is_end_of_antenna(line)) break;
+            end = reader.position();
+        }
+        block.end = end;
+        blocks.push_back(block);
+    }
+    return blocks;
+}
 
-            if (!std::getline(stream, line)) {
-                ERRORF("failed to read antenna method");
-                return nullptr;
-            } else if (!is_method_by_date(line)) {
-                ERRORF("expected antenna method and date");
-                return nullptr;
-            }
-            TRACEF("antenna method: %s", line.c_str());
-
-            if (!std::getline(stream, line)) {
-                ERRORF("failed to read dazi");
-                return nullptr;
-            } else if (!is_dazi(line)) {
-                ERRORF("expected dazi");
-                return nullptr;
-            }
-            TRACEF("dazi: %s", line.c_str());
+std::unique_ptr<Antex> Antex::from_memory(char const* data, size_t size) {
+    FUNCTION_SCOPE();
 
-            auto dazi_str = trim(line.substr(2, 6));
+    auto       result = std::unique_ptr<Antex>(new Antex{});
+    LineReader reader{data, data + size};
+    parse_header(reader, result->header);
 
-            if (!std::getline(stream, line)) {
-                ERRORF("failed to read zen1, zen2, dzen");
-                return nullptr;
-            } else if (!is_zen1_zen2_dzen(line)) {
-                ERRORF("expected zen1, zen2, dzen");
-                return nullptr;
-            }
+    auto blocks = find_antenna_blocks(reader);
+    DEBUGF("%zu antenna blocks", blocks.size());
 
-            TRACEF("zen: %s", line.c_str());
-            auto zen1_str = trim(line.substr(2, 6));
-            auto zen2_str = trim(line.substr(8, 6));
-            auto dzen_str = trim(line.substr(14, 6));
-
-            if (!std::getline(stream, line)) {
-                ERRORF("failed to read frequency count");
-                return nullptr;
-            } else if (!is_frequency_count(line)) {
-                ERRORF("expected frequency count");
-                return nullptr;
-            }
+    std::vector<Antenna>     parsed(blocks.size());
+    std::vector<BlockResult> results(blocks.size(), BlockResult::Skipped);
 
-            TRACEF("frequency count: %s", line.c_str());
-            auto frequency_count_str = trim(line.substr(0, 6));
-
-            if (!parse_float(dazi_str, antenna->dazi)) {
-                ERRORF("failed to parse dazi: %s", dazi_str.c_str());
-                return nullptr;
-            } else if (!parse_float(zen1_str, antenna->zen1)) {
-                ERRORF("failed to parse zen1: %s", zen1_str.c_str());
-                return nullptr;
-            } else if (!parse_float(zen2_str, antenna->zen2)) {
-                ERRORF("failed to parse zen2: %s", zen2_str.c_str());
-                return nullptr;
-            } else if (!parse_float(dzen_str, antenna->dzen)) {
-                ERRORF("failed to parse dzen: %s", dzen_str.c_str());
-                return nullptr;
-            } else if (!parse_int(frequency_count_str, antenna->frequency_count)) {
-                ERRORF("failed to parse frequency count: %s", frequency_count_str.c_str());
-                return nullptr;
-            }
+    // Keep the detailed log in order by parsing on a single thread when it is enabled
+    size_t thread_count = 1;
+    if (blocks.size() >= PARALLEL_MIN_BLOCKS &&
+        !loglet::is_module_level_enabled(LOGLET_CURRENT_MODULE, loglet::Level::Verbose)) {
+        auto hardware = static_cast<size_t>(std::thread::hardware_concurrency());
+        thread_count  = std::min(hardware, blocks.size() / PARALLEL_MIN_BLOCKS);
+        if (thread_count < 1) thread_count = 1;
+    }
 
-            DEBUGF("antenna: %s", antenna->id.name());
-            VERBOSEF("  dazi: %f", antenna->dazi);
-            VERBOSEF("  zen1: %f", antenna->zen1);
-            VERBOSEF("  zen2: %f", antenna->zen2);
-            VERBOSEF("  dzen: %f", antenna->dzen);
-            VERBOSEF("  frequency count: %ld", antenna->frequency_count);
+    std::atomic<size_t> next_block{0};
+    auto                worker = [&]() {
+        for (;;) {
+            auto i = next_block.fetch_add(1);
+            if (i >= blocks.size()) break;
+            results[i] = parse_antenna(blocks[i], parsed[i]);
+        }
+    };
 
-            while (std::getline(stream, line)) {
-                TRACEF("line: %s", line.c_str());
-                if (is_end_of_antenna(line)) {
-                    break;
-                } else if (is_valid_from(line)) {
-                    auto valid_from_year_str   = trim(line.substr(0, 6));
-                    auto valid_from_month_str  = trim(line.substr(6, 6));
-                    auto valid_from_day_str    = trim(line.substr(12, 6));
-                    auto valid_from_hour_str   = trim(line.substr(18, 6));
-                    auto valid_from_minute_str = trim(line.substr(24, 6));
-                    auto valid_from_second_str = trim(line.substr(30, 13));
-
-                    int64_t year, month, day, hour, minute;
-                    double  second;
-                    if (!parse_int(valid_from_year_str, year)) {
-                        ERRORF("failed to parse valid from year: %s", valid_from_year_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_from_month_str, month)) {
-                        ERRORF("failed to parse valid from month: %s",
-                               valid_from_month_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_from_day_str, day)) {
-                        ERRORF("failed to parse valid from day: %s", valid_from_day_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_from_hour_str, hour)) {
-                        ERRORF("failed to parse valid from hour: %s", valid_from_hour_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_from_minute_str, minute)) {
-                        ERRORF("failed to parse valid from minute: %s",
-                               valid_from_minute_str.c_str());
-                        return nullptr;
-                    } else if (!parse_float(valid_from_second_str, second)) {
-                        ERRORF("failed to parse valid from second: %s",
-                               valid_from_second_str.c_str());
-                        return nullptr;
-                    }
-
-                    VERBOSEF("  valid from: %04" PRId64 " %02" PRId64 " %02" PRId64 " "
-                             "%02" PRId64 ":%02" PRId64 ":%06.3f",
-                             year, month, day, hour, minute, second);
-
-                    antenna->valid_from_set = true;
-                    antenna->valid_from =
-                        ts::Gps::from_ymdhms(year, month, day, hour, minute, second);
-                    VERBOSEF("  valid from: %s",
-                             ts::Utc{antenna->valid_from}.rtklib_time_string().c_str());
-                } else if (is_valid_until(line)) {
-                    auto valid_until_year_str   = trim(line.substr(0, 6));
-                    auto valid_until_month_str  = trim(line.substr(6, 6));
-                    auto valid_until_day_str    = trim(line.substr(12, 6));
-                    auto valid_until_hour_str   = trim(line.substr(18, 6));
-                    auto valid_until_minute_str = trim(line.substr(24, 6));
-                    auto valid_until_second_str = trim(line.substr(30, 13));
-
-                    int64_t year, month, day, hour, minute;
-                    double  second;
-                    if (!parse_int(valid_until_year_str, year)) {
-                        ERRORF("failed to parse valid until year: %s",
-                               valid_until_year_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_until_month_str, month)) {
-                        ERRORF("failed to parse valid until month: %s",
-                               valid_until_month_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_until_day_str, day)) {
-                        ERRORF("failed to parse valid until day: %s", valid_until_day_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_until_hour_str, hour)) {
-                        ERRORF("failed to parse valid until hour: %s",
-                               valid_until_hour_str.c_str());
-                        return nullptr;
-                    } else if (!parse_int(valid_until_minute_str, minute)) {
-                        ERRORF("failed to parse valid until minute: %s",
-                               valid_until_minute_str.c_str());
-                        return nullptr;
-                    } else if (!parse_float(valid_until_second_str, second)) {
-                        ERRORF("failed to parse valid until second: %s",
-                               valid_until_second_str.c_str());
-                        return nullptr;
-                    }
-
-                    antenna->valid_until_set = true;
-                    antenna->valid_until =
-                        ts::Gps::from_ymdhms(year, month, day, hour, minute, second);
-                    VERBOSEF("  valid until: %s",
-                             ts::Utc{antenna->valid_until}.rtklib_time_string().c_str());
-                } else if (is_start_of_frequency(line)) {
-                    auto frequency = std::unique_ptr<Frequency>(new Frequency{});
-                    TRACEF("---------------- start of frequency ----------------");
-
-                    frequency->dazi = antenna->dazi;
-                    frequency->zen1 = antenna->zen1;
-                    frequency->zen2 = antenna->zen2;
-                    frequency->dzen = antenna->dzen;
-
-                    auto frequency_number_str = trim(line.substr(3, 3));
-                    if (frequency_number_str == "G01") {
-                        frequency->type = FrequencyType::L1;
-                    } else if (frequency_number_str == "G02") {
-                        frequency->type = FrequencyType::L2;
-                    } else if (frequency_number_str == "G05") {
-                        frequency->type = FrequencyType::L5;
-                    } else if (frequency_number_str == "R01") {
-                        frequency->type = FrequencyType::G1;
-                    } else if (frequency_number_str == "R02") {
-                        frequency->type = FrequencyType::G2;
-                    } else if (frequency_number_str == "E01") {
-                        frequency->type = FrequencyType::E1;
-                    } else if (frequency_number_str == "E05") {
-                        frequency->type = FrequencyType::E5a;
-                    } else if (frequency_number_str == "E07") {
-                        frequency->type = FrequencyType::E5b;
-                    } else if (frequency_number_str == "E08") {
-                        frequency->type = FrequencyType::E5;
-                    } else if (frequency_number_str == "E06") {
-                        frequency->type = FrequencyType::E6;
-                    } else if (frequency_number_str == "C01") {
-                        frequency->type = FrequencyType::B1;
-                    } else if (frequency_number_str == "C02") {
-                        frequency->type = FrequencyType::B2;
-                    } else if (frequency_number_str == "C06") {
-                        frequency->type = FrequencyType::B3;
-                    } else if (frequency_number_str == "C05") {
-                        frequency->type = FrequencyType::B2a;
-                    } else if (frequency_number_str == "C07") {
-                        frequency->type = FrequencyType::B2b;
-                    } else if (frequency_number_str == "C08") {
-                        frequency->type = FrequencyType::B2ab;
-                    } else {
-                        WARNF("unhandled frequency number: %s", frequency_number_str.c_str());
-                        while (std::getline(stream, line)) {
-                            if (is_end_of_frequency(line)) {
-                                break;
-                            }
-                        }
-
-                        TRACEF("---------------- end of frequency ----------------");
-                        continue;
-                    }
-
-                    if (!std::getline(stream, line)) {
-                        ERRORF("failed to read north, east, and up");
-                        return nullptr;
-                    } else if (!is_north_east_up(line)) {
-                        ERRORF("expected frequency number");
-                        return nullptr;
-                    }
-
-                    TRACEF("  NEW: %s", line.c_str());
-                    auto north_str = trim(line.substr(0, 10));
-                    auto east_str  = trim(line.substr(10, 10));
-                    auto up_str    = trim(line.substr(20, 10));
-
-                    if (!std::getline(stream, line)) {
-                        ERRORF("failed to read no azimuth");
-                        return nullptr;
-                    }
-
-                    TRACEF("  NOAZI: %s", line.c_str());
-                    auto prefix = line.substr(0, 8);
-                    if (prefix != "   NOAZI") {
-                        ERRORF("expected no azimuth");
-                        return nullptr;
-                    }
-
-                    auto element_count =
-                        static_cast<size_t>((antenna->zen2 - antenna->zen1) / antenna->dzen) + 1;
-                    auto expected_length = 8 + 8 * element_count;
-                    TRACEF("  %f - %f = %f / %f, expected %zu", antenna->zen2, antenna->zen1,
-                           antenna->zen2 - antenna->zen1, antenna->dzen, element_count);
-                    if (line.size() != expected_length) {
-                        ERRORF("expected no azimuth length %zu, got %zu", expected_length,
-                               line.size());
-                        return nullptr;
-                    }
-
-                    for (size_t i = 0; i < element_count; i++) {
-                        auto   no_azimuth_str = trim(line.substr(8 + 8 * i, 8));
-                        double no_azimuth;
-                        if (!parse_float(no_azimuth_str, no_azimuth)) {
-                            ERRORF("failed to parse no azimuth: %s", no_azimuth_str.c_str());
-                            return nullptr;
-                        }
-
-                        frequency->no_azimuth.push_back(no_azimuth);
-                    }
-
-                    if (antenna->dazi > 0.0) {
-                        auto dazi_count = static_cast<size_t>(360.0 / antenna->dazi) + 1;
-                        for (size_t i = 0; i < dazi_count; i++) {
-                            if (!std::getline(stream, line)) {
-                                ERRORF("failed to read azimuth %zu", i);
-                                return nullptr;
-                            }
-
-                            TRACEF("  AZI: %s", line.c_str());
-                            auto azimuth_str   = trim(line.substr(0, 8));
-                            auto azimuth_value = 0.0;
-                            if (!parse_float(azimuth_str, azimuth_value)) {
-                                ERRORF("failed to parse azimuth %zu: %s", i, azimuth_str.c_str());
-                                return nullptr;
-                            }
-
-                            if (line.size() != expected_length) {
-                                ERRORF("expected azimuth length %zu, got %zu", expected_length,
-                                       line.size());
-                                return nullptr;
-                            }
-
-                            std::vector<double> values;
-                            for (size_t j = 0; j < element_count; j++) {
-                                auto   value_str = trim(line.substr(8 + 8 * j, 8));
-                                double value;
-                                if (!parse_float(value_str, value)) {
-                                    ERRORF("failed to parse value %zu %zu: %s", i, j,
-                                           value_str.c_str());
-                                    return nullptr;
-                                }
-
-                                values.push_back(value);
-                            }
-
-                            frequency->azimuths.push_back(std::move(values));
-                        }
-                    }
-
-                    while (std::getline(stream, line)) {
-                        if (is_end_of_frequency(line)) {
-                            break;
-                        } else {
-                            TRACEF("unhandled: %s", line.c_str());
-                        }
-                    }
-
-                    TRACEF("---------------- end of frequency ----------------");
-
-                    antenna->frequencies[frequency->type] = std::move(frequency);
-                } else {
-                    TRACEF("unhandled: %s", line.c_str());
-                }
-            }
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
 
-            TRACEF("---------------- end of antenna ----------------");
-            result->antennas[antenna->id].push_back(std::move(antenna));
-        } else {
-            TRACEF("unhandled: %s", line.c_str());
-        }
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (results[i] == BlockResult::Error) return nullptr;
+        if (results[i] != BlockResult::Antenna) continue;
+        result->antennas[parsed[i].id].push_back(std::move(parsed[i]));
     }
 
     // Sort antennas by the inverse valid from time
     for (auto& pair : result->antennas) {
-        std::sort(pair.second.begin(), pair.second.end(),
-                  [](std::unique_ptr<Antenna> const& a, std::unique_ptr<Antenna> const& b) {
-                      return a->valid_from > b->valid_from;
-                  });
+        std::stable_sort(pair.second.begin(), pair.second.end(),
+                         [](Antenna const& a, Antenna const& b) {
+                             return a.valid_from > b.valid_from;
+                         });
     }
 
     return result;
 }
 
+std::unique_ptr<Antex> Antex::from_string(std::string const& data) {
+    return from_memory(data.data(), data.size());
+}
+
 std::unique_ptr<Antex> Antex::from_file(std::string const& path) {
     FUNCTION_SCOPE();
-    std::ifstream file;
-    file.open(path);
-    if (!file.is_open()) {
+    helper::MappedFile file;
+    if (!file.open(path)) {
         ERRORF("failed to open file %s", path.c_str());
         return nullptr;
     }
 
-    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    VERBOSEF("loaded %zu bytes from %s", data.size(), path.c_str());
-    return from_string(data);
+    VERBOSEF("mapped %zu bytes from %s", file.size(), path.c_str());
+    return from_memory(file.data(), file.size());
+}
+
+std::unique_ptr<Antex> Antex::from_file_cached(std::string const& path,
+                                               std::string const& snapshot_path) {
+    FUNCTION_SCOPE();
+    helper::FileIdentity source{};
+    if (!helper::file_identity(path, source)) {
+        ERRORF("failed to open file %s", path.c_str());
+        return nullptr;
+    }
+
+    helper::MappedFile snapshot;
+    uint8_t const*     payload = nullptr;
+    size_t             length  = 0;
+    if (helper::read_snapshot(snapshot_path, SNAPSHOT_MAGIC, source, snapshot, payload, length)) {
+        auto result = from_snapshot(payload, length);
+        if (result) {
+            DEBUGF("loaded %s from snapshot %s", path.c_str(), snapshot_path.c_str());
+            return result;
+        }
+        WARNF("invalid snapshot %s", snapshot_path.c_str());
+    }
+
+    auto result = from_file(path);
+    if (result) {
+        if (!helper::write_snapshot(snapshot_path, SNAPSHOT_MAGIC, source, result->to_snapshot())) {
+            WARNF("failed to write snapshot %s", snapshot_path.c_str());
+        }
+    }
+    return result;
+}
+
+// Value arrays are stored as raw doubles, loading them is a copy
+static void pack_values(msgpack::Packer& packer, std::vector<double> const& values) {
+    packer.pack_bin(reinterpret_cast<uint8_t const*>(values.data()),
+                    static_cast<uint32_t>(values.size() * sizeof(double)));
+}
+
+static bool unpack_values(msgpack::Unpacker& unpacker, std::vector<double>& values) {
+    uint8_t const* data;
+    uint32_t       length;
+    if (!unpacker.unpack_bin(data, length)) return false;
+    if (length % sizeof(double) != 0) return false;
+    values.resize(length / sizeof(double));
+    if (length > 0) memcpy(values.data(), data, length);
+    return true;
+}
+
+static void pack_time(msgpack::Packer& packer, ts::Gps const& time) {
+    msgpack::pack(packer, time.timestamp());
+}
+
+static bool unpack_time(msgpack::Unpacker& unpacker, ts::Gps& time) {
+    ts::Timestamp timestamp;
+    if (!msgpack::unpack(unpacker, timestamp)) return false;
+    time = ts::Gps{timestamp};
+    return true;
+}
+
+std::vector<uint8_t> Antex::to_snapshot() const {
+    FUNCTION_SCOPE();
+    std::vector<uint8_t> buffer;
+    msgpack::Packer      packer{buffer};
+
+    packer.pack_array_header(2);
+    packer.pack_array_header(5);
+    msgpack::pack(packer, header.version);
+    msgpack::pack(packer, header.system);
+    msgpack::pack(packer, header.pcv_type);
+    msgpack::pack(packer, header.refant_type);
+    msgpack::pack(packer, header.refant_serial);
+
+    size_t count = 0;
+    for (auto const& pair : antennas) {
+        count += pair.second.size();
+    }
+
+    packer.pack_array_header(static_cast<uint32_t>(count));
+    for (auto const& pair : antennas) {
+        for (auto const& antenna : pair.second) {
+            packer.pack_array_header(12);
+            packer.pack_int(static_cast<int64_t>(antenna.id.gnss()));
+            packer.pack_int(antenna.id.lpp_id().value);
+            packer.pack_double(antenna.dazi);
+            packer.pack_double(antenna.zen1);
+            packer.pack_double(antenna.zen2);
+            packer.pack_double(antenna.dzen);
+            packer.pack_int(antenna.frequency_count);
+            pack_time(packer, antenna.valid_from);
+            pack_time(packer, antenna.valid_until);
+            packer.pack_bool(antenna.valid_from_set);
+            packer.pack_bool(antenna.valid_until_set);
+
+            packer.pack_array_header(static_cast<uint32_t>(antenna.frequencies.size()));
+            for (auto const& frequency : antenna.frequencies) {
+                packer.pack_array_header(8);
+                packer.pack_int(static_cast<int64_t>(frequency.type));
+                msgpack::pack(packer, frequency.eccentricities);
+                packer.pack_double(frequency.dazi);
+                packer.pack_double(frequency.zen1);
+                packer.pack_double(frequency.zen2);
+                packer.pack_double(frequency.dzen);
+                pack_values(packer, frequency.no_azimuth);
+                pack_values(packer, frequency.azimuths);
+            }
+        }
+    }
+
+    return buffer;
+}
+
+static bool unpack_frequency(msgpack::Unpacker& unpacker, Frequency& frequency) {
+    uint32_t size = 0;
+    int64_t  type = 0;
+    if (!unpacker.unpack_array_header(size) || size != 8) return false;
+    if (!unpacker.unpack_int(type)) return false;
+    frequency.type = static_cast<FrequencyType>(type);
+    return msgpack::unpack(unpacker, frequency.eccentricities) &&
+           unpacker.unpack_double(frequency.dazi) && unpacker.unpack_double(frequency.zen1) &&
+           unpacker.unpack_double(frequency.zen2) && unpacker.unpack_double(frequency.dzen) &&
+           unpack_values(unpacker, frequency.no_azimuth) &&
+           unpack_values(unpacker, frequency.azimuths);
+}
+
+static bool unpack_antenna(msgpack::Unpacker& unpacker, Antenna& antenna) {
+    uint32_t size = 0;
+    int64_t  gnss = 0, lpp_id = 0;
+    if (!unpacker.unpack_array_header(size) || size != 12) return false;
+    if (!unpacker.unpack_int(gnss) || !unpacker.unpack_int(lpp_id)) return false;
+    antenna.id = SatelliteId::from_lpp(static_cast<SatelliteId::Gnss>(gnss), lpp_id);
+    if (!antenna.id.is_valid()) return false;
+
+    if (!unpacker.unpack_double(antenna.dazi) || !unpacker.unpack_double(antenna.zen1) ||
+        !unpacker.unpack_double(antenna.zen2) || !unpacker.unpack_double(antenna.dzen) ||
+        !unpacker.unpack_int(antenna.frequency_count) ||
+        !unpack_time(unpacker, antenna.valid_from) || !unpack_time(unpacker, antenna.valid_until) ||
+        !unpacker.unpack_bool(antenna.valid_from_set) ||
+        !unpacker.unpack_bool(antenna.valid_until_set)) {
+        return false;
+    }
+
+    uint32_t frequency_count = 0;
+    if (!unpacker.unpack_array_header(frequency_count)) return false;
+    antenna.frequencies.resize(frequency_count);
+    for (auto& frequency : antenna.frequencies) {
+        if (!unpack_frequency(unpacker, frequency)) return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Antex> Antex::from_snapshot(uint8_t const* data, size_t length) {
+    FUNCTION_SCOPE();
+    auto              result = std::unique_ptr<Antex>(new Antex{});
+    msgpack::Unpacker unpacker{data, length};
+
+    uint32_t size = 0;
+    if (!unpacker.unpack_array_header(size) || size != 2) return nullptr;
+    if (!unpacker.unpack_array_header(size) || size != 5) return nullptr;
+    if (!msgpack::unpack(unpacker, result->header.version) ||
+        !msgpack::unpack(unpacker, result->header.system) ||
+        !msgpack::unpack(unpacker, result->header.pcv_type) ||
+        !msgpack::unpack(unpacker, result->header.refant_type) ||
+        !msgpack::unpack(unpacker, result->header.refant_serial)) {
+        return nullptr;
+    }
+
+    // Antennas of a satellite were written in order
+    uint32_t count = 0;
+    if (!unpacker.unpack_array_header(count)) return nullptr;
+    for (uint32_t i = 0; i < count; i++) {
+        Antenna antenna{};
+        if (!unpack_antenna(unpacker, antenna)) return nullptr;
+        result->antennas[antenna.id].push_back(std::move(antenna));
+    }
+
+    if (unpacker.has_data()) return nullptr;
+    return result;
 }
 
 bool Frequency::phase_variation(double azimuth_rad, double nadir_rad,
@@ -579,21 +765,22 @@ bool Frequency::phase_variation(double azimuth_rad, double nadir_rad,
         VERBOSEF("azi: %zu %zu %.4f (%.4f) (%7.4f < %7.4f < %7.4f) %.4f", azi_index1, azi_index2,
                  azi_frac, azi, 0.0, azimuth_rad * RAD_TO_DEG, 360.0, dazi);
 
-        if (azi_index1 >= azimuths.size()) {
-            VERBOSEF("azi index oob: %zu %zu", azimuths.size(), azi_index1);
+        auto azi_count = azimuth_count();
+        if (azi_index1 >= azi_count) {
+            VERBOSEF("azi index oob: %zu %zu", azi_count, azi_index1);
             return false;
-        } else if (azi_index2 >= azimuths.size()) {
-            VERBOSEF("azi index oob: %zu %zu", azimuths.size(), azi_index2);
+        } else if (azi_index2 >= azi_count) {
+            VERBOSEF("azi index oob: %zu %zu", azi_count, azi_index2);
             return false;
         }
 
-        auto& values1 = azimuths[azi_index1];
-        auto& values2 = azimuths[azi_index2];
-        if (nadir_index1 >= values1.size()) {
-            VERBOSEF("nad index oob: %zu %zu", values1.size(), nadir_index1);
+        auto values1 = azimuth_row(azi_index1);
+        auto values2 = azimuth_row(azi_index2);
+        if (nadir_index1 >= no_azimuth.size()) {
+            VERBOSEF("nad index oob: %zu %zu", no_azimuth.size(), nadir_index1);
             return false;
-        } else if (nadir_index2 >= values1.size()) {
-            VERBOSEF("nad index oob: %zu %zu", values1.size(), nadir_index2);
+        } else if (nadir_index2 >= no_azimuth.size()) {
+            VERBOSEF("nad index oob: %zu %zu", no_azimuth.size(), nadir_index2);
             return false;
         }
 
@@ -613,17 +800,24 @@ bool Frequency::phase_variation(double azimuth_rad, double nadir_rad,
     }
 }
 
+Frequency const* Antenna::frequency(FrequencyType type) const NOEXCEPT {
+    for (auto const& frequency : frequencies) {
+        if (frequency.type == type) return &frequency;
+    }
+    return nullptr;
+}
+
 bool Antenna::phase_variation(SignalId const& signal_id, double azimuth_rad, double nadir_rad,
                               PhaseVariation& phase_variation) const {
     FUNCTION_SCOPEF("%s %s", id.name(), signal_id.name());
 
-    auto it = frequencies.find(signal_id.frequency_type());
-    if (it == frequencies.end()) {
+    auto frequency = this->frequency(signal_id.frequency_type());
+    if (!frequency) {
         VERBOSEF("missing frequency for %s", signal_id.name());
         return false;
     }
 
-    return it->second->phase_variation(azimuth_rad, nadir_rad, phase_variation);
+    return frequency->phase_variation(azimuth_rad, nadir_rad, phase_variation);
 }
 
 bool Antex::phase_variation(SatelliteId const& satellite_id, SignalId const& signal_id,
@@ -646,21 +840,21 @@ bool Antex::phase_variation(SatelliteId const& satellite_id, SignalId const& sig
 
     auto gps_time = ts::Gps{time};
     for (auto& antenna : antenna_list) {
-        if (antenna->valid_from_set && gps_time < antenna->valid_from) {
+        if (antenna.valid_from_set && gps_time < antenna.valid_from) {
             VERBOSEF("%s not valid: %s < %s", satellite_id.name(),
                      ts::Utc{gps_time}.rtklib_time_string().c_str(),
-                     ts::Utc{antenna->valid_from}.rtklib_time_string().c_str());
+                     ts::Utc{antenna.valid_from}.rtklib_time_string().c_str());
             continue;
         }
 
-        if (antenna->valid_until_set && gps_time > antenna->valid_until) {
+        if (antenna.valid_until_set && gps_time > antenna.valid_until) {
             VERBOSEF("%s not valid: %s > %s", satellite_id.name(),
                      ts::Utc{gps_time}.rtklib_time_string().c_str(),
-                     ts::Utc{antenna->valid_until}.rtklib_time_string().c_str());
+                     ts::Utc{antenna.valid_until}.rtklib_time_string().c_str());
             continue;
         }
 
-        return antenna->phase_variation(signal_id, azimuth_rad, nadir_rad, phase_variation);
+        return antenna.phase_variation(signal_id, azimuth_rad, nadir_rad, phase_variation);
     }
 
     return false;
@@ -44,14 +44,24 @@ struct AntexHeader {
 };
 
 struct Frequency {
-    FrequencyType                    type;
-    Float3                           eccentricities;
-    double                           dazi{0.0};
-    double                           zen1{0.0};
-    double                           zen2{0.0};
-    double                           dzen{0.0};
-    std::vector<double>              no_azimuth;
-    std::vector<std::vector<double>> azimuths;
+    FrequencyType type;
+    Float3        eccentricities;
+    double        dazi{0.0};
+    double        zen1{0.0};
+    double        zen2{0.0};
+    double        dzen{0.0};
+    /// One value per zenith/nadir angle from `zen1` to `zen2` in steps of `dzen`.
+    std::vector<double> no_azimuth;
+    /// Azimuth dependent values, one row of `no_azimuth.size()` values per azimuth from 0 to 360
+    /// in steps of `dazi`, stored row after row.
+    std::vector<double> azimuths;
+
+    NODISCARD size_t azimuth_count() const NOEXCEPT {
+        return no_azimuth.empty() ? 0 : azimuths.size() / no_azimuth.size();
+    }
+    NODISCARD double const* azimuth_row(size_t index) const NOEXCEPT {
+        return azimuths.data() + index * no_azimuth.size();
+    }
 
     bool phase_variation(double azimuth, double elevation, PhaseVariation& phase_variation) const;
 };
@@ -73,7 +83,10 @@ struct Antenna {
     bool        valid_from_set{false};
     bool        valid_until_set{false};
 
-    std::unordered_map<FrequencyType, std::unique_ptr<Frequency>> frequencies;
+    /// At most one entry per frequency type.
+    std::vector<Frequency> frequencies;
+
+    NODISCARD Frequency const* frequency(FrequencyType type) const NOEXCEPT;
 
     bool phase_variation(SignalId const& signal_id, double azimuth, double elevation,
                          PhaseVariation& phase_variation) const;
@@ -81,15 +94,28 @@ struct Antenna {
 
 class Antex {
 public:
-    AntexHeader                                                            header;
-    std::unordered_map<SatelliteId, std::vector<std::unique_ptr<Antenna>>> antennas;
+    AntexHeader header;
+    /// Antennas of each satellite, the most recent `valid_from` first.
+    std::unordered_map<SatelliteId, std::vector<Antenna>> antennas;
 
     bool phase_variation(SatelliteId const& satellite_id, SignalId const& signal_id,
                          ts::Tai const& time, double azimuth, double elevation,
                          PhaseVariation& phase_variation) const;
 
+    /// Parse the ANTEX file at `path`. The file is memory mapped and antenna blocks are parsed in
+    /// parallel.
     static std::unique_ptr<Antex> from_file(std::string const& path);
     static std::unique_ptr<Antex> from_string(std::string const& data);
+    static std::unique_ptr<Antex> from_memory(char const* data, size_t size);
+
+    /// Like `from_file`, but loads the binary snapshot at `snapshot_path` instead of parsing if it
+    /// was created from the current version of the file. Otherwise the file is parsed and a new
+    /// snapshot is written for the next time.
+    static std::unique_ptr<Antex> from_file_cached(std::string const& path,
+                                                   std::string const& snapshot_path);
+
+    NODISCARD std::vector<uint8_t> to_snapshot() const;
+    static std::unique_ptr<Antex>  from_snapshot(uint8_t const* data, size_t length);
 };
 
 }  // namespace antex
@@ -0,0 +1,181 @@
+#include "checksum.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CHECKSUM_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace format {
+namespace checksum {
+
+// All CRCs here are MSB-first with zero init and no final xor. A CRC of degree `d` with
+// polynomial P is computed as a 32-bit CRC with polynomial P * x^(32 - d); the result is in the
+// top `d` bits of the 32-bit state. This lets CRC-24Q, CRC-16 and CRC-8 share one table layout,
+// one slicing-by-8 loop and one carry-less multiply folding loop.
+struct CrcEngine {
+    uint32_t table[8][256];
+    uint64_t fold_128;  // x^128 mod P'
+    uint64_t fold_192;  // x^192 mod P'
+    int      shift;     // 32 - degree
+
+    CrcEngine(uint32_t polynomial, int degree) NOEXCEPT {
+        shift         = 32 - degree;
+        auto poly32   = polynomial << shift;
+        auto poly_all = (static_cast<uint64_t>(1) << 32) | poly32;
+
+        for (uint32_t i = 0; i < 256; i++) {
+            auto crc = i << 24;
+            for (int j = 0; j < 8; j++) {
+                crc = (crc & 0x80000000u) ? (crc << 1) ^ poly32 : (crc << 1);
+            }
+            table[0][i] = crc;
+        }
+
+        for (int k = 1; k < 8; k++) {
+            for (uint32_t i = 0; i < 256; i++) {
+                auto prev   = table[k - 1][i];
+                table[k][i] = (prev << 8) ^ table[0][prev >> 24];
+            }
+        }
+
+        fold_128 = xpow_mod(128, poly_all);
+        fold_192 = xpow_mod(192, poly_all);
+    }
+
+    static uint64_t xpow_mod(int n, uint64_t poly_all) NOEXCEPT {
+        uint64_t value = 1;
+        for (int i = 0; i < n; i++) {
+            value <<= 1;
+            if (value & (static_cast<uint64_t>(1) << 32)) value ^= poly_all;
+        }
+        return value;
+    }
+
+    NODISCARD uint32_t bytewise(uint8_t const* data, size_t length, uint32_t crc) const NOEXCEPT {
+        for (size_t i = 0; i < length; i++) {
+            crc = (crc << 8) ^ table[0][(crc >> 24) ^ data[i]];
+        }
+        return crc;
+    }
+
+    NODISCARD uint32_t slice8(uint8_t const* data, size_t length, uint32_t crc) const NOEXCEPT {
+        while (length >= 8) {
+            auto one = crc ^ (static_cast<uint32_t>(data[0]) << 24 |
+                              static_cast<uint32_t>(data[1]) << 16 |
+                              static_cast<uint32_t>(data[2]) << 8 | static_cast<uint32_t>(data[3]));
+            auto two = static_cast<uint32_t>(data[4]) << 24 | static_cast<uint32_t>(data[5]) << 16 |
+                       static_cast<uint32_t>(data[6]) << 8 | static_cast<uint32_t>(data[7]);
+            crc = table[7][one >> 24] ^ table[6][(one >> 16) & 0xFF] ^
+                  table[5][(one >> 8) & 0xFF] ^ table[4][one & 0xFF] ^ table[3][two >> 24] ^
+                  table[2][(two >> 16) & 0xFF] ^ table[1][(two >> 8) & 0xFF] ^
+                  table[0][two & 0xFF];
+            data += 8;
+            length -= 8;
+        }
+        return bytewise(data, length, crc);
+    }
+
+#if defined(CHECKSUM_HAVE_X86)
+    // Fold 16 bytes at a time: the state X is the 128-bit polynomial of the data consumed so far
+    // (first byte most significant). Appending 16 bytes D gives X * x^128 + D, which is congruent
+    // to X_hi * (x^192 mod P') + X_lo * (x^128 mod P') + D. The remaining 16 byte state and the
+    // tail are then run through the table implementation, which only depends on the value mod P'.
+    __attribute__((target("pclmul,ssse3"))) NODISCARD uint32_t
+    clmul(uint8_t const* data, size_t length) const NOEXCEPT {
+        if (length < 32) return slice8(data, length, 0);
+
+        auto const reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        auto const k       = _mm_set_epi64x(static_cast<long long>(fold_192),
+                                            static_cast<long long>(fold_128));
+
+        auto state = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)),
+                                      reverse);
+        data += 16;
+        length -= 16;
+
+        while (length >= 16) {
+            auto next = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)),
+                                         reverse);
+            auto hi   = _mm_clmulepi64_si128(state, k, 0x11);
+            auto lo   = _mm_clmulepi64_si128(state, k, 0x00);
+            state     = _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+            data += 16;
+            length -= 16;
+        }
+
+        uint8_t folded[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), _mm_shuffle_epi8(state, reverse));
+        auto crc = slice8(folded, sizeof(folded), 0);
+        return slice8(data, length, crc);
+    }
+#endif
+};
+
+static CrcEngine const& crc24q_engine() NOEXCEPT {
+    static CrcEngine const engine{0x1864CFBu, 24};
+    return engine;
+}
+
+static CrcEngine const& crc16_engine() NOEXCEPT {
+    static CrcEngine const engine{0x1021u, 16};
+    return engine;
+}
+
+static CrcEngine const& crc8_engine() NOEXCEPT {
+    static CrcEngine const engine{0x07u, 8};
+    return engine;
+}
+
+bool has_simd_crc() NOEXCEPT {
+#if defined(CHECKSUM_HAVE_X86)
+    static bool const supported =
+        __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+static uint32_t compute(CrcEngine const& engine, uint8_t const* data, size_t length,
+                        Implementation impl) NOEXCEPT {
+    uint32_t crc = 0;
+    switch (impl) {
+    case Implementation::Bytewise: crc = engine.bytewise(data, length, 0); break;
+    case Implementation::Slice8: crc = engine.slice8(data, length, 0); break;
+    case Implementation::Best:
+    case Implementation::Simd:
+#if defined(CHECKSUM_HAVE_X86)
+        if (has_simd_crc()) {
+            crc = engine.clmul(data, length);
+            break;
+        }
+#endif
+        crc = engine.slice8(data, length, 0);
+        break;
+    }
+    return crc >> engine.shift;
+}
+
+uint32_t crc24q(uint8_t const* data, size_t length, Implementation impl) NOEXCEPT {
+    return compute(crc24q_engine(), data, length, impl);
+}
+
+uint16_t crc16_ccitt(uint8_t const* data, size_t length, Implementation impl) NOEXCEPT {
+    return static_cast<uint16_t>(compute(crc16_engine(), data, length, impl));
+}
+
+uint32_t crc24q(uint8_t const* data, size_t length) NOEXCEPT {
+    return crc24q(data, length, Implementation::Best);
+}
+
+uint16_t crc16_ccitt(uint8_t const* data, size_t length) NOEXCEPT {
+    return crc16_ccitt(data, length, Implementation::Best);
+}
+
+uint8_t crc8(uint8_t const* data, size_t length) NOEXCEPT {
+    auto const& engine = crc8_engine();
+    return static_cast<uint8_t>(engine.slice8(data, length, 0) >> engine.shift);
+}
+
+}  // namespace checksum
+}  // namespace format
@@ -0,0 +1,121 @@
+#include "checksum.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CHECKSUM_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace format {
+namespace checksum {
+
+// The UBX checksum is two 8-bit running sums, A = sum(d[i]) and B = sum(A after each byte), both
+// mod 256. For a block of N bytes this is A' = A + sum(d[j]) and B' = B + N * A + sum((N - j) *
+// d[j]), which can be evaluated with wide accumulators; since 256 divides 2^32 the low 8 bits of
+// the 32-bit sums are exact even when they wrap.
+
+static uint16_t finish(uint32_t a, uint32_t b) NOEXCEPT {
+    return static_cast<uint16_t>(((b & 0xFF) << 8) | (a & 0xFF));
+}
+
+static void bytewise(uint8_t const* data, size_t length, uint32_t& a, uint32_t& b) NOEXCEPT {
+    for (size_t i = 0; i < length; i++) {
+        a += data[i];
+        b += a;
+    }
+}
+
+static uint16_t blocked(uint8_t const* data, size_t length) NOEXCEPT {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    while (length >= 16) {
+        uint32_t sum      = 0;
+        uint32_t weighted = 0;
+        for (uint32_t j = 0; j < 16; j++) {
+            sum += data[j];
+            weighted += (16 - j) * data[j];
+        }
+        b += 16 * a + weighted;
+        a += sum;
+        data += 16;
+        length -= 16;
+    }
+    bytewise(data, length, a, b);
+    return finish(a, b);
+}
+
+#if defined(CHECKSUM_HAVE_X86)
+__attribute__((target("avx2"))) static uint16_t avx2(uint8_t const* data, size_t length) NOEXCEPT {
+    uint32_t a = 0;
+    uint32_t b = 0;
+    if (length >= 32) {
+        auto const weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20,
+                                              19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6,
+                                              5, 4, 3, 2, 1);
+        auto const ones    = _mm256_set1_epi16(1);
+        auto const zero    = _mm256_setzero_si256();
+
+        // Per lane accumulators: `va` is the sum of bytes, `vb` the weighted sums plus 32 times
+        // the byte sum of all previous blocks (accumulated through `vp`).
+        auto va = _mm256_setzero_si256();
+        auto vb = _mm256_setzero_si256();
+        auto vp = _mm256_setzero_si256();
+        auto blocks = length / 32;
+        for (size_t i = 0; i < blocks; i++) {
+            auto bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data));
+            vp         = _mm256_add_epi32(vp, va);
+            va         = _mm256_add_epi32(va, _mm256_sad_epu8(bytes, zero));
+            vb         = _mm256_add_epi32(
+                vb, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+            data += 32;
+        }
+        vb = _mm256_add_epi32(vb, _mm256_slli_epi32(vp, 5));
+
+        uint32_t lanes_a[8];
+        uint32_t lanes_b[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes_a), va);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes_b), vb);
+        for (int i = 0; i < 8; i++) {
+            a += lanes_a[i];
+            b += lanes_b[i];
+        }
+        length -= blocks * 32;
+    }
+    bytewise(data, length, a, b);
+    return finish(a, b);
+}
+#endif
+
+bool has_simd_fletcher() NOEXCEPT {
+#if defined(CHECKSUM_HAVE_X86)
+    static bool const supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint16_t fletcher8(uint8_t const* data, size_t length, Implementation impl) NOEXCEPT {
+    switch (impl) {
+    case Implementation::Bytewise: {
+        uint32_t a = 0;
+        uint32_t b = 0;
+        bytewise(data, length, a, b);
+        return finish(a, b);
+    }
+    case Implementation::Slice8: return blocked(data, length);
+    case Implementation::Best:
+    case Implementation::Simd:
+#if defined(CHECKSUM_HAVE_X86)
+        if (has_simd_fletcher()) return avx2(data, length);
+#endif
+        return blocked(data, length);
+    }
+    return blocked(data, length);
+}
+
+uint16_t fletcher8(uint8_t const* data, size_t length) NOEXCEPT {
+    return fletcher8(data, length, Implementation::Best);
+}
+
+}  // namespace checksum
+}  // namespace format
@@ -0,0 +1,40 @@
+#pragma once
+#include <core/core.hpp>
+
+namespace format {
+namespace checksum {
+
+/// Checksum implementation. `Best` picks the fastest one supported by the CPU at runtime.
+///  - `Bytewise`: one table lookup (CRC) or one add (Fletcher) per byte.
+///  - `Slice8`: slicing-by-8 tables for CRCs, 16 byte blocks for Fletcher.
+///  - `Simd`: carry-less multiply folding for CRCs (x86 PCLMULQDQ), AVX2 for Fletcher.
+enum class Implementation {
+    Best,
+    Bytewise,
+    Slice8,
+    Simd,
+};
+
+/// CRC-24Q as used by RTCM 3 and SPARTN (poly 0x1864CFB, init 0, no reflection, no final xor).
+NODISCARD uint32_t crc24q(uint8_t const* data, size_t length) NOEXCEPT;
+/// CRC-16 CCITT as used by SPARTN (poly 0x1021, init 0, no reflection, no final xor).
+NODISCARD uint16_t crc16_ccitt(uint8_t const* data, size_t length) NOEXCEPT;
+/// CRC-8 as used by SPARTN (poly 0x07, init 0, no reflection, no final xor).
+NODISCARD uint8_t crc8(uint8_t const* data, size_t length) NOEXCEPT;
+
+/// 8-bit Fletcher checksum used by UBX, returned as `(ck_b << 8) | ck_a`.
+NODISCARD uint16_t fletcher8(uint8_t const* data, size_t length) NOEXCEPT;
+
+/// Same as above but with an explicit implementation, mainly for tests and benchmarks. Requesting
+/// an implementation that the CPU does not support falls back to the best supported one.
+NODISCARD uint32_t crc24q(uint8_t const* data, size_t length, Implementation impl) NOEXCEPT;
+NODISCARD uint16_t crc16_ccitt(uint8_t const* data, size_t length, Implementation impl) NOEXCEPT;
+NODISCARD uint16_t fletcher8(uint8_t const* data, size_t length, Implementation impl) NOEXCEPT;
+
+/// True if the `Simd` CRC implementation is supported by this CPU.
+NODISCARD bool has_simd_crc() NOEXCEPT;
+/// True if the `Simd` Fletcher implementation is supported by this CPU.
+NODISCARD bool has_simd_fletcher() NOEXCEPT;
+
+}  // namespace checksum
+}  // namespace format
@@ -0,0 +1,151 @@
+#include "demux.hpp"
+
+#include <format/checksum/checksum.hpp>
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(format, demux);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(format, demux)
+
+namespace format {
+namespace helper {
+
+// Same limits as the format parsers.
+static CONSTEXPR uint32_t UBX_MAX_PAYLOAD = 8192;
+// NMEA sentences are at most 82 characters, leave room for proprietary sentences.
+static CONSTEXPR uint32_t NMEA_MAX_LENGTH = 1024;
+
+static int hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+Demultiplexer::Demultiplexer(uint32_t formats) NOEXCEPT : mFormats(formats), mDiscarded(0) {
+    mFrame.reserve(1024);
+}
+
+Demultiplexer::~Demultiplexer() NOEXCEPT = default;
+
+char const* Demultiplexer::name() const NOEXCEPT {
+    return "DEMUX";
+}
+
+bool Demultiplexer::next(Frame& frame) NOEXCEPT {
+    FUNCTION_SCOPE();
+    for (;;) {
+        auto before = buffer_length();
+        skip_to_frame_start(mFormats);
+        mDiscarded += before - buffer_length();
+        if (buffer_length() < 1) return false;
+
+        uint32_t format = 0;
+        auto     result = Result::Invalid;
+        switch (peek(0)) {
+        case 0xD3:
+            format = FRAME_RTCM;
+            result = try_rtcm();
+            break;
+        case 0xB5:
+            format = FRAME_UBX;
+            result = try_ubx();
+            break;
+        case '$':
+            format = FRAME_NMEA;
+            result = try_nmea();
+            break;
+        default: break;
+        }
+
+        if (result == Result::NeedMore) {
+            return false;
+        } else if (result == Result::Invalid) {
+            skip(1u);
+            mDiscarded++;
+            continue;
+        }
+
+        frame.format = format;
+        frame.data   = mFrame.data();
+        frame.length = static_cast<uint32_t>(mFrame.size());
+        skip(frame.length);
+        VERBOSEF("frame: %u bytes (format %u)", frame.length, frame.format);
+        return true;
+    }
+}
+
+Demultiplexer::Result Demultiplexer::try_rtcm() NOEXCEPT {
+    if (buffer_length() < 3) return Result::NeedMore;
+    if ((peek(1) & 0xFC) != 0) return Result::Invalid;
+
+    auto payload_length = static_cast<uint32_t>((peek(1) & 0x03) << 8 | peek(2));
+    auto message_length = 3 + payload_length + 3;
+    if (buffer_length() < message_length) return Result::NeedMore;
+
+    mFrame.resize(message_length);
+    copy_to_buffer(mFrame.data(), message_length);
+
+    auto expected = (static_cast<uint32_t>(mFrame[message_length - 3]) << 16) |
+                    (static_cast<uint32_t>(mFrame[message_length - 2]) << 8) |
+                    static_cast<uint32_t>(mFrame[message_length - 1]);
+    if (checksum::crc24q(mFrame.data(), message_length - 3) != expected) return Result::Invalid;
+    return Result::Frame;
+}
+
+Demultiplexer::Result Demultiplexer::try_ubx() NOEXCEPT {
+    if (buffer_length() < 2) return Result::NeedMore;
+    if (peek(1) != 0x62) return Result::Invalid;
+    if (buffer_length() < 6) return Result::NeedMore;
+
+    auto payload_length = static_cast<uint32_t>(peek(4)) | (static_cast<uint32_t>(peek(5)) << 8);
+    if (payload_length > UBX_MAX_PAYLOAD) return Result::Invalid;
+    auto message_length = 6 + payload_length + 2;
+    if (buffer_length() < message_length) return Result::NeedMore;
+
+    mFrame.resize(message_length);
+    copy_to_buffer(mFrame.data(), message_length);
+
+    auto expected = static_cast<uint16_t>(mFrame[message_length - 2] |
+                                          (mFrame[message_length - 1] << 8));
+    if (checksum::fletcher8(mFrame.data() + 2, message_length - 4) != expected)
+        return Result::Invalid;
+    return Result::Frame;
+}
+
+Demultiplexer::Result Demultiplexer::try_nmea() NOEXCEPT {
+    // '$' [data] '*XY' ['\r'] '\n'
+    auto end       = find(1, '\n', '$');
+    auto available = end < buffer_length() ? end + 1 : buffer_length();
+    if (available > NMEA_MAX_LENGTH) return Result::Invalid;
+
+    mFrame.resize(available);
+    copy_to_buffer(mFrame.data(), available);
+
+    // sentences are printable ASCII, reject binary data early instead of waiting for a line ending
+    for (uint32_t i = 1; i < available; i++) {
+        auto c = mFrame[i];
+        if ((c < 0x20 || c > 0x7E) && c != '\r' && c != '\n') return Result::Invalid;
+    }
+
+    if (end >= buffer_length()) return Result::NeedMore;
+    if (mFrame[end] == '$') return Result::Invalid;
+
+    auto content_end = end;
+    if (content_end > 0 && mFrame[content_end - 1] == '\r') content_end--;
+    if (content_end < 4 || mFrame[content_end - 3] != '*') return Result::Invalid;
+
+    auto hi = hex_value(mFrame[content_end - 2]);
+    auto lo = hex_value(mFrame[content_end - 1]);
+    if (hi < 0 || lo < 0) return Result::Invalid;
+
+    uint8_t computed = 0;
+    for (uint32_t i = 1; i < content_end - 3; i++) {
+        computed ^= mFrame[i];
+    }
+    if (computed != ((hi << 4) | lo)) return Result::Invalid;
+    return Result::Frame;
+}
+
+}  // namespace helper
+}  // namespace format
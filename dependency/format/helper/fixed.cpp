@@ -0,0 +1,169 @@
+#include "fixed.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace format {
+namespace helper {
+
+// Powers of ten that are exactly representable as a double
+static CONSTEXPR double EXACT_POWERS[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+static CONSTEXPR int MAX_EXACT_POWER = 22;
+// Any 15 digit integer is exactly representable as a double
+static CONSTEXPR int MAX_EXACT_DIGITS = 15;
+// Fixed-width fields are short, longer input is rejected instead of being truncated
+static CONSTEXPR long MAX_LENGTH = 64;
+
+static inline bool is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline void trim(char const*& begin, char const*& end) {
+    while (begin < end && is_blank(*begin))
+        begin++;
+    while (end > begin && is_blank(end[-1]))
+        end--;
+}
+
+bool parse_double(char const* begin, char const* end, double& value) NOEXCEPT {
+    trim(begin, end);
+    if (begin == end || end - begin > MAX_LENGTH) return false;
+
+    auto p        = begin;
+    auto negative = false;
+    if (*p == '+' || *p == '-') {
+        negative = *p == '-';
+        p++;
+    }
+
+    // Significant digits without leading zeros, `exponent` is the power of ten of the last digit
+    char digits[MAX_LENGTH];
+    int  digit_count = 0;
+    int  exponent    = 0;
+    bool has_digits  = false;
+    for (; p < end && is_digit(*p); p++) {
+        has_digits = true;
+        if (digit_count == 0 && *p == '0') continue;
+        digits[digit_count++] = *p;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && is_digit(*p); p++) {
+            has_digits = true;
+            exponent--;
+            if (digit_count == 0 && *p == '0') continue;
+            digits[digit_count++] = *p;
+        }
+    }
+    if (!has_digits) return false;
+
+    if (p < end && (*p == 'E' || *p == 'e' || *p == 'D' || *p == 'd')) {
+        p++;
+        auto exponent_negative = false;
+        if (p < end && (*p == '+' || *p == '-')) {
+            exponent_negative = *p == '-';
+            p++;
+        }
+        if (p == end || !is_digit(*p)) return false;
+
+        int written = 0;
+        for (; p < end && is_digit(*p); p++) {
+            // Saturate, anything this large is infinity or zero anyway
+            if (written < 100000) written = written * 10 + (*p - '0');
+        }
+        exponent += exponent_negative ? -written : written;
+    }
+    if (p != end) return false;
+
+    if (digit_count == 0) {
+        value = negative ? -0.0 : 0.0;
+        return true;
+    }
+
+    // Exact mantissa and power of ten, a single multiplication or division is correctly rounded
+    if (digit_count <= MAX_EXACT_DIGITS && exponent >= -MAX_EXACT_POWER &&
+        exponent <= MAX_EXACT_POWER) {
+        uint64_t mantissa = 0;
+        for (int i = 0; i < digit_count; i++) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(digits[i] - '0');
+        }
+
+        auto result = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            result /= EXACT_POWERS[-exponent];
+        } else {
+            result *= EXACT_POWERS[exponent];
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    // Rare in practice, let strtod round. Without a decimal point the result does not depend on
+    // the locale.
+    char buffer[MAX_LENGTH + 16];
+    snprintf(buffer, sizeof(buffer), "%.*se%d", digit_count, digits, exponent);
+    auto result = strtod(buffer, nullptr);
+    value       = negative ? -result : result;
+    return true;
+}
+
+bool parse_int(char const* begin, char const* end, int64_t& value) NOEXCEPT {
+    trim(begin, end);
+    if (begin == end) return false;
+
+    auto p        = begin;
+    auto negative = false;
+    if (*p == '+' || *p == '-') {
+        negative = *p == '-';
+        p++;
+    }
+    if (p == end) return false;
+
+    uint64_t result = 0;
+    for (; p < end; p++) {
+        if (!is_digit(*p)) return false;
+        auto digit = static_cast<uint64_t>(*p - '0');
+        if (result > (static_cast<uint64_t>(INT64_MAX) - digit) / 10) return false;
+        result = result * 10 + digit;
+    }
+
+    value = negative ? -static_cast<int64_t>(result) : static_cast<int64_t>(result);
+    return true;
+}
+
+static inline void column(char const* line, size_t length, size_t offset, size_t width,
+                          char const*& begin, char const*& end) {
+    if (offset >= length) {
+        begin = end = line + length;
+        return;
+    }
+
+    begin = line + offset;
+    end   = line + (offset + width < length ? offset + width : length);
+}
+
+bool column_double(char const* line, size_t length, size_t offset, size_t width,
+                   double& value) NOEXCEPT {
+    char const* begin;
+    char const* end;
+    column(line, length, offset, width, begin, end);
+    return parse_double(begin, end, value);
+}
+
+bool column_int(char const* line, size_t length, size_t offset, size_t width,
+                int64_t& value) NOEXCEPT {
+    char const* begin;
+    char const* end;
+    column(line, length, offset, width, begin, end);
+    return parse_int(begin, end, value);
+}
+
+}  // namespace helper
+}  // namespace format
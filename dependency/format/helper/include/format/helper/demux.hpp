@@ -0,0 +1,52 @@
+#pragma once
+#include <core/core.hpp>
+#include <format/helper/parser.hpp>
+#include <format/helper/scan.hpp>
+
+#include <vector>
+
+namespace format {
+namespace helper {
+
+/// A complete, checksum-verified frame extracted by `Demultiplexer`.
+struct Frame {
+    uint32_t       format;  // one of FRAME_RTCM, FRAME_UBX or FRAME_NMEA
+    uint8_t const* data;
+    uint32_t       length;
+};
+
+/// Splits a mixed RTCM/UBX/NMEA byte stream into frames in one pass. Frame starts are found with
+/// `find_frame_start`, and a candidate is only accepted once its length and checksum have been
+/// verified, so bytes inside a valid frame are never handed to another format. Bytes that are not
+/// part of any frame are dropped.
+class Demultiplexer : public Parser {
+public:
+    EXPLICIT Demultiplexer(uint32_t formats) NOEXCEPT;
+    ~Demultiplexer() NOEXCEPT override;
+
+    NODISCARD char const* name() const NOEXCEPT override;
+
+    /// Extract the next frame. `frame.data` is valid until the next call.
+    NODISCARD bool next(Frame& frame) NOEXCEPT;
+
+    /// Number of bytes dropped because they were not part of a valid frame.
+    NODISCARD uint64_t discarded() const NOEXCEPT { return mDiscarded; }
+
+private:
+    enum class Result {
+        Frame,
+        Invalid,
+        NeedMore,
+    };
+
+    Result try_rtcm() NOEXCEPT;
+    Result try_ubx() NOEXCEPT;
+    Result try_nmea() NOEXCEPT;
+
+    uint32_t             mFormats;
+    uint64_t             mDiscarded;
+    std::vector<uint8_t> mFrame;
+};
+
+}  // namespace helper
+}  // namespace format
@@ -0,0 +1,23 @@
+#pragma once
+#include <core/core.hpp>
+
+namespace format {
+namespace helper {
+
+/// Parse a floating point number from `[begin, end)`. Leading and trailing blanks are ignored and
+/// the Fortran exponent letters 'D'/'d' are accepted as well as 'E'/'e'. The result does not
+/// depend on the current locale and is correctly rounded. Fails for blank or malformed input.
+NODISCARD bool parse_double(char const* begin, char const* end, double& value) NOEXCEPT;
+
+/// Parse a decimal integer from `[begin, end)`, leading and trailing blanks are ignored.
+NODISCARD bool parse_int(char const* begin, char const* end, int64_t& value) NOEXCEPT;
+
+/// Parse the fixed-width column `[offset, offset + width)` of a line with `length` bytes. The part
+/// of the column past the end of the line is treated as blank.
+NODISCARD bool column_double(char const* line, size_t length, size_t offset, size_t width,
+                             double& value) NOEXCEPT;
+NODISCARD bool column_int(char const* line, size_t length, size_t offset, size_t width,
+                          int64_t& value) NOEXCEPT;
+
+}  // namespace helper
+}  // namespace format
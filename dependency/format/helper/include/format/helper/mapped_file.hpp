@@ -0,0 +1,48 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <string>
+
+namespace format {
+namespace helper {
+
+/// Read-only memory mapping of a whole file. The pages are only read when they are touched, so
+/// opening a large file is cheap and parsing it does not copy it into a buffer first.
+class MappedFile {
+public:
+    MappedFile() NOEXCEPT;
+    ~MappedFile() NOEXCEPT;
+
+    MappedFile(MappedFile const&)            = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+    MappedFile(MappedFile&& other) NOEXCEPT;
+    MappedFile& operator=(MappedFile&& other) NOEXCEPT;
+
+    /// Map the file at `path`, an empty file is opened without a mapping.
+    NODISCARD bool open(std::string const& path) NOEXCEPT;
+    void           close() NOEXCEPT;
+
+    NODISCARD bool        is_open() const NOEXCEPT { return mOpen; }
+    NODISCARD char const* data() const NOEXCEPT { return static_cast<char const*>(mData); }
+    NODISCARD size_t      size() const NOEXCEPT { return mSize; }
+
+private:
+    void*  mData;
+    size_t mSize;
+    bool   mOpen;
+};
+
+/// Size and modification time of a file, used to tell if a file changed since it was read.
+struct FileIdentity {
+    uint64_t size;
+    int64_t  modified_ns;
+
+    NODISCARD bool operator==(FileIdentity const& other) const NOEXCEPT {
+        return size == other.size && modified_ns == other.modified_ns;
+    }
+};
+
+NODISCARD bool file_identity(std::string const& path, FileIdentity& identity) NOEXCEPT;
+
+}  // namespace helper
+}  // namespace format
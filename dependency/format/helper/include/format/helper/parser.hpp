@@ -2,10 +2,12 @@
 #include <core/core.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace format {
 namespace helper {
 
+class MessagePool;
 class Parser {
 public:
     EXPLICIT Parser() NOEXCEPT;
@@ -19,6 +21,20 @@ public:
     NODISCARD uint32_t buffer_length() const NOEXCEPT;
     NODISCARD uint32_t available_space() const NOEXCEPT;
 
+    /// Contiguous free space at the write position, to read new data into without a copy. Returns
+    /// its length; `commit` appends the first `length` bytes written there.
+    NODISCARD uint32_t write_space(uint8_t*& data) NOEXCEPT;
+    void               commit(uint32_t length) NOEXCEPT;
+    /// Whether `data` points into the parser buffer, i.e. was read into `write_space`.
+    NODISCARD bool contains(uint8_t const* data) const NOEXCEPT {
+        return data >= mBuffer && data < mBuffer + mBufferCapacity;
+    }
+
+    /// Allocate messages and their raw data from a `MessagePool` owned by the parser. Messages
+    /// return their memory to the pool when they are destroyed, also after the parser is gone.
+    void                   set_pooled(bool pooled) NOEXCEPT;
+    NODISCARD MessagePool* pool() const NOEXCEPT { return mPool; }
+
 protected:
     NODISCARD uint8_t peek(uint32_t index) const NOEXCEPT;
     void              skip(uint32_t length) NOEXCEPT;
@@ -26,11 +42,26 @@ protected:
 
     void copy_to_buffer(uint8_t* data, size_t length) NOEXCEPT;
 
+    /// A copy of `length` bytes of `data`, in a recycled buffer when pooled.
+    NODISCARD std::vector<uint8_t> make_buffer(uint8_t const* data, size_t length) NOEXCEPT;
+
+    /// Skip to the first buffered byte that may start a frame of one of `formats` (see scan.hpp).
+    /// The buffer is left empty if there is no candidate.
+    void skip_to_frame_start(uint32_t formats) NOEXCEPT;
+    /// Index of the first buffered byte equal to `a` or `b` at or after `offset`, or
+    /// `buffer_length()` if there is none.
+    NODISCARD uint32_t find(uint32_t offset, uint8_t a, uint8_t b) const NOEXCEPT;
+
+    /// Length of the contiguous run of buffered bytes starting at the read position.
+    NODISCARD uint32_t contiguous_length() const NOEXCEPT;
+
 private:
     uint8_t* mBuffer;
     uint32_t mBufferCapacity;
     uint32_t mBufferRead;
     uint32_t mBufferWrite;
+
+    MessagePool* mPool;
 };
 
 }  // namespace helper
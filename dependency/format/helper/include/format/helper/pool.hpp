@@ -0,0 +1,84 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace format {
+namespace helper {
+
+/// Recycles message allocations for a parser in pooled mode.
+///
+/// Message base classes route `operator new`/`operator delete` through `allocate`/`deallocate`.
+/// While a `Scope` is active on the current thread, messages are allocated from its pool and go
+/// back to it when the message is destroyed, regardless of which thread destroys it. Raw frame
+/// buffers are recycled with `acquire_buffer`/`recycle_buffer` so they keep their capacity.
+///
+/// The pool is reference counted: the owner and every outstanding allocation hold a reference,
+/// so messages can outlive the parser that created them.
+class MessagePool {
+public:
+    struct Stats {
+        uint64_t hits;    // allocations served from a free list
+        uint64_t misses;  // allocations that went to the heap
+    };
+
+    /// RAII helper that makes `pool` the current pool on this thread.
+    class Scope {
+    public:
+        EXPLICIT Scope(MessagePool* pool) NOEXCEPT;
+        ~Scope() NOEXCEPT;
+
+        Scope(Scope const&)            = delete;
+        Scope& operator=(Scope const&) = delete;
+
+    private:
+        MessagePool* mPrevious;
+    };
+
+    /// Create a pool with one reference held by the caller.
+    NODISCARD static MessagePool* create() NOEXCEPT;
+
+    void retain() NOEXCEPT;
+    void release() NOEXCEPT;
+
+    /// The pool of the active `Scope` on this thread, or null.
+    NODISCARD static MessagePool* current() NOEXCEPT;
+
+    /// Allocate `size` bytes from `pool`, or from the heap if `pool` is null or `size` is larger
+    /// than the largest size class.
+    NODISCARD static void* allocate(MessagePool* pool, size_t size);
+    /// Return memory from `allocate` to wherever it came from.
+    static void deallocate(void* pointer) NOEXCEPT;
+
+    /// An empty buffer, with capacity if a recycled one is available.
+    NODISCARD std::vector<uint8_t> acquire_buffer() NOEXCEPT;
+    void                           recycle_buffer(std::vector<uint8_t>&& buffer) NOEXCEPT;
+
+    NODISCARD Stats stats() const NOEXCEPT;
+
+private:
+    MessagePool() NOEXCEPT;
+    ~MessagePool() NOEXCEPT;
+
+    static CONSTEXPR size_t SIZE_CLASS       = 64;
+    static CONSTEXPR size_t SIZE_CLASS_COUNT = 8;   // up to 512 bytes
+    static CONSTEXPR size_t MAX_FREE         = 64;  // per size class
+    static CONSTEXPR size_t MAX_BUFFERS      = 64;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::atomic<long>                 mReferences;
+    mutable std::mutex                mMutex;
+    FreeBlock*                        mFree[SIZE_CLASS_COUNT];
+    size_t                            mFreeCount[SIZE_CLASS_COUNT];
+    std::vector<std::vector<uint8_t>> mBuffers;
+    uint64_t                          mHits;
+    uint64_t                          mMisses;
+};
+
+}  // namespace helper
+}  // namespace format
@@ -0,0 +1,21 @@
+#pragma once
+#include <core/core.hpp>
+
+namespace format {
+namespace helper {
+
+/// Frame formats recognized by `find_frame_start` and `Demultiplexer`.
+static CONSTEXPR uint32_t FRAME_RTCM = 1u << 0;  // 0xD3
+static CONSTEXPR uint32_t FRAME_UBX  = 1u << 1;  // 0xB5 0x62
+static CONSTEXPR uint32_t FRAME_NMEA = 1u << 2;  // '$'
+
+/// Index of the first byte in `data` that may start a frame of one of `formats`, or `length` if
+/// there is none. A trailing 0xB5 is reported as a UBX candidate since the following byte is not
+/// available yet. Scans 16 bytes per step with SSE2 and 8 bytes per step elsewhere.
+NODISCARD size_t find_frame_start(uint8_t const* data, size_t length, uint32_t formats) NOEXCEPT;
+
+/// Index of the first byte in `data` equal to `a` or `b`, or `length` if there is none.
+NODISCARD size_t find_byte(uint8_t const* data, size_t length, uint8_t a, uint8_t b) NOEXCEPT;
+
+}  // namespace helper
+}  // namespace format
@@ -0,0 +1,25 @@
+#pragma once
+#include <core/core.hpp>
+#include <format/helper/mapped_file.hpp>
+
+#include <string>
+#include <vector>
+
+namespace format {
+namespace helper {
+
+/// Binary snapshot of a parsed text file. The snapshot records the identity of the file it was
+/// created from and `read_snapshot` rejects it once that file has changed, so a stale snapshot is
+/// never used. `magic` identifies the payload format and must change when the payload does.
+NODISCARD bool write_snapshot(std::string const& path, uint32_t magic, FileIdentity const& source,
+                              std::vector<uint8_t> const& payload) NOEXCEPT;
+
+/// Path of the snapshot for `source` in `directory`, named after the file name of `source`.
+NODISCARD std::string snapshot_path(std::string const& directory, std::string const& source);
+
+/// Map the snapshot at `path` and return its payload, which is valid while `file` is open.
+NODISCARD bool read_snapshot(std::string const& path, uint32_t magic, FileIdentity const& source,
+                             MappedFile& file, uint8_t const*& payload, size_t& length) NOEXCEPT;
+
+}  // namespace helper
+}  // namespace format
@@ -0,0 +1,89 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace format {
+namespace helper {
+
+MappedFile::MappedFile() NOEXCEPT : mData(nullptr), mSize(0), mOpen(false) {}
+
+MappedFile::~MappedFile() NOEXCEPT {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) NOEXCEPT : mData(other.mData),
+                                                       mSize(other.mSize),
+                                                       mOpen(other.mOpen) {
+    other.mData = nullptr;
+    other.mSize = 0;
+    other.mOpen = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) NOEXCEPT {
+    if (this != &other) {
+        close();
+        mData       = other.mData;
+        mSize       = other.mSize;
+        mOpen       = other.mOpen;
+        other.mData = nullptr;
+        other.mSize = 0;
+        other.mOpen = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(std::string const& path) NOEXCEPT {
+    close();
+
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat st {};
+    if (::fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    if (size > 0) {
+        auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+
+        // The whole file is about to be parsed, possibly by several threads, let the kernel read
+        // it ahead
+        ::madvise(data, size, MADV_WILLNEED);
+        mData = data;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    mSize = size;
+    mOpen = true;
+    return true;
+}
+
+void MappedFile::close() NOEXCEPT {
+    if (mData) ::munmap(mData, mSize);
+    mData = nullptr;
+    mSize = 0;
+    mOpen = false;
+}
+
+bool file_identity(std::string const& path, FileIdentity& identity) NOEXCEPT {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) < 0) return false;
+
+    identity.size        = static_cast<uint64_t>(st.st_size);
+    identity.modified_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000ll +
+                           static_cast<int64_t>(st.st_mtim.tv_nsec);
+    return true;
+}
+
+}  // namespace helper
+}  // namespace format
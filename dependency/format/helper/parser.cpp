@@ -1,4 +1,8 @@
 #include "parser.hpp"
+#include "pool.hpp"
+#include "scan.hpp"
+
+#include <cstring>
 
 #include <loglet/loglet.hpp>
 
@@ -11,7 +15,8 @@ namespace helper {
 
 static CONSTEXPR uint32_t PARSER_BUFFER_SIZE = 32 * 4096;
 
-Parser::Parser() NOEXCEPT : mBuffer(nullptr), mBufferCapacity(0), mBufferRead(0), mBufferWrite(0) {
+Parser::Parser() NOEXCEPT
+    : mBuffer(nullptr), mBufferCapacity(0), mBufferRead(0), mBufferWrite(0), mPool(nullptr) {
     FUNCTION_SCOPE();
     mBuffer         = new uint8_t[PARSER_BUFFER_SIZE];
     mBufferCapacity = PARSER_BUFFER_SIZE;
@@ -22,6 +27,9 @@ Parser::~Parser() NOEXCEPT {
     if (mBuffer != nullptr) {
         delete[] mBuffer;
     }
+    if (mPool != nullptr) {
+        mPool->release();
+    }
 }
 
 bool Parser::append(uint8_t const* data, size_t length) NOEXCEPT {
@@ -33,14 +41,18 @@ bool Parser::append(uint8_t const* data, size_t length) NOEXCEPT {
         return false;
     }
 
-    // copy data to buffer
-    for (uint32_t i = 0; i < length32; i++) {
-        mBuffer[mBufferWrite] = data[i];
-        mBufferWrite          = (mBufferWrite + 1) % mBufferCapacity;
-        if (mBufferWrite == mBufferRead) {
-            // buffer overflow
-            mBufferRead = (mBufferRead + 1) % mBufferCapacity;
-        }
+    // copy data to buffer, in at most two chunks if the write position wraps around
+    auto previous_length = buffer_length();
+    auto first           = length32 < mBufferCapacity - mBufferWrite ? length32 :
+                                                                    mBufferCapacity - mBufferWrite;
+    memcpy(mBuffer + mBufferWrite, data, first);
+    memcpy(mBuffer, data + first, length32 - first);
+    mBufferWrite = (mBufferWrite + length32) % mBufferCapacity;
+
+    auto new_length = static_cast<uint64_t>(previous_length) + length32;
+    if (new_length >= mBufferCapacity) {
+        // buffer overflow, drop the oldest data
+        mBufferRead = (mBufferWrite + 1) % mBufferCapacity;
     }
 
     VERBOSEF("appended %u bytes", length32);
@@ -65,6 +77,21 @@ uint32_t Parser::available_space() const NOEXCEPT {
     return mBufferCapacity - buffer_length() - 1;
 }
 
+uint32_t Parser::write_space(uint8_t*& data) NOEXCEPT {
+    data = mBuffer + mBufferWrite;
+    // One byte is always left free, a full buffer would look empty
+    if (mBufferWrite >= mBufferRead) {
+        auto space = mBufferCapacity - mBufferWrite;
+        return mBufferRead == 0 ? space - 1 : space;
+    }
+    return mBufferRead - mBufferWrite - 1;
+}
+
+void Parser::commit(uint32_t length) NOEXCEPT {
+    VERBOSEF("committed %u bytes", length);
+    mBufferWrite = (mBufferWrite + length) % mBufferCapacity;
+}
+
 uint8_t Parser::peek(uint32_t index) const NOEXCEPT {
     if (index >= buffer_length()) {
         // NOTE(ewasjon): the caller should check buffer_length() before calling peek
@@ -91,10 +118,67 @@ void Parser::copy_to_buffer(uint8_t* data, size_t length) NOEXCEPT {
         length32 = available;
     }
 
-    for (uint32_t i = 0; i < length32; i++) {
-        data[i] = mBuffer[(mBufferRead + i) % mBufferCapacity];
+    auto first = contiguous_length();
+    if (first > length32) first = length32;
+    memcpy(data, mBuffer + mBufferRead, first);
+    memcpy(data + first, mBuffer, length32 - first);
+}
+
+void Parser::set_pooled(bool pooled) NOEXCEPT {
+    if (pooled && mPool == nullptr) {
+        mPool = MessagePool::create();
+    } else if (!pooled && mPool != nullptr) {
+        mPool->release();
+        mPool = nullptr;
     }
 }
 
+std::vector<uint8_t> Parser::make_buffer(uint8_t const* data, size_t length) NOEXCEPT {
+    if (mPool == nullptr) {
+        return std::vector<uint8_t>(data, data + length);
+    }
+
+    auto buffer = mPool->acquire_buffer();
+    buffer.assign(data, data + length);
+    return buffer;
+}
+
+uint32_t Parser::contiguous_length() const NOEXCEPT {
+    if (mBufferWrite >= mBufferRead) {
+        return mBufferWrite - mBufferRead;
+    } else {
+        return mBufferCapacity - mBufferRead;
+    }
+}
+
+void Parser::skip_to_frame_start(uint32_t formats) NOEXCEPT {
+    auto length = buffer_length();
+    auto first  = contiguous_length();
+    auto index  = static_cast<uint32_t>(find_frame_start(mBuffer + mBufferRead, first, formats));
+    if (index == first && first < length) {
+        index += static_cast<uint32_t>(find_frame_start(mBuffer, length - first, formats));
+    }
+    skip(index);
+}
+
+uint32_t Parser::find(uint32_t offset, uint8_t a, uint8_t b) const NOEXCEPT {
+    auto length = buffer_length();
+    auto first  = contiguous_length();
+    if (offset < first) {
+        auto index = offset + static_cast<uint32_t>(find_byte(mBuffer + mBufferRead + offset,
+                                                              first - offset, a, b));
+        if (index < first) return index;
+        offset = first;
+    }
+
+    if (offset < length) {
+        // the second chunk starts at the beginning of the buffer
+        auto start = offset - first;
+        return offset + static_cast<uint32_t>(find_byte(mBuffer + start, length - offset, a, b));
+    }
+
+    return length;
+}
+
 }  // namespace helper
 }  // namespace format
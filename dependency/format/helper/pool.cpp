@@ -0,0 +1,146 @@
+#include "pool.hpp"
+
+#include <new>
+
+namespace format {
+namespace helper {
+
+// Every allocation is prefixed with a header that records the owning pool (null for heap
+// allocations) and the size class, so `deallocate` does not need to know who allocated it.
+struct alignas(16) BlockHeader {
+    MessagePool* pool;
+    size_t       size_class;
+};
+
+static thread_local MessagePool* gCurrentPool = nullptr;
+
+MessagePool::Scope::Scope(MessagePool* pool) NOEXCEPT : mPrevious(gCurrentPool) {
+    gCurrentPool = pool;
+}
+
+MessagePool::Scope::~Scope() NOEXCEPT {
+    gCurrentPool = mPrevious;
+}
+
+MessagePool::MessagePool() NOEXCEPT : mReferences(1), mHits(0), mMisses(0) {
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+        mFree[i]      = nullptr;
+        mFreeCount[i] = 0;
+    }
+    mBuffers.reserve(MAX_BUFFERS);
+}
+
+MessagePool::~MessagePool() NOEXCEPT {
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+        while (mFree[i] != nullptr) {
+            auto block = mFree[i];
+            mFree[i]   = block->next;
+            ::operator delete(reinterpret_cast<BlockHeader*>(block) - 1);
+        }
+    }
+}
+
+MessagePool* MessagePool::create() NOEXCEPT {
+    return new MessagePool();
+}
+
+void MessagePool::retain() NOEXCEPT {
+    mReferences.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MessagePool::release() NOEXCEPT {
+    if (mReferences.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+MessagePool* MessagePool::current() NOEXCEPT {
+    return gCurrentPool;
+}
+
+void* MessagePool::allocate(MessagePool* pool, size_t size) {
+    auto size_class = (size + SIZE_CLASS - 1) / SIZE_CLASS;
+    if (pool == nullptr || size_class == 0 || size_class > SIZE_CLASS_COUNT) {
+        auto header        = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+        header->pool       = nullptr;
+        header->size_class = 0;
+        return header + 1;
+    }
+
+    BlockHeader* header = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(pool->mMutex);
+        auto&                       free = pool->mFree[size_class - 1];
+        if (free != nullptr) {
+            header = reinterpret_cast<BlockHeader*>(free) - 1;
+            free   = free->next;
+            pool->mFreeCount[size_class - 1]--;
+            pool->mHits++;
+        } else {
+            pool->mMisses++;
+        }
+    }
+
+    if (header == nullptr) {
+        header = static_cast<BlockHeader*>(
+            ::operator new(sizeof(BlockHeader) + size_class * SIZE_CLASS));
+    }
+
+    header->pool       = pool;
+    header->size_class = size_class;
+    pool->retain();
+    return header + 1;
+}
+
+void MessagePool::deallocate(void* pointer) NOEXCEPT {
+    if (pointer == nullptr) return;
+
+    auto header = static_cast<BlockHeader*>(pointer) - 1;
+    auto pool   = header->pool;
+    if (pool == nullptr) {
+        ::operator delete(header);
+        return;
+    }
+
+    auto index    = header->size_class - 1;
+    bool recycled = false;
+    {
+        std::lock_guard<std::mutex> lock(pool->mMutex);
+        if (pool->mFreeCount[index] < MAX_FREE) {
+            auto block         = reinterpret_cast<FreeBlock*>(pointer);
+            block->next        = pool->mFree[index];
+            pool->mFree[index] = block;
+            pool->mFreeCount[index]++;
+            recycled = true;
+        }
+    }
+
+    if (!recycled) ::operator delete(header);
+    pool->release();
+}
+
+std::vector<uint8_t> MessagePool::acquire_buffer() NOEXCEPT {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mBuffers.empty()) return {};
+    auto buffer = std::move(mBuffers.back());
+    mBuffers.pop_back();
+    return buffer;
+}
+
+void MessagePool::recycle_buffer(std::vector<uint8_t>&& buffer) NOEXCEPT {
+    if (buffer.capacity() == 0) return;
+    buffer.clear();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mBuffers.size() < MAX_BUFFERS) {
+        mBuffers.push_back(std::move(buffer));
+    }
+}
+
+MessagePool::Stats MessagePool::stats() const NOEXCEPT {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return Stats{mHits, mMisses};
+}
+
+}  // namespace helper
+}  // namespace format
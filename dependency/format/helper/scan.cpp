@@ -0,0 +1,115 @@
+#include "scan.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace format {
+namespace helper {
+
+static bool is_frame_start(uint8_t const* data, size_t length, size_t i, uint32_t formats) {
+    auto byte = data[i];
+    if ((formats & FRAME_RTCM) != 0 && byte == 0xD3) return true;
+    if ((formats & FRAME_NMEA) != 0 && byte == '$') return true;
+    if ((formats & FRAME_UBX) != 0 && byte == 0xB5) {
+        return i + 1 == length || data[i + 1] == 0x62;
+    }
+    return false;
+}
+
+#if !defined(__SSE2__)
+static CONSTEXPR uint64_t SWAR_ONES = 0x0101010101010101ull;
+static CONSTEXPR uint64_t SWAR_HIGH = 0x8080808080808080ull;
+
+// Non-zero if any byte in `word` equals `value`.
+static inline uint64_t swar_has(uint64_t word, uint8_t value) {
+    auto x = word ^ (SWAR_ONES * value);
+    return (x - SWAR_ONES) & ~x & SWAR_HIGH;
+}
+
+static inline uint64_t swar_load(uint8_t const* data) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+#endif
+
+static inline unsigned first_bit(unsigned mask) {
+    return static_cast<unsigned>(__builtin_ctz(mask));
+}
+
+size_t find_frame_start(uint8_t const* data, size_t length, uint32_t formats) NOEXCEPT {
+    size_t i = 0;
+#if defined(__SSE2__)
+    auto rtcm    = _mm_set1_epi8(static_cast<char>(0xD3));
+    auto nmea    = _mm_set1_epi8('$');
+    auto ubx_hi  = _mm_set1_epi8(static_cast<char>(0xB5));
+    auto ubx_lo  = _mm_set1_epi8(0x62);
+    auto has_ubx = (formats & FRAME_UBX) != 0;
+
+    // The UBX check reads one byte past the block, keep that inside the buffer.
+    for (; i + 17 <= length; i += 16) {
+        auto     block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+        unsigned mask  = 0;
+        if ((formats & FRAME_RTCM) != 0) {
+            mask |= static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, rtcm)));
+        }
+        if ((formats & FRAME_NMEA) != 0) {
+            mask |= static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, nmea)));
+        }
+        if (has_ubx) {
+            auto next = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i + 1));
+            auto pair = _mm_and_si128(_mm_cmpeq_epi8(block, ubx_hi), _mm_cmpeq_epi8(next, ubx_lo));
+            mask |= static_cast<unsigned>(_mm_movemask_epi8(pair));
+        }
+        if (mask != 0) return i + first_bit(mask);
+    }
+#else
+    for (; i + 8 <= length; i += 8) {
+        auto     word = swar_load(data + i);
+        uint64_t hit  = 0;
+        if ((formats & FRAME_RTCM) != 0) hit |= swar_has(word, 0xD3);
+        if ((formats & FRAME_NMEA) != 0) hit |= swar_has(word, '$');
+        if ((formats & FRAME_UBX) != 0) hit |= swar_has(word, 0xB5);
+        if (hit == 0) continue;
+
+        for (size_t j = i; j < i + 8; j++) {
+            if (is_frame_start(data, length, j, formats)) return j;
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
+        if (is_frame_start(data, length, i, formats)) return i;
+    }
+    return length;
+}
+
+size_t find_byte(uint8_t const* data, size_t length, uint8_t a, uint8_t b) NOEXCEPT {
+    size_t i = 0;
+#if defined(__SSE2__)
+    auto va = _mm_set1_epi8(static_cast<char>(a));
+    auto vb = _mm_set1_epi8(static_cast<char>(b));
+    for (; i + 16 <= length; i += 16) {
+        auto block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+        auto match = _mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb));
+        auto mask  = static_cast<unsigned>(_mm_movemask_epi8(match));
+        if (mask != 0) return i + first_bit(mask);
+    }
+#else
+    for (; i + 8 <= length; i += 8) {
+        auto word = swar_load(data + i);
+        if ((swar_has(word, a) | swar_has(word, b)) != 0) break;
+    }
+#endif
+
+    for (; i < length; i++) {
+        if (data[i] == a || data[i] == b) return i;
+    }
+    return length;
+}
+
+}  // namespace helper
+}  // namespace format
@@ -0,0 +1,99 @@
+#include "snapshot.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(format, snapshot);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(format, snapshot)
+
+namespace format {
+namespace helper {
+
+// Snapshots are a local cache, the header is stored in native byte order
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t source_size;
+    int64_t  source_modified_ns;
+    uint64_t payload_length;
+};
+
+std::string snapshot_path(std::string const& directory, std::string const& source) {
+    auto slash = source.find_last_of('/');
+    auto name  = slash == std::string::npos ? source : source.substr(slash + 1);
+    if (directory.empty()) return name + ".snapshot";
+    if (directory.back() == '/') return directory + name + ".snapshot";
+    return directory + "/" + name + ".snapshot";
+}
+
+bool write_snapshot(std::string const& path, uint32_t magic, FileIdentity const& source,
+                    std::vector<uint8_t> const& payload) NOEXCEPT {
+    VSCOPE_FUNCTIONF("%s", path.c_str());
+
+    SnapshotHeader header{};
+    header.magic              = magic;
+    header.source_size        = source.size;
+    header.source_modified_ns = source.modified_ns;
+    header.payload_length     = payload.size();
+
+    // Write next to the snapshot and rename, a concurrent reader never sees a partial snapshot
+    auto temporary = path + ".tmp";
+    auto file      = fopen(temporary.c_str(), "wb");
+    if (!file) {
+        WARNF("failed to create snapshot \"%s\": " ERRNO_FMT, temporary.c_str(), ERRNO_ARGS(errno));
+        return false;
+    }
+
+    auto ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !payload.empty()) ok = fwrite(payload.data(), payload.size(), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        WARNF("failed to write snapshot \"%s\": " ERRNO_FMT, path.c_str(), ERRNO_ARGS(errno));
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    DEBUGF("wrote snapshot \"%s\" (%zu bytes)", path.c_str(), payload.size());
+    return true;
+}
+
+bool read_snapshot(std::string const& path, uint32_t magic, FileIdentity const& source,
+                   MappedFile& file, uint8_t const*& payload, size_t& length) NOEXCEPT {
+    VSCOPE_FUNCTIONF("%s", path.c_str());
+
+    if (!file.open(path)) {
+        VERBOSEF("no snapshot \"%s\"", path.c_str());
+        return false;
+    }
+
+    SnapshotHeader header{};
+    if (file.size() < sizeof(header)) {
+        VERBOSEF("snapshot too small");
+        return false;
+    }
+    memcpy(&header, file.data(), sizeof(header));
+
+    if (header.magic != magic) {
+        VERBOSEF("snapshot has a different format: %08X != %08X", header.magic, magic);
+        return false;
+    } else if (header.source_size != source.size ||
+               header.source_modified_ns != source.modified_ns) {
+        VERBOSEF("snapshot is stale");
+        return false;
+    } else if (header.payload_length != file.size() - sizeof(header)) {
+        VERBOSEF("snapshot is truncated");
+        return false;
+    }
+
+    payload = reinterpret_cast<uint8_t const*>(file.data()) + sizeof(header);
+    length  = static_cast<size_t>(header.payload_length);
+    return true;
+}
+
+}  // namespace helper
+}  // namespace format
@@ -1,5 +1,6 @@
 #pragma once
 #include <core/core.hpp>
+#include <format/helper/pool.hpp>
 
 #include <memory>
 #include <string>
@@ -36,6 +37,24 @@ public:
     /// Clone the message.
     NODISCARD virtual std::unique_ptr<Message> clone() const NOEXCEPT = 0;
 
+    /// Parse a sentence with the same prefix into this message, reusing its allocations. Returns
+    /// false if the message type does not support this.
+    NODISCARD virtual bool reparse(std::string const& prefix, std::string const& payload,
+                                   std::string const& checksum) NOEXCEPT;
+
+    /// Messages created while a pool is active are allocated from it (see `MessagePool`).
+    static void* operator new(size_t size) {
+        return helper::MessagePool::allocate(helper::MessagePool::current(), size);
+    }
+    static void operator delete(void* pointer) NOEXCEPT {
+        helper::MessagePool::deallocate(pointer);
+    }
+
+protected:
+    /// Replace the raw sentence parts, keeping the existing capacity.
+    void assign(std::string const& prefix, std::string const& payload,
+                std::string const& checksum) NOEXCEPT;
+
 private:
     std::string mPrefix;
     std::string mPayload;
@@ -56,6 +75,8 @@ public:
 
     void      print() const NOEXCEPT override;
     NODISCARD std::unique_ptr<Message> clone() const NOEXCEPT override;
+    NODISCARD bool reparse(std::string const& prefix, std::string const& payload,
+                           std::string const& checksum) NOEXCEPT override;
 };
 
 /// Error message. This is used to indicate that the message could not be parsed.
@@ -71,6 +92,8 @@ public:
 
     void      print() const NOEXCEPT override;
     NODISCARD std::unique_ptr<Message> clone() const NOEXCEPT override;
+    NODISCARD bool reparse(std::string const& prefix, std::string const& payload,
+                           std::string const& checksum) NOEXCEPT override;
 };
 
 }  // namespace nmea
@@ -3,6 +3,7 @@
 #include <format/helper/parser.hpp>
 
 #include <memory>
+#include <string>
 
 namespace format {
 namespace nmea {
@@ -23,13 +24,27 @@ public:
     NODISCARD virtual char const* name() const NOEXCEPT override;
 
     NODISCARD std::unique_ptr<Message> try_parse() NOEXCEPT;
-    NODISCARD ChecksumResult           checksum(std::string const& buffer) const;
+    /// Parse the next message into `message`. If `message` already holds a message with the same
+    /// prefix that supports it, it is refilled in place; otherwise a new message is created.
+    NODISCARD bool           try_parse_into(std::unique_ptr<Message>& message) NOEXCEPT;
+    NODISCARD ChecksumResult checksum(std::string const& buffer) const;
 
 protected:
     NODISCARD std::string parse_prefix(uint8_t const* data, uint32_t length) const NOEXCEPT;
+    NODISCARD std::unique_ptr<Message> parse_message(std::string const& prefix,
+                                                     std::string const& data_payload,
+                                                     std::string const& data_checksum) const
+        NOEXCEPT;
 
 private:
-    bool mLfOnly;
+    /// Extract the next valid sentence into `mPrefix`, `mDataPayload` and `mDataChecksum`.
+    NODISCARD bool next_sentence() NOEXCEPT;
+
+    bool        mLfOnly;
+    std::string mSentence;
+    std::string mPrefix;
+    std::string mDataPayload;
+    std::string mDataChecksum;
 };
 
 }  // namespace nmea
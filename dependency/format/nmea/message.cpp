@@ -1,24 +1,36 @@
 #include "message.hpp"
 
 #include <cstdio>
+#include <utility>
 
 namespace format {
 namespace nmea {
 
 Message::Message(std::string prefix, std::string payload, std::string checksum) NOEXCEPT
-    : mPrefix(prefix),
-      mPayload(payload),
-      mChecksum(checksum) {}
+    : mPrefix(std::move(prefix)),
+      mPayload(std::move(payload)),
+      mChecksum(std::move(checksum)) {}
 
 Message::~Message() = default;
 
+bool Message::reparse(std::string const&, std::string const&, std::string const&) NOEXCEPT {
+    return false;
+}
+
+void Message::assign(std::string const& prefix, std::string const& payload,
+                     std::string const& checksum) NOEXCEPT {
+    mPrefix.assign(prefix);
+    mPayload.assign(payload);
+    mChecksum.assign(checksum);
+}
+
 //
 //
 //
 
 UnsupportedMessage::UnsupportedMessage(std::string prefix, std::string payload,
                                        std::string checksum) NOEXCEPT
-    : Message(prefix, payload, checksum) {}
+    : Message(std::move(prefix), std::move(payload), std::move(checksum)) {}
 
 void UnsupportedMessage::print() const NOEXCEPT {
     printf("[%5s] UNSUPPORTED %s\n", prefix().c_str(), payload().c_str());
@@ -28,12 +40,18 @@ std::unique_ptr<Message> UnsupportedMessage::clone() const NOEXCEPT {
     return std::unique_ptr<Message>(new UnsupportedMessage(*this));
 }
 
+bool UnsupportedMessage::reparse(std::string const& prefix, std::string const& payload,
+                                 std::string const& checksum) NOEXCEPT {
+    assign(prefix, payload, checksum);
+    return true;
+}
+
 //
 //
 //
 
 ErrorMessage::ErrorMessage(std::string prefix, std::string payload, std::string checksum) NOEXCEPT
-    : Message(prefix, payload, checksum) {}
+    : Message(std::move(prefix), std::move(payload), std::move(checksum)) {}
 
 void ErrorMessage::print() const NOEXCEPT {
     printf("[%5s] ERROR %s\n", prefix().c_str(), payload().c_str());
@@ -43,5 +61,11 @@ std::unique_ptr<Message> ErrorMessage::clone() const NOEXCEPT {
     return std::unique_ptr<Message>(new ErrorMessage(*this));
 }
 
+bool ErrorMessage::reparse(std::string const& prefix, std::string const& payload,
+                           std::string const& checksum) NOEXCEPT {
+    assign(prefix, payload, checksum);
+    return true;
+}
+
 }  // namespace nmea
 }  // namespace format
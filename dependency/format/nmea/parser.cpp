@@ -7,6 +7,8 @@
 
 #include <cstdio>
 
+#include <format/helper/pool.hpp>
+#include <format/helper/scan.hpp>
 #include <loglet/loglet.hpp>
 
 LOGLET_MODULE2(format, nmea);
@@ -22,90 +24,110 @@ NODISCARD char const* Parser::name() const NOEXCEPT {
 
 std::unique_ptr<Message> Parser::try_parse() NOEXCEPT {
     FUNCTION_SCOPE();
+    helper::MessagePool::Scope scope(pool());
+    if (!next_sentence()) return nullptr;
+    return parse_message(mPrefix, mDataPayload, mDataChecksum);
+}
 
-    // search for '$'
-    for (;;) {
-        if (buffer_length() < 1) {
-            VERBOSEF("not enough data to search for '$'");
-            return nullptr;
-        }
-
-        if (peek(0) == '$') {
-            VERBOSEF("found '$'");
-            break;
-        }
+bool Parser::try_parse_into(std::unique_ptr<Message>& message) NOEXCEPT {
+    FUNCTION_SCOPE();
+    helper::MessagePool::Scope scope(pool());
+    if (!next_sentence()) return false;
 
-        // skip one byte and try again
-        skip(1u);
+    if (message && message->prefix() == mPrefix &&
+        message->reparse(mPrefix, mDataPayload, mDataChecksum)) {
+        DEBUGF("nmea: %s, reused", mPrefix.c_str());
+        return true;
     }
 
-    auto length             = 1u;
-    auto line_ending_length = mLfOnly ? 1u : 2u;
+    message = parse_message(mPrefix, mDataPayload, mDataChecksum);
+    return message != nullptr;
+}
 
+bool Parser::next_sentence() NOEXCEPT {
     for (;;) {
-        if (buffer_length() < length + line_ending_length) {
-            VERBOSEF("not enough data to search for line ending");
-            return nullptr;
+        // search for '$'
+        skip_to_frame_start(helper::FRAME_NMEA);
+        if (buffer_length() < 1) {
+            VERBOSEF("not enough data to search for '$'");
+            return false;
         }
 
-        bool found_ending = false;
-        if (mLfOnly) {
-            if (peek(length) == '\n') {
-                VERBOSEF("found '\\n'");
-                found_ending = true;
+        // search for the line ending, restart at the next '$' if it comes first
+        auto line_ending_length = mLfOnly ? 1u : 2u;
+        auto length             = 0u;
+        auto offset             = 1u;
+        for (;;) {
+            auto index = find(offset, '\n', '$');
+            if (index >= buffer_length()) {
+                VERBOSEF("not enough data to search for line ending");
+                return false;
             }
-        } else {
-            if (peek(length) == '\r' && peek(length + 1) == '\n') {
+
+            if (peek(index) == '$') {
+                VERBOSEF("found '$' while looking for line ending");
+                offset = index;
+                break;
+            }
+
+            if (mLfOnly) {
+                VERBOSEF("found '\\n'");
+                length = index;
+                break;
+            } else if (index >= 2 && peek(index - 1) == '\r') {
                 VERBOSEF("found '\\r\\n'");
-                found_ending = true;
+                length = index - 1;
+                break;
             }
-        }
 
-        if (found_ending) break;
+            offset = index + 1;
+        }
 
-        if (peek(length) == '$') {
-            VERBOSEF("found '$' while looking for line ending");
-            skip(length);
-            return nullptr;
+        if (length == 0) {
+            skip(offset);
+            continue;
         }
 
-        length++;
-    }
+        auto& payload = mSentence;
+        payload.resize(length + line_ending_length);
+        copy_to_buffer(reinterpret_cast<uint8_t*>(&payload[0]), length + line_ending_length);
 
-    std::string payload;
-    payload.resize(length + line_ending_length);
-    copy_to_buffer(reinterpret_cast<uint8_t*>(&payload[0]), length + line_ending_length);
+        auto result = checksum(payload);
+        if (result != ChecksumResult::Ok) {
+            DEBUGF("checksum failed: \"%s\"", payload.c_str());
+            skip(1u);
+            continue;
+        }
+        skip(length + line_ending_length);
+
+        auto length_with_clrf = length + line_ending_length;
+        mPrefix = parse_prefix(reinterpret_cast<uint8_t const*>(payload.data()), length_with_clrf);
+        if (mPrefix.empty()) {
+            // invalid prefix
+            VERBOSEF("invalid prefix");
+            continue;
+        }
 
-    auto result = checksum(payload);
-    if (result != ChecksumResult::Ok) {
-        DEBUGF("checksum failed: \"%s\"", payload.c_str());
-        skip(1u);
-        return nullptr;
-    }
-    skip(length + line_ending_length);
-
-    auto length_with_clrf = length + line_ending_length;
-    auto prefix = parse_prefix(reinterpret_cast<uint8_t const*>(payload.data()), length_with_clrf);
-    if (prefix.empty()) {
-        // invalid prefix
-        VERBOSEF("invalid prefix");
-        return nullptr;
-    }
+        // '$XXXXX,' [data] '*XY\r\n'
+        auto data_start = mPrefix.size() + 1 /* $ */ + 1 /* , */;
+        auto data_end   = length_with_clrf - 5;
+        if (data_start >= data_end) {
+            // no data
+            VERBOSEF("no data");
+            continue;
+        }
 
-    // '$XXXXX,' [data] '*XY\r\n'
-    auto data_start = prefix.size() + 1 /* $ */ + 1 /* , */;
-    auto data_end   = length_with_clrf - 5;
-    if (data_start >= data_end) {
-        // no data
-        VERBOSEF("no data");
-        return nullptr;
+        auto data_length = data_end - data_start;
+        mDataPayload.assign(payload, data_start, data_length);
+        mDataChecksum.assign(payload, data_end + 1, data_end + 3);
+        DEBUGF("nmea: %s, data: %s", mPrefix.c_str(), mDataPayload.c_str());
+        return true;
     }
+}
 
-    auto data_length   = data_end - data_start;
-    auto data_payload  = payload.substr(data_start, data_length);
-    auto data_checksum = payload.substr(data_end + 1, data_end + 3);
-    DEBUGF("nmea: %s, data: %s", prefix.c_str(), data_payload.c_str());
-
+std::unique_ptr<Message> Parser::parse_message(std::string const& prefix,
+                                               std::string const& data_payload,
+                                               std::string const& data_checksum) const NOEXCEPT {
     // parse message
     if (prefix == "GPGGA" || prefix == "GLGGA" || prefix == "GAGGA" || prefix == "GNGGA") {
         auto message = GgaMessage::parse(prefix, data_payload, data_checksum);
@@ -15,8 +15,14 @@ struct NavData {
     std::vector<ephemeris::BdsEphemeris> bds;
 };
 
-/// Parse a RINEX 3/4 navigation file. Returns all decoded ephemerides.
+/// Parse a RINEX 3/4 navigation file. Returns all decoded ephemerides. The file is memory mapped
+/// and large files are parsed by several threads, the ephemerides are in file order regardless.
 NavData parse_nav_file(std::string const& path);
 
+/// Like `parse_nav_file`, but loads the binary snapshot at `snapshot_path` instead of parsing if it
+/// was created from the current version of the file. Otherwise the file is parsed and a new
+/// snapshot is written for the next time.
+NavData parse_nav_file_cached(std::string const& path, std::string const& snapshot_path);
+
 }  // namespace rinex
 }  // namespace format
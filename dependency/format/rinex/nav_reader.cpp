@@ -1,10 +1,15 @@
 #include "nav_reader.hpp"
 
+#include <algorithm>
 #include <cmath>
-#include <cstdio>
 #include <cstring>
+#include <thread>
 
+#include <format/helper/fixed.hpp>
+#include <format/helper/mapped_file.hpp>
+#include <format/helper/snapshot.hpp>
 #include <loglet/loglet.hpp>
+#include <msgpack/vector.hpp>
 #include <time/bdt.hpp>
 #include <time/gps.hpp>
 #include <time/gst.hpp>
@@ -16,77 +21,104 @@ LOGLET_MODULE(rinex_nav);
 namespace format {
 namespace rinex {
 
-// RINEX uses Fortran-style 'D' exponent notation: replace 'D'/'d' with 'E'
-static double parse_double(char const* str, int width) {
-    char buf[32];
-    int  n = width < 31 ? width : 31;
-    memcpy(buf, str, static_cast<size_t>(n));
-    buf[n] = '\0';
-    for (int i = 0; i < n; i++) {
-        if (buf[i] == 'D' || buf[i] == 'd') buf[i] = 'E';
-    }
-    return atof(buf);
+// Records are independent, below this many records per thread a single thread is faster
+CONSTEXPR static size_t PARALLEL_MIN_RECORDS = 256;
+
+// "RNX" and the snapshot payload version
+CONSTEXPR static uint32_t SNAPSHOT_MAGIC = 0x524E5801;
+
+namespace {
+struct Line {
+    char const* data;
+    size_t      length;
+};
+
+// The first line of a record starts with the satellite, the rest are continuation lines
+struct Record {
+    Line lines[8];
+};
+}  // namespace
+
+// Blank fields are zero. Fortran-style 'D' exponents are handled by the field parser.
+static double parse_double(Line const& line, size_t offset) {
+    double value = 0.0;
+    if (!helper::column_double(line.data, line.length, offset, 19, value)) return 0.0;
+    return value;
 }
 
-static bool parse_gps_record(char lines[8][128], ephemeris::GpsEphemeris& eph) {
-    int prn, year, month, day, hour, min, sec;
-    if (sscanf(lines[0] + 1, "%d %d %d %d %d %d %d", &prn, &year, &month, &day, &hour, &min,
-               &sec) != 7)
-        return false;
+// "G10 2026 06 06 00 00 00"
+static bool parse_epoch(Line const& line, int& prn, ts::Gps& time) {
+    int64_t values[7];
+    size_t  offsets[7] = {1, 4, 9, 12, 15, 18, 21};
+    size_t  widths[7]  = {2, 4, 2, 2, 2, 2, 2};
+    for (size_t i = 0; i < 7; i++) {
+        if (!helper::column_int(line.data, line.length, offsets[i], widths[i], values[i])) {
+            return false;
+        }
+    }
+
+    prn  = static_cast<int>(values[0]);
+    time = ts::Gps::from_ymdhms(values[1], values[2], values[3], values[4], values[5],
+                                static_cast<double>(values[6]));
+    return true;
+}
 
-    auto gps_time = ts::Gps::from_ymdhms(year, month, day, hour, min, static_cast<double>(sec));
+static bool parse_gps_record(Line const (&lines)[8], ephemeris::GpsEphemeris& eph) {
+    int     prn;
+    ts::Gps gps_time;
+    if (!parse_epoch(lines[0], prn, gps_time)) return false;
 
     eph             = {};
     eph.prn         = static_cast<uint8_t>(prn);
     eph.week_number = static_cast<uint16_t>(gps_time.week());
     eph.toc         = gps_time.time_of_week().full_seconds();
-    eph.af0         = parse_double(lines[0] + 23, 19);
-    eph.af1         = parse_double(lines[0] + 42, 19);
-    eph.af2         = parse_double(lines[0] + 61, 19);
+    eph.af0         = parse_double(lines[0], 23);
+    eph.af1         = parse_double(lines[0], 42);
+    eph.af2         = parse_double(lines[0], 61);
 
     // Line 1: IODE, Crs, Delta_n, M0
-    double iode_d = parse_double(lines[1] + 4, 19);
+    double iode_d = parse_double(lines[1], 4);
     eph.iode      = static_cast<uint8_t>(static_cast<int>(iode_d)) & 0xFF;
-    eph.crs       = parse_double(lines[1] + 23, 19);
-    eph.delta_n   = parse_double(lines[1] + 42, 19);
-    eph.m0        = parse_double(lines[1] + 61, 19);
+    eph.crs       = parse_double(lines[1], 23);
+    eph.delta_n   = parse_double(lines[1], 42);
+    eph.m0        = parse_double(lines[1], 61);
 
     // Line 2: Cuc, e, Cus, sqrt(A)
-    eph.cuc       = parse_double(lines[2] + 4, 19);
-    eph.e         = parse_double(lines[2] + 23, 19);
-    eph.cus       = parse_double(lines[2] + 42, 19);
-    double sqrt_a = parse_double(lines[2] + 61, 19);
+    eph.cuc       = parse_double(lines[2], 4);
+    eph.e         = parse_double(lines[2], 23);
+    eph.cus       = parse_double(lines[2], 42);
+    double sqrt_a = parse_double(lines[2], 61);
     eph.a         = sqrt_a * sqrt_a;
 
     // Line 3: Toe, Cic, OMEGA0, Cis
-    eph.toe    = parse_double(lines[3] + 4, 19);
-    eph.cic    = parse_double(lines[3] + 23, 19);
-    eph.omega0 = parse_double(lines[3] + 42, 19);
-    eph.cis    = parse_double(lines[3] + 61, 19);
+    eph.toe    = parse_double(lines[3], 4);
+    eph.cic    = parse_double(lines[3], 23);
+    eph.omega0 = parse_double(lines[3], 42);
+    eph.cis    = parse_double(lines[3], 61);
 
     // Line 4: i0, Crc, omega, OMEGA_DOT
-    eph.i0        = parse_double(lines[4] + 4, 19);
-    eph.crc       = parse_double(lines[4] + 23, 19);
-    eph.omega     = parse_double(lines[4] + 42, 19);
-    eph.omega_dot = parse_double(lines[4] + 61, 19);
+    eph.i0        = parse_double(lines[4], 4);
+    eph.crc       = parse_double(lines[4], 23);
+    eph.omega     = parse_double(lines[4], 42);
+    eph.omega_dot = parse_double(lines[4], 61);
 
     // Line 5: IDOT, codes_on_L2, GPS_week, L2_P_flag
-    eph.idot           = parse_double(lines[5] + 4, 19);
-    eph.ca_or_p_on_l2  = static_cast<uint8_t>(parse_double(lines[5] + 23, 19));
-    double week_d      = parse_double(lines[5] + 42, 19);
+    eph.idot           = parse_double(lines[5], 4);
+    eph.ca_or_p_on_l2  = static_cast<uint8_t>(parse_double(lines[5], 23));
+    double week_d      = parse_double(lines[5], 42);
     eph.week_number    = static_cast<uint16_t>(static_cast<int>(week_d));
-    eph.l2_p_data_flag = static_cast<bool>(parse_double(lines[5] + 61, 19));
+    eph.l2_p_data_flag = static_cast<bool>(parse_double(lines[5], 61));
 
     // Line 6: SV_accuracy, SV_health, TGD, IODC
-    eph.ura_index = static_cast<uint8_t>(parse_double(lines[6] + 4, 19));
-    eph.sv_health = static_cast<uint8_t>(parse_double(lines[6] + 23, 19));
-    eph.tgd       = parse_double(lines[6] + 42, 19);
-    double iodc_d = parse_double(lines[6] + 61, 19);
+    eph.ura_index = static_cast<uint8_t>(parse_double(lines[6], 4));
+    eph.sv_health = static_cast<uint8_t>(parse_double(lines[6], 23));
+    eph.tgd       = parse_double(lines[6], 42);
+    double iodc_d = parse_double(lines[6], 61);
     eph.iodc      = static_cast<uint16_t>(static_cast<int>(iodc_d));
 
     // Line 7: transmission_time, fit_interval
     // (transmission time ignored)
-    double fit_d          = parse_double(lines[7] + 23, 19);
+    double fit_d          = parse_double(lines[7], 23);
     eph.fit_interval_flag = (fit_d > 4.0);
 
     eph.lpp_iod = eph.iodc;
@@ -95,56 +127,53 @@ static bool parse_gps_record(char lines[8][128], ephemeris::GpsEphemeris& eph) {
     return true;
 }
 
-static bool parse_gal_record(char lines[8][128], ephemeris::GalEphemeris& eph) {
-    int prn, year, month, day, hour, min, sec;
-    if (sscanf(lines[0] + 1, "%d %d %d %d %d %d %d", &prn, &year, &month, &day, &hour, &min,
-               &sec) != 7)
-        return false;
-
-    auto gps_time = ts::Gps::from_ymdhms(year, month, day, hour, min, static_cast<double>(sec));
+static bool parse_gal_record(Line const (&lines)[8], ephemeris::GalEphemeris& eph) {
+    int     prn;
+    ts::Gps gps_time;
+    if (!parse_epoch(lines[0], prn, gps_time)) return false;
     auto gst_time = ts::Gst(gps_time);
 
     eph             = {};
     eph.prn         = static_cast<uint8_t>(prn);
     eph.week_number = static_cast<uint16_t>(gst_time.week());
     eph.toc         = gst_time.time_of_week().full_seconds();
-    eph.af0         = parse_double(lines[0] + 23, 19);
-    eph.af1         = parse_double(lines[0] + 42, 19);
-    eph.af2         = parse_double(lines[0] + 61, 19);
+    eph.af0         = parse_double(lines[0], 23);
+    eph.af1         = parse_double(lines[0], 42);
+    eph.af2         = parse_double(lines[0], 61);
 
     // Line 1: IODnav, Crs, Delta_n, M0
-    double iod_d = parse_double(lines[1] + 4, 19);
+    double iod_d = parse_double(lines[1], 4);
     eph.iod_nav  = static_cast<uint16_t>(static_cast<int>(iod_d));
     // LPP IOD for Galileo: the SSR orbit correction references iod_nav directly
     eph.lpp_iod = eph.iod_nav;
-    eph.crs     = parse_double(lines[1] + 23, 19);
-    eph.delta_n = parse_double(lines[1] + 42, 19);
-    eph.m0      = parse_double(lines[1] + 61, 19);
+    eph.crs     = parse_double(lines[1], 23);
+    eph.delta_n = parse_double(lines[1], 42);
+    eph.m0      = parse_double(lines[1], 61);
 
     // Line 2: Cuc, e, Cus, sqrt(A)
-    eph.cuc       = parse_double(lines[2] + 4, 19);
-    eph.e         = parse_double(lines[2] + 23, 19);
-    eph.cus       = parse_double(lines[2] + 42, 19);
-    double sqrt_a = parse_double(lines[2] + 61, 19);
+    eph.cuc       = parse_double(lines[2], 4);
+    eph.e         = parse_double(lines[2], 23);
+    eph.cus       = parse_double(lines[2], 42);
+    double sqrt_a = parse_double(lines[2], 61);
     eph.a         = sqrt_a * sqrt_a;
 
     // Line 3: Toe, Cic, OMEGA0, Cis
-    eph.toe    = parse_double(lines[3] + 4, 19);
-    eph.cic    = parse_double(lines[3] + 23, 19);
-    eph.omega0 = parse_double(lines[3] + 42, 19);
-    eph.cis    = parse_double(lines[3] + 61, 19);
+    eph.toe    = parse_double(lines[3], 4);
+    eph.cic    = parse_double(lines[3], 23);
+    eph.omega0 = parse_double(lines[3], 42);
+    eph.cis    = parse_double(lines[3], 61);
 
     // Line 4: i0, Crc, omega, OMEGA_DOT
-    eph.i0        = parse_double(lines[4] + 4, 19);
-    eph.crc       = parse_double(lines[4] + 23, 19);
-    eph.omega     = parse_double(lines[4] + 42, 19);
-    eph.omega_dot = parse_double(lines[4] + 61, 19);
+    eph.i0        = parse_double(lines[4], 4);
+    eph.crc       = parse_double(lines[4], 23);
+    eph.omega     = parse_double(lines[4], 42);
+    eph.omega_dot = parse_double(lines[4], 61);
 
     // Line 5: IDOT, data_sources, GAL_week
-    eph.idot = parse_double(lines[5] + 4, 19);
+    eph.idot = parse_double(lines[5], 4);
     // data_sources: bit0=I/NAV_E1B, bit1=F/NAV_E5a-I, bit2=I/NAV_E5b-I
     // SSR corrections reference I/NAV — reject F/NAV-only entries
-    int  data_sources = static_cast<int>(parse_double(lines[5] + 23, 19));
+    int  data_sources = static_cast<int>(parse_double(lines[5], 23));
     bool is_inav      = (data_sources & 0x01) || (data_sources & 0x04);  // bit0 or bit2
     if (!is_inav) return false;
     // Note: RINEX gives GPS week here, but week_number is already set correctly
@@ -153,13 +182,10 @@ static bool parse_gal_record(char lines[8][128], ephemeris::GalEphemeris& eph) {
     return true;
 }
 
-static bool parse_bds_record(char lines[8][128], ephemeris::BdsEphemeris& eph) {
-    int prn, year, month, day, hour, min, sec;
-    if (sscanf(lines[0] + 1, "%d %d %d %d %d %d %d", &prn, &year, &month, &day, &hour, &min,
-               &sec) != 7)
-        return false;
-
-    auto gps_time = ts::Gps::from_ymdhms(year, month, day, hour, min, static_cast<double>(sec));
+static bool parse_bds_record(Line const (&lines)[8], ephemeris::BdsEphemeris& eph) {
+    int     prn;
+    ts::Gps gps_time;
+    if (!parse_epoch(lines[0], prn, gps_time)) return false;
     // BDT = GPS time - 14 seconds (BDS epoch is 2006-01-01)
     // But for week/tow we just convert via timestamp
     auto bdt_time = ts::Bdt(gps_time);
@@ -169,43 +195,43 @@ static bool parse_bds_record(char lines[8][128], ephemeris::BdsEphemeris& eph) {
     eph.week_number = static_cast<uint16_t>(bdt_time.week());
     eph.toc         = bdt_time.time_of_week().full_seconds();
     eph.toc_time    = bdt_time;
-    eph.af0         = parse_double(lines[0] + 23, 19);
-    eph.af1         = parse_double(lines[0] + 42, 19);
-    eph.af2         = parse_double(lines[0] + 61, 19);
+    eph.af0         = parse_double(lines[0], 23);
+    eph.af1         = parse_double(lines[0], 42);
+    eph.af2         = parse_double(lines[0], 61);
 
     // Line 1: AODE, Crs, Delta_n, M0
-    double aode_d = parse_double(lines[1] + 4, 19);
+    double aode_d = parse_double(lines[1], 4);
     eph.aode      = static_cast<uint8_t>(static_cast<int>(aode_d));
-    eph.crs       = parse_double(lines[1] + 23, 19);
-    eph.delta_n   = parse_double(lines[1] + 42, 19);
-    eph.m0        = parse_double(lines[1] + 61, 19);
+    eph.crs       = parse_double(lines[1], 23);
+    eph.delta_n   = parse_double(lines[1], 42);
+    eph.m0        = parse_double(lines[1], 61);
 
     // Line 2: Cuc, e, Cus, sqrt(A)
-    eph.cuc       = parse_double(lines[2] + 4, 19);
-    eph.e         = parse_double(lines[2] + 23, 19);
-    eph.cus       = parse_double(lines[2] + 42, 19);
-    double sqrt_a = parse_double(lines[2] + 61, 19);
+    eph.cuc       = parse_double(lines[2], 4);
+    eph.e         = parse_double(lines[2], 23);
+    eph.cus       = parse_double(lines[2], 42);
+    double sqrt_a = parse_double(lines[2], 61);
     eph.a         = sqrt_a * sqrt_a;
 
     // Line 3: Toe, Cic, OMEGA0, Cis
-    eph.toe    = parse_double(lines[3] + 4, 19);
-    eph.cic    = parse_double(lines[3] + 23, 19);
-    eph.omega0 = parse_double(lines[3] + 42, 19);
-    eph.cis    = parse_double(lines[3] + 61, 19);
+    eph.toe    = parse_double(lines[3], 4);
+    eph.cic    = parse_double(lines[3], 23);
+    eph.omega0 = parse_double(lines[3], 42);
+    eph.cis    = parse_double(lines[3], 61);
 
     // Line 4: i0, Crc, omega, OMEGA_DOT
-    eph.i0        = parse_double(lines[4] + 4, 19);
-    eph.crc       = parse_double(lines[4] + 23, 19);
-    eph.omega     = parse_double(lines[4] + 42, 19);
-    eph.omega_dot = parse_double(lines[4] + 61, 19);
+    eph.i0        = parse_double(lines[4], 4);
+    eph.crc       = parse_double(lines[4], 23);
+    eph.omega     = parse_double(lines[4], 42);
+    eph.omega_dot = parse_double(lines[4], 61);
 
     // Line 5: IDOT, spare, BDT_week
-    eph.idot        = parse_double(lines[5] + 4, 19);
-    double week_d   = parse_double(lines[5] + 42, 19);
+    eph.idot        = parse_double(lines[5], 4);
+    double week_d   = parse_double(lines[5], 42);
     eph.week_number = static_cast<uint16_t>(static_cast<int>(week_d));
 
     // Line 6: SV_accuracy, SV_health, TGD1, TGD2
-    eph.sv_health = static_cast<uint8_t>(parse_double(lines[6] + 23, 19));
+    eph.sv_health = static_cast<uint8_t>(parse_double(lines[6], 23));
 
     // Compute IOD from toe (same as rtcm2eph)
     eph.lpp_iod = static_cast<uint16_t>(static_cast<uint32_t>(eph.toe) >> 9);
@@ -219,69 +245,172 @@ static bool parse_bds_record(char lines[8][128], ephemeris::BdsEphemeris& eph) {
     return true;
 }
 
-NavData parse_nav_file(std::string const& path) {
-    NavData result;
-
-    FILE* f = fopen(path.c_str(), "r");
-    if (!f) {
-        ERRORF("cannot open RINEX nav file: %s", path.c_str());
-        return result;
-    }
-
-    // Skip header
-    char line[256];
-    while (fgets(line, sizeof(line), f)) {
-        if (strstr(line, "END OF HEADER")) break;
-    }
-
-    // Parse records
-    while (fgets(line, sizeof(line), f)) {
-        if (line[0] == '\n' || line[0] == '\r' || line[0] == '\0') continue;
-        if (line[0] == ' ') continue;  // continuation line without a record start
-
-        char gnss    = line[0];
-        int  n_lines = 8;                             // GPS/GAL/BDS: 1 header + 7 data lines
-        if (gnss == 'R' || gnss == 'S') n_lines = 4;  // GLONASS/SBAS: 1 + 3
-
-        char record[8][128];
-        memset(record, 0, sizeof(record));
-        size_t len = strlen(line);
-        if (len > 127) len = 127;
-        memcpy(record[0], line, len);
-
-        bool ok = true;
-        for (int i = 1; i < n_lines; i++) {
-            if (!fgets(record[i], sizeof(record[i]), f)) {
-                ok = false;
-                break;
-            }
-        }
-        if (!ok) break;
-
+static void parse_records(Record const* records, size_t count, NavData& result) {
+    for (size_t i = 0; i < count; i++) {
+        auto& record = records[i];
+        auto  gnss   = record.lines[0].data[0];
         if (gnss == 'G') {
             ephemeris::GpsEphemeris eph{};
-            if (parse_gps_record(record, eph)) {
+            if (parse_gps_record(record.lines, eph)) {
                 result.gps.push_back(eph);
             }
         } else if (gnss == 'E') {
             ephemeris::GalEphemeris eph{};
-            if (parse_gal_record(record, eph)) {
+            if (parse_gal_record(record.lines, eph)) {
                 result.gal.push_back(eph);
             }
         } else if (gnss == 'C') {
             ephemeris::BdsEphemeris eph{};
-            if (parse_bds_record(record, eph)) {
+            if (parse_bds_record(record.lines, eph)) {
                 result.bds.push_back(eph);
             }
         }
         // R/S/J: skip (not supported)
     }
+}
+
+static bool next_line(char const*& position, char const* end, Line& line) {
+    if (position >= end) return false;
+
+    auto remaining = static_cast<size_t>(end - position);
+    auto newline   = static_cast<char const*>(memchr(position, '\n', remaining));
+    auto line_end  = newline ? newline : end;
+    line.data     = position;
+    line.length   = static_cast<size_t>(line_end - position);
+    if (line.length > 0 && line.data[line.length - 1] == '\r') line.length--;
+    position = newline ? newline + 1 : end;
+    return true;
+}
+
+static std::vector<Record> find_records(char const* data, size_t size) {
+    auto position = data;
+    auto end      = data + size;
+
+    // Skip header
+    Line line{};
+    while (next_line(position, end, line)) {
+        if (std::string(line.data, line.length).find("END OF HEADER") != std::string::npos) break;
+    }
+
+    std::vector<Record> records;
+    while (next_line(position, end, line)) {
+        if (line.length == 0) continue;
+        if (line.data[0] == ' ') continue;  // continuation line without a record start
+
+        auto gnss    = line.data[0];
+        int  n_lines = 8;                             // GPS/GAL/BDS: 1 header + 7 data lines
+        if (gnss == 'R' || gnss == 'S') n_lines = 4;  // GLONASS/SBAS: 1 + 3
+
+        Record record{};
+        record.lines[0] = line;
+        for (int i = 1; i < n_lines; i++) {
+            if (!next_line(position, end, record.lines[i])) return records;
+        }
+        records.push_back(record);
+    }
+    return records;
+}
+
+static NavData parse_nav_data(char const* data, size_t size) {
+    auto records = find_records(data, size);
+
+    size_t thread_count = 1;
+    if (records.size() >= 2 * PARALLEL_MIN_RECORDS) {
+        auto hardware = static_cast<size_t>(std::thread::hardware_concurrency());
+        thread_count  = std::min(hardware, records.size() / PARALLEL_MIN_RECORDS);
+        if (thread_count < 1) thread_count = 1;
+    }
 
-    fclose(f);
+    // Each thread parses a contiguous range, concatenating the ranges keeps the file order
+    std::vector<NavData>     partial(thread_count);
+    std::vector<std::thread> threads;
+    auto                     chunk = (records.size() + thread_count - 1) / thread_count;
+    for (size_t i = 0; i < thread_count; i++) {
+        auto begin = std::min(records.size(), i * chunk);
+        auto count = std::min(records.size(), begin + chunk) - begin;
+        if (i + 1 == thread_count) {
+            parse_records(records.data() + begin, count, partial[i]);
+        } else {
+            threads.emplace_back(parse_records, records.data() + begin, count,
+                                 std::ref(partial[i]));
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    NavData result = std::move(partial[0]);
+    for (size_t i = 1; i < partial.size(); i++) {
+        result.gps.insert(result.gps.end(), partial[i].gps.begin(), partial[i].gps.end());
+        result.gal.insert(result.gal.end(), partial[i].gal.begin(), partial[i].gal.end());
+        result.bds.insert(result.bds.end(), partial[i].bds.begin(), partial[i].bds.end());
+    }
+    return result;
+}
+
+NavData parse_nav_file(std::string const& path) {
+    helper::MappedFile file;
+    if (!file.open(path)) {
+        ERRORF("cannot open RINEX nav file: %s", path.c_str());
+        return NavData{};
+    }
+
+    auto result = parse_nav_data(file.data(), file.size());
     INFOF("RINEX nav: loaded %zu GPS, %zu GAL, %zu BDS ephemerides from %s", result.gps.size(),
           result.gal.size(), result.bds.size(), path.c_str());
     return result;
 }
 
+static bool unpack_nav_data(uint8_t const* data, size_t length, NavData& result) {
+    msgpack::Unpacker unpacker{data, length};
+    uint32_t          size = 0;
+    if (!unpacker.unpack_array_header(size) || size != 3) return false;
+    if (!msgpack::unpack(unpacker, result.gps) || !msgpack::unpack(unpacker, result.gal) ||
+        !msgpack::unpack(unpacker, result.bds)) {
+        return false;
+    }
+
+    // The BDT times are not part of the serialized ephemeris
+    for (auto& eph : result.bds) {
+        eph.toe_time = ts::Bdt::from_week_tow(eph.week_number, static_cast<int64_t>(eph.toe), 0.0);
+        eph.toc_time = ts::Bdt::from_week_tow(eph.week_number, static_cast<int64_t>(eph.toc), 0.0);
+    }
+    return !unpacker.has_data();
+}
+
+NavData parse_nav_file_cached(std::string const& path, std::string const& snapshot_path) {
+    helper::FileIdentity source{};
+    if (!helper::file_identity(path, source)) {
+        ERRORF("cannot open RINEX nav file: %s", path.c_str());
+        return NavData{};
+    }
+
+    helper::MappedFile snapshot;
+    uint8_t const*     payload = nullptr;
+    size_t             length  = 0;
+    if (helper::read_snapshot(snapshot_path, SNAPSHOT_MAGIC, source, snapshot, payload, length)) {
+        NavData result;
+        if (unpack_nav_data(payload, length, result)) {
+            INFOF("RINEX nav: loaded %zu GPS, %zu GAL, %zu BDS ephemerides from snapshot %s",
+                  result.gps.size(), result.gal.size(), result.bds.size(), snapshot_path.c_str());
+            return result;
+        }
+        WARNF("invalid RINEX nav snapshot: %s", snapshot_path.c_str());
+    }
+
+    auto result = parse_nav_file(path);
+
+    std::vector<uint8_t> buffer;
+    msgpack::Packer      packer{buffer};
+    packer.pack_array_header(3);
+    msgpack::pack(packer, result.gps);
+    msgpack::pack(packer, result.gal);
+    msgpack::pack(packer, result.bds);
+    if (!helper::write_snapshot(snapshot_path, SNAPSHOT_MAGIC, source, buffer)) {
+        WARNF("failed to write RINEX nav snapshot: %s", snapshot_path.c_str());
+    }
+    return result;
+}
+
 }  // namespace rinex
 }  // namespace format
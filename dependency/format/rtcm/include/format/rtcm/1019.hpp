@@ -18,7 +18,7 @@ public:
     EXPLICIT Rtcm1019(DF002 type, std::vector<uint8_t> data) NOEXCEPT;
     ~Rtcm1019() override = default;
 
-    Rtcm1019(Rtcm1019 const& other) : Message(other) {}
+    Rtcm1019(Rtcm1019 const& other)      = default;
     Rtcm1019(Rtcm1019&&)                 = delete;
     Rtcm1019& operator=(Rtcm1019 const&) = delete;
     Rtcm1019& operator=(Rtcm1019&&)      = delete;
@@ -17,7 +17,7 @@ class Rtcm1042 final : public Message {
 public:
     ~Rtcm1042() override = default;
 
-    Rtcm1042(Rtcm1042 const& other) : Message(other) {}
+    Rtcm1042(Rtcm1042 const& other)      = default;
     Rtcm1042(Rtcm1042&&)                 = delete;
     Rtcm1042& operator=(Rtcm1042 const&) = delete;
     Rtcm1042& operator=(Rtcm1042&&)      = delete;
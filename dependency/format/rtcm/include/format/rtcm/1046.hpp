@@ -15,7 +15,7 @@ public:
     EXPLICIT Rtcm1046(DF002 type, std::vector<uint8_t> data) NOEXCEPT;
     ~Rtcm1046() override = default;
 
-    Rtcm1046(Rtcm1046 const& other) : Message(other) {}
+    Rtcm1046(Rtcm1046 const& other)      = default;
     Rtcm1046(Rtcm1046&&)                 = delete;
     Rtcm1046& operator=(Rtcm1046 const&) = delete;
     Rtcm1046& operator=(Rtcm1046&&)      = delete;
@@ -1,5 +1,6 @@
 #pragma once
 #include <core/core.hpp>
+#include <format/helper/pool.hpp>
 
 #include <memory>
 #include <vector>
@@ -14,7 +15,7 @@ public:
     EXPLICIT Message(DF002 type, std::vector<uint8_t> data) NOEXCEPT;
     virtual ~Message();
 
-    Message(Message const& other) : mData{other.mData} {}
+    Message(Message const& other);
     Message(Message&&)                 = delete;
     Message& operator=(Message const&) = delete;
     Message& operator=(Message&&)      = delete;
@@ -29,9 +30,24 @@ public:
     /// Clone the message.
     NODISCARD virtual std::unique_ptr<Message> clone() const NOEXCEPT = 0;
 
+    /// Parse a frame of the same type into this message, reusing its allocations. Returns false if
+    /// the message type does not support this.
+    NODISCARD virtual bool reparse(uint8_t const* frame, uint32_t length) NOEXCEPT;
+
+    /// Messages created while a pool is active are allocated from it (see `MessagePool`).
+    static void* operator new(size_t size) {
+        return helper::MessagePool::allocate(helper::MessagePool::current(), size);
+    }
+    static void operator delete(void* pointer) NOEXCEPT {
+        helper::MessagePool::deallocate(pointer);
+    }
+
 protected:
     DF002                mType;
     std::vector<uint8_t> mData;
+
+private:
+    helper::MessagePool* mPool;  // Pool to return mData to, if any
 };
 
 /// Unsupported or unknown message.
@@ -47,6 +63,7 @@ public:
 
     void      print() const NOEXCEPT override;
     NODISCARD std::unique_ptr<Message> clone() const NOEXCEPT override;
+    NODISCARD bool reparse(uint8_t const* frame, uint32_t length) NOEXCEPT override;
 };
 
 /// Error message. This is used to indicate that the message could not be parsed.
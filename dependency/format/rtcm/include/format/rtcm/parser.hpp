@@ -18,16 +18,31 @@ enum class CRCResult {
 class Message;
 class Parser : public format::helper::Parser {
 public:
-    EXPLICIT Parser()          = default;
-    virtual ~Parser() override = default;
+    EXPLICIT Parser() NOEXCEPT;
+    virtual ~Parser() override;
 
     NODISCARD virtual char const* name() const NOEXCEPT override;
 
     NODISCARD std::unique_ptr<Message> try_parse() NOEXCEPT;
-    NODISCARD static CRCResult         crc(std::vector<uint8_t> const& buffer);
+    /// Parse the next message into `message`. If `message` already holds a message of the same
+    /// type (or the parser has a spare one from an earlier call) it is refilled in place and keeps
+    /// its allocations; otherwise a new message is created.
+    NODISCARD bool             try_parse_into(std::unique_ptr<Message>& message) NOEXCEPT;
+    NODISCARD static CRCResult crc(std::vector<uint8_t> const& buffer);
 
 protected:
     NODISCARD std::string parse_prefix(uint8_t const* data, uint32_t length) const NOEXCEPT;
+
+private:
+    static CONSTEXPR size_t MAX_SPARES = 8;
+
+    /// Copy the next valid frame into `mFrame`. Returns false if there is none.
+    NODISCARD bool                     next_frame() NOEXCEPT;
+    NODISCARD int                      frame_type() const NOEXCEPT;
+    NODISCARD std::unique_ptr<Message> decode() NOEXCEPT;
+
+    std::vector<uint8_t>                  mFrame;
+    std::vector<std::unique_ptr<Message>> mSpares;
 };
 
 }  // namespace rtcm
@@ -5,12 +5,31 @@
 namespace format {
 namespace rtcm {
 
-Message::Message(DF002 type, std::vector<uint8_t> data) NOEXCEPT : mType{type}, mData{data} {}
+Message::Message(DF002 type, std::vector<uint8_t> data) NOEXCEPT
+    : mType{type},
+      mData{std::move(data)},
+      mPool(helper::MessagePool::current()) {
+    if (mPool) mPool->retain();
+}
 
-Message::~Message() = default;
+Message::Message(Message const& other)
+    : mType{other.mType}, mData{other.mData}, mPool(helper::MessagePool::current()) {
+    if (mPool) mPool->retain();
+}
+
+Message::~Message() {
+    if (mPool) {
+        mPool->recycle_buffer(std::move(mData));
+        mPool->release();
+    }
+}
+
+bool Message::reparse(uint8_t const*, uint32_t) NOEXCEPT {
+    return false;
+}
 
 UnsupportedMessage::UnsupportedMessage(DF002 type, std::vector<uint8_t> data) NOEXCEPT
-    : Message(type, data) {}
+    : Message(type, std::move(data)) {}
 
 void UnsupportedMessage::print() const NOEXCEPT {
     printf("[RTCM%4u] UNSUPPORTED\n", mType.value());
@@ -21,6 +40,11 @@ std::unique_ptr<Message> UnsupportedMessage::clone() const NOEXCEPT {
     return std::unique_ptr<Message>(new UnsupportedMessage(*this));
 }
 
+bool UnsupportedMessage::reparse(uint8_t const* frame, uint32_t length) NOEXCEPT {
+    mData.assign(frame, frame + length);
+    return true;
+}
+
 /** RTCM ErrorMessage
  */
 
@@ -0,0 +1,168 @@
+#include <format/checksum/checksum.hpp>
+#include <format/tbin/block.hpp>
+
+#include <cstring>
+
+namespace format {
+namespace tbin {
+
+static uint32_t get_u32(uint8_t const* p) NOEXCEPT {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static uint64_t get_u64(uint8_t const* p) NOEXCEPT {
+    return static_cast<uint64_t>(get_u32(p)) | (static_cast<uint64_t>(get_u32(p + 4)) << 32);
+}
+
+static void put_u32(uint8_t* p, uint32_t value) NOEXCEPT {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+static void put_u64(uint8_t* p, uint64_t value) NOEXCEPT {
+    put_u32(p, static_cast<uint32_t>(value));
+    put_u32(p + 4, static_cast<uint32_t>(value >> 32));
+}
+
+static uint64_t zigzag(int64_t value) NOEXCEPT {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) NOEXCEPT {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static bool get_varint(uint8_t const* data, size_t size, size_t& pos, uint64_t& value) NOEXCEPT {
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (pos >= size) return false;
+        auto byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool BlockHeader::parse(uint8_t const* data, BlockHeader& header) NOEXCEPT {
+    if (memcmp(data, BLOCK_MAGIC, 4) != 0) return false;
+    header.crc               = get_u32(data + 4);
+    header.codec             = static_cast<Codec>(data[8]);
+    header.count             = get_u32(data + 12);
+    header.raw_size          = get_u32(data + 16);
+    header.stored_size       = get_u32(data + 20);
+    header.base_timestamp_us = static_cast<int64_t>(get_u64(data + 24));
+
+    if (header.codec != Codec::Stored && header.codec != Codec::Lz) return false;
+    if (header.raw_size > MAX_BLOCK_BODY_SIZE) return false;
+    if (header.stored_size > lz::compress_bound(header.raw_size)) return false;
+    if (header.codec == Codec::Stored && header.stored_size != header.raw_size) return false;
+    return true;
+}
+
+uint32_t block_crc(uint8_t const* block, size_t length) NOEXCEPT {
+    return format::checksum::crc24q(block + 8, length - 8);
+}
+
+bool decode_block(uint8_t const* block, size_t length, BlockHeader const& header,
+                  std::vector<uint8_t>& raw) NOEXCEPT {
+    if (length != BLOCK_HEADER_SIZE + header.stored_size) return false;
+    if (block_crc(block, length) != header.crc) return false;
+
+    auto body = block + BLOCK_HEADER_SIZE;
+    raw.resize(header.raw_size);
+    if (header.codec == Codec::Stored) {
+        memcpy(raw.data(), body, header.raw_size);
+        return true;
+    }
+    return lz::decompress(body, header.stored_size, raw.data(), header.raw_size);
+}
+
+bool next_record(std::vector<uint8_t> const& raw, size_t& pos, int64_t& timestamp_us,
+                 uint8_t const*& data, uint32_t& length) NOEXCEPT {
+    uint64_t delta;
+    uint64_t size;
+    if (!get_varint(raw.data(), raw.size(), pos, delta)) return false;
+    if (!get_varint(raw.data(), raw.size(), pos, size)) return false;
+    if (size > raw.size() - pos) return false;
+
+    timestamp_us += unzigzag(delta);
+    data   = raw.data() + pos;
+    length = static_cast<uint32_t>(size);
+    pos += size;
+    return true;
+}
+
+BlockEncoder::BlockEncoder(size_t block_size, bool compress) NOEXCEPT
+    : mBlockSize(block_size),
+      mCompress(compress),
+      mCount(0),
+      mBaseTimestamp(0),
+      mLastTimestamp(0) {
+    // A message may overshoot the block size, leave room for a typical one
+    mRaw.reserve(mBlockSize + 4096);
+    mBlock.reserve(BLOCK_HEADER_SIZE + lz::compress_bound(mRaw.capacity()));
+}
+
+void BlockEncoder::put_varint(uint64_t value) NOEXCEPT {
+    while (value >= 0x80) {
+        mRaw.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    mRaw.push_back(static_cast<uint8_t>(value));
+}
+
+void BlockEncoder::add(int64_t timestamp_us, uint8_t const* data, uint32_t length) NOEXCEPT {
+    if (mCount == 0) {
+        mBaseTimestamp = timestamp_us;
+        mLastTimestamp = timestamp_us;
+    }
+
+    put_varint(zigzag(timestamp_us - mLastTimestamp));
+    put_varint(length);
+    mRaw.insert(mRaw.end(), data, data + length);
+    mLastTimestamp = timestamp_us;
+    mCount++;
+}
+
+std::vector<uint8_t> const& BlockEncoder::finish() NOEXCEPT {
+    auto   raw_size = mRaw.size();
+    auto   codec    = Codec::Stored;
+    size_t stored   = raw_size;
+
+    mBlock.resize(BLOCK_HEADER_SIZE + lz::compress_bound(raw_size));
+    auto body = mBlock.data() + BLOCK_HEADER_SIZE;
+    if (mCompress) {
+        auto compressed =
+            mCompressor.compress(mRaw.data(), raw_size, body, lz::compress_bound(raw_size));
+        if (compressed > 0 && compressed < raw_size) {
+            codec  = Codec::Lz;
+            stored = compressed;
+        }
+    }
+    if (codec == Codec::Stored) {
+        memcpy(body, mRaw.data(), raw_size);
+    }
+    mBlock.resize(BLOCK_HEADER_SIZE + stored);
+
+    auto header = mBlock.data();
+    memcpy(header, BLOCK_MAGIC, 4);
+    header[8]  = static_cast<uint8_t>(codec);
+    header[9]  = 0;
+    header[10] = 0;
+    header[11] = 0;
+    put_u32(header + 12, mCount);
+    put_u32(header + 16, static_cast<uint32_t>(raw_size));
+    put_u32(header + 20, static_cast<uint32_t>(stored));
+    put_u64(header + 24, static_cast<uint64_t>(mBaseTimestamp));
+    put_u32(header + 4, block_crc(mBlock.data(), mBlock.size()));
+
+    mRaw.clear();
+    mCount = 0;
+    return mBlock;
+}
+
+}  // namespace tbin
+}  // namespace format
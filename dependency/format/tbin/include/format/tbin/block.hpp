@@ -0,0 +1,89 @@
+#pragma once
+#include <core/core.hpp>
+#include <format/tbin/lz.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace format {
+namespace tbin {
+
+// TBIN v2 files have the same file header as v1 (magic, version, stream id) followed by blocks:
+//
+//   0  "TBLK"
+//   4  u32 CRC-24Q of everything after this field, up to the end of the body
+//   8  u8  codec, u8[3] reserved
+//  12  u32 message count
+//  16  u32 raw body size
+//  20  u32 stored body size
+//  24  i64 base timestamp (us)
+//  32  body, for each message: varint zigzag timestamp delta, varint length, payload
+//
+// All integers are little-endian. Blocks are self-contained, so files can be appended to (or
+// concatenated, the reader skips a repeated file header) and a corrupt block only loses itself.
+static constexpr char     BLOCK_MAGIC[4]      = {'T', 'B', 'L', 'K'};
+static constexpr size_t   BLOCK_HEADER_SIZE   = 32;
+static constexpr size_t   DEFAULT_BLOCK_SIZE  = 64 * 1024;
+static constexpr uint32_t MAX_BLOCK_BODY_SIZE = 64 * 1024 * 1024;
+
+enum class Codec : uint8_t {
+    Stored = 0,
+    Lz     = 1,
+};
+
+struct BlockHeader {
+    uint32_t crc;
+    Codec    codec;
+    uint32_t count;
+    uint32_t raw_size;
+    uint32_t stored_size;
+    int64_t  base_timestamp_us;
+
+    /// Parse and sanity check a block header, does not verify the CRC.
+    NODISCARD static bool parse(uint8_t const* data, BlockHeader& header) NOEXCEPT;
+};
+
+/// CRC of a block, `block` must start with the header and contain the whole body.
+NODISCARD uint32_t block_crc(uint8_t const* block, size_t length) NOEXCEPT;
+
+/// Decode the body of a block into `raw`, verifying the CRC. `block` is the header and body.
+NODISCARD bool decode_block(uint8_t const* block, size_t length, BlockHeader const& header,
+                            std::vector<uint8_t>& raw) NOEXCEPT;
+
+/// Read the message at `pos` of a decoded body and advance `pos`. `timestamp_us` holds the
+/// previous timestamp (the base timestamp before the first message) and is updated.
+NODISCARD bool next_record(std::vector<uint8_t> const& raw, size_t& pos, int64_t& timestamp_us,
+                           uint8_t const*& data, uint32_t& length) NOEXCEPT;
+
+/// Batches messages into TBIN v2 blocks. The buffers are reused between blocks, so encoding does
+/// not allocate once they have grown to the block size.
+class BlockEncoder {
+public:
+    EXPLICIT BlockEncoder(size_t block_size = DEFAULT_BLOCK_SIZE, bool compress = true) NOEXCEPT;
+
+    void add(int64_t timestamp_us, uint8_t const* data, uint32_t length) NOEXCEPT;
+
+    NODISCARD bool   full() const NOEXCEPT { return mRaw.size() >= mBlockSize; }
+    NODISCARD bool   empty() const NOEXCEPT { return mCount == 0; }
+    NODISCARD size_t count() const NOEXCEPT { return mCount; }
+
+    /// Encode the pending messages as a block and start a new one. The returned buffer (header and
+    /// body) is valid until the next call.
+    NODISCARD std::vector<uint8_t> const& finish() NOEXCEPT;
+
+private:
+    void put_varint(uint64_t value) NOEXCEPT;
+
+    size_t               mBlockSize;
+    bool                 mCompress;
+    uint32_t             mCount;
+    int64_t              mBaseTimestamp;
+    int64_t              mLastTimestamp;
+    std::vector<uint8_t> mRaw;
+    std::vector<uint8_t> mBlock;
+    lz::Compressor       mCompressor;
+};
+
+}  // namespace tbin
+}  // namespace format
@@ -0,0 +1,41 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace format {
+namespace tbin {
+namespace lz {
+
+/// Byte-oriented LZ77 codec for TBIN v2 blocks. Sequences are encoded as in the LZ4 block format
+/// (token, literals, 16-bit offset, match length), the last sequence only has literals. It trades
+/// ratio for speed, recorded GNSS streams are repetitive enough that a 64 KiB window is plenty.
+
+/// Worst case compressed size of `size` bytes.
+NODISCARD constexpr size_t compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+class Compressor {
+public:
+    Compressor() NOEXCEPT;
+
+    /// Compress `size` bytes into `dst`, which must hold at least `compress_bound(size)` bytes.
+    /// Returns the compressed size, or 0 if `capacity` is too small.
+    NODISCARD size_t compress(uint8_t const* src, size_t size, uint8_t* dst,
+                              size_t capacity) NOEXCEPT;
+
+private:
+    static constexpr size_t HASH_BITS = 12;
+
+    uint32_t mTable[1u << HASH_BITS];
+};
+
+/// Decompress exactly `size` bytes into `dst`. Returns false if the input is malformed or does not
+/// decompress to exactly `size` bytes.
+NODISCARD bool decompress(uint8_t const* src, size_t length, uint8_t* dst, size_t size) NOEXCEPT;
+
+}  // namespace lz
+}  // namespace tbin
+}  // namespace format
@@ -0,0 +1,74 @@
+#pragma once
+#include <core/core.hpp>
+#include <format/tbin/reader.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace format {
+namespace tbin {
+
+/// Merges TBIN files into one stream ordered by timestamp, messages with the same timestamp are
+/// delivered in source order. Each source is read ahead in batches, by default on its own thread
+/// with two batches so that reading the next one overlaps with merging the current one. The
+/// sources are merged with a loser tree, one comparison per level for every message.
+class Merger {
+public:
+    struct Source {
+        std::string path;
+        // Added to the timestamps of the source, for ordering and in the delivered messages
+        int64_t shift_us = 0;
+    };
+
+    struct Options {
+        // Read ahead on a thread per source, otherwise batches are read when needed
+        bool prefetch = true;
+        // Messages per batch
+        size_t batch_size = 512;
+        // stdio buffer size of each file
+        size_t read_buffer_size = 1024 * 1024;
+    };
+
+    Merger() NOEXCEPT;
+    EXPLICIT Merger(Options const& options) NOEXCEPT;
+    ~Merger() NOEXCEPT;
+
+    Merger(Merger const&)            = delete;
+    Merger& operator=(Merger const&) = delete;
+
+    /// Open all sources, fails if any of them can not be opened.
+    NODISCARD bool open(std::vector<Source> const& sources) NOEXCEPT;
+    void           close() NOEXCEPT;
+
+    /// Timestamp of the next message, false when all sources are exhausted.
+    NODISCARD bool peek(int64_t& timestamp_us) NOEXCEPT;
+    /// The next message and the index of its source, or nullptr when all sources are exhausted.
+    /// The message is valid until the next call to `next` or `peek`, it may be modified.
+    NODISCARD Message* next(size_t* source = nullptr) NOEXCEPT;
+
+    NODISCARD size_t             size() const NOEXCEPT { return mSources.size(); }
+    NODISCARD std::string const& stream_id(size_t source) const NOEXCEPT;
+
+private:
+    class Prefetcher;
+
+    NODISCARD bool less(size_t a, size_t b) const NOEXCEPT;
+    void           replay(size_t leaf) NOEXCEPT;
+    void           advance() NOEXCEPT;
+
+    Options                                  mOptions;
+    std::vector<std::unique_ptr<Prefetcher>> mSources;
+    // Timestamp of the current message of each source, `mDone` is set when a source is exhausted
+    std::vector<int64_t> mKeys;
+    std::vector<bool>    mDone;
+    // mTree[0] is the winner, the other nodes hold the loser of their match
+    std::vector<size_t> mTree;
+    // The source of the last delivered message, advanced on the next call
+    size_t mDelivered;
+};
+
+}  // namespace tbin
+}  // namespace format
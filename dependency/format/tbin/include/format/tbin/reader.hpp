@@ -12,22 +12,45 @@ struct Message {
     std::vector<uint8_t> data;
 };
 
+/// Reads TBIN v1 and v2 files, the version is taken from the file header.
 class Reader {
 public:
     Reader() = default;
     ~Reader();
 
-    bool open(std::string const& path);
+    /// A `buffer_size` larger than the default stdio buffer makes fewer, larger reads.
+    bool open(std::string const& path, size_t buffer_size = 0);
     bool next(Message& msg);
     void close();
 
     std::string const& stream_id() const { return mStreamId; }
+    uint8_t            version() const { return mVersion; }
     bool               eof() const { return mEof; }
+    /// Number of v2 blocks skipped because their header, CRC or body was invalid. After an invalid
+    /// header the reader resyncs at the next block or file header.
+    uint64_t corrupt_blocks() const { return mCorruptBlocks; }
 
 private:
-    FILE*       mFile{nullptr};
-    std::string mStreamId;
-    bool        mEof{false};
+    bool read_header();
+    bool next_v1(Message& msg);
+    bool next_v2(Message& msg);
+    bool read_block();
+    bool at_magic();
+    bool resync(long position);
+
+    FILE*             mFile{nullptr};
+    std::vector<char> mBuffer;
+    std::string       mStreamId;
+    uint8_t           mVersion{0};
+    bool              mEof{false};
+
+    // v2 block state
+    std::vector<uint8_t> mBlock;
+    std::vector<uint8_t> mRaw;
+    size_t               mRawPos{0};
+    uint32_t             mRemaining{0};
+    int64_t              mTimestamp{0};
+    uint64_t             mCorruptBlocks{0};
 };
 
 }  // namespace tbin
@@ -1,25 +1,50 @@
 #pragma once
+#include <format/tbin/block.hpp>
+
 #include <cstdint>
 #include <cstdio>
+#include <memory>
 #include <string>
 
 namespace format {
 namespace tbin {
 
-static constexpr char    MAGIC[4] = {'T', 'B', 'I', 'N'};
-static constexpr uint8_t VERSION  = 1;
+static constexpr char    MAGIC[4]  = {'T', 'B', 'I', 'N'};
+static constexpr uint8_t VERSION_1 = 1;
+static constexpr uint8_t VERSION_2 = 2;
+
+/// Prepare `path` for appending `version` records. Only the record or block headers are read to
+/// find the end of the last complete one, a partially written tail (e.g. after a crash) is
+/// truncated. Returns false if the file is not a TBIN file of `version`, the versions cannot be
+/// mixed. `has_header` is set if the file already has a header, a missing or empty file needs one.
+NODISCARD bool prepare_append(std::string const& path, uint8_t version, bool& has_header);
 
 class Writer {
 public:
     Writer() = default;
     ~Writer();
 
-    bool open(std::string const& path, std::string const& stream_id);
+    /// Create `path`. Version 1 writes every message as it comes, version 2 batches messages into
+    /// compressed blocks of `block_size` raw bytes, see `block.hpp`.
+    bool open(std::string const& path, std::string const& stream_id, uint8_t version = VERSION_1,
+              size_t block_size = DEFAULT_BLOCK_SIZE);
+    /// Append version 2 blocks to `path`, creating it if it does not exist. See `prepare_append`,
+    /// version 1 files are refused.
+    bool append(std::string const& path, std::string const& stream_id,
+                size_t block_size = DEFAULT_BLOCK_SIZE);
     void write(int64_t timestamp_us, uint8_t const* data, uint32_t length);
+    /// Write the pending version 2 block, if any.
+    void flush();
     void close();
 
+    uint8_t version() const { return mVersion; }
+
 private:
-    FILE* mFile{nullptr};
+    void write_header(std::string const& stream_id);
+
+    FILE*                         mFile{nullptr};
+    uint8_t                       mVersion{VERSION_1};
+    std::unique_ptr<BlockEncoder> mEncoder;
 };
 
 }  // namespace tbin
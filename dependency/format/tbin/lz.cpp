@@ -0,0 +1,138 @@
+#include <format/tbin/lz.hpp>
+
+#include <cstring>
+
+namespace format {
+namespace tbin {
+namespace lz {
+
+static constexpr size_t MIN_MATCH  = 4;
+static constexpr size_t MAX_OFFSET = 65535;
+
+static uint32_t read32(uint8_t const* p) NOEXCEPT {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint8_t* write_length(uint8_t* op, size_t length) NOEXCEPT {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+static uint8_t* write_sequence(uint8_t* op, uint8_t const* literals, size_t literal_length,
+                               size_t offset, size_t match_length) NOEXCEPT {
+    auto token_literal = literal_length < 15 ? literal_length : 15;
+    auto token_match   = match_length < 15 ? match_length : 15;
+    *op++              = static_cast<uint8_t>((token_literal << 4) | token_match);
+    if (literal_length >= 15) op = write_length(op, literal_length - 15);
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (offset > 0) {
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        if (match_length >= 15) op = write_length(op, match_length - 15);
+    }
+    return op;
+}
+
+Compressor::Compressor() NOEXCEPT {
+    memset(mTable, 0, sizeof(mTable));
+}
+
+size_t Compressor::compress(uint8_t const* src, size_t size, uint8_t* dst,
+                            size_t capacity) NOEXCEPT {
+    if (capacity < compress_bound(size)) return 0;
+
+    // Positions are stored plus one so that zero means empty
+    memset(mTable, 0, sizeof(mTable));
+
+    auto   op     = dst;
+    size_t ip     = 0;
+    size_t anchor = 0;
+    if (size >= MIN_MATCH) {
+        auto last = size - MIN_MATCH;
+        while (ip <= last) {
+            auto value     = read32(src + ip);
+            auto hash      = (value * 2654435761u) >> (32 - HASH_BITS);
+            auto candidate = mTable[hash];
+            mTable[hash]   = static_cast<uint32_t>(ip + 1);
+
+            if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET ||
+                read32(src + candidate - 1) != value) {
+                ip++;
+                continue;
+            }
+
+            auto match  = candidate - 1;
+            auto length = MIN_MATCH;
+            while (ip + length < size && src[match + length] == src[ip + length])
+                length++;
+
+            op = write_sequence(op, src + anchor, ip - anchor, ip - match, length - MIN_MATCH);
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    op = write_sequence(op, src + anchor, size - anchor, 0, 0);
+    return static_cast<size_t>(op - dst);
+}
+
+static bool read_length(uint8_t const* src, size_t length, size_t& ip, size_t& value) NOEXCEPT {
+    uint8_t byte;
+    do {
+        if (ip >= length) return false;
+        byte = src[ip++];
+        value += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool decompress(uint8_t const* src, size_t length, uint8_t* dst, size_t size) NOEXCEPT {
+    size_t ip = 0;
+    size_t op = 0;
+    for (;;) {
+        if (ip >= length) return false;
+        auto token = src[ip++];
+
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_length(src, length, ip, literal_length)) return false;
+        if (literal_length > length - ip || literal_length > size - op) return false;
+        memcpy(dst + op, src + ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // The last sequence has no match
+        if (ip == length) return op == size;
+
+        if (length - ip < 2) return false;
+        size_t offset = static_cast<size_t>(src[ip]) | (static_cast<size_t>(src[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !read_length(src, length, ip, match_length)) return false;
+        match_length += MIN_MATCH;
+        if (match_length > size - op) return false;
+
+        auto match = dst + op - offset;
+        if (offset >= match_length) {
+            memcpy(dst + op, match, match_length);
+        } else {
+            // Overlapping match, repeats the last `offset` bytes
+            for (size_t i = 0; i < match_length; i++)
+                dst[op + i] = match[i];
+        }
+        op += match_length;
+    }
+}
+
+}  // namespace lz
+}  // namespace tbin
+}  // namespace format
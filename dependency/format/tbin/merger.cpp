@@ -0,0 +1,266 @@
+#include <format/tbin/merger.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace format {
+namespace tbin {
+
+static constexpr size_t EMPTY = static_cast<size_t>(-1);
+
+// Reads a source in batches. With a thread, the thread fills one batch while the merger consumes
+// the other, the batches and their messages are reused so steady state reading does not allocate.
+class Merger::Prefetcher {
+public:
+    Prefetcher(size_t batch_size, int64_t shift_us) NOEXCEPT
+        : mShift(shift_us),
+          mCurrent(0),
+          mPosition(0),
+          mAcquired(false),
+          mStop(false) {
+        for (auto& batch : mBatches) {
+            batch.messages.resize(batch_size);
+            batch.count = 0;
+            batch.end   = false;
+            batch.ready = false;
+        }
+    }
+
+    ~Prefetcher() NOEXCEPT {
+        if (mThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mStop = true;
+            }
+            mCondition.notify_all();
+            mThread.join();
+        }
+    }
+
+    bool open(std::string const& path, size_t buffer_size, bool prefetch) NOEXCEPT {
+        if (!mReader.open(path, buffer_size)) return false;
+        if (prefetch) {
+            mThread = std::thread([this]() {
+                run();
+            });
+        }
+        return true;
+    }
+
+    std::string const& stream_id() const NOEXCEPT { return mReader.stream_id(); }
+
+    // The current message, nullptr when the source is exhausted
+    Message* front() NOEXCEPT {
+        for (;;) {
+            if (!mAcquired) acquire();
+            auto& batch = mBatches[mCurrent];
+            if (mPosition < batch.count) return &batch.messages[mPosition];
+            if (batch.end) return nullptr;
+            release();
+        }
+    }
+
+    void pop() NOEXCEPT { mPosition++; }
+
+private:
+    struct Batch {
+        std::vector<Message> messages;
+        size_t               count;
+        bool                 end;
+        bool                 ready;
+    };
+
+    void fill(Batch& batch) NOEXCEPT {
+        batch.count = 0;
+        while (batch.count < batch.messages.size()) {
+            auto& message = batch.messages[batch.count];
+            if (!mReader.next(message)) {
+                batch.end = true;
+                break;
+            }
+            message.timestamp_us += mShift;
+            batch.count++;
+        }
+    }
+
+    void run() NOEXCEPT {
+        size_t index = 0;
+        for (;;) {
+            auto& batch = mBatches[index];
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [&]() {
+                    return mStop || !batch.ready;
+                });
+                if (mStop) return;
+            }
+
+            fill(batch);
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                batch.ready = true;
+            }
+            mCondition.notify_all();
+
+            if (batch.end) return;
+            index ^= 1;
+        }
+    }
+
+    void acquire() NOEXCEPT {
+        auto& batch = mBatches[mCurrent];
+        if (mThread.joinable()) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [&]() {
+                return batch.ready;
+            });
+        } else {
+            fill(batch);
+        }
+        mPosition = 0;
+        mAcquired = true;
+    }
+
+    void release() NOEXCEPT {
+        if (mThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mBatches[mCurrent].ready = false;
+            }
+            mCondition.notify_all();
+            mCurrent ^= 1;
+        }
+        mAcquired = false;
+    }
+
+    Reader                  mReader;
+    int64_t                 mShift;
+    Batch                   mBatches[2];
+    size_t                  mCurrent;
+    size_t                  mPosition;
+    bool                    mAcquired;
+    bool                    mStop;
+    std::mutex              mMutex;
+    std::condition_variable mCondition;
+    std::thread             mThread;
+};
+
+Merger::Merger() NOEXCEPT : Merger(Options{}) {}
+
+Merger::Merger(Options const& options) NOEXCEPT : mOptions(options), mDelivered(EMPTY) {
+    if (mOptions.batch_size == 0) mOptions.batch_size = 1;
+}
+
+Merger::~Merger() NOEXCEPT {
+    close();
+}
+
+bool Merger::open(std::vector<Source> const& sources) NOEXCEPT {
+    close();
+
+    for (auto& source : sources) {
+        std::unique_ptr<Prefetcher> prefetcher{
+            new Prefetcher(mOptions.batch_size, source.shift_us)};
+        if (!prefetcher->open(source.path, mOptions.read_buffer_size, mOptions.prefetch)) {
+            close();
+            return false;
+        }
+        mSources.push_back(std::move(prefetcher));
+    }
+
+    auto count = mSources.size();
+    mKeys.assign(count, 0);
+    mDone.assign(count, false);
+    for (size_t i = 0; i < count; i++) {
+        auto message = mSources[i]->front();
+        if (message) {
+            mKeys[i] = message->timestamp_us;
+        } else {
+            mDone[i] = true;
+        }
+    }
+
+    // Every internal node has two children, the first one to arrive waits for the second
+    mTree.assign(count, EMPTY);
+    for (size_t leaf = 0; leaf < count; leaf++) {
+        auto winner = leaf;
+        auto node   = (leaf + count) / 2;
+        for (; node > 0; node /= 2) {
+            if (mTree[node] == EMPTY) {
+                mTree[node] = winner;
+                break;
+            }
+            if (less(mTree[node], winner)) std::swap(mTree[node], winner);
+        }
+        if (node == 0) mTree[0] = winner;
+    }
+    return true;
+}
+
+void Merger::close() NOEXCEPT {
+    mSources.clear();
+    mKeys.clear();
+    mDone.clear();
+    mTree.clear();
+    mDelivered = EMPTY;
+}
+
+bool Merger::less(size_t a, size_t b) const NOEXCEPT {
+    if (mDone[a] != mDone[b]) return mDone[b];
+    if (mKeys[a] != mKeys[b]) return mKeys[a] < mKeys[b];
+    return a < b;
+}
+
+void Merger::replay(size_t leaf) NOEXCEPT {
+    auto winner = leaf;
+    for (auto node = (leaf + mTree.size()) / 2; node > 0; node /= 2) {
+        if (less(mTree[node], winner)) std::swap(mTree[node], winner);
+    }
+    mTree[0] = winner;
+}
+
+void Merger::advance() NOEXCEPT {
+    if (mDelivered == EMPTY) return;
+
+    auto& prefetcher = *mSources[mDelivered];
+    prefetcher.pop();
+    auto message = prefetcher.front();
+    if (message) {
+        mKeys[mDelivered] = message->timestamp_us;
+    } else {
+        mDone[mDelivered] = true;
+    }
+    replay(mDelivered);
+    mDelivered = EMPTY;
+}
+
+bool Merger::peek(int64_t& timestamp_us) NOEXCEPT {
+    if (mTree.empty()) return false;
+    advance();
+
+    auto winner = mTree[0];
+    if (mDone[winner]) return false;
+    timestamp_us = mKeys[winner];
+    return true;
+}
+
+Message* Merger::next(size_t* source) NOEXCEPT {
+    if (mTree.empty()) return nullptr;
+    advance();
+
+    auto winner = mTree[0];
+    if (mDone[winner]) return nullptr;
+
+    mDelivered = winner;
+    if (source) *source = winner;
+    return mSources[winner]->front();
+}
+
+std::string const& Merger::stream_id(size_t source) const NOEXCEPT {
+    return mSources[source]->stream_id();
+}
+
+}  // namespace tbin
+}  // namespace format
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <format/tbin/block.hpp>
 #include <format/tbin/reader.hpp>
 
 namespace format {
@@ -8,17 +9,28 @@ Reader::~Reader() {
     close();
 }
 
-bool Reader::open(std::string const& path) {
+bool Reader::open(std::string const& path, size_t buffer_size) {
     mFile = fopen(path.c_str(), "rb");
     if (!mFile) return false;
 
+    if (buffer_size > 0) {
+        mBuffer.resize(buffer_size);
+        setvbuf(mFile, mBuffer.data(), _IOFBF, mBuffer.size());
+    }
+
     char magic[4];
     if (fread(magic, 1, 4, mFile) != 4) return false;
     if (memcmp(magic, "TBIN", 4) != 0) return false;
+    return read_header();
+}
 
+// Reads the rest of the file header after the magic
+bool Reader::read_header() {
     uint8_t version;
     if (fread(&version, 1, 1, mFile) != 1) return false;
-    if (version != 1) return false;
+    if (version != 1 && version != 2) return false;
+    if (mVersion != 0 && version != mVersion) return false;
+    mVersion = version;
 
     uint8_t len;
     if (fread(&len, 1, 1, mFile) != 1) return false;
@@ -30,7 +42,11 @@ bool Reader::open(std::string const& path) {
 
 bool Reader::next(Message& msg) {
     if (!mFile || mEof) return false;
+    if (mVersion == 2) return next_v2(msg);
+    return next_v1(msg);
+}
 
+bool Reader::next_v1(Message& msg) {
     int64_t ts;
     if (fread(&ts, sizeof(ts), 1, mFile) != 1) {
         mEof = true;
@@ -53,6 +69,102 @@ bool Reader::next(Message& msg) {
     return true;
 }
 
+bool Reader::next_v2(Message& msg) {
+    while (mRemaining == 0) {
+        if (!read_block()) {
+            mEof = true;
+            return false;
+        }
+    }
+
+    uint8_t const* data;
+    uint32_t       length;
+    if (!next_record(mRaw, mRawPos, mTimestamp, data, length)) {
+        // The CRC matched, so the block was written like this. Skip the rest of it.
+        mCorruptBlocks++;
+        mRemaining = 0;
+        return next_v2(msg);
+    }
+
+    mRemaining--;
+    msg.timestamp_us = mTimestamp;
+    msg.data.assign(data, data + length);
+    return true;
+}
+
+bool Reader::read_block() {
+    for (;;) {
+        auto start = ftell(mFile);
+        mBlock.resize(BLOCK_HEADER_SIZE);
+        if (fread(mBlock.data(), 1, 4, mFile) != 4) return false;
+
+        // Appended or concatenated files repeat the file header
+        if (memcmp(mBlock.data(), "TBIN", 4) == 0) {
+            if (read_header()) continue;
+            mCorruptBlocks++;
+            if (!resync(start + 1)) return false;
+            continue;
+        }
+
+        if (fread(mBlock.data() + 4, 1, BLOCK_HEADER_SIZE - 4, mFile) != BLOCK_HEADER_SIZE - 4) {
+            return false;
+        }
+
+        BlockHeader header{};
+        if (!BlockHeader::parse(mBlock.data(), header)) {
+            mCorruptBlocks++;
+            if (!resync(start + 1)) return false;
+            continue;
+        }
+
+        mBlock.resize(BLOCK_HEADER_SIZE + header.stored_size);
+        if (fread(mBlock.data() + BLOCK_HEADER_SIZE, 1, header.stored_size, mFile) !=
+            header.stored_size) {
+            return false;
+        }
+
+        if (!decode_block(mBlock.data(), mBlock.size(), header, mRaw)) {
+            // Only the body may be damaged, continue after it if the next block is there.
+            // Otherwise the header was wrong as well and we scan for the next magic.
+            mCorruptBlocks++;
+            if (!at_magic() && !resync(start + 1)) return false;
+            continue;
+        }
+
+        mRawPos    = 0;
+        mRemaining = header.count;
+        mTimestamp = header.base_timestamp_us;
+        return true;
+    }
+}
+
+bool Reader::at_magic() {
+    auto    position = ftell(mFile);
+    uint8_t magic[4];
+    auto    found = fread(magic, 1, 4, mFile) == 4 &&
+                 (memcmp(magic, BLOCK_MAGIC, 4) == 0 || memcmp(magic, "TBIN", 4) == 0);
+    fseek(mFile, position, SEEK_SET);
+    return found;
+}
+
+// Scan from `position` for the next block or file header and leave the file at it
+bool Reader::resync(long position) {
+    if (fseek(mFile, position, SEEK_SET) != 0) return false;
+
+    uint8_t window[4];
+    if (fread(window, 1, 4, mFile) != 4) return false;
+    for (;;) {
+        if (memcmp(window, BLOCK_MAGIC, 4) == 0 || memcmp(window, "TBIN", 4) == 0) {
+            return fseek(mFile, -4, SEEK_CUR) == 0;
+        }
+
+        auto c = fgetc(mFile);
+        if (c == EOF) return false;
+        memmove(window, window + 1, 3);
+        window[3] = static_cast<uint8_t>(c);
+    }
+}
+
 void Reader::close() {
     if (mFile) {
         fclose(mFile);
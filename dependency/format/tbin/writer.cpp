@@ -1,6 +1,8 @@
 #include <cstring>
 #include <format/tbin/writer.hpp>
 
+#include <unistd.h>
+
 namespace format {
 namespace tbin {
 
@@ -8,30 +10,141 @@ Writer::~Writer() {
     close();
 }
 
-bool Writer::open(std::string const& path, std::string const& stream_id) {
+bool Writer::open(std::string const& path, std::string const& stream_id, uint8_t version,
+                  size_t block_size) {
+    if (version != VERSION_1 && version != VERSION_2) return false;
+
     mFile = fopen(path.c_str(), "wb");
     if (!mFile) return false;
 
+    mVersion = version;
+    if (mVersion == VERSION_2) {
+        mEncoder.reset(new BlockEncoder(block_size));
+    }
+
+    write_header(stream_id);
+    return true;
+}
+
+bool Writer::append(std::string const& path, std::string const& stream_id, size_t block_size) {
+    bool has_header = false;
+    if (!prepare_append(path, VERSION_2, has_header)) return false;
+    if (!has_header) return open(path, stream_id, VERSION_2, block_size);
+
+    mFile = fopen(path.c_str(), "ab");
+    if (!mFile) return false;
+
+    mVersion = VERSION_2;
+    mEncoder.reset(new BlockEncoder(block_size));
+    return true;
+}
+
+// End of the last complete version 1 record
+static long v1_end(FILE* file, long start, long size) {
+    auto end = start;
+    for (;;) {
+        uint8_t record[12];
+        if (fseek(file, end, SEEK_SET) != 0) break;
+        if (fread(record, 1, sizeof(record), file) != sizeof(record)) break;
+
+        uint32_t length;
+        memcpy(&length, record + 8, sizeof(length));
+        auto next = end + static_cast<long>(sizeof(record) + length);
+        if (next > size) break;
+        end = next;
+    }
+    return end;
+}
+
+// End of the last complete version 2 block, repeated file headers are skipped
+static long v2_end(FILE* file, long start, long size) {
+    auto end = start;
+    for (;;) {
+        uint8_t block[BLOCK_HEADER_SIZE];
+        if (fseek(file, end, SEEK_SET) != 0) break;
+        if (fread(block, 1, 4, file) != 4) break;
+        if (memcmp(block, MAGIC, 4) == 0) {
+            uint8_t rest[2];
+            if (fread(rest, 1, 2, file) != 2 || rest[0] != VERSION_2) break;
+            end += 6 + rest[1];
+            continue;
+        }
+
+        if (fread(block + 4, 1, BLOCK_HEADER_SIZE - 4, file) != BLOCK_HEADER_SIZE - 4) break;
+        BlockHeader block_header{};
+        if (!BlockHeader::parse(block, block_header)) break;
+
+        auto next = end + static_cast<long>(BLOCK_HEADER_SIZE + block_header.stored_size);
+        if (next > size) break;
+        end = next;
+    }
+    return end;
+}
+
+bool prepare_append(std::string const& path, uint8_t version, bool& has_header) {
+    has_header = false;
+    if (version != VERSION_1 && version != VERSION_2) return false;
+
+    auto file = fopen(path.c_str(), "r+b");
+    if (!file) return true;
+
+    fseek(file, 0, SEEK_END);
+    auto size = ftell(file);
+    if (size <= 0) {
+        fclose(file);
+        return true;
+    }
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t header[6];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, MAGIC, 4) != 0 || header[4] != version) {
+        fclose(file);
+        return false;
+    }
+
+    auto start = static_cast<long>(sizeof(header) + header[5]);
+    auto end   = version == VERSION_2 ? v2_end(file, start, size) : v1_end(file, start, size);
+    auto ok    = end >= size || ftruncate(fileno(file), end) == 0;
+    fclose(file);
+    has_header = true;
+    return ok;
+}
+
+void Writer::write_header(std::string const& stream_id) {
     fwrite(MAGIC, 1, 4, mFile);
-    fwrite(&VERSION, 1, 1, mFile);
+    fwrite(&mVersion, 1, 1, mFile);
     auto len = static_cast<uint8_t>(stream_id.size());
     fwrite(&len, 1, 1, mFile);
     fwrite(stream_id.data(), 1, len, mFile);
-    return true;
 }
 
 void Writer::write(int64_t timestamp_us, uint8_t const* data, uint32_t length) {
     if (!mFile) return;
+    if (mEncoder) {
+        mEncoder->add(timestamp_us, data, length);
+        if (mEncoder->full()) flush();
+        return;
+    }
+
     fwrite(&timestamp_us, sizeof(timestamp_us), 1, mFile);
     fwrite(&length, sizeof(length), 1, mFile);
     fwrite(data, 1, length, mFile);
 }
 
+void Writer::flush() {
+    if (!mFile || !mEncoder || mEncoder->empty()) return;
+    auto& block = mEncoder->finish();
+    fwrite(block.data(), 1, block.size(), mFile);
+}
+
 void Writer::close() {
     if (mFile) {
+        flush();
         fclose(mFile);
         mFile = nullptr;
     }
+    mEncoder.reset();
 }
 
 }  // namespace tbin
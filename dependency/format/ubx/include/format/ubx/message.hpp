@@ -1,17 +1,19 @@
 #pragma once
 #include <core/core.hpp>
+#include <format/helper/pool.hpp>
 
 #include <memory>
 #include <vector>
 
 namespace format {
 namespace ubx {
+class Decoder;
 class Message {
 public:
     EXPLICIT Message(uint8_t message_class, uint8_t message_id, std::vector<uint8_t> data) NOEXCEPT;
     virtual ~Message();
 
-    Message(Message const& other) : mClass(other.mClass), mId(other.mId) {}
+    Message(Message const& other);
     Message(Message&&)                 = delete;
     Message& operator=(Message const&) = delete;
     Message& operator=(Message&&)      = delete;
@@ -31,10 +33,28 @@ public:
     /// Clone the message.
     NODISCARD virtual std::unique_ptr<Message> clone() const NOEXCEPT = 0;
 
+    /// Parse a frame of the same class and id into this message, reusing its allocations. Returns
+    /// false if the message type does not support this or the frame is invalid.
+    NODISCARD virtual bool reparse(Decoder& decoder, uint8_t const* frame,
+                                   uint32_t length) NOEXCEPT;
+
+    /// Messages created while a pool is active are allocated from it (see `MessagePool`).
+    static void* operator new(size_t size) {
+        return helper::MessagePool::allocate(helper::MessagePool::current(), size);
+    }
+    static void operator delete(void* pointer) NOEXCEPT {
+        helper::MessagePool::deallocate(pointer);
+    }
+
+protected:
+    /// Replace the raw message data, keeping the existing capacity.
+    void assign_data(uint8_t const* frame, uint32_t length) NOEXCEPT;
+
 private:
     uint8_t              mClass;
     uint8_t              mId;
     std::vector<uint8_t> mData;  // Raw message data
+    helper::MessagePool* mPool;  // Pool to return mData to, if any
 };
 
 /// Unsupported or unknown message.
@@ -51,6 +71,8 @@ public:
 
     void      print() const NOEXCEPT override;
     NODISCARD std::unique_ptr<Message> clone() const NOEXCEPT override;
+    NODISCARD bool reparse(Decoder& decoder, uint8_t const* frame,
+                           uint32_t length) NOEXCEPT override;
 };
 
 }  // namespace ubx
@@ -56,7 +56,8 @@ public:
                         std::vector<uint8_t>&& data) NOEXCEPT;
     ~UbxRxmRawx() override = default;
 
-    UbxRxmRawx(UbxRxmRawx const& other) : Message(other), mPayload(other.mPayload) {}
+    UbxRxmRawx(UbxRxmRawx const& other)
+        : Message(other), mPayload(other.mPayload), mMeasurements(other.mMeasurements) {}
     UbxRxmRawx(UbxRxmRawx&&)                 = delete;
     UbxRxmRawx& operator=(UbxRxmRawx const&) = delete;
     UbxRxmRawx& operator=(UbxRxmRawx&&)      = delete;
@@ -77,6 +78,8 @@ public:
 
     void      print() const NOEXCEPT override;
     NODISCARD std::unique_ptr<Message> clone() const NOEXCEPT override;
+    NODISCARD bool reparse(Decoder& decoder, uint8_t const* frame,
+                           uint32_t length) NOEXCEPT override;
 
     NODISCARD static std::unique_ptr<Message> parse(Decoder&             decoder,
                                                     std::vector<uint8_t> data) NOEXCEPT;
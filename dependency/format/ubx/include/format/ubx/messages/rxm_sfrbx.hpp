@@ -51,6 +51,8 @@ public:
 
     void      print() const NOEXCEPT override;
     NODISCARD std::unique_ptr<Message> clone() const NOEXCEPT override;
+    NODISCARD bool reparse(Decoder& decoder, uint8_t const* frame,
+                           uint32_t length) NOEXCEPT override;
 
     NODISCARD static std::unique_ptr<Message> parse(Decoder&             decoder,
                                                     std::vector<uint8_t> data) NOEXCEPT;
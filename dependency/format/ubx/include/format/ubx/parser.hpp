@@ -2,6 +2,7 @@
 #include <format/ubx/message.hpp>
 
 #include <memory>
+#include <vector>
 
 #include <format/helper/parser.hpp>
 
@@ -16,11 +17,25 @@ public:
     NODISCARD virtual char const* name() const NOEXCEPT override;
 
     NODISCARD std::unique_ptr<Message> try_parse() NOEXCEPT;
+    /// Parse the next message into `message`. If `message` already holds a message of the same
+    /// class and id (or the parser has a spare one from an earlier call) it is refilled in place
+    /// and keeps its allocations; otherwise a new message is created.
+    NODISCARD bool try_parse_into(std::unique_ptr<Message>& message) NOEXCEPT;
     NODISCARD static uint16_t checksum_message(uint8_t* message_data, uint32_t message_length);
     NODISCARD static uint16_t checksum(uint8_t* payload, uint32_t length);
 
 protected:
     NODISCARD bool is_frame_boundary() const NOEXCEPT;
+
+private:
+    static CONSTEXPR uint32_t MAX_FRAME_LENGTH = 8192 + 8;
+    static CONSTEXPR size_t   MAX_SPARES       = 8;
+
+    /// Copy the next valid frame into `buffer` and return its length, or 0 if there is none.
+    NODISCARD uint32_t                 next_frame(uint8_t* buffer) NOEXCEPT;
+    NODISCARD std::unique_ptr<Message> decode(uint8_t* buffer, uint32_t frame_length) NOEXCEPT;
+
+    std::vector<std::unique_ptr<Message>> mSpares;
 };
 
 }  // namespace ubx
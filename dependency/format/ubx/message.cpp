@@ -9,9 +9,31 @@ namespace ubx {
 Message::Message(uint8_t message_class, uint8_t message_id, std::vector<uint8_t> data) NOEXCEPT
     : mClass(message_class),
       mId(message_id),
-      mData(std::move(data)) {}
+      mData(std::move(data)),
+      mPool(helper::MessagePool::current()) {
+    if (mPool) mPool->retain();
+}
+
+Message::Message(Message const& other)
+    : mClass(other.mClass), mId(other.mId), mData(other.mData),
+      mPool(helper::MessagePool::current()) {
+    if (mPool) mPool->retain();
+}
+
+Message::~Message() {
+    if (mPool) {
+        mPool->recycle_buffer(std::move(mData));
+        mPool->release();
+    }
+}
 
-Message::~Message() = default;
+bool Message::reparse(Decoder&, uint8_t const*, uint32_t) NOEXCEPT {
+    return false;
+}
+
+void Message::assign_data(uint8_t const* frame, uint32_t length) NOEXCEPT {
+    mData.assign(frame, frame + length);
+}
 
 UnsupportedMessage::UnsupportedMessage(uint8_t message_class, uint8_t message_id,
                                        std::vector<uint8_t> data) NOEXCEPT
@@ -25,5 +47,10 @@ std::unique_ptr<Message> UnsupportedMessage::clone() const NOEXCEPT {
     return std::unique_ptr<Message>{new UnsupportedMessage{*this}};
 }
 
+bool UnsupportedMessage::reparse(Decoder&, uint8_t const* frame, uint32_t length) NOEXCEPT {
+    assign_data(frame, length);
+    return true;
+}
+
 }  // namespace ubx
 }  // namespace format
@@ -28,11 +28,11 @@ std::unique_ptr<Message> UbxRxmRawx::clone() const NOEXCEPT {
     return std::unique_ptr<Message>{new UbxRxmRawx{*this}};
 }
 
-std::unique_ptr<Message> UbxRxmRawx::parse(Decoder& decoder, std::vector<uint8_t> data) NOEXCEPT {
-    FUNCTION_SCOPE();
+static bool decode(Decoder& decoder, raw::RxmRawx& payload,
+                   std::vector<raw::RxmRawxMeasurement>& measurements) NOEXCEPT {
     if (decoder.remaining() < 16) {
         VERBOSEF("not enough data for payload");
-        return nullptr;
+        return false;
     }
 
     auto rcv_tow   = decoder.r8();
@@ -44,10 +44,9 @@ std::unique_ptr<Message> UbxRxmRawx::parse(Decoder& decoder, std::vector<uint8_t
     auto reserved0 = decoder.u2();
     if (decoder.error()) {
         VERBOSEF("failed to decode payload");
-        return nullptr;
+        return false;
     }
 
-    raw::RxmRawx payload;
     payload.rcv_tow            = rcv_tow;
     payload.week               = week;
     payload.leap_s             = leap_s;
@@ -64,7 +63,8 @@ std::unique_ptr<Message> UbxRxmRawx::parse(Decoder& decoder, std::vector<uint8_t
     VERBOSEF("rec_stat=0x%02X", rec_stat);
     VERBOSEF("version=%u", version);
 
-    std::vector<raw::RxmRawxMeasurement> measurements;
+    measurements.clear();
+    measurements.reserve(num_meas);
     for (uint8_t i = 0; i < num_meas; i++) {
         auto pr_mes         = decoder.r8();
         auto cp_mes         = decoder.r8();
@@ -82,7 +82,7 @@ std::unique_ptr<Message> UbxRxmRawx::parse(Decoder& decoder, std::vector<uint8_t
         auto meas_reserved0 = decoder.u1();
         if (decoder.error()) {
             VERBOSEF("failed to decode measurement %u", i);
-            return nullptr;
+            return false;
         }
 
         raw::RxmRawxMeasurement measurement;
@@ -108,12 +108,27 @@ std::unique_ptr<Message> UbxRxmRawx::parse(Decoder& decoder, std::vector<uint8_t
 
     if (decoder.error()) {
         VERBOSEF("failed to decode measurements");
-        return nullptr;
-    } else {
-        VERBOSEF("decoded %zu measurements", measurements.size());
-        return std::unique_ptr<Message>{
-            new UbxRxmRawx(std::move(payload), std::move(measurements), std::move(data))};
+        return false;
     }
+
+    VERBOSEF("decoded %zu measurements", measurements.size());
+    return true;
+}
+
+std::unique_ptr<Message> UbxRxmRawx::parse(Decoder& decoder, std::vector<uint8_t> data) NOEXCEPT {
+    FUNCTION_SCOPE();
+    raw::RxmRawx                         payload;
+    std::vector<raw::RxmRawxMeasurement> measurements;
+    if (!decode(decoder, payload, measurements)) return nullptr;
+    return std::unique_ptr<Message>{
+        new UbxRxmRawx(std::move(payload), std::move(measurements), std::move(data))};
+}
+
+bool UbxRxmRawx::reparse(Decoder& decoder, uint8_t const* frame, uint32_t length) NOEXCEPT {
+    FUNCTION_SCOPE();
+    if (!decode(decoder, mPayload, mMeasurements)) return false;
+    assign_data(frame, length);
+    return true;
 }
 
 }  // namespace ubx
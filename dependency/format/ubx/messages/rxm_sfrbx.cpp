@@ -93,10 +93,11 @@ std::unique_ptr<Message> RxmSfrbx::clone() const NOEXCEPT {
     return std::unique_ptr<Message>{new RxmSfrbx{*this}};
 }
 
-std::unique_ptr<Message> RxmSfrbx::parse(Decoder& decoder, std::vector<uint8_t> data) NOEXCEPT {
+static bool decode(Decoder& decoder, raw::RxmSfrbx& payload,
+                   std::vector<uint32_t>& words) NOEXCEPT {
     if (decoder.remaining() < 8) {
         VERBOSEF("parse failed: insufficient data (need 8, have %u)", decoder.remaining());
-        return nullptr;
+        return false;
     }
 
     auto gnss_id   = decoder.u1();
@@ -109,10 +110,9 @@ std::unique_ptr<Message> RxmSfrbx::parse(Decoder& decoder, std::vector<uint8_t>
     auto reserved0 = decoder.u1();
     if (decoder.error()) {
         VERBOSEF("parse failed: decoder error reading header");
-        return nullptr;
+        return false;
     }
 
-    raw::RxmSfrbx payload;
     payload.gnss_id   = gnss_id;
     payload.sv_id     = sv_id;
     payload.sig_id    = sig_id;
@@ -123,21 +123,35 @@ std::unique_ptr<Message> RxmSfrbx::parse(Decoder& decoder, std::vector<uint8_t>
     payload.reserved0 = reserved0;
     if (version != 0x02) {
         VERBOSEF("parse failed: unsupported version %u", version);
-        return nullptr;
+        return false;
     }
 
-    std::vector<uint32_t> words;
+    words.clear();
+    words.reserve(num_words);
     for (size_t i = 0; i < num_words; ++i) {
         words.push_back(decoder.u4());
     }
 
     if (decoder.error()) {
         VERBOSEF("parse failed: decoder error reading words");
-        return nullptr;
-    } else {
-        return std::unique_ptr<Message>{
-            new RxmSfrbx(std::move(payload), std::move(words), std::move(data))};
+        return false;
     }
+
+    return true;
+}
+
+std::unique_ptr<Message> RxmSfrbx::parse(Decoder& decoder, std::vector<uint8_t> data) NOEXCEPT {
+    raw::RxmSfrbx         payload;
+    std::vector<uint32_t> words;
+    if (!decode(decoder, payload, words)) return nullptr;
+    return std::unique_ptr<Message>{
+        new RxmSfrbx(std::move(payload), std::move(words), std::move(data))};
+}
+
+bool RxmSfrbx::reparse(Decoder& decoder, uint8_t const* frame, uint32_t length) NOEXCEPT {
+    if (!decode(decoder, mPayload, mWords)) return false;
+    assign_data(frame, length);
+    return true;
 }
 
 }  // namespace ubx
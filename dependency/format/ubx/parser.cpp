@@ -10,6 +10,9 @@
 #include "messages/rxm_sfrbx.hpp"
 #include "messages/rxm_spartn.hpp"
 
+#include <format/checksum/checksum.hpp>
+#include <format/helper/scan.hpp>
+
 #include <cstdio>
 
 #include <loglet/loglet.hpp>
@@ -28,76 +31,121 @@ char const* Parser::name() const NOEXCEPT {
 
 std::unique_ptr<Message> Parser::try_parse() NOEXCEPT {
     FUNCTION_SCOPEF("%u bytes", buffer_length());
+    helper::MessagePool::Scope scope(pool());
 
-    // search for frame boundary
-    bool did_skip_anything = false;
-    for (;;) {
-        if (buffer_length() < 8) {
-            // not enough data to search for frame boundary
-            TRACEF("not enough data to search for frame boundary: %u", buffer_length());
-            return nullptr;
-        }
+    uint8_t buffer[MAX_FRAME_LENGTH];
+    auto    length = next_frame(buffer);
+    if (length == 0) return nullptr;
+    return decode(buffer, length);
+}
 
-        if (is_frame_boundary()) {
-            if (did_skip_anything) {
-                // found frame boundary (only print once)
-                VERBOSEF("found frame boundary");
+bool Parser::try_parse_into(std::unique_ptr<Message>& message) NOEXCEPT {
+    FUNCTION_SCOPEF("%u bytes", buffer_length());
+    helper::MessagePool::Scope scope(pool());
+
+    uint8_t buffer[MAX_FRAME_LENGTH];
+    auto    length = next_frame(buffer);
+    if (length == 0) return false;
+
+    auto message_class = buffer[2];
+    auto message_id    = buffer[3];
+    if (!message || message->message_class() != message_class ||
+        message->message_id() != message_id) {
+        // keep the caller's message for when its type shows up again and pick up a spare one of
+        // this type, if there is one
+        std::unique_ptr<Message> spare;
+        for (auto it = mSpares.begin(); it != mSpares.end(); ++it) {
+            if ((*it)->message_class() == message_class && (*it)->message_id() == message_id) {
+                spare = std::move(*it);
+                mSpares.erase(it);
+                break;
             }
-            break;
         }
 
-        // skip one byte and try again
-        skip(1u);
-        did_skip_anything = true;
+        if (message) {
+            if (mSpares.size() >= MAX_SPARES) mSpares.erase(mSpares.begin());
+            mSpares.push_back(std::move(message));
+        }
+        message = std::move(spare);
     }
 
-    // check that we have enough data for the header
-    if (buffer_length() < 8) {
-        // not enough data for header
-        VERBOSEF("not enough data for header: %u", buffer_length());
-        return nullptr;
+    if (message) {
+        Decoder decoder(buffer + 6, length - 8);
+        if (message->reparse(decoder, buffer, length)) {
+            DEBUGF("ubx: %02X-%02X, length: %u, reused", message_class, message_id, length - 8);
+            return true;
+        }
     }
 
-    // read header
-    uint8_t buffer[8192];
-    copy_to_buffer(buffer, 6u);
+    message = decode(buffer, length);
+    return message != nullptr;
+}
+
+uint32_t Parser::next_frame(uint8_t* buffer) NOEXCEPT {
+    // search for frame boundary
+    for (;;) {
+        auto before = buffer_length();
+        skip_to_frame_start(helper::FRAME_UBX);
+        if (buffer_length() < 8) {
+            // not enough data to search for frame boundary
+            TRACEF("not enough data to search for frame boundary: %u", buffer_length());
+            return 0;
+        }
+
+        if (!is_frame_boundary()) {
+            // 0xB5 at the end of the contiguous part of the buffer, not followed by 0x62
+            skip(1u);
+            continue;
+        } else if (before != buffer_length()) {
+            // found frame boundary (only print once)
+            VERBOSEF("found frame boundary");
+        }
 
-    Decoder header_decoder(buffer, 6);
-    header_decoder.skip(2);  // skip frame boundary
-    auto message_class = header_decoder.u1();
-    auto message_id    = header_decoder.u1();
-    auto length        = static_cast<uint32_t>(header_decoder.u2());
+        // read header
+        copy_to_buffer(buffer, 6u);
+
+        Decoder header_decoder(buffer, 6);
+        header_decoder.skip(4);  // skip frame boundary, message class and id
+        auto length = static_cast<uint32_t>(header_decoder.u2());
+
+        if (length + 8 > MAX_FRAME_LENGTH) {
+            // invalid length
+            skip(2u);
+            VERBOSEF("invalid length");
+            continue;
+        } else if (buffer_length() < length + 8) {
+            // not enough data for payload
+            TRACEF("not enough data for payload: %u of %u", buffer_length(), length + 8);
+            return 0;
+        }
 
-    auto type = (static_cast<uint16_t>(message_class) << 8) | static_cast<uint16_t>(message_id);
-    if (length > 8192) {
-        // invalid length
-        skip(2u);
-        VERBOSEF("invalid length");
-        return nullptr;
-    } else if (buffer_length() < length + 8) {
-        // not enough data for payload
-        TRACEF("not enough data for payload: %u of %u", buffer_length(), length + 8);
-        return nullptr;
-    }
+        copy_to_buffer(buffer, length + 8);
+
+        // check checksum
+        auto calculated_checksum = checksum_message(buffer, length + 8);
+        auto expected_checksum   = (static_cast<uint16_t>(buffer[length + 7]) << 8) |
+                                 static_cast<uint16_t>(buffer[length + 6]);
+        if (calculated_checksum != expected_checksum) {
+            // checksum failed
+            skip(2u);
+            VERBOSEF("checksum failed");
+            continue;
+        }
 
-    copy_to_buffer(buffer, length + 8);
-
-    // check checksum
-    auto calculated_checksum = checksum_message(buffer, length + 8);
-    auto expected_checksum   = (static_cast<uint16_t>(buffer[length + 7]) << 8) |
-                             static_cast<uint16_t>(buffer[length + 6]);
-    if (calculated_checksum != expected_checksum) {
-        // checksum failed
-        skip(2u);
-        VERBOSEF("checksum failed");
-        return nullptr;
+        skip(length + 8);
+        return length + 8;
     }
+}
 
-    skip(length + 8);
+std::unique_ptr<Message> Parser::decode(uint8_t* buffer, uint32_t frame_length) NOEXCEPT {
+    auto message_class = buffer[2];
+    auto message_id    = buffer[3];
+    auto length        = frame_length - 8;
+    auto type = (static_cast<uint16_t>(message_class) << 8) | static_cast<uint16_t>(message_id);
 
     // parse payload
-    Decoder              decoder(buffer + 6, length);
-    std::vector<uint8_t> data(buffer, buffer + length + 8);
+    Decoder decoder(buffer + 6, length);
+    auto    data = make_buffer(buffer, frame_length);
 
     std::unique_ptr<Message> result;
     switch (type) {
@@ -139,14 +187,7 @@ uint16_t Parser::checksum_message(uint8_t* message_data, uint32_t message_length
 
 uint16_t Parser::checksum(uint8_t* payload, uint32_t length) {
     ASSERT(length <= 0xFFFF, "length must be less than 0xFFFF");
-
-    uint8_t ck_a = 0, ck_b = 0;
-    for (uint16_t i = 0; i < static_cast<uint16_t>(length); i++) {
-        ck_a = ck_a + payload[i];
-        ck_b = ck_b + ck_a;
-    }
-
-    return static_cast<uint16_t>((ck_b << 8U) | ck_a);
+    return checksum::fletcher8(payload, length);
 }
 
 }  // namespace ubx
@@ -0,0 +1,99 @@
+#pragma once
+#include <core/core.hpp>
+#include <generator/idokeido/idokeido.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+namespace idokeido {
+
+/// Normal equations of a weighted linear least-squares problem with `N` unknowns. Observations are
+/// accumulated one row at a time into H^T W H and H^T W r, so the design matrix is never stored
+/// and nothing is allocated regardless of the number of satellites. The system is solved with an
+/// explicit Cholesky factorization, `N` is small (4 for position and receiver clock, 5 with an
+/// inter-system bias).
+template <size_t N>
+class NormalEquations {
+public:
+    NormalEquations() NOEXCEPT { reset(); }
+
+    void reset() NOEXCEPT {
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                mHtH[i][j] = 0.0;
+            }
+            mHtr[i] = 0.0;
+        }
+        mCount = 0;
+    }
+
+    /// Add the row `h` of the design matrix with residual `r` and weight `w`.
+    void add(Scalar const (&h)[N], Scalar r, Scalar w = 1.0) NOEXCEPT {
+        for (size_t i = 0; i < N; ++i) {
+            auto wh = w * h[i];
+            // Only the lower triangle is used by the factorization
+            for (size_t j = 0; j <= i; ++j) {
+                mHtH[i][j] += wh * h[j];
+            }
+            mHtr[i] += wh * r;
+        }
+        mCount++;
+    }
+
+    NODISCARD size_t count() const NOEXCEPT { return mCount; }
+
+    /// Solve (H^T W H) x = H^T W r, fails if the system is under-determined or not positive
+    /// definite.
+    NODISCARD bool solve(Scalar (&x)[N]) const NOEXCEPT {
+        if (mCount < N) return false;
+
+        // H^T W H = L L^T
+        Scalar l[N][N];
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                auto sum = mHtH[i][j];
+                for (size_t k = 0; k < j; ++k) {
+                    sum -= l[i][k] * l[j][k];
+                }
+
+                if (i == j) {
+                    // Relative to the diagonal, rounding leaves a tiny pivot for a singular system
+                    if (!(sum > mHtH[i][i] * PIVOT_EPSILON)) return false;
+                    l[i][i] = std::sqrt(sum);
+                } else {
+                    l[i][j] = sum / l[j][j];
+                }
+            }
+        }
+
+        // L y = H^T W r
+        Scalar y[N];
+        for (size_t i = 0; i < N; ++i) {
+            auto sum = mHtr[i];
+            for (size_t k = 0; k < i; ++k) {
+                sum -= l[i][k] * y[k];
+            }
+            y[i] = sum / l[i][i];
+        }
+
+        // L^T x = y
+        for (size_t n = N; n > 0; --n) {
+            auto i   = n - 1;
+            auto sum = y[i];
+            for (size_t k = i + 1; k < N; ++k) {
+                sum -= l[k][i] * x[k];
+            }
+            x[i] = sum / l[i][i];
+        }
+        return true;
+    }
+
+private:
+    static constexpr Scalar PIVOT_EPSILON = 1e-12;
+
+    Scalar mHtH[N][N];
+    Scalar mHtr[N];
+    size_t mCount;
+};
+
+}  // namespace idokeido
@@ -6,7 +6,8 @@
 #include <generator/idokeido/klobuchar.hpp>
 #include <generator/idokeido/satellite.hpp>
 
-#include <bitset>
+#include <array>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -53,16 +54,17 @@ public:
     };
 
     struct Observation {
-        ts::Tai                                  time;
-        SatelliteId                              satellite_id;
-        size_t                                   measurement_count;
-        std::bitset<SIGNAL_ABS_COUNT>            measurement_mask;
-        std::array<Measurment, SIGNAL_ABS_COUNT> measurements;
+        ts::Tai     time;
+        SatelliteId satellite_id;
+        // Tracked signals ordered by absolute signal id, usually only a few per satellite
+        std::vector<Measurment> measurements;
+        // Part of the current epoch
+        bool active;
 
         Vector3 eph_position;
         Vector3 eph_velocity;
         Scalar  eph_clock_bias;
-        Scalar  group_delay[SIGNAL_ABS_COUNT];
+        Scalar  group_delay;
 
         Scalar azimuth;
         Scalar elevation;
@@ -72,19 +74,14 @@ public:
         Vector3 true_velocity;
         Scalar  true_clock_bias;
 
+        // Index into `measurements`
         long selected0;
         long selected1;
 
         ephemeris::Ephemeris ephemeris;
 
-        void add_measurement(Measurment const& measurment) NOEXCEPT {
-            auto id = measurment.signal_id.absolute_id();
-            if (id < 0 || static_cast<size_t>(id) >= SIGNAL_ABS_COUNT) return;
-            auto idx              = static_cast<size_t>(id);
-            measurement_mask[idx] = true;
-            measurements[idx]     = measurment;
-            measurement_count += 1;
-        }
+        NODISCARD size_t measurement_count() const NOEXCEPT { return measurements.size(); }
+        void             add_measurement(Measurment const& measurment) NOEXCEPT;
     };
 
     SppEngine(SppConfiguration configuration, EphemerisEngine& ephemeris_engine,
@@ -102,12 +99,27 @@ public:
     /// Evaluate the SPP at epoch
     NODISCARD Solution evaluate(ts::Tai time) NOEXCEPT;
 
+    /// Evaluate every epoch of a recorded window, e.g. for RINEX or TBIN post-processing. A new
+    /// epoch starts when a measurement is more than half the observation window after the first
+    /// measurement of the current one. Each epoch is evaluated on its own, independent of the
+    /// measurements added with `add_measurement`, on up to `threads` workers that share the
+    /// ephemeris and corrections. Solutions are delivered in time order on the calling thread.
+    /// With verbose or trace logging enabled the epochs are evaluated on the calling thread.
+    void evaluate_batch(std::vector<RawMeasurement> const&          measurements,
+                        size_t                                      threads,
+                        std::function<void(Solution const&)> const& callback) NOEXCEPT;
+
 protected:
     void select_best_observations(ts::Tai const& time);
     void compute_satellite_states(ts::Tai const& time);
 
     void datatrace_report() NOEXCEPT;
 
+    NODISCARD Observation& observation(SatelliteId satellite_id, size_t index) NOEXCEPT;
+    void                   reset_observations() NOEXCEPT;
+    void                   remove_untracked_observations() NOEXCEPT;
+    NODISCARD size_t       active_observation_count() const NOEXCEPT;
+
 private:
     SppConfiguration mConfiguration;
     EphemerisEngine& mEphemerisEngine;
@@ -120,8 +132,10 @@ private:
     long    mEpochObservationCount;
     double  mEpochTotalObservationTime;
 
-    std::bitset<SATELLITE_ID_MAX>             mObservationMask;
-    std::array<Observation, SATELLITE_ID_MAX> mObservations;
+    // Only the tracked satellites, ordered by absolute satellite id. `mObservationIndex` maps an
+    // absolute satellite id to its position in `mObservations` or -1.
+    std::vector<Observation>              mObservations;
+    std::array<int16_t, SATELLITE_ID_MAX> mObservationIndex;
 
     KlobucharModelParameters mKlobucharModel;
     bool                     mKlobucharModelSet;
@@ -1,7 +1,13 @@
 #include "spp.hpp"
 #include "eph.hpp"
+#include "least_squares.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #ifdef INCLUDE_GENERATOR_TOKORO
 #include <generator/tokoro/coordinate.hpp>
 #endif
@@ -15,8 +21,6 @@
 #include <datatrace/datatrace.hpp>
 #endif
 
-#include <iomanip>
-
 LOGLET_MODULE2(idokeido, spp);
 #undef LOGLET_CURRENT_MODULE
 #define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(idokeido, spp)
@@ -37,6 +41,8 @@ SppEngine::SppEngine(SppConfiguration configuration, EphemerisEngine& ephemeris_
     mEpochTotalObservationTime = 0;
 
     mKlobucharModelSet = false;
+
+    mObservationIndex.fill(-1);
 }
 
 SppEngine::~SppEngine() {
@@ -74,11 +80,8 @@ void SppEngine::add_measurement(RawMeasurement const& raw) NOEXCEPT {
     }
 
     // Mark that the satellite is active
-    auto sat_idx              = static_cast<size_t>(satellite_id);
-    mObservationMask[sat_idx] = true;
-
-    auto& observation        = mObservations[sat_idx];
-    observation.satellite_id = raw.satellite_id;
+    auto& observation  = this->observation(raw.satellite_id, static_cast<size_t>(satellite_id));
+    observation.active = true;
     observation.add_measurement(Measurment{
         .time          = raw.time,
         .signal_id     = raw.signal_id,
@@ -99,112 +102,154 @@ void SppEngine::add_measurement(RawMeasurement const& raw) NOEXCEPT {
     mEpochTotalObservationTime += raw.time.timestamp().full_seconds();
 }
 
-template <typename T>
-static std::string epf(T const& t) {
-    std::stringstream ss;
-    ss << std::fixed << std::setprecision(8);
-    ss << t;
-    return ss.str();
+void SppEngine::Observation::add_measurement(Measurment const& measurment) NOEXCEPT {
+    auto id = measurment.signal_id.absolute_id();
+    if (id < 0 || static_cast<size_t>(id) >= SIGNAL_ABS_COUNT) return;
+
+    auto it = std::lower_bound(measurements.begin(), measurements.end(), id,
+                               [](Measurment const& m, long signal_id) {
+                                   return m.signal_id.absolute_id() < signal_id;
+                               });
+    if (it != measurements.end() && it->signal_id.absolute_id() == id) {
+        *it = measurment;
+    } else {
+        measurements.insert(it, measurment);
+    }
+}
+
+SppEngine::Observation& SppEngine::observation(SatelliteId satellite_id, size_t index) NOEXCEPT {
+    auto position = mObservationIndex[index];
+    if (position >= 0) return mObservations[static_cast<size_t>(position)];
+
+    // A new satellite, keep the order so that the satellites are used in the same order as before
+    auto it = std::lower_bound(mObservations.begin(), mObservations.end(), satellite_id,
+                               [](Observation const& o, SatelliteId id) {
+                                   return o.satellite_id.absolute_id() < id.absolute_id();
+                               });
+    Observation observation{};
+    observation.satellite_id = satellite_id;
+    observation.active       = false;
+    observation.selected0    = -1;
+    observation.selected1    = -1;
+    it                       = mObservations.insert(it, std::move(observation));
+
+    mObservationIndex.fill(-1);
+    for (size_t i = 0; i < mObservations.size(); ++i) {
+        auto id               = static_cast<size_t>(mObservations[i].satellite_id.absolute_id());
+        mObservationIndex[id] = static_cast<int16_t>(i);
+    }
+    return *it;
+}
+
+void SppEngine::remove_untracked_observations() NOEXCEPT {
+    auto end = std::remove_if(mObservations.begin(), mObservations.end(),
+                              [](Observation const& observation) {
+                                  return observation.measurements.empty();
+                              });
+    if (end == mObservations.end()) return;
+    mObservations.erase(end, mObservations.end());
+
+    mObservationIndex.fill(-1);
+    for (size_t i = 0; i < mObservations.size(); ++i) {
+        auto id               = static_cast<size_t>(mObservations[i].satellite_id.absolute_id());
+        mObservationIndex[id] = static_cast<int16_t>(i);
+    }
+}
+
+void SppEngine::reset_observations() NOEXCEPT {
+    mObservations.clear();
+    mObservationIndex.fill(-1);
+
+    mEpochFirstTimeSet         = false;
+    mEpochLastTimeSet          = false;
+    mEpochObservationCount     = 0;
+    mEpochTotalObservationTime = 0;
+}
+
+size_t SppEngine::active_observation_count() const NOEXCEPT {
+    size_t count = 0;
+    for (auto const& observation : mObservations) {
+        if (observation.active) count++;
+    }
+    return count;
 }
 
 void SppEngine::select_best_observations(ts::Tai const& time) {
     FUNCTION_SCOPE();
 
-    for (size_t i = 0; i < mObservationMask.size(); ++i) {
-        if (!mObservationMask[i]) continue;
-        auto& observation = mObservations[i];
-        VERBOSEF("%03ld %s: %d measurments", observation.satellite_id.absolute_id(),
-                 observation.satellite_id.name(), observation.measurement_count);
-        for (size_t j = 0; j < observation.measurement_mask.size(); ++j) {
-            if (!observation.measurement_mask[j]) continue;
-            auto& measurement = observation.measurements[j];
+    for (auto const& observation : mObservations) {
+        if (!observation.active) continue;
+        VERBOSEF("%03ld %s: %zu measurments", observation.satellite_id.absolute_id(),
+                 observation.satellite_id.name(), observation.measurement_count());
+        for (auto const& measurement : observation.measurements) {
             VERBOSEF("  %12s: %s %+16.4f", measurement.signal_id.name(),
                      measurement.time.rtklib_time_string().c_str(), measurement.pseudo_range);
         }
     }
 
-    std::bitset<SIGNAL_ABS_COUNT> measurment_skip;
-
     DEBUGF("selecting best observation for each satellite");
-    for (size_t i = 0; i < mObservationMask.size(); ++i) {
-        if (!mObservationMask[i]) continue;
+    for (auto& observation : mObservations) {
+        if (!observation.active) continue;
 
-        auto& observation = mObservations[i];
-        if (observation.measurement_count == 0) {
-            WARNF("reject: %03ld %s: no measurement", observation.satellite_id.absolute_id(),
-                  observation.satellite_id.name());
-            mObservationMask[i] = false;
+        auto sid = observation.satellite_id.absolute_id();
+        if (observation.measurements.empty()) {
+            WARNF("reject: %03ld %s: no measurement", sid, observation.satellite_id.name());
+            observation.active = false;
             continue;
         }
 
         // Reset the observation
         observation.selected0 = -1;
         observation.selected1 = -1;
-        measurment_skip.reset();
-
-        // Discard measurement that is out of observation window
-        for (size_t j = 0; j < observation.measurement_mask.size(); ++j) {
-            if (!observation.measurement_mask[j]) continue;
 
+        // Select the best measurement based on SNR, measurements that are out of the observation
+        // window or of an unsupported signal are discarded. The kept measurements are compacted
+        // in place, so the selected index refers to the final position.
+        long   best_id  = -1;
+        double best_snr = 0.0;
+        size_t kept     = 0;
+        for (size_t j = 0; j < observation.measurements.size(); ++j) {
             auto& measurement = observation.measurements[j];
+            auto  oid         = measurement.signal_id.absolute_id();
             auto  time_diff   = time.difference_seconds(measurement.time);
             if (time_diff < -mConfiguration.observation_window * 0.5) {
-                WARNF("measurement time out of window: %03ld:%04ld %s %s: %s out of %s", i, j,
+                WARNF("measurement time out of window: %03ld:%04ld %s %s: %s out of %s", sid, oid,
                       observation.satellite_id.name(), measurement.signal_id.name(),
                       measurement.time.rtklib_time_string().c_str(),
                       time.rtklib_time_string().c_str());
-                observation.measurement_mask[j] = false;
-                observation.measurement_count -= 1;
-                continue;
-            }
-
-            if (time_diff > mConfiguration.observation_window * 0.5) {
-                measurment_skip[j] = true;  // Skip this measurement, but don't discard it
                 continue;
             }
 
-            // If the measurement is within the observation window, we need to align the
-            // pseudo-range to the epoch time
-            measurement.time = time;
-            measurement.pseudo_range += constant::K_C * time_diff;
-        }
-
-        // Discard measurement that are of unsupported signal
-        for (size_t j = 0; j < observation.measurement_mask.size(); ++j) {
-            if (!observation.measurement_mask[j]) continue;
-            if (measurment_skip[j]) continue;
-
-            auto& measurement = observation.measurements[j];
-
-            if (measurement.signal_id == SignalId::GPS_L1_CA) continue;
-
-            WARNF("unsupported signal: %03ld:%04ld %s %s: %s %s", i, j,
-                  observation.satellite_id.name(), measurement.signal_id.name(),
-                  time.rtklib_time_string().c_str(), measurement.time.rtklib_time_string().c_str());
-
-            observation.measurement_mask[j] = false;
-            observation.measurement_count -= 1;
-        }
-
-        // Select the best measurement based on SNR
-        long   best_id  = -1;
-        double best_snr = 0.0;
-
-        for (size_t j = 0; j < observation.measurement_mask.size(); ++j) {
-            if (!observation.measurement_mask[j]) continue;
-            if (measurment_skip[j]) continue;
+            // Skip this measurement, but don't discard it
+            auto skip = time_diff > mConfiguration.observation_window * 0.5;
+            if (!skip) {
+                // If the measurement is within the observation window, we need to align the
+                // pseudo-range to the epoch time
+                measurement.time = time;
+                measurement.pseudo_range += constant::K_C * time_diff;
+
+                if (measurement.signal_id != SignalId::GPS_L1_CA) {
+                    WARNF("unsupported signal: %03ld:%04ld %s %s: %s %s", sid, oid,
+                          observation.satellite_id.name(), measurement.signal_id.name(),
+                          time.rtklib_time_string().c_str(),
+                          measurement.time.rtklib_time_string().c_str());
+                    continue;
+                }
 
-            auto& measurement = observation.measurements[j];
-            if (measurement.snr > best_snr) {
-                best_id  = static_cast<long>(j);
-                best_snr = measurement.snr;
+                if (measurement.snr > best_snr) {
+                    best_id  = static_cast<long>(kept);
+                    best_snr = measurement.snr;
+                }
             }
+
+            if (kept != j) observation.measurements[kept] = measurement;
+            kept++;
         }
+        observation.measurements.resize(kept);
 
         if (best_id < 0) {
-            mObservationMask[i] = false;
-            WARNF("no measurement selected: %03ld %s", observation.satellite_id.absolute_id(),
-                  observation.satellite_id.name());
+            observation.active = false;
+            WARNF("no measurement selected: %03ld %s", sid, observation.satellite_id.name());
             continue;
         }
 
@@ -212,34 +257,31 @@ void SppEngine::select_best_observations(ts::Tai const& time) {
 
         // TODO: find secondary observation with highest SNR for ionospheric 1-order estimation
 
-        DEBUGF("  %03ld %s: %04ld", observation.satellite_id.absolute_id(),
-               observation.satellite_id.name(), observation.selected0);
+        DEBUGF("  %03ld %s: %04ld", sid, observation.satellite_id.name(),
+               observation.measurements[static_cast<size_t>(best_id)].signal_id.absolute_id());
     }
+
+    remove_untracked_observations();
 }
 
 void SppEngine::compute_satellite_states(ts::Tai const& time) {
     FUNCTION_SCOPE();
 
     DEBUGF("computing satellite states");
-    for (size_t i = 0; i < mObservations.size(); ++i) {
-        if (!mObservationMask[i]) continue;
-
-        auto& observation = mObservations[i];
-        if (observation.measurement_count == 0) continue;
+    for (auto& observation : mObservations) {
+        if (!observation.active) continue;
         if (observation.selected0 < 0) continue;
 
         auto& measurement = observation.measurements[static_cast<size_t>(observation.selected0)];
 
         // Clear group delay
-        for (auto& group_delay : observation.group_delay) {
-            group_delay = 0.0;
-        }
+        observation.group_delay = 0.0;
 
         // TODO(ewasjon): The ephemeris we should use here is the one that corresponds to when the
         // satellite transmitted the signal. It might (very unlikely) not be the one that
         // corresponds to the epoch time. Maybe the error is neglible?
         if (!mEphemerisEngine.find(observation.satellite_id, time, observation.ephemeris)) {
-            mObservationMask[i] = false;
+            observation.active = false;
             WARNF("reject: %03ld %s: no ephemeris", observation.satellite_id.absolute_id(),
                   observation.satellite_id.name());
             continue;
@@ -264,7 +306,7 @@ void SppEngine::compute_satellite_states(ts::Tai const& time) {
         if (!satellite_position(observation.satellite_id, time, measurement.pseudo_range,
                                 observation.ephemeris, mConfiguration.relativistic_model,
                                 orbit_correction, result)) {
-            mObservationMask[i] = false;
+            observation.active = false;
             WARNF("reject: %03ld %s: no position and velocity",
                   observation.satellite_id.absolute_id(), observation.satellite_id.name());
             continue;
@@ -274,7 +316,7 @@ void SppEngine::compute_satellite_states(ts::Tai const& time) {
         observation.eph_position   = result.eph_position;
         observation.eph_velocity   = result.eph_velocity;
         observation.eph_clock_bias = result.eph_clock_bias;
-        observation.group_delay[0] = result.group_delay;
+        observation.group_delay    = result.group_delay;
 
         observation.true_position   = result.true_position;
         observation.true_velocity   = result.true_velocity;
@@ -321,7 +363,7 @@ Solution SppEngine::evaluate(ts::Tai time) NOEXCEPT {
     compute_satellite_states(time);
 
     // We can only solve if we have enough satellites
-    auto satellite_count = mObservationMask.count();
+    auto satellite_count = active_observation_count();
     if (satellite_count < 4) {
         WARNF("not enough satellites: %d < 4", satellite_count);
         return Solution{};
@@ -358,9 +400,7 @@ Solution SppEngine::evaluate(ts::Tai time) NOEXCEPT {
     DEBUGF("initial guess: %14.3f %14.3f %14.3f %14.3f", current(0), current(1), current(2),
            current(3));
 
-    MatrixX residuals{satellite_count, 1};
-    MatrixX design_matrix{satellite_count, 4};
-
+    NormalEquations<4> normal_equations;
     for (size_t it = 0; it < 10; ++it) {
         DEBUGF("iteration %d: %14.3f %14.3f %14.3f %14.3f", it, current(0), current(1), current(2),
                current(3));
@@ -375,12 +415,9 @@ Solution SppEngine::evaluate(ts::Tai time) NOEXCEPT {
 
         auto cps = mCorrectionCache.correction_point_set(ground_llh);
 
-        long j = 0;
-        for (size_t i = 0; i < mObservationMask.size(); ++i) {
-            if (!mObservationMask[i]) continue;
-
-            auto& observation = mObservations[i];
-            if (observation.measurement_count == 0) continue;
+        normal_equations.reset();
+        for (auto& observation : mObservations) {
+            if (!observation.active) continue;
             if (observation.selected0 < 0) continue;
 
             auto geometric_range = geometric_distance(observation.true_position, ground_position);
@@ -496,28 +533,23 @@ Solution SppEngine::evaluate(ts::Tai time) NOEXCEPT {
                    satellite.id.lpp_id().value + 1, satellite.azimuth * constant::K_R2D,
                    satellite.elevation * constant::K_R2D, residual, 0.0);
 #endif
-            design_matrix(j, 0) = -line_of_sight.x();
-            design_matrix(j, 1) = -line_of_sight.y();
-            design_matrix(j, 2) = -line_of_sight.z();
-            design_matrix(j, 3) = 1.0;
-
-            residuals(j, 0) = residual;
-
-            j++;
+            Scalar design_row[4] = {
+                -line_of_sight.x(),
+                -line_of_sight.y(),
+                -line_of_sight.z(),
+                1.0,
+            };
+            normal_equations.add(design_row, residual);
         }
 
-        auto h_subset = design_matrix.topRows(j).eval();
-        auto r_subset = residuals.topRows(j).eval();
-
-        DEBUGF("H:\n%s", epf(h_subset).c_str());
-        DEBUGF("R:\n%s", epf(r_subset).c_str());
-
-        auto h_transpose = h_subset.transpose();
-
         // Compute the solution
-        auto dTd      = h_transpose * h_subset;
-        auto dTr      = h_transpose * r_subset;
-        auto solution = dTd.ldlt().solve(dTr).eval();
+        Scalar delta[4];
+        if (!normal_equations.solve(delta)) {
+            WARNF("no solution: %zu usable satellites", normal_equations.count());
+            return Solution{};
+        }
+
+        Vector4 solution{delta[0], delta[1], delta[2], delta[3]};
         DEBUGF("solution: %+14.3f %+14.3f %+14.3f %+14.3f (norm %14.8f)", solution(0), solution(1),
                solution(2), solution(3), solution.norm());
         current += solution;
@@ -589,12 +621,124 @@ Solution SppEngine::evaluate(ts::Tai time) NOEXCEPT {
     return solution;
 }
 
+// The indentation of scoped (verbose and trace) logging is global and not thread-safe. The
+// evaluation reaches into many modules (idokeido, ephemeris, coordinates), so check all of them.
+static bool scoped_logging_enabled() {
+    bool enabled = false;
+    loglet::iterate_modules(
+        [](loglet::LogModule const* module, int, void* data) {
+            if (loglet::is_module_level_enabled(module, loglet::Level::Verbose)) {
+                *static_cast<bool*>(data) = true;
+            }
+        },
+        &enabled);
+    return enabled;
+}
+
+void SppEngine::evaluate_batch(std::vector<RawMeasurement> const&          measurements,
+                               size_t                                      threads,
+                               std::function<void(Solution const&)> const& callback) NOEXCEPT {
+    FUNCTION_SCOPEF("%zu measurements, %zu threads", measurements.size(), threads);
+
+    std::vector<size_t> order(measurements.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return measurements[a].time < measurements[b].time;
+    });
+
+    // [begin, end) of each epoch in `order`
+    std::vector<std::pair<size_t, size_t>> epochs;
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto& time = measurements[order[i]].time;
+        if (epochs.empty() ||
+            time.difference_seconds(measurements[order[epochs.back().first]].time) >
+                mConfiguration.observation_window * 0.5) {
+            epochs.emplace_back(i, i);
+        }
+        epochs.back().second = i + 1;
+    }
+    DEBUGF("batch: %zu measurements in %zu epochs", measurements.size(), epochs.size());
+    if (epochs.empty()) return;
+
+    auto evaluate_epoch = [&](SppEngine& engine, size_t epoch) {
+        engine.reset_observations();
+        for (auto i = epochs[epoch].first; i < epochs[epoch].second; ++i) {
+            engine.add_measurement(measurements[order[i]]);
+        }
+        return engine.evaluate();
+    };
+
+    auto make_engine = [&]() {
+        std::unique_ptr<SppEngine> engine{
+            new SppEngine(mConfiguration, mEphemerisEngine, mCorrectionCache)};
+        if (mKlobucharModelSet) engine->klobuchar_model(mKlobucharModel);
+        return engine;
+    };
+
+    if (threads > epochs.size()) threads = epochs.size();
+    if (threads > 1 && scoped_logging_enabled()) {
+        DEBUGF("batch: verbose logging is enabled, evaluating on the calling thread");
+        threads = 1;
+    }
+    if (threads <= 1) {
+        auto engine = make_engine();
+        for (size_t epoch = 0; epoch < epochs.size(); ++epoch) {
+            callback(evaluate_epoch(*engine, epoch));
+        }
+        return;
+    }
+
+    // Workers take the next epoch when they are done with one, the calling thread delivers the
+    // solutions in order as soon as the next one is complete
+    std::vector<Solution>   solutions(epochs.size());
+    std::vector<char>       completed(epochs.size(), 0);
+    std::atomic<size_t>     next_epoch{0};
+    std::mutex              mutex;
+    std::condition_variable condition;
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            auto engine = make_engine();
+            for (;;) {
+                auto epoch = next_epoch.fetch_add(1);
+                if (epoch >= epochs.size()) break;
+
+                auto solution = evaluate_epoch(*engine, epoch);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    solutions[epoch] = solution;
+                    completed[epoch] = 1;
+                }
+                condition.notify_all();
+            }
+        });
+    }
+
+    for (size_t epoch = 0; epoch < epochs.size(); ++epoch) {
+        Solution solution;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() {
+                return completed[epoch] != 0;
+            });
+            solution = solutions[epoch];
+        }
+        callback(solution);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
 void SppEngine::datatrace_report() NOEXCEPT {
     VSCOPE_FUNCTION();
 #ifdef DATA_TRACING
-    for (size_t i = 0; i < mObservationMask.size(); ++i) {
-        if (!mObservationMask[i]) continue;
-        auto&                satellite = mObservations[i];
+    for (auto const& satellite : mObservations) {
+        if (!satellite.active) continue;
         datatrace::Satellite dt_sat{};
         dt_sat.position  = Float3{satellite.true_position.x(), satellite.true_position.y(),
                                  satellite.true_position.z()};
@@ -2,7 +2,8 @@
 
 #include <cinttypes>
 #include <cstdio>
-#include "crc_24q.hpp"
+
+#include <format/checksum/checksum.hpp>
 
 namespace generator {
 namespace rtcm {
@@ -77,7 +78,7 @@ void Encoder::copy(uint8_t const* buffer, size_t size) {
 }
 
 void Encoder::checksum() {
-    auto crc = crc24q_hash(mBuffer.data(), mBuffer.size());
+    auto crc = format::checksum::crc24q(mBuffer.data(), mBuffer.size());
     u32(24, crc);
 }
 
@@ -9,6 +9,15 @@ EXTERNAL_WARNINGS_POP
 namespace generator {
 namespace spartn {
 
+void CorrectionData::clear() {
+    ocb_data.clear();
+    hpac_data.clear();
+    real_time_integrity_data.clear();
+    stec_dnu_satellites.clear();
+    troposphere_dnu = -1;
+    ionosphere_dnu  = -1;
+}
+
 uint8_t subtype_from_gnss_id(long gnss_id) {
     if (gnss_id == GNSS_ID__gnss_id_gps) return 0;
     if (gnss_id == GNSS_ID__gnss_id_glonass) return 1;
@@ -141,11 +141,15 @@ struct OcbCorrections {
 
     // Generate a set of satellite ids for this correction
     // this is the union of all satellite ids that have at least
-    // one correction type.
-    NODISCARD std::vector<OcbSatellite> satellites() const;
+    // one correction type. The set is generated once and kept
+    // until a correction is added.
+    NODISCARD std::vector<OcbSatellite> const& satellites() const;
 
     // Check if there is _any_ correction for the given satellite.
     NODISCARD bool has_satellite(long id) const;
+
+    mutable std::vector<OcbSatellite> satellite_list;
+    mutable bool                      satellite_list_valid;
 };
 
 struct OcbData {
@@ -177,11 +181,15 @@ struct HpacCorrections {
 
     // Generate a set of satellite ids for this correction
     // this is the union of all satellite ids that have at least
-    // one correction type.
-    NODISCARD std::vector<HpacSatellite> satellites() const;
+    // one correction type. The set is generated once and kept
+    // until a correction is added.
+    NODISCARD std::vector<HpacSatellite> const& satellites() const;
 
     // Find GridElement_r16 for the given grid_id
     NODISCARD GridElement_r16* find_grid_point(long grid_id) const;
+
+    mutable std::vector<HpacSatellite> satellite_list;
+    mutable bool                       satellite_list_valid;
 };
 
 struct HpacData {
@@ -222,6 +230,9 @@ struct CorrectionData {
     CorrectionData(bool group_by_epoch_time_param)
         : group_by_epoch_time(group_by_epoch_time_param) {}
 
+    // Remove the corrections of the previous generation, the allocated buckets are kept
+    void clear();
+
     std::vector<uint16_t> iods() const;
     std::vector<uint16_t> set_ids() const;
 
@@ -259,6 +270,28 @@ struct CorrectionData {
 
 uint8_t subtype_from_gnss_id(long gnss_id);
 
+// Find the satellite with the given id or add it. Satellite ids are 0-63, `index` maps them to
+// their position in `satellites` and must be initialized to -1.
+template <typename S>
+inline S& find_or_add_satellite(std::vector<S>& satellites, int8_t (&index)[64], long id) {
+    if (id >= 0 && id < 64) {
+        auto& position = index[id];
+        if (position < 0) {
+            position = static_cast<int8_t>(satellites.size());
+            satellites.emplace_back();
+            satellites.back().id = id;
+        }
+        return satellites[static_cast<size_t>(position)];
+    }
+
+    for (auto& satellite : satellites) {
+        if (satellite.id == id) return satellite;
+    }
+    satellites.emplace_back();
+    satellites.back().id = id;
+    return satellites.back();
+}
+
 }  // namespace spartn
 }  // namespace generator
 
@@ -2,6 +2,7 @@
 #include "decode.hpp"
 #include "generator.hpp"
 #include "message.hpp"
+#include "state.hpp"
 
 #include <loglet/loglet.hpp>
 
@@ -23,6 +24,16 @@ void Generator::generate_gad(uint16_t iod, uint32_t epoch_time, uint16_t set_id)
     }
     mLastGadTimeTag = epoch_time;
 
+    auto siou = iod;
+    if (mIncreasingSiou) {
+        siou = mSiouIndex;
+    }
+
+    // The correction point set never changes, only the SIOU does
+    auto key     = CorrectionState::gad_key(set_id);
+    auto context = EncodingContext{siou, 0};
+    if (push_cached(key, context, 2 /* GAD */, 0, epoch_time)) return;
+
     VERBOSEF("  grid points: %ld", correction_point_set.grid_point_count);
 
     char buffer[256];
@@ -71,11 +82,6 @@ void Generator::generate_gad(uint16_t iod, uint32_t epoch_time, uint16_t set_id)
         VERBOSEF("%s", buffer);
     }
 
-    auto siou = iod;
-    if (mIncreasingSiou) {
-        siou = mSiouIndex;
-    }
-
     MessageBuilder builder{2 /* GAD */, 0, epoch_time};
     builder.sf005(siou);  // TODO(ewasjon): We could include AIOU in the correction point set, to
                           // handle overflow
@@ -108,9 +114,7 @@ void Generator::generate_gad(uint16_t iod, uint32_t epoch_time, uint16_t set_id)
         builder.sf037(delta_lng);
     }
 
-    auto message = builder.build();
-    mStatistics.message_counts[(message.message_type() << 8) | message.message_subtype()]++;
-    mMessages.push_back(std::move(message));
+    push_encoded(key, context, builder.build());
 }
 
 }  // namespace spartn
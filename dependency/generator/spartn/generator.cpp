@@ -4,7 +4,9 @@
 #include "data.hpp"
 #include "decode.hpp"
 #include "message.hpp"
+#include "state.hpp"
 #include "time.hpp"
+#include "worker_pool.hpp"
 
 #include <time/bdt.hpp>
 #include <time/glo.hpp>
@@ -46,8 +48,8 @@ namespace generator {
 namespace spartn {
 
 Generator::Generator()
-    : mGenerationIndex(0), mNextAreaId(1), mUraOverride(-1),
-      mUraDefault(0 /* SF024(0) = unknown */), mContinuityIndicator(-1),
+    : mGenerationIndex(0), mNextAreaId(1), mCorrectionState(new CorrectionState()),
+      mUraOverride(-1), mUraDefault(0 /* SF024(0) = unknown */), mContinuityIndicator(-1),
       mUBloxClockCorrection(false), mSf055Override(-1), mSf055Default(0 /* SF055(0) = invalid */),
       mSf042Override(-1), mSf042Default(0 /* SF042(0) = invalid */),
       mComputeAverageZenithDelay(false), mGroupByEpochTime(true), mIncreasingSiou(false),
@@ -58,8 +60,8 @@ Generator::Generator()
       mStecInvalidToZero(false), mSignFlipC00(false), mSignFlipC01(false), mSignFlipC10(false),
       mSignFlipC11(false), mSignFlipStecResiduals(false), mFlipOrbitCorrection(false),
       mDoNotUseSatellite(true), mDoNotUseAtmosphere(true), mEpochLogEnabled(false),
-      mIonoQualityThreshold(-1.0), mGenerateGad(true), mGenerateOcb(true), mGenerateHpac(true),
-      mGpsSupported(true), mGlonassSupported(true), mGalileoSupported(true),
+      mIonoQualityThreshold(-1.0), mConfigChanged(false), mGenerateGad(true), mGenerateOcb(true),
+      mGenerateHpac(true), mGpsSupported(true), mGlonassSupported(true), mGalileoSupported(true),
       mBeidouSupported(false), mQzssSupported(false), mNavicSupported(false) {}
 
 Generator::~Generator() = default;
@@ -73,6 +75,7 @@ void Generator::set_bias_map(long gnss_id, generator::spartn::BiasMap const& map
         mGalBiasMap = map;
     else if (gnss_id == GNSS_ID__gnss_id_bds)
         mBdsBiasMap = map;
+    mConfigChanged = true;
 }
 
 int Generator::rinex_suffix_to_index(long gnss_id, char const* suffix) {
@@ -83,43 +86,67 @@ int Generator::rinex_suffix_to_index(long gnss_id, char const* suffix) {
     return -1;
 }
 
-std::vector<Message> Generator::generate(LPP_Message const* lpp_message) {
-    FUNCTION_SCOPE();
-    // Clear previous messages
-    mMessages.clear();
-    if (!lpp_message) return mMessages;
+static ProvideAssistanceData_r9_IEs const* provide_assistance_data(LPP_Message const* message) {
+    if (!message) return nullptr;
 
-    auto body = lpp_message->lpp_MessageBody;
-    if (!body) return mMessages;
-    if (body->present != LPP_MessageBody_PR_c1) return mMessages;
-    if (body->choice.c1.present != LPP_MessageBody__c1_PR_provideAssistanceData) return mMessages;
+    auto body = message->lpp_MessageBody;
+    if (!body) return nullptr;
+    if (body->present != LPP_MessageBody_PR_c1) return nullptr;
+    if (body->choice.c1.present != LPP_MessageBody__c1_PR_provideAssistanceData) return nullptr;
 
     auto& pad = body->choice.c1.choice.provideAssistanceData;
     if (pad.criticalExtensions.present != ProvideAssistanceData__criticalExtensions_PR_c1)
-        return mMessages;
+        return nullptr;
     if (pad.criticalExtensions.choice.c1.present !=
         ProvideAssistanceData__criticalExtensions__c1_PR_provideAssistanceData_r9)
-        return mMessages;
+        return nullptr;
+
+    return &pad.criticalExtensions.choice.c1.choice.provideAssistanceData_r9;
+}
+
+void Generator::set_hpac_threads(size_t threads) {
+    if (threads > 1) {
+        mWorkerPool = std::unique_ptr<WorkerPool>(new WorkerPool(threads - 1));
+    } else {
+        mWorkerPool.reset();
+    }
+}
+
+std::vector<Message> Generator::generate(LPP_Message const* lpp_message) {
+    return generate(&lpp_message, 1);
+}
+
+std::vector<Message> Generator::generate(LPP_Message const* const* lpp_messages, size_t count) {
+    FUNCTION_SCOPE();
+    // Clear previous messages
+    mMessages.clear();
+
+    std::vector<ProvideAssistanceData_r9_IEs const*> messages;
+    for (size_t i = 0; i < count; i++) {
+        auto message = provide_assistance_data(lpp_messages[i]);
+        if (message) messages.push_back(message);
+    }
+    if (messages.empty()) return mMessages;
 
     // Initialze (and clear previous) correction data
-    mCorrectionData = std::unique_ptr<CorrectionData>(new CorrectionData(mGroupByEpochTime));
+    if (mCorrectionData) {
+        mCorrectionData->clear();
+    } else {
+        mCorrectionData = std::unique_ptr<CorrectionData>(new CorrectionData(mGroupByEpochTime));
+    }
 
-    auto message = &pad.criticalExtensions.choice.c1.choice.provideAssistanceData_r9;
-    find_correction_point_set(message);
-    find_ocb_corrections(message);
-    find_hpac_corrections(message);
-    find_rti_corrections(message);
+    // Encodings from before a configuration change cannot be reused
+    if (mConfigChanged) {
+        mCorrectionState->clear();
+        mConfigChanged = false;
+    }
 
-    // Parse tropo/iono integrity service alert from CommonAssistData
-    if (mDoNotUseAtmosphere && message->a_gnss_ProvideAssistanceData &&
-        message->a_gnss_ProvideAssistanceData->gnss_CommonAssistData) {
-        auto& cad = *message->a_gnss_ProvideAssistanceData->gnss_CommonAssistData;
-        if (cad.ext3 && cad.ext3->gnss_Integrity_ServiceAlert_r17) {
-            auto& alert                      = *cad.ext3->gnss_Integrity_ServiceAlert_r17;
-            mCorrectionData->troposphere_dnu = alert.troposphereDoNotUse_r17 ? 1 : 0;
-            mCorrectionData->ionosphere_dnu  = alert.ionosphereDoNotUse_r17 ? 1 : 0;
-            mStatistics.lpp_ie_counts["gnss_Integrity_ServiceAlert_r17"]++;
-        }
+    for (auto message : messages) {
+        find_correction_point_set(message);
+        find_ocb_corrections(message);
+        find_hpac_corrections(message);
+        find_rti_corrections(message);
+        find_service_alert(message);
     }
 
     // Populate epoch log
@@ -140,7 +167,7 @@ std::vector<Message> Generator::generate(LPP_Message const* lpp_message) {
                 if (corr.epoch_time.rounded_seconds > 0 && mEpochLog.epoch_time == 0) {
                     mEpochLog.epoch_time = corr.epoch_time.rounded_seconds;
                 }
-                auto sats = corr.satellites();
+                auto& sats = corr.satellites();
                 for (auto& sat : sats) {
                     mEpochLog.available_satellites[corr.gnss_id].push_back(sat.prn());
                 }
@@ -228,6 +255,52 @@ std::vector<Message> Generator::generate(LPP_Message const* lpp_message) {
     return mMessages;
 }
 
+bool Generator::can_use_satellite(long gnss_id, long satellite_id) const {
+    if (!mDoNotUseSatellite) return true;
+
+    auto rti_data = mCorrectionData->real_time_integrity(gnss_id);
+    if (rti_data && !rti_data->can_use_satellite(satellite_id)) {
+        VERBOSEF("  CAN USE SATELLITE: %ld: %ld:  NO", gnss_id, satellite_id);
+        return false;
+    }
+
+    auto it = mCorrectionData->stec_dnu_satellites.find(gnss_id);
+    if (it != mCorrectionData->stec_dnu_satellites.end() && it->second.count(satellite_id) > 0) {
+        VERBOSEF("  CAN USE SATELLITE: %ld: %ld:  NO [iono quality threshold]", gnss_id,
+                 satellite_id);
+        return false;
+    }
+
+    return true;
+}
+
+// GAD and HPAC messages belong to the correction point set in the low bits of their key
+static void assign_set_id(Message& message, uint32_t key) {
+    if (message.message_type() == 0 /* OCB */) return;
+    message.assign_set_id(static_cast<uint16_t>(key & 0xFFFF));
+}
+
+bool Generator::push_cached(uint32_t key, EncodingContext const& context, uint8_t message_type,
+                            uint8_t message_subtype, uint32_t message_time) {
+    auto payload = mCorrectionState->find(key, context);
+    if (!payload) return false;
+
+    VERBOSEF("  unchanged, reusing %zu bytes", payload->size());
+    mStatistics.message_counts[(message_type << 8) | message_subtype]++;
+    mStatistics.cached_messages++;
+    mMessages.emplace_back(message_type, message_subtype, message_time,
+                           std::vector<uint8_t>(*payload));
+    assign_set_id(mMessages.back(), key);
+    return true;
+}
+
+void Generator::push_encoded(uint32_t key, EncodingContext const& context, Message&& message) {
+    mCorrectionState->store(key, context, message.payload());
+    mStatistics.message_counts[(message.message_type() << 8) | message.message_subtype()]++;
+    assign_set_id(message, key);
+    mMessages.push_back(std::move(message));
+}
+
 void Generator::find_correction_point_set(ProvideAssistanceData_r9_IEs const* message) {
     FUNCTION_SCOPE();
     if (!message->a_gnss_ProvideAssistanceData) return;
@@ -399,5 +472,20 @@ void Generator::find_rti_corrections(ProvideAssistanceData_r9_IEs const* message
     }
 }
 
+void Generator::find_service_alert(ProvideAssistanceData_r9_IEs const* message) {
+    FUNCTION_SCOPE();
+    // Parse tropo/iono integrity service alert from CommonAssistData
+    if (mDoNotUseAtmosphere && message->a_gnss_ProvideAssistanceData &&
+        message->a_gnss_ProvideAssistanceData->gnss_CommonAssistData) {
+        auto& cad = *message->a_gnss_ProvideAssistanceData->gnss_CommonAssistData;
+        if (cad.ext3 && cad.ext3->gnss_Integrity_ServiceAlert_r17) {
+            auto& alert                      = *cad.ext3->gnss_Integrity_ServiceAlert_r17;
+            mCorrectionData->troposphere_dnu = alert.troposphereDoNotUse_r17 ? 1 : 0;
+            mCorrectionData->ionosphere_dnu  = alert.ionosphereDoNotUse_r17 ? 1 : 0;
+            mStatistics.lpp_ie_counts["gnss_Integrity_ServiceAlert_r17"]++;
+        }
+    }
+}
+
 }  // namespace spartn
 }  // namespace generator
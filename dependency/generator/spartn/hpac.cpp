@@ -2,6 +2,8 @@
 #include "decode.hpp"
 #include "generator.hpp"
 #include "message.hpp"
+#include "state.hpp"
+#include "worker_pool.hpp"
 
 #include <external_warnings.hpp>
 
@@ -22,6 +24,7 @@ EXTERNAL_WARNINGS_POP
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include <asn.1/bit_string.hpp>
 #include <loglet/loglet.hpp>
@@ -87,9 +90,15 @@ bool HpacSatellite::has_all_residuals(CorrectionPointSet const& cps) const {
     return true;
 }
 
-std::vector<HpacSatellite> HpacCorrections::satellites() const {
+std::vector<HpacSatellite> const& HpacCorrections::satellites() const {
     FUNCTION_SCOPE();
-    std::unordered_map<long, HpacSatellite> satellites;
+    if (satellite_list_valid) return satellite_list;
+
+    auto& satellites = satellite_list;
+    satellites.clear();
+
+    int8_t index[64];
+    memset(index, -1, sizeof(index));
 
     if (stec) {
         auto& list = stec->stec_SatList_r16.list;
@@ -98,8 +107,7 @@ std::vector<HpacSatellite> HpacCorrections::satellites() const {
             if (!element) continue;
 
             auto  id        = element->svID_r16.satellite_id;
-            auto& satellite = satellites[id];
-            satellite.id    = id;
+            auto& satellite = find_or_add_satellite(satellites, index, id);
             satellite.add_correction(element);
         }
     }
@@ -119,8 +127,7 @@ std::vector<HpacSatellite> HpacCorrections::satellites() const {
                         if (!sat_element) continue;
 
                         auto  id        = sat_element->svID_r16.satellite_id;
-                        auto& satellite = satellites[id];
-                        satellite.id    = id;
+                        auto& satellite = find_or_add_satellite(satellites, index, id);
                         satellite.add_correction(grid_id, sat_element);
                     }
                 }
@@ -130,18 +137,14 @@ std::vector<HpacSatellite> HpacCorrections::satellites() const {
         }
     }
 
-    // Convert to vector
-    std::vector<HpacSatellite> result;
-    for (auto& kv : satellites) {
-        result.push_back(kv.second);
-    }
-
     // Sort by satellite id
-    std::sort(result.begin(), result.end(), [](HpacSatellite const& a, HpacSatellite const& b) {
-        return a.id < b.id;
-    });
+    std::sort(satellites.begin(), satellites.end(),
+              [](HpacSatellite const& a, HpacSatellite const& b) {
+                  return a.id < b.id;
+              });
 
-    return result;
+    satellite_list_valid = true;
+    return satellite_list;
 }
 
 GridElement_r16* HpacCorrections::find_grid_point(long grid_id) const {
@@ -232,6 +235,8 @@ void CorrectionData::add_correction(long gnss_id, GNSS_SSR_GriddedCorrection_r16
     corrections.set_id     = set_id;
     corrections.epoch_time = epoch_time;
     corrections.gridded    = gridded;
+
+    corrections.satellite_list_valid = false;
 }
 
 void CorrectionData::add_correction(long gnss_id, GNSS_SSR_STEC_Correction_r16* stec) {
@@ -250,6 +255,8 @@ void CorrectionData::add_correction(long gnss_id, GNSS_SSR_STEC_Correction_r16*
     corrections.set_id     = set_id;
     corrections.epoch_time = epoch_time;
     corrections.stec       = stec;
+
+    corrections.satellite_list_valid = false;
 }
 
 void CorrectionData::add_correction(long gnss_id, GNSS_RealTimeIntegrity* rti) {
@@ -906,6 +913,23 @@ static void ionosphere_data_block(MessageBuilder& builder, CorrectionPointSet& c
     }
 }
 
+// HPAC message of one GNSS and correction point set. The encoding only reads the job and the
+// generator configuration, so jobs of different sets can be encoded concurrently.
+struct HpacJob {
+    HpacCorrections*         corrections;
+    CorrectionPointSet*      correction_point_set;
+    OcbCorrections*          ocb_corrections;
+    uint32_t                 key;
+    EncodingContext          context;
+    uint8_t                  subtype;
+    uint32_t                 epoch_time;
+    uint16_t                 siou;
+    uint8_t                  troposphere_block_type;
+    uint8_t                  ionosphere_block_type;
+    bool                     cached;
+    std::unique_ptr<Message> message;
+};
+
 void Generator::generate_hpac(uint16_t iod) {
     auto hpac_data = mCorrectionData->hpac(iod);
     if (!hpac_data) return;
@@ -924,11 +948,17 @@ void Generator::generate_hpac(uint16_t iod) {
         messages.push_back(&kvp.second);
     }
 
+    // Group the messages by correction point set (tile), ordered by GNSS within each set
     std::sort(messages.begin(), messages.end(),
               [](HpacCorrections const* a, HpacCorrections const* b) {
+                  if (a->set_id != b->set_id) return a->set_id < b->set_id;
                   return subtype_from_gnss_id(a->gnss_id) < subtype_from_gnss_id(b->gnss_id);
               });
 
+    // Everything that touches the generator state is done here, in order. Only the encoding of
+    // changed messages is left to `encode_hpac`, which may run on the worker pool.
+    std::vector<HpacJob> jobs;
+    jobs.reserve(messages.size());
     for (size_t message_id = 0; message_id < messages.size(); message_id++) {
         auto& corrections = *messages[message_id];
         auto  gnss_id     = corrections.gnss_id;
@@ -1024,46 +1054,102 @@ void Generator::generate_hpac(uint16_t iod) {
             siou = mSiouIndex;
         }
 
-        MessageBuilder builder{1 /* HPAC */, subtype, epoch_time};
-        builder.sf005(siou);
-        builder.sf068(0);  // TODO(ewasjon): [low-priority] We could include AIOU in the
-                           // correction point set, to handle overflow
-        builder.sf069();
-        builder.sf030(1);
-
-        // Atmosphere block
-        {
-            // Area data block
-            {
-                builder.sf031(static_cast<uint8_t>(correction_point_set.area_id));
-                builder.sf039(static_cast<uint8_t>(correction_point_set.grid_point_count));
-                builder.sf040(troposphere_block_type);
-                builder.sf040(ionosphere_block_type);
+        // Besides the HPAC inputs, the payload depends on the SIOU, the block types and the
+        // satellites with OCB corrections (when filtering by OCB)
+        uint64_t ocb_satellites = ~0ULL;
+        if (ocb_corrections) {
+            ocb_satellites = 0;
+            for (auto& satellite : ocb_corrections->satellites()) {
+                if (satellite.id >= 0 && satellite.id < 64) ocb_satellites |= 1ULL << satellite.id;
             }
+        }
 
-            // Troposphere data block
-            if (troposphere_block_type != 0) {
-                // TODO(ewasjon): [low-priority] Expose this as a option
-                auto calculate_sf051 = mComputeAverageZenithDelay;
-                troposphere_data_block(builder, correction_point_set, corrections, mSf042Override,
-                                       mSf042Default, mComputeAverageZenithDelay, calculate_sf051,
-                                       mHydrostaticResidualInZenith);
-            }
+        auto block_types = static_cast<uint64_t>(troposphere_block_type) << 16 |
+                           static_cast<uint64_t>(ionosphere_block_type) << 24;
+        auto key         = CorrectionState::hpac_key(gnss_id, set_id);
+        auto context     = EncodingContext{siou | block_types, ocb_satellites};
+        auto dirty       = mCorrectionState->update(gnss_id, set_id, corrections);
+        VERBOSEF("  dirty=%02X", dirty);
 
-            // Ionosphere data block
-            if (ionosphere_block_type != 0) {
-                ionosphere_data_block(builder, correction_point_set, corrections, gnss_id,
-                                      ocb_corrections, ionosphere_block_type, mSf055Override,
-                                      mSf055Default, mStecMethod, mStecTranform, mFilterByResiduals,
-                                      mStecInvalidToZero, mSignFlipC00, mSignFlipC01, mSignFlipC10,
-                                      mSignFlipC11, mSignFlipStecResiduals);
-            }
+        auto cached = mCorrectionState->find(key, context) != nullptr;
+
+        jobs.push_back(HpacJob{&corrections, &correction_point_set, ocb_corrections, key, context,
+                               subtype, epoch_time, siou, troposphere_block_type,
+                               ionosphere_block_type, cached, nullptr});
+    }
+
+    std::vector<HpacJob*> changed;
+    for (auto& job : jobs) {
+        if (!job.cached) changed.push_back(&job);
+    }
+
+    // Scoped logging is not thread-safe and would interleave the per-message log, so encode on
+    // the calling thread when verbose logging is enabled
+    auto parallel = mWorkerPool && changed.size() > 1 &&
+                    !loglet::is_module_level_enabled(LOGLET_CURRENT_MODULE, loglet::Level::Verbose);
+    if (parallel) {
+        mWorkerPool->run(changed.size(), [&](size_t index) {
+            encode_hpac(*changed[index]);
+        });
+    } else {
+        for (auto job : changed) {
+            encode_hpac(*job);
+        }
+    }
+
+    for (auto& job : jobs) {
+        if (job.cached) {
+            push_cached(job.key, job.context, 1 /* HPAC */, job.subtype, job.epoch_time);
+        } else {
+            push_encoded(job.key, job.context, std::move(*job.message));
+        }
+    }
+}
+
+void Generator::encode_hpac(HpacJob& job) const {
+    auto& correction_point_set   = *job.correction_point_set;
+    auto& corrections            = *job.corrections;
+    auto  troposphere_block_type = job.troposphere_block_type;
+    auto  ionosphere_block_type  = job.ionosphere_block_type;
+
+    MessageBuilder builder{1 /* HPAC */, job.subtype, job.epoch_time};
+    builder.sf005(job.siou);
+    builder.sf068(0);  // TODO(ewasjon): [low-priority] We could include AIOU in the
+                       // correction point set, to handle overflow
+    builder.sf069();
+    builder.sf030(1);
+
+    // Atmosphere block
+    {
+        // Area data block
+        {
+            builder.sf031(static_cast<uint8_t>(correction_point_set.area_id));
+            builder.sf039(static_cast<uint8_t>(correction_point_set.grid_point_count));
+            builder.sf040(troposphere_block_type);
+            builder.sf040(ionosphere_block_type);
         }
 
-        auto message = builder.build();
-        mStatistics.message_counts[(message.message_type() << 8) | message.message_subtype()]++;
-        mMessages.push_back(std::move(message));
+        // Troposphere data block
+        if (troposphere_block_type != 0) {
+            // TODO(ewasjon): [low-priority] Expose this as a option
+            auto calculate_sf051 = mComputeAverageZenithDelay;
+            troposphere_data_block(builder, correction_point_set, corrections, mSf042Override,
+                                   mSf042Default, mComputeAverageZenithDelay, calculate_sf051,
+                                   mHydrostaticResidualInZenith);
+        }
+
+        // Ionosphere data block
+        if (ionosphere_block_type != 0) {
+            ionosphere_data_block(builder, correction_point_set, corrections,
+                                  corrections.gnss_id, job.ocb_corrections, ionosphere_block_type,
+                                  mSf055Override, mSf055Default, mStecMethod, mStecTranform,
+                                  mFilterByResiduals, mStecInvalidToZero, mSignFlipC00,
+                                  mSignFlipC01, mSignFlipC10, mSignFlipC11,
+                                  mSignFlipStecResiduals);
+        }
     }
+
+    job.message = std::unique_ptr<Message>(new Message(builder.build()));
 }
 
 }  // namespace spartn
@@ -30,10 +30,18 @@ public:
     NODISCARD uint8_t message_subtype() const { return mMessageSubtype; }
     /// Message data
     NODISCARD std::vector<uint8_t> const& payload() const { return mPayload; }
+    /// Correction point set (tile) of GAD and HPAC messages, OCB messages are not tied to a set
+    /// and apply to all of them.
+    NODISCARD bool     has_set_id() const { return mHasSetId; }
+    NODISCARD uint16_t set_id() const { return mSetId; }
 
     void set_crc_type(CrcType crc_type) { mCrcType = crc_type; }
     void set_solution_id(uint8_t solution_id) { mSolutionId = solution_id; }
     void set_solution_processor_id(uint8_t id) { mSolutionProcessorId = id; }
+    void assign_set_id(uint16_t set_id) {
+        mHasSetId = true;
+        mSetId    = set_id;
+    }
 
     std::vector<uint8_t> build();
 
@@ -45,10 +53,16 @@ private:
     CrcType              mCrcType{CrcType::CRC16};
     uint8_t              mSolutionId{0};
     uint8_t              mSolutionProcessorId{0};
+    bool                 mHasSetId{false};
+    uint16_t             mSetId{0};
 };
 
 struct CorrectionPointSet;
 struct CorrectionData;
+class CorrectionState;
+struct EncodingContext;
+struct HpacJob;
+class WorkerPool;
 
 enum class StecMethod {
     Default,
@@ -60,11 +74,14 @@ struct Statistics {
     std::unordered_map<uint16_t, size_t>                              message_counts;
     std::unordered_map<std::string, size_t>                           lpp_ie_counts;
     std::unordered_map<std::string, std::unordered_map<long, size_t>> lpp_ie_per_gnss;
+    // Messages whose payload was reused from the previous generation
+    size_t cached_messages{0};
 
     void reset() {
         message_counts.clear();
         lpp_ie_counts.clear();
         lpp_ie_per_gnss.clear();
+        cached_messages = 0;
     }
 };
 
@@ -94,81 +111,202 @@ public:
     /// Destructor.
     ~Generator();
 
-    void set_ura_override(int ura_override) { mUraOverride = ura_override; }
-    void set_ura_default(int ura_default) { mUraDefault = ura_default; }
+    void set_ura_override(int ura_override) {
+        mUraOverride   = ura_override;
+        mConfigChanged = true;
+    }
+    void set_ura_default(int ura_default) {
+        mUraDefault    = ura_default;
+        mConfigChanged = true;
+    }
 
     void set_continuity_indicator(double continuity_indicator) {
         mContinuityIndicator = continuity_indicator;
+        mConfigChanged       = true;
     }
 
     void set_ublox_clock_correction(bool ublox_clock_correction) {
         mUBloxClockCorrection = ublox_clock_correction;
+        mConfigChanged        = true;
     }
 
     void set_compute_average_zenith_delay(bool compute_average_zenith_delay) {
         mComputeAverageZenithDelay = compute_average_zenith_delay;
+        mConfigChanged             = true;
     }
 
-    void set_sf055_override(int sf055_override) { mSf055Override = sf055_override; }
-    void set_sf055_default(int sf055_default) { mSf055Default = sf055_default; }
+    void set_sf055_override(int sf055_override) {
+        mSf055Override = sf055_override;
+        mConfigChanged = true;
+    }
+    void set_sf055_default(int sf055_default) {
+        mSf055Default  = sf055_default;
+        mConfigChanged = true;
+    }
 
-    void set_sf042_override(int sf042_override) { mSf042Override = sf042_override; }
-    void set_sf042_default(int sf042_default) { mSf042Default = sf042_default; }
+    void set_sf042_override(int sf042_override) {
+        mSf042Override = sf042_override;
+        mConfigChanged = true;
+    }
+    void set_sf042_default(int sf042_default) {
+        mSf042Default  = sf042_default;
+        mConfigChanged = true;
+    }
 
-    void set_increasing_siou(bool increasing_siou) { mIncreasingSiou = increasing_siou; }
+    void set_increasing_siou(bool increasing_siou) {
+        mIncreasingSiou = increasing_siou;
+        mConfigChanged  = true;
+    }
     void set_filter_by_residuals(bool filter_by_residuals) {
         mFilterByResiduals = filter_by_residuals;
+        mConfigChanged     = true;
+    }
+    void set_filter_by_ocb(bool filter_by_ocb) {
+        mFilterByOcb   = filter_by_ocb;
+        mConfigChanged = true;
+    }
+    void set_ignore_l2l(bool ignore_l2l) {
+        mIgnoreL2L     = ignore_l2l;
+        mConfigChanged = true;
     }
-    void set_filter_by_ocb(bool filter_by_ocb) { mFilterByOcb = filter_by_ocb; }
-    void set_ignore_l2l(bool ignore_l2l) { mIgnoreL2L = ignore_l2l; }
     void set_stec_invalid_to_zero(bool stec_invalid_to_zero) {
         mStecInvalidToZero = stec_invalid_to_zero;
+        mConfigChanged     = true;
+    }
+    void set_sign_flip_c00(bool sign_flip_c00) {
+        mSignFlipC00   = sign_flip_c00;
+        mConfigChanged = true;
+    }
+    void set_sign_flip_c01(bool sign_flip_c01) {
+        mSignFlipC01   = sign_flip_c01;
+        mConfigChanged = true;
+    }
+    void set_sign_flip_c10(bool sign_flip_c10) {
+        mSignFlipC10   = sign_flip_c10;
+        mConfigChanged = true;
+    }
+    void set_sign_flip_c11(bool sign_flip_c11) {
+        mSignFlipC11   = sign_flip_c11;
+        mConfigChanged = true;
     }
-    void set_sign_flip_c00(bool sign_flip_c00) { mSignFlipC00 = sign_flip_c00; }
-    void set_sign_flip_c01(bool sign_flip_c01) { mSignFlipC01 = sign_flip_c01; }
-    void set_sign_flip_c10(bool sign_flip_c10) { mSignFlipC10 = sign_flip_c10; }
-    void set_sign_flip_c11(bool sign_flip_c11) { mSignFlipC11 = sign_flip_c11; }
     void set_sign_flip_stec_residuals(bool sign_flip_stec_residuals) {
         mSignFlipStecResiduals = sign_flip_stec_residuals;
+        mConfigChanged         = true;
+    }
+
+    void set_generate_ocb(bool generate_ocb) {
+        mGenerateOcb   = generate_ocb;
+        mConfigChanged = true;
+    }
+    void set_generate_hpac(bool generate_hpac) {
+        mGenerateHpac  = generate_hpac;
+        mConfigChanged = true;
+    }
+    void set_generate_gad(bool generate_gad) {
+        mGenerateGad   = generate_gad;
+        mConfigChanged = true;
     }
 
-    void set_generate_ocb(bool generate_ocb) { mGenerateOcb = generate_ocb; }
-    void set_generate_hpac(bool generate_hpac) { mGenerateHpac = generate_hpac; }
-    void set_generate_gad(bool generate_gad) { mGenerateGad = generate_gad; }
-
-    void set_gps_supported(bool gps_supported) { mGpsSupported = gps_supported; }
-    void set_glonass_supported(bool glonass_supported) { mGlonassSupported = glonass_supported; }
-    void set_galileo_supported(bool galileo_supported) { mGalileoSupported = galileo_supported; }
-    void set_beidou_supported(bool beidou_supported) { mBeidouSupported = beidou_supported; }
-    void set_qzss_supported(bool qzss_supported) { mQzssSupported = qzss_supported; }
-    void set_navic_supported(bool navic_supported) { mNavicSupported = navic_supported; }
-
-    void set_code_bias_translate(bool value) { mCodeBiasTranslate = value; }
-    void set_code_bias_correction_shift(bool value) { mCodeBiasCorrectionShift = value; }
-    void set_phase_bias_translate(bool value) { mPhaseBiasTranslate = value; }
-    void set_phase_bias_correction_shift(bool value) { mPhaseBiasCorrectionShift = value; }
-    void set_hydrostatic_in_zenith(bool value) { mHydrostaticResidualInZenith = value; }
-    void set_stec_method(StecMethod method) { mStecMethod = method; }
-    void set_stec_transform(bool value) { mStecTranform = value; }
-    void set_flip_grid_bitmask(bool flip_grid_bitmask) { mFlipGridBitmask = flip_grid_bitmask; }
+    void set_gps_supported(bool gps_supported) {
+        mGpsSupported  = gps_supported;
+        mConfigChanged = true;
+    }
+    void set_glonass_supported(bool glonass_supported) {
+        mGlonassSupported = glonass_supported;
+        mConfigChanged    = true;
+    }
+    void set_galileo_supported(bool galileo_supported) {
+        mGalileoSupported = galileo_supported;
+        mConfigChanged    = true;
+    }
+    void set_beidou_supported(bool beidou_supported) {
+        mBeidouSupported = beidou_supported;
+        mConfigChanged   = true;
+    }
+    void set_qzss_supported(bool qzss_supported) {
+        mQzssSupported = qzss_supported;
+        mConfigChanged = true;
+    }
+    void set_navic_supported(bool navic_supported) {
+        mNavicSupported = navic_supported;
+        mConfigChanged  = true;
+    }
+
+    void set_code_bias_translate(bool value) {
+        mCodeBiasTranslate = value;
+        mConfigChanged     = true;
+    }
+    void set_code_bias_correction_shift(bool value) {
+        mCodeBiasCorrectionShift = value;
+        mConfigChanged           = true;
+    }
+    void set_phase_bias_translate(bool value) {
+        mPhaseBiasTranslate = value;
+        mConfigChanged      = true;
+    }
+    void set_phase_bias_correction_shift(bool value) {
+        mPhaseBiasCorrectionShift = value;
+        mConfigChanged            = true;
+    }
+    void set_hydrostatic_in_zenith(bool value) {
+        mHydrostaticResidualInZenith = value;
+        mConfigChanged               = true;
+    }
+    void set_stec_method(StecMethod method) {
+        mStecMethod    = method;
+        mConfigChanged = true;
+    }
+    void set_stec_transform(bool value) {
+        mStecTranform  = value;
+        mConfigChanged = true;
+    }
+    void set_flip_grid_bitmask(bool flip_grid_bitmask) {
+        mFlipGridBitmask = flip_grid_bitmask;
+        mConfigChanged   = true;
+    }
     void set_flip_orbit_correction(bool flip_orbit_correction) {
         mFlipOrbitCorrection = flip_orbit_correction;
+        mConfigChanged       = true;
+    }
+    void set_do_not_use_satellite(bool value) {
+        mDoNotUseSatellite = value;
+        mConfigChanged     = true;
+    }
+    void set_do_not_use_atmosphere(bool value) {
+        mDoNotUseAtmosphere = value;
+        mConfigChanged      = true;
+    }
+    void set_iono_quality_threshold(double value) {
+        mIonoQualityThreshold = value;
+        mConfigChanged        = true;
     }
-    void set_do_not_use_satellite(bool value) { mDoNotUseSatellite = value; }
-    void set_do_not_use_atmosphere(bool value) { mDoNotUseAtmosphere = value; }
-    void set_iono_quality_threshold(double value) { mIonoQualityThreshold = value; }
-    void enable_epoch_log(bool value) { mEpochLogEnabled = value; }
+    void enable_epoch_log(bool value) {
+        mEpochLogEnabled = value;
+        mConfigChanged   = true;
+    }
+
+    /// Encode the HPAC messages of different correction point sets (tiles) in parallel on
+    /// `threads` threads, including the calling thread. 0 or 1 encodes on the calling thread, as
+    /// does verbose logging of the HPAC module.
+    void set_hpac_threads(size_t threads);
 
     void set_bias_map(long gnss_id, generator::spartn::BiasMap const& map);
 
     // Returns the RINEX signal index for the given GNSS and suffix (e.g. "5X"), or -1 if unknown.
     static int rinex_suffix_to_index(long gnss_id, char const* suffix);
 
-    /// Generate SPARTN messages based on LPP SSR messages.
+    /// Generate SPARTN messages based on LPP SSR messages. Messages whose LPP inputs are unchanged
+    /// since the previous call reuse the previously encoded payload.
     /// @param[in] lpp_message The LPP SSR message.
     /// @return The generated SPARTN messages.
     std::vector<Message> generate(LPP_Message const* lpp_message);
 
+    /// Generate SPARTN messages for a batch of LPP SSR messages, e.g. one epoch of a feed that
+    /// carries many correction point sets (tiles) in separate messages. The OCB corrections are
+    /// encoded once for the batch and GAD/HPAC messages are tagged with their set, see
+    /// `Message::set_id`. The LPP messages must stay valid until the call returns.
+    std::vector<Message> generate(LPP_Message const* const* lpp_messages, size_t count);
+
     NODISCARD Statistics const& statistics() const { return mStatistics; }
     NODISCARD EpochLog const&   epoch_log() const { return mEpochLog; }
     void                        reset_statistics() { mStatistics.reset(); }
@@ -178,10 +316,18 @@ private:
     void find_ocb_corrections(ProvideAssistanceData_r9_IEs const* message);
     void find_hpac_corrections(ProvideAssistanceData_r9_IEs const* message);
     void find_rti_corrections(ProvideAssistanceData_r9_IEs const* message);
+    void find_service_alert(ProvideAssistanceData_r9_IEs const* message);
 
     void generate_gad(uint16_t iod, uint32_t epoch_time, uint16_t set_id);
     void generate_ocb(uint16_t iod);
     void generate_hpac(uint16_t iod);
+    void encode_hpac(HpacJob& job) const;
+
+    NODISCARD bool can_use_satellite(long gnss_id, long satellite_id) const;
+    // Push the cached payload of an unchanged message, returns false if it must be encoded
+    bool push_cached(uint32_t key, EncodingContext const& context, uint8_t message_type,
+                     uint8_t message_subtype, uint32_t message_time);
+    void push_encoded(uint32_t key, EncodingContext const& context, Message&& message);
 
     uint16_t next_area_id() {
         auto id     = mNextAreaId;
@@ -194,7 +340,9 @@ private:
 
     std::unordered_map<uint16_t, std::unique_ptr<CorrectionPointSet>> mCorrectionPointSets;
     std::unique_ptr<CorrectionData>                                   mCorrectionData;
+    std::unique_ptr<CorrectionState>                                  mCorrectionState;
     std::vector<Message>                                              mMessages;
+    std::unique_ptr<WorkerPool>                                       mWorkerPool;
 
     int    mUraOverride;  // <0 = no override
     int    mUraDefault;
@@ -237,6 +385,8 @@ private:
     bool   mEpochLogEnabled;
     double mIonoQualityThreshold;  // <0 = disabled
 
+    bool mConfigChanged;  // the cached encodings were made with another configuration
+
     bool mGenerateGad;
     bool mGenerateOcb;
     bool mGenerateHpac;
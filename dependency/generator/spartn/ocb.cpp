@@ -4,6 +4,7 @@
 #include "decode.hpp"
 #include "generator.hpp"
 #include "message.hpp"
+#include "state.hpp"
 #include "time.hpp"
 
 #include <external_warnings.hpp>
@@ -32,6 +33,7 @@ EXTERNAL_WARNINGS_POP
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 
 #include <loglet/loglet.hpp>
 
@@ -72,8 +74,14 @@ void OcbSatellite::add_correction(SSR_URA_SatElement_r16* new_ura) {
     ura = new_ura;
 }
 
-std::vector<OcbSatellite> OcbCorrections::satellites() const {
-    std::unordered_map<long, OcbSatellite> satellites;
+std::vector<OcbSatellite> const& OcbCorrections::satellites() const {
+    if (satellite_list_valid) return satellite_list;
+
+    auto& satellites = satellite_list;
+    satellites.clear();
+
+    int8_t index[64];
+    memset(index, -1, sizeof(index));
 
     // Orbit
     if (orbit) {
@@ -83,8 +91,7 @@ std::vector<OcbSatellite> OcbCorrections::satellites() const {
             if (!element) continue;
 
             auto  satellite_id = element->svID_r15.satellite_id;
-            auto& satellite    = satellites[satellite_id];
-            satellite.id       = satellite_id;
+            auto& satellite    = find_or_add_satellite(satellites, index, satellite_id);
             satellite.iod      = iod;
             satellite.add_correction(element);
         }
@@ -98,8 +105,7 @@ std::vector<OcbSatellite> OcbCorrections::satellites() const {
             if (!element) continue;
 
             auto  satellite_id = element->svID_r15.satellite_id;
-            auto& satellite    = satellites[satellite_id];
-            satellite.id       = satellite_id;
+            auto& satellite    = find_or_add_satellite(satellites, index, satellite_id);
             satellite.iod      = iod;
             satellite.add_correction(element);
         }
@@ -113,8 +119,7 @@ std::vector<OcbSatellite> OcbCorrections::satellites() const {
             if (!element) continue;
 
             auto  satellite_id = element->svID_r15.satellite_id;
-            auto& satellite    = satellites[satellite_id];
-            satellite.id       = satellite_id;
+            auto& satellite    = find_or_add_satellite(satellites, index, satellite_id);
             satellite.iod      = iod;
             satellite.add_correction(element);
         }
@@ -128,8 +133,7 @@ std::vector<OcbSatellite> OcbCorrections::satellites() const {
             if (!element) continue;
 
             auto  satellite_id = element->svID_r16.satellite_id;
-            auto& satellite    = satellites[satellite_id];
-            satellite.id       = satellite_id;
+            auto& satellite    = find_or_add_satellite(satellites, index, satellite_id);
             satellite.iod      = iod;
             satellite.add_correction(element);
         }
@@ -143,25 +147,20 @@ std::vector<OcbSatellite> OcbCorrections::satellites() const {
             if (!element) continue;
 
             auto  satellite_id = element->svID_r16.satellite_id;
-            auto& satellite    = satellites[satellite_id];
-            satellite.id       = satellite_id;
+            auto& satellite    = find_or_add_satellite(satellites, index, satellite_id);
             satellite.iod      = iod;
             satellite.add_correction(element);
         }
     }
 
-    // Convert to vector
-    std::vector<OcbSatellite> result;
-    for (auto& kv : satellites) {
-        result.push_back(kv.second);
-    }
-
     // Sort by satellite id
-    std::sort(result.begin(), result.end(), [](OcbSatellite const& a, OcbSatellite const& b) {
-        return a.id < b.id;
-    });
+    std::sort(satellites.begin(), satellites.end(),
+              [](OcbSatellite const& a, OcbSatellite const& b) {
+                  return a.id < b.id;
+              });
 
-    return result;
+    satellite_list_valid = true;
+    return satellite_list;
 }
 
 bool OcbCorrections::has_satellite(long id) const {
@@ -227,6 +226,8 @@ void CorrectionData::add_correction(long gnss_id, GNSS_SSR_OrbitCorrections_r15*
     corrections.iod        = iod;
     corrections.epoch_time = epoch_time;
     corrections.orbit      = orbit;
+
+    corrections.satellite_list_valid = false;
     corrections.orbit_update_interval =
         decode::ssr_update_interval_r15(orbit->ssrUpdateInterval_r15);
 }
@@ -244,6 +245,8 @@ void CorrectionData::add_correction(long gnss_id, GNSS_SSR_ClockCorrections_r15*
     corrections.iod        = iod;
     corrections.epoch_time = epoch_time;
     corrections.clock      = clock;
+
+    corrections.satellite_list_valid = false;
     corrections.clock_update_interval =
         decode::ssr_update_interval_r15(clock->ssrUpdateInterval_r15);
 }
@@ -261,6 +264,8 @@ void CorrectionData::add_correction(long gnss_id, GNSS_SSR_CodeBias_r15* code_bi
     corrections.iod        = iod;
     corrections.epoch_time = epoch_time;
     corrections.code_bias  = code_bias;
+
+    corrections.satellite_list_valid = false;
 }
 
 void CorrectionData::add_correction(long gnss_id, GNSS_SSR_PhaseBias_r16* phase_bias) {
@@ -276,6 +281,8 @@ void CorrectionData::add_correction(long gnss_id, GNSS_SSR_PhaseBias_r16* phase_
     corrections.iod        = iod;
     corrections.epoch_time = epoch_time;
     corrections.phase_bias = phase_bias;
+
+    corrections.satellite_list_valid = false;
 }
 
 void CorrectionData::add_correction(long gnss_id, GNSS_SSR_URA_r16* ura) {
@@ -296,6 +303,8 @@ void CorrectionData::add_correction(long gnss_id, GNSS_SSR_URA_r16* ura) {
         corrections.epoch_time = epoch_time;
     }
     corrections.ura = ura;
+
+    corrections.satellite_list_valid = false;
 }
 
 static bool phase_bias_fix_flag(SSR_PhaseBiasSignalElement_r16 const& signal) {
@@ -566,9 +575,8 @@ void Generator::generate_ocb(uint16_t iod) {
         auto& corrections = *messages[message_id];
         auto  gnss_id     = corrections.gnss_id;
         auto  epoch_time  = spartn_time_for_gnss(corrections.epoch_time, gnss_id);
-        auto  rti_data    = mCorrectionData->real_time_integrity(gnss_id);
 
-        auto satellites = corrections.satellites();
+        auto& satellites = corrections.satellites();
 
         if (epoch_time == 0) {
             WARNF("OCB has epoch_time=0 for GNSS=%ld, skipping", gnss_id);
@@ -577,13 +585,6 @@ void Generator::generate_ocb(uint16_t iod) {
 
         mLastOcbTimeTagPerGnss[gnss_id] = epoch_time;
 
-        VERBOSEF("OCB: time=%u, gnss=%ld, iod=%hu", epoch_time, gnss_id, iod);
-        for (auto& satellite : satellites) {
-            VERBOSEF("  satellite: %4ld %s%s%s%s%s", satellite.id, satellite.orbit ? "O" : "-",
-                     satellite.clock ? "C" : "-", satellite.code_bias ? "B" : "-",
-                     satellite.phase_bias ? "P" : "-", satellite.ura ? "U" : "-");
-        }
-
         auto eos               = ((message_id + 1) == messages.size());
         auto yaw_angle_present = false;
         auto subtype           = subtype_from_gnss_id(gnss_id);
@@ -593,6 +594,26 @@ void Generator::generate_ocb(uint16_t iod) {
             siou = mSiouIndex;
         }
 
+        // Besides the OCB inputs, the payload depends on the SIOU, the end of set flag and the
+        // satellites that must not be used (from other IEs)
+        uint64_t dnu_satellites = 0;
+        for (auto& satellite : satellites) {
+            if (satellite.id < 0 || satellite.id >= 64) continue;
+            if (!can_use_satellite(gnss_id, satellite.id)) dnu_satellites |= 1ULL << satellite.id;
+        }
+
+        auto key     = CorrectionState::ocb_key(gnss_id);
+        auto context = EncodingContext{siou | (eos ? 1ULL << 16 : 0), dnu_satellites};
+        auto dirty   = mCorrectionState->update(gnss_id, corrections);
+        VERBOSEF("OCB: time=%u, gnss=%ld, iod=%hu, dirty=%02X", epoch_time, gnss_id, iod, dirty);
+        if (push_cached(key, context, 0 /* OCB */, subtype, epoch_time)) continue;
+
+        for (auto& satellite : satellites) {
+            VERBOSEF("  satellite: %4ld %s%s%s%s%s", satellite.id, satellite.orbit ? "O" : "-",
+                     satellite.clock ? "C" : "-", satellite.code_bias ? "B" : "-",
+                     satellite.phase_bias ? "P" : "-", satellite.ura ? "U" : "-");
+        }
+
         MessageBuilder builder{0 /* OCB */, subtype, epoch_time};
         builder.sf005(siou);
         builder.sf010(eos);
@@ -605,23 +626,9 @@ void Generator::generate_ocb(uint16_t iod) {
         for (auto& satellite : satellites) {
             VERBOSEF("  SATELLITE: %4ld", satellite.id);
 
-            auto do_use_satellite = true;
-            if (rti_data && mDoNotUseSatellite) {
-                do_use_satellite = rti_data->can_use_satellite(satellite.id);
-                VERBOSEF("  CAN USE SATELLITE: %ld: %ld: %s %u", gnss_id, satellite.id,
-                         do_use_satellite ? "YES" : " NO", do_use_satellite);
-            }
-            if (do_use_satellite && mDoNotUseSatellite) {
-                auto it = mCorrectionData->stec_dnu_satellites.find(gnss_id);
-                if (it != mCorrectionData->stec_dnu_satellites.end()) {
-                    if (it->second.count(satellite.id) > 0) {
-                        do_use_satellite = false;
-                        VERBOSEF("  CAN USE SATELLITE: %ld: %ld:  NO [iono quality threshold]",
-                                 gnss_id, satellite.id);
-                    }
-                }
-            }
-
+            auto do_use_satellite = satellite.id < 0 || satellite.id >= 64 ?
+                                        can_use_satellite(gnss_id, satellite.id) :
+                                        (dnu_satellites & (1ULL << satellite.id)) == 0;
             builder.sf013(!do_use_satellite);
             builder.sf014(satellite.orbit != nullptr, satellite.clock != nullptr,
                           satellite.code_bias != nullptr || satellite.phase_bias != nullptr);
@@ -749,9 +756,7 @@ void Generator::generate_ocb(uint16_t iod) {
             }
         }
 
-        auto message = builder.build();
-        mStatistics.message_counts[(message.message_type() << 8) | message.message_subtype()]++;
-        mMessages.push_back(std::move(message));
+        push_encoded(key, context, builder.build());
     }
 }
 
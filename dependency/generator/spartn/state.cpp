@@ -0,0 +1,155 @@
+#include "state.hpp"
+#include "data.hpp"
+
+#include <external_warnings.hpp>
+
+EXTERNAL_WARNINGS_PUSH
+#include <BIT_STRING.h>
+#include <GNSS-SSR-ClockCorrections-r15.h>
+#include <GNSS-SSR-CodeBias-r15.h>
+#include <GNSS-SSR-GriddedCorrection-r16.h>
+#include <GNSS-SSR-OrbitCorrections-r15.h>
+#include <GNSS-SSR-PhaseBias-r16.h>
+#include <GNSS-SSR-STEC-Correction-r16.h>
+#include <GNSS-SSR-URA-r16.h>
+EXTERNAL_WARNINGS_POP
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(spartn, state);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(spartn, state)
+
+namespace generator {
+namespace spartn {
+
+AsnSnapshot::~AsnSnapshot() NOEXCEPT {
+    clear();
+}
+
+void AsnSnapshot::clear() NOEXCEPT {
+    if (mValue) {
+        ASN_STRUCT_FREE(*mDescriptor, mValue);
+        mValue = nullptr;
+    }
+}
+
+bool AsnSnapshot::update(asn_TYPE_descriptor_s const* descriptor, void const* value) NOEXCEPT {
+    if (!value && !mValue) return false;
+    if (value && mValue && mDescriptor == descriptor &&
+        descriptor->op->compare_struct(descriptor, mValue, value) == 0) {
+        return false;
+    }
+
+    clear();
+    mDescriptor = descriptor;
+    if (value && descriptor->op->copy_struct(descriptor, &mValue, value) != 0) {
+        // Without a copy the next update is always treated as changed
+        WARNF("failed to copy %s", descriptor->name);
+        clear();
+    }
+    return true;
+}
+
+CorrectionState::CorrectionState() NOEXCEPT = default;
+CorrectionState::~CorrectionState() NOEXCEPT = default;
+
+uint32_t CorrectionState::ocb_key(long gnss_id) NOEXCEPT {
+    return (0u << 24) | (static_cast<uint32_t>(subtype_from_gnss_id(gnss_id)) << 16);
+}
+
+uint32_t CorrectionState::hpac_key(long gnss_id, uint16_t set_id) NOEXCEPT {
+    return (1u << 24) | (static_cast<uint32_t>(subtype_from_gnss_id(gnss_id)) << 16) | set_id;
+}
+
+uint32_t CorrectionState::gad_key(uint16_t set_id) NOEXCEPT {
+    return (2u << 24) | set_id;
+}
+
+CorrectionState::Entry& CorrectionState::entry(uint32_t key) {
+    auto& entry = mEntries[key];
+    if (!entry) {
+        entry = std::unique_ptr<Entry>(new Entry{});
+        // A message that has never been encoded is always dirty
+        entry->dirty = 0xFF;
+    }
+    return *entry;
+}
+
+uint8_t CorrectionState::update(long gnss_id, OcbCorrections const& corrections) NOEXCEPT {
+    auto& ocb = entry(ocb_key(gnss_id));
+
+    uint8_t dirty = 0;
+    if (ocb.inputs[0].update(&asn_DEF_SSR_OrbitCorrectionList_r15,
+                             corrections.orbit ? &corrections.orbit->ssr_OrbitCorrectionList_r15 :
+                                                 nullptr))
+        dirty |= OCB_INPUT_ORBIT;
+    if (ocb.inputs[1].update(&asn_DEF_SSR_ClockCorrectionList_r15,
+                             corrections.clock ? &corrections.clock->ssr_ClockCorrectionList_r15 :
+                                                 nullptr))
+        dirty |= OCB_INPUT_CLOCK;
+    if (ocb.inputs[2].update(&asn_DEF_SSR_CodeBiasSatList_r15,
+                             corrections.code_bias ?
+                                 &corrections.code_bias->ssr_CodeBiasSatList_r15 :
+                                 nullptr))
+        dirty |= OCB_INPUT_CODE_BIAS;
+    if (ocb.inputs[3].update(&asn_DEF_SSR_PhaseBiasSatList_r16,
+                             corrections.phase_bias ?
+                                 &corrections.phase_bias->ssr_PhaseBiasSatList_r16 :
+                                 nullptr))
+        dirty |= OCB_INPUT_PHASE_BIAS;
+    if (ocb.inputs[4].update(&asn_DEF_SSR_URA_SatList_r16,
+                             corrections.ura ? &corrections.ura->ssr_URA_SatList_r16 : nullptr))
+        dirty |= OCB_INPUT_URA;
+
+    ocb.dirty |= dirty;
+    return dirty;
+}
+
+uint8_t CorrectionState::update(long gnss_id, uint16_t set_id,
+                                HpacCorrections const& corrections) NOEXCEPT {
+    auto& hpac = entry(hpac_key(gnss_id, set_id));
+
+    uint8_t dirty = 0;
+    if (hpac.inputs[0].update(&asn_DEF_STEC_SatList_r16,
+                              corrections.stec ? &corrections.stec->stec_SatList_r16 : nullptr))
+        dirty |= HPAC_INPUT_STEC;
+    if (hpac.inputs[1].update(&asn_DEF_GridList_r16,
+                              corrections.gridded ? &corrections.gridded->gridList_r16 : nullptr))
+        dirty |= HPAC_INPUT_GRID;
+    if (hpac.inputs[2].update(&asn_DEF_BIT_STRING,
+                              corrections.gridded ?
+                                  corrections.gridded->troposphericDelayQualityIndicator_r16 :
+                                  nullptr))
+        dirty |= HPAC_INPUT_TROPO_QUALITY;
+
+    hpac.dirty |= dirty;
+    return dirty;
+}
+
+std::vector<uint8_t> const* CorrectionState::find(uint32_t               key,
+                                                  EncodingContext const& context) const NOEXCEPT {
+    auto it = mEntries.find(key);
+    if (it == mEntries.end()) return nullptr;
+
+    auto& entry = *it->second;
+    if (!entry.encoded || entry.dirty != 0) return nullptr;
+    if (!(entry.context == context)) return nullptr;
+    return &entry.payload;
+}
+
+void CorrectionState::store(uint32_t key, EncodingContext const& context,
+                            std::vector<uint8_t> const& payload) {
+    auto& stored   = entry(key);
+    stored.dirty   = 0;
+    stored.encoded = true;
+    stored.context = context;
+    stored.payload = payload;
+}
+
+void CorrectionState::clear() NOEXCEPT {
+    mEntries.clear();
+}
+
+}  // namespace spartn
+}  // namespace generator
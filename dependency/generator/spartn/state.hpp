@@ -0,0 +1,103 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct asn_TYPE_descriptor_s;
+
+namespace generator {
+namespace spartn {
+
+struct OcbCorrections;
+struct HpacCorrections;
+
+/// Deep copy of an LPP IE from the previous generation, used to detect if the IE has changed.
+class AsnSnapshot {
+public:
+    AsnSnapshot() NOEXCEPT : mDescriptor(nullptr), mValue(nullptr) {}
+    ~AsnSnapshot() NOEXCEPT;
+
+    AsnSnapshot(AsnSnapshot const&)            = delete;
+    AsnSnapshot& operator=(AsnSnapshot const&) = delete;
+
+    /// Replace the snapshot with `value`, nullptr if the IE is not present. Returns true if the
+    /// value differs from the previous snapshot.
+    bool update(asn_TYPE_descriptor_s const* descriptor, void const* value) NOEXCEPT;
+    void clear() NOEXCEPT;
+
+private:
+    asn_TYPE_descriptor_s const* mDescriptor;
+    void*                        mValue;
+};
+
+// Inputs of an OCB message, one dirty flag each.
+static CONSTEXPR uint8_t OCB_INPUT_ORBIT      = 1 << 0;
+static CONSTEXPR uint8_t OCB_INPUT_CLOCK      = 1 << 1;
+static CONSTEXPR uint8_t OCB_INPUT_CODE_BIAS  = 1 << 2;
+static CONSTEXPR uint8_t OCB_INPUT_PHASE_BIAS = 1 << 3;
+static CONSTEXPR uint8_t OCB_INPUT_URA        = 1 << 4;
+
+// Inputs of an HPAC message, one dirty flag each.
+static CONSTEXPR uint8_t HPAC_INPUT_STEC          = 1 << 0;
+static CONSTEXPR uint8_t HPAC_INPUT_GRID          = 1 << 1;
+static CONSTEXPR uint8_t HPAC_INPUT_TROPO_QUALITY = 1 << 2;
+
+/// Everything that is encoded into a message but not taken from its LPP inputs, e.g. the SIOU or
+/// satellites marked as do-not-use by other IEs.
+struct EncodingContext {
+    uint64_t flags;
+    uint64_t satellites;
+
+    bool operator==(EncodingContext const& other) const {
+        return flags == other.flags && satellites == other.satellites;
+    }
+};
+
+/// Correction state kept between generations. The LPP IEs of each SPARTN message (per message
+/// type, GNSS and correction point set) are compared against the previous generation and the
+/// encoded payload is kept, so a message is only encoded again when its inputs have changed.
+/// Only the correction lists are compared, epoch time and update interval are not part of the
+/// payload.
+class CorrectionState {
+public:
+    CorrectionState() NOEXCEPT;
+    ~CorrectionState() NOEXCEPT;
+
+    /// Update the inputs of the OCB message of `gnss_id`, returns the inputs that changed.
+    uint8_t update(long gnss_id, OcbCorrections const& corrections) NOEXCEPT;
+    /// Update the inputs of the HPAC message of `gnss_id` and `set_id`, returns the inputs that
+    /// changed.
+    uint8_t update(long gnss_id, uint16_t set_id, HpacCorrections const& corrections) NOEXCEPT;
+
+    /// Payload of a message encoded from unchanged inputs and the same context, or nullptr.
+    NODISCARD std::vector<uint8_t> const* find(uint32_t key,
+                                               EncodingContext const& context) const NOEXCEPT;
+    void store(uint32_t key, EncodingContext const& context, std::vector<uint8_t> const& payload);
+
+    /// Drop all inputs and payloads, e.g. when the generator is reconfigured.
+    void clear() NOEXCEPT;
+
+    static uint32_t ocb_key(long gnss_id) NOEXCEPT;
+    static uint32_t hpac_key(long gnss_id, uint16_t set_id) NOEXCEPT;
+    static uint32_t gad_key(uint16_t set_id) NOEXCEPT;
+
+private:
+    static CONSTEXPR size_t MAX_INPUTS = 5;
+
+    struct Entry {
+        AsnSnapshot          inputs[MAX_INPUTS];
+        uint8_t              dirty;
+        bool                 encoded;
+        EncodingContext      context;
+        std::vector<uint8_t> payload;
+    };
+
+    Entry& entry(uint32_t key);
+
+    std::unordered_map<uint32_t, std::unique_ptr<Entry>> mEntries;
+};
+
+}  // namespace spartn
+}  // namespace generator
@@ -0,0 +1,87 @@
+#include "worker_pool.hpp"
+
+namespace generator {
+namespace spartn {
+
+WorkerPool::WorkerPool(size_t threads)
+    : mTask(nullptr), mCount(0), mNext(0), mActive(0), mBatch(0), mStop(false) {
+    for (size_t i = 0; i < threads; i++) {
+        mWorkers.emplace_back([this]() {
+            worker();
+        });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWork.notify_all();
+
+    for (auto& worker : mWorkers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::run(size_t count, std::function<void(size_t)> const& task) {
+    if (count == 0) return;
+    if (mWorkers.empty() || count == 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask   = &task;
+        mCount  = count;
+        mNext   = 0;
+        mActive = mWorkers.size();
+        mBatch++;
+    }
+    mWork.notify_all();
+
+    drain();
+
+    // Every worker has to leave the batch before `task` goes out of scope
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() {
+        return mActive == 0;
+    });
+    mTask = nullptr;
+}
+
+void WorkerPool::worker() {
+    uint64_t batch = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWork.wait(lock, [&]() {
+                return mStop || mBatch != batch;
+            });
+            if (mStop) return;
+            batch = mBatch;
+        }
+
+        drain();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mActive--;
+        }
+        mDone.notify_one();
+    }
+}
+
+void WorkerPool::drain() {
+    for (;;) {
+        auto index = mNext.fetch_add(1);
+        if (index >= mCount) break;
+        (*mTask)(index);
+    }
+}
+
+}  // namespace spartn
+}  // namespace generator
@@ -0,0 +1,48 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace generator {
+namespace spartn {
+
+/// Fixed set of threads that are kept between generations, so encoding the messages of many
+/// correction point sets does not start new threads for every epoch.
+class WorkerPool {
+public:
+    /// Start `threads` worker threads, the thread calling `run` is used as well.
+    EXPLICIT WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(WorkerPool const&)            = delete;
+    WorkerPool& operator=(WorkerPool const&) = delete;
+
+    /// Call `task` for each index in [0, count) and wait until all calls have returned. The
+    /// indices are handed out one at a time to the workers and the calling thread.
+    void run(size_t count, std::function<void(size_t)> const& task);
+
+private:
+    void worker();
+    void drain();
+
+    std::mutex              mMutex;
+    std::condition_variable mWork;
+    std::condition_variable mDone;
+
+    std::function<void(size_t)> const* mTask;
+    size_t                             mCount;
+    std::atomic<size_t>                mNext;
+    size_t                             mActive;
+    uint64_t                           mBatch;
+    bool                               mStop;
+
+    std::vector<std::thread> mWorkers;
+};
+
+}  // namespace spartn
+}  // namespace generator
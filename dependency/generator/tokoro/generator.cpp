@@ -3,6 +3,8 @@
 #include "coordinate.hpp"
 #include "data/correction.hpp"
 #include "decode.hpp"
+#include "ground.hpp"
+#include "models/astro_cache.hpp"
 #include "models/helper.hpp"
 #include "observation.hpp"
 #include "satellite.hpp"
@@ -143,7 +145,8 @@ void ReferenceStation::initialize_satellites() NOEXCEPT {
     }
 }
 
-void ReferenceStation::initialize_observation(Satellite& satellite, SignalId signal_id,
+void ReferenceStation::initialize_observation(Satellite& satellite, GroundContext const& ground,
+                                              SignalId    signal_id,
                                               char const* diag_discard_reason) NOEXCEPT {
     FUNCTION_SCOPE();
 
@@ -165,8 +168,7 @@ void ReferenceStation::initialize_observation(Satellite& satellite, SignalId sig
     auto antex = mGenerator.mAntex.get();
 #endif
 
-    auto& observation = satellite.initialize_observation(signal_id);
-    observation.recompute_mapping_hydrostatic(mTropoHydrostaticDelta);
+    auto& observation = satellite.initialize_observation(signal_id, ground);
     observation.update_lock_time(lock_time);
     observation.compute_phase_bias(correction_data);
     observation.compute_code_bias(correction_data);
@@ -176,7 +178,7 @@ void ReferenceStation::initialize_observation(Satellite& satellite, SignalId sig
 #ifdef INCLUDE_FORMAT_ANTEX
     if (mAntennaPhaseVariation && antex) observation.compute_antenna_phase_variation(*antex);
 #endif
-    if (mTropoHeightCorrection) observation.compute_tropospheric_height();
+    if (mTropoHeightCorrection) observation.compute_tropospheric_height(ground);
 
     observation.set_negative_phase_windup(mNegativePhaseWindup);
     observation.set_require_code_bias(mRequireCodeBias);
@@ -211,6 +213,31 @@ void ReferenceStation::initialize_observation(Satellite& satellite, SignalId sig
     VERBOSEF("observation: c=%f, p=%f", observation.code_range(), observation.phase_range());
 }
 
+void ReferenceStation::compute_tropospheric_mapping(GroundContext const& ground) NOEXCEPT {
+    FUNCTION_SCOPE();
+
+    // Map the elevations of all enabled satellites in one batch
+    mMappingSatellites.clear();
+    mMappingElevations.clear();
+    for (size_t i = 0; i < mSatellites.size(); i++) {
+        if (!mSatellites[i].enabled()) continue;
+        mMappingSatellites.push_back(i);
+        mMappingElevations.push_back(mSatellites[i].elevation());
+    }
+
+    auto count = mMappingElevations.size();
+    mMappingHydrostatic.resize(count);
+    mMappingWet.resize(count);
+    hydrostatic_mapping_functions(ground.niell, mMappingElevations.data(), count,
+                                  mTropoHydrostaticDelta, mMappingHydrostatic.data(),
+                                  mMappingWet.data());
+
+    for (size_t i = 0; i < count; i++) {
+        mSatellites[mMappingSatellites[i]].set_tropospheric_mapping(
+            {mMappingHydrostatic[i], mMappingWet[i]});
+    }
+}
+
 bool ReferenceStation::generate(ts::Tai const& reception_time) NOEXCEPT {
     FUNCTION_SCOPE();
     if (mGenerator.mCorrectionData == nullptr) {
@@ -235,6 +262,10 @@ bool ReferenceStation::generate(ts::Tai const& reception_time) NOEXCEPT {
         satellite.update(mGenerationTime);
     }
 
+    // Station terms shared by all observations of this epoch
+    GroundContext ground{mGroundPosition, mGenerationTime};
+    compute_tropospheric_mapping(ground);
+
     // Generate the observations
     std::unordered_set<SatelliteSignalId> active_signals;
     for (auto& satellite : mSatellites) {
@@ -248,7 +279,7 @@ bool ReferenceStation::generate(ts::Tai const& reception_time) NOEXCEPT {
         satellite.compute_sun_position();
         if (mShapiroCorrection) satellite.compute_shapiro();
         if (mEarthSolidTidesCorrection) satellite.compute_earth_solid_tides();
-        if (mPhaseWindupCorrection) satellite.compute_phase_windup();
+        if (mPhaseWindupCorrection) satellite.compute_phase_windup(ground);
         satellite.datatrace_report();
 
         if (mSatelliteIncludeSet.size() > 0 &&
@@ -284,7 +315,7 @@ bool ReferenceStation::generate(ts::Tai const& reception_time) NOEXCEPT {
                 continue;
             }
 
-            initialize_observation(satellite, signal,
+            initialize_observation(satellite, ground, signal,
                                    elevation_masked ? "elevation_mask" : nullptr);
             satellite.remove_discarded_observations();
         }
@@ -685,7 +716,7 @@ std::vector<rtcm::Message> ReferenceStation::produce() NOEXCEPT {
 //
 //
 
-Generator::Generator() NOEXCEPT {
+Generator::Generator() NOEXCEPT : mAstroCache(new AstroCache()) {
     FUNCTION_SCOPE();
     mIodConsistencyCheck                         = false;
     mUseReceptionTimeForOrbitAndClockCorrections = false;
@@ -0,0 +1,38 @@
+#include "ground.hpp"
+#include "coordinate.hpp"
+#include "models/geoid.hpp"
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(tokoro, ground);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(tokoro, ground)
+
+namespace generator {
+namespace tokoro {
+
+GroundContext::GroundContext(Float3 ground_position, ts::Tai const& epoch_time) NOEXCEPT
+    : time(epoch_time),
+      position(ground_position),
+      mops{},
+      mops_sea_level{},
+      mops_ellipsoidal_height{} {
+    VSCOPE_FUNCTIONF("%s", time.rtklib_time_string().c_str());
+
+    llh          = ecef_to_llh(position, ellipsoid::gWgs84);
+    geoid_height = Geoid::height(llh.x, llh.y, Geoid::Model::EMBEDDED);
+
+    receiver_antenna_basis = tokoro::receiver_antenna_basis(llh);
+    niell                  = niell_coefficients(time, llh);
+
+    mops_valid = evaluate_mops(time, llh.x, mops);
+    if (mops_valid) {
+        mops_tropospheric_delay(mops, llh.x, 0.0, geoid_height, mops_sea_level);
+        mops_tropospheric_delay(mops, llh.x, llh.z, geoid_height, mops_ellipsoidal_height);
+    } else {
+        VERBOSEF("failed to evaluate mops");
+    }
+}
+
+}  // namespace tokoro
+}  // namespace generator
@@ -0,0 +1,35 @@
+#pragma once
+#include <core/core.hpp>
+#include <maths/float3.hpp>
+#include <time/tai.hpp>
+
+#include "models/helper.hpp"
+#include "models/mops.hpp"
+#include "models/phase_windup.hpp"
+
+namespace generator {
+namespace tokoro {
+
+// Terms of a reference station that are the same for every observation in an epoch. They are
+// evaluated once per epoch instead of once for every satellite and signal.
+struct GroundContext {
+public:
+    EXPLICIT GroundContext(Float3 position, ts::Tai const& time) NOEXCEPT;
+
+    ts::Tai time;
+    Float3  position;
+    Float3  llh;
+    double  geoid_height;
+
+    ReceiverAntennaBasis receiver_antenna_basis;
+    NiellCoefficients    niell;
+
+    // MOPS meteorology and the delay at mean sea level and at the ellipsoidal height
+    Mops                   mops;
+    HydrostaticAndWetDelay mops_sea_level;
+    HydrostaticAndWetDelay mops_ellipsoidal_height;
+    bool                   mops_valid;
+};
+
+}  // namespace tokoro
+}  // namespace generator
@@ -45,8 +45,10 @@ struct ReferenceStationConfig {
     bool   generate_qzs;
 };
 
+class AstroCache;
 struct CorrectionData;
 struct CorrectionPointSet;
+struct GroundContext;
 struct Satellite;
 struct Observation;
 struct RangeTimeDivision;
@@ -119,7 +121,9 @@ public:
 
 protected:
     void initialize_satellites() NOEXCEPT;
-    void initialize_observation(Satellite& satellite, SignalId signal_id,
+    void compute_tropospheric_mapping(GroundContext const& ground) NOEXCEPT;
+    void initialize_observation(Satellite& satellite, GroundContext const& ground,
+                                SignalId    signal_id,
                                 char const* diag_discard_reason = nullptr) NOEXCEPT;
     void build_rtcm_observation(Satellite const& satellite, Observation const& observation,
                                 RangeTimeDivision const& rtd, double reference_phase_range_rate,
@@ -170,6 +174,12 @@ private:
     std::unordered_set<SatelliteId> mSatelliteIncludeSet;
     std::unordered_set<SignalId>    mSignalIncludeSet;
 
+    // Scratch space of the batched tropospheric mapping, reused every epoch
+    std::vector<size_t> mMappingSatellites;
+    std::vector<double> mMappingElevations;
+    std::vector<double> mMappingHydrostatic;
+    std::vector<double> mMappingWet;
+
     std::unordered_map<SatelliteSignalId, ts::Tai> mLockTime;
 
     ts::Tai mGenerationTime;
@@ -276,6 +286,8 @@ private:
 #ifdef INCLUDE_FORMAT_ANTEX
     std::unique_ptr<format::antex::Antex> mAntex;
 #endif
+    // Shared by the satellites of every reference station
+    std::unique_ptr<AstroCache> mAstroCache;
 
     bool mIodConsistencyCheck;
     bool mUseReceptionTimeForOrbitAndClockCorrections;
@@ -16,6 +16,7 @@ namespace generator {
 namespace tokoro {
 
 struct CorrectionData;
+struct GroundContext;
 struct Satellite;
 struct SatelliteState;
 
@@ -56,7 +57,8 @@ struct LockTime {
 
 struct Observation {
 public:
-    EXPLICIT Observation(Satellite const& satellite, SignalId signal_id, Float3 location) NOEXCEPT;
+    EXPLICIT Observation(Satellite const& satellite, SignalId signal_id,
+                         GroundContext const& ground) NOEXCEPT;
 
     void update_lock_time(LockTime const& lock_time) NOEXCEPT;
 
@@ -65,8 +67,7 @@ public:
     void compute_tropospheric(CorrectionData const& correction_data) NOEXCEPT;
     void compute_ionospheric(CorrectionData const& correction_data) NOEXCEPT;
 
-    void compute_tropospheric_height() NOEXCEPT;
-    void recompute_mapping_hydrostatic(bool apply_hydrostatic_delta) NOEXCEPT;
+    void compute_tropospheric_height(GroundContext const& ground) NOEXCEPT;
 
 #ifdef INCLUDE_FORMAT_ANTEX
     void compute_antenna_phase_variation(format::antex::Antex const& antex) NOEXCEPT;
@@ -103,6 +104,8 @@ public:
     NODISCARD bool has_tropospheric() const NOEXCEPT { return mTropospheric.valid; }
     NODISCARD bool has_ionospheric() const NOEXCEPT { return mIonospheric.valid; }
 
+    NODISCARD TroposphericDelay const& tropospheric() const NOEXCEPT { return mTropospheric; }
+
     NODISCARD SatelliteId const& sv_id() const NOEXCEPT { return mSvId; }
     NODISCARD SignalId const&    signal_id() const NOEXCEPT { return mSignalId; }
     NODISCARD SatelliteSignalId  ss_id() const NOEXCEPT { return {mSvId, mSignalId}; }
@@ -0,0 +1,35 @@
+#include "astro_cache.hpp"
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(tokoro, astro);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(tokoro, astro)
+
+namespace generator {
+namespace tokoro {
+
+AstroCache::AstroCache() NOEXCEPT : mEntries{}, mCount(0), mNext(0), mHits(0), mMisses(0) {}
+
+SunMoonPosition const& AstroCache::sun_and_moon_position_ecef(ts::Tai const& time) NOEXCEPT {
+    for (size_t i = 0; i < mCount; i++) {
+        if (mEntries[i].time == time) {
+            mHits++;
+            return mEntries[i].position;
+        }
+    }
+
+    TRACEF("astro cache miss: %s", time.rtklib_time_string().c_str());
+    mMisses++;
+
+    // Replace the oldest epoch
+    auto& entry    = mEntries[mNext];
+    entry.time     = time;
+    entry.position = tokoro::sun_and_moon_position_ecef(time);
+    mNext          = (mNext + 1) % ENTRY_COUNT;
+    if (mCount < ENTRY_COUNT) mCount++;
+    return entry.position;
+}
+
+}  // namespace tokoro
+}  // namespace generator
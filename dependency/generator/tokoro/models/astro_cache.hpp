@@ -0,0 +1,39 @@
+#pragma once
+#include <core/core.hpp>
+#include <time/tai.hpp>
+
+#include "sun_moon.hpp"
+
+namespace generator {
+namespace tokoro {
+
+// Sun and moon positions with the nutation and Earth rotation they are transformed with only
+// depend on the time. The cache keeps the most recent epochs, so all satellites and reference
+// stations generated for the same epoch share one evaluation.
+class AstroCache {
+public:
+    AstroCache() NOEXCEPT;
+
+    NODISCARD SunMoonPosition const& sun_and_moon_position_ecef(ts::Tai const& time) NOEXCEPT;
+
+    NODISCARD size_t hits() const NOEXCEPT { return mHits; }
+    NODISCARD size_t misses() const NOEXCEPT { return mMisses; }
+
+private:
+    struct Entry {
+        ts::Tai         time;
+        SunMoonPosition position;
+    };
+
+    // Each epoch evaluates the current and next state of every satellite
+    static CONSTEXPR size_t ENTRY_COUNT = 8;
+
+    Entry  mEntries[ENTRY_COUNT];
+    size_t mCount;
+    size_t mNext;
+    size_t mHits;
+    size_t mMisses;
+};
+
+}  // namespace tokoro
+}  // namespace generator
@@ -57,7 +57,8 @@ static bool compute_solid_tide_pole(ts::Tai const& time, Float3 const& up, Float
 }
 
 EarthSolidTides model_earth_solid_tides(ts::Tai const& time, SatelliteState const& satellite,
-                                        Float3 ground_position_ecef, Float3 ground_position_llh) {
+                                        SunMoonPosition const& sm, Float3 ground_position_ecef,
+                                        Float3 ground_position_llh) {
     VSCOPE_FUNCTIONF("%s", time.rtklib_time_string().c_str());
 
     Float3 east{};
@@ -65,8 +66,6 @@ EarthSolidTides model_earth_solid_tides(ts::Tai const& time, SatelliteState cons
     Float3 up{};
     enu_basis_from_xyz(ground_position_ecef, east, north, up);
 
-    auto sm = sun_and_moon_position_ecef(time);
-
     Float3 sun_pole{};
     compute_solid_tide_pole(time, up, sm.sun, constant::SUN_GRAVITATIONAL_CONSTANT, sun_pole);
 
@@ -4,6 +4,8 @@
 #include <maths/float3.hpp>
 #include <time/tai.hpp>
 
+#include "sun_moon.hpp"
+
 namespace generator {
 namespace tokoro {
 
@@ -15,6 +17,7 @@ struct EarthSolidTides {
 
 struct SatelliteState;
 EarthSolidTides model_earth_solid_tides(ts::Tai const& time, SatelliteState const& satellite,
+                                        SunMoonPosition const& sun_moon,
                                         Float3 ground_position_ecef, Float3 ground_position_llh);
 
 }  // namespace tokoro
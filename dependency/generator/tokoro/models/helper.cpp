@@ -54,16 +54,9 @@ static double delta_m(double elevation, double ellipsoidal_height) {
            ellipsoidal_height;
 }
 
-HydrostaticAndWetMapping hydrostatic_mapping_function(ts::Tai time, Float3 position,
-                                                      double elevation,
-                                                      bool   apply_hydrostatic_delta) {
-    VSCOPE_FUNCTIONF("%s, (%f, %f, %f), %f", ts::Utc{time}.rtklib_time_string().c_str(),
-                     position.x * constant::RAD2DEG, position.y * constant::RAD2DEG, position.z,
-                     elevation * constant::RAD2DEG);
-
-    if (elevation < 0.0) {
-        return {0.0, 0.0};
-    }
+NiellCoefficients niell_coefficients(ts::Tai time, Float3 position) {
+    VSCOPE_FUNCTIONF("%s, (%f, %f, %f)", ts::Utc{time}.rtklib_time_string().c_str(),
+                     position.x * constant::RAD2DEG, position.y * constant::RAD2DEG, position.z);
 
     auto day_of_year = ts::Utc{time}.day_of_year();
     auto time_y      = (day_of_year - 28.0) / 365.25;
@@ -79,31 +72,40 @@ HydrostaticAndWetMapping hydrostatic_mapping_function(ts::Tai time, Float3 posit
     auto lat_deg = position.x * constant::RAD2DEG;
     auto cos_y   = std::cos(2.0 * constant::PI * time_y);
 
-    auto a_d =
+    NiellCoefficients coefficients{};
+    coefficients.a_d =
         interpolate_coef(lat_deg, MAP_COEF[0]) - interpolate_coef(lat_deg, MAP_COEF[3]) * cos_y;
-    auto b_d =
+    coefficients.b_d =
         interpolate_coef(lat_deg, MAP_COEF[1]) - interpolate_coef(lat_deg, MAP_COEF[4]) * cos_y;
-    auto c_d =
+    coefficients.c_d =
         interpolate_coef(lat_deg, MAP_COEF[2]) - interpolate_coef(lat_deg, MAP_COEF[5]) * cos_y;
+    coefficients.a_w    = interpolate_coef(lat_deg, MAP_COEF[6]);
+    coefficients.b_w    = interpolate_coef(lat_deg, MAP_COEF[7]);
+    coefficients.c_w    = interpolate_coef(lat_deg, MAP_COEF[8]);
+    coefficients.height = position.z / 1.0e3;
+
+    VERBOSEF("a_d: %+f", coefficients.a_d);
+    VERBOSEF("b_d: %+f", coefficients.b_d);
+    VERBOSEF("c_d: %+f", coefficients.c_d);
+    VERBOSEF("a_w: %+f", coefficients.a_w);
+    VERBOSEF("b_w: %+f", coefficients.b_w);
+    VERBOSEF("c_w: %+f", coefficients.c_w);
+    return coefficients;
+}
 
-    VERBOSEF("a_d: %+f", a_d);
-    VERBOSEF("b_d: %+f", b_d);
-    VERBOSEF("c_d: %+f", c_d);
-
-    auto height = position.z / 1.0e3;
-
-    auto hydrostatic         = mapping_function(elevation, a_d, b_d, c_d);
-    auto hydrostatic_delta_m = delta_m(elevation, height);
-
-    auto a_w = interpolate_coef(lat_deg, MAP_COEF[6]);
-    auto b_w = interpolate_coef(lat_deg, MAP_COEF[7]);
-    auto c_w = interpolate_coef(lat_deg, MAP_COEF[8]);
+HydrostaticAndWetMapping hydrostatic_mapping_function(NiellCoefficients const& coefficients,
+                                                      double                   elevation,
+                                                      bool apply_hydrostatic_delta) {
+    VSCOPE_FUNCTIONF("%f", elevation * constant::RAD2DEG);
 
-    VERBOSEF("a_w: %+f", a_w);
-    VERBOSEF("b_w: %+f", b_w);
-    VERBOSEF("c_w: %+f", c_w);
+    if (elevation < 0.0) {
+        return {0.0, 0.0};
+    }
 
-    auto wet = mapping_function(elevation, a_w, b_w, c_w);
+    auto hydrostatic =
+        mapping_function(elevation, coefficients.a_d, coefficients.b_d, coefficients.c_d);
+    auto hydrostatic_delta_m = delta_m(elevation, coefficients.height);
+    auto wet = mapping_function(elevation, coefficients.a_w, coefficients.b_w, coefficients.c_w);
 
     VERBOSEF("delta_m: %+f", hydrostatic_delta_m);
     VERBOSEF("hydrostatic: %+f", hydrostatic);
@@ -112,5 +114,69 @@ HydrostaticAndWetMapping hydrostatic_mapping_function(ts::Tai time, Float3 posit
     return {hydrostatic + (apply_hydrostatic_delta ? hydrostatic_delta_m : 0.0), wet};
 }
 
+HydrostaticAndWetMapping hydrostatic_mapping_function(ts::Tai time, Float3 position,
+                                                      double elevation,
+                                                      bool   apply_hydrostatic_delta) {
+    if (elevation < 0.0) {
+        return {0.0, 0.0};
+    }
+
+    return hydrostatic_mapping_function(niell_coefficients(time, position), elevation,
+                                        apply_hydrostatic_delta);
+}
+
+// The constant numerator of the continued fraction
+static double mapping_numerator(double a, double b, double c) {
+    return 1.0 + a / (1.0 + b / (1.0 + c));
+}
+
+static double mapping_denominator(double sinel, double a, double b, double c) {
+    return sinel + (a / (sinel + b / (sinel + c)));
+}
+
+void hydrostatic_mapping_functions(NiellCoefficients const& coefficients, double const* elevations,
+                                   size_t count, bool apply_hydrostatic_delta,
+                                   double* hydrostatic, double* wet) {
+    VSCOPE_FUNCTIONF("%zu", count);
+
+    auto a_d  = coefficients.a_d;
+    auto b_d  = coefficients.b_d;
+    auto c_d  = coefficients.c_d;
+    auto a_w  = coefficients.a_w;
+    auto b_w  = coefficients.b_w;
+    auto c_w  = coefficients.c_w;
+    auto a_ht = 2.53E-5;
+    auto b_ht = 5.49E-3;
+    auto c_ht = 1.14E-3;
+
+    auto numerator_d  = mapping_numerator(a_d, b_d, c_d);
+    auto numerator_w  = mapping_numerator(a_w, b_w, c_w);
+    auto numerator_ht = mapping_numerator(a_ht, b_ht, c_ht);
+    auto height       = coefficients.height;
+
+    // The sine is evaluated once per elevation instead of once per mapping function. The second
+    // loop is only arithmetic and selects, which the compiler vectorizes.
+    static CONSTEXPR size_t BLOCK = 64;
+    double                  sinel[BLOCK];
+    for (size_t begin = 0; begin < count; begin += BLOCK) {
+        auto length = count - begin < BLOCK ? count - begin : BLOCK;
+        for (size_t i = 0; i < length; i++) {
+            sinel[i] = std::sin(elevations[begin + i]);
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            auto s       = sinel[i];
+            auto h       = numerator_d / mapping_denominator(s, a_d, b_d, c_d);
+            auto w       = numerator_w / mapping_denominator(s, a_w, b_w, c_w);
+            auto ht      = numerator_ht / mapping_denominator(s, a_ht, b_ht, c_ht);
+            auto delta   = ((1.0 / s) - ht) * height;
+            auto visible = elevations[begin + i] >= 0.0;
+
+            hydrostatic[begin + i] = visible ? (apply_hydrostatic_delta ? h + delta : h) : 0.0;
+            wet[begin + i]         = visible ? w : 0.0;
+        }
+    }
+}
+
 }  // namespace tokoro
 }  // namespace generator
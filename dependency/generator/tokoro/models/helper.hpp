@@ -72,9 +72,32 @@ struct HydrostaticAndWetMapping {
     double wet;
 };
 
+// Niell mapping coefficients at a time and position, they do not depend on the elevation and are
+// shared by every satellite seen from the position
+struct NiellCoefficients {
+    double a_d;
+    double b_d;
+    double c_d;
+    double a_w;
+    double b_w;
+    double c_w;
+    double height;  // km
+};
+
+NiellCoefficients niell_coefficients(ts::Tai time, Float3 position);
+
+HydrostaticAndWetMapping hydrostatic_mapping_function(NiellCoefficients const& coefficients,
+                                                      double                   elevation,
+                                                      bool apply_hydrostatic_delta);
 HydrostaticAndWetMapping hydrostatic_mapping_function(ts::Tai time, Float3 position,
                                                       double elevation,
                                                       bool   apply_hydrostatic_delta);
 
+// Mapping for `count` elevations at once, the same as `hydrostatic_mapping_function` for each of
+// them. Elevations below the horizon map to zero.
+void hydrostatic_mapping_functions(NiellCoefficients const& coefficients, double const* elevations,
+                                   size_t count, bool apply_hydrostatic_delta,
+                                   double* hydrostatic, double* wet);
+
 }  // namespace tokoro
 }  // namespace generator
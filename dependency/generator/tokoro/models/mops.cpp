@@ -104,16 +104,10 @@ static double wet_function(double temperature, double water_pressure) {
     return 2.2768 * (1255.0 / temperature + 0.05) * water_pressure * 0.001;
 }
 
-bool mops_tropospheric_delay(ts::Tai const& time, double latitude, double ellipsoidal_height,
+void mops_tropospheric_delay(Mops const& mops, double latitude, double ellipsoidal_height,
                              double geoid_height, HydrostaticAndWetDelay& result) {
-    VSCOPE_FUNCTIONF("%s, %+.8f, %+.8f, %+.8f", time.rtklib_time_string().c_str(),
-                     latitude * constant::RAD2DEG, ellipsoidal_height, geoid_height);
-
-    Mops mops{};
-    if (!evaluate_mops(time, latitude, mops)) {
-        VERBOSEF("failed to evaluate mops");
-        return false;
-    }
+    VSCOPE_FUNCTIONF("%+.8f, %+.8f, %+.8f", latitude * constant::RAD2DEG, ellipsoidal_height,
+                     geoid_height);
 
     auto elevation = ellipsoidal_height - geoid_height;
 
@@ -149,6 +143,20 @@ bool mops_tropospheric_delay(ts::Tai const& time, double latitude, double ellips
 
     VERBOSEF("hydrostatic:    %+.8f", result.hydrostatic);
     VERBOSEF("wet:            %+.8f", result.wet);
+}
+
+bool mops_tropospheric_delay(ts::Tai const& time, double latitude, double ellipsoidal_height,
+                             double geoid_height, HydrostaticAndWetDelay& result) {
+    VSCOPE_FUNCTIONF("%s, %+.8f, %+.8f, %+.8f", time.rtklib_time_string().c_str(),
+                     latitude * constant::RAD2DEG, ellipsoidal_height, geoid_height);
+
+    Mops mops{};
+    if (!evaluate_mops(time, latitude, mops)) {
+        VERBOSEF("failed to evaluate mops");
+        return false;
+    }
+
+    mops_tropospheric_delay(mops, latitude, ellipsoidal_height, geoid_height, result);
     return true;
 }
 
@@ -20,6 +20,9 @@ struct HydrostaticAndWetDelay {
     double wet;
 };
 
+// Delay from meteorological parameters already evaluated with `evaluate_mops`
+void mops_tropospheric_delay(Mops const& mops, double latitude, double ellipsoidal_height,
+                             double geoid_height, HydrostaticAndWetDelay& result);
 bool mops_tropospheric_delay(ts::Tai const& time, double latitude, double ellipsoidal_height,
                              double geoid_height, HydrostaticAndWetDelay& result);
 
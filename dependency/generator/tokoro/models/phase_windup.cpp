@@ -236,13 +236,18 @@ static double phase_windup_from_basis(SatelliteState const& satellite, Float3 sx
     return phw;
 }
 
+ReceiverAntennaBasis receiver_antenna_basis(Float3 ground_position_llh) {
+    ReceiverAntennaBasis basis{};
+    basis.valid = compute_receiver_antenna_basis(ground_position_llh, basis.x, basis.y, basis.z);
+    return basis;
+}
+
 PhaseWindup model_phase_windup(ts::Tai const& time, SatelliteState const& satellite,
-                               UNUSED Float3 ground_position_ecef, Float3 ground_position_llh,
-                               PhaseWindup const& previous_windup) {
+                               SunMoonPosition const& sm, Float3 ground_position_ecef,
+                               ReceiverAntennaBasis const& receiver,
+                               PhaseWindup const&          previous_windup) {
     VSCOPE_FUNCTIONF("%s", time.rtklib_time_string().c_str());
 
-    auto sm = sun_and_moon_position_ecef(time);
-
     Float3 sx_sun, sy_sun, sz_sun;
     if (!compute_satellite_antenna_basis_sun(satellite.true_position, sm.sun, sx_sun, sy_sun,
                                              sz_sun)) {
@@ -266,11 +271,12 @@ PhaseWindup model_phase_windup(ts::Tai const& time, SatelliteState const& satell
         return {};
     }
 
-    Float3 rx, ry, rz;
-    if (!compute_receiver_antenna_basis(ground_position_llh, rx, ry, rz)) {
+    if (!receiver.valid) {
         WARNF("failed to compute receiver antenna basis");
         return {};
     }
+    auto rx = receiver.x;
+    auto ry = receiver.y;
 
     auto prev_phw_sun      = 0.0;
     auto prev_phw_velocity = 0.0;
@@ -4,6 +4,8 @@
 #include <maths/float3.hpp>
 #include <time/tai.hpp>
 
+#include "sun_moon.hpp"
+
 namespace generator {
 namespace tokoro {
 
@@ -14,10 +16,21 @@ struct PhaseWindup {
     bool   valid;
 };
 
+// Receiver antenna basis, it only depends on the ground position
+struct ReceiverAntennaBasis {
+    Float3 x;
+    Float3 y;
+    Float3 z;
+    bool   valid;
+};
+
+ReceiverAntennaBasis receiver_antenna_basis(Float3 ground_position_llh);
+
 struct SatelliteState;
 PhaseWindup model_phase_windup(ts::Tai const& time, SatelliteState const& satellite,
-                               Float3 ground_position, Float3 ground_position_llh,
-                               PhaseWindup const& previous_windup);
+                               SunMoonPosition const& sun_moon, Float3 ground_position,
+                               ReceiverAntennaBasis const& receiver,
+                               PhaseWindup const&          previous_windup);
 
 }  // namespace tokoro
 }  // namespace generator
@@ -3,8 +3,8 @@
 #include "coordinates/eci.hpp"
 #include "coordinates/enu.hpp"
 #include "data/correction.hpp"
+#include "ground.hpp"
 #include "models/astronomical_arguments.hpp"
-#include "models/geoid.hpp"
 #include "models/helper.hpp"
 #include "models/mops.hpp"
 #include "models/nutation.hpp"
@@ -29,7 +29,8 @@ LOGLET_MODULE2(tokoro, obs);
 namespace generator {
 namespace tokoro {
 
-Observation::Observation(Satellite const& satellite, SignalId signal_id, Float3 location) NOEXCEPT
+Observation::Observation(Satellite const& satellite, SignalId signal_id,
+                         GroundContext const& ground) NOEXCEPT
     : mSvId(satellite.id()),
       mSignalId(signal_id),
       mCurrent{&satellite.current_state()},
@@ -62,48 +63,31 @@ Observation::Observation(Satellite const& satellite, SignalId signal_id, Float3
     mIonospheric  = IonosphericDelay{0.0, 0.0, false, 0.0, 0.0, 0.0, false};
     mAntennaPhaseVariation = Correction{0.0, false};
 
-    mGroundPosition = location;
-    mGroundLlh      = ecef_to_llh(location, ellipsoid::gWgs84);
+    mGroundPosition = ground.position;
+    mGroundLlh      = ground.llh;
 
-    auto mapping = hydrostatic_mapping_function(mCurrent->reception_time, mGroundLlh,
-                                                mCurrent->true_elevation, true);
+    // The mapping only depends on the elevation and is computed once per satellite
+    auto const& mapping               = satellite.tropospheric_mapping();
     mTropospheric.mapping_hydrostatic = mapping.hydrostatic;
     mTropospheric.mapping_wet         = mapping.wet;
 }
 
-void Observation::recompute_mapping_hydrostatic(bool apply_hydrostatic_delta) NOEXCEPT {
-    auto mapping = hydrostatic_mapping_function(mCurrent->reception_time, mGroundLlh,
-                                                mCurrent->true_elevation, apply_hydrostatic_delta);
-    mTropospheric.mapping_hydrostatic = mapping.hydrostatic;
-}
-
-void Observation::compute_tropospheric_height() NOEXCEPT {
+void Observation::compute_tropospheric_height(GroundContext const& ground) NOEXCEPT {
     VSCOPE_FUNCTION();
 
-    auto ellipsoidal_height = mGroundLlh.z;
-    auto geoid_height       = Geoid::height(mGroundLlh.x, mGroundLlh.y, Geoid::Model::EMBEDDED);
-
-    HydrostaticAndWetDelay alt_0{};
-    HydrostaticAndWetDelay alt_eh{};
-    auto                   mops_0 =
-        mops_tropospheric_delay(mCurrent->reception_time, mGroundLlh.x, 0.0, geoid_height, alt_0);
-    auto mops_eh = mops_tropospheric_delay(mCurrent->reception_time, mGroundLlh.x,
-                                           ellipsoidal_height, geoid_height, alt_eh);
-    if (mops_0 && mops_eh) {
+    if (ground.mops_valid) {
+        auto const& alt_0  = ground.mops_sea_level;
+        auto const& alt_eh = ground.mops_ellipsoidal_height;
         mTropospheric.height_mapping_hydrostatic = alt_eh.hydrostatic / alt_0.hydrostatic;
         mTropospheric.height_mapping_wet         = alt_eh.wet / alt_0.wet;
         mTropospheric.valid_height_mapping       = true;
+        mTropospheric.model_hydrostatic          = alt_eh.hydrostatic;
+        mTropospheric.model_wet                  = alt_eh.wet;
+        mTropospheric.valid_model                = true;
     } else {
         WARNF("failed to compute tropospheric height correction");
         mTropospheric.valid_height_mapping = false;
-    }
-
-    if (mops_eh) {
-        mTropospheric.model_hydrostatic = alt_eh.hydrostatic;
-        mTropospheric.model_wet         = alt_eh.wet;
-        mTropospheric.valid_model       = true;
-    } else {
-        mTropospheric.valid_model = false;
+        mTropospheric.valid_model          = false;
     }
 }
 
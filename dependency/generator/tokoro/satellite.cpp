@@ -3,6 +3,7 @@
 #include "coordinates/enu.hpp"
 #include "data/correction.hpp"
 #include "generator.hpp"
+#include "models/astro_cache.hpp"
 #include "models/helper.hpp"
 
 #include <cmath>
@@ -409,7 +410,8 @@ void Satellite::compute_sun_position() NOEXCEPT {
 void Satellite::compute_sun_position(SatelliteState& state) NOEXCEPT {
     VSCOPE_FUNCTIONF("%s, %s", mId.name(), state.reception_time.rtklib_time_string().c_str());
 
-    state.sun_moon_position = sun_and_moon_position_ecef(state.reception_time);
+    auto& astro_cache       = *mGenerator.mAstroCache;
+    state.sun_moon_position = astro_cache.sun_and_moon_position_ecef(state.reception_time);
 }
 
 void Satellite::compute_shapiro() NOEXCEPT {
@@ -422,15 +424,16 @@ void Satellite::compute_earth_solid_tides() NOEXCEPT {
     compute_earth_solid_tides(mNextState);
 }
 
-void Satellite::compute_phase_windup() NOEXCEPT {
-    compute_phase_windup(mCurrentState);
+void Satellite::compute_phase_windup(GroundContext const& ground) NOEXCEPT {
+    compute_phase_windup(mCurrentState, ground);
 
     // The phase windup is dependent on the previous state, instead of using the previous next
     // state, use the new current state
     mNextState.phase_windup = mCurrentState.phase_windup;
-    compute_phase_windup(mNextState);
+    compute_phase_windup(mNextState, ground);
 }
 
+
 void Satellite::compute_shapiro(SatelliteState& state) NOEXCEPT {
     VSCOPE_FUNCTIONF("%s, %s", mId.name(), state.reception_time.rtklib_time_string().c_str());
 
@@ -440,9 +443,9 @@ void Satellite::compute_shapiro(SatelliteState& state) NOEXCEPT {
 void Satellite::compute_earth_solid_tides(SatelliteState& state) NOEXCEPT {
     VSCOPE_FUNCTIONF("%s, %s", mId.name(), state.reception_time.rtklib_time_string().c_str());
 
-    // TODO(ewasjon): Use sun_moon_position in model_earth_solid_tides instead of re-computing it
-    state.earth_solid_tides = model_earth_solid_tides(state.reception_time, state,
-                                                      mGroundPositionEcef, mGroundPositionLlh);
+    state.earth_solid_tides =
+        model_earth_solid_tides(state.reception_time, state, state.sun_moon_position,
+                                mGroundPositionEcef, mGroundPositionLlh);
 
     VERBOSEF("disp x: %+.14f * %+.14f = %+.14f", state.earth_solid_tides.displacement_vector.x,
              state.true_line_of_sight.x,
@@ -456,12 +459,13 @@ void Satellite::compute_earth_solid_tides(SatelliteState& state) NOEXCEPT {
     VERBOSEF("solid tides: %+.14f", state.earth_solid_tides.displacement);
 }
 
-void Satellite::compute_phase_windup(SatelliteState& state) NOEXCEPT {
+void Satellite::compute_phase_windup(SatelliteState&      state,
+                                     GroundContext const& ground) NOEXCEPT {
     VSCOPE_FUNCTIONF("%s, %s", mId.name(), state.reception_time.rtklib_time_string().c_str());
 
-    // TODO(ewasjon): Use sun_moon_position in model_phase_windup instead of re-computing it
-    state.phase_windup = model_phase_windup(state.reception_time, state, mGroundPositionEcef,
-                                            mGroundPositionLlh, state.phase_windup);
+    state.phase_windup =
+        model_phase_windup(state.reception_time, state, state.sun_moon_position,
+                           mGroundPositionEcef, ground.receiver_antenna_basis, state.phase_windup);
     VERBOSEF("phase_windup: %+.14f", state.phase_windup.correction_sun);
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "constant.hpp"
 #include "data/correction.hpp"
+#include "ground.hpp"
 #include "models/earth_solid_tides.hpp"
 #include "models/phase_windup.hpp"
 #include "models/shapiro.hpp"
@@ -99,8 +100,8 @@ public:
         return mObservations;
     }
 
-    Observation& initialize_observation(SignalId signal_id) NOEXCEPT {
-        mObservations.emplace_back(*this, signal_id, mGroundPositionEcef);
+    Observation& initialize_observation(SignalId signal_id, GroundContext const& ground) NOEXCEPT {
+        mObservations.emplace_back(*this, signal_id, ground);
         return mObservations.back();
     }
 
@@ -108,9 +109,17 @@ public:
 
     void compute_shapiro() NOEXCEPT;
     void compute_earth_solid_tides() NOEXCEPT;
-    void compute_phase_windup() NOEXCEPT;
+    void compute_phase_windup(GroundContext const& ground) NOEXCEPT;
     void compute_sun_position() NOEXCEPT;
 
+    // Mapping by elevation, shared by all signals of the satellite
+    NODISCARD HydrostaticAndWetMapping const& tropospheric_mapping() const NOEXCEPT {
+        return mTroposphericMapping;
+    }
+    void set_tropospheric_mapping(HydrostaticAndWetMapping const& mapping) NOEXCEPT {
+        mTroposphericMapping = mapping;
+    }
+
     void datatrace_report() NOEXCEPT;
 
 protected:
@@ -128,7 +137,7 @@ protected:
 
     void compute_shapiro(SatelliteState& state) NOEXCEPT;
     void compute_earth_solid_tides(SatelliteState& state) NOEXCEPT;
-    void compute_phase_windup(SatelliteState& state) NOEXCEPT;
+    void compute_phase_windup(SatelliteState& state, GroundContext const& ground) NOEXCEPT;
     void compute_sun_position(SatelliteState& state) NOEXCEPT;
 
 private:
@@ -148,6 +157,8 @@ private:
     bool            mHasOrbitCorrection{false};
     bool            mHasClockCorrection{false};
 
+    HydrostaticAndWetMapping mTroposphericMapping{0.0, 0.0};
+
     std::vector<Observation> mObservations;
 
     Generator const& mGenerator;
@@ -20,6 +20,15 @@ StreamInputAdapter::~StreamInputAdapter() NOEXCEPT {
     }
 }
 
+bool StreamInputAdapter::set_read_target(ReadTarget* target) NOEXCEPT {
+    mStream->set_read_target(target);
+    return true;
+}
+
+std::chrono::steady_clock::time_point StreamInputAdapter::read_time() const NOEXCEPT {
+    return mStream->last_read_time();
+}
+
 bool StreamInputAdapter::do_schedule(scheduler::Scheduler& scheduler) NOEXCEPT {
     VSCOPE_FUNCTIONF("%p, stream=%s", &scheduler, mStream->id().c_str());
 
@@ -65,6 +74,19 @@ void StreamOutputAdapter::write(uint8_t const* buffer, size_t length) NOEXCEPT {
     mStream->write(buffer, length);
 }
 
+void StreamOutputAdapter::end_epoch() NOEXCEPT {
+    mStream->end_epoch();
+}
+
+void StreamOutputAdapter::set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT {
+    mStream->set_drop_policy(policy);
+}
+
+void StreamOutputAdapter::record_output_latency(
+    std::chrono::steady_clock::time_point read_time) NOEXCEPT {
+    mStream->record_output_latency(read_time);
+}
+
 bool StreamOutputAdapter::do_schedule(scheduler::Scheduler& scheduler) NOEXCEPT {
     VSCOPE_FUNCTIONF("%p, stream=%s", &scheduler, mStream->id().c_str());
     if (mStream->state() == Stream::State::Initial) {
@@ -0,0 +1,293 @@
+#include <io/datagram.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(io, datagram);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(io, datagram)
+
+namespace io {
+
+// Messages passed to a single sendmmsg
+static CONSTEXPR size_t SEND_BATCH = 64;
+// Segments in a single GSO send, the kernel limit is 64 on older kernels
+static CONSTEXPR size_t GSO_MAX_SEGMENTS = 64;
+// Payload of a single GSO send, it must fit in one IP packet before segmentation
+static CONSTEXPR size_t GSO_MAX_PAYLOAD = 65000;
+
+DatagramBatch::DatagramBatch(size_t count, size_t datagram_size) NOEXCEPT
+    : mDatagramSize(0),
+      mReceived(0),
+      mRequiredSize(0),
+      mTruncatedCount(0),
+      mIovecs(count),
+      mHeaders(count),
+      mSenders(count) {
+    VSCOPE_FUNCTIONF("%zu, %zu", count, datagram_size);
+    resize(datagram_size);
+}
+
+void DatagramBatch::resize(size_t datagram_size) NOEXCEPT {
+    mDatagramSize = datagram_size;
+    mBuffer.reset(new uint8_t[mIovecs.size() * datagram_size]);
+    for (size_t i = 0; i < mIovecs.size(); i++) {
+        mIovecs[i].iov_base = data(i);
+        mIovecs[i].iov_len  = mDatagramSize;
+    }
+}
+
+int DatagramBatch::receive(int fd) NOEXCEPT {
+    // Grow after the previous batch has been delivered, the buffer is reallocated
+    if (mRequiredSize > mDatagramSize) {
+        auto size = mRequiredSize < MAX_DATAGRAM_SIZE ? mRequiredSize : MAX_DATAGRAM_SIZE;
+        DEBUGF("datagram size %zu -> %zu bytes", mDatagramSize, size);
+        resize(size);
+    }
+
+    for (size_t i = 0; i < mHeaders.size(); i++) {
+        auto& header        = mHeaders[i].msg_hdr;
+        header              = {};
+        header.msg_iov      = &mIovecs[i];
+        header.msg_iovlen   = 1;
+        header.msg_name     = &mSenders[i];
+        header.msg_namelen  = sizeof(mSenders[i]);
+        mHeaders[i].msg_len = 0;
+    }
+
+    // With MSG_TRUNC `msg_len` is the real length of a datagram that did not fit
+    auto result = ::recvmmsg(fd, mHeaders.data(), static_cast<unsigned int>(mHeaders.size()),
+                             MSG_DONTWAIT | MSG_TRUNC, nullptr);
+    VERBOSEF("::recvmmsg(%d, %p, %zu, MSG_DONTWAIT | MSG_TRUNC, nullptr) = %d", fd,
+             mHeaders.data(), mHeaders.size(), result);
+    mReceived = result > 0 ? static_cast<size_t>(result) : 0;
+    for (size_t i = 0; i < mReceived; i++) {
+        if (!truncated(i)) continue;
+        WARNF("datagram of %u bytes truncated to %zu bytes, dropped", mHeaders[i].msg_len,
+              mDatagramSize);
+        mTruncatedCount++;
+        if (mHeaders[i].msg_len > mRequiredSize) mRequiredSize = mHeaders[i].msg_len;
+    }
+    return result;
+}
+
+size_t DatagramBatch::length(size_t index) const NOEXCEPT {
+    auto length = static_cast<size_t>(mHeaders[index].msg_len);
+    return length < mDatagramSize ? length : mDatagramSize;
+}
+
+bool DatagramBatch::truncated(size_t index) const NOEXCEPT {
+    return (mHeaders[index].msg_hdr.msg_flags & MSG_TRUNC) != 0 ||
+           mHeaders[index].msg_len > mDatagramSize;
+}
+
+bool DatagramBatch::same_sender(size_t a, size_t b) const NOEXCEPT {
+    auto length = sender_length(a);
+    return length == sender_length(b) && memcmp(&mSenders[a], &mSenders[b], length) == 0;
+}
+
+size_t DatagramBatch::coalesce(size_t begin, size_t end) NOEXCEPT {
+    size_t offset = begin * mDatagramSize;
+    for (size_t i = begin; i < end; i++) {
+        if (truncated(i)) continue;
+        auto length = this->length(i);
+        if (offset != i * mDatagramSize) {
+            memmove(&mBuffer[offset], data(i), length);
+        }
+        offset += length;
+    }
+    return offset - begin * mDatagramSize;
+}
+
+bool resolve_destination(std::string const& host, uint16_t port,
+                         DatagramDestination& destination) NOEXCEPT {
+    VSCOPE_FUNCTIONF("\"%s\", %u", host.c_str(), port);
+
+    struct addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    char port_str[16];
+    snprintf(port_str, sizeof(port_str), "%u", port);
+
+    struct addrinfo* res    = nullptr;
+    auto             result = ::getaddrinfo(host.c_str(), port_str, &hints, &res);
+    VERBOSEF("::getaddrinfo(\"%s\", \"%s\", %p, %p) = %d", host.c_str(), port_str, &hints, &res,
+             result);
+    if (result != 0) {
+        WARNF("failed to resolve \"%s\": %s", host.c_str(), gai_strerror(result));
+        return false;
+    }
+
+    auto found = false;
+    for (auto addr = res; addr != nullptr; addr = addr->ai_next) {
+        if (addr->ai_family != AF_INET && addr->ai_family != AF_INET6) continue;
+        destination        = {};
+        destination.length = addr->ai_addrlen;
+        memcpy(&destination.address, addr->ai_addr, addr->ai_addrlen);
+        found = true;
+        break;
+    }
+    ::freeaddrinfo(res);
+    return found;
+}
+
+int send_datagrams(int fd, struct iovec const* datagrams, size_t count,
+                   DatagramDestination const* destination) NOEXCEPT {
+    struct mmsghdr headers[SEND_BATCH];
+
+    size_t sent = 0;
+    while (sent < count) {
+        auto batch = count - sent < SEND_BATCH ? count - sent : SEND_BATCH;
+        for (size_t i = 0; i < batch; i++) {
+            auto& header      = headers[i].msg_hdr;
+            header            = {};
+            header.msg_iov    = const_cast<struct iovec*>(&datagrams[sent + i]);
+            header.msg_iovlen = 1;
+            if (destination) {
+                header.msg_name    = const_cast<sockaddr_storage*>(&destination->address);
+                header.msg_namelen = destination->length;
+            }
+        }
+
+        auto result = ::sendmmsg(fd, headers, static_cast<unsigned int>(batch), MSG_NOSIGNAL);
+        VERBOSEF("::sendmmsg(%d, %p, %zu, MSG_NOSIGNAL) = %d", fd, headers, batch, result);
+        if (result < 0) {
+            if (sent > 0) break;
+            return -1;
+        }
+
+        sent += static_cast<size_t>(result);
+        if (static_cast<size_t>(result) < batch) break;
+    }
+    return static_cast<int>(sent);
+}
+
+size_t send_to_all(int fd, uint8_t const* data, size_t length,
+                   DatagramDestination const* destinations, size_t count) NOEXCEPT {
+    struct iovec   iov{const_cast<uint8_t*>(data), length};
+    struct mmsghdr headers[SEND_BATCH];
+
+    size_t delivered = 0;
+    size_t next      = 0;
+    while (next < count) {
+        auto batch = count - next < SEND_BATCH ? count - next : SEND_BATCH;
+        for (size_t i = 0; i < batch; i++) {
+            auto& header       = headers[i].msg_hdr;
+            header             = {};
+            header.msg_iov     = &iov;
+            header.msg_iovlen  = 1;
+            header.msg_name    = const_cast<sockaddr_storage*>(&destinations[next + i].address);
+            header.msg_namelen = destinations[next + i].length;
+        }
+
+        auto result = ::sendmmsg(fd, headers, static_cast<unsigned int>(batch), MSG_NOSIGNAL);
+        VERBOSEF("::sendmmsg(%d, %p, %zu, MSG_NOSIGNAL) = %d", fd, headers, batch, result);
+        if (result < 0) {
+            // The first destination of the batch failed, skip it
+            WARNF("failed to send to destination %zu: " ERRNO_FMT, next, ERRNO_ARGS(errno));
+            next++;
+            continue;
+        }
+
+        delivered += static_cast<size_t>(result);
+        next += static_cast<size_t>(result);
+    }
+    return delivered;
+}
+
+static ssize_t send_segments_fallback(int fd, uint8_t const* data, size_t length,
+                                      size_t segment_size,
+                                      DatagramDestination const* destination) NOEXCEPT {
+    struct iovec datagrams[SEND_BATCH];
+
+    size_t sent = 0;
+    while (sent < length) {
+        size_t count  = 0;
+        size_t offset = sent;
+        while (count < SEND_BATCH && offset < length) {
+            auto size = length - offset < segment_size ? length - offset : segment_size;
+            datagrams[count].iov_base = const_cast<uint8_t*>(data + offset);
+            datagrams[count].iov_len  = size;
+            offset += size;
+            count++;
+        }
+
+        auto result = send_datagrams(fd, datagrams, count, destination);
+        if (result < 0) return sent > 0 ? static_cast<ssize_t>(sent) : -1;
+        for (int i = 0; i < result; i++) {
+            sent += datagrams[i].iov_len;
+        }
+        if (static_cast<size_t>(result) < count) break;
+    }
+    return static_cast<ssize_t>(sent);
+}
+
+ssize_t send_segments(int fd, uint8_t const* data, size_t length, size_t segment_size,
+                      DatagramDestination const* destination, bool& gso) NOEXCEPT {
+    if (segment_size == 0 || segment_size > 0xFFFF) {
+        errno = EINVAL;
+        return -1;
+    }
+
+#ifdef UDP_SEGMENT
+    auto per_send = (GSO_MAX_PAYLOAD / segment_size) * segment_size;
+    if (per_send > GSO_MAX_SEGMENTS * segment_size) per_send = GSO_MAX_SEGMENTS * segment_size;
+
+    size_t sent = 0;
+    while (gso && per_send > 0 && sent < length) {
+        auto size = length - sent < per_send ? length - sent : per_send;
+
+        struct iovec  iov{const_cast<uint8_t*>(data + sent), size};
+        struct msghdr header{};
+        header.msg_iov    = &iov;
+        header.msg_iovlen = 1;
+        if (destination) {
+            header.msg_name    = const_cast<sockaddr_storage*>(&destination->address);
+            header.msg_namelen = destination->length;
+        }
+
+        char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+        if (size > segment_size) {
+            header.msg_control    = control;
+            header.msg_controllen = sizeof(control);
+
+            auto     cmsg    = CMSG_FIRSTHDR(&header);
+            uint16_t value   = static_cast<uint16_t>(segment_size);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type  = UDP_SEGMENT;
+            cmsg->cmsg_len   = CMSG_LEN(sizeof(value));
+            memcpy(CMSG_DATA(cmsg), &value, sizeof(value));
+        }
+
+        auto result = ::sendmsg(fd, &header, MSG_NOSIGNAL);
+        VERBOSEF("::sendmsg(%d, %p, MSG_NOSIGNAL) = %zd", fd, &header, result);
+        if (result < 0) {
+            if (errno == EINVAL || errno == EIO || errno == EOPNOTSUPP || errno == ENOPROTOOPT) {
+                DEBUGF("UDP GSO not supported: " ERRNO_FMT, ERRNO_ARGS(errno));
+                gso = false;
+                break;
+            }
+            return sent > 0 ? static_cast<ssize_t>(sent) : -1;
+        }
+        sent += static_cast<size_t>(result);
+    }
+
+    if (sent >= length) return static_cast<ssize_t>(sent);
+    auto result =
+        send_segments_fallback(fd, data + sent, length - sent, segment_size, destination);
+    if (result < 0) return sent > 0 ? static_cast<ssize_t>(sent) : -1;
+    return static_cast<ssize_t>(sent) + result;
+#else
+    gso = false;
+    return send_segments_fallback(fd, data, length, segment_size, destination);
+#endif
+}
+
+}  // namespace io
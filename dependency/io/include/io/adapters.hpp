@@ -12,6 +12,9 @@ public:
     EXPLICIT StreamInputAdapter(std::shared_ptr<Stream> stream) NOEXCEPT;
     ~StreamInputAdapter() NOEXCEPT override;
 
+    NODISCARD bool set_read_target(ReadTarget* target) NOEXCEPT override;
+    NODISCARD std::chrono::steady_clock::time_point read_time() const NOEXCEPT override;
+
 protected:
     NODISCARD bool do_schedule(scheduler::Scheduler& scheduler) NOEXCEPT override;
     NODISCARD bool do_cancel(scheduler::Scheduler& scheduler) NOEXCEPT override;
@@ -28,6 +31,9 @@ public:
 
     NODISCARD char const* name() const NOEXCEPT override;
     void                  write(uint8_t const* buffer, size_t length) NOEXCEPT override;
+    void                  end_epoch() NOEXCEPT override;
+    void                  set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT override;
+    void record_output_latency(std::chrono::steady_clock::time_point read_time) NOEXCEPT override;
 
 protected:
     NODISCARD bool do_schedule(scheduler::Scheduler& scheduler) NOEXCEPT override;
@@ -0,0 +1,95 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace io {
+
+/// Datagrams received with a single `recvmmsg`. Every slot has a buffer of `datagram_size` bytes.
+/// The buffer is not initialized, so only the pages datagrams have been received into are resident
+/// and large slots cost address space rather than memory. A datagram larger than a slot is
+/// truncated and not delivered by `coalesce`; the slots then grow to fit it (up to
+/// `MAX_DATAGRAM_SIZE`) before the next receive, so only that datagram is lost.
+class DatagramBatch {
+public:
+    static CONSTEXPR size_t MAX_DATAGRAM_SIZE = 65535;
+
+    DatagramBatch(size_t count, size_t datagram_size) NOEXCEPT;
+
+    /// Receive up to `capacity()` datagrams without blocking. Returns the number of datagrams or -1
+    /// with `errno` set.
+    int receive(int fd) NOEXCEPT;
+
+    NODISCARD size_t   capacity() const NOEXCEPT { return mHeaders.size(); }
+    NODISCARD size_t   datagram_size() const NOEXCEPT { return mDatagramSize; }
+    NODISCARD size_t   size() const NOEXCEPT { return mReceived; }
+    NODISCARD uint8_t* data(size_t index) NOEXCEPT { return &mBuffer[index * mDatagramSize]; }
+    /// Received bytes, at most `datagram_size()`.
+    NODISCARD size_t   length(size_t index) const NOEXCEPT;
+    NODISCARD bool     truncated(size_t index) const NOEXCEPT;
+    /// Datagrams dropped because they did not fit in a slot.
+    NODISCARD uint64_t truncated_count() const NOEXCEPT { return mTruncatedCount; }
+
+    NODISCARD sockaddr_storage const& sender(size_t index) const NOEXCEPT {
+        return mSenders[index];
+    }
+    NODISCARD socklen_t sender_length(size_t index) const NOEXCEPT {
+        return mHeaders[index].msg_hdr.msg_namelen;
+    }
+
+    NODISCARD bool same_sender(size_t a, size_t b) const NOEXCEPT;
+
+    /// Move the received datagrams next to each other at the start of the buffer, so the batch can
+    /// be delivered with one call. Truncated datagrams are skipped. Returns the number of bytes.
+    NODISCARD size_t   coalesce() NOEXCEPT { return coalesce(0, mReceived); }
+    /// Same for the datagrams [begin, end), they are moved to `data(begin)`.
+    NODISCARD size_t   coalesce(size_t begin, size_t end) NOEXCEPT;
+    NODISCARD uint8_t* buffer() NOEXCEPT { return mBuffer.get(); }
+
+private:
+    void resize(size_t datagram_size) NOEXCEPT;
+
+    size_t                        mDatagramSize;
+    size_t                        mReceived;
+    size_t                        mRequiredSize;
+    uint64_t                      mTruncatedCount;
+    std::unique_ptr<uint8_t[]>    mBuffer;
+    std::vector<struct iovec>     mIovecs;
+    std::vector<struct mmsghdr>   mHeaders;
+    std::vector<sockaddr_storage> mSenders;
+};
+
+struct DatagramDestination {
+    sockaddr_storage address;
+    socklen_t        length;
+};
+
+/// Resolve `host` and `port` to the first IPv4 or IPv6 address.
+NODISCARD bool resolve_destination(std::string const& host, uint16_t port,
+                                   DatagramDestination& destination) NOEXCEPT;
+
+/// Send `count` datagrams with as few `sendmmsg` calls as possible, to `destination` or to the
+/// connected peer if it is null. Returns the number of datagrams sent or -1 with `errno` set if
+/// none could be sent.
+int send_datagrams(int fd, struct iovec const* datagrams, size_t count,
+                   DatagramDestination const* destination) NOEXCEPT;
+
+/// Send the same datagram to every destination with `sendmmsg`. A destination that fails is
+/// skipped. Returns the number of destinations the datagram was sent to.
+size_t send_to_all(int fd, uint8_t const* data, size_t length,
+                   DatagramDestination const* destinations, size_t count) NOEXCEPT;
+
+/// Send `data` as datagrams of `segment_size` bytes. With `gso` set the segmentation is done by the
+/// kernel (`UDP_SEGMENT`); if the socket does not support it `gso` is cleared and the datagrams are
+/// sent with `send_datagrams`. Returns the number of bytes sent or -1 with `errno` set.
+ssize_t send_segments(int fd, uint8_t const* data, size_t length, size_t segment_size,
+                      DatagramDestination const* destination, bool& gso) NOEXCEPT;
+
+}  // namespace io
@@ -1,6 +1,7 @@
 #pragma once
 #include <core/core.hpp>
 
+#include <chrono>
 #include <functional>
 #include <string>
 
@@ -9,6 +10,7 @@ class Scheduler;
 }
 
 namespace io {
+class ReadTarget;
 class Input {
 public:
     EXPLICIT Input() NOEXCEPT;
@@ -20,6 +22,15 @@ public:
     std::function<void(Input&, uint8_t*, size_t)> callback;
     std::function<void()>                         on_complete;
 
+    /// Read directly into `target` if the input supports it, see `Stream::set_read_target`.
+    NODISCARD virtual bool set_read_target(ReadTarget*) NOEXCEPT { return false; }
+
+    /// When the data passed to the current callback was read, a default time point if the input
+    /// does not timestamp its reads.
+    NODISCARD virtual std::chrono::steady_clock::time_point read_time() const NOEXCEPT {
+        return {};
+    }
+
     NODISCARD std::string const& event_name() const NOEXCEPT { return mEventName; }
 
     void set_event_name(std::string const& name) NOEXCEPT {
@@ -1,5 +1,8 @@
 #pragma once
 #include <core/core.hpp>
+#include <io/write_buffer.hpp>
+
+#include <chrono>
 
 namespace scheduler {
 class Scheduler;
@@ -18,6 +21,14 @@ public:
 
     virtual void write(uint8_t const* buffer, size_t length) NOEXCEPT = 0;
 
+    /// Mark the last written buffer as the end of an epoch, see `WriteBuffer::DropPolicy`.
+    virtual void end_epoch() NOEXCEPT {}
+    /// Outputs without a write buffer ignore the drop policy.
+    virtual void set_drop_policy(WriteBuffer::DropPolicy) NOEXCEPT {}
+    /// The last written buffer was generated from input read at `read_time`, see
+    /// `Stream::output_latency`. Outputs without a stream do not measure it.
+    virtual void record_output_latency(std::chrono::steady_clock::time_point) NOEXCEPT {}
+
 protected:
     NODISCARD virtual bool do_schedule(scheduler::Scheduler&) NOEXCEPT { return true; }
     NODISCARD virtual bool do_cancel(scheduler::Scheduler&) NOEXCEPT { return true; }
@@ -17,6 +17,9 @@ public:
     bool schedule_all(scheduler::Scheduler& scheduler) NOEXCEPT;
     void cancel_all() NOEXCEPT;
 
+    /// Log the statistics of every stream that has any.
+    void log_stats() const NOEXCEPT;
+
 private:
     std::unordered_map<std::string, std::shared_ptr<Stream>> mStreams;
 };
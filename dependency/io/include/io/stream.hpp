@@ -1,10 +1,12 @@
 #pragma once
 #include <core/core.hpp>
+#include <io/write_buffer.hpp>
 
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace scheduler {
@@ -17,6 +19,47 @@ namespace io {
 struct ReadBufferConfig {
     size_t                    min_bytes = 1;
     std::chrono::milliseconds timeout   = {};
+    /// Timestamp every read when it returns and measure `Stream::read_callback_latency`, and the
+    /// `Stream::output_latency` of the streams the data ends up written to.
+    bool                      timestamp = false;
+    /// Datagram streams: datagrams received with one `recvmmsg` and the initial size of each, 0
+    /// uses the stream default. Larger datagrams are dropped and the size grows to fit them.
+    size_t datagrams     = 0;
+    size_t datagram_size = 0;
+};
+
+/// Latency measured from the time a read returned, coalesced reads are measured from the oldest
+/// byte. See `Stream::read_callback_latency` and `Stream::output_latency`.
+struct LatencyStats {
+    uint64_t                 count = 0;
+    std::chrono::nanoseconds last  = {};
+    std::chrono::nanoseconds max   = {};
+    std::chrono::nanoseconds total = {};
+
+    void add(std::chrono::steady_clock::time_point read_time) NOEXCEPT {
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - read_time);
+        count++;
+        last = latency;
+        total += latency;
+        if (latency > max) max = latency;
+    }
+
+    NODISCARD std::chrono::nanoseconds mean() const NOEXCEPT {
+        return count > 0 ? total / static_cast<int64_t>(count) : std::chrono::nanoseconds{};
+    }
+};
+
+/// Destination a stream reads into directly, e.g. the free space of a parser buffer, so data is
+/// copied once between the kernel and the decoder.
+class ReadTarget {
+public:
+    virtual ~ReadTarget() = default;
+
+    /// Contiguous free space to read into. Returns its length, zero if there is none.
+    virtual size_t read_space(uint8_t*& data) NOEXCEPT = 0;
+    /// The first `length` bytes of the space returned by `read_space` have been filled.
+    virtual void commit_read(size_t length) NOEXCEPT = 0;
 };
 
 class Stream {
@@ -39,11 +82,42 @@ public:
     virtual bool           cancel()                                             = 0;
     virtual void           write(uint8_t const* buffer, size_t length) NOEXCEPT = 0;
 
-    NODISCARD virtual size_t pending_writes() const NOEXCEPT { return 0; }
+    NODISCARD virtual size_t   pending_writes() const NOEXCEPT { return 0; }
+    /// Messages (and their bytes) dropped because the write buffer was full.
+    NODISCARD virtual uint64_t dropped_messages() const NOEXCEPT { return 0; }
+    NODISCARD virtual uint64_t dropped_bytes() const NOEXCEPT { return 0; }
+
+    /// Mark the last written message as the end of an epoch, see `WriteBuffer::DropPolicy`.
+    virtual void end_epoch() NOEXCEPT {}
+    /// Streams without a write buffer ignore the drop policy.
+    virtual void set_drop_policy(WriteBuffer::DropPolicy) NOEXCEPT {}
 
     ReadCallbackHandle on_read(ReadCallback cb) NOEXCEPT;
     void               remove_on_read(ReadCallbackHandle handle) NOEXCEPT;
 
+    /// Read into `target` instead of the stream's own buffer. Read callbacks still get every
+    /// chunk, as a pointer into the target. The target is only used when reads are not batched
+    /// (`min_bytes` of at most one).
+    void                  set_read_target(ReadTarget* target) NOEXCEPT { mReadTarget = target; }
+    NODISCARD ReadTarget* read_target() const NOEXCEPT { return mReadTarget; }
+
+    /// When the data passed to the current read callback was read, if reads are timestamped.
+    NODISCARD std::chrono::steady_clock::time_point last_read_time() const NOEXCEPT {
+        return mLastReadTime;
+    }
+    /// Time from a read returning until its data has been through all read callbacks. The callbacks
+    /// usually parse the data and queue the messages, writing the outputs is not included.
+    NODISCARD LatencyStats const& read_callback_latency() const NOEXCEPT {
+        return mReadCallbackLatency;
+    }
+
+    /// Bytes generated from input read at `read_time` have been written to this stream.
+    void record_output_latency(std::chrono::steady_clock::time_point read_time) NOEXCEPT {
+        mOutputLatency.add(read_time);
+    }
+    /// Time from the input read until the output written from it was handed to this stream.
+    NODISCARD LatencyStats const& output_latency() const NOEXCEPT { return mOutputLatency; }
+
     std::function<void()>                                            on_complete;
     std::function<void(Stream&, int error_code, std::string const&)> on_error;
 
@@ -66,9 +140,24 @@ protected:
     std::vector<CallbackEntry> mReadCallbacks;
     ReadCallbackHandle         mNextHandle = 1;
 
+    ReadTarget* mReadTarget  = nullptr;
+    uint8_t*    mTargetSpace = nullptr;
+
+    std::chrono::steady_clock::time_point mLastReadTime;
+    std::chrono::steady_clock::time_point mBufferedReadTime;
+    LatencyStats                          mReadCallbackLatency;
+    LatencyStats                          mOutputLatency;
+
+    /// Where to read the next chunk of at most `length` bytes: the free space of the read target
+    /// or `buffer`. The chunk is then passed to `on_raw_read`.
+    NODISCARD std::pair<uint8_t*, size_t> read_space(uint8_t* buffer, size_t length) NOEXCEPT;
+
     void on_raw_read(uint8_t* data, size_t length) NOEXCEPT;
     void flush_read_buffer() NOEXCEPT;
-    void deliver_read(uint8_t* data, size_t length) NOEXCEPT;
+    void deliver_read(uint8_t* data, size_t length,
+                      std::chrono::steady_clock::time_point read_time) NOEXCEPT;
+    /// Called every `timeout` of the read buffer configuration.
+    virtual void on_read_timeout() NOEXCEPT { flush_read_buffer(); }
 
     void set_error(int error_code, std::string const& message) NOEXCEPT;
     void set_disconnected() NOEXCEPT;
@@ -26,7 +26,18 @@ public:
     void           write(uint8_t const* buffer, size_t length) NOEXCEPT override;
 
     NODISCARD int    fd() const NOEXCEPT { return mConfig.fd; }
-    NODISCARD size_t pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD size_t   pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD uint64_t dropped_messages() const NOEXCEPT override {
+        return mWriteBuffer.dropped_messages();
+    }
+    NODISCARD uint64_t dropped_bytes() const NOEXCEPT override {
+        return mWriteBuffer.dropped_bytes();
+    }
+
+    void end_epoch() NOEXCEPT override { mWriteBuffer.end_epoch(); }
+    void set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT override {
+        mWriteBuffer.set_drop_policy(policy);
+    }
 
 private:
     FdConfig                                            mConfig;
@@ -28,7 +28,18 @@ public:
 
     NODISCARD std::string const& slave_path() const NOEXCEPT { return mSlavePath; }
     NODISCARD std::string const& link_path() const NOEXCEPT { return mConfig.link_path; }
-    NODISCARD size_t pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD size_t   pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD uint64_t dropped_messages() const NOEXCEPT override {
+        return mWriteBuffer.dropped_messages();
+    }
+    NODISCARD uint64_t dropped_bytes() const NOEXCEPT override {
+        return mWriteBuffer.dropped_bytes();
+    }
+
+    void end_epoch() NOEXCEPT override { mWriteBuffer.end_epoch(); }
+    void set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT override {
+        mWriteBuffer.set_drop_policy(policy);
+    }
 
 private:
     bool configure_termios() NOEXCEPT;
@@ -19,6 +19,10 @@ struct SerialConfig {
     StopBits         stop_bits   = StopBits::ONE;
     ParityBit        parity_bit  = ParityBit::NONE;
     bool             raw         = false;
+    /// Low-latency profile: the port is switched to `ASYNC_LOW_LATENCY`, the tty wakes the reader
+    /// once `read_config.min_bytes` have arrived (`VMIN`) instead of the stream coalescing them,
+    /// `read_config.timeout` reads whatever is left and reads are timestamped.
+    bool             low_latency = false;
     ReadBufferConfig read_config = {};
 };
 
@@ -32,10 +36,26 @@ public:
     void           write(uint8_t const* buffer, size_t length) NOEXCEPT override;
 
     NODISCARD std::string const& device() const NOEXCEPT { return mConfig.device; }
-    NODISCARD size_t pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD size_t   pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD uint64_t dropped_messages() const NOEXCEPT override {
+        return mWriteBuffer.dropped_messages();
+    }
+    NODISCARD uint64_t dropped_bytes() const NOEXCEPT override {
+        return mWriteBuffer.dropped_bytes();
+    }
+
+    void end_epoch() NOEXCEPT override { mWriteBuffer.end_epoch(); }
+    void set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT override {
+        mWriteBuffer.set_drop_policy(policy);
+    }
+
+protected:
+    void on_read_timeout() NOEXCEPT override;
 
 private:
     bool configure_termios() NOEXCEPT;
+    void set_low_latency() NOEXCEPT;
+    void read_once() NOEXCEPT;
 
     SerialConfig                                        mConfig;
     int                                                 mFd = -1;
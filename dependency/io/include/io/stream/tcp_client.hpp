@@ -31,15 +31,33 @@ public:
     NODISCARD std::string const& host() const NOEXCEPT { return mConfig.host; }
     NODISCARD uint16_t           port() const NOEXCEPT { return mConfig.port; }
     NODISCARD std::string const& path() const NOEXCEPT { return mConfig.path; }
-    NODISCARD size_t pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD size_t   pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD uint64_t dropped_messages() const NOEXCEPT override {
+        return mWriteBuffer.dropped_messages();
+    }
+    NODISCARD uint64_t dropped_bytes() const NOEXCEPT override {
+        return mWriteBuffer.dropped_bytes();
+    }
+
+    void end_epoch() NOEXCEPT override { mWriteBuffer.end_epoch(); }
+    void set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT override {
+        mWriteBuffer.set_drop_policy(policy);
+    }
 
 private:
+    void on_receive(uint8_t* data, ssize_t result) NOEXCEPT;
+    void on_send(ssize_t result) NOEXCEPT;
+    void send_write_buffer() NOEXCEPT;
+
     TcpClientConfig mConfig;
 
     std::unique_ptr<scheduler::TcpConnectTask> mConnectTask;
     WriteBuffer                                mWriteBuffer;
     bool                                       mWriteRegistered = false;
-    uint8_t                                    mReadBuf[4096];
+    // The connection is read and written with io_uring requests, see `Scheduler::receive`
+    bool    mCompletions = false;
+    size_t  mSendQueued  = 0;  // bytes in the send queue of the scheduler
+    uint8_t mReadBuf[4096];
 };
 
 }  // namespace io
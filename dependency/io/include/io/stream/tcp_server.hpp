@@ -23,6 +23,13 @@ public:
     bool           cancel() override;
     void           write(uint8_t const* buffer, size_t length) NOEXCEPT override;
 
+    NODISCARD uint64_t dropped_messages() const NOEXCEPT override;
+    NODISCARD uint64_t dropped_bytes() const NOEXCEPT override;
+
+    /// Applies to every client, including clients that connect later.
+    void end_epoch() NOEXCEPT override;
+    void set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT override;
+
     NODISCARD uint16_t port() const NOEXCEPT;
 
 private:
@@ -33,12 +40,17 @@ private:
         void write(uint8_t const* data, size_t length) NOEXCEPT;
         void destroy() NOEXCEPT;
 
-        int fd() const NOEXCEPT { return mFd; }
+        int                fd() const NOEXCEPT { return mFd; }
+        WriteBuffer&       write_buffer() NOEXCEPT { return mWriteBuffer; }
+        WriteBuffer const& write_buffer() const NOEXCEPT { return mWriteBuffer; }
 
     private:
         void on_read() NOEXCEPT;
         void on_write() NOEXCEPT;
         void on_error() NOEXCEPT;
+        void on_receive(uint8_t* data, ssize_t result) NOEXCEPT;
+        void on_send(ssize_t result) NOEXCEPT;
+        void send_write_buffer() NOEXCEPT;
 
         TcpServerStream&                   mServer;
         int                                mFd;
@@ -46,6 +58,8 @@ private:
         WriteBuffer                        mWriteBuffer;
         bool                               mWriteRegistered = false;
         bool                               mDestroying      = false;
+        bool                               mCompletions     = false;
+        size_t                             mSendQueued      = 0;
     };
 
     void remove_client(int fd) NOEXCEPT;
@@ -53,6 +67,10 @@ private:
     std::unique_ptr<scheduler::SocketListenerTask> mListenerTask;
     std::vector<std::unique_ptr<Client>>           mClients;
     uint8_t                                        mReadBuf[4096];
+    WriteBuffer::DropPolicy                        mDropPolicy = WriteBuffer::DropPolicy::Message;
+    // Drops of clients that have been removed
+    uint64_t mRemovedDroppedMessages = 0;
+    uint64_t mRemovedDroppedBytes    = 0;
 };
 
 }  // namespace io
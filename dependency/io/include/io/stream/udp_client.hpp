@@ -1,10 +1,12 @@
 #pragma once
+#include <io/datagram.hpp>
 #include <io/stream.hpp>
 #include <io/write_buffer.hpp>
 
 #include <memory>
 #include <string>
 #include <sys/socket.h>
+#include <vector>
 
 namespace scheduler {
 class OwnedFileDescriptorTask;
@@ -17,6 +19,12 @@ struct UdpClientConfig {
     uint16_t         port = 0;
     std::string      path;
     ReadBufferConfig read_config = {};
+    /// Additional "<host>:<port>" destinations. Every write is sent to `host` and all of them with
+    /// one `sendmmsg`, without buffering: a destination that would block is skipped.
+    std::vector<std::string> fanout;
+    /// Writes larger than this are sent as datagrams of this size, with UDP GSO when the kernel
+    /// supports it. Zero sends every write as one datagram.
+    size_t segment_size = 0;
 };
 
 class UdpClientStream : public Stream {
@@ -31,16 +39,32 @@ public:
     NODISCARD std::string const& host() const NOEXCEPT { return mConfig.host; }
     NODISCARD uint16_t           port() const NOEXCEPT { return mConfig.port; }
     NODISCARD std::string const& path() const NOEXCEPT { return mConfig.path; }
-    NODISCARD size_t pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD size_t   pending_writes() const NOEXCEPT override { return mWriteBuffer.size(); }
+    NODISCARD uint64_t dropped_messages() const NOEXCEPT override {
+        return mWriteBuffer.dropped_messages();
+    }
+    NODISCARD uint64_t dropped_bytes() const NOEXCEPT override {
+        return mWriteBuffer.dropped_bytes();
+    }
+
+    void end_epoch() NOEXCEPT override { mWriteBuffer.end_epoch(); }
+    void set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT override {
+        mWriteBuffer.set_drop_policy(policy);
+    }
 
 private:
     UdpClientConfig mConfig;
 
+    void send_fanout(uint8_t const* data, size_t length) NOEXCEPT;
+    void register_write() NOEXCEPT;
+
     int                                                 mFd = -1;
     std::unique_ptr<scheduler::OwnedFileDescriptorTask> mSocketTask;
     WriteBuffer                                         mWriteBuffer;
     bool                                                mWriteRegistered = false;
-    uint8_t                                             mReadBuf[65535];
+    bool                                                mGso             = true;
+    std::vector<DatagramDestination>                    mDestinations;
+    DatagramBatch                                       mBatch;
 };
 
 }  // namespace io
@@ -1,4 +1,5 @@
 #pragma once
+#include <io/datagram.hpp>
 #include <io/stream.hpp>
 
 #include <memory>
@@ -11,6 +12,8 @@ class UdpSocketListenerTask;
 
 namespace io {
 
+/// Datagrams are delivered in batches of consecutive datagrams from the same sender. `write` sends
+/// to the sender of the most recently delivered batch, i.e. the current one inside a read callback.
 class UdpServerStream : public Stream {
 public:
     UdpServerStream(std::string id, std::unique_ptr<scheduler::UdpSocketListenerTask> listener,
@@ -27,7 +30,7 @@ private:
     std::unique_ptr<scheduler::UdpSocketListenerTask> mListenerTask;
     sockaddr_storage                                  mLastSender{};
     socklen_t                                         mLastSenderLen = 0;
-    uint8_t                                           mReadBuf[65535];
+    DatagramBatch                                     mBatch;
 };
 
 }  // namespace io
@@ -1,4 +1,5 @@
 #pragma once
+#include <io/datagram.hpp>
 #include <io/input.hpp>
 #include <io/output.hpp>
 
@@ -33,7 +34,7 @@ private:
     uint16_t    mPort;
 
     std::unique_ptr<scheduler::UdpSocketListenerTask> mListenerTask;
-    uint8_t                                           mBuffer[4096];
+    DatagramBatch                                     mBatch;
 };
 
 /// An output that sends UDP packets to a server.
@@ -3,27 +3,96 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <sys/types.h>
 #include <utility>
 #include <vector>
 
+struct iovec;
+
 namespace io {
 
+/// Pending writes of a stream. Data is kept as a ring of slices, one per enqueued message, so it
+/// can be written with `writev` without moving it. Messages enqueued with `enqueue_message` are
+/// never split when the buffer is full: whole messages (or whole epochs) are dropped, oldest first.
+/// A message that has been partially written is never dropped, the receiver would lose sync.
 class WriteBuffer {
 public:
+    enum class DropPolicy {
+        Message,  // drop the oldest messages
+        Epoch,    // drop the oldest messages up to the end of their epoch
+    };
+
     EXPLICIT WriteBuffer(size_t max_size = 64 * 1024) NOEXCEPT;
 
-    void                              enqueue(uint8_t const* data, size_t length) NOEXCEPT;
+    /// Enqueue bytes without message boundaries, they are appended to the last unframed slice. When
+    /// full, the oldest bytes are discarded.
+    void enqueue(uint8_t const* data, size_t length) NOEXCEPT;
+
+    /// Enqueue a whole message of which the first `written` bytes are already written. The rest of
+    /// a partially written message is kept even if older messages have to be dropped for it.
+    void enqueue_message(uint8_t const* data, size_t length, size_t written = 0) NOEXCEPT;
+
+    /// Mark the last enqueued message as the last message of an epoch.
+    void end_epoch() NOEXCEPT;
+
+    void                 set_drop_policy(DropPolicy policy) NOEXCEPT { mDropPolicy = policy; }
+    NODISCARD DropPolicy drop_policy() const NOEXCEPT { return mDropPolicy; }
+
+    /// The first slice.
     std::pair<uint8_t const*, size_t> peek() const NOEXCEPT;
-    void                              consume(size_t bytes) NOEXCEPT;
+    /// Fill up to `count` iovecs with the pending slices, returns the number used.
+    size_t gather(struct iovec* iov, size_t count) const NOEXCEPT;
+    void   consume(size_t bytes) NOEXCEPT;
 
-    NODISCARD size_t size() const NOEXCEPT { return mBuffer.size() - mReadPos; }
-    NODISCARD bool   empty() const NOEXCEPT { return mReadPos >= mBuffer.size(); }
+    /// Write as much as possible to `fd` with a single `writev`, the written bytes are consumed.
+    /// Returns the result of `writev`.
+    ssize_t write_to(int fd) NOEXCEPT;
+
+    /// Pass whole slices of up to about `limit` bytes to `send`, which copies them, e.g. to the
+    /// io_uring send queue of the scheduler. They are consumed if `send` returns true. Returns the
+    /// number of bytes passed.
+    size_t send_to(size_t limit,
+                   std::function<bool(struct iovec const*, size_t)> const& send) NOEXCEPT;
+
+    NODISCARD size_t size() const NOEXCEPT { return mSize; }
+    NODISCARD size_t max_size() const NOEXCEPT { return mMaxSize; }
+    NODISCARD bool   empty() const NOEXCEPT { return mSize == 0; }
+    NODISCARD size_t message_count() const NOEXCEPT { return mCount; }
     void             clear() NOEXCEPT;
 
+    NODISCARD uint64_t dropped_messages() const NOEXCEPT { return mDroppedMessages; }
+    NODISCARD uint64_t dropped_bytes() const NOEXCEPT { return mDroppedBytes; }
+
 private:
-    std::vector<uint8_t> mBuffer;
-    size_t               mReadPos;
-    size_t               mMaxSize;
+    struct Slice {
+        std::vector<uint8_t> data;
+        size_t               offset;
+        bool                 framed;
+        bool                 started;  // partially written
+        bool                 epoch_end;
+    };
+
+    NODISCARD size_t slice_length(size_t index) const NOEXCEPT;
+    Slice&           slice(size_t index) NOEXCEPT;
+    Slice const&     slice(size_t index) const NOEXCEPT;
+    Slice&           push_slice(bool framed) NOEXCEPT;
+    void             pop_front() NOEXCEPT;
+    void             remove(size_t index) NOEXCEPT;
+    void             recycle(std::vector<uint8_t>& data) NOEXCEPT;
+    void             discard_bytes(size_t bytes) NOEXCEPT;
+    NODISCARD bool   drop_oldest() NOEXCEPT;
+
+    std::vector<Slice>                mSlices;
+    size_t                            mFirst;
+    size_t                            mCount;
+    size_t                            mSize;
+    size_t                            mMaxSize;
+    DropPolicy                        mDropPolicy;
+    std::vector<std::vector<uint8_t>> mSpare;
+
+    uint64_t mDroppedMessages;
+    uint64_t mDroppedBytes;
 };
 
 }  // namespace io
@@ -54,4 +54,42 @@ void StreamRegistry::cancel_all() NOEXCEPT {
     }
 }
 
+void StreamRegistry::log_stats() const NOEXCEPT {
+    for (auto const& is : mStreams) {
+        auto& id      = is.first;
+        auto& stream  = *is.second;
+        auto& latency = stream.read_callback_latency();
+        if (latency.count > 0) {
+            using std::chrono::microseconds;
+            using std::chrono::duration_cast;
+            INFOF("stream %s: read callback latency last %lld us, mean %lld us, max %lld us (%llu)",
+                  id.c_str(),
+                  static_cast<long long>(duration_cast<microseconds>(latency.last).count()),
+                  static_cast<long long>(duration_cast<microseconds>(latency.mean()).count()),
+                  static_cast<long long>(duration_cast<microseconds>(latency.max).count()),
+                  static_cast<unsigned long long>(latency.count));
+        }
+
+        auto& output = stream.output_latency();
+        if (output.count > 0) {
+            using std::chrono::microseconds;
+            using std::chrono::duration_cast;
+            INFOF("stream %s: input-to-output latency last %lld us, mean %lld us, max %lld us "
+                  "(%llu)",
+                  id.c_str(),
+                  static_cast<long long>(duration_cast<microseconds>(output.last).count()),
+                  static_cast<long long>(duration_cast<microseconds>(output.mean()).count()),
+                  static_cast<long long>(duration_cast<microseconds>(output.max).count()),
+                  static_cast<unsigned long long>(output.count));
+        }
+
+        if (stream.pending_writes() > 0 || stream.dropped_messages() > 0) {
+            INFOF("stream %s: pending writes %zu bytes, dropped %llu messages (%llu bytes)",
+                  id.c_str(), stream.pending_writes(),
+                  static_cast<unsigned long long>(stream.dropped_messages()),
+                  static_cast<unsigned long long>(stream.dropped_bytes()));
+        }
+    }
+}
+
 }  // namespace io
@@ -39,10 +39,40 @@ void Stream::remove_on_read(ReadCallbackHandle handle) NOEXCEPT {
                          mReadCallbacks.end());
 }
 
+std::pair<uint8_t*, size_t> Stream::read_space(uint8_t* buffer, size_t length) NOEXCEPT {
+    mTargetSpace = nullptr;
+    if (mReadTarget && mReadBuffer.empty() && mReadConfig.min_bytes <= 1) {
+        uint8_t* space  = nullptr;
+        auto     target = mReadTarget->read_space(space);
+        if (target > 0) {
+            mTargetSpace = space;
+            return {space, target < length ? target : length};
+        }
+    }
+    return {buffer, length};
+}
+
 void Stream::on_raw_read(uint8_t* data, size_t length) NOEXCEPT {
     TRACEF("%p, %zu", data, length);
-    mReadBuffer.insert(mReadBuffer.end(), data, data + length);
+    // Streams call this as soon as the read returns
+    std::chrono::steady_clock::time_point read_time;
+    if (mReadConfig.timestamp) read_time = std::chrono::steady_clock::now();
+
+    if (mTargetSpace && data == mTargetSpace) {
+        mTargetSpace = nullptr;
+        mReadTarget->commit_read(length);
+        deliver_read(data, length, read_time);
+        return;
+    }
 
+    // Nothing is pending, deliver the chunk without copying it
+    if (mReadBuffer.empty() && length >= mReadConfig.min_bytes) {
+        deliver_read(data, length, read_time);
+        return;
+    }
+
+    if (mReadBuffer.empty()) mBufferedReadTime = read_time;
+    mReadBuffer.insert(mReadBuffer.end(), data, data + length);
     if (mReadBuffer.size() >= mReadConfig.min_bytes) {
         flush_read_buffer();
     }
@@ -51,15 +81,19 @@ void Stream::on_raw_read(uint8_t* data, size_t length) NOEXCEPT {
 void Stream::flush_read_buffer() NOEXCEPT {
     if (mReadBuffer.empty()) return;
     VERBOSEF("flushing read buffer, size=%zu", mReadBuffer.size());
-    deliver_read(mReadBuffer.data(), mReadBuffer.size());
+    deliver_read(mReadBuffer.data(), mReadBuffer.size(), mBufferedReadTime);
     mReadBuffer.clear();
 }
 
-void Stream::deliver_read(uint8_t* data, size_t length) NOEXCEPT {
+void Stream::deliver_read(uint8_t* data, size_t length,
+                          std::chrono::steady_clock::time_point read_time) NOEXCEPT {
     TRACEF("%p, %zu to %zu callbacks", data, length, mReadCallbacks.size());
+    mLastReadTime = read_time;
     for (auto& entry : mReadCallbacks) {
         entry.callback(*this, data, length);
     }
+
+    if (mReadConfig.timestamp) mReadCallbackLatency.add(read_time);
 }
 
 void Stream::set_error(int error_code, std::string const& message) NOEXCEPT {
@@ -82,7 +116,7 @@ bool Stream::schedule_read_timeout(scheduler::Scheduler& scheduler) NOEXCEPT {
              static_cast<long long>(mReadConfig.timeout.count()));
     mReadTimeoutTask.reset(new scheduler::PeriodicTask(mReadConfig.timeout));
     mReadTimeoutTask->callback = [this]() {
-        flush_read_buffer();
+        on_read_timeout();
     };
     return mReadTimeoutTask->schedule(scheduler);
 }
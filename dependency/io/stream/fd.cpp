@@ -40,10 +40,11 @@ bool FdStream::schedule(scheduler::Scheduler& scheduler) {
     mSocketTask.reset(new scheduler::OwnedFileDescriptorTask(mConfig.fd));
     mSocketTask->set_event_name("fd:" + mId);
     mSocketTask->on_read = [this](scheduler::OwnedFileDescriptorTask&) {
-        auto result = ::read(mConfig.fd, mReadBuf, sizeof(mReadBuf));
-        VERBOSEF("::read(%d, %p, %zu) = %zd", mConfig.fd, mReadBuf, sizeof(mReadBuf), result);
+        auto space  = read_space(mReadBuf, sizeof(mReadBuf));
+        auto result = ::read(mConfig.fd, space.first, space.second);
+        VERBOSEF("::read(%d, %p, %zu) = %zd", mConfig.fd, space.first, space.second, result);
         if (result > 0) {
-            on_raw_read(mReadBuf, result);
+            on_raw_read(space.first, result);
         } else if (result == 0) {
             DEBUGF("fd %d closed", mConfig.fd);
             set_disconnected();
@@ -54,17 +55,13 @@ bool FdStream::schedule(scheduler::Scheduler& scheduler) {
     };
     mSocketTask->on_write = [this](scheduler::OwnedFileDescriptorTask&) {
         while (!mWriteBuffer.empty()) {
-            auto  peek   = mWriteBuffer.peek();
-            auto& data   = peek.first;
-            auto& len    = peek.second;
-            auto  result = ::write(mConfig.fd, data, len);
-            VERBOSEF("::write(%d, %p, %zu) = %zd", mConfig.fd, data, len, result);
+            auto result = mWriteBuffer.write_to(mConfig.fd);
+            VERBOSEF("writev(%d) = %zd", mConfig.fd, result);
             if (result < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) break;
                 WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
                 return;
             }
-            mWriteBuffer.consume(result);
         }
         if (mWriteBuffer.empty() && mWriteRegistered) {
             mSocketTask->update_interests(scheduler::EventInterest::Read |
@@ -112,6 +109,7 @@ bool FdStream::cancel() {
 void FdStream::write(uint8_t const* data, size_t length) NOEXCEPT {
     TRACEF("%p, %zu", data, length);
 
+    size_t written = 0;
     if (mWriteBuffer.empty()) {
         auto result = ::write(mConfig.fd, data, length);
         VERBOSEF("::write(%d, %p, %zu) = %zd", mConfig.fd, data, length, result);
@@ -124,11 +122,10 @@ void FdStream::write(uint8_t const* data, size_t length) NOEXCEPT {
             }
         }
         if (static_cast<size_t>(result) == length) return;
-        data += result;
-        length -= result;
+        written = static_cast<size_t>(result);
     }
 
-    mWriteBuffer.enqueue(data, length);
+    mWriteBuffer.enqueue_message(data, length, written);
     if (!mWriteRegistered && mSocketTask) {
         mSocketTask->update_interests(
             scheduler::EventInterest::Read | scheduler::EventInterest::Write |
@@ -59,10 +59,11 @@ bool FileStream::schedule(scheduler::Scheduler& scheduler) {
             mReadTask.reset(new scheduler::PeriodicTask(mConfig.tick_interval));
             mReadTask->callback = [this]() {
                 auto to_read = std::min(mConfig.bytes_per_tick, sizeof(mReadBuf));
-                auto result  = ::read(mFd, mReadBuf, to_read);
-                VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, mReadBuf, to_read, result);
+                auto space   = read_space(mReadBuf, to_read);
+                auto result  = ::read(mFd, space.first, space.second);
+                VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, space.first, space.second, result);
                 if (result > 0) {
-                    on_raw_read(mReadBuf, result);
+                    on_raw_read(space.first, result);
                 } else if (result == 0) {
                     DEBUGF("file read complete (EOF)");
                     set_disconnected();
@@ -84,10 +85,11 @@ bool FileStream::schedule(scheduler::Scheduler& scheduler) {
             mFdTask.reset(new scheduler::FileDescriptorTask());
             (void)mFdTask->set_fd(mFd);
             mFdTask->on_read = [this](scheduler::FileDescriptorTask&) {
-                auto result = ::read(mFd, mReadBuf, sizeof(mReadBuf));
-                VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, mReadBuf, sizeof(mReadBuf), result);
+                auto space  = read_space(mReadBuf, sizeof(mReadBuf));
+                auto result = ::read(mFd, space.first, space.second);
+                VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, space.first, space.second, result);
                 if (result > 0) {
-                    on_raw_read(mReadBuf, result);
+                    on_raw_read(space.first, result);
                 } else if (result == 0) {
                     DEBUGF("file read complete (EOF)");
                     set_disconnected();
@@ -99,10 +99,11 @@ bool PtyStream::schedule(scheduler::Scheduler& scheduler) {
     mSocketTask.reset(new scheduler::OwnedFileDescriptorTask(mMasterFd));
     mSocketTask->set_event_name("pty:" + mId);
     mSocketTask->on_read = [this](scheduler::OwnedFileDescriptorTask&) {
-        auto result = ::read(mMasterFd, mReadBuf, sizeof(mReadBuf));
-        VERBOSEF("::read(%d, %p, %zu) = %zd", mMasterFd, mReadBuf, sizeof(mReadBuf), result);
+        auto space  = read_space(mReadBuf, sizeof(mReadBuf));
+        auto result = ::read(mMasterFd, space.first, space.second);
+        VERBOSEF("::read(%d, %p, %zu) = %zd", mMasterFd, space.first, space.second, result);
         if (result > 0) {
-            on_raw_read(mReadBuf, result);
+            on_raw_read(space.first, result);
         } else if (result == 0) {
             DEBUGF("pty closed");
             set_disconnected();
@@ -113,17 +114,13 @@ bool PtyStream::schedule(scheduler::Scheduler& scheduler) {
     };
     mSocketTask->on_write = [this](scheduler::OwnedFileDescriptorTask&) {
         while (!mWriteBuffer.empty()) {
-            auto  peek   = mWriteBuffer.peek();
-            auto& data   = peek.first;
-            auto& len    = peek.second;
-            auto  result = ::write(mMasterFd, data, len);
-            VERBOSEF("::write(%d, %p, %zu) = %zd", mMasterFd, data, len, result);
+            auto result = mWriteBuffer.write_to(mMasterFd);
+            VERBOSEF("writev(%d) = %zd", mMasterFd, result);
             if (result < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) break;
                 WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
                 return;
             }
-            mWriteBuffer.consume(result);
         }
         if (mWriteBuffer.empty() && mWriteRegistered) {
             mSocketTask->update_interests(scheduler::EventInterest::Read |
@@ -180,6 +177,7 @@ bool PtyStream::cancel() {
 void PtyStream::write(uint8_t const* data, size_t length) NOEXCEPT {
     TRACEF("%p, %zu", data, length);
 
+    size_t written = 0;
     if (mWriteBuffer.empty()) {
         auto result = ::write(mMasterFd, data, length);
         VERBOSEF("::write(%d, %p, %zu) = %zd", mMasterFd, data, length, result);
@@ -192,11 +190,10 @@ void PtyStream::write(uint8_t const* data, size_t length) NOEXCEPT {
             }
         }
         if (static_cast<size_t>(result) == length) return;
-        data += result;
-        length -= result;
+        written = static_cast<size_t>(result);
     }
 
-    mWriteBuffer.enqueue(data, length);
+    mWriteBuffer.enqueue_message(data, length, written);
     if (!mWriteRegistered && mSocketTask) {
         mSocketTask->update_interests(
             scheduler::EventInterest::Read | scheduler::EventInterest::Write |
@@ -4,6 +4,8 @@
 #include <cerrno>
 #include <cstring>
 #include <fcntl.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -54,7 +56,16 @@ static speed_t baud_rate_to_constant(BaudRate baud_rate) {
 SerialStream::SerialStream(std::string id, SerialConfig config) NOEXCEPT
     : Stream(std::move(id), config.read_config),
       mConfig(std::move(config)) {
-    VSCOPE_FUNCTIONF("\"%s\", \"%s\", raw=%d", mId.c_str(), mConfig.device.c_str(), mConfig.raw);
+    VSCOPE_FUNCTIONF("\"%s\", \"%s\", raw=%d, low_latency=%d", mId.c_str(),
+                     mConfig.device.c_str(), mConfig.raw, mConfig.low_latency);
+    if (mConfig.low_latency) mReadConfig.timestamp = true;
+    if (mConfig.low_latency && mReadConfig.min_bytes > 1 && mReadConfig.timeout.count() <= 0) {
+        // Only the read timeout reads the bytes left below VMIN, without it a trailing partial
+        // frame would stay in the tty until more data arrives
+        WARNF("low_latency: read_min_bytes=%zu needs read_timeout_ms, using 1",
+              mReadConfig.min_bytes);
+        mReadConfig.min_bytes = 1;
+    }
 }
 
 SerialStream::~SerialStream() NOEXCEPT {
@@ -82,34 +93,22 @@ bool SerialStream::schedule(scheduler::Scheduler& scheduler) {
         return false;
     }
 
+    if (mConfig.low_latency) set_low_latency();
+
     mSocketTask.reset(new scheduler::OwnedFileDescriptorTask(mFd));
     mSocketTask->set_event_name("serial:" + mId);
     mSocketTask->on_read = [this](scheduler::OwnedFileDescriptorTask&) {
-        auto result = ::read(mFd, mReadBuf, sizeof(mReadBuf));
-        VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, mReadBuf, sizeof(mReadBuf), result);
-        if (result > 0) {
-            on_raw_read(mReadBuf, result);
-        } else if (result == 0) {
-            DEBUGF("serial device closed");
-            set_disconnected();
-        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            ERRORF("failed to read from serial: " ERRNO_FMT, ERRNO_ARGS(errno));
-            set_error(errno, strerror(errno));
-        }
+        read_once();
     };
     mSocketTask->on_write = [this](scheduler::OwnedFileDescriptorTask&) {
         while (!mWriteBuffer.empty()) {
-            auto  peek   = mWriteBuffer.peek();
-            auto& data   = peek.first;
-            auto& len    = peek.second;
-            auto  result = ::write(mFd, data, len);
-            VERBOSEF("::write(%d, %p, %zu) = %zd", mFd, data, len, result);
+            auto result = mWriteBuffer.write_to(mFd);
+            VERBOSEF("writev(%d) = %zd", mFd, result);
             if (result < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) break;
                 WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
                 return;
             }
-            mWriteBuffer.consume(result);
         }
         if (mWriteBuffer.empty() && mWriteRegistered) {
             mSocketTask->update_interests(scheduler::EventInterest::Read |
@@ -141,6 +140,48 @@ bool SerialStream::schedule(scheduler::Scheduler& scheduler) {
     return true;
 }
 
+void SerialStream::read_once() NOEXCEPT {
+    auto space  = read_space(mReadBuf, sizeof(mReadBuf));
+    auto result = ::read(mFd, space.first, space.second);
+    VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, space.first, space.second, result);
+    if (result > 0) {
+        on_raw_read(space.first, static_cast<size_t>(result));
+    } else if (result == 0) {
+        DEBUGF("serial device closed");
+        set_disconnected();
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        ERRORF("failed to read from serial: " ERRNO_FMT, ERRNO_ARGS(errno));
+        set_error(errno, strerror(errno));
+    }
+}
+
+void SerialStream::on_read_timeout() NOEXCEPT {
+    // In low-latency mode bytes below VMIN are still in the tty, a non-blocking read returns them
+    if (mConfig.low_latency && mFd >= 0) read_once();
+    flush_read_buffer();
+}
+
+void SerialStream::set_low_latency() NOEXCEPT {
+    VSCOPE_FUNCTION();
+
+    // Not every tty is a serial port (e.g. a pty), the rest of the profile still applies
+    struct serial_struct serial;
+    memset(&serial, 0, sizeof(serial));
+    auto result = ::ioctl(mFd, TIOCGSERIAL, &serial);
+    VERBOSEF("::ioctl(%d, TIOCGSERIAL, %p) = %d", mFd, &serial, result);
+    if (result != 0) {
+        WARNF("serial device does not support low-latency mode: " ERRNO_FMT, ERRNO_ARGS(errno));
+        return;
+    }
+
+    serial.flags |= ASYNC_LOW_LATENCY;
+    result = ::ioctl(mFd, TIOCSSERIAL, &serial);
+    VERBOSEF("::ioctl(%d, TIOCSSERIAL, %p) = %d", mFd, &serial, result);
+    if (result != 0) {
+        WARNF("failed to enable low-latency mode: " ERRNO_FMT, ERRNO_ARGS(errno));
+    }
+}
+
 bool SerialStream::cancel() {
     VSCOPE_FUNCTION();
     cancel_read_timeout();
@@ -154,6 +195,7 @@ bool SerialStream::cancel() {
 void SerialStream::write(uint8_t const* data, size_t length) NOEXCEPT {
     TRACEF("%p, %zu", data, length);
 
+    size_t written = 0;
     if (mWriteBuffer.empty()) {
         auto result = ::write(mFd, data, length);
         VERBOSEF("::write(%d, %p, %zu) = %zd", mFd, data, length, result);
@@ -166,11 +208,10 @@ void SerialStream::write(uint8_t const* data, size_t length) NOEXCEPT {
             }
         }
         if (static_cast<size_t>(result) == length) return;
-        data += result;
-        length -= result;
+        written = static_cast<size_t>(result);
     }
 
-    mWriteBuffer.enqueue(data, length);
+    mWriteBuffer.enqueue_message(data, length, written);
     if (!mWriteRegistered && mSocketTask) {
         mSocketTask->update_interests(
             scheduler::EventInterest::Read | scheduler::EventInterest::Write |
@@ -198,6 +239,14 @@ bool SerialStream::configure_termios() NOEXCEPT {
 
     tty.c_cc[VTIME] = 0;
     tty.c_cc[VMIN]  = 0;
+    if (mConfig.low_latency) {
+        // The tty reports the port readable once VMIN bytes have arrived (only without VTIME), a
+        // frame then arrives with one wakeup and one read
+        auto min_bytes = mReadConfig.min_bytes;
+        if (min_bytes < 1) min_bytes = 1;
+        if (min_bytes > 255) min_bytes = 255;
+        tty.c_cc[VMIN] = static_cast<cc_t>(min_bytes);
+    }
 
     auto iflag = static_cast<int>(tty.c_iflag);
     iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON);
@@ -46,10 +46,11 @@ bool StdioStream::schedule(scheduler::Scheduler& scheduler) {
     mSocketTask.reset(new scheduler::OwnedFileDescriptorTask(STDIN_FILENO));
     mSocketTask->set_event_name("stdio:" + mId);
     mSocketTask->on_read = [this](scheduler::OwnedFileDescriptorTask&) {
-        auto result = ::read(STDIN_FILENO, mReadBuf, sizeof(mReadBuf));
-        VERBOSEF("::read(%d, %p, %zu) = %zd", STDIN_FILENO, mReadBuf, sizeof(mReadBuf), result);
+        auto space  = read_space(mReadBuf, sizeof(mReadBuf));
+        auto result = ::read(STDIN_FILENO, space.first, space.second);
+        VERBOSEF("::read(%d, %p, %zu) = %zd", STDIN_FILENO, space.first, space.second, result);
         if (result > 0) {
-            on_raw_read(mReadBuf, result);
+            on_raw_read(space.first, result);
         } else if (result == 0) {
             DEBUGF("stdin closed");
             set_disconnected();
@@ -72,17 +73,13 @@ bool StdioStream::schedule(scheduler::Scheduler& scheduler) {
     mWriteTask->set_event_name("stdio-write:" + mId);
     mWriteTask->on_write = [this, write_fd](scheduler::OwnedFileDescriptorTask&) {
         while (!mWriteBuffer.empty()) {
-            auto  peek   = mWriteBuffer.peek();
-            auto& data   = peek.first;
-            auto& len    = peek.second;
-            auto  result = ::write(write_fd, data, len);
-            VERBOSEF("::write(%d, %p, %zu) = %zd", write_fd, data, len, result);
+            auto result = mWriteBuffer.write_to(write_fd);
+            VERBOSEF("writev(%d) = %zd", write_fd, result);
             if (result < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) break;
                 WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
                 return;
             }
-            mWriteBuffer.consume(result);
         }
         if (mWriteBuffer.empty() && mWriteRegistered) {
             mWriteTask->cancel();
@@ -118,6 +115,7 @@ void StdioStream::write(uint8_t const* data, size_t length) NOEXCEPT {
     TRACEF("%p, %zu", data, length);
     int write_fd = mConfig.use_stderr ? STDERR_FILENO : STDOUT_FILENO;
 
+    size_t written = 0;
     if (mWriteBuffer.empty()) {
         auto result = ::write(write_fd, data, length);
         VERBOSEF("::write(%d, %p, %zu) = %zd", write_fd, data, length, result);
@@ -130,11 +128,10 @@ void StdioStream::write(uint8_t const* data, size_t length) NOEXCEPT {
             }
         }
         if (static_cast<size_t>(result) == length) return;
-        data += result;
-        length -= result;
+        written = static_cast<size_t>(result);
     }
 
-    mWriteBuffer.enqueue(data, length);
+    mWriteBuffer.enqueue_message(data, length, written);
     if (!mWriteRegistered && mScheduler) {
         mWriteTask->schedule(*mScheduler);
         mWriteRegistered = true;
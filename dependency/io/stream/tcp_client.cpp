@@ -39,13 +39,20 @@ bool TcpClientStream::schedule(scheduler::Scheduler& scheduler) {
             new scheduler::TcpConnectTask(mConfig.host, mConfig.port, mConfig.reconnect));
     }
 
-    mConnectTask->on_connected = [this](scheduler::TcpConnectTask&) {
+    mConnectTask->on_connected = [this](scheduler::TcpConnectTask& task) {
         INFOF("tcp client connected");
-        mState = State::Connected;
+        mState       = State::Connected;
+        mSendQueued  = 0;
+        mCompletions = task.receive([this](uint8_t* data, ssize_t result) {
+            on_receive(data, result);
+        });
+        VERBOSEF("completions: %s", mCompletions ? "true" : "false");
+        if (mCompletions) send_write_buffer();
     };
 
     mConnectTask->on_disconnected = [this](scheduler::TcpConnectTask&) {
         INFOF("tcp client disconnected");
+        mCompletions = false;
         flush_read_buffer();
         if (mConfig.reconnect) {
             mState = State::Connecting;
@@ -55,10 +62,11 @@ bool TcpClientStream::schedule(scheduler::Scheduler& scheduler) {
     };
 
     mConnectTask->on_read = [this](scheduler::TcpConnectTask& task) {
-        auto result = ::read(task.fd(), mReadBuf, sizeof(mReadBuf));
-        VERBOSEF("::read(%d, %p, %zu) = %zd", task.fd(), mReadBuf, sizeof(mReadBuf), result);
+        auto space  = read_space(mReadBuf, sizeof(mReadBuf));
+        auto result = ::read(task.fd(), space.first, space.second);
+        VERBOSEF("::read(%d, %p, %zu) = %zd", task.fd(), space.first, space.second, result);
         if (result > 0) {
-            on_raw_read(mReadBuf, result);
+            on_raw_read(space.first, result);
         } else if (result == 0) {
             DEBUGF("tcp connection closed by peer");
             flush_read_buffer();
@@ -70,17 +78,13 @@ bool TcpClientStream::schedule(scheduler::Scheduler& scheduler) {
 
     mConnectTask->on_write = [this](scheduler::TcpConnectTask& task) {
         while (!mWriteBuffer.empty()) {
-            auto  peek   = mWriteBuffer.peek();
-            auto& data   = peek.first;
-            auto& len    = peek.second;
-            auto  result = ::write(task.fd(), data, len);
-            VERBOSEF("::write(%d, %p, %zu) = %zd", task.fd(), data, len, result);
+            auto result = mWriteBuffer.write_to(task.fd());
+            VERBOSEF("writev(%d) = %zd", task.fd(), result);
             if (result < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) break;
                 WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
                 return;
             }
-            mWriteBuffer.consume(result);
         }
         if (mWriteBuffer.empty() && mWriteRegistered) {
             mConnectTask->update_interests(scheduler::EventInterest::Read |
@@ -114,7 +118,14 @@ void TcpClientStream::write(uint8_t const* data, size_t length) NOEXCEPT {
         return;
     }
 
-    int fd = mConnectTask->fd();
+    if (mCompletions) {
+        mWriteBuffer.enqueue_message(data, length);
+        send_write_buffer();
+        return;
+    }
+
+    int    fd      = mConnectTask->fd();
+    size_t written = 0;
     if (mWriteBuffer.empty()) {
         auto result = ::write(fd, data, length);
         VERBOSEF("::write(%d, %p, %zu) = %zd", fd, data, length, result);
@@ -127,11 +138,10 @@ void TcpClientStream::write(uint8_t const* data, size_t length) NOEXCEPT {
             }
         }
         if (static_cast<size_t>(result) == length) return;
-        data += result;
-        length -= result;
+        written = static_cast<size_t>(result);
     }
 
-    mWriteBuffer.enqueue(data, length);
+    mWriteBuffer.enqueue_message(data, length, written);
     if (!mWriteRegistered && mConnectTask) {
         mConnectTask->update_interests(
             scheduler::EventInterest::Read | scheduler::EventInterest::Write |
@@ -140,4 +150,42 @@ void TcpClientStream::write(uint8_t const* data, size_t length) NOEXCEPT {
     }
 }
 
+void TcpClientStream::on_receive(uint8_t* data, ssize_t result) NOEXCEPT {
+    VERBOSEF("receive: %zd", result);
+    if (result > 0) {
+        on_raw_read(data, static_cast<size_t>(result));
+    } else if (result == 0) {
+        DEBUGF("tcp connection closed by peer");
+        flush_read_buffer();
+    } else {
+        auto error = static_cast<int>(-result);
+        ERRORF("failed to receive from socket: " ERRNO_FMT, ERRNO_ARGS(error));
+        set_error(error, strerror(error));
+    }
+}
+
+void TcpClientStream::on_send(ssize_t result) NOEXCEPT {
+    VERBOSEF("send: %zd", result);
+    if (result < 0) {
+        auto error = static_cast<int>(-result);
+        WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(error));
+        mSendQueued = 0;
+        return;
+    }
+    mSendQueued -= static_cast<size_t>(result);
+    send_write_buffer();
+}
+
+// The scheduler queue holds up to the size of the write buffer, the messages after it wait in the
+// write buffer and are dropped by its policy when the peer does not keep up.
+void TcpClientStream::send_write_buffer() NOEXCEPT {
+    if (!mConnectTask || mSendQueued >= mWriteBuffer.max_size()) return;
+    auto limit = mWriteBuffer.max_size() - mSendQueued;
+    mSendQueued += mWriteBuffer.send_to(limit, [this](struct iovec const* iov, size_t count) {
+        return mConnectTask->send(iov, count, [this](ssize_t result) {
+            on_send(result);
+        });
+    });
+}
+
 }  // namespace io
@@ -19,6 +19,7 @@ TcpServerStream::Client::Client(TcpServerStream& server, int fd) NOEXCEPT : mSer
                                                                             mFd(fd),
                                                                             mTask(fd) {
     mTask.set_event_name("tcp-server-client:" + server.mId);
+    mWriteBuffer.set_drop_policy(server.mDropPolicy);
     mTask.on_read = [this](scheduler::OwnedFileDescriptorTask&) {
         if (!mDestroying) on_read();
     };
@@ -29,6 +30,9 @@ TcpServerStream::Client::Client(TcpServerStream& server, int fd) NOEXCEPT : mSer
         if (!mDestroying) on_error();
     };
     (void)mTask.schedule();
+    mCompletions = mTask.receive([this](uint8_t* data, ssize_t result) {
+        if (!mDestroying) on_receive(data, result);
+    });
 }
 
 TcpServerStream::Client::~Client() NOEXCEPT {
@@ -50,10 +54,11 @@ void TcpServerStream::Client::destroy() NOEXCEPT {
 
 void TcpServerStream::Client::on_read() NOEXCEPT {
     FUNCTION_SCOPEF("fd=%d", mFd);
-    auto result = ::read(mFd, mServer.mReadBuf, sizeof(mServer.mReadBuf));
-    VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, mServer.mReadBuf, sizeof(mServer.mReadBuf), result);
+    auto space  = mServer.read_space(mServer.mReadBuf, sizeof(mServer.mReadBuf));
+    auto result = ::read(mFd, space.first, space.second);
+    VERBOSEF("::read(%d, %p, %zu) = %zd", mFd, space.first, space.second, result);
     if (result > 0) {
-        mServer.on_raw_read(mServer.mReadBuf, result);
+        mServer.on_raw_read(space.first, result);
     } else if (result == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
         if (result == 0) {
             DEBUGF("client fd=%d disconnected", mFd);
@@ -67,18 +72,14 @@ void TcpServerStream::Client::on_read() NOEXCEPT {
 void TcpServerStream::Client::on_write() NOEXCEPT {
     FUNCTION_SCOPEF("fd=%d", mFd);
     while (!mWriteBuffer.empty()) {
-        auto peek   = mWriteBuffer.peek();
-        auto data   = peek.first;
-        auto len    = peek.second;
-        auto result = ::write(mFd, data, len);
-        VERBOSEF("::write(%d, %p, %zu) = %zd", mFd, data, len, result);
+        auto result = mWriteBuffer.write_to(mFd);
+        VERBOSEF("writev(%d) = %zd", mFd, result);
         if (result < 0) {
             if (errno == EAGAIN || errno == EWOULDBLOCK) break;
             WARNF("client fd=%d write error: " ERRNO_FMT, mFd, ERRNO_ARGS(errno));
             destroy();
             return;
         }
-        mWriteBuffer.consume(result);
     }
     if (mWriteBuffer.empty() && mWriteRegistered) {
         VERBOSEF("client fd=%d write buffer drained", mFd);
@@ -88,6 +89,46 @@ void TcpServerStream::Client::on_write() NOEXCEPT {
     }
 }
 
+void TcpServerStream::Client::on_receive(uint8_t* data, ssize_t result) NOEXCEPT {
+    FUNCTION_SCOPEF("fd=%d, %zd", mFd, result);
+    if (result > 0) {
+        mServer.on_raw_read(data, static_cast<size_t>(result));
+        return;
+    }
+
+    if (result == 0) {
+        DEBUGF("client fd=%d disconnected", mFd);
+    } else {
+        auto error = static_cast<int>(-result);
+        WARNF("client fd=%d read error: " ERRNO_FMT, mFd, ERRNO_ARGS(error));
+    }
+    destroy();
+}
+
+void TcpServerStream::Client::on_send(ssize_t result) NOEXCEPT {
+    FUNCTION_SCOPEF("fd=%d, %zd", mFd, result);
+    if (result < 0) {
+        auto error = static_cast<int>(-result);
+        WARNF("client fd=%d write error: " ERRNO_FMT, mFd, ERRNO_ARGS(error));
+        destroy();
+        return;
+    }
+    mSendQueued -= static_cast<size_t>(result);
+    send_write_buffer();
+}
+
+// The scheduler queue holds up to the size of the write buffer, the messages after it wait in the
+// write buffer and are dropped by its policy when the client does not keep up.
+void TcpServerStream::Client::send_write_buffer() NOEXCEPT {
+    if (mSendQueued >= mWriteBuffer.max_size()) return;
+    auto limit = mWriteBuffer.max_size() - mSendQueued;
+    mSendQueued += mWriteBuffer.send_to(limit, [this](struct iovec const* iov, size_t count) {
+        return mTask.send(iov, count, [this](ssize_t result) {
+            if (!mDestroying) on_send(result);
+        });
+    });
+}
+
 void TcpServerStream::Client::on_error() NOEXCEPT {
     FUNCTION_SCOPEF("fd=%d", mFd);
     int       err    = 0;
@@ -100,7 +141,10 @@ void TcpServerStream::Client::on_error() NOEXCEPT {
 
 void TcpServerStream::Client::write(uint8_t const* data, size_t length) NOEXCEPT {
     FUNCTION_SCOPEF("fd=%d, length=%zu", mFd, length);
-    if (mWriteBuffer.empty()) {
+    if (mCompletions) {
+        mWriteBuffer.enqueue_message(data, length);
+        send_write_buffer();
+    } else if (mWriteBuffer.empty()) {
         auto result = ::write(mFd, data, length);
         VERBOSEF("::write(%d, %p, %zu) = %zd", mFd, data, length, result);
         if (result < 0) {
@@ -112,7 +156,7 @@ void TcpServerStream::Client::write(uint8_t const* data, size_t length) NOEXCEPT
             }
         }
         if (static_cast<size_t>(result) < length) {
-            mWriteBuffer.enqueue(data + result, length - result);
+            mWriteBuffer.enqueue_message(data, length, static_cast<size_t>(result));
             if (!mWriteRegistered) {
                 mTask.update_interests(
                     scheduler::EventInterest::Read | scheduler::EventInterest::Write |
@@ -121,7 +165,7 @@ void TcpServerStream::Client::write(uint8_t const* data, size_t length) NOEXCEPT
             }
         }
     } else {
-        mWriteBuffer.enqueue(data, length);
+        mWriteBuffer.enqueue_message(data, length);
     }
 }
 
@@ -192,6 +236,35 @@ void TcpServerStream::write(uint8_t const* data, size_t length) NOEXCEPT {
     }
 }
 
+uint64_t TcpServerStream::dropped_messages() const NOEXCEPT {
+    auto count = mRemovedDroppedMessages;
+    for (auto const& client : mClients) {
+        count += client->write_buffer().dropped_messages();
+    }
+    return count;
+}
+
+uint64_t TcpServerStream::dropped_bytes() const NOEXCEPT {
+    auto count = mRemovedDroppedBytes;
+    for (auto const& client : mClients) {
+        count += client->write_buffer().dropped_bytes();
+    }
+    return count;
+}
+
+void TcpServerStream::end_epoch() NOEXCEPT {
+    for (auto& client : mClients) {
+        client->write_buffer().end_epoch();
+    }
+}
+
+void TcpServerStream::set_drop_policy(WriteBuffer::DropPolicy policy) NOEXCEPT {
+    mDropPolicy = policy;
+    for (auto& client : mClients) {
+        client->write_buffer().set_drop_policy(policy);
+    }
+}
+
 void TcpServerStream::remove_client(int fd) NOEXCEPT {
     FUNCTION_SCOPE();
     auto it =
@@ -202,6 +275,8 @@ void TcpServerStream::remove_client(int fd) NOEXCEPT {
         VERBOSEF("client fd=%d not found", fd);
     } else {
         DEBUGF("removing client fd=%d", fd);
+        mRemovedDroppedMessages += (*it)->write_buffer().dropped_messages();
+        mRemovedDroppedBytes += (*it)->write_buffer().dropped_bytes();
         mClients.erase(it);
         VERBOSEF("remaining clients: %zu", mClients.size());
     }
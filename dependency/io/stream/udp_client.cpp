@@ -1,8 +1,10 @@
 #include <io/stream/udp_client.hpp>
 #include <scheduler/file_descriptor.hpp>
 
+#include <algorithm>
 #include <arpa/inet.h>
 #include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <netdb.h>
 #include <netinet/in.h>
@@ -17,9 +19,18 @@ LOGLET_MODULE3(io, stream, udp_client);
 
 namespace io {
 
+// Datagrams received with one recvmmsg by default, each up to the largest UDP payload so that no
+// datagram is dropped. Smaller slots can be configured with `ReadBufferConfig::datagram_size`.
+static CONSTEXPR size_t DATAGRAM_BATCH = 8;
+static CONSTEXPR size_t DATAGRAM_SIZE  = DatagramBatch::MAX_DATAGRAM_SIZE;
+// Buffered datagrams passed to one sendmmsg
+static CONSTEXPR size_t SEND_BATCH = 16;
+
 UdpClientStream::UdpClientStream(std::string id, UdpClientConfig config) NOEXCEPT
     : Stream(std::move(id), config.read_config),
-      mConfig(std::move(config)) {
+      mConfig(std::move(config)),
+      mBatch(mReadConfig.datagrams > 0 ? mReadConfig.datagrams : DATAGRAM_BATCH,
+             mReadConfig.datagram_size > 0 ? mReadConfig.datagram_size : DATAGRAM_SIZE) {
     VSCOPE_FUNCTIONF("\"%s\", host=\"%s\", port=%u, path=\"%s\"", mId.c_str(), mConfig.host.c_str(),
                      mConfig.port, mConfig.path.c_str());
 }
@@ -100,13 +111,39 @@ bool UdpClientStream::schedule(scheduler::Scheduler& scheduler) {
         }
     }
 
+    mDestinations.clear();
+    if (!mConfig.fanout.empty()) {
+        // The connected peer is the first destination
+        DatagramDestination peer{};
+        peer.length = sizeof(peer.address);
+        if (::getpeername(mFd, reinterpret_cast<sockaddr*>(&peer.address), &peer.length) == 0) {
+            mDestinations.push_back(peer);
+        }
+
+        for (auto const& endpoint : mConfig.fanout) {
+            auto colon = endpoint.rfind(':');
+            if (colon == std::string::npos) {
+                WARNF("invalid fanout destination \"%s\", expected <host>:<port>",
+                      endpoint.c_str());
+                continue;
+            }
+
+            auto                port = static_cast<uint16_t>(atoi(endpoint.c_str() + colon + 1));
+            DatagramDestination destination{};
+            if (resolve_destination(endpoint.substr(0, colon), port, destination)) {
+                mDestinations.push_back(destination);
+            }
+        }
+        DEBUGF("fanout to %zu destinations", mDestinations.size());
+    }
+
     mSocketTask.reset(new scheduler::OwnedFileDescriptorTask(mFd));
     mSocketTask->set_event_name("udp-client:" + mId);
     mSocketTask->on_read = [this](scheduler::OwnedFileDescriptorTask&) {
-        auto result = ::recv(mFd, mReadBuf, sizeof(mReadBuf), 0);
-        VERBOSEF("::recv(%d, %p, %zu, 0) = %zd", mFd, mReadBuf, sizeof(mReadBuf), result);
+        auto result = mBatch.receive(mFd);
         if (result > 0) {
-            on_raw_read(mReadBuf, result);
+            auto length = mBatch.coalesce();
+            if (length > 0) on_raw_read(mBatch.buffer(), length);
         } else if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
             ERRORF("failed to read from socket: " ERRNO_FMT, ERRNO_ARGS(errno));
             set_error(errno, strerror(errno));
@@ -114,17 +151,21 @@ bool UdpClientStream::schedule(scheduler::Scheduler& scheduler) {
     };
     mSocketTask->on_write = [this](scheduler::OwnedFileDescriptorTask&) {
         while (!mWriteBuffer.empty()) {
-            auto  peek   = mWriteBuffer.peek();
-            auto& data   = peek.first;
-            auto& len    = peek.second;
-            auto  result = ::send(mFd, data, len, MSG_NOSIGNAL);
-            VERBOSEF("::send(%d, %p, %zu, MSG_NOSIGNAL) = %zd", mFd, data, len, result);
+            // Every buffered message is one datagram
+            struct iovec datagrams[SEND_BATCH];
+            auto         count  = mWriteBuffer.gather(datagrams, SEND_BATCH);
+            auto         result = send_datagrams(mFd, datagrams, count, nullptr);
             if (result < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) break;
                 WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
                 return;
             }
-            mWriteBuffer.consume(result);
+
+            size_t bytes = 0;
+            for (int i = 0; i < result; i++) {
+                bytes += datagrams[i].iov_len;
+            }
+            mWriteBuffer.consume(bytes);
         }
         if (mWriteBuffer.empty() && mWriteRegistered) {
             mSocketTask->update_interests(scheduler::EventInterest::Read |
@@ -166,9 +207,52 @@ bool UdpClientStream::cancel() {
     return true;
 }
 
+void UdpClientStream::send_fanout(uint8_t const* data, size_t length) NOEXCEPT {
+    if (mConfig.segment_size > 0 && length > mConfig.segment_size) {
+        for (auto const& destination : mDestinations) {
+            auto result =
+                send_segments(mFd, data, length, mConfig.segment_size, &destination, mGso);
+            if (result < 0) WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
+        }
+        return;
+    }
+
+    auto sent = send_to_all(mFd, data, length, mDestinations.data(), mDestinations.size());
+    if (sent < mDestinations.size()) {
+        VERBOSEF("sent to %zu of %zu destinations", sent, mDestinations.size());
+    }
+}
+
 void UdpClientStream::write(uint8_t const* data, size_t length) NOEXCEPT {
     TRACEF("%p, %zu", data, length);
 
+    if (!mDestinations.empty()) {
+        send_fanout(data, length);
+        return;
+    }
+
+    if (mConfig.segment_size > 0 && length > mConfig.segment_size) {
+        size_t sent = 0;
+        if (mWriteBuffer.empty()) {
+            auto result = send_segments(mFd, data, length, mConfig.segment_size, nullptr, mGso);
+            if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                WARNF("write error: " ERRNO_FMT, ERRNO_ARGS(errno));
+                return;
+            }
+            if (result > 0) sent = static_cast<size_t>(result);
+            if (sent == length) return;
+        }
+
+        // Buffer the segments that were not sent, one datagram each
+        for (auto offset = sent; offset < length; offset += mConfig.segment_size) {
+            auto size = std::min(length - offset, mConfig.segment_size);
+            mWriteBuffer.enqueue_message(data + offset, size);
+        }
+        register_write();
+        return;
+    }
+
+    size_t written = 0;
     if (mWriteBuffer.empty()) {
         auto result = ::send(mFd, data, length, MSG_NOSIGNAL);
         VERBOSEF("::send(%d, %p, %zu, MSG_NOSIGNAL) = %zd", mFd, data, length, result);
@@ -181,11 +265,14 @@ void UdpClientStream::write(uint8_t const* data, size_t length) NOEXCEPT {
             }
         }
         if (static_cast<size_t>(result) == length) return;
-        data += result;
-        length -= result;
+        written = static_cast<size_t>(result);
     }
 
-    mWriteBuffer.enqueue(data, length);
+    mWriteBuffer.enqueue_message(data, length, written);
+    register_write();
+}
+
+void UdpClientStream::register_write() NOEXCEPT {
     if (!mWriteRegistered && mSocketTask) {
         mSocketTask->update_interests(
             scheduler::EventInterest::Read | scheduler::EventInterest::Write |
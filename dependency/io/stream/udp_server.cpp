@@ -13,11 +13,18 @@ LOGLET_MODULE3(io, stream, udp_server);
 
 namespace io {
 
+// Datagrams received with one recvmmsg by default, each up to the largest UDP payload so that no
+// datagram is dropped. Smaller slots can be configured with `ReadBufferConfig::datagram_size`.
+static CONSTEXPR size_t DATAGRAM_BATCH = 8;
+static CONSTEXPR size_t DATAGRAM_SIZE  = DatagramBatch::MAX_DATAGRAM_SIZE;
+
 UdpServerStream::UdpServerStream(std::string                                       id,
                                  std::unique_ptr<scheduler::UdpSocketListenerTask> listener,
                                  ReadBufferConfig read_config) NOEXCEPT
     : Stream(std::move(id), read_config),
-      mListenerTask(std::move(listener)) {
+      mListenerTask(std::move(listener)),
+      mBatch(mReadConfig.datagrams > 0 ? mReadConfig.datagrams : DATAGRAM_BATCH,
+             mReadConfig.datagram_size > 0 ? mReadConfig.datagram_size : DATAGRAM_SIZE) {
     VSCOPE_FUNCTIONF("\"%s\"", mId.c_str());
 }
 
@@ -31,13 +38,22 @@ bool UdpServerStream::schedule(scheduler::Scheduler& scheduler) {
     mScheduler = &scheduler;
 
     mListenerTask->on_read = [this](scheduler::UdpSocketListenerTask& task) {
-        mLastSenderLen = sizeof(mLastSender);
-        auto result    = ::recvfrom(task.fd(), mReadBuf, sizeof(mReadBuf), 0,
-                                    reinterpret_cast<sockaddr*>(&mLastSender), &mLastSenderLen);
-        VERBOSEF("::recvfrom(%d, %p, %zu, 0, %p, %p) = %zd", task.fd(), mReadBuf, sizeof(mReadBuf),
-                 &mLastSender, &mLastSenderLen, result);
+        auto result = mBatch.receive(task.fd());
         if (result > 0) {
-            on_raw_read(mReadBuf, result);
+            // Deliver consecutive datagrams from the same sender at once, with that sender as the
+            // reply destination while the read callbacks run
+            size_t begin = 0;
+            while (begin < mBatch.size()) {
+                auto end = begin + 1;
+                while (end < mBatch.size() && mBatch.same_sender(begin, end)) {
+                    end++;
+                }
+                mLastSender    = mBatch.sender(begin);
+                mLastSenderLen = mBatch.sender_length(begin);
+                auto length    = mBatch.coalesce(begin, end);
+                if (length > 0) on_raw_read(mBatch.data(begin), length);
+                begin = end;
+            }
         } else if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
             ERRORF("failed to read from socket: " ERRNO_FMT, ERRNO_ARGS(errno));
             set_error(errno, strerror(errno));
@@ -23,16 +23,23 @@ LOGLET_MODULE2(io, udp);
 #define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(io, udp)
 
 namespace io {
+// Datagrams received with one recvmmsg, each up to the largest UDP payload
+static CONSTEXPR size_t DATAGRAM_BATCH = 8;
+static CONSTEXPR size_t DATAGRAM_SIZE  = DatagramBatch::MAX_DATAGRAM_SIZE;
+
 UdpServerInput::UdpServerInput(std::string listen, uint16_t port) NOEXCEPT
     : mPath{},
       mListen(std::move(listen)),
-      mPort(port) {
+      mPort(port),
+      mBatch(DATAGRAM_BATCH, DATAGRAM_SIZE) {
     VSCOPE_FUNCTIONF("\"%s\", %u", mListen.c_str(), mPort);
 }
 
-UdpServerInput::UdpServerInput(std::string path) NOEXCEPT : mPath(std::move(path)),
-                                                            mListen{},
-                                                            mPort(0) {
+UdpServerInput::UdpServerInput(std::string path) NOEXCEPT
+    : mPath(std::move(path)),
+      mListen{},
+      mPort(0),
+      mBatch(DATAGRAM_BATCH, DATAGRAM_SIZE) {
     VSCOPE_FUNCTIONF("\"%s\"", mPath.c_str());
 }
 
@@ -55,13 +62,9 @@ bool UdpServerInput::do_schedule(scheduler::Scheduler& scheduler) NOEXCEPT {
 
     ASSERT(mListenerTask, "failed to create listener task");
     mListenerTask->on_read = [this, &scheduler](scheduler::UdpSocketListenerTask& task) {
-        struct sockaddr_storage addr;
-        socklen_t               addr_len = sizeof(addr);
-        auto result = ::recvfrom(mListenerTask->fd(), mBuffer, sizeof(mBuffer), 0,
-                                 reinterpret_cast<struct sockaddr*>(&addr), &addr_len);
-        VERBOSEF("::recvfrom(%d, %p, %zu, 0, %p, %p) = %d", mListenerTask->fd(), mBuffer,
-                 sizeof(mBuffer), &addr, &addr_len, result);
+        auto result = mBatch.receive(task.fd());
         if (result < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
             ERRORF("failed to read from socket: " ERRNO_FMT, ERRNO_ARGS(errno));
             scheduler.defer([&task](scheduler::Scheduler&) {
                 task.cancel();
@@ -69,8 +72,10 @@ bool UdpServerInput::do_schedule(scheduler::Scheduler& scheduler) NOEXCEPT {
             return;
         }
 
-        if (callback) {
-            callback(*this, mBuffer, static_cast<size_t>(result));
+        // Deliver the whole batch with one callback
+        auto length = mBatch.coalesce();
+        if (callback && length > 0) {
+            callback(*this, mBatch.buffer(), length);
         }
     };
     mListenerTask->on_error = [this, &scheduler](scheduler::UdpSocketListenerTask&) {
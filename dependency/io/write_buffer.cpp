@@ -1,5 +1,7 @@
 #include <io/write_buffer.hpp>
 
+#include <sys/uio.h>
+
 #include <loglet/loglet.hpp>
 
 LOGLET_MODULE2(io, write_buffer);
@@ -8,65 +10,255 @@ LOGLET_MODULE2(io, write_buffer);
 
 namespace io {
 
-WriteBuffer::WriteBuffer(size_t max_size) NOEXCEPT : mReadPos(0), mMaxSize(max_size) {
+// Storage of written slices is reused for new messages
+static CONSTEXPR size_t MAX_SPARES = 16;
+// Slices passed to a single writev
+static CONSTEXPR size_t WRITEV_SLICES = 64;
+
+WriteBuffer::WriteBuffer(size_t max_size) NOEXCEPT : mFirst(0),
+                                                      mCount(0),
+                                                      mSize(0),
+                                                      mMaxSize(max_size),
+                                                      mDropPolicy(DropPolicy::Message),
+                                                      mDroppedMessages(0),
+                                                      mDroppedBytes(0) {
     VSCOPE_FUNCTIONF("max_size=%zu", max_size);
 }
 
-void WriteBuffer::enqueue(uint8_t const* data, size_t length) NOEXCEPT {
-    TRACEF("%p, %zu", data, length);
+WriteBuffer::Slice& WriteBuffer::slice(size_t index) NOEXCEPT {
+    return mSlices[(mFirst + index) & (mSlices.size() - 1)];
+}
+
+WriteBuffer::Slice const& WriteBuffer::slice(size_t index) const NOEXCEPT {
+    return mSlices[(mFirst + index) & (mSlices.size() - 1)];
+}
+
+size_t WriteBuffer::slice_length(size_t index) const NOEXCEPT {
+    auto& s = slice(index);
+    return s.data.size() - s.offset;
+}
+
+WriteBuffer::Slice& WriteBuffer::push_slice(bool framed) NOEXCEPT {
+    if (mCount == mSlices.size()) {
+        // The ring capacity is a power of two, grow it and unwrap the slices
+        std::vector<Slice> slices(mSlices.empty() ? 8 : mSlices.size() * 2);
+        for (size_t i = 0; i < mCount; i++) {
+            slices[i] = std::move(slice(i));
+        }
+        mSlices = std::move(slices);
+        mFirst  = 0;
+    }
+
+    auto& s = slice(mCount++);
+    if (!mSpare.empty()) {
+        s.data = std::move(mSpare.back());
+        mSpare.pop_back();
+    }
+    s.data.clear();
+    s.offset    = 0;
+    s.framed    = framed;
+    s.started   = false;
+    s.epoch_end = false;
+    return s;
+}
+
+void WriteBuffer::recycle(std::vector<uint8_t>& data) NOEXCEPT {
+    if (mSpare.size() < MAX_SPARES && data.capacity() <= mMaxSize) {
+        data.clear();
+        mSpare.push_back(std::move(data));
+    } else {
+        std::vector<uint8_t>().swap(data);
+    }
+}
+
+void WriteBuffer::pop_front() NOEXCEPT {
+    recycle(slice(0).data);
+    mFirst = (mFirst + 1) & (mSlices.size() - 1);
+    mCount--;
+}
+
+void WriteBuffer::remove(size_t index) NOEXCEPT {
+    // Move the slices before `index` one step towards the back, then drop the first
+    for (auto i = index; i > 0; i--) {
+        std::swap(slice(i), slice(i - 1));
+    }
+    pop_front();
+}
 
-    // Compact buffer if read position is at the end
-    if (mReadPos > 0 && mReadPos == mBuffer.size()) {
-        mBuffer.clear();
-        mReadPos = 0;
+void WriteBuffer::discard_bytes(size_t bytes) NOEXCEPT {
+    while (bytes > 0 && mCount > 0) {
+        auto length = slice_length(0);
+        if (length <= bytes) {
+            if (slice(0).framed) mDroppedMessages++;
+            mDroppedBytes += length;
+            mSize -= length;
+            bytes -= length;
+            pop_front();
+        } else {
+            slice(0).offset += bytes;
+            mDroppedBytes += bytes;
+            mSize -= bytes;
+            bytes = 0;
+        }
     }
+}
+
+bool WriteBuffer::drop_oldest() NOEXCEPT {
+    // The rest of a partially written message must be written, drop the messages after it
+    size_t index = 0;
+    if (mCount > 0 && slice(0).started) index = 1;
+    if (index >= mCount) return false;
+
+    do {
+        auto epoch_end = slice(index).epoch_end;
+        auto length    = slice_length(index);
+        VERBOSEF("dropping message: %zu bytes", length);
+        mDroppedMessages++;
+        mDroppedBytes += length;
+        mSize -= length;
+        remove(index);
+        if (mDropPolicy == DropPolicy::Message || epoch_end) break;
+    } while (index < mCount);
+    return true;
+}
+
+void WriteBuffer::enqueue(uint8_t const* data, size_t length) NOEXCEPT {
+    TRACEF("%p, %zu", data, length);
+    if (length == 0) return;
 
     // If data is larger than max size, only keep the tail
     if (length > mMaxSize) {
         WARNF("data larger than max size, truncating: length=%zu, max=%zu", length, mMaxSize);
         data += length - mMaxSize;
         length = mMaxSize;
-        mBuffer.clear();
-        mReadPos = 0;
+        discard_bytes(mSize);
     }
 
     // Discard old data if needed to make room
-    size_t available = mMaxSize - size();
+    size_t available = mMaxSize - mSize;
     if (length > available) {
         size_t discard = length - available;
         WARNF("buffer full, discarding %zu bytes", discard);
-        mReadPos += discard;
-        if (mReadPos >= mBuffer.size()) {
-            mBuffer.clear();
-            mReadPos = 0;
-        }
+        discard_bytes(discard);
+    }
+
+    auto& tail = (mCount > 0 && !slice(mCount - 1).framed) ? slice(mCount - 1) : push_slice(false);
+    tail.data.insert(tail.data.end(), data, data + length);
+    mSize += length;
+    VERBOSEF("enqueued %zu bytes, total=%zu", length, mSize);
+}
+
+void WriteBuffer::enqueue_message(uint8_t const* data, size_t length, size_t written) NOEXCEPT {
+    TRACEF("%p, %zu, %zu", data, length, written);
+    if (written >= length) return;
+
+    auto started = written > 0;
+    data += written;
+    length -= written;
+
+    if (!started && length > mMaxSize) {
+        WARNF("message larger than max size, dropped: length=%zu, max=%zu", length, mMaxSize);
+        mDroppedMessages++;
+        mDroppedBytes += length;
+        return;
+    }
+
+    auto dropped = mDroppedMessages;
+    while (mSize + length > mMaxSize && drop_oldest()) {
+    }
+    if (mDroppedMessages != dropped) {
+        WARNF("buffer full, dropped %llu messages",
+              static_cast<unsigned long long>(mDroppedMessages - dropped));
+    }
+
+    // Only a partially written message is left, it is the new message that does not fit
+    if (!started && mSize + length > mMaxSize) {
+        WARNF("buffer full, dropped message: length=%zu", length);
+        mDroppedMessages++;
+        mDroppedBytes += length;
+        return;
     }
 
-    mBuffer.insert(mBuffer.end(), data, data + length);
-    VERBOSEF("enqueued %zu bytes, total=%zu", length, size());
+    auto& s   = push_slice(true);
+    s.started = started;
+    s.data.assign(data, data + length);
+    mSize += length;
+    VERBOSEF("enqueued message %zu bytes, total=%zu", length, mSize);
+}
+
+void WriteBuffer::end_epoch() NOEXCEPT {
+    if (mCount > 0) slice(mCount - 1).epoch_end = true;
 }
 
 std::pair<uint8_t const*, size_t> WriteBuffer::peek() const NOEXCEPT {
     if (empty()) return {nullptr, 0};
-    return {mBuffer.data() + mReadPos, mBuffer.size() - mReadPos};
+    auto& s = slice(0);
+    return {s.data.data() + s.offset, s.data.size() - s.offset};
+}
+
+size_t WriteBuffer::gather(struct iovec* iov, size_t count) const NOEXCEPT {
+    if (count > mCount) count = mCount;
+    for (size_t i = 0; i < count; i++) {
+        auto& s         = slice(i);
+        iov[i].iov_base = const_cast<uint8_t*>(s.data.data() + s.offset);
+        iov[i].iov_len  = s.data.size() - s.offset;
+    }
+    return count;
 }
 
 void WriteBuffer::consume(size_t bytes) NOEXCEPT {
     TRACEF("%zu", bytes);
-    mReadPos += bytes;
-    if (mReadPos > mBuffer.size()) mReadPos = mBuffer.size();
+    auto remaining = bytes;
+    while (remaining > 0 && mCount > 0) {
+        auto length = slice_length(0);
+        if (remaining >= length) {
+            remaining -= length;
+            mSize -= length;
+            pop_front();
+        } else {
+            auto& s = slice(0);
+            s.offset += remaining;
+            s.started = true;
+            mSize -= remaining;
+            remaining = 0;
+        }
+    }
+    VERBOSEF("consumed %zu bytes, remaining=%zu", bytes, mSize);
+}
+
+ssize_t WriteBuffer::write_to(int fd) NOEXCEPT {
+    struct iovec iov[WRITEV_SLICES];
+    auto         count  = gather(iov, WRITEV_SLICES);
+    auto         result = ::writev(fd, iov, static_cast<int>(count));
+    if (result > 0) consume(static_cast<size_t>(result));
+    return result;
+}
 
-    if (mReadPos == mBuffer.size()) {
-        mBuffer.clear();
-        mReadPos = 0;
+size_t WriteBuffer::send_to(size_t limit,
+                            std::function<bool(struct iovec const*, size_t)> const& send) NOEXCEPT {
+    size_t total = 0;
+    while (total < limit && mCount > 0) {
+        struct iovec iov[WRITEV_SLICES];
+        auto         count = gather(iov, WRITEV_SLICES);
+        size_t       used  = 0;
+        size_t       bytes = 0;
+        while (used < count && total + bytes < limit) {
+            bytes += iov[used++].iov_len;
+        }
+        if (!send(iov, used)) break;
+
+        consume(bytes);
+        total += bytes;
     }
-    VERBOSEF("consumed %zu bytes, remaining=%zu", bytes, size());
+    return total;
 }
 
 void WriteBuffer::clear() NOEXCEPT {
     VSCOPE_FUNCTION();
-    mBuffer.clear();
-    mReadPos = 0;
+    while (mCount > 0) {
+        pop_front();
+    }
+    mSize = 0;
 }
 
 }  // namespace io
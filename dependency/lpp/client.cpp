@@ -37,6 +37,7 @@ Client::Client(supl::Identity identity, supl::Cell supl_cell, std::string const&
     on_provide_location_information_advanced = nullptr;
     on_connected                             = nullptr;
     on_disconnected                          = nullptr;
+    on_decoded                               = nullptr;
 
     mNextSessionId        = 1;
     mSession.on_connected = [](Session&) {
@@ -78,6 +79,13 @@ Client::Client(supl::Identity identity, supl::Cell supl_cell, std::string const&
         this->process_message(transaction, std::move(message));
     };
 
+    mSession.on_decoded = [this](lpp::Session&, size_t size,
+                                 std::chrono::steady_clock::duration duration) {
+        if (on_decoded) {
+            on_decoded(*this, size, duration);
+        }
+    };
+
     mHackBadTransactionInitiator = false;
     mHackNeverSendAbort          = false;
     mHackServerInitiatedPush     = false;
@@ -0,0 +1,204 @@
+#include "lpp/client_host.hpp"
+#include "lpp/client.hpp"
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(lpp, host);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(lpp, host)
+
+namespace lpp {
+
+ClientHost::ClientHost(std::string host, uint16_t port, PeriodicRequestAssistanceData request)
+    : mHost(std::move(host)), mPort(port), mRequest(std::move(request)), mScheduler(nullptr),
+      mSessionCount(0), mConnectedCount(0) {
+    VSCOPE_FUNCTION();
+    mRequest.on_non_periodic = nullptr;
+    mRequest.on_periodic     = nullptr;
+    mRequest.on_started      = nullptr;
+    mRequest.on_ended        = nullptr;
+    mRequest.on_error        = nullptr;
+}
+
+ClientHost::~ClientHost() {
+    VSCOPE_FUNCTION();
+}
+
+ClientHost::SessionId ClientHost::add_session(supl::Identity identity, supl::Cell cell) {
+    VSCOPE_FUNCTION();
+
+    auto id = static_cast<SessionId>(mEntries.size());
+    mEntries.emplace_back();
+
+    auto& entry  = mEntries.back();
+    entry.cell   = cell;
+    entry.stats  = {};
+    entry.client = std::unique_ptr<Client>(new Client(std::move(identity), cell, mHost, mPort));
+    entry.client->set_tls(mTls);
+
+    entry.client->on_connected = [this, id](Client&) {
+        auto session = find(id);
+        if (!session) return;
+        DEBUGF("session %u: connected", id);
+        session->stats.connects++;
+        session->stats.connected = true;
+        mConnectedCount++;
+        if (on_connected) on_connected(id);
+    };
+
+    entry.client->on_disconnected = [this, id](Client&) {
+        auto session = find(id);
+        if (!session) return;
+        DEBUGF("session %u: disconnected", id);
+        session->stats.disconnects++;
+        if (session->stats.connected) {
+            session->stats.connected = false;
+            mConnectedCount--;
+        }
+        session->periodic_session = PeriodicSessionHandle::invalid();
+        session->scheduled        = false;
+        if (on_disconnected) on_disconnected(id);
+    };
+
+    entry.client->on_provide_capabilities = [this, id](Client&) {
+        request(id);
+    };
+
+    entry.client->on_decoded = [this, id](Client&, size_t size,
+                                          std::chrono::steady_clock::duration duration) {
+        if (on_decoded) on_decoded(id, size, duration);
+    };
+
+    if (mScheduler) {
+        entry.client->schedule(mScheduler);
+        entry.scheduled = true;
+    }
+
+    mSessionCount++;
+    return id;
+}
+
+bool ClientHost::remove_session(SessionId id) {
+    VSCOPE_FUNCTIONF("%u", id);
+    auto entry = find(id);
+    if (!entry) return false;
+
+    if (entry->stats.connected) {
+        mConnectedCount--;
+    }
+
+    // Destroying the client closes its connection and unregisters it from the scheduler
+    entry->client.reset();
+    entry->scheduled = false;
+    mRoutes.erase(id);
+    mSessionCount--;
+    return true;
+}
+
+bool ClientHost::set_route(SessionId id, Callback route) {
+    if (!find(id)) return false;
+    if (route) {
+        mRoutes[id] = std::move(route);
+    } else {
+        mRoutes.erase(id);
+    }
+    return true;
+}
+
+Client* ClientHost::client(SessionId id) {
+    auto entry = find(id);
+    return entry ? entry->client.get() : nullptr;
+}
+
+ClientHost::SessionStats const* ClientHost::stats(SessionId id) const {
+    auto entry = find(id);
+    return entry ? &entry->stats : nullptr;
+}
+
+void ClientHost::schedule(scheduler::Scheduler* scheduler) {
+    VSCOPE_FUNCTION();
+    ASSERT(scheduler, "scheduler is null");
+    ASSERT(!mScheduler, "scheduler is already set");
+
+    mScheduler = scheduler;
+    for (auto& entry : mEntries) {
+        if (!entry.client || entry.scheduled) continue;
+        entry.client->schedule(mScheduler);
+        entry.scheduled = true;
+    }
+}
+
+void ClientHost::cancel() {
+    VSCOPE_FUNCTION();
+    for (auto& entry : mEntries) {
+        if (!entry.client || !entry.scheduled) continue;
+        entry.client->cancel();
+        entry.scheduled = false;
+        if (entry.stats.connected) {
+            entry.stats.connected = false;
+            mConnectedCount--;
+        }
+    }
+
+    mScheduler = nullptr;
+}
+
+ClientHost::Entry* ClientHost::find(SessionId id) {
+    if (id >= mEntries.size()) return nullptr;
+    auto& entry = mEntries[id];
+    return entry.client ? &entry : nullptr;
+}
+
+ClientHost::Entry const* ClientHost::find(SessionId id) const {
+    if (id >= mEntries.size()) return nullptr;
+    auto& entry = mEntries[id];
+    return entry.client ? &entry : nullptr;
+}
+
+void ClientHost::request(SessionId id) {
+    VSCOPE_FUNCTIONF("%u", id);
+    auto entry = find(id);
+    if (!entry) return;
+
+    if (entry->periodic_session.is_valid()) {
+        DEBUGF("session %u: assistance data already requested", id);
+        return;
+    }
+
+    auto request            = mRequest;
+    request.cell            = entry->cell;
+    request.on_non_periodic = [this, id](Client&, Message message) {
+        deliver(id, std::move(message));
+    };
+    request.on_periodic = [this, id](Client&, PeriodicSessionHandle, Message message) {
+        deliver(id, std::move(message));
+    };
+    request.on_started = [this, id](Client&, PeriodicSessionHandle) {
+        if (on_started) on_started(id);
+    };
+    request.on_error = [id](Client&) {
+        WARNF("session %u: request assistance data failed", id);
+    };
+
+    entry->periodic_session = entry->client->request_assistance_data(request);
+}
+
+void ClientHost::deliver(SessionId id, Message message) {
+    auto entry = find(id);
+    if (!entry) return;
+    entry->stats.messages++;
+
+    if (!mRoutes.empty()) {
+        auto it = mRoutes.find(id);
+        if (it != mRoutes.end()) {
+            it->second(id, std::move(message));
+            return;
+        }
+    }
+
+    if (on_message) {
+        on_message(id, std::move(message));
+    }
+}
+
+}  // namespace lpp
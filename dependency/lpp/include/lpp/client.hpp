@@ -5,6 +5,7 @@
 #include <lpp/transaction.hpp>
 #include <supl/cell.hpp>
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
@@ -61,6 +62,10 @@ public:
     std::function<bool(Client&, LocationInformationDelivery const&)>
         on_provide_location_information_advanced;
 
+    // Called for every received LPP message with its encoded size and the time it took to decode,
+    // e.g. to collect decode latency statistics.
+    std::function<void(Client&, size_t, std::chrono::steady_clock::duration)> on_decoded;
+
     // Request assistance data from the server
     PeriodicSessionHandle
     request_assistance_data(PeriodicRequestAssistanceData const& request_assistance_data);
@@ -0,0 +1,106 @@
+#pragma once
+#include <lpp/assistance_data.hpp>
+#include <lpp/message.hpp>
+#include <lpp/periodic_session.hpp>
+#include <scheduler/scheduler.hpp>
+#include <supl/cell.hpp>
+#include <supl/identity.hpp>
+#include <supl/tls.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lpp {
+
+class Client;
+
+/// Runs many `lpp::Client` sessions against the same location server on one scheduler, e.g. to
+/// serve a fleet of devices from a single process or to load test a location server. Every session
+/// has its own SUPL connection and identity and requests periodic assistance data with the shared
+/// request template as soon as the capabilities handshake is done.
+///
+/// Assistance data from all sessions is delivered to `on_message` so the consumers (ephemeris
+/// store, generators, outputs) are shared, a session can be routed elsewhere with `set_route`. Each
+/// session uses two scheduler events, the SUPL connection and the periodic session timer.
+class ClientHost {
+public:
+    using SessionId = uint32_t;
+    using Callback  = std::function<void(SessionId, Message)>;
+
+    struct SessionStats {
+        uint32_t connects;
+        uint32_t disconnects;
+        uint32_t messages;
+        bool     connected;
+    };
+
+    /// The callbacks of `request` are not used, the host installs its own for every session.
+    EXPLICIT ClientHost(std::string host, uint16_t port, PeriodicRequestAssistanceData request);
+    ~ClientHost();
+
+    ClientHost(ClientHost const&)            = delete;
+    ClientHost& operator=(ClientHost const&) = delete;
+
+    // Called for every assistance data message of a session without a route
+    Callback on_message;
+    // Called when the SUPL session of a session has been established
+    std::function<void(SessionId)> on_connected;
+    // Called when a session has started its periodic assistance data
+    std::function<void(SessionId)> on_started;
+    // Called when a session has been disconnected from the server
+    std::function<void(SessionId)> on_disconnected;
+    // Called for every received LPP message, see `Client::on_decoded`
+    std::function<void(SessionId, size_t, std::chrono::steady_clock::duration)> on_decoded;
+
+    /// Connect with TLS, applies to sessions added afterwards.
+    void set_tls(supl::TlsConfig const& tls) { mTls = tls; }
+
+    /// Add a session, if the host is scheduled the session connects immediately. Must not be
+    /// called from a callback of the host.
+    SessionId add_session(supl::Identity identity, supl::Cell cell);
+    /// Remove a session and disconnect it. Must not be called from a callback of the host.
+    bool remove_session(SessionId id);
+    /// Deliver the assistance data of a session to `route` instead of `on_message`. An empty
+    /// route restores the default.
+    bool set_route(SessionId id, Callback route);
+
+    NODISCARD Client*             client(SessionId id);
+    NODISCARD SessionStats const* stats(SessionId id) const;
+    NODISCARD size_t              size() const { return mSessionCount; }
+    NODISCARD size_t              connected() const { return mConnectedCount; }
+
+    void schedule(scheduler::Scheduler* scheduler);
+    void cancel();
+
+private:
+    // Kept small, the host may have hundreds of sessions.
+    struct Entry {
+        std::unique_ptr<Client> client;
+        supl::Cell              cell;
+        PeriodicSessionHandle   periodic_session;
+        SessionStats            stats;
+        bool                    scheduled;
+    };
+
+    NODISCARD Entry*       find(SessionId id);
+    NODISCARD Entry const* find(SessionId id) const;
+
+    void request(SessionId id);
+    void deliver(SessionId id, Message message);
+
+    std::string                             mHost;
+    uint16_t                                mPort;
+    PeriodicRequestAssistanceData           mRequest;
+    supl::TlsConfig                         mTls;
+    scheduler::Scheduler*                   mScheduler;
+    std::vector<Entry>                      mEntries;
+    std::unordered_map<SessionId, Callback> mRoutes;
+    size_t                                  mSessionCount;
+    size_t                                  mConnectedCount;
+};
+
+}  // namespace lpp
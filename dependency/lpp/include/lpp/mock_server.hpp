@@ -0,0 +1,84 @@
+#pragma once
+#include <lpp/message.hpp>
+#include <scheduler/periodic.hpp>
+#include <scheduler/scheduler.hpp>
+#include <scheduler/socket.hpp>
+#include <supl/tls.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lpp {
+
+/// A minimal SUPL/LPP location server for local testing. It accepts SUPL 2.1 connections, asks each
+/// SET for its capabilities, acknowledges the periodic RequestAssistanceData and then delivers
+/// ProvideAssistanceData messages on a server-initiated transaction every period. It is not a
+/// conforming SLP, it only implements the part of the protocol that `lpp::Client` relies on.
+class MockLocationServer {
+public:
+    struct Stats {
+        uint64_t accepted;
+        uint64_t closed;
+        uint64_t established;
+        uint64_t requests;
+        uint64_t messages_sent;
+        uint64_t bytes_sent;
+    };
+
+    EXPLICIT MockLocationServer(std::string address, uint16_t port) NOEXCEPT;
+    ~MockLocationServer() NOEXCEPT;
+
+    MockLocationServer(MockLocationServer const&)            = delete;
+    MockLocationServer& operator=(MockLocationServer const&) = delete;
+
+    /// Set the UPER encoded ProvideAssistanceData messages to deliver. Every period the next
+    /// message is sent to all connections with a periodic session, wrapping around at the end. The
+    /// transaction and periodic session of the message are replaced for each connection. Messages
+    /// that are not ProvideAssistanceData are skipped, returns the number of messages kept. Without
+    /// messages, an empty ProvideAssistanceData is sent.
+    size_t set_messages(std::vector<std::vector<uint8_t>> const& messages);
+    /// Pad smaller messages to about `size` bytes with an external PDU, to test the throughput of
+    /// a given message size independently of the content.
+    void set_message_size(size_t size);
+    void set_period(std::chrono::steady_clock::duration period) { mPeriod = period; }
+    /// Accept TLS connections, see `supl::TlsConfig::server`.
+    void set_tls(supl::TlsConfig const& tls) { mTls = tls; }
+
+    /// The listening socket is registered with the current scheduler, which must be `scheduler`.
+    NODISCARD bool schedule(scheduler::Scheduler& scheduler);
+    void           cancel();
+
+    /// The port the server is listening on, resolved by `schedule` if port 0 was requested.
+    NODISCARD uint16_t     port() const { return mListener.port(); }
+    NODISCARD size_t       connections() const { return mConnections.size(); }
+    NODISCARD Stats const& stats() const { return mStats; }
+
+private:
+    struct Connection;
+
+    void accept(int fd);
+    void event(Connection* connection, scheduler::EventInterest triggered);
+    void process(Connection& connection, Message message);
+    void deliver();
+    /// Queue the message on the connection, it is written when the socket is writable.
+    bool send(Connection& connection, std::vector<uint8_t> const& message);
+    void update_interests(Connection& connection);
+    void close(Connection* connection);
+    void pad_messages();
+
+    scheduler::Scheduler*                    mScheduler;
+    scheduler::TcpInetListenerTask           mListener;
+    std::unique_ptr<scheduler::PeriodicTask> mDeliveryTask;
+    std::chrono::steady_clock::duration      mPeriod;
+    supl::TlsConfig                          mTls;
+    std::vector<Message>                     mMessages;
+    size_t                                   mMessageSize;
+    size_t                                   mNextMessage;
+    std::vector<std::unique_ptr<Connection>> mConnections;
+    uint32_t                                 mNextSlpId;
+    Stats                                    mStats;
+};
+
+}  // namespace lpp
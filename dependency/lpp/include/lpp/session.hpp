@@ -7,6 +7,7 @@
 #include <supl/identity.hpp>
 #include <supl/tls.hpp>
 
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <unordered_map>
@@ -153,6 +154,8 @@ public:
     std::function<void(Session&, TransactionHandle const&)> on_end_transaction;
     // Called when a message was received for a transaction
     std::function<void(Session&, TransactionHandle const&, Message)> on_message;
+    // Called for every received LPP message with its encoded size and the time it took to decode
+    std::function<void(Session&, size_t, std::chrono::steady_clock::duration)> on_decoded;
 
     void set_hack_server_initiated_push(bool value) { mHackServerInitiatedPush = value; }
     void set_horacc(long horacc) { mHoracc.reset(new long(horacc)); }
@@ -0,0 +1,498 @@
+#include "lpp/mock_server.hpp"
+#include "lpp/session.hpp"
+
+#include <supl/end.hpp>
+#include <supl/pos.hpp>
+#include <supl/response.hpp>
+#include <supl/server.hpp>
+
+#include <external_warnings.hpp>
+
+EXTERNAL_WARNINGS_PUSH
+#include <Acknowledgement.h>
+#include <CommonIEsProvideAssistanceData.h>
+#include <CommonIEsRequestAssistanceData.h>
+#include <EPDU-Sequence.h>
+#include <EPDU.h>
+#include <LPP-Message.h>
+#include <LPP-MessageBody.h>
+#include <LPP-TransactionID.h>
+#include <PeriodicAssistanceDataControlParameters-r15.h>
+#include <PeriodicSessionID-r15.h>
+#include <ProvideAssistanceData-r9-IEs.h>
+#include <RequestAssistanceData-r9-IEs.h>
+#include <RequestCapabilities-r9-IEs.h>
+EXTERNAL_WARNINGS_POP
+
+#include <algorithm>
+#include <loglet/loglet.hpp>
+
+#define ALLOC_ZERO(type) reinterpret_cast<type*>(calloc(1, sizeof(type)))
+
+LOGLET_MODULE2(lpp, mock);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(lpp, mock)
+
+namespace lpp {
+
+// The capabilities are requested on the first server transaction and the periodic assistance data
+// is delivered on the following ones.
+static constexpr long CAPABILITIES_TRANSACTION = 1;
+static constexpr long PERIODIC_TRANSACTION     = 2;
+
+static scheduler::EventInterest const READ_INTERESTS = scheduler::EventInterest::Read |
+                                                       scheduler::EventInterest::Error |
+                                                       scheduler::EventInterest::Hangup;
+
+struct MockLocationServer::Connection {
+    std::unique_ptr<supl::ServerSession> session;
+    scheduler::ScheduledEvent            event;
+    bool                                 write_registered;
+    bool                                 closed;
+    bool                                 established;
+    bool                                 periodic;
+    long                                 periodic_transaction;
+    long                                 periodic_session_number;
+    long                                 periodic_session_initiator;
+};
+
+static Message create_request_capabilities() {
+    auto body               = ALLOC_ZERO(LPP_MessageBody);
+    body->present           = LPP_MessageBody_PR_c1;
+    body->choice.c1.present = LPP_MessageBody__c1_PR_requestCapabilities;
+
+    auto body_ce     = &body->choice.c1.choice.requestCapabilities.criticalExtensions;
+    body_ce->present = RequestCapabilities__criticalExtensions_PR_c1;
+    body_ce->choice.c1.present =
+        RequestCapabilities__criticalExtensions__c1_PR_requestCapabilities_r9;
+
+    auto message             = ALLOC_ZERO(LPP_Message);
+    message->lpp_MessageBody = body;
+    return Message{message};
+}
+
+static Message create_provide_assistance_data() {
+    auto body               = ALLOC_ZERO(LPP_MessageBody);
+    body->present           = LPP_MessageBody_PR_c1;
+    body->choice.c1.present = LPP_MessageBody__c1_PR_provideAssistanceData;
+
+    auto body_ce     = &body->choice.c1.choice.provideAssistanceData.criticalExtensions;
+    body_ce->present = ProvideAssistanceData__criticalExtensions_PR_c1;
+    body_ce->choice.c1.present =
+        ProvideAssistanceData__criticalExtensions__c1_PR_provideAssistanceData_r9;
+
+    auto message             = ALLOC_ZERO(LPP_Message);
+    message->lpp_MessageBody = body;
+    return Message{message};
+}
+
+static RequestAssistanceData_r9_IEs* get_request_assistance_data(Message const& message) {
+    if (!is_request_assistance_data(message)) return nullptr;
+    auto& body = *message->lpp_MessageBody;
+    return &body.choice.c1.choice.requestAssistanceData.criticalExtensions.choice.c1.choice
+                .requestAssistanceData_r9;
+}
+
+static void set_periodic_session(Message& message, long number, long initiator) {
+    auto inner = get_provide_assistance_data(message);
+    if (!inner) return;
+
+    if (!inner->commonIEsProvideAssistanceData) {
+        inner->commonIEsProvideAssistanceData = ALLOC_ZERO(CommonIEsProvideAssistanceData);
+    }
+
+    auto common = inner->commonIEsProvideAssistanceData;
+    if (!common->ext2) {
+        common->ext2 =
+            ALLOC_ZERO(CommonIEsProvideAssistanceData::CommonIEsProvideAssistanceData__ext2);
+    }
+
+    if (!common->ext2->periodicAssistanceData_r15) {
+        common->ext2->periodicAssistanceData_r15 =
+            ALLOC_ZERO(PeriodicAssistanceDataControlParameters_r15);
+    }
+
+    auto& psid = common->ext2->periodicAssistanceData_r15->periodicSessionID_r15;
+
+    psid.periodicSessionNumber_r15    = number;
+    psid.periodicSessionInitiator_r15 = initiator;
+}
+
+// Replace the transaction of the message and encode it. The sequence number and acknowledgement
+// are dropped, `lpp::Client` does not use them and it keeps the encoding the same for every
+// connection with the same transaction and periodic session.
+static std::vector<uint8_t> encode_with_transaction(Message& message, long initiator, long number,
+                                                    bool end_transaction) {
+    if (!message->transactionID) {
+        message->transactionID = ALLOC_ZERO(LPP_TransactionID);
+    }
+    message->transactionID->initiator         = initiator;
+    message->transactionID->transactionNumber = number;
+    message->endTransaction                   = end_transaction;
+
+    if (message->sequenceNumber) {
+        free(message->sequenceNumber);
+        message->sequenceNumber = nullptr;
+    }
+
+    if (message->acknowledgement) {
+        ASN_STRUCT_FREE(asn_DEF_Acknowledgement, message->acknowledgement);
+        message->acknowledgement = nullptr;
+    }
+
+    return Session::encode_lpp_message(message);
+}
+
+MockLocationServer::MockLocationServer(std::string address, uint16_t port) NOEXCEPT
+    : mScheduler(nullptr),
+      mListener(std::move(address), port),
+      mPeriod(std::chrono::seconds(1)),
+      mMessageSize(0),
+      mNextMessage(0),
+      mNextSlpId(1),
+      mStats{} {
+    VSCOPE_FUNCTION();
+    mMessages.push_back(create_provide_assistance_data());
+
+    mListener.on_accept = [this](scheduler::SocketListenerTask&, int fd, struct sockaddr_storage*,
+                                 socklen_t) {
+        accept(fd);
+    };
+    mListener.on_error = [](scheduler::SocketListenerTask&) {
+        ERRORF("listener error");
+    };
+}
+
+MockLocationServer::~MockLocationServer() NOEXCEPT {
+    VSCOPE_FUNCTION();
+    cancel();
+}
+
+size_t MockLocationServer::set_messages(std::vector<std::vector<uint8_t>> const& messages) {
+    VSCOPE_FUNCTIONF("%zu", messages.size());
+
+    std::vector<Message> decoded;
+    for (size_t i = 0; i < messages.size(); i++) {
+        auto message = Session::decode_lpp_message(messages[i].data(), messages[i].size());
+        if (!message) {
+            WARNF("skipping message %zu: failed to decode", i);
+            continue;
+        } else if (!get_provide_assistance_data(message)) {
+            VERBOSEF("skipping message %zu: not a ProvideAssistanceData", i);
+            continue;
+        }
+
+        decoded.push_back(std::move(message));
+    }
+
+    auto count = decoded.size();
+    if (decoded.empty()) {
+        decoded.push_back(create_provide_assistance_data());
+    }
+
+    mMessages    = std::move(decoded);
+    mNextMessage = 0;
+    pad_messages();
+    return count;
+}
+
+void MockLocationServer::set_message_size(size_t size) {
+    mMessageSize = size;
+    pad_messages();
+}
+
+void MockLocationServer::pad_messages() {
+    VSCOPE_FUNCTIONF("%zu", mMessageSize);
+
+    // The UPER overhead of another external PDU is a few bytes, don't bother below that.
+    constexpr size_t EPDU_OVERHEAD = 8;
+
+    for (auto& message : mMessages) {
+        set_periodic_session(message, 0, 0);
+        auto size = encode_with_transaction(message, Initiator_locationServer, 0, false).size();
+        if (size + EPDU_OVERHEAD >= mMessageSize) continue;
+
+        auto inner = get_provide_assistance_data(message);
+        if (!inner->epdu_Provide_Assistance_Data) {
+            inner->epdu_Provide_Assistance_Data = ALLOC_ZERO(EPDU_Sequence);
+        }
+
+        std::vector<uint8_t> padding(mMessageSize - size - EPDU_OVERHEAD, 0x55);
+
+        auto epdu                     = ALLOC_ZERO(EPDU);
+        epdu->ePDU_Identifier.ePDU_ID = 256;
+        OCTET_STRING_fromBuf(&epdu->ePDU_Body, reinterpret_cast<char const*>(padding.data()),
+                             static_cast<int>(padding.size()));
+        ASN_SEQUENCE_ADD(&inner->epdu_Provide_Assistance_Data->list, epdu);
+    }
+}
+
+bool MockLocationServer::schedule(scheduler::Scheduler& scheduler) {
+    VSCOPE_FUNCTION();
+    if (mScheduler) {
+        WARNF("already scheduled");
+        return false;
+    } else if (mTls.enabled && !supl::create_tls_backend(mTls)) {
+        ERRORF("TLS requested but not available");
+        return false;
+    }
+
+    mListener.schedule(scheduler);
+    if (!mListener.is_scheduled()) {
+        ERRORF("failed to listen");
+        return false;
+    }
+
+    mDeliveryTask.reset(new scheduler::PeriodicTask(mPeriod));
+    mDeliveryTask->set_event_name("mock-slp-delivery");
+    mDeliveryTask->callback = [this]() {
+        deliver();
+    };
+    if (!mDeliveryTask->schedule(scheduler)) {
+        ERRORF("failed to schedule delivery");
+        mListener.cancel();
+        return false;
+    }
+
+    mScheduler = &scheduler;
+    DEBUGF("listening on port %u", port());
+    return true;
+}
+
+void MockLocationServer::cancel() {
+    VSCOPE_FUNCTION();
+    if (!mScheduler) return;
+
+    for (auto& connection : mConnections) {
+        if (connection->event.valid()) {
+            mScheduler->unregister(connection->event);
+        }
+    }
+    mConnections.clear();
+
+    mDeliveryTask.reset();
+    mListener.cancel();
+    mScheduler = nullptr;
+}
+
+void MockLocationServer::accept(int fd) {
+    VSCOPE_FUNCTIONF("%d", fd);
+
+    uint8_t localhost[4] = {127, 0, 0, 1};
+    auto    identity     = supl::Identity::ipv4(localhost);
+    auto    connection   = std::unique_ptr<Connection>(new Connection{});
+    auto    tls          = supl::create_tls_backend(mTls);
+    connection->session.reset(
+        new supl::ServerSession(fd, supl::VERSION_2_1, identity, mNextSlpId++, std::move(tls)));
+
+    auto ptr          = connection.get();
+    connection->event = mScheduler->register_fd(
+        fd, READ_INTERESTS,
+        [this, ptr](scheduler::EventInterest triggered) {
+            event(ptr, triggered);
+        },
+        "mock-slp-connection");
+    if (!connection->event.valid()) {
+        WARNF("failed to register connection");
+        return;
+    }
+
+    mConnections.push_back(std::move(connection));
+    mStats.accepted++;
+}
+
+void MockLocationServer::event(Connection* connection, scheduler::EventInterest triggered) {
+    VSCOPE_FUNCTION();
+    if (connection->closed) return;
+
+    // Queued messages are written here, a TLS write may also have been waiting for a read
+    auto alive = connection->session->flush() && connection->session->fill_receive_buffer();
+    for (;;) {
+        supl::POS pos{};
+        auto      received = connection->session->try_receive(pos);
+        if (received == supl::ServerSession::Received::NoData) {
+            break;
+        } else if (received == supl::ServerSession::Received::UnableToDecode) {
+            continue;
+        } else if (received == supl::ServerSession::Received::END) {
+            DEBUGF("SUPL END");
+            alive = false;
+            break;
+        } else if (received == supl::ServerSession::Received::START) {
+            DEBUGF("SUPL START");
+            supl::RESPONSE response{};
+            response.pos_method = supl::RESPONSE::PosMethod::AgpsSETBased;
+            if (!connection->session->send(response)) {
+                alive = false;
+                break;
+            }
+            continue;
+        }
+
+        if (received == supl::ServerSession::Received::POSINIT && !connection->established) {
+            DEBUGF("SUPL POSINIT");
+            connection->established = true;
+            mStats.established++;
+
+            auto request_capabilities = create_request_capabilities();
+            auto encoded              = encode_with_transaction(
+                request_capabilities, Initiator_locationServer, CAPABILITIES_TRANSACTION, false);
+            if (!send(*connection, encoded)) {
+                alive = false;
+                break;
+            }
+        }
+
+        for (auto& payload : pos.payloads) {
+            if (payload.type != supl::Payload::Type::LPP) continue;
+            auto message = Session::decode_lpp_message(payload.bytes(), payload.size());
+            if (!message) {
+                WARNF("failed to decode LPP message");
+                continue;
+            }
+            process(*connection, std::move(message));
+        }
+    }
+
+    auto error = scheduler::EventInterest::Error | scheduler::EventInterest::Hangup;
+    if (!alive || !connection->session->flush() || (triggered & error)) {
+        close(connection);
+    } else {
+        update_interests(*connection);
+    }
+}
+
+void MockLocationServer::update_interests(Connection& connection) {
+    auto wants_write = connection.session->wants_write();
+    if (wants_write == connection.write_registered) return;
+
+    VERBOSEF("%s write interest (%zu bytes queued)", wants_write ? "register" : "unregister",
+             connection.session->send_buffer().size());
+    auto interests = READ_INTERESTS;
+    if (wants_write) interests |= scheduler::EventInterest::Write;
+    mScheduler->update_interests(connection.event, interests);
+    connection.write_registered = wants_write;
+}
+
+void MockLocationServer::process(Connection& connection, Message message) {
+    VSCOPE_FUNCTION();
+    if (!message->transactionID) {
+        WARNF("missing transaction id");
+        return;
+    }
+
+    if (is_abort(message)) {
+        if (connection.periodic &&
+            message->transactionID->initiator == Initiator_locationServer &&
+            message->transactionID->transactionNumber == connection.periodic_transaction) {
+            DEBUGF("periodic session aborted");
+            connection.periodic = false;
+        }
+        return;
+    }
+
+    auto request = get_request_assistance_data(message);
+    if (!request) {
+        VERBOSEF("ignoring message");
+        return;
+    }
+
+    mStats.requests++;
+
+    auto ack    = create_provide_assistance_data();
+    auto common = request->commonIEsRequestAssistanceData;
+    if (common && common->ext2 && common->ext2->periodicAssistanceDataReq_r15) {
+        auto& psid = common->ext2->periodicAssistanceDataReq_r15->periodicSessionID_r15;
+        connection.periodic                   = true;
+        connection.periodic_transaction       = PERIODIC_TRANSACTION;
+        connection.periodic_session_number    = psid.periodicSessionNumber_r15;
+        connection.periodic_session_initiator = psid.periodicSessionInitiator_r15;
+        set_periodic_session(ack, psid.periodicSessionNumber_r15,
+                             psid.periodicSessionInitiator_r15);
+    }
+
+    // Acknowledge the request on its own transaction, the assistance data follows on the periodic
+    // transaction.
+    auto encoded = encode_with_transaction(ack, message->transactionID->initiator,
+                                           message->transactionID->transactionNumber, true);
+    if (!send(connection, encoded)) {
+        close(&connection);
+    }
+}
+
+void MockLocationServer::deliver() {
+    VSCOPE_FUNCTION();
+    if (mMessages.empty()) return;
+
+    auto& message = mMessages[mNextMessage % mMessages.size()];
+    mNextMessage++;
+
+    // Most connections share the periodic session number, only re-encode when it changes.
+    std::vector<uint8_t> encoded;
+    long                 encoded_number    = -1;
+    long                 encoded_initiator = -1;
+    for (size_t i = 0; i < mConnections.size(); i++) {
+        auto& connection = *mConnections[i];
+        if (connection.closed || !connection.periodic) continue;
+
+        if (encoded.empty() || encoded_number != connection.periodic_session_number ||
+            encoded_initiator != connection.periodic_session_initiator) {
+            encoded_number    = connection.periodic_session_number;
+            encoded_initiator = connection.periodic_session_initiator;
+            set_periodic_session(message, encoded_number, encoded_initiator);
+            encoded = encode_with_transaction(message, Initiator_locationServer,
+                                              connection.periodic_transaction, false);
+            if (encoded.empty()) {
+                ERRORF("failed to encode ProvideAssistanceData");
+                return;
+            }
+        }
+
+        if (!send(connection, encoded)) {
+            close(&connection);
+        }
+    }
+}
+
+bool MockLocationServer::send(Connection& connection, std::vector<uint8_t> const& message) {
+    VSCOPE_FUNCTIONF("%zu", message.size());
+    if (message.empty()) return false;
+
+    supl::Payload payload{};
+    payload.type = supl::Payload::Type::LPP;
+    payload.data = message;
+
+    supl::POS pos{};
+    pos.payloads.push_back(std::move(payload));
+    if (!connection.session->send(pos)) {
+        return false;
+    }
+    update_interests(connection);
+
+    mStats.messages_sent++;
+    mStats.bytes_sent += message.size();
+    return true;
+}
+
+void MockLocationServer::close(Connection* connection) {
+    VSCOPE_FUNCTIONF("%d", connection->session->fd());
+    if (connection->closed) return;
+
+    connection->closed = true;
+    mScheduler->unregister(connection->event);
+    connection->event = scheduler::ScheduledEvent::invalid();
+    mStats.closed++;
+
+    // The connection may be closed from its own event callback, remove it once that has returned.
+    mScheduler->defer([this, connection](scheduler::Scheduler&) {
+        auto it = std::find_if(mConnections.begin(), mConnections.end(),
+                               [connection](std::unique_ptr<Connection> const& other) {
+                                   return other.get() == connection;
+                               });
+        if (it != mConnections.end()) {
+            mConnections.erase(it);
+        }
+    });
+}
+
+}  // namespace lpp
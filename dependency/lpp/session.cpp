@@ -728,7 +728,7 @@ void Session::process_supl_pos(supl::POS const& pos) {
     for (auto const& payload : pos.payloads) {
         switch (payload.type) {
         case supl::Payload::Type::LPP:
-            DEBUGF("lpp payload: %d bytes", payload.data.size());
+            DEBUGF("lpp payload: %zu bytes", payload.size());
             process_lpp_payload(payload);
             break;
         case supl::Payload::Type::NOTHING:
@@ -745,16 +745,19 @@ void Session::process_lpp_payload(supl::Payload const& payload) {
     ASSERT(payload.type == supl::Payload::Type::LPP, "invalid payload type");
 
     auto decode_start = std::chrono::steady_clock::now();
-    auto message      = decode_lpp_message(payload.data.data(), payload.data.size());
+    auto message      = decode_lpp_message(payload.bytes(), payload.size());
     auto decode_end   = std::chrono::steady_clock::now();
     auto decode_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(decode_end - decode_start).count();
 
     if (decode_ms > 100) {
-        WARNF("LPP decode took %lld ms (payload size: %zu bytes)", decode_ms, payload.data.size());
+        WARNF("LPP decode took %lld ms (payload size: %zu bytes)", decode_ms, payload.size());
     } else {
-        VERBOSEF("LPP decode took %lld ms (payload size: %zu bytes)", decode_ms,
-                 payload.data.size());
+        VERBOSEF("LPP decode took %lld ms (payload size: %zu bytes)", decode_ms, payload.size());
+    }
+
+    if (on_decoded) {
+        on_decoded(*this, payload.size(), decode_end - decode_start);
     }
 
     if (!message) {
@@ -152,6 +152,19 @@ void FileDescriptorTask::update_interests(EventInterest interests) NOEXCEPT {
     mEvent.interests(interests);
 }
 
+bool FileDescriptorTask::receive(std::function<void(uint8_t*, ssize_t)> callback) NOEXCEPT {
+    VSCOPE_FUNCTION();
+    if (!mEvent.valid() || !has_current()) return false;
+    return current().receive(mEvent, std::move(callback));
+}
+
+bool FileDescriptorTask::send(struct iovec const* iov, size_t count,
+                              std::function<void(ssize_t)> callback) NOEXCEPT {
+    VSCOPE_FUNCTIONF("%zu", count);
+    if (!mEvent.valid() || !has_current()) return false;
+    return current().send(mEvent, iov, count, std::move(callback));
+}
+
 //
 // OwnedFileDescriptorTask
 //
@@ -27,6 +27,12 @@ public:
     void update() NOEXCEPT;
     void update_interests(EventInterest interests) NOEXCEPT;
 
+    /// See `Scheduler::receive` and `Scheduler::send`, false if the scheduler does not support
+    /// completions.
+    NODISCARD bool receive(std::function<void(uint8_t*, ssize_t)> callback) NOEXCEPT;
+    NODISCARD bool send(struct iovec const* iov, size_t count,
+                        std::function<void(ssize_t)> callback) NOEXCEPT;
+
     void set_name(std::string name) NOEXCEPT { mName = std::move(name); }
     void set_event_name(std::string name) NOEXCEPT { set_name(std::move(name)); }
 
@@ -62,6 +68,14 @@ public:
     void update() NOEXCEPT { mTask.update(); }
     void update_interests(EventInterest interests) NOEXCEPT { mTask.update_interests(interests); }
 
+    NODISCARD bool receive(std::function<void(uint8_t*, ssize_t)> callback) NOEXCEPT {
+        return mTask.receive(std::move(callback));
+    }
+    NODISCARD bool send(struct iovec const* iov, size_t count,
+                        std::function<void(ssize_t)> callback) NOEXCEPT {
+        return mTask.send(iov, count, std::move(callback));
+    }
+
     void set_name(std::string name) NOEXCEPT { mTask.set_name(std::move(name)); }
     void set_event_name(std::string name) NOEXCEPT { set_name(std::move(name)); }
 
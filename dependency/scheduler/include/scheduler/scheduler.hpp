@@ -3,12 +3,17 @@
 
 #include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <string>
 #include <sys/epoll.h>
+#include <sys/types.h>
 #include <unordered_map>
 #include <vector>
 
+struct iovec;
+
 namespace scheduler {
 
 enum class ExecuteResult {
@@ -19,6 +24,13 @@ enum class ExecuteResult {
     Error,
 };
 
+/// How the scheduler waits for file descriptors. `Epoll` is the default, `IoUring` is opt-in and
+/// falls back to `Epoll` when io_uring is not compiled in or not supported by the kernel.
+enum class Backend {
+    Epoll,
+    IoUring,
+};
+
 enum class EventInterest : uint32_t {
     None   = 0,
     Read   = 1 << 0,
@@ -61,18 +73,38 @@ struct EventSlot {
     std::function<void(EventInterest)> callback;
     std::string                        name;
     int                                fd           = -1;
+    uint32_t                           events       = 0;
     uint16_t                           generation   = 0;
+    uint16_t                           arm          = 0;  // io_uring: sequence of the poll request
+    bool                               armed        = false;
+    bool                               arm_queued   = false;
     bool                               in_use       = false;
     bool                               pending_free = false;
+
+    // io_uring completions, see `Scheduler::receive` and `Scheduler::send`. The slot is not reused
+    // while the kernel still has a request of it, the send request reads the first `send_length`
+    // bytes of `send_data`.
+    std::function<void(uint8_t*, ssize_t)> on_receive;
+    std::function<void(ssize_t)>           on_send;
+    std::vector<uint8_t>                   send_data;
+    size_t                                 send_length = 0;
+    uint16_t                               in_flight   = 0;
+    bool                                   receiving   = false;
 };
 
+class Uring;
+
 class Scheduler {
 public:
-    static constexpr int MAX_EVENT_SLOTS = 256;
+    /// The event pool grows on demand, slot indices must fit in `ScheduledEvent::index`.
+    static constexpr int MAX_EVENT_SLOTS = UINT16_MAX;
 
     Scheduler() NOEXCEPT;
+    EXPLICIT Scheduler(Backend backend) NOEXCEPT;
     ~Scheduler() NOEXCEPT;
 
+    NODISCARD Backend backend() const NOEXCEPT;
+
     ExecuteResult execute() NOEXCEPT;
     ExecuteResult execute_timeout(std::chrono::steady_clock::duration duration) NOEXCEPT;
     ExecuteResult execute_while(std::function<bool()> condition) NOEXCEPT;
@@ -90,17 +122,47 @@ public:
                          std::function<void(EventInterest)> callback) NOEXCEPT;
     void unregister(ScheduledEvent event) NOEXCEPT;
 
+    /// Completion-based reads and writes of sockets, only with the io_uring backend when the kernel
+    /// supports multishot receives into provided buffers.
+    NODISCARD bool completions() const NOEXCEPT;
+
+    /// Read the socket of `event` with a multishot receive and pass each chunk to `callback`
+    /// instead of reporting the socket as readable. The length is negative (-errno) on error and 0
+    /// when the peer closed the connection, the data is only valid during the callback. Returns
+    /// false if completions are not supported, the caller then reads when the socket is readable.
+    NODISCARD bool receive(ScheduledEvent                         event,
+                           std::function<void(uint8_t*, ssize_t)> callback) NOEXCEPT;
+    /// Copy `count` buffers to the send queue of the socket of `event`. The queue is sent with one
+    /// request submitted with the next wait, data queued while a request is in flight goes with
+    /// the next one. `callback` replaces the previous one and gets the number of bytes of each
+    /// completed request, or -errno after which the queue is dropped.
+    NODISCARD bool send(ScheduledEvent event, struct iovec const* iov, size_t count,
+                        std::function<void(ssize_t)> callback) NOEXCEPT;
+
     void set_max_events_per_wait(int max_events) NOEXCEPT { mMaxEventsPerWait = max_events; }
     int  max_events_per_wait() const NOEXCEPT { return mMaxEventsPerWait; }
 
 private:
+    NODISCARD bool setup_uring() NOEXCEPT;
+    NODISCARD bool initialized() const NOEXCEPT;
+    NODISCARD int  wait(int timeout_ms) NOEXCEPT;
+    NODISCARD int  wait_uring(int max_events, int timeout_ms) NOEXCEPT;
+    void           queue_arm(uint16_t index) NOEXCEPT;
+    void           disarm(ScheduledEvent event) NOEXCEPT;
+    void           cancel_requests(ScheduledEvent event) NOEXCEPT;
+    void           submit_send(ScheduledEvent event) NOEXCEPT;
+
     void process_event(struct epoll_event& event) NOEXCEPT;
+    void process_completion(uint64_t user_data, int32_t result, uint32_t flags) NOEXCEPT;
+    NODISCARD bool is_completion(struct epoll_event const& event) const NOEXCEPT;
     void process_deferred();
 
     NODISCARD EventSlot* get_slot(ScheduledEvent handle) NOEXCEPT;
     NODISCARD bool       is_stale(ScheduledEvent handle) NOEXCEPT;
 
     static uint64_t       encode_handle(ScheduledEvent h) NOEXCEPT;
+    static uint64_t       encode_arm(ScheduledEvent h, uint16_t arm) NOEXCEPT;
+    static uint64_t       encode_request(ScheduledEvent h, uint64_t request) NOEXCEPT;
     static ScheduledEvent decode_handle(uint64_t v) NOEXCEPT;
     static uint32_t       interests_to_epoll(EventInterest i) NOEXCEPT;
     static EventInterest  epoll_to_interests(uint32_t e) NOEXCEPT;
@@ -110,10 +172,24 @@ private:
     int  mEpollCount;
     int  mMaxEventsPerWait;
     bool mInterrupted;
+    bool mInterruptArmed;
 
     struct epoll_event mEvents[32];
 
-    EventSlot mEventPool[MAX_EVENT_SLOTS];
+    // io_uring receive and send completions of `mEvents`, indexed by the event
+    struct Completion {
+        int32_t  result;
+        uint32_t flags;
+    };
+    Completion mCompletions[32];
+
+    std::unique_ptr<Uring> mUring;
+    std::vector<uint16_t>  mArmQueue;
+
+    // Slots are referenced across callbacks that may register new events, a deque keeps them in
+    // place when the pool grows.
+    std::deque<EventSlot> mEventPool;
+    std::vector<uint16_t> mFreeSlots;
 
     std::vector<std::function<void(scheduler::Scheduler&)>> mDeferredCallbacks;
 };
@@ -147,6 +223,7 @@ inline void interrupt() {
 class ScopedScheduler : public Scheduler {
 public:
     ScopedScheduler() NOEXCEPT { set_current(this); }
+    EXPLICIT ScopedScheduler(Backend backend) NOEXCEPT : Scheduler(backend) { set_current(this); }
     ~ScopedScheduler() NOEXCEPT { set_current(nullptr); }
 
     ScopedScheduler(ScopedScheduler const&)            = delete;
@@ -159,6 +159,12 @@ public:
 
     void update_interests(EventInterest interests) NOEXCEPT;
 
+    /// Completion-based I/O on the connected socket, see `Scheduler::receive` and
+    /// `Scheduler::send`. The receive ends with the connection, call it again after reconnecting.
+    NODISCARD bool receive(std::function<void(uint8_t*, ssize_t)> callback) NOEXCEPT;
+    NODISCARD bool send(struct iovec const* iov, size_t count,
+                        std::function<void(ssize_t)> callback) NOEXCEPT;
+
     std::function<void(TcpConnectTask&)> on_connected;
     std::function<void(TcpConnectTask&)> on_disconnected;
     std::function<void(TcpConnectTask&)> on_read;
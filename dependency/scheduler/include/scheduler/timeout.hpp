@@ -6,9 +6,17 @@
 
 namespace scheduler {
 
+enum class TimerClock {
+    // The virtual clock when it is enabled, otherwise the monotonic clock
+    Default,
+    // Always the monotonic clock, e.g. for the input that drives the virtual clock
+    Monotonic,
+};
+
 class Timer {
 public:
-    EXPLICIT Timer(std::chrono::steady_clock::duration duration) NOEXCEPT;
+    EXPLICIT Timer(std::chrono::steady_clock::duration duration,
+                   TimerClock                          clock = TimerClock::Default) NOEXCEPT;
     ~Timer() NOEXCEPT;
 
     Timer(Timer&& other) NOEXCEPT;
@@ -25,8 +33,12 @@ public:
     NODISCARD std::chrono::steady_clock::duration duration() const NOEXCEPT { return mDuration; }
 
 private:
+    void drain() NOEXCEPT;
+
     std::chrono::steady_clock::duration mDuration;
     int                                 mTimerFd;
+    // An eventfd signalled by `VirtualClock` instead of a timerfd
+    bool mVirtual;
 };
 
 class TimeoutTask {
@@ -55,7 +67,8 @@ private:
 
 class RepeatableTimeoutTask {
 public:
-    EXPLICIT RepeatableTimeoutTask(std::chrono::steady_clock::duration duration) NOEXCEPT;
+    EXPLICIT RepeatableTimeoutTask(std::chrono::steady_clock::duration duration,
+                                   TimerClock clock = TimerClock::Default) NOEXCEPT;
     ~RepeatableTimeoutTask() NOEXCEPT;
 
     RepeatableTimeoutTask(RepeatableTimeoutTask&& other) NOEXCEPT;
@@ -0,0 +1,46 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace scheduler {
+
+/// Virtual time for deterministic replay faster than realtime. When enabled, timers created after
+/// that do not follow the monotonic clock, they expire when the virtual time is advanced past their
+/// deadline, e.g. by an input replaying recorded messages at their timestamps.
+///
+/// Expired timers are signalled one at a time, in deadline order and then in the order they were
+/// armed, and the scheduler is run until idle before the next one, so the order of events only
+/// depends on the recorded data. Timers armed before the clock is started are relative to the
+/// first time it is advanced to.
+class VirtualClock {
+public:
+    using Listener = std::function<void(int64_t now_us)>;
+
+    /// Enable the virtual clock. Must be called before any timer that should follow it is created.
+    static void           enable() NOEXCEPT;
+    NODISCARD static bool enabled() NOEXCEPT;
+    NODISCARD static bool started() NOEXCEPT;
+    /// Disable the virtual clock and forget all timers, the clock must not be used by any timer.
+    static void reset() NOEXCEPT;
+
+    /// Virtual time in microseconds, e.g. since the Unix epoch for recorded timestamps.
+    NODISCARD static int64_t now_us() NOEXCEPT;
+    /// Called every time the virtual time changes, e.g. to drive `ts::set_virtual_now`.
+    static void set_listener(Listener listener) NOEXCEPT;
+
+    /// Advance the virtual time to `time_us` and dispatch the timers that expire on the way. Time
+    /// never goes backwards, an earlier time is ignored.
+    static void advance_to(int64_t time_us) NOEXCEPT;
+
+    NODISCARD static size_t pending() NOEXCEPT;
+
+    // Used by `Timer`, `fd` is signalled (as an eventfd) when the timer expires
+    static void arm(int fd, std::chrono::steady_clock::duration duration, bool repeat) NOEXCEPT;
+    static void disarm(int fd) NOEXCEPT;
+};
+
+}  // namespace scheduler
@@ -4,8 +4,12 @@
 #include <sched.h>
 #include <stdexcept>
 #include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include "uring.hpp"
+
 #include <loglet/loglet.hpp>
 
 LOGLET_MODULE(sched);
@@ -35,25 +39,34 @@ void ScheduledEvent::unregister() {
     }
 }
 
-Scheduler::Scheduler() NOEXCEPT : mEpollFd(-1),
-                                  mInterruptFd(-1),
-                                  mEpollCount(0),
-                                  mMaxEventsPerWait(1),
-                                  mInterrupted(false) {
-    VSCOPE_FUNCTION();
+Scheduler::Scheduler() NOEXCEPT : Scheduler(Backend::Epoll) {}
 
-    mEpollFd = ::epoll_create1(0);
-    VERBOSEF("::epoll_create1(0) = %d", mEpollFd);
-    if (mEpollFd == -1) {
-        ERRORF("failed to create epoll instance: " ERRNO_FMT, ERRNO_ARGS(errno));
-        return;
-    }
+Scheduler::Scheduler(Backend backend) NOEXCEPT : mEpollFd(-1),
+                                                 mInterruptFd(-1),
+                                                 mEpollCount(0),
+                                                 mMaxEventsPerWait(1),
+                                                 mInterrupted(false),
+                                                 mInterruptArmed(false) {
+    VSCOPE_FUNCTIONF("%s", backend == Backend::IoUring ? "io_uring" : "epoll");
 
     mInterruptFd = ::eventfd(0, EFD_NONBLOCK);
     VERBOSEF("::eventfd(0, EFD_NONBLOCK) = %d", mInterruptFd);
     if (mInterruptFd == -1) {
         ERRORF("failed to create eventfd instance: " ERRNO_FMT, ERRNO_ARGS(errno));
-        close(mEpollFd);
+        return;
+    }
+
+    if (backend == Backend::IoUring && setup_uring()) {
+        VERBOSEF("interrupt_fd: %d", mInterruptFd);
+        return;
+    }
+
+    mEpollFd = ::epoll_create1(0);
+    VERBOSEF("::epoll_create1(0) = %d", mEpollFd);
+    if (mEpollFd == -1) {
+        ERRORF("failed to create epoll instance: " ERRNO_FMT, ERRNO_ARGS(errno));
+        close(mInterruptFd);
+        mInterruptFd = -1;
         return;
     }
 
@@ -66,6 +79,8 @@ Scheduler::Scheduler() NOEXCEPT : mEpollFd(-1),
         ERRORF("failed to add eventfd to epoll instance: " ERRNO_FMT, ERRNO_ARGS(errno));
         close(mEpollFd);
         close(mInterruptFd);
+        mEpollFd     = -1;
+        mInterruptFd = -1;
         return;
     }
 
@@ -75,6 +90,7 @@ Scheduler::Scheduler() NOEXCEPT : mEpollFd(-1),
 
 Scheduler::~Scheduler() NOEXCEPT {
     VSCOPE_FUNCTION();
+    mUring.reset();
     if (mEpollFd != -1) {
         auto reslut = ::close(mEpollFd);
         VERBOSEF("::close(%d) = %d", mEpollFd, reslut);
@@ -87,12 +103,318 @@ Scheduler::~Scheduler() NOEXCEPT {
     }
 }
 
+#if defined(HAVE_IO_URING)
+// io_uring user data of the interrupt poll, poll removals and cancellations complete with 0
+static CONSTEXPR uint64_t INTERRUPT_DATA = 1ULL << 63;
+// Request type in the user data of a slot, polls are 0 and also carry the arm sequence
+static CONSTEXPR uint64_t REQUEST_SHIFT   = 48;
+static CONSTEXPR uint64_t REQUEST_MASK    = 3ULL << REQUEST_SHIFT;
+static CONSTEXPR uint64_t REQUEST_RECEIVE = 1ULL << REQUEST_SHIFT;
+static CONSTEXPR uint64_t REQUEST_SEND    = 2ULL << REQUEST_SHIFT;
+// Shared by all receiving sockets, a receive that runs out of buffers is re-armed after the
+// buffers have been processed
+static CONSTEXPR unsigned RECEIVE_BUFFER_COUNT = 256;
+static CONSTEXPR unsigned RECEIVE_BUFFER_SIZE  = 4096;
+#endif
+
+bool Scheduler::setup_uring() NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    std::unique_ptr<Uring> uring{new Uring()};
+    if (!uring->setup(256)) {
+        DEBUGF("io_uring is not supported, using epoll");
+        return false;
+    }
+    if (!uring->setup_buffers(RECEIVE_BUFFER_COUNT, RECEIVE_BUFFER_SIZE)) {
+        DEBUGF("io_uring completions are not supported, sockets are read when ready");
+    }
+
+    mUring = std::move(uring);
+    VERBOSEF("io_uring_fd: %d", mUring->fd());
+    return true;
+#else
+    DEBUGF("io_uring is not compiled in, using epoll");
+    return false;
+#endif
+}
+
+Backend Scheduler::backend() const NOEXCEPT {
+    return mUring ? Backend::IoUring : Backend::Epoll;
+}
+
+bool Scheduler::completions() const NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    return mUring && mUring->has_buffers();
+#else
+    return false;
+#endif
+}
+
+bool Scheduler::initialized() const NOEXCEPT {
+    return (mEpollFd != -1 || mUring) && mInterruptFd != -1;
+}
+
 #define EVENT_COUNT 32
 
+
+int Scheduler::wait(int timeout_ms) NOEXCEPT {
+    if (mUring) {
+        auto max_events = mMaxEventsPerWait < 1 ? 1 : mMaxEventsPerWait;
+        return wait_uring(max_events < EVENT_COUNT ? max_events : EVENT_COUNT, timeout_ms);
+    }
+
+    auto nfds = ::epoll_pwait(mEpollFd, mEvents, EVENT_COUNT, timeout_ms, nullptr);
+    VERBOSEF("::epoll_pwait(%d, %p, %d, %d, nullptr) = %d", mEpollFd, mEvents, EVENT_COUNT,
+             timeout_ms, nfds);
+    return nfds;
+}
+
+// Poll requests are one-shot, a slot is re-armed with its current interests before the next wait
+// which keeps the level-triggered behavior of epoll. Completions that will not be processed in this
+// iteration are left in the completion ring, the next wait takes them without a system call.
+// Receive and send completions are passed on as events that refer to `mCompletions`.
+int Scheduler::wait_uring(int max_events, int timeout_ms) NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    if (!mUring->pending()) {
+        for (auto index : mArmQueue) {
+            auto& slot      = mEventPool[index];
+            slot.arm_queued = false;
+            if (!slot.in_use) continue;
+
+            ScheduledEvent handle{index, slot.generation};
+            if (slot.on_receive && !slot.receiving) {
+                slot.receiving = true;
+                slot.in_flight++;
+                mUring->recv_multishot(slot.fd, encode_request(handle, REQUEST_RECEIVE));
+            }
+            if (!slot.send_data.empty() && slot.send_length == 0) submit_send(handle);
+            if (slot.armed) continue;
+
+            // The data is read by the receive request, the poll request reports the other events
+            auto events = slot.on_receive ? slot.events & ~static_cast<uint32_t>(EPOLLIN) :
+                                            slot.events;
+            slot.arm++;
+            slot.armed = true;
+            mUring->poll_add(slot.fd, events, encode_arm(handle, slot.arm));
+        }
+        mArmQueue.clear();
+
+        if (!mInterruptArmed) {
+            mUring->poll_add(mInterruptFd, EPOLLIN, INTERRUPT_DATA);
+            mInterruptArmed = true;
+        }
+
+        auto result = mUring->submit_and_wait(timeout_ms);
+        if (result < 0) {
+            errno = -result;
+            return -1;
+        }
+    }
+
+    struct io_uring_cqe cqes[EVENT_COUNT];
+    int                 nfds = 0;
+    while (nfds < max_events) {
+        auto count = mUring->reap(cqes, static_cast<size_t>(max_events - nfds));
+        if (count == 0) break;
+
+        for (size_t i = 0; i < count; i++) {
+            auto const& cqe = cqes[i];
+            if (cqe.user_data == 0) continue;
+
+            struct epoll_event event;
+            event.data.u64 = 0;
+            if (cqe.user_data == INTERRUPT_DATA) {
+                mInterruptArmed = false;
+                event.data.fd   = mInterruptFd;
+            } else if (cqe.user_data & REQUEST_MASK) {
+                mCompletions[nfds].result = cqe.res;
+                mCompletions[nfds].flags  = cqe.flags;
+                event.data.u64            = cqe.user_data;
+                event.events              = static_cast<uint32_t>(nfds);
+                mEvents[nfds++]           = event;
+                continue;
+            } else {
+                auto  handle = decode_handle(cqe.user_data);
+                auto  arm    = static_cast<uint16_t>(cqe.user_data >> 32);
+                auto* slot   = get_slot(handle);
+                if (!slot || !slot->armed || slot->arm != arm) {
+                    VERBOSEF("completion stale %04x:%04x", handle.index, handle.generation);
+                    continue;
+                }
+
+                slot->armed = false;
+                queue_arm(handle.index);
+                event.data.u64 = encode_handle(handle);
+            }
+
+            event.events    = cqe.res < 0 ? EPOLLERR : static_cast<uint32_t>(cqe.res);
+            mEvents[nfds++] = event;
+        }
+    }
+    return nfds;
+#else
+    (void)max_events;
+    (void)timeout_ms;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+void Scheduler::queue_arm(uint16_t index) NOEXCEPT {
+    auto& slot = mEventPool[index];
+    if (slot.arm_queued) return;
+    slot.arm_queued = true;
+    mArmQueue.push_back(index);
+}
+
+void Scheduler::disarm(ScheduledEvent event) NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    auto& slot = mEventPool[event.index];
+    if (!slot.armed) return;
+
+    slot.armed = false;
+    mUring->poll_remove(encode_arm(event, slot.arm));
+#else
+    (void)event;
+#endif
+}
+
+void Scheduler::cancel_requests(ScheduledEvent event) NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    auto& slot = mEventPool[event.index];
+    disarm(event);
+    if (slot.receiving) mUring->cancel(encode_request(event, REQUEST_RECEIVE));
+    if (slot.send_length > 0) mUring->cancel(encode_request(event, REQUEST_SEND));
+    if (!mUring->submit()) {
+        ERRORF("failed to cancel requests of %04x:%04x", event.index, event.generation);
+    }
+#else
+    (void)event;
+#endif
+}
+
+bool Scheduler::receive(ScheduledEvent                         event,
+                        std::function<void(uint8_t*, ssize_t)> callback) NOEXCEPT {
+    VSCOPE_FUNCTIONF("{%u, %u}", event.index, event.generation);
+    if (!completions()) return false;
+
+    auto* slot = get_slot(event);
+    if (!slot) {
+        ERRORF("invalid event handle or generation mismatch");
+        return false;
+    }
+
+    DEBUGF("event receive %04x:%04x \"%s\"", event.index, event.generation, slot->name.c_str());
+    slot->on_receive = std::move(callback);
+    // The armed poll request also waits for the data
+    disarm(event);
+    queue_arm(event.index);
+    return true;
+}
+
+bool Scheduler::send(ScheduledEvent event, struct iovec const* iov, size_t count,
+                     std::function<void(ssize_t)> callback) NOEXCEPT {
+    VSCOPE_FUNCTIONF("{%u, %u}, %zu", event.index, event.generation, count);
+    if (!completions()) return false;
+
+    auto* slot = get_slot(event);
+    if (!slot) {
+        ERRORF("invalid event handle or generation mismatch");
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        auto data = static_cast<uint8_t const*>(iov[i].iov_base);
+        slot->send_data.insert(slot->send_data.end(), data, data + iov[i].iov_len);
+    }
+    slot->on_send = std::move(callback);
+    // Everything queued until the next wait is sent with one request
+    if (slot->send_length == 0) queue_arm(event.index);
+    return true;
+}
+
+void Scheduler::submit_send(ScheduledEvent event) NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    auto& slot       = mEventPool[event.index];
+    slot.send_length = slot.send_data.size();
+    slot.in_flight++;
+    mUring->send(slot.fd, slot.send_data.data(), slot.send_length,
+                 encode_request(event, REQUEST_SEND));
+#else
+    (void)event;
+#endif
+}
+
+bool Scheduler::is_completion(struct epoll_event const& event) const NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    return mUring && (event.data.u64 & REQUEST_MASK) != 0;
+#else
+    (void)event;
+    return false;
+#endif
+}
+
+// The slot of a completion is still allocated, even if it has been unregistered, as slots are not
+// freed while they have requests in the kernel.
+void Scheduler::process_completion(uint64_t user_data, int32_t result, uint32_t flags) NOEXCEPT {
+#if defined(HAVE_IO_URING)
+    auto  handle = decode_handle(user_data);
+    auto& slot   = mEventPool[handle.index];
+    auto  active = get_slot(handle) != nullptr;
+
+    if ((user_data & REQUEST_MASK) == REQUEST_SEND) {
+        slot.in_flight--;
+        slot.send_length = 0;
+        VERBOSEF("event %04x:%04x sent %d", handle.index, handle.generation, result);
+        if (result <= 0 || !active) {
+            // The rest of the queue is dropped with the request
+            slot.send_data.clear();
+        } else {
+            // Nothing is in flight, the bytes queued behind the request move to the front. A
+            // partial send leaves its rest in front of them.
+            slot.send_data.erase(slot.send_data.begin(), slot.send_data.begin() + result);
+            if (!slot.send_data.empty()) submit_send(handle);
+        }
+        if (!active || !slot.on_send) return;
+
+        // The callback may queue more data and replace itself
+        auto callback = std::move(slot.on_send);
+        slot.on_send  = nullptr;
+        callback(result);
+        if (!slot.on_send) slot.on_send = std::move(callback);
+        return;
+    }
+
+    auto more = (flags & IORING_CQE_F_MORE) != 0;
+    if (!more) {
+        slot.receiving = false;
+        slot.in_flight--;
+    }
+
+    uint8_t* data = nullptr;
+    auto     id   = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+    if (flags & IORING_CQE_F_BUFFER) data = mUring->buffer(id);
+
+    VERBOSEF("event %04x:%04x received %d%s", handle.index, handle.generation, result,
+             more ? "" : " (done)");
+    // Running out of buffers only ends the receive
+    if (active && slot.on_receive && result != -ENOBUFS) slot.on_receive(data, result);
+    if (data) mUring->recycle_buffer(id);
+
+    // Receive again unless the connection was closed, failed or the callback unregistered it
+    if (!more && get_slot(handle) && slot.on_receive && (result > 0 || result == -ENOBUFS)) {
+        queue_arm(handle.index);
+    }
+#else
+    (void)user_data;
+    (void)result;
+    (void)flags;
+#endif
+}
+
 ExecuteResult Scheduler::execute() NOEXCEPT {
     VSCOPE_FUNCTION();
-    if (mEpollFd == -1 || mInterruptFd == -1) {
-        ERRORF("epoll_fd or interrupt_fd is not initialized");
+    if (!initialized()) {
+        ERRORF("scheduler is not initialized");
         return ExecuteResult::Error;
     }
 
@@ -112,9 +434,7 @@ ExecuteResult Scheduler::execute() NOEXCEPT {
 
         // Wait for a file descriptor to become ready.
         VERBOSEF("waiting for events (%d file descriptors)", mEpollCount);
-        auto nfds = ::epoll_pwait(mEpollFd, mEvents, EVENT_COUNT, -1, nullptr);
-        VERBOSEF("::epoll_pwait(%d, %p, %d, -1, nullptr) = %d", mEpollFd, mEvents, EVENT_COUNT,
-                 nfds);
+        auto nfds = wait(-1);
         if (nfds == -1) {
             if (errno == EINTR) {
                 continue;
@@ -135,8 +455,8 @@ ExecuteResult Scheduler::execute() NOEXCEPT {
 
 ExecuteResult Scheduler::execute_timeout(std::chrono::steady_clock::duration duration) NOEXCEPT {
     VSCOPE_FUNCTION();
-    if (mEpollFd == -1 || mInterruptFd == -1) {
-        ERRORF("epoll_fd or interrupt_fd is not initialized");
+    if (!initialized()) {
+        ERRORF("scheduler is not initialized");
         return ExecuteResult::Error;
     }
 
@@ -151,7 +471,7 @@ ExecuteResult Scheduler::execute_timeout(std::chrono::steady_clock::duration dur
             return ExecuteResult::Interrupted;
         }
 
-        // Calculate the timeout for epoll_pwait.
+        // Calculate the timeout for the wait.
         now = std::chrono::steady_clock::now();
         if (now >= end) {
             VERBOSEF("timeout expired");
@@ -169,9 +489,7 @@ ExecuteResult Scheduler::execute_timeout(std::chrono::steady_clock::duration dur
         // Wait for a file descriptor to become ready. Even if the mEpollCount is 0, we still need
         // to wait for the timeout to expire.
         VERBOSEF("waiting for events (%d file descriptors, %d ms)", mEpollCount, timeout_ms);
-        auto nfds = ::epoll_pwait(mEpollFd, mEvents, EVENT_COUNT, timeout_ms, nullptr);
-        VERBOSEF("::epoll_pwait(%d, %p, %d, %d, nullptr) = %d", mEpollFd, mEvents, EVENT_COUNT,
-                 timeout_ms, nfds);
+        auto nfds = wait(timeout_ms);
         if (nfds == -1) {
             if (errno == EINTR) {
                 VERBOSEF("timeout expired");
@@ -187,6 +505,10 @@ ExecuteResult Scheduler::execute_timeout(std::chrono::steady_clock::duration dur
             now = std::chrono::steady_clock::now();
             if (now >= end) {
                 VERBOSEF("timeout expired (skipping events)");
+                // Poll requests are re-armed, but completions are not reported again
+                for (; i < to_process; i++) {
+                    if (is_completion(mEvents[i])) process_event(mEvents[i]);
+                }
                 return ExecuteResult::Timeout;
             }
 
@@ -199,8 +521,8 @@ ExecuteResult Scheduler::execute_timeout(std::chrono::steady_clock::duration dur
 
 ExecuteResult Scheduler::execute_while(std::function<bool()> condition) NOEXCEPT {
     VSCOPE_FUNCTION();
-    if (mEpollFd == -1 || mInterruptFd == -1) {
-        ERRORF("epoll_fd or interrupt_fd is not initialized");
+    if (!initialized()) {
+        ERRORF("scheduler is not initialized");
         return ExecuteResult::Error;
     }
 
@@ -218,9 +540,7 @@ ExecuteResult Scheduler::execute_while(std::function<bool()> condition) NOEXCEPT
 
         // Wait for a file descriptor to become ready.
         VERBOSEF("waiting for events (%d file descriptors, while)", mEpollCount);
-        auto nfds = ::epoll_pwait(mEpollFd, mEvents, EVENT_COUNT, -1, nullptr);
-        VERBOSEF("::epoll_pwait(%d, %p, %d, -1, nullptr) = %d", mEpollFd, mEvents, EVENT_COUNT,
-                 nfds);
+        auto nfds = wait(-1);
         if (nfds == -1) {
             if (errno == EINTR) {
                 continue;
@@ -241,8 +561,8 @@ ExecuteResult Scheduler::execute_while(std::function<bool()> condition) NOEXCEPT
 
 ExecuteResult Scheduler::execute_once() NOEXCEPT {
     VSCOPE_FUNCTION();
-    if (mEpollFd == -1 || mInterruptFd == -1) {
-        ERRORF("epoll_fd or interrupt_fd is not initialized");
+    if (!initialized()) {
+        ERRORF("scheduler is not initialized");
         return ExecuteResult::Error;
     }
 
@@ -256,9 +576,7 @@ ExecuteResult Scheduler::execute_once() NOEXCEPT {
 
         // Wait for a file descriptor to become ready.
         VERBOSEF("waiting for events (%d file descriptors, while)", mEpollCount);
-        auto nfds = ::epoll_pwait(mEpollFd, mEvents, EVENT_COUNT, 0, nullptr);
-        VERBOSEF("::epoll_pwait(%d, %p, %d, 0, nullptr) = %d", mEpollFd, mEvents, EVENT_COUNT,
-                 nfds);
+        auto nfds = wait(0);
         if (nfds == -1) {
             if (errno == EINTR) {
                 continue;
@@ -314,6 +632,12 @@ void Scheduler::process_event(struct epoll_event& event) NOEXCEPT {
         return;
     }
 
+    if (is_completion(event)) {
+        auto const& completion = mCompletions[event.events];
+        process_completion(event.data.u64, completion.result, completion.flags);
+        return;
+    }
+
     auto  handle = decode_handle(event.data.u64);
     auto* slot   = get_slot(handle);
     if (!slot) {
@@ -343,12 +667,17 @@ void Scheduler::defer(std::function<void(scheduler::Scheduler&)> callback) NOEXC
 }
 
 void Scheduler::process_deferred() {
-    for (auto& slot : mEventPool) {
-        if (slot.pending_free) {
+    for (size_t i = 0; i < mEventPool.size(); i++) {
+        auto& slot = mEventPool[i];
+        if (slot.pending_free && slot.in_flight == 0) {
             slot.pending_free = false;
             slot.callback     = nullptr;
+            slot.on_receive   = nullptr;
+            slot.on_send      = nullptr;
+            slot.send_data.clear();
             slot.name.clear();
             slot.fd = -1;
+            mFreeSlots.push_back(static_cast<uint16_t>(i));
         }
     }
 
@@ -371,6 +700,14 @@ uint64_t Scheduler::encode_handle(ScheduledEvent h) NOEXCEPT {
     return (static_cast<uint64_t>(h.generation) << 16) | h.index;
 }
 
+uint64_t Scheduler::encode_arm(ScheduledEvent h, uint16_t arm) NOEXCEPT {
+    return (static_cast<uint64_t>(arm) << 32) | encode_handle(h);
+}
+
+uint64_t Scheduler::encode_request(ScheduledEvent h, uint64_t request) NOEXCEPT {
+    return request | encode_handle(h);
+}
+
 ScheduledEvent Scheduler::decode_handle(uint64_t v) NOEXCEPT {
     return {static_cast<uint16_t>(v), static_cast<uint16_t>(v >> 16)};
 }
@@ -395,7 +732,7 @@ EventInterest Scheduler::epoll_to_interests(uint32_t e) NOEXCEPT {
 
 EventSlot* Scheduler::get_slot(ScheduledEvent handle) NOEXCEPT {
     if (!handle.valid()) return nullptr;
-    if (handle.index >= MAX_EVENT_SLOTS) return nullptr;
+    if (handle.index >= mEventPool.size()) return nullptr;
     auto& slot = mEventPool[handle.index];
     if (!slot.in_use || slot.generation != handle.generation) return nullptr;
     return &slot;
@@ -403,7 +740,7 @@ EventSlot* Scheduler::get_slot(ScheduledEvent handle) NOEXCEPT {
 
 bool Scheduler::is_stale(ScheduledEvent handle) NOEXCEPT {
     if (!handle.valid()) return false;
-    if (handle.index >= MAX_EVENT_SLOTS) return true;
+    if (handle.index >= mEventPool.size()) return true;
     auto& slot = mEventPool[handle.index];
     return slot.pending_free || slot.generation != handle.generation;
 }
@@ -412,20 +749,19 @@ ScheduledEvent Scheduler::register_fd(int fd, EventInterest interests,
                                       std::function<void(EventInterest)> callback,
                                       std::string                        name) NOEXCEPT {
     VSCOPE_FUNCTIONF("%d, %u, %s", fd, static_cast<uint32_t>(interests), name.c_str());
-    if (mEpollFd == -1 || mInterruptFd == -1) {
-        ERRORF("epoll_fd or interrupt_fd is not initialized");
+    if (!initialized()) {
+        ERRORF("scheduler is not initialized");
         return ScheduledEvent::invalid();
     }
 
     int slot_index = -1;
-    for (int i = 0; i < MAX_EVENT_SLOTS; i++) {
-        if (!mEventPool[i].in_use && !mEventPool[i].pending_free) {
-            slot_index = i;
-            break;
-        }
-    }
-
-    if (slot_index == -1) {
+    if (!mFreeSlots.empty()) {
+        slot_index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    } else if (mEventPool.size() < static_cast<size_t>(MAX_EVENT_SLOTS)) {
+        slot_index = static_cast<int>(mEventPool.size());
+        mEventPool.emplace_back();
+    } else {
         ERRORF("event pool exhausted");
         return ScheduledEvent::invalid();
     }
@@ -440,21 +776,38 @@ ScheduledEvent Scheduler::register_fd(int fd, EventInterest interests,
     DEBUGF("event register %04x:%04x \"%s\"", slot_index, slot.generation, slot.name.c_str());
 
     ScheduledEvent handle{static_cast<uint16_t>(slot_index), slot.generation};
-
-    struct epoll_event epoll_event;
-    epoll_event.events   = interests_to_epoll(interests);
-    epoll_event.data.u64 = encode_handle(handle);
-    auto result          = ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &epoll_event);
-    VERBOSEF("::epoll_ctl(%d, EPOLL_CTL_ADD, %d, %p) = %d", mEpollFd, fd, &epoll_event, result);
+    slot.events = interests_to_epoll(interests);
+    slot.armed  = false;
+
+    int result;
+    if (mUring) {
+        // Match epoll, which refuses unknown file descriptors and files that are always ready
+        struct stat st;
+        result = ::fstat(fd, &st);
+        VERBOSEF("::fstat(%d, %p) = %d", fd, &st, result);
+        if (result == 0 && (S_ISREG(st.st_mode) || S_ISDIR(st.st_mode))) {
+            errno  = EPERM;
+            result = -1;
+        }
+    } else {
+        struct epoll_event epoll_event;
+        epoll_event.events   = slot.events;
+        epoll_event.data.u64 = encode_handle(handle);
+        result               = ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &epoll_event);
+        VERBOSEF("::epoll_ctl(%d, EPOLL_CTL_ADD, %d, %p) = %d", mEpollFd, fd, &epoll_event,
+                 result);
+    }
     if (result == -1) {
-        ERRORF("failed to add file descriptor to epoll instance: " ERRNO_FMT, ERRNO_ARGS(errno));
+        ERRORF("failed to register file descriptor: " ERRNO_FMT, ERRNO_ARGS(errno));
         slot.in_use   = false;
         slot.callback = nullptr;
         slot.name.clear();
         slot.fd = -1;
+        mFreeSlots.push_back(handle.index);
         return ScheduledEvent::invalid();
     }
 
+    if (mUring) queue_arm(handle.index);
     mEpollCount++;
     return handle;
 }
@@ -462,8 +815,8 @@ ScheduledEvent Scheduler::register_fd(int fd, EventInterest interests,
 void Scheduler::update_interests(ScheduledEvent event, EventInterest interests) NOEXCEPT {
     VSCOPE_FUNCTIONF("{%u, %u}, %u", event.index, event.generation,
                      static_cast<uint32_t>(interests));
-    if (mEpollFd == -1 || mInterruptFd == -1) {
-        ERRORF("epoll_fd or interrupt_fd is not initialized");
+    if (!initialized()) {
+        ERRORF("scheduler is not initialized");
         return;
     }
 
@@ -476,8 +829,16 @@ void Scheduler::update_interests(ScheduledEvent event, EventInterest interests)
     DEBUGF("event interests %04x:%04x \"%s\" to %u", event.index, event.generation,
            slot->name.c_str(), static_cast<uint32_t>(interests));
 
+    slot->events = interests_to_epoll(interests);
+    if (mUring) {
+        // The armed poll request waits for the old interests
+        disarm(event);
+        queue_arm(event.index);
+        return;
+    }
+
     struct epoll_event epoll_event;
-    epoll_event.events   = interests_to_epoll(interests);
+    epoll_event.events   = slot->events;
     epoll_event.data.u64 = encode_handle(event);
     auto result          = ::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, slot->fd, &epoll_event);
     VERBOSEF("::epoll_ctl(%d, EPOLL_CTL_MOD, %d, %p) = %d", mEpollFd, slot->fd, &epoll_event,
@@ -502,8 +863,8 @@ void Scheduler::update_callback(ScheduledEvent                     event,
 
 void Scheduler::unregister(ScheduledEvent event) NOEXCEPT {
     VSCOPE_FUNCTIONF("{%u, %u}", event.index, event.generation);
-    if (mEpollFd == -1 || mInterruptFd == -1) {
-        ERRORF("epoll_fd or interrupt_fd is not initialized");
+    if (!initialized()) {
+        ERRORF("scheduler is not initialized");
         return;
     }
 
@@ -514,11 +875,16 @@ void Scheduler::unregister(ScheduledEvent event) NOEXCEPT {
     }
 
     DEBUGF("event unregister %04x:%04x \"%s\"", event.index, event.generation, slot->name.c_str());
-    auto result = ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, slot->fd, nullptr);
-    VERBOSEF("::epoll_ctl(%d, EPOLL_CTL_DEL, %d, nullptr) = %d", mEpollFd, slot->fd, result);
-    if (result == -1) {
-        ERRORF("failed to remove file descriptor from epoll instance: " ERRNO_FMT,
-               ERRNO_ARGS(errno));
+    if (mUring) {
+        // The requests hold a reference to the file, remove them before the caller closes it
+        cancel_requests(event);
+    } else {
+        auto result = ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, slot->fd, nullptr);
+        VERBOSEF("::epoll_ctl(%d, EPOLL_CTL_DEL, %d, nullptr) = %d", mEpollFd, slot->fd, result);
+        if (result == -1) {
+            ERRORF("failed to remove file descriptor from epoll instance: " ERRNO_FMT,
+                   ERRNO_ARGS(errno));
+        }
     }
 
     slot->in_use       = false;
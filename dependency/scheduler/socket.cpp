@@ -621,13 +621,9 @@ bool TcpConnectTask::connect() NOEXCEPT {
             return false;
         }
     } else {
-        // connection is already established
+        // connection is already established, `schedule` reports it once the socket is registered
         VERBOSEF("connection established");
         mState = StateConnected;
-
-        if (on_connected) {
-            on_connected(*this);
-        }
     }
 
     return true;
@@ -803,6 +799,9 @@ bool TcpConnectTask::schedule(Scheduler& scheduler) NOEXCEPT {
         mConnected   = false;
         mScheduler   = &scheduler;
         mIsScheduled = true;
+        if (mState == StateConnected && on_connected) {
+            on_connected(*this);
+        }
         return true;
     } else {
         mState = StateError;
@@ -833,4 +832,17 @@ void TcpConnectTask::update_interests(EventInterest interests) NOEXCEPT {
     mScheduler->update_interests(mEvent, interests);
 }
 
+bool TcpConnectTask::receive(std::function<void(uint8_t*, ssize_t)> callback) NOEXCEPT {
+    VSCOPE_FUNCTIONF(") (state=%s", state_to_string(mState));
+    if (!mIsScheduled || !mScheduler) return false;
+    return mScheduler->receive(mEvent, std::move(callback));
+}
+
+bool TcpConnectTask::send(struct iovec const* iov, size_t count,
+                          std::function<void(ssize_t)> callback) NOEXCEPT {
+    VSCOPE_FUNCTIONF("%zu) (state=%s", count, state_to_string(mState));
+    if (!mIsScheduled || !mScheduler) return false;
+    return mScheduler->send(mEvent, iov, count, std::move(callback));
+}
+
 }  // namespace scheduler
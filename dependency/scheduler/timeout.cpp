@@ -1,7 +1,9 @@
 #include "timeout.hpp"
+#include "virtual_clock.hpp"
 
 #include <cerrno>
 #include <cstring>
+#include <sys/eventfd.h>
 #include <sys/timerfd.h>
 #include <unistd.h>
 #include <utility>
@@ -18,9 +20,20 @@ namespace scheduler {
 // Timer
 //
 
-Timer::Timer(std::chrono::steady_clock::duration duration) NOEXCEPT : mDuration{duration},
-                                                                      mTimerFd{-1} {
+Timer::Timer(std::chrono::steady_clock::duration duration, TimerClock clock) NOEXCEPT
+    : mDuration{duration},
+      mTimerFd{-1},
+      mVirtual{clock == TimerClock::Default && VirtualClock::enabled()} {
     VSCOPE_FUNCTION();
+    if (mVirtual) {
+        mTimerFd = ::eventfd(0, EFD_NONBLOCK);
+        VERBOSEF("::eventfd(0, EFD_NONBLOCK) = %d", mTimerFd);
+        if (mTimerFd < 0) {
+            ERRORF("failed to create eventfd: " ERRNO_FMT, ERRNO_ARGS(errno));
+        }
+        return;
+    }
+
     mTimerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
     VERBOSEF("::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK) = %d", mTimerFd);
     if (mTimerFd < 0) {
@@ -31,28 +44,47 @@ Timer::Timer(std::chrono::steady_clock::duration duration) NOEXCEPT : mDuration{
 Timer::~Timer() NOEXCEPT {
     VSCOPE_FUNCTION();
     if (mTimerFd >= 0) {
+        if (mVirtual) VirtualClock::disarm(mTimerFd);
         auto result = ::close(mTimerFd);
         VERBOSEF("::close(%d) = %d", mTimerFd, result);
     }
 }
 
-Timer::Timer(Timer&& other) NOEXCEPT : mDuration{other.mDuration}, mTimerFd{other.mTimerFd} {
+Timer::Timer(Timer&& other) NOEXCEPT : mDuration{other.mDuration},
+                                       mTimerFd{other.mTimerFd},
+                                       mVirtual{other.mVirtual} {
     other.mTimerFd = -1;
 }
 
 Timer& Timer::operator=(Timer&& other) NOEXCEPT {
     if (this != &other) {
-        if (mTimerFd >= 0) ::close(mTimerFd);
+        if (mTimerFd >= 0) {
+            if (mVirtual) VirtualClock::disarm(mTimerFd);
+            ::close(mTimerFd);
+        }
         mDuration      = other.mDuration;
         mTimerFd       = other.mTimerFd;
+        mVirtual       = other.mVirtual;
         other.mTimerFd = -1;
     }
     return *this;
 }
 
+void Timer::drain() NOEXCEPT {
+    // Like re-arming a timerfd, forget expirations that have not been read
+    uint64_t value  = 0;
+    auto     result = ::read(mTimerFd, &value, sizeof(value));
+    (void)result;
+}
+
 void Timer::arm(bool repeat) NOEXCEPT {
     VSCOPE_FUNCTION();
     if (mTimerFd < 0) return;
+    if (mVirtual) {
+        drain();
+        VirtualClock::arm(mTimerFd, mDuration, repeat);
+        return;
+    }
 
     auto seconds = std::chrono::duration_cast<std::chrono::seconds>(mDuration).count();
     auto nanoseconds =
@@ -81,6 +113,11 @@ void Timer::arm(bool repeat) NOEXCEPT {
 void Timer::disarm() NOEXCEPT {
     VSCOPE_FUNCTION();
     if (mTimerFd < 0) return;
+    if (mVirtual) {
+        VirtualClock::disarm(mTimerFd);
+        drain();
+        return;
+    }
 
     struct itimerspec its{};
     auto              result = ::timerfd_settime(mTimerFd, 0, &its, nullptr);
@@ -169,9 +206,10 @@ void TimeoutTask::cancel() NOEXCEPT {
 // RepeatableTimeoutTask
 //
 
-RepeatableTimeoutTask::RepeatableTimeoutTask(std::chrono::steady_clock::duration duration) NOEXCEPT
+RepeatableTimeoutTask::RepeatableTimeoutTask(std::chrono::steady_clock::duration duration,
+                                             TimerClock                          clock) NOEXCEPT
     : callback{},
-      mTimer{duration},
+      mTimer{duration, clock},
       mEvent{ScheduledEvent::invalid()} {
     VSCOPE_FUNCTION();
 }
@@ -0,0 +1,341 @@
+#include "uring.hpp"
+
+#if defined(HAVE_IO_URING)
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <linux/time_types.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(sched, uring);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(sched, uring)
+
+namespace scheduler {
+
+static unsigned load_acquire(unsigned const* value) NOEXCEPT {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+static void store_release(unsigned* value, unsigned new_value) NOEXCEPT {
+    __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+}
+
+// The only provided buffer group
+static CONSTEXPR uint16_t BUFFER_GROUP = 0;
+// User data of the receive that probes for multishot support
+static CONSTEXPR uint64_t PROBE_DATA = 1;
+
+Uring::Uring() NOEXCEPT : mFd(-1),
+                          mRing(MAP_FAILED),
+                          mRingSize(0),
+                          mSqes(MAP_FAILED),
+                          mSqesSize(0),
+                          mSqHead(nullptr),
+                          mSqTail(nullptr),
+                          mSqMask(0),
+                          mSqArray(nullptr),
+                          mSqQueued(0),
+                          mCqHead(nullptr),
+                          mCqTail(nullptr),
+                          mCqMask(0),
+                          mCqes(nullptr),
+                          mBufRing(nullptr),
+                          mBufRingSize(0),
+                          mBufMask(0),
+                          mBufTail(0),
+                          mBufSize(0) {}
+
+Uring::~Uring() NOEXCEPT {
+    VSCOPE_FUNCTION();
+    if (mBufRing) ::munmap(mBufRing, mBufRingSize);
+    if (mSqes != MAP_FAILED) ::munmap(mSqes, mSqesSize);
+    if (mRing != MAP_FAILED) ::munmap(mRing, mRingSize);
+    if (mFd != -1) {
+        auto result = ::close(mFd);
+        VERBOSEF("::close(%d) = %d", mFd, result);
+        mFd = -1;
+    }
+}
+
+bool Uring::setup(unsigned entries) NOEXCEPT {
+    VSCOPE_FUNCTIONF("%u", entries);
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    mFd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    VERBOSEF("::io_uring_setup(%u, %p) = %d", entries, &params, mFd);
+    if (mFd == -1) {
+        DEBUGF("io_uring is not available: " ERRNO_FMT, ERRNO_ARGS(errno));
+        return false;
+    }
+
+    // A single mapping for both rings, completions are never dropped and the wait takes a timeout
+    auto required = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & required) != required) {
+        DEBUGF("io_uring is missing required features: %08X", params.features);
+        return false;
+    }
+
+    auto sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    auto cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    mRingSize    = sq_size > cq_size ? sq_size : cq_size;
+    mRing        = ::mmap(nullptr, mRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          mFd, IORING_OFF_SQ_RING);
+    if (mRing == MAP_FAILED) {
+        ERRORF("failed to map io_uring rings: " ERRNO_FMT, ERRNO_ARGS(errno));
+        return false;
+    }
+
+    mSqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    mSqes     = ::mmap(nullptr, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mFd,
+                       IORING_OFF_SQES);
+    if (mSqes == MAP_FAILED) {
+        ERRORF("failed to map io_uring submission entries: " ERRNO_FMT, ERRNO_ARGS(errno));
+        return false;
+    }
+
+    auto ring = static_cast<uint8_t*>(mRing);
+    mSqHead   = reinterpret_cast<unsigned*>(ring + params.sq_off.head);
+    mSqTail   = reinterpret_cast<unsigned*>(ring + params.sq_off.tail);
+    mSqMask   = *reinterpret_cast<unsigned*>(ring + params.sq_off.ring_mask);
+    mSqArray  = reinterpret_cast<unsigned*>(ring + params.sq_off.array);
+    mCqHead   = reinterpret_cast<unsigned*>(ring + params.cq_off.head);
+    mCqTail   = reinterpret_cast<unsigned*>(ring + params.cq_off.tail);
+    mCqMask   = *reinterpret_cast<unsigned*>(ring + params.cq_off.ring_mask);
+    mCqes     = reinterpret_cast<struct io_uring_cqe*>(ring + params.cq_off.cqes);
+
+    DEBUGF("io_uring %d: %u submission and %u completion entries", mFd, params.sq_entries,
+           params.cq_entries);
+    return true;
+}
+
+bool Uring::setup_buffers(unsigned count, unsigned size) NOEXCEPT {
+    VSCOPE_FUNCTIONF("%u, %u", count, size);
+
+    // The ring is shared with the kernel and must be page aligned
+    mBufRingSize = count * sizeof(struct io_uring_buf);
+    auto ring    = ::mmap(nullptr, mBufRingSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        ERRORF("failed to map provided buffer ring: " ERRNO_FMT, ERRNO_ARGS(errno));
+        return false;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr    = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = count;
+    reg.bgid         = BUFFER_GROUP;
+    auto result = static_cast<int>(::syscall(__NR_io_uring_register, mFd, IORING_REGISTER_PBUF_RING,
+                                             &reg, 1));
+    VERBOSEF("::io_uring_register(%d, IORING_REGISTER_PBUF_RING, %p, 1) = %d", mFd, &reg, result);
+    if (result == -1) {
+        DEBUGF("provided buffer rings are not supported: " ERRNO_FMT, ERRNO_ARGS(errno));
+        ::munmap(ring, mBufRingSize);
+        return false;
+    }
+
+    mBufRing = static_cast<struct io_uring_buf_ring*>(ring);
+    mBufMask = count - 1;
+    mBufTail = 0;
+    mBufSize = size;
+    mBuffers.resize(static_cast<size_t>(count) * size);
+    for (unsigned i = 0; i < count; i++) {
+        recycle_buffer(static_cast<uint16_t>(i));
+    }
+
+    if (!probe_receive()) {
+        DEBUGF("multishot receives are not supported");
+        ::syscall(__NR_io_uring_register, mFd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+        ::munmap(mBufRing, mBufRingSize);
+        mBufRing = nullptr;
+        mBuffers.clear();
+        return false;
+    }
+
+    DEBUGF("io_uring %d: %u provided buffers of %u bytes", mFd, count, size);
+    return true;
+}
+
+// Provided buffer rings (5.19) are older than multishot receives (6.0), receive a byte on a socket
+// pair to find out. The peer then closes its end, which ends the receive.
+bool Uring::probe_receive() NOEXCEPT {
+    int pair[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) != 0) return false;
+
+    recv_multishot(pair[0], PROBE_DATA);
+    auto supported = ::write(pair[1], "x", 1) == 1;
+    ::close(pair[1]);
+
+    bool done = false;
+    while (supported && !done) {
+        if (!pending() && submit_and_wait(100) < 0) break;
+
+        struct io_uring_cqe cqe;
+        if (reap(&cqe, 1) == 0) {
+            supported = false;
+            break;
+        }
+
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            recycle_buffer(static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+        }
+        done = (cqe.flags & IORING_CQE_F_MORE) == 0;
+        if (cqe.res < 0 || (cqe.res == 0 && !done)) supported = false;
+        if (cqe.res == 1 && done) supported = false;
+    }
+    ::close(pair[0]);
+    return supported && done;
+}
+
+struct io_uring_sqe* Uring::next_sqe() NOEXCEPT {
+    auto tail = *mSqTail;
+    if (tail - load_acquire(mSqHead) > mSqMask) {
+        // The submission ring is full, hand the queued requests to the kernel first
+        if (!submit()) return nullptr;
+        tail = *mSqTail;
+    }
+
+    auto index      = tail & mSqMask;
+    auto sqe        = &static_cast<struct io_uring_sqe*>(mSqes)[index];
+    mSqArray[index] = index;
+    memset(sqe, 0, sizeof(*sqe));
+    store_release(mSqTail, tail + 1);
+    mSqQueued++;
+    return sqe;
+}
+
+void Uring::poll_add(int fd, uint32_t events, uint64_t user_data) NOEXCEPT {
+    auto sqe = next_sqe();
+    if (!sqe) return;
+    sqe->opcode        = IORING_OP_POLL_ADD;
+    sqe->fd            = fd;
+    sqe->poll32_events = events;
+    sqe->user_data     = user_data;
+}
+
+void Uring::poll_remove(uint64_t user_data) NOEXCEPT {
+    auto sqe = next_sqe();
+    if (!sqe) return;
+    sqe->opcode    = IORING_OP_POLL_REMOVE;
+    sqe->fd        = -1;
+    sqe->addr      = user_data;
+    sqe->user_data = 0;
+}
+
+void Uring::recv_multishot(int fd, uint64_t user_data) NOEXCEPT {
+    auto sqe = next_sqe();
+    if (!sqe) return;
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = fd;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = user_data;
+}
+
+void Uring::send(int fd, void const* data, size_t length, uint64_t user_data) NOEXCEPT {
+    auto sqe = next_sqe();
+    if (!sqe) return;
+    sqe->opcode    = IORING_OP_SEND;
+    sqe->fd        = fd;
+    sqe->addr      = reinterpret_cast<uint64_t>(data);
+    sqe->len       = static_cast<uint32_t>(length);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+void Uring::cancel(uint64_t user_data) NOEXCEPT {
+    auto sqe = next_sqe();
+    if (!sqe) return;
+    sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+    sqe->fd        = -1;
+    sqe->addr      = user_data;
+    sqe->user_data = 0;
+}
+
+uint8_t* Uring::buffer(uint16_t id) NOEXCEPT {
+    return mBuffers.data() + static_cast<size_t>(id) * mBufSize;
+}
+
+void Uring::recycle_buffer(uint16_t id) NOEXCEPT {
+    // The tail overlays the reserved field of the first entry, only set the other fields. `bufs`
+    // is not used as the empty struct in front of it has a size in C++ and moves it.
+    auto  entries = reinterpret_cast<struct io_uring_buf*>(mBufRing);
+    auto& entry   = entries[mBufTail & mBufMask];
+    entry.addr  = reinterpret_cast<uint64_t>(buffer(id));
+    entry.len   = mBufSize;
+    entry.bid   = id;
+    mBufTail++;
+    __atomic_store_n(&mBufRing->tail, mBufTail, __ATOMIC_RELEASE);
+}
+
+int Uring::enter(unsigned min_complete, int timeout_ms) NOEXCEPT {
+    struct __kernel_timespec      ts;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    if (timeout_ms > 0) {
+        ts.tv_sec  = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+        arg.ts     = reinterpret_cast<uint64_t>(&ts);
+    }
+    arg.sigmask_sz = _NSIG / 8;
+
+    auto to_submit = mSqQueued;
+    auto flags     = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    auto result    = static_cast<int>(::syscall(__NR_io_uring_enter, mFd, to_submit, min_complete,
+                                                flags, &arg, sizeof(arg)));
+    VERBOSEF("::io_uring_enter(%d, %u, %u, %u, %p, %zu) = %d", mFd, to_submit, min_complete,
+             flags, &arg, sizeof(arg), result);
+    if (result >= 0) {
+        mSqQueued -= static_cast<unsigned>(result) < to_submit ? static_cast<unsigned>(result) :
+                                                                 to_submit;
+        return 0;
+    }
+
+    // A timed out wait still submits the queued requests
+    if (errno == ETIME) {
+        mSqQueued = 0;
+        return 0;
+    }
+    return -errno;
+}
+
+bool Uring::submit() NOEXCEPT {
+    if (mSqQueued == 0) return true;
+    auto result = enter(0, 0);
+    if (result < 0) {
+        ERRORF("failed to submit io_uring requests: " ERRNO_FMT, ERRNO_ARGS(-result));
+        return false;
+    }
+    return true;
+}
+
+int Uring::submit_and_wait(int timeout_ms) NOEXCEPT {
+    return enter(timeout_ms == 0 ? 0 : 1, timeout_ms);
+}
+
+size_t Uring::reap(struct io_uring_cqe* cqes, size_t count) NOEXCEPT {
+    auto   head   = *mCqHead;
+    auto   tail   = load_acquire(mCqTail);
+    size_t reaped = 0;
+    while (head != tail && reaped < count) {
+        cqes[reaped++] = mCqes[head & mCqMask];
+        head++;
+    }
+    store_release(mCqHead, head);
+    return reaped;
+}
+
+bool Uring::pending() const NOEXCEPT {
+    return *mCqHead != load_acquire(mCqTail);
+}
+
+}  // namespace scheduler
+#endif
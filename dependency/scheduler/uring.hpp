@@ -0,0 +1,92 @@
+#pragma once
+#include <core/core.hpp>
+
+#if defined(HAVE_IO_URING)
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <vector>
+
+namespace scheduler {
+
+/// Minimal io_uring used by the scheduler. Interests are one-shot poll requests, the scheduler
+/// re-arms them after each completion. Sockets can instead be read with multishot receives into a
+/// ring of provided buffers and written with send requests. Requests are queued in the submission
+/// ring and submitted together with the next wait, so a loop iteration costs a single
+/// `io_uring_enter`.
+class Uring {
+public:
+    Uring() NOEXCEPT;
+    ~Uring() NOEXCEPT;
+
+    Uring(Uring const&)            = delete;
+    Uring& operator=(Uring const&) = delete;
+
+    /// Create the ring, fails if the kernel does not support io_uring or lacks the features used.
+    NODISCARD bool setup(unsigned entries) NOEXCEPT;
+
+    /// Register `count` provided buffers of `size` bytes for `recv_multishot`. Fails if the kernel
+    /// does not support provided buffer rings or multishot receives.
+    NODISCARD bool setup_buffers(unsigned count, unsigned size) NOEXCEPT;
+    NODISCARD bool has_buffers() const NOEXCEPT { return mBufRing != nullptr; }
+
+    void poll_add(int fd, uint32_t events, uint64_t user_data) NOEXCEPT;
+    void poll_remove(uint64_t user_data) NOEXCEPT;
+    /// Receive into the provided buffers until the request fails, runs out of buffers or the peer
+    /// closes the connection. Each completion carries the id of the buffer in its flags.
+    void recv_multishot(int fd, uint64_t user_data) NOEXCEPT;
+    void send(int fd, void const* data, size_t length, uint64_t user_data) NOEXCEPT;
+    void cancel(uint64_t user_data) NOEXCEPT;
+
+    NODISCARD uint8_t* buffer(uint16_t id) NOEXCEPT;
+    /// Give a buffer back to the kernel once its data has been processed.
+    void recycle_buffer(uint16_t id) NOEXCEPT;
+
+    /// Submit the queued requests without waiting.
+    NODISCARD bool submit() NOEXCEPT;
+    /// Submit the queued requests and wait up to `timeout_ms` (-1 forever) for a completion.
+    /// Returns 0 on success, including when the wait timed out, or -errno.
+    NODISCARD int submit_and_wait(int timeout_ms) NOEXCEPT;
+
+    /// Copy up to `count` completions and remove them from the completion ring.
+    size_t reap(struct io_uring_cqe* cqes, size_t count) NOEXCEPT;
+    NODISCARD bool pending() const NOEXCEPT;
+
+    NODISCARD int fd() const NOEXCEPT { return mFd; }
+
+private:
+    struct io_uring_sqe* next_sqe() NOEXCEPT;
+    NODISCARD int        enter(unsigned min_complete, int timeout_ms) NOEXCEPT;
+    NODISCARD bool       probe_receive() NOEXCEPT;
+
+    int    mFd;
+    void*  mRing;
+    size_t mRingSize;
+    void*  mSqes;
+    size_t mSqesSize;
+
+    unsigned* mSqHead;
+    unsigned* mSqTail;
+    unsigned  mSqMask;
+    unsigned* mSqArray;
+    unsigned  mSqQueued;
+
+    unsigned*            mCqHead;
+    unsigned*            mCqTail;
+    unsigned             mCqMask;
+    struct io_uring_cqe* mCqes;
+
+    struct io_uring_buf_ring* mBufRing;
+    size_t                    mBufRingSize;
+    unsigned                  mBufMask;
+    uint16_t                  mBufTail;
+    unsigned                  mBufSize;
+    std::vector<uint8_t>      mBuffers;
+};
+
+}  // namespace scheduler
+#else
+namespace scheduler {
+class Uring {};
+}  // namespace scheduler
+#endif
@@ -0,0 +1,151 @@
+#include "virtual_clock.hpp"
+#include "scheduler.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+
+#include <loglet/loglet.hpp>
+
+LOGLET_MODULE2(sched, vclock);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(sched, vclock)
+
+namespace scheduler {
+
+namespace {
+// Deadline and arm sequence, the sequence breaks ties between timers with the same deadline
+using Key = std::pair<int64_t, uint64_t>;
+
+struct Entry {
+    int     fd;
+    int64_t interval_us;
+};
+
+struct State {
+    bool                         enabled  = false;
+    bool                         started  = false;
+    int64_t                      now_us   = 0;
+    uint64_t                     sequence = 0;
+    std::map<Key, Entry>         queue;
+    std::unordered_map<int, Key> timers;
+    VirtualClock::Listener       listener;
+};
+}  // namespace
+
+static State gState;
+
+static void set_now(int64_t time_us) NOEXCEPT {
+    if (gState.now_us == time_us) return;
+    gState.now_us = time_us;
+    if (gState.listener) gState.listener(time_us);
+}
+
+static void insert(int fd, int64_t deadline_us, int64_t interval_us) NOEXCEPT {
+    Key key{deadline_us, gState.sequence++};
+    gState.queue[key] = Entry{fd, interval_us};
+    gState.timers[fd] = key;
+}
+
+void VirtualClock::enable() NOEXCEPT {
+    VSCOPE_FUNCTION();
+    gState.enabled = true;
+}
+
+bool VirtualClock::enabled() NOEXCEPT {
+    return gState.enabled;
+}
+
+bool VirtualClock::started() NOEXCEPT {
+    return gState.started;
+}
+
+void VirtualClock::reset() NOEXCEPT {
+    VSCOPE_FUNCTION();
+    gState = State{};
+}
+
+int64_t VirtualClock::now_us() NOEXCEPT {
+    return gState.now_us;
+}
+
+void VirtualClock::set_listener(Listener listener) NOEXCEPT {
+    gState.listener = std::move(listener);
+}
+
+size_t VirtualClock::pending() NOEXCEPT {
+    return gState.queue.size();
+}
+
+void VirtualClock::arm(int fd, std::chrono::steady_clock::duration duration, bool repeat) NOEXCEPT {
+    disarm(fd);
+
+    auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    if (duration_us < 0) duration_us = 0;
+    // A zero interval would expire forever at the same time
+    auto interval_us = repeat ? (duration_us > 0 ? duration_us : 1) : 0;
+    insert(fd, gState.now_us + duration_us, interval_us);
+    VERBOSEF("arm fd=%d deadline=%lld interval=%lld", fd,
+             static_cast<long long>(gState.now_us + duration_us),
+             static_cast<long long>(interval_us));
+}
+
+void VirtualClock::disarm(int fd) NOEXCEPT {
+    auto it = gState.timers.find(fd);
+    if (it == gState.timers.end()) return;
+    gState.queue.erase(it->second);
+    gState.timers.erase(it);
+}
+
+void VirtualClock::advance_to(int64_t time_us) NOEXCEPT {
+    if (!gState.started) {
+        // Timers armed before the start are relative to it
+        std::map<Key, Entry> queue;
+        for (auto& kv : gState.queue) {
+            Key key{kv.first.first + time_us, kv.first.second};
+            queue[key]                  = kv.second;
+            gState.timers[kv.second.fd] = key;
+        }
+        gState.queue.swap(queue);
+        gState.started = true;
+        gState.now_us  = time_us;
+        DEBUGF("started at %lld with %zu timer(s)", static_cast<long long>(time_us),
+               gState.queue.size());
+        if (gState.listener) gState.listener(time_us);
+    }
+
+    while (!gState.queue.empty()) {
+        auto it = gState.queue.begin();
+        if (it->first.first > time_us) break;
+
+        auto deadline = it->first.first;
+        auto entry    = it->second;
+        gState.queue.erase(it);
+        gState.timers.erase(entry.fd);
+        if (entry.interval_us > 0) {
+            insert(entry.fd, deadline + entry.interval_us, entry.interval_us);
+        }
+
+        if (deadline > gState.now_us) set_now(deadline);
+
+        uint64_t value  = 1;
+        auto     result = ::write(entry.fd, &value, sizeof(value));
+        VERBOSEF("::write(%d, 1) = %zd", entry.fd, result);
+        if (result < 0) {
+            WARNF("failed to signal timer: " ERRNO_FMT, ERRNO_ARGS(errno));
+            continue;
+        }
+
+        if (has_current()) {
+            while (current().execute_once() == ExecuteResult::ConditionMet) {
+            }
+        }
+    }
+
+    if (time_us > gState.now_us) set_now(time_us);
+}
+
+}  // namespace scheduler
@@ -0,0 +1,35 @@
+#pragma once
+#include <streamline/task.hpp>
+
+namespace streamline {
+/// Typed handle to the queue of a single data type. Obtain it once from `System::channel<T>()`
+/// and keep it around; pushing through the handle skips the per-push type lookup that
+/// `System::push` has to do. The handle is only valid for the lifetime of the `System`.
+template <typename T>
+class Channel {
+public:
+    using DataType = T;
+
+    Channel() : mQueue(nullptr) {}
+    EXPLICIT Channel(QueueTask<T>* queue) : mQueue(queue) {}
+
+    NODISCARD bool valid() const { return mQueue != nullptr; }
+    explicit       operator bool() const { return valid(); }
+
+    /// True if anything is listening on the channel, producers can use this to skip building
+    /// messages nobody will look at.
+    NODISCARD bool has_listeners() const {
+        return mQueue && (mQueue->consumer_count() > 0 || mQueue->inspector_count() > 0);
+    }
+
+    /// Push data to the channel. Like `System::push`, data without any listeners is dropped.
+    void push(T&& data, uint64_t tag = 0) {
+        if (has_listeners()) {
+            mQueue->submit(std::move(data), tag);
+        }
+    }
+
+private:
+    QueueTask<T>* mQueue;
+};
+}  // namespace streamline
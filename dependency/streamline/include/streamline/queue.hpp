@@ -18,10 +18,13 @@ LOGLET_MODULE_FORWARD_REF(streamline);
 #define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF(streamline)
 
 namespace streamline {
+/// Queue that signals the reader through an eventfd. The eventfd is only written when the queue
+/// goes from empty to non-empty, so a burst of pushes costs a single wakeup and the reader drains
+/// everything that arrived since the last scheduler tick in one batch.
 template <typename T>
 class EventQueue {
 public:
-    EventQueue() { mFd = eventfd(0, EFD_NONBLOCK); }
+    EventQueue() : mSignaled(false) { mFd = eventfd(0, EFD_NONBLOCK); }
     ~EventQueue() { close(mFd); }
 
     void push(T&& data) {
@@ -31,7 +34,10 @@ public:
             WARNF("queue size limit reached (%lu > %d), discarding data", mQueue.size(),
                   EVENT_QUEUE_SIZE);
             mQueue.pop();
-        } else {
+        }
+
+        if (!mSignaled) {
+            mSignaled       = true;
             uint64_t value  = 1;
             ssize_t  result = write(mFd, &value, sizeof(value));
             if (result == -1) {
@@ -40,16 +46,17 @@ public:
         }
     }
 
-    T pop() {
+    /// Move all queued items into `batch`. The eventfd must have been cleared with `poll_count`
+    /// before calling this, otherwise a push racing with the drain could be left unsignaled.
+    void drain(std::queue<T>& batch) {
         std::lock_guard<std::mutex> lock(mMutex);
-        auto                        data = std::move(mQueue.front());
-        mQueue.pop();
-        return data;
+        batch.swap(mQueue);
+        mSignaled = false;
     }
 
     NODISCARD int get_fd() const { return mFd; }
     uint64_t      poll_count() {
-        uint64_t value;
+        uint64_t value  = 0;
         ssize_t  result = read(mFd, &value, sizeof(value));
         (void)result;
         return value;
@@ -59,6 +66,7 @@ private:
     std::queue<T> mQueue;
     std::mutex    mMutex;  // TODO(ewasjon): why have a mutex if the program is single threaded?
     int           mFd;
+    bool          mSignaled;
 };
 }  // namespace streamline
 
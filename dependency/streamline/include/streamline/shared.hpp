@@ -0,0 +1,16 @@
+#pragma once
+#include <memory>
+#include <utility>
+
+namespace streamline {
+/// Immutable reference counted payload. Pushing a `Shared<T>` lets any number of inspectors and
+/// consumers observe the same message without copying it; the default `Clone` of a shared pointer
+/// is a reference count increment.
+template <typename T>
+using Shared = std::shared_ptr<T const>;
+
+template <typename T, typename... Args>
+Shared<T> make_shared(Args&&... args) {
+    return std::make_shared<T const>(std::forward<Args>(args)...);
+}
+}  // namespace streamline
@@ -1,6 +1,9 @@
 #pragma once
+#include <streamline/channel.hpp>
+#include <streamline/shared.hpp>
 #include <streamline/task.hpp>
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -22,7 +25,12 @@ public:
     System(scheduler::Scheduler& scheduler) : mScheduler(&scheduler), mSyncMode(false) {}
 
     /// Enable synchronous mode: push() dispatches immediately instead of queuing.
-    void set_sync_mode(bool enabled) { mSyncMode = enabled; }
+    void set_sync_mode(bool enabled) {
+        mSyncMode = enabled;
+        for (auto& it : mQueues) {
+            static_cast<QueueTaskBase*>(it.second.get())->set_sync_mode(enabled);
+        }
+    }
 
     ~System() { cancel(); }
 
@@ -34,6 +42,8 @@ public:
         if (this != &other) {
             cancel();
             mScheduler       = other.mScheduler;
+            mSyncMode        = other.mSyncMode;
+            mReadTime        = other.mReadTime;
             mQueues          = std::move(other.mQueues);
             other.mScheduler = nullptr;
         }
@@ -78,30 +88,42 @@ public:
         return nullptr;
     }
 
+    /// Get a typed handle to the queue for `DataType`, creating the queue if needed. Producers
+    /// on a hot path should fetch the channel once and push through it.
+    template <typename DataType>
+    Channel<DataType> channel() {
+        FUNCTION_SCOPE();
+        if (!mScheduler && !mSyncMode) {
+            WARNF("invalid system state");
+            return Channel<DataType>{};
+        }
+
+        return Channel<DataType>{get_or_create_queue<DataType>()};
+    }
+
     template <typename DataType>
     void push(DataType&& data, uint64_t tag = 0) {
         FUNCTION_SCOPE();
         VERBOSEF("push %s", TypeName<typename std::decay<DataType>::type>::name());
 
-        if (mSyncMode) {
-            auto queue = get_queue<DataType>();
-            if (queue) {
-                queue->dispatch_sync(*this, std::forward<DataType>(data), tag);
-            }
-            return;
-        }
-
-        if (!mScheduler) {
+        if (!mScheduler && !mSyncMode) {
             WARNF("invalid system state");
             return;
         }
 
         auto queue = get_queue<DataType>();
         if (queue) {
-            queue->push(std::forward<DataType>(data), tag);
+            queue->submit(std::forward<DataType>(data), tag);
         }
     }
 
+    /// When the input data behind the message being produced or delivered was read, a default time
+    /// point if it is unknown. Producers set it before pushing, everything pushed carries it and it
+    /// is restored while the message is delivered, so messages derived from it (and the outputs
+    /// written for them) can measure the latency from the input read.
+    NODISCARD std::chrono::steady_clock::time_point read_time() const { return mReadTime; }
+    void set_read_time(std::chrono::steady_clock::time_point read_time) { mReadTime = read_time; }
+
     void cancel() {
         FUNCTION_SCOPE();
         for (auto& it : mQueues) {
@@ -118,7 +140,9 @@ protected:
         auto it = mQueues.find(std::type_index(typeid(DataType)));
         if (it == mQueues.end()) {
             VERBOSEF("created queue for %s", TypeName<DataType>::name());
-            auto queue = std::shared_ptr<QueueTask<DataType>>(new QueueTask<DataType>(*this));
+            auto queue = std::shared_ptr<QueueTask<DataType>>(
+                new QueueTask<DataType>(*this, mReadTime));
+            queue->set_sync_mode(mSyncMode);
             if (mScheduler && !mSyncMode) {
                 queue->schedule(mScheduler);
             }
@@ -143,6 +167,7 @@ protected:
 private:
     scheduler::Scheduler*                                      mScheduler;
     bool                                                       mSyncMode;
+    std::chrono::steady_clock::time_point                      mReadTime;
     std::unordered_map<std::type_index, std::shared_ptr<void>> mQueues;
 };
 }  // namespace streamline
@@ -3,6 +3,7 @@
 #include <streamline/inspector.hpp>
 #include <streamline/queue.hpp>
 
+#include <chrono>
 #include <memory>
 #include <unistd.h>
 #include <vector>
@@ -28,25 +29,33 @@ struct Clone {
 
 class QueueTaskBase {
 public:
-    QueueTaskBase() : mScheduler(nullptr), mEvent{scheduler::ScheduledEvent::invalid()} {}
+    QueueTaskBase()
+        : mScheduler(nullptr), mEvent{scheduler::ScheduledEvent::invalid()}, mSyncMode(false) {}
     virtual ~QueueTaskBase()                               = default;
     virtual void schedule(scheduler::Scheduler* scheduler) = 0;
     virtual void cancel()                                  = 0;
 
+    void set_sync_mode(bool enabled) { mSyncMode = enabled; }
+
 protected:
     scheduler::Scheduler*     mScheduler;
     scheduler::ScheduledEvent mEvent;
+    bool                      mSyncMode;
 };
 
 template <typename T>
 class QueueTask : public QueueTaskBase {
 public:
     struct Item {
-        uint64_t tag;
-        T        data;
+        uint64_t                              tag;
+        std::chrono::steady_clock::time_point read_time;
+        T                                     data;
     };
 
-    QueueTask(System& system) : mSystem(system), mQueue() {
+    /// `read_time` is the read time of the system, see `System::read_time`. It is stored with every
+    /// queued item and restored while the item is delivered.
+    QueueTask(System& system, std::chrono::steady_clock::time_point& read_time)
+        : mSystem(system), mReadTime(read_time), mQueue() {
         mQueueName = std::string{"streamline/"} + TypeName<T>::name();
     }
     ~QueueTask() override { cancel(); }
@@ -81,56 +90,36 @@ public:
         if (!mScheduler) return;
         if (!(triggered & scheduler::EventInterest::Read)) return;
 
-        auto count = mQueue.poll_count();
-        VERBOSEF("queue task (%d): event count %lu (%zu inspectors, %zu consumers)",
-                 mQueue.get_fd(), count, mInspectors.size(), mConsumers.size());
+        // Everything pushed since the last tick is delivered as one batch. The batch is moved out
+        // of the queue first so that consumers pushing to this same queue land in the next tick.
+        mQueue.poll_count();
+        mQueue.drain(mBatch);
+        VERBOSEF("queue task (%d): batch %zu (%zu inspectors, %zu consumers)", mQueue.get_fd(),
+                 mBatch.size(), mInspectors.size(), mConsumers.size());
         LOGLET_INDENT_SCOPE(loglet::Level::Verbose);
 
-        for (uint64_t i = 0; i < count; i++) {
-            auto item = mQueue.pop();
-            for (auto& inspector : mInspectors) {
-                if (inspector->accept(mSystem, item.tag)) {
-                    auto before_event = std::chrono::steady_clock::now();
-                    inspector->inspect(mSystem, item.data, item.tag);
-                    auto after_event = std::chrono::steady_clock::now();
-                    VERBOSEF("inspector \"%s\" took %lld ms", inspector->name(),
-                             std::chrono::duration_cast<std::chrono::milliseconds>(after_event -
-                                                                                   before_event)
-                                 .count());
-                }
-            }
-
-            auto it = mConsumers.begin();
-            while (it != mConsumers.end()) {
-                auto consumer = it->get();
-                if (!consumer->accept(mSystem, item.tag)) {
-                    it++;
-                    continue;
-                }
-
-                auto before_event = std::chrono::steady_clock::now();
-
-                auto data = std::move(item.data);
-                if (std::next(it) != mConsumers.end()) {
-                    auto clone = streamline::Clone<T>{}(data);
-                    VERBOSEF("cloning data for next consumer");
-                    consumer->consume(mSystem, std::move(clone), item.tag);
-                } else {
-                    consumer->consume(mSystem, std::move(data), item.tag);
-                }
-
-                auto after_event = std::chrono::steady_clock::now();
-                VERBOSEF("consumer \"%s\" took %lld ms", consumer->name(),
-                         std::chrono::duration_cast<std::chrono::milliseconds>(after_event -
-                                                                               before_event)
-                             .count());
+        auto read_time = mReadTime;
+        while (!mBatch.empty()) {
+            auto item = std::move(mBatch.front());
+            mBatch.pop();
+            mReadTime = item.read_time;
+            deliver(mSystem, item.data, item.tag);
+        }
+        mReadTime = read_time;
+    }
 
-                it++;
-            }
+    /// Queue the value for the next scheduler tick, or dispatch it immediately in sync mode.
+    void submit(T&& value, uint64_t tag) {
+        if (mSyncMode) {
+            dispatch_sync(mSystem, std::move(value), tag);
+        } else if (mScheduler) {
+            push(std::move(value), tag);
+        } else {
+            WARNF("invalid system state");
         }
     }
 
-    void push(T&& value, uint64_t tag) { mQueue.push({tag, std::move(value)}); }
+    void push(T&& value, uint64_t tag) { mQueue.push({tag, mReadTime, std::move(value)}); }
 
     /// Synchronous dispatch — bypasses the queue entirely.
     void dispatch_sync(System& system, T&& value, uint64_t tag) {
@@ -158,9 +147,53 @@ public:
         mInspectors.push_back(std::move(inspector));
     }
 
+    NODISCARD size_t consumer_count() const { return mConsumers.size(); }
+    NODISCARD size_t inspector_count() const { return mInspectors.size(); }
+
 protected:
+    void deliver(System& system, T& data, uint64_t tag) {
+        for (auto& inspector : mInspectors) {
+            if (inspector->accept(system, tag)) {
+                auto before_event = std::chrono::steady_clock::now();
+                inspector->inspect(system, data, tag);
+                auto after_event = std::chrono::steady_clock::now();
+                VERBOSEF("inspector \"%s\" took %lld ms", inspector->name(),
+                         std::chrono::duration_cast<std::chrono::milliseconds>(after_event -
+                                                                               before_event)
+                             .count());
+            }
+        }
+
+        // Every accepting consumer except the last gets a clone, the last one takes ownership.
+        // For `Shared<T>` payloads the clone is a reference count increment.
+        Consumer<T>* last = nullptr;
+        for (auto& consumer : mConsumers) {
+            if (consumer->accept(system, tag)) {
+                if (last) {
+                    consume(system, *last, streamline::Clone<T>{}(data), tag);
+                }
+                last = consumer.get();
+            }
+        }
+
+        if (last) {
+            consume(system, *last, std::move(data), tag);
+        }
+    }
+
+    void consume(System& system, Consumer<T>& consumer, T&& data, uint64_t tag) {
+        auto before_event = std::chrono::steady_clock::now();
+        consumer.consume(system, std::move(data), tag);
+        auto after_event = std::chrono::steady_clock::now();
+        VERBOSEF("consumer \"%s\" took %lld ms", consumer.name(),
+                 std::chrono::duration_cast<std::chrono::milliseconds>(after_event - before_event)
+                     .count());
+    }
+
     System&                                    mSystem;
+    std::chrono::steady_clock::time_point&     mReadTime;
     EventQueue<Item>                           mQueue;
+    std::queue<Item>                           mBatch;
     std::vector<std::unique_ptr<Consumer<T>>>  mConsumers;
     std::vector<std::unique_ptr<Inspector<T>>> mInspectors;
     std::string                                mQueueName;
@@ -22,6 +22,7 @@ EXTERNAL_WARNINGS_PUSH
 #include <Ver2-PosProtocol-extension.h>
 EXTERNAL_WARNINGS_POP
 
+#include <chrono>
 #include <loglet/loglet.hpp>
 
 LOGLET_MODULE2(supl, decode);
@@ -30,6 +31,42 @@ LOGLET_MODULE2(supl, decode);
 
 namespace supl {
 
+ULP_PDU* decode_ulp_pdu(uint8_t const* data, size_t size) {
+    VSCOPE_FUNCTIONF("%zu", size);
+
+    ULP_PDU* ulp_pdu{};
+
+    // NOTE: Increase default max stack size to handle large messages.
+    // TODO(ewasjon): Is this correct?
+    asn_codec_ctx_t stack_ctx{};
+    stack_ctx.max_stack_size = 1024 * 1024 * 4;
+
+    auto decode_start = std::chrono::steady_clock::now();
+    auto result       = uper_decode_complete(&stack_ctx, &asn_DEF_ULP_PDU,
+                                             reinterpret_cast<void**>(&ulp_pdu), data, size);
+    auto decode_end   = std::chrono::steady_clock::now();
+    auto decode_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(decode_end - decode_start).count();
+
+    if (decode_ms > 100) {
+        WARNF("SUPL decode took %lld ms (PDU size: %zu bytes)", decode_ms, size);
+    } else {
+        VERBOSEF("SUPL decode took %lld ms (PDU size: %zu bytes)", decode_ms, size);
+    }
+
+    DEBUGF("uper_decode_complete(): %s %zd",
+           (result.code == RC_FAIL ? "RC_FAIL" : (result.code == RC_WMORE ? "RC_WMORE" : "RC_OK")),
+           result.consumed);
+
+    if (result.code != RC_OK) {
+        WARNF("failed to decode uper: %zd of %zu bytes consumed", result.consumed, size);
+        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, ulp_pdu);
+        return nullptr;
+    }
+
+    return ulp_pdu;
+}
+
 static Identity decode_identity(IPAddress& ip_address) {
     VSCOPE_FUNCTION();
     switch (ip_address.present) {
@@ -134,6 +171,21 @@ static Identity decode_identity(SLPAddress_t& slp_address) {
     return Identity::unknown();
 }
 
+static bool decode_set_session(Session::SET& set, ULP_PDU* pdu) {
+    VSCOPE_FUNCTION();
+
+    auto set_session = pdu->sessionID.setSessionID;
+    if (!set_session) {
+        VERBOSEF("missing set session");
+        return false;
+    }
+
+    set.is_active = true;
+    set.id        = set_session->sessionId;
+    set.identity  = decode_identity(set_session->setId);
+    return true;
+}
+
 static bool decode_session(Session::SET& set, Session::SLP& slp, ULP_PDU* pdu) {
     VSCOPE_FUNCTION();
 
@@ -149,9 +201,9 @@ static bool decode_session(Session::SET& set, Session::SLP& slp, ULP_PDU* pdu) {
         return false;
     }
 
-    set.is_active = true;
-    set.id        = set_session->sessionId;
-    set.identity  = decode_identity(set_session->setId);
+    if (!decode_set_session(set, pdu)) {
+        return false;
+    }
 
     auto slp_id = slp_session->sessionID;
     assert(slp_id.size == 4);
@@ -211,42 +263,26 @@ bool decode_end(Session::SET& set, Session::SLP& slp, END&, ULP_PDU* pdu) {
 Payload decode_payload(Payload::Type type, const OCTET_STRING& data) {
     VSCOPE_FUNCTION();
     Payload payload{};
-    payload.type = type;
-    payload.data.resize(data.size);
-    memcpy(payload.data.data(), data.buf, data.size);
+    payload.type      = type;
+    payload.view      = data.buf;
+    payload.view_size = static_cast<size_t>(data.size);
     return payload;
 }
 
-bool decode_pos(Session::SET& set, Session::SLP& slp, POS& pos, ULP_PDU* pdu) {
+static void decode_pos_payload(POS& pos, PosPayLoad& pos_payload) {
     VSCOPE_FUNCTION();
 
-    if (!pdu) {
-        VERBOSEF("pdu is null");
-        return false;
-    }
-
-    if (pdu->message.present != UlpMessage_PR_msSUPLPOS) {
-        VERBOSEF("not SUPLPOS: %d", pdu->message.present);
-        return false;
-    }
-
-    if (!decode_session(set, slp, pdu)) {
-        VERBOSEF("decode_session failed");
-        return false;
-    }
-
-    auto message = &pdu->message.choice.msSUPLPOS;
-    if (message->posPayLoad.present == PosPayLoad_PR_tia801payload) {
+    if (pos_payload.present == PosPayLoad_PR_tia801payload) {
         pos.payloads.emplace_back(
-            decode_payload(Payload::Type::TIA801, message->posPayLoad.choice.rrlpPayload));
-    } else if (message->posPayLoad.present == PosPayLoad_PR_rrcPayload) {
+            decode_payload(Payload::Type::TIA801, pos_payload.choice.rrlpPayload));
+    } else if (pos_payload.present == PosPayLoad_PR_rrcPayload) {
         pos.payloads.emplace_back(
-            decode_payload(Payload::Type::RRC, message->posPayLoad.choice.rrlpPayload));
-    } else if (message->posPayLoad.present == PosPayLoad_PR_rrlpPayload) {
+            decode_payload(Payload::Type::RRC, pos_payload.choice.rrlpPayload));
+    } else if (pos_payload.present == PosPayLoad_PR_rrlpPayload) {
         pos.payloads.emplace_back(
-            decode_payload(Payload::Type::RRLP, message->posPayLoad.choice.rrlpPayload));
-    } else if (message->posPayLoad.present == PosPayLoad_PR_ver2_PosPayLoad_extension) {
-        auto ver2 = &message->posPayLoad.choice.ver2_PosPayLoad_extension;
+            decode_payload(Payload::Type::RRLP, pos_payload.choice.rrlpPayload));
+    } else if (pos_payload.present == PosPayLoad_PR_ver2_PosPayLoad_extension) {
+        auto ver2 = &pos_payload.choice.ver2_PosPayLoad_extension;
         if (ver2->lPPPayload) {
             for (int i = 0; i < ver2->lPPPayload->list.count; i++) {
                 if (ver2->lPPPayload->list.array[i] != nullptr) {
@@ -265,6 +301,76 @@ bool decode_pos(Session::SET& set, Session::SLP& slp, POS& pos, ULP_PDU* pdu) {
             }
         }
     }
+}
+
+bool decode_pos(Session::SET& set, Session::SLP& slp, POS& pos, ULP_PDU* pdu) {
+    VSCOPE_FUNCTION();
+
+    if (!pdu) {
+        VERBOSEF("pdu is null");
+        return false;
+    }
+
+    if (pdu->message.present != UlpMessage_PR_msSUPLPOS) {
+        VERBOSEF("not SUPLPOS: %d", pdu->message.present);
+        return false;
+    }
+
+    if (!decode_session(set, slp, pdu)) {
+        VERBOSEF("decode_session failed");
+        return false;
+    }
+
+    decode_pos_payload(pos, pdu->message.choice.msSUPLPOS.posPayLoad);
+    print(loglet::Level::Trace, pdu);
+    return true;
+}
+
+bool decode_start(Session::SET& set, ULP_PDU* pdu) {
+    VSCOPE_FUNCTION();
+
+    if (!pdu) {
+        VERBOSEF("pdu is null");
+        return false;
+    }
+
+    if (pdu->message.present != UlpMessage_PR_msSUPLSTART) {
+        VERBOSEF("not SUPLSTART: %d", pdu->message.present);
+        return false;
+    }
+
+    // the SLP session is assigned by the response
+    if (!decode_set_session(set, pdu)) {
+        VERBOSEF("decode_set_session failed");
+        return false;
+    }
+
+    print(loglet::Level::Trace, pdu);
+    return true;
+}
+
+bool decode_posinit(Session::SET& set, Session::SLP& slp, POS& pos, ULP_PDU* pdu) {
+    VSCOPE_FUNCTION();
+
+    if (!pdu) {
+        VERBOSEF("pdu is null");
+        return false;
+    }
+
+    if (pdu->message.present != UlpMessage_PR_msSUPLPOSINIT) {
+        VERBOSEF("not SUPLPOSINIT: %d", pdu->message.present);
+        return false;
+    }
+
+    if (!decode_session(set, slp, pdu)) {
+        VERBOSEF("decode_session failed");
+        return false;
+    }
+
+    auto suplpos = pdu->message.choice.msSUPLPOSINIT.sUPLPOS;
+    if (suplpos) {
+        decode_pos_payload(pos, suplpos->posPayLoad);
+    }
 
     print(loglet::Level::Trace, pdu);
     return true;
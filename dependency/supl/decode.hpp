@@ -9,8 +9,15 @@ struct RESPONSE;
 struct END;
 struct POS;
 
+/// Decode one complete UPER-encoded ULP PDU of `size` octets. Returns null on failure.
+ULP_PDU* decode_ulp_pdu(uint8_t const* data, size_t size);
+
 bool decode_response(Session::SET& set, Session::SLP& slp, RESPONSE& response, ULP_PDU* pdu);
 bool decode_end(Session::SET& set, Session::SLP& slp, END& end, ULP_PDU* pdu);
 bool decode_pos(Session::SET& set, Session::SLP& slp, POS& pos, ULP_PDU* pdu);
 
+// SLP side, see `ServerSession`
+bool decode_start(Session::SET& set, ULP_PDU* pdu);
+bool decode_posinit(Session::SET& set, Session::SLP& slp, POS& pos, ULP_PDU* pdu);
+
 }  // namespace supl
@@ -430,10 +430,10 @@ static ::PosPayLoad encode_pospayload(std::vector<supl::Payload> const& payloads
     asn_sequence_empty(&lpppayload->list);
     for (auto& payload : payloads) {
         auto os   = helper::asn1_allocate<OCTET_STRING>();
-        auto data = reinterpret_cast<uint8_t*>(malloc(payload.data.size()));
-        memcpy(data, payload.data.data(), payload.data.size());
+        auto data = reinterpret_cast<uint8_t*>(malloc(payload.size()));
+        memcpy(data, payload.bytes(), payload.size());
         os->buf  = data;
-        os->size = payload.data.size();
+        os->size = payload.size();
         asn_sequence_add(&lpppayload->list, os);
     }
 
@@ -556,4 +556,36 @@ EncodedMessage encode(Version version, Session::SET& set, Session::SLP& slp, con
     return encode_uper(ulp_pdu);
 }
 
+EncodedMessage encode(Version version, Session::SET& set, Session::SLP& slp,
+                      const RESPONSE& message) {
+    FUNCTION_SCOPEN("RESPONSE");
+
+    auto ulp_pdu = create_message(UlpMessage_PR_msSUPLRESPONSE, version);
+    SUPL_DEFER {
+        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, ulp_pdu);
+    };
+
+    encode_session(ulp_pdu, set, slp);
+
+    auto& pdu_message     = ulp_pdu->message.choice.msSUPLRESPONSE;
+    pdu_message.posMethod = static_cast<long>(message.pos_method);
+
+    print(loglet::Level::Trace, ulp_pdu);
+    return encode_uper(ulp_pdu);
+}
+
+EncodedMessage encode(Version version, Session::SET& set, Session::SLP& slp, const END&) {
+    FUNCTION_SCOPEN("END");
+
+    auto ulp_pdu = create_message(UlpMessage_PR_msSUPLEND, version);
+    SUPL_DEFER {
+        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, ulp_pdu);
+    };
+
+    encode_session(ulp_pdu, set, slp);
+
+    print(loglet::Level::Trace, ulp_pdu);
+    return encode_uper(ulp_pdu);
+}
+
 }  // namespace supl
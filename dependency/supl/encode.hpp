@@ -1,6 +1,8 @@
 #pragma once
+#include <supl/end.hpp>
 #include <supl/pos.hpp>
 #include <supl/posinit.hpp>
+#include <supl/response.hpp>
 #include <supl/session.hpp>
 #include <supl/start.hpp>
 
@@ -45,4 +47,9 @@ EncodedMessage encode(Version version, Session::SET& set, Session::SLP& slp,
                       const POSINIT& message);
 EncodedMessage encode(Version version, Session::SET& set, Session::SLP& slp, const POS& message);
 
+// SLP side, see `ServerSession`
+EncodedMessage encode(Version version, Session::SET& set, Session::SLP& slp,
+                      const RESPONSE& message);
+EncodedMessage encode(Version version, Session::SET& set, Session::SLP& slp, const END& message);
+
 }  // namespace supl
@@ -1,6 +1,7 @@
 #pragma once
 #include <core/core.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace supl {
@@ -16,10 +17,21 @@ struct Payload {
 
     Type                 type;
     std::vector<uint8_t> data;
+
+    /// Received payloads refer to the octets inside the decoded ULP PDU instead of copying them
+    /// into `data`. The view is valid for as long as the `POS` it was received in.
+    uint8_t const* view      = nullptr;
+    size_t         view_size = 0;
+
+    NODISCARD uint8_t const* bytes() const { return view ? view : data.data(); }
+    NODISCARD size_t         size() const { return view ? view_size : data.size(); }
 };
 
 struct POS {
     std::vector<Payload> payloads;
+
+    /// The decoded ULP PDU that received payload views point into.
+    std::shared_ptr<void> pdu;
 };
 
 }  // namespace supl
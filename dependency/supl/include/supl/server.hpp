@@ -0,0 +1,87 @@
+#pragma once
+#include <io/write_buffer.hpp>
+#include <supl/identity.hpp>
+#include <supl/pos.hpp>
+#include <supl/session.hpp>
+#include <supl/tls.hpp>
+#include <supl/version.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace supl {
+
+struct RESPONSE;
+struct END;
+
+/// The location server (SLP) side of a SUPL session on an accepted TCP connection. It implements
+/// the part of ULP that `supl::Session` uses, so that local test and load-testing servers can be
+/// built without a real SLP.
+///
+/// The session never blocks on the socket: messages that do not fit in the socket are queued. The
+/// owner calls `flush` when the socket is readable and, while `wants_write` is true, when it is
+/// writable. When a slow SET lets the queue grow past its limit the oldest whole messages are
+/// dropped.
+class ServerSession {
+public:
+    enum class Received {
+        NoData,
+        UnableToDecode,
+        START,
+        POSINIT,
+        POS,
+        END,
+    };
+
+    /// Takes ownership of the connected socket `fd`. `slp_id` is the SLP session id assigned to
+    /// the SET in the response. With `tls` the TLS handshake is accepted before any ULP message.
+    explicit ServerSession(int fd, Version version, Identity slp_identity, uint32_t slp_id,
+                           std::unique_ptr<TlsBackend> tls = nullptr);
+    ~ServerSession();
+
+    ServerSession(ServerSession const&)            = delete;
+    ServerSession& operator=(ServerSession const&) = delete;
+
+    NODISCARD int                 fd() const { return mFd; }
+    NODISCARD Session::SET const& set() const { return mSETSession; }
+    NODISCARD Session::SLP const& slp() const { return mSLPSession; }
+
+    /// Read what is available on the socket. Returns false if the SET closed the connection.
+    bool fill_receive_buffer();
+
+    /// Write the queued messages, or continue the TLS handshake, as far as the socket allows.
+    /// Returns false if the connection failed.
+    bool                             flush();
+    NODISCARD bool                   wants_write() const { return mWantWrite; }
+    NODISCARD io::WriteBuffer const& send_buffer() const { return mSendBuffer; }
+
+    /// Decode the next complete ULP PDU in the receive buffer. The payloads of SUPL POSINIT and
+    /// SUPL POS are returned in `pos`.
+    Received try_receive(POS& pos);
+
+    /// Queue the message and write what the socket takes. Returns false if the message could not
+    /// be encoded or the connection failed.
+    bool send(RESPONSE const& message);
+    bool send(POS const& message);
+    bool send(END const& message);
+
+protected:
+    bool send_all(uint8_t const* buffer, size_t size);
+    bool handshake();
+
+private:
+    int                         mFd;
+    Version                     mVersion;
+    std::unique_ptr<TlsBackend> mTls;
+    bool                        mTlsEstablished;
+    bool                        mWantWrite;
+
+    Session::SET mSETSession;
+    Session::SLP mSLPSession;
+
+    std::vector<uint8_t> mReceiveBuffer;
+    size_t               mReceiveBufferOffset;
+    io::WriteBuffer      mSendBuffer;
+};
+
+}  // namespace supl
@@ -88,9 +88,13 @@ public:
     NODISCARD int fd() const;
     bool          fill_receive_buffer();
 
+    /// Total length of the ULP PDU starting at `data`, or 0 if fewer than two octets are given.
+    NODISCARD static size_t pdu_length(uint8_t const* data, size_t size);
+
 protected:
     ULP_PDU* parse_receive_buffer();
     ULP_PDU* wait_for_ulp_pdu();
+    Received receive_message(ULP_PDU* ulp_pdu, RESPONSE* response, END* end, POS* pos);
     Received parse_message(ULP_PDU* ulp_pdu, RESPONSE* response, END* end, POS* pos);
 
     bool send_all(void const* buffer, size_t size);
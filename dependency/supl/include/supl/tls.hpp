@@ -10,6 +10,9 @@ struct TlsConfig {
     std::string ca_cert_path     = "";
     std::string client_cert_path = "";
     std::string client_key_path  = "";
+    // Accept the handshake as the server instead of connecting, `client_cert_path` and
+    // `client_key_path` are then the certificate and key presented by the server.
+    bool server = false;
 };
 
 class TlsBackend {
@@ -0,0 +1,269 @@
+#include "supl/server.hpp"
+#include "decode.hpp"
+#include "encode.hpp"
+#include "supl/end.hpp"
+#include "supl/response.hpp"
+
+#include <external_warnings.hpp>
+
+EXTERNAL_WARNINGS_PUSH
+#include <ULP-PDU.h>
+EXTERNAL_WARNINGS_POP
+
+#include <cerrno>
+#include <cstring>
+#include <loglet/loglet.hpp>
+#include <memory>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define RECEIVE_BUFFER_SIZE (64 * 1024)
+// A few seconds of assistance data for a SET that stops reading, older messages are dropped
+#define SEND_BUFFER_SIZE (1024 * 1024)
+
+LOGLET_MODULE2(supl, server);
+#undef LOGLET_CURRENT_MODULE
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(supl, server)
+
+namespace supl {
+
+ServerSession::ServerSession(int fd, Version version, Identity slp_identity, uint32_t slp_id,
+                             std::unique_ptr<TlsBackend> tls)
+    : mFd(fd), mVersion(std::move(version)), mTls(std::move(tls)), mTlsEstablished(false),
+      mWantWrite(false), mReceiveBuffer(RECEIVE_BUFFER_SIZE), mReceiveBufferOffset(0),
+      mSendBuffer(SEND_BUFFER_SIZE) {
+    VSCOPE_FUNCTIONF("%d", fd);
+
+    mSETSession           = {};
+    mSETSession.is_active = false;
+
+    mSLPSession           = {};
+    mSLPSession.is_active = true;
+    mSLPSession.id[0]     = static_cast<uint8_t>(slp_id >> 24);
+    mSLPSession.id[1]     = static_cast<uint8_t>(slp_id >> 16);
+    mSLPSession.id[2]     = static_cast<uint8_t>(slp_id >> 8);
+    mSLPSession.id[3]     = static_cast<uint8_t>(slp_id);
+    mSLPSession.identity  = std::move(slp_identity);
+}
+
+ServerSession::~ServerSession() {
+    VSCOPE_FUNCTION();
+    if (mTls) {
+        mTls->shutdown();
+        mTls.reset();
+    }
+
+    if (mFd >= 0) {
+        ::close(mFd);
+        mFd = -1;
+    }
+}
+
+bool ServerSession::handshake() {
+    VSCOPE_FUNCTION();
+    auto result = mTls->handshake(mFd, "");
+    mWantWrite  = result == TlsBackend::HandshakeResult::WantWrite;
+    if (result == TlsBackend::HandshakeResult::Error) {
+        WARNF("TLS handshake failed");
+        return false;
+    } else if (result == TlsBackend::HandshakeResult::Ok) {
+        DEBUGF("TLS handshake completed");
+        mTlsEstablished = true;
+    }
+    return true;
+}
+
+bool ServerSession::fill_receive_buffer() {
+    VSCOPE_FUNCTION();
+
+    if (mTls && !mTlsEstablished) {
+        if (!handshake()) return false;
+        if (!mTlsEstablished) return true;
+    }
+
+    for (;;) {
+        auto size = mReceiveBuffer.size() - mReceiveBufferOffset;
+        if (size == 0) {
+            VERBOSEF("receive buffer full");
+            return true;
+        }
+
+        if (mTls) {
+            auto result = mTls->read(mReceiveBuffer.data() + mReceiveBufferOffset,
+                                     static_cast<int>(size));
+            switch (result.status) {
+            case TlsBackend::IoStatus::Ok:
+                mReceiveBufferOffset += static_cast<size_t>(result.bytes);
+                continue;
+            case TlsBackend::IoStatus::WantRead:
+            case TlsBackend::IoStatus::WantWrite: return true;
+            case TlsBackend::IoStatus::Closed: DEBUGF("peer closed TLS connection"); return false;
+            case TlsBackend::IoStatus::Error: return false;
+            }
+        }
+
+        auto result = ::read(mFd, mReceiveBuffer.data() + mReceiveBufferOffset, size);
+        if (result > 0) {
+            VERBOSEF("received %zd bytes", result);
+            mReceiveBufferOffset += static_cast<size_t>(result);
+            continue;
+        } else if (result == 0) {
+            DEBUGF("peer closed connection");
+            return false;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            WARNF("read failed: %s", strerror(errno));
+            return false;
+        }
+    }
+}
+
+ServerSession::Received ServerSession::try_receive(POS& pos) {
+    VSCOPE_FUNCTIONF("%zu", mReceiveBufferOffset);
+
+    auto size = Session::pdu_length(mReceiveBuffer.data(), mReceiveBufferOffset);
+    if (mReceiveBufferOffset < 2) {
+        return Received::NoData;
+    } else if (size < 4) {
+        WARNF("invalid ULP PDU length: %zu bytes, discarding %zu bytes", size,
+              mReceiveBufferOffset);
+        mReceiveBufferOffset = 0;
+        return Received::UnableToDecode;
+    } else if (size > mReceiveBufferOffset) {
+        return Received::NoData;
+    }
+
+    auto ulp_pdu = decode_ulp_pdu(mReceiveBuffer.data(), size);
+    memmove(mReceiveBuffer.data(), mReceiveBuffer.data() + size, mReceiveBufferOffset - size);
+    mReceiveBufferOffset -= size;
+    if (!ulp_pdu) {
+        return Received::UnableToDecode;
+    }
+
+    std::shared_ptr<ULP_PDU> owner(ulp_pdu, [](ULP_PDU* pdu) {
+        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, pdu);
+    });
+
+    Session::SET set{};
+    Session::SLP slp{};
+    END          end{};
+    Received     received = Received::UnableToDecode;
+    if (decode_start(set, ulp_pdu)) {
+        mSETSession = set;
+        received    = Received::START;
+    } else if (decode_posinit(set, slp, pos, ulp_pdu)) {
+        received = Received::POSINIT;
+    } else if (decode_pos(set, slp, pos, ulp_pdu)) {
+        received = Received::POS;
+    } else if (decode_end(set, slp, end, ulp_pdu)) {
+        received = Received::END;
+    } else {
+        WARNF("unsupported message: %d", ulp_pdu->message.present);
+        return Received::UnableToDecode;
+    }
+
+    if (!mSETSession.is_active || set.id != mSETSession.id) {
+        WARNF("invalid SET session");
+        return Received::UnableToDecode;
+    }
+
+    if (!pos.payloads.empty()) {
+        pos.pdu = std::move(owner);
+    }
+    return received;
+}
+
+bool ServerSession::send(RESPONSE const& message) {
+    FUNCTION_SCOPEN("RESPONSE");
+    auto encoded_message = encode(mVersion, mSETSession, mSLPSession, message);
+    if (encoded_message.size() == 0) {
+        WARNF("encode failed");
+        return false;
+    }
+
+    return send_all(encoded_message.data(), encoded_message.size());
+}
+
+bool ServerSession::send(POS const& message) {
+    FUNCTION_SCOPEN("POS");
+    auto encoded_message = encode(mVersion, mSETSession, mSLPSession, message);
+    if (encoded_message.size() == 0) {
+        WARNF("encode failed");
+        return false;
+    }
+
+    return send_all(encoded_message.data(), encoded_message.size());
+}
+
+bool ServerSession::send(END const& message) {
+    FUNCTION_SCOPEN("END");
+    auto encoded_message = encode(mVersion, mSETSession, mSLPSession, message);
+    if (encoded_message.size() == 0) {
+        WARNF("encode failed");
+        return false;
+    }
+
+    return send_all(encoded_message.data(), encoded_message.size());
+}
+
+bool ServerSession::send_all(uint8_t const* buffer, size_t size) {
+    VSCOPE_FUNCTIONF("%zu", size);
+    mSendBuffer.enqueue_message(buffer, size);
+    return flush();
+}
+
+bool ServerSession::flush() {
+    VSCOPE_FUNCTIONF("%zu", mSendBuffer.size());
+
+    if (mTls && !mTlsEstablished) {
+        if (!handshake()) return false;
+        if (!mTlsEstablished) return true;
+    }
+
+    mWantWrite = false;
+    while (!mSendBuffer.empty()) {
+        if (mTls) {
+            // TLS needs the same buffer again after WantRead/WantWrite, which the first slice is
+            auto slice  = mSendBuffer.peek();
+            auto result = mTls->write(slice.first, static_cast<int>(slice.second));
+            if (result.status == TlsBackend::IoStatus::Ok) {
+                mSendBuffer.consume(static_cast<size_t>(result.bytes));
+                continue;
+            } else if (result.status == TlsBackend::IoStatus::WantRead) {
+                // Retried by the `flush` that follows the next read
+                return true;
+            } else if (result.status == TlsBackend::IoStatus::WantWrite) {
+                mWantWrite = true;
+                return true;
+            }
+            WARNF("TLS write failed");
+            return false;
+        }
+
+        struct iovec iov[16];
+        struct msghdr msg{};
+        msg.msg_iov    = iov;
+        msg.msg_iovlen = mSendBuffer.gather(iov, 16);
+
+        auto result = ::sendmsg(mFd, &msg, MSG_NOSIGNAL);
+        if (result >= 0) {
+            VERBOSEF("sent %zd bytes (%zu left)", result, mSendBuffer.size());
+            mSendBuffer.consume(static_cast<size_t>(result));
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            VERBOSEF("socket full, %zu bytes queued", mSendBuffer.size());
+            mWantWrite = true;
+            return true;
+        } else if (errno != EINTR) {
+            WARNF("send failed: %s", strerror(errno));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace supl
@@ -1,7 +1,6 @@
 #include "supl/session.hpp"
 #include "decode.hpp"
 #include "encode.hpp"
-#include "supl.hpp"
 #include "supl/end.hpp"
 #include "supl/response.hpp"
 #include "supl/start.hpp"
@@ -14,7 +13,7 @@ EXTERNAL_WARNINGS_PUSH
 #include <ULP-PDU.h>
 EXTERNAL_WARNINGS_POP
 
-#include <chrono>
+#include <memory>
 #include <loglet/loglet.hpp>
 #include <poll.h>
 
@@ -291,50 +290,38 @@ void Session::rb_consume(size_t bytes) {
     }
 }
 
+size_t Session::pdu_length(uint8_t const* data, size_t size) {
+    // The ULP PDU starts with `length INTEGER (0..65535)`, the total length of the PDU in octets,
+    // which UPER encodes as two aligned octets.
+    if (size < 2) return 0;
+    return (static_cast<size_t>(data[0]) << 8) | static_cast<size_t>(data[1]);
+}
+
 ULP_PDU* Session::parse_receive_buffer() {
     VSCOPE_FUNCTIONF("%zd/%zd", mReceiveBufferOffset, mReceiveBufferSize);
-    if (mReceiveBufferOffset < 4) {
+    if (mReceiveBufferOffset < 2) {
         return nullptr;
     }
 
-    ULP_PDU* ulp_pdu{};
-    auto     size   = mReceiveBufferOffset;
-    auto     buffer = mReceiveBuffer;
-
-    // NOTE: Increase default max stack size to handle large messages.
-    // TODO(ewasjon): Is this correct?
-    asn_codec_ctx_t stack_ctx{};
-    stack_ctx.max_stack_size = 1024 * 1024 * 4;
-
-    auto decode_start = std::chrono::steady_clock::now();
-    auto result       = uper_decode_complete(&stack_ctx, &asn_DEF_ULP_PDU,
-                                             reinterpret_cast<void**>(&ulp_pdu), buffer, size);
-    auto decode_end   = std::chrono::steady_clock::now();
-    auto decode_ms =
-        std::chrono::duration_cast<std::chrono::milliseconds>(decode_end - decode_start).count();
-
-    if (decode_ms > 100) {
-        WARNF("SUPL decode took %lld ms (buffer size: %zu bytes)", decode_ms, size);
-    } else {
-        VERBOSEF("SUPL decode took %lld ms (buffer size: %zu bytes)", decode_ms, size);
-    }
-
-    DEBUGF("uper_decode_complete(): %s %zd",
-           (result.code == RC_FAIL ? "RC_FAIL" : (result.code == RC_WMORE ? "RC_WMORE" : "RC_OK")),
-           result.consumed);
-    if (result.code == RC_FAIL) {
-        WARNF("failed to decode uper: %zd bytes consumed", result.consumed);
-        rb_consume(result.consumed);
+    // Wait until the complete PDU is buffered so that it is decoded exactly once. Decoding a
+    // partial PDU would throw away all the work on RC_WMORE.
+    auto size = pdu_length(mReceiveBuffer, mReceiveBufferOffset);
+    if (size < 4 || size > mReceiveBufferSize) {
+        // there is no way to find the next PDU in the stream
+        WARNF("invalid ULP PDU length: %zu bytes, discarding %zu bytes", size,
+              mReceiveBufferOffset);
+        rb_consume(mReceiveBufferOffset);
         return nullptr;
-    } else if (result.code == RC_WMORE) {
-        VERBOSEF("more data is needed to decode the fully message (%zd of %ld)", size,
-                 ulp_pdu->length);
-        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, ulp_pdu);
+    } else if (size > mReceiveBufferOffset) {
+        VERBOSEF("waiting for the complete ULP PDU (%zu of %zu bytes)", mReceiveBufferOffset,
+                 size);
         return nullptr;
-    } else {
-        rb_consume(result.consumed);
-        return ulp_pdu;
     }
+
+    // The PDU is consumed whatever the result, the next one starts right after it.
+    auto ulp_pdu = decode_ulp_pdu(mReceiveBuffer, size);
+    rb_consume(size);
+    return ulp_pdu;
 }
 
 bool Session::fill_receive_buffer() {
@@ -438,11 +425,7 @@ Session::Received Session::block_receive(RESPONSE* response, END* end, POS* pos)
         return Received::UnableToDecode;
     }
 
-    SUPL_DEFER {
-        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, ulp_pdu);
-    };
-
-    return parse_message(ulp_pdu, response, end, pos);
+    return receive_message(ulp_pdu, response, end, pos);
 }
 
 Session::Received Session::try_receive(RESPONSE* response, END* end, POS* pos) {
@@ -457,11 +440,22 @@ Session::Received Session::try_receive(RESPONSE* response, END* end, POS* pos) {
         return Received::NoData;
     }
 
-    SUPL_DEFER {
-        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, ulp_pdu);
-    };
+    return receive_message(ulp_pdu, response, end, pos);
+}
 
-    return parse_message(ulp_pdu, response, end, pos);
+Session::Received Session::receive_message(ULP_PDU* ulp_pdu, RESPONSE* response, END* end,
+                                           POS* pos) {
+    // The received POS payloads refer to the octets inside the decoded PDU, so the PDU is owned
+    // by the POS for as long as it is alive.
+    std::shared_ptr<ULP_PDU> owner(ulp_pdu, [](ULP_PDU* pdu) {
+        ASN_STRUCT_FREE(asn_DEF_ULP_PDU, pdu);
+    });
+
+    auto received = parse_message(ulp_pdu, response, end, pos);
+    if (pos && !pos->payloads.empty()) {
+        pos->pdu = std::move(owner);
+    }
+    return received;
 }
 
 Session::Received Session::parse_message(ULP_PDU* ulp_pdu, RESPONSE* response, END* end, POS* pos) {
@@ -27,7 +27,7 @@ public:
     DeferFinalizer& operator=(DeferFinalizer&&)      = delete;
 };
 
-struct {
+UNUSED struct {
     template <typename F>
     DeferFinalizer<F> operator<<(F&& f) {
         return DeferFinalizer<F>(std::forward<F>(f));
@@ -26,13 +26,18 @@ public:
 
     HandshakeResult handshake(int fd, std::string const& sni) override {
         if (!mCtx) {
-            mCtx = SSL_CTX_new(TLS_client_method());
+            mCtx = SSL_CTX_new(mConfig.server ? TLS_server_method() : TLS_client_method());
             if (!mCtx) {
                 ERRORF("SSL_CTX_new failed");
                 return HandshakeResult::Error;
             }
 
-            if (mConfig.skip_verify) {
+            if (mConfig.server) {
+                if (mConfig.client_cert_path.empty() || mConfig.client_key_path.empty()) {
+                    ERRORF("TLS server requires a certificate and a key");
+                    return HandshakeResult::Error;
+                }
+            } else if (mConfig.skip_verify) {
                 SSL_CTX_set_verify(mCtx, SSL_VERIFY_NONE, nullptr);
                 WARNF("TLS server verification disabled");
             } else {
@@ -75,14 +80,14 @@ public:
             }
 
             SSL_set_fd(mSsl, fd);
-            if (!sni.empty()) SSL_set_tlsext_host_name(mSsl, sni.c_str());
-            if (!mConfig.skip_verify && !sni.empty()) {
+            if (!mConfig.server && !sni.empty()) SSL_set_tlsext_host_name(mSsl, sni.c_str());
+            if (!mConfig.server && !mConfig.skip_verify && !sni.empty()) {
                 SSL_set1_host(mSsl, sni.c_str());
             }
         }
 
         ERR_clear_error();
-        auto ret = SSL_connect(mSsl);
+        auto ret = mConfig.server ? SSL_accept(mSsl) : SSL_connect(mSsl);
         if (ret == 1) {
             INFOF("TLS handshake ok: %s %s", SSL_get_version(mSsl), SSL_get_cipher(mSsl));
             return HandshakeResult::Ok;
@@ -95,7 +100,8 @@ public:
         auto queued = ERR_get_error();
         char buf[256];
         ERR_error_string_n(queued, buf, sizeof(buf));
-        ERRORF("SSL_connect failed: ssl_err=%d %s", err, buf);
+        ERRORF("%s failed: ssl_err=%d %s", mConfig.server ? "SSL_accept" : "SSL_connect", err,
+               buf);
         return HandshakeResult::Error;
     }
 
@@ -71,4 +71,11 @@ private:
     Timestamp mTm;
 };
 
+/// Replace the system clock used by `now()` of all time systems with a given time, e.g. the
+/// virtual clock of a replay. The time is in microseconds since the Unix epoch.
+void set_virtual_now(int64_t unix_us);
+/// Use the system clock for `now()` again.
+void clear_virtual_now();
+NODISCARD bool is_virtual_now();
+
 }  // namespace ts
@@ -6,8 +6,10 @@
 #include "tai.hpp"
 
 #include <array>
+#include <atomic>
 #include <cinttypes>
 #include <cmath>
+#include <cstdint>
 #include <ctime>
 #include <sys/time.h>
 
@@ -212,11 +214,38 @@ std::string Utc::rinex_filename() const {
     return std::string{buffer.data()};
 }
 
+static std::atomic<int64_t> gVirtualNowUs{INT64_MIN};
+
+void set_virtual_now(int64_t unix_us) {
+    gVirtualNowUs.store(unix_us, std::memory_order_relaxed);
+}
+
+void clear_virtual_now() {
+    gVirtualNowUs.store(INT64_MIN, std::memory_order_relaxed);
+}
+
+bool is_virtual_now() {
+    return gVirtualNowUs.load(std::memory_order_relaxed) != INT64_MIN;
+}
+
 Utc Utc::now() {
     struct timeval tv{};
     struct tm      time_info{};
 
-    gettimeofday(&tv, nullptr);
+    auto virtual_us = gVirtualNowUs.load(std::memory_order_relaxed);
+    if (virtual_us != INT64_MIN) {
+        // Floor division, the microseconds are always positive like those of gettimeofday
+        auto unix_seconds = virtual_us / 1000000;
+        auto unix_micros  = virtual_us % 1000000;
+        if (unix_micros < 0) {
+            unix_seconds -= 1;
+            unix_micros += 1000000;
+        }
+        tv.tv_sec  = static_cast<time_t>(unix_seconds);
+        tv.tv_usec = static_cast<suseconds_t>(unix_micros);
+    } else {
+        gettimeofday(&tv, nullptr);
+    }
     auto tt = gmtime_r(&tv.tv_sec, &time_info);
 
     auto year      = tt->tm_year + GMTIME_START_YEAR;
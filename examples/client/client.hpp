@@ -6,7 +6,9 @@
 #include <scheduler/scheduler.hpp>
 #include <streamline/system.hpp>
 
+#include <client-io/parser_read_target.hpp>
 #include <format/ctrl/parser.hpp>
+#include <format/helper/demux.hpp>
 #include <format/lpp/uper_parser.hpp>
 #include <format/nmea/message.hpp>
 #include <format/nmea/parser.hpp>
@@ -36,6 +38,16 @@ struct InputContext {
     std::unique_ptr<format::lpp::UperParser> lpp_uper{};
     std::unique_ptr<format::lpp::UperParser> lpp_uper_pad{};
     bool                                     raw{};
+
+    // Splits mixed NMEA/RTCM/UBX input into frames so each parser only sees its own format
+    std::unique_ptr<format::helper::Demultiplexer> demux{};
+    // Inputs with a single parser read straight into its buffer
+    std::unique_ptr<ParserReadTarget> read_target{};
+
+    streamline::Channel<std::unique_ptr<format::nmea::Message>> nmea_channel{};
+    streamline::Channel<std::unique_ptr<format::rtcm::Message>> rtcm_channel{};
+    streamline::Channel<std::unique_ptr<format::ubx::Message>>  ubx_channel{};
+    streamline::Channel<std::unique_ptr<format::ctrl::Message>> ctrl_channel{};
 };
 
 struct Program {
@@ -45,10 +57,10 @@ struct Program {
     io::StreamRegistry   stream_registry;
     scheduler::Scheduler scheduler;
     streamline::System   stream;
-    bool                 is_disconnected;
+    bool                 is_disconnected{false};
 
     lpp::PeriodicSessionHandle assistance_data_session{};
-    size_t                     assistance_data_request_count;
+    size_t                     assistance_data_request_count{0};
 
     lpp::Optional<lpp::LocationInformation> latest_location_information;
     lpp::Optional<lpp::HaGnssMetrics>       latest_gnss_metrics;
@@ -66,6 +78,7 @@ struct Program {
     std::unique_ptr<format::rtcm::Parser>      ntrip_parser;
 
     std::unique_ptr<scheduler::PeriodicTask> fake_location_task;
+    std::unique_ptr<scheduler::PeriodicTask> stream_stats_task;
 
     uint64_t lpp_tag{0};
 
@@ -73,6 +86,8 @@ struct Program {
     bool                                    shutdown_scheduled{false};
     std::unique_ptr<scheduler::TimeoutTask> shutdown_task;
 
+    EXPLICIT Program(scheduler::Backend backend) : scheduler(backend) {}
+
     void update_location_information(lpp::LocationInformation const& location) {
         latest_location_information           = location;
         latest_location_information_submitted = false;
@@ -91,7 +91,7 @@ struct PrintInterface {
                                  std::vector<std::string> exclude_tags) {
         return {
             format,           std::move(include_tags), std::move(exclude_tags),
-            tags::TagMask(0), tags::TagMask(0),
+            tags::TagMask{},  tags::TagMask{},
         };
     }
 
@@ -105,7 +105,7 @@ struct PrintInterface {
     }
 
     NODISCARD inline bool accept_tag(uint64_t tag) const {
-        return tags::TagMask::filter(include_tag_mask, exclude_tag_mask, tags::Tag(tag));
+        return tags::TagMask::filter(include_tag_mask, exclude_tag_mask, tags::mask(tag));
     }
 };
 
@@ -245,7 +245,8 @@ struct GnssConfig {
 };
 
 struct SchedulerConfig {
-    int max_events_per_wait;
+    int  max_events_per_wait;
+    bool io_uring;
 };
 
 #ifdef INCLUDE_GENERATOR_RTCM
@@ -340,12 +341,17 @@ struct Lpp2SpartnConfig {
     bool                          do_not_use_atmosphere;
     double                        iono_quality_threshold;  // <0 = disabled
     std::string                   output_tag;
+    size_t                        hpac_threads;
+    size_t                        tile_batch;  // 0 = number of tile tags, or 1
     generator::spartn::CrcType    crc_type;
     uint8_t                       solution_id;
     uint8_t                       solution_processor_id;
 
     // Per-GNSS bias maps: [0]=GPS, [1]=GLO, [2]=GAL, [3]=BDS
     std::array<generator::spartn::BiasMap, 4> bias_maps;
+
+    // Per-tile output tags, correction point set id -> tag
+    std::unordered_map<uint16_t, std::string> tile_tags;
 };
 #endif
 
@@ -420,6 +426,7 @@ struct TokoroConfig {
 
     std::string              antex_file;
     std::vector<std::string> nav_files;
+    std::string              file_cache_dir;  // snapshots of the antex and nav files
     bool                     ignore_bitmask;
     bool                     deduplicate_epochs;
     std::string              output_tag;
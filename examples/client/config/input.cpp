@@ -38,6 +38,7 @@ static args::ValueFlagList<std::string> gArgs{
     "    databits=<5|6|7|8>\n"
     "    stopbits=<1|2>\n"
     "    parity=<none|odd|even>\n"
+    "    low_latency=<bool>\n"
     "  tcp-client:\n"
     "    host=<host>\n"
     "    port=<port>\n"
@@ -239,6 +240,8 @@ static void parse_serial(Options const& options, InputsConfig& inputs) {
     if (options.find("parity") != options.end()) {
         cfg.config.parity_bit = parse_paritybit(options.at("parity"));
     }
+    cfg.config.low_latency = parse_bool(options, "low_latency", false);
+    cfg.config.read_config = parse_read_config(options);
 
     inputs.serial.push_back(std::move(cfg));
 }
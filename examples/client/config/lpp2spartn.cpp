@@ -2,6 +2,8 @@
 #include <loglet/loglet.hpp>
 #include "../config.hpp"
 
+#include <cstdlib>
+
 #undef LOGLET_CURRENT_MODULE
 #define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(client, config)
 
@@ -294,6 +296,29 @@ static args::ValueFlag<std::string> gOutputTag{
     {"l2s-output-tag"},
 };
 
+static args::Group                       gTileGroup{gGroup, "Tiles:"};
+static args::ValueFlagList<std::string> gTileTag{
+    gTileGroup,
+    "set-id=tag",
+    "Tag to apply to GAD and HPAC messages of a correction point set (tile), OCB messages get "
+    "the tags of all tiles. Can be repeated",
+    {"l2s-tile-tag"},
+};
+static args::ValueFlag<int> gTileBatch{
+    gTileGroup,
+    "count",
+    "Generate from batches of LPP messages, one epoch of a feed with a correction point set "
+    "(tile) per message. OCB messages are encoded once per batch (default: the number of "
+    "--l2s-tile-tag, or 1)",
+    {"l2s-tile-batch"},
+};
+static args::ValueFlag<int> gHpacThreads{
+    gTileGroup,
+    "threads",
+    "Encode HPAC messages of different tiles in parallel (default: 1)",
+    {"l2s-hpac-threads"},
+};
+
 static args::Group                  gTransportGroup{gGroup, "Transport:"};
 static args::ValueFlag<std::string> gCrcType{
     gTransportGroup,
@@ -367,6 +392,8 @@ void parse(Config* config) {
     lpp2spartn.do_not_use_atmosphere  = true;
     lpp2spartn.iono_quality_threshold = -1.0;
     lpp2spartn.output_tag             = "";
+    lpp2spartn.hpac_threads           = 1;
+    lpp2spartn.tile_batch             = 0;
     lpp2spartn.crc_type               = generator::spartn::CrcType::CRC16;
     lpp2spartn.solution_id            = 0;
     lpp2spartn.solution_processor_id  = 0;
@@ -434,6 +461,38 @@ void parse(Config* config) {
     if (gSignFlipC11) lpp2spartn.sign_flip_c11 = true;
     if (gOutputTag) lpp2spartn.output_tag = gOutputTag.Get();
 
+    for (auto const& value : gTileTag.Get()) {
+        auto eq = value.find('=');
+        if (eq == std::string::npos || eq == 0 || eq + 1 == value.size()) {
+            throw args::ValidationError("--l2s-tile-tag: expected SET-ID=TAG, got `" + value +
+                                        "`");
+        }
+
+        char* end    = nullptr;
+        auto  set_id = strtol(value.c_str(), &end, 10);
+        if (end != value.c_str() + eq || set_id < 0 || set_id > 65535) {
+            throw args::ValidationError("--l2s-tile-tag: invalid correction point set id in `" +
+                                        value + "`");
+        }
+        lpp2spartn.tile_tags[static_cast<uint16_t>(set_id)] = value.substr(eq + 1);
+    }
+
+    if (gTileBatch) {
+        if (gTileBatch.Get() < 1) {
+            throw args::ValidationError("--l2s-tile-batch: must be at least 1, got `" +
+                                        std::to_string(gTileBatch.Get()) + "`");
+        }
+        lpp2spartn.tile_batch = static_cast<size_t>(gTileBatch.Get());
+    }
+
+    if (gHpacThreads) {
+        if (gHpacThreads.Get() < 1) {
+            throw args::ValidationError("--l2s-hpac-threads: must be at least 1, got `" +
+                                        std::to_string(gHpacThreads.Get()) + "`");
+        }
+        lpp2spartn.hpac_threads = static_cast<size_t>(gHpacThreads.Get());
+    }
+
     if (gCrcType) {
         auto type = gCrcType.Get();
         if (type == "crc8") {
@@ -636,6 +695,12 @@ void dump(Lpp2SpartnConfig const& config) {
     DEBUGF("C01: %s", config.sign_flip_c01 ? "flipped" : "normal");
     DEBUGF("C10: %s", config.sign_flip_c10 ? "flipped" : "normal");
     DEBUGF("C11: %s", config.sign_flip_c11 ? "flipped" : "normal");
+
+    DEBUGF("HPAC threads: %zu", config.hpac_threads);
+    DEBUGF("tile batch: %zu", config.tile_batch);
+    for (auto const& kvp : config.tile_tags) {
+        DEBUGF("tile %u: tag=%s", kvp.first, kvp.second.c_str());
+    }
 }
 
 }  // namespace lpp2spartn
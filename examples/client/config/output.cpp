@@ -49,6 +49,8 @@ static args::ValueFlagList<std::string> gArgs{
     "    host=<host>\n"
     "    port=<port>\n"
     "    path=<path>\n"
+    "    fanout=<host>:<port>+...\n"
+    "    segment=<bytes>\n"
     "  tcp-server:\n"
     "    host=<host>\n"
     "    port=<port>\n"
@@ -292,6 +294,12 @@ static void parse_udp_client(Options const& options, OutputsConfig& outputs) {
         cfg.config.host = options.at("host");
         cfg.config.port = static_cast<uint16_t>(std::stoul(options.at("port")));
     }
+    if (options.find("fanout") != options.end()) {
+        cfg.config.fanout = parse_list(options.at("fanout"), '+');
+    }
+    if (options.find("segment") != options.end()) {
+        cfg.config.segment_size = std::stoull(options.at("segment"));
+    }
     cfg.stream_id = generate_stream_id("udp-client", options, unique);
 
     outputs.udp_client.push_back(std::move(cfg));
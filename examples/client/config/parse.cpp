@@ -118,6 +118,7 @@ io::ReadBufferConfig parse_read_config(Options const& options) {
     if (it != options.end()) {
         config.timeout = std::chrono::milliseconds(std::stoll(it->second));
     }
+    config.timestamp = parse_bool(options, "read_timestamp", false);
     return config;
 }
 
@@ -25,6 +25,13 @@ static args::ValueFlag<int> gMaxEventsPerWait{
     "Maximum number of events to process per wait",
     {"scheduler-max-events"},
 };
+static args::Flag gIoUring{
+    gGroup,
+    "io-uring",
+    "Wait for events and read/write TCP streams with io_uring instead of epoll, falls back to "
+    "epoll when unsupported",
+    {"scheduler-io-uring"},
+};
 
 void setup(args::ArgumentParser& parser) {
     static args::GlobalOptions sGlobals{parser, gGroup};
@@ -33,14 +40,19 @@ void setup(args::ArgumentParser& parser) {
 void parse(Config* config) {
     auto& scheduler               = config->scheduler;
     scheduler.max_events_per_wait = 1;
+    scheduler.io_uring            = false;
 
     if (gMaxEventsPerWait) {
         scheduler.max_events_per_wait = args::get(gMaxEventsPerWait);
     }
+    if (gIoUring) {
+        scheduler.io_uring = true;
+    }
 }
 
 void dump(SchedulerConfig const& config) {
     DEBUGF("max_events_per_wait: %d", config.max_events_per_wait);
+    DEBUGF("io_uring: %s", config.io_uring ? "true" : "false");
 }
 
 }  // namespace scheduler
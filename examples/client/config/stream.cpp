@@ -25,7 +25,8 @@ static args::ValueFlagList<std::string> gArgs{
     "Common arguments:\n"
     "  id=<name>                  Required: unique identifier\n"
     "  read_min_bytes=<N>         Read buffering: min bytes\n"
-    "  read_timeout_ms=<N>        Read buffering: flush interval\n\n"
+    "  read_timeout_ms=<N>        Read buffering: flush interval\n"
+    "  read_timestamp=<bool>      Timestamp reads and measure the read latency\n\n"
     "Types:\n"
     "  serial:\n"
     "    device=<device>\n"
@@ -34,6 +35,7 @@ static args::ValueFlagList<std::string> gArgs{
     "    stopbits=<1|2>\n"
     "    parity=<none|odd|even>\n"
     "    raw=<bool>\n"
+    "    low_latency=<bool>\n"
     "  tcp-client:\n"
     "    host=<host>\n"
     "    port=<port>\n"
@@ -47,6 +49,8 @@ static args::ValueFlagList<std::string> gArgs{
     "    host=<host>\n"
     "    port=<port>\n"
     "    path=<path>\n"
+    "    fanout=<host>:<port>+...\n"
+    "    segment=<bytes>\n"
     "  udp-server:\n"
     "    listen=<addr>\n"
     "    port=<port>\n"
@@ -93,6 +97,7 @@ static void parse_serial(std::string const& id, Options const& options, StreamsC
         cfg.config.parity_bit = parse_paritybit(options.at("parity"));
     }
     cfg.config.raw         = parse_bool(options, "raw", false);
+    cfg.config.low_latency = parse_bool(options, "low_latency", false);
     cfg.config.read_config = parse_read_config(options);
 
     streams.serial.push_back(std::move(cfg));
@@ -152,6 +157,12 @@ static void parse_udp_client(std::string const& id, Options const& options,
         cfg.config.port = static_cast<uint16_t>(std::stoul(options.at("port")));
     }
     cfg.config.read_config = parse_read_config(options);
+    if (options.find("fanout") != options.end()) {
+        cfg.config.fanout = parse_list(options.at("fanout"), '+');
+    }
+    if (options.find("segment") != options.end()) {
+        cfg.config.segment_size = std::stoull(options.at("segment"));
+    }
 
     streams.udp_client.push_back(std::move(cfg));
 }
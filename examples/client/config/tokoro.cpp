@@ -284,6 +284,14 @@ static args::ValueFlagList<std::string> gNavFile{
     {"tkr-nav-file"},
 };
 
+static args::ValueFlag<std::string> gFileCacheDir{
+    gGroup,
+    "directory",
+    "Directory for binary snapshots of the antex and nav files, later startups load the "
+    "snapshot instead of parsing the file again",
+    {"tkr-file-cache-dir"},
+};
+
 static args::Flag gIgnoreBitmask{
     gGroup,
     "ignore-bitmask",
@@ -444,6 +452,7 @@ void parse(Config* config) {
     tokoro.time_step           = 1.0;
 
     tokoro.antex_file          = "";
+    tokoro.file_cache_dir      = "";
     tokoro.ignore_bitmask      = false;
     tokoro.deduplicate_epochs  = false;
     tokoro.output_tag          = "";
@@ -579,6 +588,7 @@ void parse(Config* config) {
     if (gUseIonosphericHeightCorrection) tokoro.use_ionospheric_height_correction = true;
     if (gAntexFile) tokoro.antex_file = gAntexFile.Get();
     if (gNavFile) tokoro.nav_files = gNavFile.Get();
+    if (gFileCacheDir) tokoro.file_cache_dir = gFileCacheDir.Get();
     if (gIgnoreBitmask) tokoro.ignore_bitmask = true;
     if (gDeduplicateEpochs) tokoro.deduplicate_epochs = true;
     if (gOutputTag) tokoro.output_tag = gOutputTag.Get();
@@ -688,6 +698,7 @@ void dump(TokoroConfig const& config) {
     DEBUGF("antex file: \"%s\"", config.antex_file.c_str());
     for (auto const& nf : config.nav_files)
         DEBUGF("nav file:   \"%s\"", nf.c_str());
+    DEBUGF("file cache: \"%s\"", config.file_cache_dir.c_str());
     DEBUGF("ignore bitmask: %s", config.ignore_bitmask ? "true" : "false");
 }
 
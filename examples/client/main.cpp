@@ -15,6 +15,8 @@ EXTERNAL_WARNINGS_POP
 #include <lpp/messages/provide_location_information.hpp>
 #include <lpp/provide_capabilities.hpp>
 #include <scheduler/timeout.hpp>
+#include <scheduler/virtual_clock.hpp>
+#include <time/utc.hpp>
 
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -311,6 +313,13 @@ static void client_initialize(Program& program, lpp::Client&) {
         program.config.location_server.hack_server_initiated_push);
 }
 
+// Data read into the parser buffer through the input's read target is already appended
+static void append(InputContext const& p, format::helper::Parser& parser, uint8_t const* buffer,
+                   size_t count) {
+    if (p.read_target && parser.contains(buffer)) return;
+    parser.append(buffer, count);
+}
+
 static void process_input(Program& program, InputContext& p, InputFormat formats,
                           uint8_t const* buffer, size_t count, uint64_t tag) {
     VERBOSEF("input %s: %zu bytes", p.name.c_str(), count);
@@ -344,8 +353,25 @@ static void process_input(Program& program, InputContext& p, InputFormat formats
     }
 #endif
 
+    // With more than one of NMEA, RTCM and UBX enabled, frame the input once and only append each
+    // frame to the parser of its format instead of appending every byte to every parser.
+    auto demux_formats = formats & (INPUT_FORMAT_NMEA | INPUT_FORMAT_RTCM | INPUT_FORMAT_UBX);
+    auto use_demux     = p.demux && (demux_formats & (demux_formats - 1)) != 0;
+    if (use_demux) {
+        p.demux->append(buffer, count);
+        format::helper::Frame frame{};
+        while (p.demux->next(frame)) {
+            switch (frame.format) {
+            case format::helper::FRAME_NMEA: p.nmea->append(frame.data, frame.length); break;
+            case format::helper::FRAME_RTCM: p.rtcm->append(frame.data, frame.length); break;
+            case format::helper::FRAME_UBX: p.ubx->append(frame.data, frame.length); break;
+            default: break;
+            }
+        }
+    }
+
     if (p.nmea && (formats & INPUT_FORMAT_NMEA) != 0) {
-        p.nmea->append(buffer, count);
+        if (!use_demux) append(p, *p.nmea, buffer, count);
         for (;;) {
             auto message = p.nmea->try_parse();
             if (!message) break;
@@ -356,12 +382,12 @@ static void process_input(Program& program, InputContext& p, InputFormat formats
                 dynamic_cast<format::nmea::UnsupportedMessage*>(message.get()))
                 continue;
             if (p.input->entry.print) message->print();
-            program.stream.push(std::move(message), tag);
+            p.nmea_channel.push(std::move(message), tag);
         }
     }
 
     if (p.rtcm && (formats & INPUT_FORMAT_RTCM) != 0) {
-        p.rtcm->append(buffer, count);
+        if (!use_demux) append(p, *p.rtcm, buffer, count);
         for (;;) {
             auto message = p.rtcm->try_parse();
             if (!message) break;
@@ -372,12 +398,12 @@ static void process_input(Program& program, InputContext& p, InputFormat formats
                 dynamic_cast<format::rtcm::UnsupportedMessage*>(message.get()))
                 continue;
             if (p.input->entry.print) message->print();
-            program.stream.push(std::move(message), tag);
+            p.rtcm_channel.push(std::move(message), tag);
         }
     }
 
     if (p.ubx && (formats & INPUT_FORMAT_UBX) != 0) {
-        p.ubx->append(buffer, count);
+        if (!use_demux) append(p, *p.ubx, buffer, count);
         for (;;) {
             auto message = p.ubx->try_parse();
             if (!message) break;
@@ -385,22 +411,22 @@ static void process_input(Program& program, InputContext& p, InputFormat formats
                 dynamic_cast<format::ubx::UnsupportedMessage*>(message.get()))
                 continue;
             if (p.input->entry.print) message->print();
-            program.stream.push(std::move(message), tag);
+            p.ubx_channel.push(std::move(message), tag);
         }
     }
 
     if (p.ctrl && (formats & INPUT_FORMAT_CTRL) != 0) {
-        p.ctrl->append(buffer, count);
+        append(p, *p.ctrl, buffer, count);
         for (;;) {
             auto message = p.ctrl->try_parse();
             if (!message) break;
             if (p.input->entry.print) message->print();
-            program.stream.push(std::move(message), tag);
+            p.ctrl_channel.push(std::move(message), tag);
         }
     }
 
     if (p.lpp_uper && (formats & INPUT_FORMAT_LPP_UPER) != 0) {
-        p.lpp_uper->append(buffer, count);
+        append(p, *p.lpp_uper, buffer, count);
         for (;;) {
             auto message = p.lpp_uper->try_parse();
             if (!message) break;
@@ -414,7 +440,7 @@ static void process_input(Program& program, InputContext& p, InputFormat formats
     }
 
     if (p.lpp_uper_pad && (formats & INPUT_FORMAT_LPP_UPER_PAD) != 0) {
-        p.lpp_uper_pad->append(buffer, count);
+        append(p, *p.lpp_uper_pad, buffer, count);
         for (;;) {
             auto message = p.lpp_uper_pad->try_parse_provide_assistance_data();
             if (!message) break;
@@ -432,6 +458,27 @@ static void process_input(Program& program, InputContext& p, InputFormat formats
     }
 }
 
+// Replaying tbin inputs on a virtual clock must be set up before any timer is created
+static void setup_virtual_clock(Config const& config) {
+    for (auto const& entry : config.inputs_config.inputs) {
+        if (entry.type != "tbin" || !entry.options.count("virtual-clock")) continue;
+        auto const& value = entry.options.at("virtual-clock");
+        if (value != "true" && !value.empty()) continue;
+        if (entry.options.count("realtime") &&
+            (entry.options.at("realtime") == "true" || entry.options.at("realtime").empty())) {
+            WARNF("tbin: virtual-clock is ignored with realtime replay");
+            return;
+        }
+
+        INFOF("replaying on a virtual clock");
+        scheduler::VirtualClock::enable();
+        scheduler::VirtualClock::set_listener([](int64_t now_us) {
+            ts::set_virtual_now(now_us);
+        });
+        return;
+    }
+}
+
 static void create_io_from_config(Program& program) {
     auto& config = program.config;
     create_streams(config.streams_config, program.stream_registry);
@@ -521,6 +568,8 @@ static void create_io_from_config(Program& program) {
 #ifdef INCLUDE_GENERATOR_SPARTN
     if (!config.lpp2spartn.output_tag.empty())
         registry.register_tag(config.lpp2spartn.output_tag, "lpp2spartn output tag", "custom");
+    for (auto const& kvp : config.lpp2spartn.tile_tags)
+        registry.register_tag(kvp.second, "lpp2spartn tile tag", "custom");
 #endif
 #ifdef INCLUDE_GENERATOR_TOKORO
     if (!config.tokoro.output_tag.empty())
@@ -533,7 +582,7 @@ static void create_io_from_config(Program& program) {
     if (!config.location_server.output_tag.empty())
         registry.register_tag(config.location_server.output_tag, "location server tag", "custom");
 
-    program.lpp_tag = registry.get_tag(config.location_server.output_tag).value;
+    program.lpp_tag = registry.id(registry.get_tag(config.location_server.output_tag));
 }
 
 static void initialize_inputs(Program& program, ProgramInput& config) {
@@ -561,9 +610,10 @@ static void initialize_inputs(Program& program, ProgramInput& config) {
             tag_stream << input.entry.tags[i];
         }
 
-        auto tag_str = tag_stream.str();
-        auto tag     = global_tag_registry().get_tag(input.entry.tags) |
-                   global_tag_registry().get_tag("input");
+        auto tag_str  = tag_stream.str();
+        auto tag_mask = global_tag_registry().get_tag(input.entry.tags) |
+                        global_tag_registry().get_tag("input");
+        auto tag      = global_tag_registry().id(tag_mask);
         bool raw = (input.entry.format & INPUT_FORMAT_RAW) != 0;
 
         DEBUGF("input  %p: %s%s%s%s%s%s%s %s[%" PRIu64 "]", input.interface.get(),
@@ -621,6 +671,37 @@ static void initialize_inputs(Program& program, ProgramInput& config) {
         if (lpp_uper_pad)
             context->lpp_uper_pad = std::unique_ptr<format::lpp::UperParser>(lpp_uper_pad);
 
+        uint32_t demux_formats = 0;
+        if (nmea) demux_formats |= format::helper::FRAME_NMEA;
+        if (rtcm) demux_formats |= format::helper::FRAME_RTCM;
+        if (ubx) demux_formats |= format::helper::FRAME_UBX;
+        if ((demux_formats & (demux_formats - 1)) != 0) {
+            context->demux = std::unique_ptr<format::helper::Demultiplexer>(
+                new format::helper::Demultiplexer{demux_formats});
+        }
+
+        if (nmea) context->nmea_channel = program.stream.channel<NmeaMessage>();
+        if (rtcm) context->rtcm_channel = program.stream.channel<RtcmMessage>();
+        if (ubx) context->ubx_channel = program.stream.channel<UbxMessage>();
+        if (ctrl) context->ctrl_channel = program.stream.channel<CtrlMessage>();
+
+        // With a single parser the input can read into its buffer, so the data is copied once
+        format::helper::Parser* parsers[] = {nmea, rtcm, ubx, ctrl, lpp_uper, lpp_uper_pad};
+        format::helper::Parser* single_parser = nullptr;
+        auto                    parser_count  = 0;
+        for (auto* parser : parsers) {
+            if (!parser) continue;
+            single_parser = parser;
+            parser_count++;
+        }
+        if (parser_count == 1) {
+            context->read_target = std::unique_ptr<ParserReadTarget>(
+                new ParserReadTarget{*single_parser});
+            if (!input.interface->set_read_target(context->read_target.get())) {
+                context->read_target.reset();
+            }
+        }
+
         auto context_ptr = context.get();
         program.input_contexts.push_back(std::move(context));
 
@@ -633,11 +714,15 @@ static void initialize_inputs(Program& program, ProgramInput& config) {
             (void)input.interface->schedule(program.scheduler);
             program.input_stages.push_back(nullptr);  // placeholder to keep indices aligned
         } else {
-            auto stage = std::unique_ptr<InputStage>(
+            auto interface = input.interface.get();
+            auto stage     = std::unique_ptr<InputStage>(
                 new InterfaceInputStage(std::move(input.interface), input.entry.format));
-            stage->callback = [context_ptr, &program, tag](InputFormat    format,
-                                                           uint8_t const* buffer, size_t length) {
+            stage->callback = [context_ptr, &program, tag, interface](
+                                  InputFormat format, uint8_t const* buffer, size_t length) {
+                // Messages parsed from the data carry its read time to the outputs
+                program.stream.set_read_time(interface->read_time());
                 process_input(program, *context_ptr, format, buffer, length, tag);
+                program.stream.set_read_time({});
             };
             (void)stage->schedule(program.scheduler);
             program.input_stages.push_back(std::move(stage));
@@ -713,7 +798,7 @@ static void initialize_outputs(Program& program, ProgramOutput& config) {
         if (output.test_support()) test_output = true;
 
         auto last_stage = std::unique_ptr<OutputStage>(
-            new InterfaceOutputStage(std::move(output.initial_interface)));
+            new InterfaceOutputStage(std::move(output.initial_interface), program.stream));
         output.stage = std::move(last_stage);
 
         ASSERT(output.stage, "stage is null");
@@ -722,6 +807,8 @@ static void initialize_outputs(Program& program, ProgramOutput& config) {
         }
     }
 
+    config.compile_routes();
+
     if (lpp_xer_output) program.stream.add_inspector<LppXerOutput>(config);
     if (lpp_uper_output) program.stream.add_inspector<LppUperOutput>(config);
     if (nmea_output) program.stream.add_inspector<NmeaOutput>(config);
@@ -734,7 +821,7 @@ static void initialize_outputs(Program& program, ProgramOutput& config) {
 #endif
     if (location_output) program.stream.add_inspector<LocationOutput>(config);
     if (test_output)
-        test_outputer(program.scheduler, config, global_tag_registry().get_tag("test"));
+        test_outputer(program.scheduler, config, tags::id(global_tag_registry().get_tag("test")));
 }
 
 static void setup_print_inspectors(Program& program) {
@@ -895,17 +982,17 @@ static void setup_lpp2osr(UNUSED Program& program) {
     }
 
     if (program.config.lpp2eph.enabled) {
-        auto tag = global_tag_registry().get_tag("lpp2eph");
+        auto tag = tags::id(global_tag_registry().get_tag("lpp2eph"));
         program.stream.add_inspector<Lpp2Eph>(program.config.lpp2eph, tag);
     }
 
     if (program.config.ubx2eph.enabled) {
-        auto tag = global_tag_registry().get_tag("ubx2eph");
+        auto tag = tags::id(global_tag_registry().get_tag("ubx2eph"));
         program.stream.add_inspector<Ubx2Eph>(program.config.ubx2eph, tag);
     }
 
     if (program.config.rtcm2eph.enabled) {
-        auto tag = global_tag_registry().get_tag("rtcm2eph");
+        auto tag = tags::id(global_tag_registry().get_tag("rtcm2eph"));
         program.stream.add_inspector<Rtcm2Eph>(program.config.rtcm2eph, tag);
     }
 #endif
@@ -914,7 +1001,7 @@ static void setup_lpp2osr(UNUSED Program& program) {
 static void setup_lpp2spartn(UNUSED Program& program) {
 #if defined(INCLUDE_GENERATOR_SPARTN)
     if (program.config.lpp2spartn.enabled) {
-        program.stream.add_inspector<Lpp2Spartn>(program.output, program.config.lpp2spartn);
+        program.stream.add_consumer<Lpp2Spartn>(program.output, program.config.lpp2spartn);
     }
 #endif
 }
@@ -1127,8 +1214,10 @@ int main(int argc, char** argv) {
     }
 
     config_dump(&config);
+    setup_virtual_clock(config);
 
-    Program program{};
+    Program program{config.scheduler.io_uring ? scheduler::Backend::IoUring :
+                                                scheduler::Backend::Epoll};
     program.config = std::move(config);
     scheduler::SchedulerGuard scheduler_guard{program.scheduler};
 
@@ -1149,6 +1238,10 @@ int main(int argc, char** argv) {
     program.is_disconnected = false;
 
     program.scheduler.set_max_events_per_wait(program.config.scheduler.max_events_per_wait);
+    if (program.config.scheduler.io_uring &&
+        program.scheduler.backend() != scheduler::Backend::IoUring) {
+        WARNF("io_uring is not available, using epoll");
+    }
 
     global_tag_registry().register_tag("input", "Input data", "custom");
 
@@ -1172,8 +1265,8 @@ int main(int argc, char** argv) {
             };
         }
         auto* rtcm_parser = new format::rtcm::Parser{};
-        auto  rtcm_tag =
-            global_tag_registry().get_tag("ntrip") | global_tag_registry().get_tag("input");
+        auto  rtcm_tag    = tags::id(global_tag_registry().get_tag("ntrip") |
+                                     global_tag_registry().get_tag("input"));
         auto ntrip = std::make_unique<NtripSource>(
             program.config.ntrip,
             [&program, rtcm_parser, rtcm_tag](uint8_t const* data, size_t len) {
@@ -1395,6 +1488,18 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    auto stats_interval = program.config.streams_config.stats_interval;
+    if (stats_interval.count() > 0) {
+        program.stream_stats_task =
+            std::unique_ptr<scheduler::PeriodicTask>(new scheduler::PeriodicTask{stats_interval});
+        program.stream_stats_task->callback = [&program]() {
+            program.stream_registry.log_stats();
+        };
+        if (!program.stream_stats_task->schedule(program.scheduler)) {
+            WARNF("failed to schedule stream statistics");
+        }
+    }
+
     program.scheduler.execute();
     return 0;
 }
@@ -23,16 +23,10 @@ void CtrlOutput::inspect(streamline::System&, DataType const& message, uint64_t
     auto payload = message->payload();
     auto data    = reinterpret_cast<uint8_t const*>(payload.data());
     auto size    = payload.size();
-    for (auto const& output : mConfig.outputs) {
-        if (!output.ctrl_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "ctrl: tag %s not accepted: %s",
-                      output.tag_name(tag).c_str(), output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mConfig.route(OUTPUT_FORMAT_CTRL, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "ctrl: (%zd bytes) tag=%llX", size, tag);
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_CTRL, data, size);
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_CTRL, data, size);
     }
 }
 
@@ -343,7 +343,7 @@ IdokeidoSpp::IdokeidoSpp(ProgramOutput const&, IdokeidoConfig const& config,
 
     mEngine = std::unique_ptr<idokeido::SppEngine>(
         new idokeido::SppEngine{configuration, *mEphemerisEngine, *mCorrectionCache});
-    mOutputTag = tags::get(mConfig.output_tag).value;
+    mOutputTag = tags::id(tags::get(mConfig.output_tag));
 
     // TODO(ewasjon): Change to a better system
     {
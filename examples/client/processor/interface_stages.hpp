@@ -3,18 +3,29 @@
 #include <client-io/stage.hpp>
 #include <io/input.hpp>
 #include <io/output.hpp>
+#include <streamline/system.hpp>
 
 #include <memory>
 
 class InterfaceOutputStage : public OutputStage {
 public:
-    explicit InterfaceOutputStage(std::unique_ptr<io::Output> interface) NOEXCEPT
-        : mInterface(std::move(interface)) {}
+    explicit InterfaceOutputStage(std::unique_ptr<io::Output> interface,
+                                  streamline::System const&   system) NOEXCEPT
+        : mInterface(std::move(interface)),
+          mSystem(system) {}
 
     void write(OutputFormat, uint8_t const* buffer, size_t length) NOEXCEPT override {
         mInterface->write(buffer, length);
+
+        // Written while delivering a message generated from timestamped input
+        auto read_time = mSystem.read_time();
+        if (read_time != std::chrono::steady_clock::time_point{}) {
+            mInterface->record_output_latency(read_time);
+        }
     }
 
+    void end_epoch() NOEXCEPT override { mInterface->end_epoch(); }
+
 protected:
     bool do_schedule(scheduler::Scheduler& s) NOEXCEPT override { return mInterface->schedule(s); }
     bool do_cancel(scheduler::Scheduler&) NOEXCEPT override {
@@ -24,6 +35,7 @@ protected:
 
 private:
     std::unique_ptr<io::Output> mInterface;
+    streamline::System const&   mSystem;
 };
 
 class InterfaceInputStage : public InputStage {
@@ -81,16 +81,10 @@ void LocationOutput::inspect(streamline::System&, DataType const& location, uint
     auto sentence = result.str();
     auto data     = reinterpret_cast<uint8_t const*>(sentence.data());
     auto size     = sentence.size();
-    for (auto const& output : mOutput.outputs) {
-        if (!output.location_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "location: tag %s not accepted: %s",
-                      output.tag_name(tag).c_str(), output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_LOCATION, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "location: (%zd bytes) tag=%llX", size, tag);
 
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_LOCATION, data, size);
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_LOCATION, data, size);
     }
 }
@@ -19,16 +19,10 @@ void LppXerOutput::inspect(streamline::System&, DataType const& message, uint64_
     auto data        = reinterpret_cast<uint8_t const*>(xer_message.c_str());
     auto size        = xer_message.size();
 
-    for (auto const& output : mOutput.outputs) {
-        if (!output.lpp_xer_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "lpp-xer: tag %s not accepted: %s",
-                      output.tag_name(tag).c_str(), output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_LPP_XER, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "lpp-xer: (%zd bytes) tag=%llX", size, tag);
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_LPP_XER, data, size);
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_LPP_XER, data, size);
     }
 }
 
@@ -40,15 +34,9 @@ void LppUperOutput::inspect(streamline::System&, DataType const& message, uint64
     auto data = reinterpret_cast<uint8_t const*>(buffer.data());
     auto size = buffer.size();
 
-    for (auto const& output : mOutput.outputs) {
-        if (!output.lpp_uper_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "lpp-uper: tag %s not accepted: %s",
-                      output.tag_name(tag).c_str(), output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_LPP_UPER, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "lpp-uper: (%zd bytes) tag=%llX", size, tag);
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_LPP_UPER, data, size);
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_LPP_UPER, data, size);
     }
 }
@@ -29,29 +29,30 @@ void Lpp2FrameRtcm::inspect(streamline::System&, DataType const& message, uint64
         DEBUGF("message: %4u: %zu bytes", submessage.id(), sub_size);
 
         // TODO(ewasjon): These message should be passed back into the system
-        for (auto const& output : mOutput.outputs) {
-            auto output_lfr    = output.lfr_support();
-            auto output_rtcm   = mConfig.output_in_rtcm && output.rtcm_support();
-            auto should_output = output_rtcm || output_lfr;
-            if (!should_output) continue;
-
-            if (!output.accept_tag(tag)) {
-                XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s",
-                          output.tag_name(tag).c_str(), output.reject_reason(tag).c_str());
-                continue;
-            }
+        for (auto output : mOutput.route(OUTPUT_FORMAT_LFR, tag)) {
+            XDEBUGF(OUTPUT_PRINT_MODULE, "lfr : %04d (%zd bytes) tag=%llX", submessage.id(),
+                    sub_size, tag);
+            ASSERT(output->stage, "stage is null");
+            output->stage->write(OUTPUT_FORMAT_RTCM, sub_buffer, sub_size);
+        }
 
-            if (output_lfr) {
-                XDEBUGF(OUTPUT_PRINT_MODULE, "lfr : %04d (%zd bytes) tag=%llX", submessage.id(),
-                        sub_size, tag);
-            }
-            if (output_rtcm) {
+        if (mConfig.output_in_rtcm) {
+            for (auto output : mOutput.route(OUTPUT_FORMAT_RTCM, tag)) {
+                if (output->lfr_support()) continue;  // already written as lfr
                 XDEBUGF(OUTPUT_PRINT_MODULE, "rtcm: %04d (%zd bytes) tag=%llX", submessage.id(),
                         sub_size, tag);
+                ASSERT(output->stage, "stage is null");
+                output->stage->write(OUTPUT_FORMAT_RTCM, sub_buffer, sub_size);
             }
+        }
+    }
 
-            ASSERT(output.stage, "stage is null");
-            output.stage->write(OUTPUT_FORMAT_RTCM, sub_buffer, sub_size);
+    for (auto output : mOutput.route(OUTPUT_FORMAT_LFR, tag)) {
+        output->stage->end_epoch();
+    }
+    if (mConfig.output_in_rtcm) {
+        for (auto output : mOutput.route(OUTPUT_FORMAT_RTCM, tag)) {
+            output->stage->end_epoch();
         }
     }
 }
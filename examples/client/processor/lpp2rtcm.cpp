@@ -11,7 +11,7 @@ LOGLET_MODULE2(p, l2r);
 Lpp2Rtcm::Lpp2Rtcm(ProgramOutput const& output, Lpp2RtcmConfig const& config,
                    scheduler::Scheduler& scheduler)
     : mOutput(output), mConfig(config), mScheduler(scheduler), mConversionCount(0),
-      mOutputTag(tags::get(config.output_tag).value) {
+      mOutputTag(tags::id(tags::get(config.output_tag))) {
     VSCOPE_FUNCTION();
     mGenerator = std::unique_ptr<generator::rtcm::Generator>(new generator::rtcm::Generator{});
     mFilter    = generator::rtcm::MessageFilter{};
@@ -46,22 +46,19 @@ void Lpp2Rtcm::inspect(streamline::System&, DataType const& message, uint64_t /*
         DEBUGF("message: %4u: %zu bytes", submessage.id(), size);
 
         // TODO(ewasjon): These message should be passed back into the system
-        for (auto const& output : mOutput.outputs) {
-            if (!output.rtcm_support()) continue;
-            if (!output.accept_tag(mOutputTag)) {
-                XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s",
-                          output.tag_name(mOutputTag).c_str(),
-                          output.reject_reason(mOutputTag).c_str());
-                continue;
-            }
+        for (auto output : mOutput.route(OUTPUT_FORMAT_RTCM, mOutputTag)) {
             XDEBUGF(OUTPUT_PRINT_MODULE, "rtcm: %04d (%zd bytes) tag=%llX", submessage.id(), size,
                     mOutputTag);
 
-            ASSERT(output.stage, "stage is null");
-            output.stage->write(OUTPUT_FORMAT_RTCM, buffer, size);
+            ASSERT(output->stage, "stage is null");
+            output->stage->write(OUTPUT_FORMAT_RTCM, buffer, size);
         }
     }
 
+    for (auto output : mOutput.route(OUTPUT_FORMAT_RTCM, mOutputTag)) {
+        output->stage->end_epoch();
+    }
+
     if (mConfig.max_conversions > 0) {
         mConversionCount++;
         if (mConversionCount >= mConfig.max_conversions) {
@@ -3,13 +3,29 @@
 
 #include <loglet/loglet.hpp>
 
+#include <algorithm>
+
 LOGLET_MODULE2(p, l2s);
 #undef LOGLET_CURRENT_MODULE
 #define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(p, l2s)
 
 Lpp2Spartn::Lpp2Spartn(ProgramOutput const& output, Lpp2SpartnConfig const& config)
-    : mOutput(output), mConfig(config), mOutputTag(tags::get(config.output_tag).value) {
+    : mOutput(output), mConfig(config), mOutputTag(tags::id(tags::get(config.output_tag))),
+      mSharedTag(mOutputTag), mBatchSize(config.tile_batch) {
     VSCOPE_FUNCTION();
+    auto shared = tags::get(config.output_tag);
+    for (auto const& kvp : mConfig.tile_tags) {
+        auto tag             = tags::get(kvp.second);
+        mTileTags[kvp.first] = tags::id(tag);
+        shared |= tag;
+    }
+    mSharedTag = tags::id(shared);
+
+    // A feed with a tile per message sends one message per tile and epoch
+    if (mBatchSize == 0) mBatchSize = std::max<size_t>(mTileTags.size(), 1);
+    mBatch.reserve(mBatchSize);
+    mBatchMessages.reserve(mBatchSize);
+
     mGenerator = std::unique_ptr<generator::spartn::Generator>(new generator::spartn::Generator{});
 
     mGenerator->set_ura_override(mConfig.sf024_override);
@@ -64,15 +80,47 @@ Lpp2Spartn::Lpp2Spartn(ProgramOutput const& output, Lpp2SpartnConfig const& conf
     mGenerator->set_generate_gad(mConfig.generate_gad);
     mGenerator->set_generate_ocb(mConfig.generate_ocb);
     mGenerator->set_generate_hpac(mConfig.generate_hpac);
+    mGenerator->set_hpac_threads(mConfig.hpac_threads);
 }
 
 Lpp2Spartn::~Lpp2Spartn() {
     VSCOPE_FUNCTION();
 }
 
-void Lpp2Spartn::inspect(streamline::System&, DataType const& message, uint64_t /*tag*/) {
+uint64_t Lpp2Spartn::output_tag(generator::spartn::Message const& message) const {
+    if (mTileTags.empty()) return mOutputTag;
+    // OCB messages are needed by every tile
+    if (!message.has_set_id()) return mSharedTag;
+
+    auto it = mTileTags.find(message.set_id());
+    if (it == mTileTags.end()) return mOutputTag;
+    return it->second;
+}
+
+void Lpp2Spartn::consume(streamline::System&, DataType&& message, uint64_t /*tag*/) {
     VSCOPE_FUNCTION();
-    auto messages = mGenerator->generate(message.get());
+    if (!lpp::is_provide_assistance_data(message)) return;
+
+    mBatch.push_back(std::move(message));
+    if (mBatch.size() < mBatchSize) {
+        VERBOSEF("batch: %zu/%zu messages", mBatch.size(), mBatchSize);
+        return;
+    }
+
+    generate();
+}
+
+void Lpp2Spartn::generate() {
+    VSCOPE_FUNCTIONF("%zu", mBatch.size());
+    mBatchMessages.clear();
+    for (auto const& message : mBatch) {
+        mBatchMessages.push_back(message.get());
+    }
+
+    auto messages = mGenerator->generate(mBatchMessages.data(), mBatchMessages.size());
+    mBatchMessages.clear();
+    mBatch.clear();
+
     if (messages.empty()) {
         WARNF("no SPARTN messages generated, check that you're using `--ad-type ssr`");
     } else {
@@ -87,21 +135,24 @@ void Lpp2Spartn::inspect(streamline::System&, DataType const& message, uint64_t
                    data.size());
 
             // TODO(ewasjon): These message should be passed back into the system
-            for (auto const& output : mOutput.outputs) {
-                if (!output.spartn_support()) continue;
-                if (!output.accept_tag(mOutputTag)) {
-                    XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s",
-                              output.tag_name(mOutputTag).c_str(),
-                              output.reject_reason(mOutputTag).c_str());
-                    continue;
-                }
+            auto tag = output_tag(msg);
+            for (auto output : mOutput.route(OUTPUT_FORMAT_SPARTN, tag)) {
                 XDEBUGF(OUTPUT_PRINT_MODULE, "spartn: %02X-%02X (%zd bytes) tag=%llX",
-                        msg.message_type(), msg.message_subtype(), data.size(), mOutputTag);
+                        msg.message_type(), msg.message_subtype(), data.size(), tag);
 
-                ASSERT(output.stage, "stage is null");
-                output.stage->write(OUTPUT_FORMAT_SPARTN, data.data(), data.size());
+                ASSERT(output->stage, "stage is null");
+                output->stage->write(OUTPUT_FORMAT_SPARTN, data.data(), data.size());
+                if (std::find(mEpochOutputs.begin(), mEpochOutputs.end(), output) ==
+                    mEpochOutputs.end())
+                    mEpochOutputs.push_back(output);
             }
         }
+
+        // Messages are routed by tile, mark the end of the epoch on every output that got one
+        for (auto output : mEpochOutputs) {
+            output->stage->end_epoch();
+        }
+        mEpochOutputs.clear();
     }
 }
 
@@ -10,20 +10,43 @@
 #include "config.hpp"
 #include "lpp.hpp"
 
-class Lpp2Spartn : public streamline::Inspector<lpp::Message> {
+#include <streamline/consumer.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+/// Consumes the LPP messages, instead of inspecting them, so that the assistance data of an epoch
+/// can be kept until the batch of `tile_batch` messages is complete. There must be no other
+/// consumer of `lpp::Message`, as they cannot be cloned.
+class Lpp2Spartn : public streamline::Consumer<lpp::Message> {
 public:
     Lpp2Spartn(ProgramOutput const& output, Lpp2SpartnConfig const& config);
     ~Lpp2Spartn() override;
 
     NODISCARD char const* name() const NOEXCEPT override { return "Lpp2Spartn"; }
-    void inspect(streamline::System&, DataType const& message, uint64_t tag) override;
+    void consume(streamline::System&, DataType&& message, uint64_t tag) override;
 
     NODISCARD generator::spartn::Generator const* generator() const { return mGenerator.get(); }
 
 private:
+    NODISCARD uint64_t output_tag(generator::spartn::Message const& message) const;
+    void               generate();
+
     std::unique_ptr<generator::spartn::Generator> mGenerator;
 
     ProgramOutput const&    mOutput;
     Lpp2SpartnConfig const& mConfig;
     uint64_t                mOutputTag;
+
+    // Tiles: correction point set id -> tag id, OCB messages are routed with all of them
+    std::unordered_map<uint16_t, uint64_t> mTileTags;
+    uint64_t                               mSharedTag;
+
+    // Assistance data messages of the current epoch, generated from once `mBatchSize` arrived
+    std::vector<lpp::Message>       mBatch;
+    std::vector<LPP_Message const*> mBatchMessages;
+    size_t                          mBatchSize;
+
+    // Outputs written to during the current epoch
+    std::vector<OutputInterface const*> mEpochOutputs;
 };
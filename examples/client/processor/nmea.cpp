@@ -28,18 +28,12 @@ void NmeaOutput::inspect(streamline::System&, DataType const& message, uint64_t
     auto sentence = message->sentence();
     auto data     = reinterpret_cast<uint8_t const*>(sentence.data());
     auto size     = sentence.size();
-    for (auto const& output : mOutput.outputs) {
-        if (!output.nmea_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s", output.tag_name(tag).c_str(),
-                      output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_NMEA, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "nmea: %s (%zd bytes) tag=%llX", message->prefix().c_str(),
                 size, tag);
 
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_NMEA, data, size);
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_NMEA, data, size);
     }
 }
 
@@ -88,17 +88,11 @@ void PossibOutput::inspect(streamline::System&, DataType const& message, uint64_
     auto sentence = message->json();
     auto data     = reinterpret_cast<uint8_t const*>(sentence.data());
     auto size     = sentence.size();
-    for (auto const& output : mOutput.outputs) {
-        if (!output.possib_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s", output.tag_name(tag).c_str(),
-                      output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_POSSIB, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "possib: (%zd bytes) tag=%llX", size, tag);
 
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_POSSIB, data, size);
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_POSSIB, data, size);
     }
 }
 
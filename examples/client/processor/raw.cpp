@@ -7,16 +7,10 @@ LOGLET_MODULE2(p, raw);
 #define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF2(p, raw)
 
 void RawOutput::inspect(streamline::System&, DataType const& message, uint64_t tag) NOEXCEPT {
-    for (auto& output : mOutput.outputs) {
-        if (!output.raw_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s", output.tag_name(tag).c_str(),
-                      output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_RAW, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "raw: %zd bytes tag=%llX", message.data.size(), tag);
 
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_RAW, message.data.data(), message.data.size());
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_RAW, message.data.data(), message.data.size());
     }
 }
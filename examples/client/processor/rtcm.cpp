@@ -25,16 +25,10 @@ void RtcmOutput::inspect(streamline::System&, DataType const& message, uint64_t
     VSCOPE_FUNCTION();
     auto& data = message->data();
     auto  size = data.size();
-    for (auto& output : mOutput.outputs) {
-        if (!output.rtcm_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s", output.tag_name(tag).c_str(),
-                      output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_RTCM, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "rtcm: %04d (%zd bytes) tag=%llX", message->type(), size, tag);
 
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_RTCM, data.data(), size);
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_RTCM, data.data(), size);
     }
 }
@@ -24,17 +24,11 @@ void test_outputer(scheduler::Scheduler& scheduler, ProgramOutput const& output,
         uint8_t data[16 + 1] = "TESTTESTTESTTEST";
         DEBUGF("test: \"%s\"", data);
 
-        for (auto& out : output.outputs) {
-            if (!out.test_support()) continue;
-            if (!out.accept_tag(tag)) {
-                XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s", out.tag_name(tag).c_str(),
-                            out.reject_reason(tag).c_str());
-                continue;
-            }
+        for (auto out : output.route(OUTPUT_FORMAT_TEST, tag)) {
             XDEBUGF(OUTPUT_PRINT_MODULE, "test: (%zd bytes) tag=%llX", sizeof(data), tag);
 
-            ASSERT(out.stage, "stage is null");
-            out.stage->write(OUTPUT_FORMAT_TEST, data, sizeof(data));
+            ASSERT(out->stage, "stage is null");
+            out->stage->write(OUTPUT_FORMAT_TEST, data, sizeof(data));
         }
     };
 
@@ -11,6 +11,7 @@
 #ifdef INCLUDE_FORMAT_ANTEX
 #include <format/antex/antex.hpp>
 #endif
+#include <format/helper/snapshot.hpp>
 #include <format/rinex/nav_reader.hpp>
 #include <format/rtcm/datafields.hpp>
 #include <generator/rtcm/generator.hpp>
@@ -322,7 +323,7 @@ Tokoro::Tokoro(ProgramOutput const& output, TokoroConfig const& config,
     mGenerator = std::unique_ptr<generator::tokoro::Generator>(new generator::tokoro::Generator{});
     mReferenceStation = nullptr;
     mPeriodicTask     = nullptr;
-    mOutputTag        = tags::get(mConfig.output_tag).value;
+    mOutputTag        = tags::id(tags::get(mConfig.output_tag));
 
     mGenerator->set_iod_consistency_check(mConfig.iod_consistency_check);
     mGenerator->set_rtoc(mConfig.rtoc);
@@ -340,7 +341,12 @@ Tokoro::Tokoro(ProgramOutput const& output, TokoroConfig const& config,
 
 #ifdef INCLUDE_FORMAT_ANTEX
     if (!config.antex_file.empty()) {
-        auto result = format::antex::Antex::from_file(config.antex_file);
+        auto result =
+            config.file_cache_dir.empty() ?
+                format::antex::Antex::from_file(config.antex_file) :
+                format::antex::Antex::from_file_cached(
+                    config.antex_file,
+                    format::helper::snapshot_path(config.file_cache_dir, config.antex_file));
         if (!result) {
             WARNF("failed to load antex file: \"%s\"", config.antex_file.c_str());
         } else {
@@ -351,7 +357,11 @@ Tokoro::Tokoro(ProgramOutput const& output, TokoroConfig const& config,
 
     if (!config.nav_files.empty()) {
         for (auto const& nav_file : config.nav_files) {
-            auto nav = format::rinex::parse_nav_file(nav_file);
+            auto nav = config.file_cache_dir.empty() ?
+                           format::rinex::parse_nav_file(nav_file) :
+                           format::rinex::parse_nav_file_cached(
+                               nav_file,
+                               format::helper::snapshot_path(config.file_cache_dir, nav_file));
             for (auto& eph : nav.gps)
                 mGenerator->process_ephemeris(eph);
             for (auto& eph : nav.gal)
@@ -658,21 +668,18 @@ void Tokoro::generate(ts::Tai const& generation_time) {
         DEBUGF("message: %4u: %zu bytes", submessage.id(), size);
 
         // TODO(ewasjon): These message should be passed back into the system
-        for (auto const& output : mOutput.outputs) {
-            if (!output.rtcm_support()) continue;
-            if (!output.accept_tag(mOutputTag)) {
-                XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s",
-                          output.tag_name(mOutputTag).c_str(),
-                          output.reject_reason(mOutputTag).c_str());
-                continue;
-            }
+        for (auto output : mOutput.route(OUTPUT_FORMAT_RTCM, mOutputTag)) {
             XDEBUGF(OUTPUT_PRINT_MODULE, "rtcm: %04d (%zd bytes) tag=%llX", submessage.id(), size,
                     mOutputTag);
 
-            ASSERT(output.stage, "stage is null");
-            output.stage->write(OUTPUT_FORMAT_RTCM, buffer, size);
+            ASSERT(output->stage, "stage is null");
+            output->stage->write(OUTPUT_FORMAT_RTCM, buffer, size);
         }
     }
+
+    for (auto output : mOutput.route(OUTPUT_FORMAT_RTCM, mOutputTag)) {
+        output->stage->end_epoch();
+    }
 }
 
 void Tokoro::inspect(streamline::System& system, DataType const& message, uint64_t) {
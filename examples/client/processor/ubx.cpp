@@ -23,18 +23,12 @@ void UbxPrint::inspect(streamline::System&, DataType const& message, uint64_t ta
 void UbxOutput::inspect(streamline::System&, DataType const& message, uint64_t tag) NOEXCEPT {
     VSCOPE_FUNCTION();
     auto& data = message->data();
-    for (auto& output : mOutput.outputs) {
-        if (!output.ubx_support()) continue;
-        if (!output.accept_tag(tag)) {
-            XVERBOSEF(OUTPUT_PRINT_MODULE, "tag %s not accepted: %s", output.tag_name(tag).c_str(),
-                      output.reject_reason(tag).c_str());
-            continue;
-        }
+    for (auto output : mOutput.route(OUTPUT_FORMAT_UBX, tag)) {
         XDEBUGF(OUTPUT_PRINT_MODULE, "ubx: %02X-%02X (%zd bytes) tag=%llX",
                 message->message_class(), message->message_id(), data.size(), tag);
 
-        ASSERT(output.stage, "stage is null");
-        output.stage->write(OUTPUT_FORMAT_UBX, data.data(), data.size());
+        ASSERT(output->stage, "stage is null");
+        output->stage->write(OUTPUT_FORMAT_UBX, data.data(), data.size());
     }
 }
 
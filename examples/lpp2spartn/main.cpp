@@ -11,6 +11,8 @@
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
+#include <map>
+#include <string>
 #include <vector>
 
 LOGLET_MODULE(main);
@@ -95,6 +97,21 @@ int main(int argc, char** argv) {
         "Set SF013 DNU for STEC when iono quality (meters) exceeds this value (e.g. 1.0)",
         {"iono-quality-threshold"});
 
+    args::Group             tile_group(parser, "Tiles:");
+    args::ValueFlag<size_t> tile_batch(
+        tile_group, "count",
+        "Generate from batches of LPP messages, e.g. one epoch of a feed with a correction "
+        "point set (tile) per message. OCB messages are encoded once per batch",
+        {"tile-batch"});
+    args::ValueFlag<size_t> hpac_threads(tile_group, "threads",
+                                         "Encode HPAC messages of different tiles in parallel",
+                                         {"hpac-threads"});
+    args::ValueFlag<std::string> tile_output(
+        tile_group, "path",
+        "Write each tile to its own file, `{set}` is replaced by the correction point set id. "
+        "OCB messages are written to all tiles",
+        {"tile-output"});
+
     args::Group                  transport_group(parser, "Transport:");
     args::ValueFlag<std::string> crc_type(transport_group, "crc8|crc16|crc24q",
                                           "CRC type (default: crc16)", {"crc-type"});
@@ -175,6 +192,7 @@ int main(int argc, char** argv) {
     gen.set_do_not_use_atmosphere(!no_dnu);
     if (iono_quality_threshold) gen.set_iono_quality_threshold(args::get(iono_quality_threshold));
     gen.set_continuity_indicator(320.0);
+    if (hpac_threads) gen.set_hpac_threads(args::get(hpac_threads));
 
     {
         struct GnssEntry {
@@ -295,6 +313,18 @@ int main(int argc, char** argv) {
         gen.enable_epoch_log(true);
     }
 
+    // Per-tile outputs, `{set}` in the path is replaced by the correction point set id
+    std::map<uint16_t, FILE*> tile_outputs;
+
+    auto open_tile = [&](uint16_t set_id) -> FILE* {
+        auto path = args::get(tile_output);
+        auto pos  = path.find("{set}");
+        if (pos != std::string::npos) path.replace(pos, 5, std::to_string(set_id));
+        auto file = fopen(path.c_str(), "wb");
+        if (!file) fprintf(stderr, "error: cannot open tile output file: %s\n", path.c_str());
+        return file;
+    };
+
     // Process messages
     size_t offset       = 0;
     size_t msg_count    = 0;
@@ -302,6 +332,9 @@ int main(int argc, char** argv) {
     size_t total_size   = data.size();
     size_t msg_limit    = limit ? args::get(limit) : SIZE_MAX;
     int    last_pct     = -1;
+    size_t batch_size   = tile_batch ? args::get(tile_batch) : 1;
+
+    std::vector<LPP_Message*> batch;
 
     auto start_time  = std::chrono::steady_clock::now();
     auto last_update = start_time;
@@ -332,12 +365,22 @@ int main(int argc, char** argv) {
                 offset += consumed;
                 continue;
             }
-            break;
+            // Nothing more can be decoded, generate from the messages already in the batch
+            if (batch.empty()) break;
+            offset = data.size();
+        } else {
+            msg_count++;
+            offset += consumed;
+            batch.push_back(lpp);
         }
 
-        msg_count++;
-        auto messages = gen.generate(lpp);
-        ASN_STRUCT_FREE(asn_DEF_LPP_Message, lpp);
+        if (batch.size() < batch_size && offset < data.size() && msg_count < msg_limit) continue;
+
+        auto messages = gen.generate(batch.data(), batch.size());
+        for (auto message : batch) {
+            ASN_STRUCT_FREE(asn_DEF_LPP_Message, message);
+        }
+        batch.clear();
 
         // Write DNU log entry
         if (dnu_out) {
@@ -430,9 +473,21 @@ int main(int argc, char** argv) {
             } else {
                 fwrite(bytes.data(), 1, bytes.size(), out);
             }
-        }
 
-        offset += consumed;
+            // OCB messages are shared by all tiles, GAD and HPAC only go to their own tile
+            if (tile_output) {
+                if (msg.has_set_id()) {
+                    auto it = tile_outputs.find(msg.set_id());
+                    if (it == tile_outputs.end())
+                        it = tile_outputs.emplace(msg.set_id(), open_tile(msg.set_id())).first;
+                    if (it->second) fwrite(bytes.data(), 1, bytes.size(), it->second);
+                } else {
+                    for (auto& kvp : tile_outputs) {
+                        if (kvp.second) fwrite(bytes.data(), 1, bytes.size(), kvp.second);
+                    }
+                }
+            }
+        }
     }
 
     fprintf(stderr, "\rProcessing: 100%%                                        \n");
@@ -443,6 +498,9 @@ int main(int argc, char** argv) {
     if (dnu_out) {
         fclose(dnu_out);
     }
+    for (auto& kvp : tile_outputs) {
+        if (kvp.second) fclose(kvp.second);
+    }
 
     fprintf(stderr, "Processed %zu LPP messages, generated %zu SPARTN messages\n", msg_count,
             spartn_count);
@@ -457,6 +515,13 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (stats.cached_messages > 0) {
+        fprintf(stderr, "  reused unchanged payloads: %zu\n", stats.cached_messages);
+    }
+    if (!tile_outputs.empty()) {
+        fprintf(stderr, "  tiles: %zu\n", tile_outputs.size());
+    }
+
     if (!stats.lpp_ie_counts.empty()) {
         fprintf(stderr, "\nLPP IE counts:\n");
         for (auto const& entry : stats.lpp_ie_counts) {
@@ -0,0 +1,341 @@
+#include <format/tbin/reader.hpp>
+#include <loglet/loglet.hpp>
+#include <lpp/client_host.hpp>
+#include <lpp/mock_server.hpp>
+#include <scheduler/scheduler.hpp>
+#include <supl/tls.hpp>
+
+#include <external_warnings.hpp>
+EXTERNAL_WARNINGS_PUSH
+#include <args.hxx>
+EXTERNAL_WARNINGS_POP
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+LOGLET_MODULE(mock_slp);
+#define LOGLET_CURRENT_MODULE &LOGLET_MODULE_REF(mock_slp)
+
+using Clock = std::chrono::steady_clock;
+
+// Decode latency in power-of-two microsecond buckets, the last bucket holds everything above.
+static constexpr size_t HISTOGRAM_BUCKETS = 24;
+
+struct ServerOptions {
+    std::string               address;
+    uint16_t                  port;
+    std::chrono::milliseconds period;
+    size_t                    message_size;
+    std::vector<std::string>  tbin_paths;
+    std::string               tls_cert;
+    std::string               tls_key;
+};
+
+struct LoadOptions {
+    std::string host;
+    uint16_t    port;
+    uint32_t    sessions;
+    double      duration;
+    bool        tls;
+    bool        local;
+};
+
+struct LoadSession {
+    Clock::time_point added;
+    Clock::time_point connected;
+    bool              is_connected;
+};
+
+static double cpu_seconds() {
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+}
+
+static double seconds(Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+
+static std::vector<std::vector<uint8_t>> load_messages(std::vector<std::string> const& paths) {
+    std::vector<std::vector<uint8_t>> messages;
+    for (auto& path : paths) {
+        format::tbin::Reader reader;
+        if (!reader.open(path)) {
+            WARNF("failed to open \"%s\"", path.c_str());
+            continue;
+        }
+
+        if (reader.stream_id() != "lpp-uper") {
+            WARNF("\"%s\": stream \"%s\" is not lpp-uper", path.c_str(),
+                  reader.stream_id().c_str());
+        }
+
+        format::tbin::Message message{};
+        while (reader.next(message)) {
+            messages.push_back(std::move(message.data));
+        }
+    }
+    return messages;
+}
+
+static std::unique_ptr<lpp::MockLocationServer> create_server(ServerOptions const& options) {
+    std::unique_ptr<lpp::MockLocationServer> server{
+        new lpp::MockLocationServer(options.address, options.port)};
+    server->set_period(options.period);
+
+    if (!options.tbin_paths.empty()) {
+        auto messages = load_messages(options.tbin_paths);
+        auto kept     = server->set_messages(messages);
+        INFOF("replaying %zu of %zu messages", kept, messages.size());
+    }
+
+    if (options.message_size > 0) {
+        server->set_message_size(options.message_size);
+    }
+
+    if (!options.tls_cert.empty() || !options.tls_key.empty()) {
+        supl::TlsConfig tls{};
+        tls.enabled          = true;
+        tls.server           = true;
+        tls.client_cert_path = options.tls_cert;
+        tls.client_key_path  = options.tls_key;
+        server->set_tls(tls);
+    }
+
+    return server;
+}
+
+static void print_server_stats(lpp::MockLocationServer const& server) {
+    auto& stats = server.stats();
+    printf("server: %zu connections, %lu accepted, %lu closed, %lu established, %lu messages, "
+           "%lu bytes\n",
+           server.connections(), stats.accepted, stats.closed, stats.established,
+           stats.messages_sent, stats.bytes_sent);
+}
+
+static int serve(ServerOptions const& options) {
+    scheduler::ScopedScheduler scheduler;
+
+    auto server = create_server(options);
+    if (!server->schedule(scheduler)) {
+        ERRORF("failed to listen on %s:%u", options.address.c_str(), options.port);
+        return 1;
+    }
+
+    INFOF("listening on %s:%u", options.address.c_str(), server->port());
+
+    auto next_report = Clock::now() + std::chrono::seconds(10);
+    for (;;) {
+        scheduler.execute_timeout(std::chrono::seconds(1));
+        if (Clock::now() >= next_report) {
+            print_server_stats(*server);
+            next_report += std::chrono::seconds(10);
+        }
+    }
+}
+
+static lpp::PeriodicRequestAssistanceData load_request() {
+    lpp::PeriodicRequestAssistanceData request{};
+    request.type                    = lpp::PeriodicRequestAssistanceData::Type::OSR;
+    request.gnss.gps                = true;
+    request.gnss.glonass            = true;
+    request.gnss.galileo            = true;
+    request.gnss.beidou             = true;
+    request.config.delivery_amount  = 32;
+    request.config.osr_observations = 1;
+    request.config.osr_residuals    = 1;
+    return request;
+}
+
+static int load(LoadOptions const& options, ServerOptions const& server_options) {
+    scheduler::ScopedScheduler scheduler;
+
+    std::unique_ptr<lpp::MockLocationServer> server;
+    auto                                     port = options.port;
+    if (options.local) {
+        server = create_server(server_options);
+        if (!server->schedule(scheduler)) {
+            ERRORF("failed to listen on %s:%u", server_options.address.c_str(),
+                   server_options.port);
+            return 1;
+        }
+        port = server->port();
+    }
+
+    lpp::ClientHost host{options.host, port, load_request()};
+    if (options.tls) {
+        supl::TlsConfig tls{};
+        tls.enabled     = true;
+        tls.skip_verify = true;
+        host.set_tls(tls);
+    }
+
+    std::vector<LoadSession> sessions(options.sessions);
+    Clock::time_point        all_connected{};
+    size_t                   connected_count = 0;
+    uint64_t                 messages        = 0;
+    uint64_t                 bytes           = 0;
+    uint64_t                 histogram[HISTOGRAM_BUCKETS]{};
+
+    host.on_connected = [&](lpp::ClientHost::SessionId id) {
+        auto& session = sessions[id];
+        if (session.is_connected) return;
+        session.connected    = Clock::now();
+        session.is_connected = true;
+        if (++connected_count == sessions.size()) all_connected = session.connected;
+    };
+    host.on_decoded = [&](lpp::ClientHost::SessionId, size_t size, Clock::duration duration) {
+        auto   us     = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        size_t bucket = 0;
+        while (bucket + 1 < HISTOGRAM_BUCKETS && (1ll << bucket) <= us)
+            bucket++;
+        histogram[bucket]++;
+        messages++;
+        bytes += size;
+    };
+
+    host.schedule(&scheduler);
+
+    auto cpu_begin = cpu_seconds();
+    auto begin     = Clock::now();
+    for (uint32_t i = 0; i < options.sessions; i++) {
+        sessions[i].added = Clock::now();
+        host.add_session(supl::Identity::msisdn(919825098250ull + i),
+                         supl::Cell::lte(240, 1, 1, 3 + i));
+    }
+
+    auto end = begin + std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<double>(options.duration));
+    while (Clock::now() < end) {
+        scheduler.execute_timeout(std::chrono::milliseconds(100));
+    }
+
+    auto elapsed = seconds(Clock::now() - begin);
+    auto cpu     = cpu_seconds() - cpu_begin;
+
+    std::vector<double> setup;
+    for (auto& session : sessions) {
+        if (session.is_connected) setup.push_back(seconds(session.connected - session.added));
+    }
+
+    printf("sessions:     %zu/%u connected\n", connected_count, options.sessions);
+    if (connected_count == sessions.size() && connected_count > 0) {
+        printf("setup rate:   %.1f sessions/s\n",
+               static_cast<double>(connected_count) / seconds(all_connected - begin));
+    }
+    printf("setup time:   p50 %.2f ms, p99 %.2f ms\n", percentile(setup, 0.50) * 1e3,
+           percentile(setup, 0.99) * 1e3);
+    printf("messages:     %lu (%.1f/s, %.1f KiB/s)\n", messages,
+           static_cast<double>(messages) / elapsed,
+           static_cast<double>(bytes) / elapsed / 1024.0);
+    printf("cpu:          %.3f s (%.2f ms/session, %.1f us/message)%s\n", cpu,
+           connected_count > 0 ? cpu * 1e3 / static_cast<double>(connected_count) : 0.0,
+           messages > 0 ? cpu * 1e6 / static_cast<double>(messages) : 0.0,
+           options.local ? ", including the server" : "");
+    printf("decode latency:\n");
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        if (histogram[i] == 0) continue;
+        auto percent = 100.0 * static_cast<double>(histogram[i]) / static_cast<double>(messages);
+        if (i == 0) {
+            printf("  <1 us:      %8lu %5.1f%%\n", histogram[i], percent);
+        } else if (i + 1 == HISTOGRAM_BUCKETS) {
+            printf("  >=%-8llu  %8lu %5.1f%%\n", 1ull << (i - 1), histogram[i], percent);
+        } else {
+            printf("  <%-8llu us %8lu %5.1f%%\n", 1ull << i, histogram[i], percent);
+        }
+    }
+
+    if (server) print_server_stats(*server);
+
+    host.cancel();
+    if (server) server->cancel();
+    return connected_count == sessions.size() ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    loglet::initialize();
+    loglet::set_level(loglet::Level::Info);
+
+    args::ArgumentParser parser{
+        "example-mock-slp — local SUPL/LPP location server that replays recorded assistance "
+        "data, and a load generator for it"};
+    args::HelpFlag help{parser, "help", "Display this help menu", {'?', "help"}};
+
+    args::Group server_group{parser, "Server:"};
+    args::ValueFlag<std::string> address{
+        server_group, "address", "Listen address", {"address"}, "127.0.0.1"};
+    args::ValueFlag<uint16_t> port{server_group, "port", "Listen or connect port", {'p', "port"},
+                                   5431};
+    args::ValueFlag<int> period_ms{
+        server_group, "ms", "Period between assistance data messages", {"period-ms"}, 1000};
+    args::ValueFlag<size_t> message_size{
+        server_group, "bytes", "Pad messages to about this size", {"size"}, 0};
+    args::ValueFlagList<std::string> tbin{
+        server_group, "file", "lpp-uper .tbin capture to replay", {"tbin"}};
+    args::ValueFlag<std::string> tls_cert{
+        server_group, "file", "Accept TLS with this certificate", {"tls-cert"}};
+    args::ValueFlag<std::string> tls_key{
+        server_group, "file", "Private key of the TLS certificate", {"tls-key"}};
+
+    args::Group               load_group{parser, "Load generator:"};
+    args::ValueFlag<uint32_t> sessions{
+        load_group, "count", "Run a load test with this many sessions", {"load"}};
+    args::ValueFlag<std::string> host{
+        load_group, "host", "Location server to connect to", {"host"}, "127.0.0.1"};
+    args::ValueFlag<double> duration{
+        load_group, "seconds", "Duration of the load test", {"duration"}, 10.0};
+    args::Flag tls{load_group, "tls", "Connect with TLS, without verification", {"tls"}};
+    args::Flag local{
+        load_group, "local", "Run the server in-process instead of connecting to --host",
+        {"local"}};
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (args::Help const&) {
+        printf("%s", parser.Help().c_str());
+        return 0;
+    } catch (args::ParseError const& e) {
+        fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+
+    ServerOptions server_options{};
+    server_options.address      = args::get(address);
+    server_options.port         = args::get(port);
+    server_options.period       = std::chrono::milliseconds(args::get(period_ms));
+    server_options.message_size = args::get(message_size);
+    server_options.tbin_paths   = args::get(tbin);
+    server_options.tls_cert     = args::get(tls_cert);
+    server_options.tls_key      = args::get(tls_key);
+
+    if (!sessions) {
+        return serve(server_options);
+    }
+
+    LoadOptions load_options{};
+    load_options.host     = args::get(host);
+    load_options.port     = args::get(port);
+    load_options.sessions = args::get(sessions);
+    load_options.duration = args::get(duration);
+    load_options.tls      = tls;
+    load_options.local    = local;
+
+    // The in-process server listens on an ephemeral port so it does not collide with a running one
+    if (load_options.local) server_options.port = 0;
+
+    return load(load_options, server_options);
+}
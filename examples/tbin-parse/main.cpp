@@ -19,6 +19,9 @@ EXTERNAL_WARNINGS_POP
 #include <string>
 #include <vector>
 
+// Version of the written files, --v2 selects block compressed output
+static uint8_t gTbinVersion = format::tbin::VERSION_1;
+
 static int64_t utc_to_us(int year, int month, int day, int hour, int min, int sec, int nano) {
     struct tm t{};
     t.tm_year  = year - 1900;
@@ -161,7 +164,7 @@ static void parse_ubx(std::string const& input, std::string const& output) {
     fclose(f);
 
     format::tbin::Writer writer;
-    if (!writer.open(output, "ubx")) {
+    if (!writer.open(output, "ubx", gTbinVersion)) {
         fprintf(stderr, "error: cannot open output %s\n", output.c_str());
         return;
     }
@@ -223,7 +226,7 @@ static void parse_rtcm(std::string const& input, std::string const& output, int
     fclose(f);
 
     format::tbin::Writer writer;
-    if (!writer.open(output, "rtcm")) {
+    if (!writer.open(output, "rtcm", gTbinVersion)) {
         fprintf(stderr, "error: cannot open output %s\n", output.c_str());
         return;
     }
@@ -283,7 +286,7 @@ static void parse_lpp_uper(std::string const& input, std::string const& output,
     fseek(f, 0, SEEK_SET);
 
     format::tbin::Writer writer;
-    if (!writer.open(output, "lpp-uper")) {
+    if (!writer.open(output, "lpp-uper", gTbinVersion)) {
         fprintf(stderr, "error: cannot open output %s\n", output.c_str());
         fclose(f);
         return;
@@ -362,7 +365,7 @@ static void parse_rinex_nav(std::string const& input, std::string const& output)
     }
 
     format::tbin::Writer writer;
-    if (!writer.open(output, "nav")) {
+    if (!writer.open(output, "nav", gTbinVersion)) {
         fprintf(stderr, "error: cannot open output %s\n", output.c_str());
         fclose(f);
         return;
@@ -428,7 +431,8 @@ static void print_usage() {
             "Options:\n"
             "  --gps-week <week>                    GPS week for RTCM timestamp resolution\n"
             "  --start-time <ISO8601>               Start time for formats without timestamps\n"
-            "  --interval <ms>                      Interval between messages (default: 1000)\n");
+            "  --interval <ms>                      Interval between messages (default: 1000)\n"
+            "  --v2                                 Write block compressed TBIN v2\n");
 }
 
 int main(int argc, char* argv[]) {
@@ -461,6 +465,8 @@ int main(int argc, char* argv[]) {
             interval_ms = atoi(argv[++i]);
         else if (arg == "--info")
             format = "info";
+        else if (arg == "--v2")
+            gTbinVersion = format::tbin::VERSION_2;
         else if (arg == "--help" || arg == "-h") {
             print_usage();
             return 0;
@@ -480,6 +486,7 @@ int main(int argc, char* argv[]) {
         }
         printf("File:     %s\n", input.c_str());
         printf("Stream:   %s\n", reader.stream_id().c_str());
+        printf("Version:  %u\n", reader.version());
 
         format::tbin::Message msg;
         uint64_t              count = 0, ubx = 0, rtcm = 0, lpp = 0, nav = 0, other = 0;
@@ -511,6 +518,7 @@ int main(int argc, char* argv[]) {
         printf("Last:     %s UTC\n", buf2);
         printf("Duration: %.1fs (%.1f min)\n", duration, duration / 60.0);
         printf("Types:    UBX=%lu RTCM=%lu LPP=%lu NAV=%lu\n", ubx, rtcm, lpp, nav);
+        if (reader.corrupt_blocks() > 0) printf("Corrupt:  %lu blocks\n", reader.corrupt_blocks());
         if (duration > 0) printf("Rate:     %.1f msg/s\n", count / duration);
         return 0;
     }
@@ -13,6 +13,7 @@
 #include <ephemeris/bds.hpp>
 #include <ephemeris/gal.hpp>
 #include <ephemeris/gps.hpp>
+#include <format/helper/snapshot.hpp>
 #include <format/lpp/uper_parser.hpp>
 #include <format/nav/gps/lnav.hpp>
 #include <format/rinex/nav_reader.hpp>
@@ -42,6 +43,7 @@ struct Config {
     std::string              diag_dir;
     std::string              antex_file;
     std::vector<std::string> nav_files;
+    std::string              file_cache_dir;
     double                   ubx_shift = -72000.0;
     double                   stop_time = 0.0;
     double                   pos_x = 0, pos_y = 0, pos_z = 0;
@@ -70,6 +72,8 @@ static Config parse_args(int argc, char** argv) {
             cfg.diag_dir = next();
         else if (arg == "--antex")
             cfg.antex_file = next();
+        else if (arg == "--file-cache-dir")
+            cfg.file_cache_dir = next();
         else if (arg == "--ubx-shift")
             cfg.ubx_shift = std::stod(next());
         else if (arg == "--stop-time")
@@ -130,7 +134,10 @@ int main(int argc, char** argv) {
 
     // Load nav files
     for (auto& nav_path : cfg.nav_files) {
-        auto nav = format::rinex::parse_nav_file(nav_path);
+        auto nav = cfg.file_cache_dir.empty() ?
+                       format::rinex::parse_nav_file(nav_path) :
+                       format::rinex::parse_nav_file_cached(
+                           nav_path, format::helper::snapshot_path(cfg.file_cache_dir, nav_path));
         for (auto& eph : nav.gps)
             generator->process_ephemeris(eph);
         for (auto& eph : nav.gal)
@@ -142,7 +149,11 @@ int main(int argc, char** argv) {
     // Load antex
 #ifdef INCLUDE_FORMAT_ANTEX
     if (!cfg.antex_file.empty()) {
-        auto antex = format::antex::Antex::from_file(cfg.antex_file);
+        auto antex = cfg.file_cache_dir.empty() ?
+                         format::antex::Antex::from_file(cfg.antex_file) :
+                         format::antex::Antex::from_file_cached(
+                             cfg.antex_file,
+                             format::helper::snapshot_path(cfg.file_cache_dir, cfg.antex_file));
         if (antex) generator->set_antex(std::move(antex));
     }
 #endif
@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace bench {
+using Clock = std::chrono::steady_clock;
+
+inline long iterations(int argc, char** argv, long fallback) {
+    if (argc > 1) {
+        auto value = std::strtol(argv[1], nullptr, 10);
+        if (value > 0) return value;
+    }
+    return fallback;
+}
+
+template <typename F>
+inline double measure(F&& function) {
+    auto begin = Clock::now();
+    function();
+    auto end = Clock::now();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+inline void report(char const* name, long count, double seconds) {
+    printf("%-40s %10ld ops %10.3f ms %14.0f ops/s\n", name, count, seconds * 1000.0,
+           seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0);
+}
+}  // namespace bench
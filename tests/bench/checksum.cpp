@@ -0,0 +1,63 @@
+#include <random>
+#include <vector>
+
+#include <format/checksum/checksum.hpp>
+
+#include "bench.hpp"
+
+using format::checksum::Implementation;
+
+struct Variant {
+    char const*    name;
+    Implementation implementation;
+};
+
+static Variant const VARIANTS[] = {
+    {"bytewise", Implementation::Bytewise},
+    {"slice8", Implementation::Slice8},
+    {"simd", Implementation::Simd},
+};
+
+template <typename F>
+static void run(char const* checksum, std::vector<uint8_t> const& data, long count, F&& function) {
+    for (auto& variant : VARIANTS) {
+        uint32_t sink    = 0;
+        auto     seconds = bench::measure([&] {
+            for (long i = 0; i < count; i++) {
+                sink += function(data.data(), data.size(), variant.implementation);
+            }
+        });
+
+        char name[64];
+        snprintf(name, sizeof(name), "%s/%s/%zu", checksum, variant.name, data.size());
+        bench::report(name, count, seconds);
+        printf("%-40s %10.1f MB/s (%08x)\n", "",
+               seconds > 0.0 ? static_cast<double>(count * data.size()) / seconds / 1e6 : 0.0,
+               sink);
+    }
+}
+
+int main(int argc, char** argv) {
+    auto count = bench::iterations(argc, argv, 100000);
+
+    printf("simd crc: %s, simd fletcher: %s\n", format::checksum::has_simd_crc() ? "yes" : "no",
+           format::checksum::has_simd_fletcher() ? "yes" : "no");
+
+    std::mt19937 rng(42);
+    for (size_t size : {64u, 1029u}) {
+        std::vector<uint8_t> data(size);
+        for (auto& byte : data)
+            byte = static_cast<uint8_t>(rng());
+
+        run("crc24q", data, count, [](uint8_t const* d, size_t n, Implementation impl) {
+            return static_cast<uint32_t>(format::checksum::crc24q(d, n, impl));
+        });
+        run("crc16", data, count, [](uint8_t const* d, size_t n, Implementation impl) {
+            return static_cast<uint32_t>(format::checksum::crc16_ccitt(d, n, impl));
+        });
+        run("fletcher8", data, count, [](uint8_t const* d, size_t n, Implementation impl) {
+            return static_cast<uint32_t>(format::checksum::fletcher8(d, n, impl));
+        });
+    }
+    return 0;
+}
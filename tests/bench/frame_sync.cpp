@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <format/checksum/checksum.hpp>
+#include <format/helper/demux.hpp>
+#include <format/nmea/message.hpp>
+#include <format/nmea/parser.hpp>
+#include <format/rtcm/message.hpp>
+#include <format/rtcm/parser.hpp>
+#include <format/ubx/message.hpp>
+#include <format/ubx/parser.hpp>
+#include <loglet/loglet.hpp>
+
+#include "bench.hpp"
+
+static void append_rtcm(std::vector<uint8_t>& stream, std::mt19937& rng, size_t payload_length) {
+    auto start = stream.size();
+    stream.push_back(0xD3);
+    stream.push_back(static_cast<uint8_t>(payload_length >> 8));
+    stream.push_back(static_cast<uint8_t>(payload_length));
+    stream.push_back(0x3E);
+    stream.push_back(0xD0);
+    for (size_t i = 2; i < payload_length; i++)
+        stream.push_back(static_cast<uint8_t>(rng()));
+    auto crc = format::checksum::crc24q(stream.data() + start, stream.size() - start);
+    stream.push_back(static_cast<uint8_t>(crc >> 16));
+    stream.push_back(static_cast<uint8_t>(crc >> 8));
+    stream.push_back(static_cast<uint8_t>(crc));
+}
+
+static void append_ubx(std::vector<uint8_t>& stream, std::mt19937& rng, size_t payload_length) {
+    auto start = stream.size();
+    stream.push_back(0xB5);
+    stream.push_back(0x62);
+    stream.push_back(0x02);
+    stream.push_back(0x99);
+    stream.push_back(static_cast<uint8_t>(payload_length));
+    stream.push_back(static_cast<uint8_t>(payload_length >> 8));
+    for (size_t i = 0; i < payload_length; i++)
+        stream.push_back(static_cast<uint8_t>(rng()));
+    auto ck = format::checksum::fletcher8(stream.data() + start + 2, stream.size() - start - 2);
+    stream.push_back(static_cast<uint8_t>(ck));
+    stream.push_back(static_cast<uint8_t>(ck >> 8));
+}
+
+static void append_nmea(std::vector<uint8_t>& stream) {
+    char const* sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    stream.insert(stream.end(), sentence, sentence + strlen(sentence));
+}
+
+// One second of a receiver at 921600 baud: RAWX/SFRBX-like UBX, MSM-like RTCM, a few NMEA
+// sentences and some line noise.
+static std::vector<uint8_t> make_stream() {
+    std::mt19937         rng(7);
+    std::vector<uint8_t> stream;
+    while (stream.size() < 92160) {
+        append_ubx(stream, rng, 1000 + rng() % 1000);
+        append_rtcm(stream, rng, 200 + rng() % 400);
+        append_nmea(stream);
+        for (int i = 0; i < 64; i++)
+            stream.push_back(static_cast<uint8_t>(rng()));
+    }
+    return stream;
+}
+
+template <typename Feed>
+static void run(char const* name, std::vector<uint8_t> const& stream, long count, Feed&& feed) {
+    size_t messages = 0;
+    auto   seconds  = bench::measure([&] {
+        for (long i = 0; i < count; i++) {
+            // serial reads arrive in small chunks
+            for (size_t offset = 0; offset < stream.size(); offset += 256) {
+                auto length = std::min<size_t>(256, stream.size() - offset);
+                messages += feed(stream.data() + offset, length);
+            }
+        }
+    });
+    bench::report(name, count, seconds);
+    printf("%-40s %10.1f MB/s (%zu messages)\n", "",
+           seconds > 0.0 ? static_cast<double>(count * stream.size()) / seconds / 1e6 : 0.0,
+           messages);
+}
+
+int main(int argc, char** argv) {
+    auto count = bench::iterations(argc, argv, 200);
+    loglet::set_level(loglet::Level::Error);
+
+    auto stream = make_stream();
+
+    format::nmea::Parser nmea;
+    format::rtcm::Parser rtcm;
+    format::ubx::Parser  ubx;
+    run("parsers/all-bytes", stream, count, [&](uint8_t const* data, size_t length) {
+        size_t messages = 0;
+        nmea.append(data, length);
+        while (nmea.try_parse())
+            messages++;
+        rtcm.append(data, length);
+        while (rtcm.try_parse())
+            messages++;
+        ubx.append(data, length);
+        while (ubx.try_parse())
+            messages++;
+        return messages;
+    });
+
+    format::helper::Demultiplexer demux{format::helper::FRAME_NMEA | format::helper::FRAME_RTCM |
+                                        format::helper::FRAME_UBX};
+    run("parsers/demux", stream, count, [&](uint8_t const* data, size_t length) {
+        size_t messages = 0;
+        demux.append(data, length);
+        format::helper::Frame frame{};
+        while (demux.next(frame)) {
+            switch (frame.format) {
+            case format::helper::FRAME_NMEA:
+                nmea.append(frame.data, frame.length);
+                while (nmea.try_parse())
+                    messages++;
+                break;
+            case format::helper::FRAME_RTCM:
+                rtcm.append(frame.data, frame.length);
+                while (rtcm.try_parse())
+                    messages++;
+                break;
+            default:
+                ubx.append(frame.data, frame.length);
+                while (ubx.try_parse())
+                    messages++;
+                break;
+            }
+        }
+        return messages;
+    });
+
+    run("scan/find_frame_start", stream, count, [&](uint8_t const* data, size_t length) {
+        size_t candidates = 0;
+        for (size_t i = 0; i < length;) {
+            i += format::helper::find_frame_start(data + i, length - i, format::helper::FRAME_RTCM);
+            if (i < length) candidates++, i++;
+        }
+        return candidates;
+    });
+    return 0;
+}
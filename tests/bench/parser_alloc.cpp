@@ -0,0 +1,158 @@
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include <format/checksum/checksum.hpp>
+#include <format/rtcm/message.hpp>
+#include <format/rtcm/parser.hpp>
+#include <format/ubx/message.hpp>
+#include <format/ubx/parser.hpp>
+#include <loglet/loglet.hpp>
+
+#include "bench.hpp"
+
+// Count every heap allocation made by the process, so the parsers can be compared by allocations
+// per message and not only by time.
+static std::atomic<unsigned long> gAllocations{0};
+
+void* operator new(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    auto pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+static std::vector<uint8_t> ubx_frame(uint8_t message_class, uint8_t message_id,
+                                      std::vector<uint8_t> const& payload) {
+    std::vector<uint8_t> frame{0xB5, 0x62, message_class, message_id,
+                               static_cast<uint8_t>(payload.size()),
+                               static_cast<uint8_t>(payload.size() >> 8)};
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    auto checksum = format::checksum::fletcher8(frame.data() + 2, frame.size() - 2);
+    frame.push_back(static_cast<uint8_t>(checksum & 0xFF));
+    frame.push_back(static_cast<uint8_t>(checksum >> 8));
+    return frame;
+}
+
+static std::vector<uint8_t> rtcm_frame(uint16_t type, std::mt19937& rng, size_t payload_length) {
+    std::vector<uint8_t> frame{0xD3, static_cast<uint8_t>(payload_length >> 8),
+                               static_cast<uint8_t>(payload_length),
+                               static_cast<uint8_t>(type >> 4),
+                               static_cast<uint8_t>((type & 0x0F) << 4)};
+    for (size_t i = 2; i < payload_length; i++)
+        frame.push_back(static_cast<uint8_t>(rng()));
+    auto crc = format::checksum::crc24q(frame.data(), frame.size());
+    frame.push_back(static_cast<uint8_t>(crc >> 16));
+    frame.push_back(static_cast<uint8_t>(crc >> 8));
+    frame.push_back(static_cast<uint8_t>(crc));
+    return frame;
+}
+
+// A RXM-RAWX epoch with 32 measurements followed by 32 RXM-SFRBX subframes.
+static std::vector<std::vector<uint8_t>> ubx_epoch(std::mt19937& rng) {
+    std::vector<std::vector<uint8_t>> frames;
+
+    std::vector<uint8_t> rawx(16 + 32 * 32);
+    for (auto& byte : rawx)
+        byte = static_cast<uint8_t>(rng());
+    rawx[11] = 32;  // numMeas
+    frames.push_back(ubx_frame(0x02, 0x15, rawx));
+
+    for (int i = 0; i < 32; i++) {
+        std::vector<uint8_t> sfrbx(8 + 10 * 4);
+        for (auto& byte : sfrbx)
+            byte = static_cast<uint8_t>(rng());
+        sfrbx[4] = 10;    // numWords
+        sfrbx[6] = 0x02;  // version
+        frames.push_back(ubx_frame(0x02, 0x13, sfrbx));
+    }
+    return frames;
+}
+
+// MSM7 messages for four constellations, as they would be sent by a reference station.
+static std::vector<std::vector<uint8_t>> rtcm_epoch(std::mt19937& rng) {
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 8; i++) {
+        for (uint16_t type : {1077, 1087, 1097, 1127})
+            frames.push_back(rtcm_frame(type, rng, 200 + (rng() % 400)));
+    }
+    return frames;
+}
+
+enum class Mode {
+    TryParse,
+    Pooled,
+    TryParseInto,
+};
+
+static char const* mode_name(Mode mode) {
+    switch (mode) {
+    case Mode::TryParse: return "try_parse";
+    case Mode::Pooled: return "try_parse+pooled";
+    case Mode::TryParseInto: return "try_parse_into+pooled";
+    }
+    return "?";
+}
+
+template <typename Parser, typename MessagePtr>
+static void run(char const* format, std::vector<std::vector<uint8_t>> const& frames, long count,
+                Mode mode) {
+    Parser parser;
+    parser.set_pooled(mode != Mode::TryParse);
+
+    unsigned long messages    = 0;
+    unsigned long allocations = 0;
+    MessagePtr    message;
+    auto          seconds = bench::measure([&] {
+        for (long i = 0; i < count; i++) {
+            for (auto& frame : frames) {
+                auto before = gAllocations.load(std::memory_order_relaxed);
+                parser.append(frame.data(), static_cast<uint32_t>(frame.size()));
+                if (mode == Mode::TryParseInto) {
+                    while (parser.try_parse_into(message))
+                        messages++;
+                } else {
+                    for (;;) {
+                        auto parsed = parser.try_parse();
+                        if (!parsed) break;
+                        messages++;
+                    }
+                }
+                allocations += gAllocations.load(std::memory_order_relaxed) - before;
+            }
+        }
+    });
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s/%s", format, mode_name(mode));
+    bench::report(name, static_cast<long>(messages), seconds);
+    printf("%-40s %10.2f allocations/message\n", "",
+           messages > 0 ? static_cast<double>(allocations) / static_cast<double>(messages) : 0.0);
+}
+
+int main(int argc, char** argv) {
+    loglet::set_level(loglet::Level::Error);
+    auto count = bench::iterations(argc, argv, 2000);
+
+    std::mt19937 rng(42);
+    auto         ubx  = ubx_epoch(rng);
+    auto         rtcm = rtcm_epoch(rng);
+
+    for (auto mode : {Mode::TryParse, Mode::Pooled, Mode::TryParseInto}) {
+        run<format::ubx::Parser, std::unique_ptr<format::ubx::Message>>("ubx", ubx, count, mode);
+        run<format::rtcm::Parser, std::unique_ptr<format::rtcm::Message>>("rtcm", rtcm, count,
+                                                                           mode);
+    }
+    return 0;
+}
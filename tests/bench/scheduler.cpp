@@ -0,0 +1,79 @@
+#include <memory>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include <scheduler/file_descriptor.hpp>
+#include <scheduler/scheduler.hpp>
+
+#include "bench.hpp"
+
+using scheduler::Backend;
+
+static Backend const BACKENDS[] = {Backend::Epoll, Backend::IoUring};
+
+// Many inputs that all become readable at once, like a gateway with many serial and TCP inputs.
+// With `completions` the inputs are read with io_uring receive completions instead of `read`.
+static void run(Backend backend, bool completions, int inputs, int max_events, long rounds) {
+    scheduler::ScopedScheduler sched{backend};
+    sched.set_max_events_per_wait(max_events);
+
+    std::vector<int>                                                 write_fds;
+    std::vector<std::unique_ptr<scheduler::OwnedFileDescriptorTask>> tasks;
+    long                                                             received = 0;
+    for (int i = 0; i < inputs; i++) {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) != 0) return;
+        write_fds.push_back(pair[1]);
+
+        auto task     = std::unique_ptr<scheduler::OwnedFileDescriptorTask>(
+            new scheduler::OwnedFileDescriptorTask(pair[0]));
+        task->on_read = [&received](scheduler::OwnedFileDescriptorTask& t) {
+            char buffer[64];
+            if (::read(t.fd(), buffer, sizeof(buffer)) > 0) received++;
+        };
+        if (!task->schedule(sched)) return;
+        if (completions && !task->receive([&received](uint8_t*, ssize_t length) {
+                if (length > 0) received += length;
+            }))
+            return;
+        tasks.push_back(std::move(task));
+    }
+
+    auto seconds = bench::measure([&] {
+        for (long round = 1; round <= rounds; round++) {
+            for (auto fd : write_fds) {
+                if (::write(fd, "x", 1) != 1) return;
+            }
+            sched.execute_while([&] {
+                return received < round * inputs;
+            });
+        }
+    });
+
+    // The io_uring backend falls back to epoll when the kernel does not support it
+    char name[64];
+    snprintf(name, sizeof(name), "%s/%d inputs/%d per wait",
+             completions                         ? "io_uring+recv" :
+             sched.backend() == Backend::IoUring ? "io_uring" :
+                                                   "epoll",
+             inputs, max_events);
+    bench::report(name, received, seconds);
+
+    for (auto fd : write_fds)
+        ::close(fd);
+}
+
+int main(int argc, char** argv) {
+    auto rounds = bench::iterations(argc, argv, 2000);
+
+    for (auto inputs : {16, 256}) {
+        for (auto max_events : {1, 32}) {
+            for (auto backend : BACKENDS) {
+                run(backend, false, inputs, max_events, rounds);
+            }
+            run(Backend::IoUring, true, inputs, max_events, rounds);
+        }
+    }
+    return 0;
+}
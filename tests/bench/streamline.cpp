@@ -0,0 +1,148 @@
+#include <memory>
+
+#include <loglet/loglet.hpp>
+#include <scheduler/scheduler.hpp>
+#include <streamline/system.hpp>
+
+#include "bench.hpp"
+
+struct Payload {
+    uint64_t sequence;
+    uint8_t  data[64];
+};
+
+using Message = std::unique_ptr<Payload>;
+
+struct Counter : public streamline::Inspector<Message> {
+    uint64_t& count;
+    Counter(uint64_t& c) : count(c) {}
+    void inspect(streamline::System&, DataType const& data, uint64_t) override {
+        count += data->sequence & 1u;
+    }
+    char const* name() const NOEXCEPT override { return "Counter"; }
+};
+
+struct Sink : public streamline::Consumer<Message> {
+    uint64_t& count;
+    Sink(uint64_t& c) : count(c) {}
+    void consume(streamline::System&, DataType&& data, uint64_t) override {
+        count += data->sequence & 1u;
+    }
+    char const* name() const NOEXCEPT override { return "Sink"; }
+};
+
+struct SharedCounter : public streamline::Consumer<streamline::Shared<Payload>> {
+    uint64_t& count;
+    SharedCounter(uint64_t& c) : count(c) {}
+    void consume(streamline::System&, DataType&& data, uint64_t) override {
+        count += data->sequence & 1u;
+    }
+    char const* name() const NOEXCEPT override { return "SharedCounter"; }
+};
+
+namespace streamline {
+template <>
+struct Clone<Message> {
+    Message operator()(Message const& value) { return Message(new Payload(*value)); }
+};
+}  // namespace streamline
+
+static Message make_message(long i) {
+    auto message      = Message(new Payload{});
+    message->sequence = static_cast<uint64_t>(i);
+    return message;
+}
+
+// Push `count` messages in batches of `batch` and run one scheduler tick per batch.
+template <typename Push>
+static void run_async(scheduler::Scheduler& scheduler, long count, long batch, Push&& push) {
+    for (long i = 0; i < count;) {
+        for (long j = 0; j < batch && i < count; j++, i++) {
+            push(i);
+        }
+        scheduler.execute_once();
+    }
+}
+
+int main(int argc, char** argv) {
+    loglet::set_level(loglet::Level::Warning);
+    auto count = bench::iterations(argc, argv, 1000000);
+
+    {
+        streamline::System system;
+        system.set_sync_mode(true);
+        uint64_t sink = 0;
+        system.add_inspector<Counter>(sink);
+        auto seconds = bench::measure([&] {
+            for (long i = 0; i < count; i++)
+                system.push(make_message(i));
+        });
+        bench::report("sync System::push", count, seconds);
+    }
+
+    {
+        streamline::System system;
+        system.set_sync_mode(true);
+        uint64_t sink = 0;
+        system.add_inspector<Counter>(sink);
+        auto channel = system.channel<Message>();
+        auto seconds = bench::measure([&] {
+            for (long i = 0; i < count; i++)
+                channel.push(make_message(i));
+        });
+        bench::report("sync Channel::push", count, seconds);
+    }
+
+    for (long batch : {1L, 16L, 256L}) {
+        scheduler::Scheduler scheduler;
+        streamline::System   system{scheduler};
+        uint64_t             sink = 0;
+        system.add_inspector<Counter>(sink);
+        auto channel = system.channel<Message>();
+
+        char name[64];
+        snprintf(name, sizeof(name), "async Channel::push (batch %ld)", batch);
+        auto seconds = bench::measure([&] {
+            run_async(scheduler, count, batch, [&](long i) {
+                channel.push(make_message(i));
+            });
+        });
+        bench::report(name, count, seconds);
+    }
+
+    {
+        scheduler::Scheduler scheduler;
+        streamline::System   system{scheduler};
+        uint64_t             sink = 0;
+        system.add_consumer<Sink>(sink);
+        system.add_consumer<Sink>(sink);
+        system.add_consumer<Sink>(sink);
+        auto channel = system.channel<Message>();
+        auto seconds = bench::measure([&] {
+            run_async(scheduler, count, 256, [&](long i) {
+                channel.push(make_message(i));
+            });
+        });
+        bench::report("async 3 consumers, cloned", count, seconds);
+    }
+
+    {
+        scheduler::Scheduler scheduler;
+        streamline::System   system{scheduler};
+        uint64_t             sink = 0;
+        system.add_consumer<SharedCounter>(sink);
+        system.add_consumer<SharedCounter>(sink);
+        system.add_consumer<SharedCounter>(sink);
+        auto channel = system.channel<streamline::Shared<Payload>>();
+        auto seconds = bench::measure([&] {
+            run_async(scheduler, count, 256, [&](long i) {
+                auto payload      = std::make_shared<Payload>();
+                payload->sequence = static_cast<uint64_t>(i);
+                channel.push(std::move(payload));
+            });
+        });
+        bench::report("async 3 consumers, shared", count, seconds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <time/gps.hpp>
+
+#include "models/helper.hpp"
+
+#include "bench.hpp"
+
+using namespace generator::tokoro;
+
+static CONSTEXPR size_t SIGNALS_PER_SATELLITE = 3;
+
+int main(int argc, char** argv) {
+    auto count = bench::iterations(argc, argv, 20000);
+
+    auto time = ts::Tai{ts::Gps::from_ymdhms(2025, 5, 12, 10, 0, 0.0)};
+    auto llh  = Float3{57.7 * constant::DEG2RAD, 11.9 * constant::DEG2RAD, 80.0};
+
+    // The satellites of a multi-constellation epoch, a few of them below the horizon
+    std::mt19937                           rng(7);
+    std::uniform_real_distribution<double> distribution(-5.0, 90.0);
+    std::vector<double>                    elevations(40);
+    for (auto& elevation : elevations)
+        elevation = distribution(rng) * constant::DEG2RAD;
+
+    std::vector<double> hydrostatic(elevations.size());
+    std::vector<double> wet(elevations.size());
+    double              sink = 0.0;
+
+    // Before: the full model per satellite and signal
+    auto seconds = bench::measure([&] {
+        for (long n = 0; n < count; n++) {
+            for (size_t i = 0; i < elevations.size(); i++) {
+                for (size_t s = 0; s < SIGNALS_PER_SATELLITE; s++) {
+                    auto mapping = hydrostatic_mapping_function(time, llh, elevations[i], true);
+                    hydrostatic[i] = mapping.hydrostatic;
+                    wet[i]         = mapping.wet;
+                }
+            }
+            sink += hydrostatic[0];
+        }
+    });
+    bench::report("mapping/per-signal", count * static_cast<long>(elevations.size()), seconds);
+    auto expected_hydrostatic = hydrostatic;
+    auto expected_wet         = wet;
+
+    // Coefficients once per epoch, mapping once per satellite
+    seconds = bench::measure([&] {
+        for (long n = 0; n < count; n++) {
+            auto coefficients = niell_coefficients(time, llh);
+            for (size_t i = 0; i < elevations.size(); i++) {
+                auto mapping = hydrostatic_mapping_function(coefficients, elevations[i], true);
+                hydrostatic[i] = mapping.hydrostatic;
+                wet[i]         = mapping.wet;
+            }
+            sink += hydrostatic[0];
+        }
+    });
+    bench::report("mapping/per-satellite", count * static_cast<long>(elevations.size()), seconds);
+
+    // All satellites in one batch
+    seconds = bench::measure([&] {
+        for (long n = 0; n < count; n++) {
+            auto coefficients = niell_coefficients(time, llh);
+            hydrostatic_mapping_functions(coefficients, elevations.data(), elevations.size(), true,
+                                          hydrostatic.data(), wet.data());
+            sink += hydrostatic[0];
+        }
+    });
+    bench::report("mapping/batch", count * static_cast<long>(elevations.size()), seconds);
+    printf("%-40s %g\n", "", sink);
+
+    auto bytes = elevations.size() * sizeof(double);
+    if (memcmp(hydrostatic.data(), expected_hydrostatic.data(), bytes) != 0 ||
+        memcmp(wet.data(), expected_wet.data(), bytes) != 0) {
+        printf("batched mapping differs from the scalar mapping\n");
+        return 1;
+    }
+    return 0;
+}
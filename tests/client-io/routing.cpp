@@ -0,0 +1,230 @@
+#include <client-io/program_io.hpp>
+#include <client-io/tag_registry.hpp>
+#include <doctest/doctest.h>
+
+#include <string>
+#include <vector>
+
+using Targets = std::vector<OutputInterface const*>;
+
+// Registered in the same order by every test, so the bit of each tag does not depend on the order
+// the tests run in. The fillers push "high" and "higher" past the first 64 bits.
+static void register_tags() {
+    tags::register_tag("route-a", "test tag");
+    tags::register_tag("route-b", "test tag");
+    tags::register_tag("route-c", "test tag");
+    for (int i = 0; i < 64; i++) {
+        tags::register_tag("route-fill-" + std::to_string(i), "test tag");
+    }
+    tags::register_tag("route-high", "test tag");
+    tags::register_tag("route-higher", "test tag");
+}
+
+static OutputInterface make_output(OutputFormat format, std::vector<std::string> itags,
+                                   std::vector<std::string> otags) {
+    OutputInterface output;
+    output.entry.type         = "test";
+    output.entry.format       = format;
+    output.entry.include_tags = std::move(itags);
+    output.entry.exclude_tags = std::move(otags);
+    output.include_tag_mask   = tags::get(output.entry.include_tags);
+    output.exclude_tag_mask   = tags::get(output.entry.exclude_tags);
+    return output;
+}
+
+static uint64_t tag_id(std::vector<std::string> const& names) {
+    return tags::id(tags::get(names));
+}
+
+// What the processors did before the routing table: test every output for every message
+static Targets accept_loop(std::vector<OutputInterface> const& outputs, OutputFormat format,
+                           uint64_t tag) {
+    Targets targets;
+    for (auto const& output : outputs) {
+        if ((output.entry.format & format) != 0 && output.accept_tag(tag)) {
+            targets.push_back(&output);
+        }
+    }
+    return targets;
+}
+
+static Targets pick(std::vector<OutputInterface> const& outputs, std::vector<size_t> indices) {
+    Targets targets;
+    for (auto index : indices) {
+        targets.push_back(&outputs[index]);
+    }
+    return targets;
+}
+
+static Targets routed(ProgramOutput const& config, OutputFormat format, uint64_t tag) {
+    Targets targets;
+    for (auto output : config.route(format, tag)) {
+        targets.push_back(output);
+    }
+    return targets;
+}
+
+static OutputFormat const FORMATS[] = {
+    OUTPUT_FORMAT_UBX,    OUTPUT_FORMAT_NMEA, OUTPUT_FORMAT_RTCM,
+    OUTPUT_FORMAT_SPARTN, OUTPUT_FORMAT_LFR,  OUTPUT_FORMAT_TEST,
+};
+
+static std::vector<std::vector<std::string>> const TAG_SETS = {
+    {},
+    {"route-a"},
+    {"route-b"},
+    {"route-c"},
+    {"route-a", "route-b"},
+    {"route-a", "route-c"},
+    {"route-high"},
+    {"route-a", "route-high"},
+    {"route-c", "route-high"},
+    {"route-higher"},
+    {"route-high", "route-higher"},
+};
+
+static void add_outputs(ProgramOutput& config) {
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM, {}, {}));
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM, {"route-a"}, {}));
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM | OUTPUT_FORMAT_NMEA, {}, {"route-b"}));
+    config.outputs.push_back(
+        make_output(OUTPUT_FORMAT_RTCM, {"route-a", "route-high"}, {"route-c"}));
+    config.outputs.push_back(
+        make_output(OUTPUT_FORMAT_NMEA | OUTPUT_FORMAT_UBX, {"route-high"}, {}));
+    // A second output with the same configuration, as `unique=true` gives it its own stream
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM, {}, {}));
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_TEST, {"route-c"}, {}));
+    config.outputs.push_back(
+        make_output(OUTPUT_FORMAT_SPARTN | OUTPUT_FORMAT_RTCM, {"route-b"}, {"route-higher"}));
+}
+
+TEST_CASE("OutputRouter - routes match the accept_tag loop") {
+    register_tags();
+    ProgramOutput config;
+    add_outputs(config);
+    config.compile_routes();
+
+    // Twice, the second pass is served from the cached tag slots
+    for (int pass = 0; pass < 2; pass++) {
+        for (auto const& names : TAG_SETS) {
+            auto tag = tag_id(names);
+            for (auto format : FORMATS) {
+                CAPTURE(pass);
+                CAPTURE(tags::to_string(tags::mask(tag)));
+                CAPTURE(format);
+                CHECK(routed(config, format, tag) == accept_loop(config.outputs, format, tag));
+            }
+        }
+    }
+
+    // Alternating tags switch between slots
+    auto a    = tag_id({"route-a"});
+    auto high = tag_id({"route-high"});
+    for (int i = 0; i < 4; i++) {
+        auto tag = (i % 2) ? high : a;
+        CHECK(routed(config, OUTPUT_FORMAT_RTCM, tag) ==
+              accept_loop(config.outputs, OUTPUT_FORMAT_RTCM, tag));
+    }
+
+    CHECK(config.route(OUTPUT_FORMAT_NONE, a).empty());
+}
+
+TEST_CASE("OutputRouter - untagged messages and itags/otags") {
+    register_tags();
+    ProgramOutput config;
+    add_outputs(config);
+
+    // Untagged messages go to every output of the format, whatever its tags
+    auto untagged = pick(config.outputs, {0, 1, 2, 3, 5, 7});
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, 0) == untagged);
+
+    // itags=route-a+route-high accepts either tag, otags=route-c rejects the message even then
+    auto a_c         = tag_id({"route-a", "route-c"});
+    auto a_c_targets = pick(config.outputs, {0, 1, 2, 5});
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, a_c) == a_c_targets);
+
+    // Both configurations of the duplicated output receive the message, in configuration order
+    auto b         = tag_id({"route-b"});
+    auto b_targets = pick(config.outputs, {0, 5, 7});
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, b) == b_targets);
+}
+
+TEST_CASE("OutputRouter - tags with a bit index of 64 and above") {
+    register_tags();
+    auto high   = tags::get("route-high");
+    auto higher = tags::get("route-higher");
+    REQUIRE(TAG_MAX_COUNT > 64);
+    CHECK(high.words[0] == 0);
+    CHECK(higher.words[0] == 0);
+    CHECK(high != higher);
+
+    ProgramOutput config;
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM, {"route-high"}, {}));
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM, {}, {"route-higher"}));
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM, {"route-a"}, {}));
+    auto high_id        = tag_id({"route-high"});
+    auto higher_id      = tag_id({"route-higher"});
+    auto high_higher_id = tag_id({"route-high", "route-higher"});
+    auto a_higher_id    = tag_id({"route-a", "route-higher"});
+
+    auto high_targets        = pick(config.outputs, {0, 1});
+    auto high_higher_targets = pick(config.outputs, {0});
+    auto a_higher_targets    = pick(config.outputs, {2});
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, high_id) == high_targets);
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, higher_id).empty());
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, high_higher_id) == high_higher_targets);
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, a_higher_id) == a_higher_targets);
+}
+
+TEST_CASE("OutputRouter - recompiled when the outputs change") {
+    register_tags();
+    ProgramOutput config;
+    config.outputs.reserve(4);
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM, {"route-a"}, {}));
+    config.compile_routes();
+
+    auto a     = tag_id({"route-a"});
+    auto first = pick(config.outputs, {0});
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, a) == first);
+    CHECK(routed(config, OUTPUT_FORMAT_NMEA, a).empty());
+
+    // Adding an output is picked up on the next route
+    config.outputs.push_back(make_output(OUTPUT_FORMAT_RTCM | OUTPUT_FORMAT_NMEA, {}, {}));
+    auto both   = pick(config.outputs, {0, 1});
+    auto second = pick(config.outputs, {1});
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, a) == both);
+    CHECK(routed(config, OUTPUT_FORMAT_NMEA, a) == second);
+
+    // Changing the tags of an output needs an explicit compile
+    config.outputs[1].exclude_tag_mask = tags::get("route-a");
+    config.compile_routes();
+    CHECK(routed(config, OUTPUT_FORMAT_RTCM, a) == first);
+
+    // Removing outputs as well
+    config.outputs.clear();
+    CHECK(config.route(OUTPUT_FORMAT_RTCM, a).empty());
+}
+
+TEST_CASE("OutputRouter - a route stays valid while other tags are routed") {
+    register_tags();
+    ProgramOutput config;
+    add_outputs(config);
+    config.compile_routes();
+
+    auto tag      = tag_id({});
+    auto expected = accept_loop(config.outputs, OUTPUT_FORMAT_RTCM, tag);
+
+    // Every new tag id adds a slot to the routing table, growing it while the outer route is used
+    Targets targets;
+    size_t  index = 0;
+    for (auto output : config.route(OUTPUT_FORMAT_RTCM, tag)) {
+        targets.push_back(output);
+        for (size_t i = 0; i < 4; i++, index++) {
+            auto fill  = "route-fill-" + std::to_string(index);
+            auto other = tag_id({fill, "route-b"});
+            CHECK(routed(config, OUTPUT_FORMAT_RTCM, other) ==
+                  accept_loop(config.outputs, OUTPUT_FORMAT_RTCM, other));
+        }
+    }
+    CHECK(targets == expected);
+}
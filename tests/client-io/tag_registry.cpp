@@ -0,0 +1,75 @@
+#include <client-io/tag_registry.hpp>
+#include <doctest/doctest.h>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("TagRegistry - combined masks are interned to ids") {
+    tags::TagRegistry registry;
+    registry.register_tag("a", "test tag");
+    registry.register_tag("b", "test tag");
+    for (int i = 0; i < 70; i++) {
+        registry.register_tag("fill-" + std::to_string(i), "test tag");
+    }
+    registry.register_tag("high", "test tag");
+
+    auto a    = registry.get_tag("a");
+    auto b    = registry.get_tag("b");
+    auto high = registry.get_tag("high");
+
+    // The empty set is always 0
+    CHECK(registry.id(tags::TagMask{}) == 0);
+
+    auto a_id      = registry.id(a);
+    auto ab_id     = registry.id(a | b);
+    auto a_high_id = registry.id(a | high);
+    CHECK(a_id != 0);
+    CHECK(ab_id != a_id);
+    CHECK(a_high_id != a_id);
+    CHECK(a_high_id != ab_id);
+
+    // The same set gets the same id, however it was built
+    CHECK(registry.id(b | a) == ab_id);
+    CHECK(registry.id(registry.get_tag(std::vector<std::string>{"a", "b"})) == ab_id);
+    CHECK(registry.id(high | a) == a_high_id);
+    CHECK(registry.id(a) == a_id);
+
+    CHECK(registry.mask(0).empty());
+    CHECK(registry.mask(a_id) == a);
+    CHECK(registry.mask(ab_id) == (a | b));
+    CHECK(registry.mask(a_high_id) == (a | high));
+    CHECK(registry.mask(a_high_id).intersects(high));
+    CHECK(registry.mask(12345).empty());
+}
+
+TEST_CASE("TagRegistry - mask names past the first 64 tags") {
+    tags::TagRegistry registry;
+    for (int i = 0; i < 64; i++) {
+        registry.register_tag("fill-" + std::to_string(i), "test tag");
+    }
+    registry.register_tag("high", "test tag");
+
+    auto high = registry.get_tag("high");
+    CHECK(high == tags::TagMask::bit(64));
+    CHECK(registry.mask_to_string(high) == "high");
+    CHECK(registry.mask_to_string(tags::TagMask::bit(100)) == "#100");
+    CHECK(registry.mask_to_string(tags::TagMask{}) == "");
+}
+
+TEST_CASE("TagMask - filter") {
+    auto a    = tags::TagMask::bit(1);
+    auto b    = tags::TagMask::bit(70);
+    auto c    = tags::TagMask::bit(130);
+    auto none = tags::TagMask{};
+
+    // Untagged messages pass every filter
+    CHECK(tags::TagMask::filter(a, b, none));
+    // No include tags accepts everything that is not excluded
+    CHECK(tags::TagMask::filter(none, none, c));
+    CHECK(tags::TagMask::filter(none, b, a | c));
+    CHECK_FALSE(tags::TagMask::filter(none, b, a | b));
+    // Include tags need one of them to be set, exclude tags win
+    CHECK(tags::TagMask::filter(a | b, none, b));
+    CHECK_FALSE(tags::TagMask::filter(a | b, none, c));
+    CHECK_FALSE(tags::TagMask::filter(a | b, c, b | c));
+}
@@ -1,7 +1,231 @@
 #include <doctest/doctest.h>
 #include <format/antex/antex.hpp>
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace format::antex;
+
+static std::string record(std::string const& content, char const* label) {
+    char line[128];
+    snprintf(line, sizeof(line), "%-60s%-20s\n", content.c_str(), label);
+    return line;
+}
+
+static std::string values_line(std::string prefix, int antenna, int row, int count) {
+    char value[16];
+    for (int j = 0; j < count; j++) {
+        snprintf(value, sizeof(value), "%8.2f", (antenna % 7) - 0.25 * j + 0.01 * row);
+        prefix += value;
+    }
+    return prefix + "\n";
+}
+
+// Pairs of GPS satellite antennas, the first valid until the end of 2009 and the second from 2010.
+// Every fourth antenna has an azimuth dependent pattern and every tenth is a receiver antenna
+// that the parser skips.
+static std::string make_antex(int antenna_count) {
+    std::string data;
+    data += record("     1.4            M", "ANTEX VERSION / SYST");
+    data += record("A                                       ", "PCV TYPE / REFANT");
+    data += record("generated for the parser tests", "COMMENT");
+    data += record("", "END OF HEADER");
+
+    for (int i = 0; i < antenna_count; i++) {
+        char satellite[8];
+        snprintf(satellite, sizeof(satellite), "G%02d", 1 + (i / 2) % 32);
+        auto receiver = i % 10 == 9;
+        auto dazi     = i % 4 == 0 ? 30.0 : 0.0;
+
+        char text[128];
+        data += record("", "START OF ANTENNA");
+        snprintf(text, sizeof(text), "%-20s%-20s%-20s",
+                 receiver ? "AOAD/M_T        NONE" : "BLOCK IIF", receiver ? "" : satellite, "");
+        data += record(text, "TYPE / SERIAL NO");
+        data += record("COD/ESA                  0    29-JAN-17", "METH / BY / # / DATE");
+        snprintf(text, sizeof(text), "  %6.1f", dazi);
+        data += record(text, "DAZI");
+        data += record("     0.0  12.0   1.0", "ZEN1 / ZEN2 / DZEN");
+        data += record("     2", "# OF FREQUENCIES");
+        snprintf(text, sizeof(text), "%6d%6d%6d%6d%6d%13.7f", 2000 + i % 2 * 10 + i / 64, 1, 1,
+                 0, 0, 0.0);
+        data += record(text, "VALID FROM");
+        if (i % 2 == 0) {
+            snprintf(text, sizeof(text), "%6d%6d%6d%6d%6d%13.7f", 2009 + i / 64, 12, 31, 23, 59,
+                     59.9999999);
+            data += record(text, "VALID UNTIL");
+        }
+
+        for (auto frequency : {"G01", "G02"}) {
+            snprintf(text, sizeof(text), "   %s", frequency);
+            data += record(text, "START OF FREQUENCY");
+            data += record("    394.00      0.00   1091.00", "NORTH / EAST / UP");
+            data += values_line("   NOAZI", i, 0, 13);
+            if (dazi > 0.0) {
+                for (int row = 0; row <= 12; row++) {
+                    char azimuth[16];
+                    snprintf(azimuth, sizeof(azimuth), "%8.1f", row * dazi);
+                    data += values_line(azimuth, i, row + 1, 13);
+                }
+            }
+            data += record(text, "END OF FREQUENCY");
+        }
+        data += record("", "END OF ANTENNA");
+    }
+    return data;
+}
+
+static void check_equal(Antex const& a, Antex const& b) {
+    CHECK(a.header.version == b.header.version);
+    CHECK(a.header.system == b.header.system);
+    CHECK(a.header.pcv_type == b.header.pcv_type);
+    REQUIRE(a.antennas.size() == b.antennas.size());
+    for (auto const& pair : a.antennas) {
+        auto it = b.antennas.find(pair.first);
+        REQUIRE(it != b.antennas.end());
+        REQUIRE(pair.second.size() == it->second.size());
+        for (size_t i = 0; i < pair.second.size(); i++) {
+            auto const& x = pair.second[i];
+            auto const& y = it->second[i];
+            CHECK(x.dazi == y.dazi);
+            CHECK(x.zen2 == y.zen2);
+            CHECK(x.valid_from_set == y.valid_from_set);
+            CHECK(x.valid_until_set == y.valid_until_set);
+            CHECK(x.valid_from.timestamp().seconds() == y.valid_from.timestamp().seconds());
+            CHECK(x.valid_until.timestamp().seconds() == y.valid_until.timestamp().seconds());
+            REQUIRE(x.frequencies.size() == y.frequencies.size());
+            for (size_t k = 0; k < x.frequencies.size(); k++) {
+                CHECK(x.frequencies[k].type == y.frequencies[k].type);
+                CHECK(x.frequencies[k].eccentricities.z == y.frequencies[k].eccentricities.z);
+                CHECK(x.frequencies[k].no_azimuth == y.frequencies[k].no_azimuth);
+                CHECK(x.frequencies[k].azimuths == y.frequencies[k].azimuths);
+            }
+        }
+    }
+}
+
 TEST_CASE("ANTEX parser - from_string") {
     auto antex = format::antex::Antex::from_string("     1.4            ANTEX VERSION / SYST\n");
     CHECK(antex != nullptr);
 }
+
+TEST_CASE("ANTEX parser - antenna blocks") {
+    // Enough blocks for the parallel parser
+    auto antex = Antex::from_string(make_antex(400));
+    REQUIRE(antex != nullptr);
+    CHECK(antex->header.version == "1.4");
+    CHECK(antex->header.system == "M");
+    CHECK(antex->header.pcv_type == "A");
+
+    size_t count = 0;
+    for (auto const& pair : antex->antennas) {
+        count += pair.second.size();
+        // The most recent antenna first
+        for (size_t i = 1; i < pair.second.size(); i++) {
+            CHECK(pair.second[i - 1].valid_from >= pair.second[i].valid_from);
+        }
+    }
+    CHECK(antex->antennas.size() == 32);
+    CHECK(count == 360);
+
+    auto const& antenna = antex->antennas.at(SatelliteId::from_gps_prn(1)).back();
+    REQUIRE(antenna.frequencies.size() == 2);
+    auto const* l2 = antenna.frequency(FrequencyType::L2);
+    REQUIRE(l2 != nullptr);
+    CHECK(l2->eccentricities.x == 394.0);
+    CHECK(l2->eccentricities.z == 1091.0);
+    CHECK(l2->no_azimuth.size() == 13);
+    CHECK(l2->azimuth_count() == 13);
+    CHECK(l2->azimuth_row(2)[4] == doctest::Approx(-1.0 + 0.03));
+    CHECK(antenna.frequency(FrequencyType::L5) == nullptr);
+
+    // Parsing again gives the same result
+    auto again = Antex::from_string(make_antex(400));
+    REQUIRE(again != nullptr);
+    check_equal(*antex, *again);
+}
+
+TEST_CASE("ANTEX parser - phase variation") {
+    auto antex = Antex::from_string(make_antex(4));
+    REQUIRE(antex != nullptr);
+
+    // Antenna 0: valid 2000-01-01 to 2009-12-31, azimuth dependent
+    PhaseVariation phase_variation{};
+    auto           time = ts::Tai{ts::Gps::from_ymdhms(2005, 6, 1, 0, 0, 0.0)};
+    auto           deg  = 3.1415926535897932 / 180.0;
+    REQUIRE(antex->phase_variation(SatelliteId::from_gps_prn(1), SignalId::GPS_L1_CA, time,
+                                   60.0 * deg, 4.0 * deg, phase_variation));
+    CHECK(phase_variation.value == doctest::Approx((0.0 - 1.0 + 0.03) * 1e-3));
+
+    // Antenna 1: valid from 2010-01-01
+    time = ts::Tai{ts::Gps::from_ymdhms(2012, 6, 1, 0, 0, 0.0)};
+    REQUIRE(antex->phase_variation(SatelliteId::from_gps_prn(1), SignalId::GPS_L1_CA, time,
+                                   60.0 * deg, 4.0 * deg, phase_variation));
+    CHECK(phase_variation.value == doctest::Approx((1.0 - 1.0) * 1e-3));
+
+    // Before the first antenna
+    time = ts::Tai{ts::Gps::from_ymdhms(1999, 6, 1, 0, 0, 0.0)};
+    CHECK_FALSE(antex->phase_variation(SatelliteId::from_gps_prn(1), SignalId::GPS_L1_CA, time,
+                                       60.0 * deg, 4.0 * deg, phase_variation));
+}
+
+TEST_CASE("ANTEX parser - errors") {
+    auto data = make_antex(200);
+    auto at   = data.find("   NOAZI", data.find("BLOCK IIF           G05"));
+    REQUIRE(at != std::string::npos);
+    data[at + 12] = 'x';
+    CHECK(Antex::from_string(data) == nullptr);
+}
+
+TEST_CASE("ANTEX parser - snapshot") {
+    auto antex = Antex::from_string(make_antex(150));
+    REQUIRE(antex != nullptr);
+
+    auto buffer = antex->to_snapshot();
+    auto loaded = Antex::from_snapshot(buffer.data(), buffer.size());
+    REQUIRE(loaded != nullptr);
+    check_equal(*antex, *loaded);
+
+    // Truncated snapshots are rejected
+    CHECK(Antex::from_snapshot(buffer.data(), buffer.size() / 2) == nullptr);
+
+    std::string path          = "/tmp/test_antex_snapshot.atx";
+    std::string snapshot_path = "/tmp/test_antex_snapshot.atx.snapshot";
+    remove(snapshot_path.c_str());
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file << make_antex(150);
+    }
+
+    auto first = Antex::from_file_cached(path, snapshot_path);
+    REQUIRE(first != nullptr);
+    check_equal(*antex, *first);
+
+    auto second = Antex::from_file_cached(path, snapshot_path);
+    REQUIRE(second != nullptr);
+    check_equal(*antex, *second);
+
+    // A changed file invalidates the snapshot
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file << make_antex(40);
+    }
+    auto changed = Antex::from_file_cached(path, snapshot_path);
+    REQUIRE(changed != nullptr);
+    check_equal(*Antex::from_string(make_antex(40)), *changed);
+
+    // A corrupt snapshot of the current file is ignored
+    {
+        std::ofstream file{snapshot_path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(40);
+        file << "garbage";
+    }
+    auto corrupt = Antex::from_file_cached(path, snapshot_path);
+    REQUIRE(corrupt != nullptr);
+    check_equal(*changed, *corrupt);
+
+    remove(path.c_str());
+    remove(snapshot_path.c_str());
+}
@@ -0,0 +1,98 @@
+#include <doctest/doctest.h>
+#include <format/checksum/checksum.hpp>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace format::checksum;
+
+static uint32_t reference_crc(uint8_t const* data, size_t length, uint32_t poly, int degree) {
+    uint32_t mask = degree == 32 ? 0xFFFFFFFFu : ((1u << degree) - 1u);
+    uint32_t crc  = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= static_cast<uint32_t>(data[i]) << (degree - 8);
+        for (int j = 0; j < 8; j++) {
+            if (crc & (1u << (degree - 1))) {
+                crc = ((crc << 1) ^ poly) & mask;
+            } else {
+                crc = (crc << 1) & mask;
+            }
+        }
+    }
+    return crc;
+}
+
+static uint16_t reference_fletcher8(uint8_t const* data, size_t length) {
+    uint8_t ck_a = 0;
+    uint8_t ck_b = 0;
+    for (size_t i = 0; i < length; i++) {
+        ck_a = static_cast<uint8_t>(ck_a + data[i]);
+        ck_b = static_cast<uint8_t>(ck_b + ck_a);
+    }
+    return static_cast<uint16_t>((ck_b << 8) | ck_a);
+}
+
+static std::vector<uint8_t> random_bytes(std::mt19937& rng, size_t length) {
+    std::vector<uint8_t> data(length);
+    for (auto& byte : data)
+        byte = static_cast<uint8_t>(rng());
+    return data;
+}
+
+static Implementation const IMPLEMENTATIONS[] = {
+    Implementation::Best,
+    Implementation::Bytewise,
+    Implementation::Slice8,
+    Implementation::Simd,
+};
+
+TEST_CASE("Checksum - check values") {
+    auto data   = reinterpret_cast<uint8_t const*>("123456789");
+    auto length = strlen("123456789");
+
+    CHECK(crc24q(data, length) == 0xCDE703);
+    CHECK(crc16_ccitt(data, length) == 0x31C3);
+    CHECK(crc8(data, length) == 0xF4);
+    CHECK(fletcher8(data, length) == reference_fletcher8(data, length));
+
+    CHECK(crc24q(data, 0) == 0);
+    CHECK(crc16_ccitt(data, 0) == 0);
+    CHECK(fletcher8(data, 0) == 0);
+}
+
+TEST_CASE("Checksum - implementations agree") {
+    std::mt19937 rng(1234);
+    for (size_t length = 0; length < 2000; length += 1 + length / 16) {
+        CAPTURE(length);
+        // Offset the buffer by one to exercise unaligned loads.
+        auto buffer = random_bytes(rng, length + 1);
+        auto data   = buffer.data() + 1;
+
+        auto expected_24q = reference_crc(data, length, 0x864CFB, 24);
+        auto expected_16  = reference_crc(data, length, 0x1021, 16);
+        auto expected_8   = reference_crc(data, length, 0x07, 8);
+        auto expected_f8  = reference_fletcher8(data, length);
+
+        CHECK(crc8(data, length) == expected_8);
+        for (auto implementation : IMPLEMENTATIONS) {
+            CAPTURE(static_cast<int>(implementation));
+            CHECK(crc24q(data, length, implementation) == expected_24q);
+            CHECK(crc16_ccitt(data, length, implementation) == expected_16);
+            CHECK(fletcher8(data, length, implementation) == expected_f8);
+        }
+    }
+}
+
+TEST_CASE("Checksum - RTCM frame") {
+    // Appending the CRC-24Q to a frame makes the CRC over the whole frame zero.
+    uint8_t frame[] = {0xD3, 0x00, 0x13, 0x3E, 0xD0, 0x00, 0x03, 0x8A, 0x0E, 0xDE, 0xEF,
+                       0x34, 0xB4, 0xBD, 0x62, 0xAC, 0x09, 0x41, 0x98, 0x6F, 0x33, 0x36,
+                       0x0B, 0x98, 0x00, 0x00, 0x00};
+    auto length     = sizeof(frame) - 3;
+    auto crc        = crc24q(frame, length);
+    frame[length + 0] = static_cast<uint8_t>(crc >> 16);
+    frame[length + 1] = static_cast<uint8_t>(crc >> 8);
+    frame[length + 2] = static_cast<uint8_t>(crc);
+    CHECK(crc24q(frame, sizeof(frame)) == 0);
+}
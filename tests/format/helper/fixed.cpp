@@ -0,0 +1,97 @@
+#include <doctest/doctest.h>
+#include <format/helper/fixed.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace format::helper;
+
+static bool parse(std::string const& text, double& value) {
+    return parse_double(text.data(), text.data() + text.size(), value);
+}
+
+static bool same_bits(double a, double b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+TEST_CASE("parse_double - same result as strtod") {
+    std::mt19937                           rng(3);
+    std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+    std::uniform_int_distribution<int>     exponent(-30, 30);
+
+    // ANTEX "%8.2f", RINEX "%19.12E" and full precision "%.17g"
+    char const* formats[] = {"%8.2f", "%19.12E", "%.17g", "%.6e", "%12.4f"};
+    for (int i = 0; i < 20000; i++) {
+        auto value = mantissa(rng) * std::pow(10.0, exponent(rng));
+        for (auto format : formats) {
+            char text[64];
+            snprintf(text, sizeof(text), format, value);
+
+            double parsed = 0.0;
+            CAPTURE(text);
+            REQUIRE(parse(text, parsed));
+            REQUIRE(same_bits(parsed, strtod(text, nullptr)));
+        }
+    }
+}
+
+TEST_CASE("parse_double - fixed-width fields") {
+    double value = 0.0;
+    CHECK(parse("-5.798246711490D-04", value));
+    CHECK(same_bits(value, -5.798246711490e-04));
+    CHECK(parse(" 4.177377559240d+02 ", value));
+    CHECK(same_bits(value, 4.177377559240e+02));
+    CHECK(parse("   -0.80", value));
+    CHECK(same_bits(value, -0.80));
+    CHECK(parse("  +.5", value));
+    CHECK(value == 0.5);
+    CHECK(parse("7.", value));
+    CHECK(value == 7.0);
+    CHECK(parse("-0.000", value));
+    CHECK(same_bits(value, -0.0));
+    CHECK(parse("0.000000000000E+00", value));
+    CHECK(same_bits(value, 0.0));
+    CHECK(parse("1E400", value));
+    CHECK(value == HUGE_VAL);
+    CHECK(parse("12345678901234567890123", value));
+    CHECK(same_bits(value, 12345678901234567890123.0));
+
+    CHECK_FALSE(parse("", value));
+    CHECK_FALSE(parse("      ", value));
+    CHECK_FALSE(parse(".", value));
+    CHECK_FALSE(parse("-", value));
+    CHECK_FALSE(parse("1.0E", value));
+    CHECK_FALSE(parse("1.0E+", value));
+    CHECK_FALSE(parse("1.0-05", value));
+    CHECK_FALSE(parse("1 2", value));
+    CHECK_FALSE(parse("0x10", value));
+}
+
+TEST_CASE("parse_int and columns") {
+    int64_t value = 0;
+    CHECK(parse_int("  2026", "  2026" + 6, value));
+    CHECK(value == 2026);
+    CHECK(parse_int(" -12 ", " -12 " + 5, value));
+    CHECK(value == -12);
+    CHECK_FALSE(parse_int("  ", "  " + 2, value));
+    CHECK_FALSE(parse_int("1.5", "1.5" + 3, value));
+    CHECK_FALSE(parse_int("99999999999999999999", "99999999999999999999" + 20, value));
+
+    std::string line = "G10 2026 06 06 00 00 00-5.798246711490E-04";
+    CHECK(column_int(line.data(), line.size(), 1, 2, value));
+    CHECK(value == 10);
+    CHECK(column_int(line.data(), line.size(), 4, 4, value));
+    CHECK(value == 2026);
+
+    double number = 0.0;
+    CHECK(column_double(line.data(), line.size(), 23, 19, number));
+    CHECK(same_bits(number, -5.798246711490e-04));
+    // Past the end of the line the column is blank
+    CHECK_FALSE(column_double(line.data(), line.size(), 42, 19, number));
+    CHECK(column_double(line.data(), line.size(), 39, 19, number));
+    CHECK(number == -4.0);
+}
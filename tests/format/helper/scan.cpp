@@ -0,0 +1,237 @@
+#include <doctest/doctest.h>
+#include <format/checksum/checksum.hpp>
+#include <format/helper/demux.hpp>
+#include <format/helper/scan.hpp>
+#include <format/nmea/message.hpp>
+#include <format/nmea/parser.hpp>
+#include <format/rtcm/message.hpp>
+#include <format/rtcm/parser.hpp>
+#include <format/ubx/message.hpp>
+#include <format/ubx/parser.hpp>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace format::helper;
+
+static size_t reference_frame_start(std::vector<uint8_t> const& data, uint32_t formats) {
+    for (size_t i = 0; i < data.size(); i++) {
+        if ((formats & FRAME_RTCM) && data[i] == 0xD3) return i;
+        if ((formats & FRAME_NMEA) && data[i] == '$') return i;
+        if ((formats & FRAME_UBX) && data[i] == 0xB5 &&
+            (i + 1 == data.size() || data[i + 1] == 0x62))
+            return i;
+    }
+    return data.size();
+}
+
+static std::vector<uint8_t> rtcm_frame(uint16_t type, size_t payload_length) {
+    std::vector<uint8_t> frame(3 + payload_length + 3, 0x11);
+    frame[0] = 0xD3;
+    frame[1] = static_cast<uint8_t>(payload_length >> 8);
+    frame[2] = static_cast<uint8_t>(payload_length);
+    frame[3] = static_cast<uint8_t>(type >> 4);
+    frame[4] = static_cast<uint8_t>(type << 4);
+    // embed other preambles inside the payload, they must not be picked up
+    frame[5] = 0xB5;
+    frame[6] = 0x62;
+    frame[7] = '$';
+    auto crc = format::checksum::crc24q(frame.data(), frame.size() - 3);
+    frame[frame.size() - 3] = static_cast<uint8_t>(crc >> 16);
+    frame[frame.size() - 2] = static_cast<uint8_t>(crc >> 8);
+    frame[frame.size() - 1] = static_cast<uint8_t>(crc);
+    return frame;
+}
+
+static std::vector<uint8_t> ubx_frame(uint8_t message_class, uint8_t message_id,
+                                      size_t payload_length) {
+    std::vector<uint8_t> frame(6 + payload_length + 2, 0xD3);
+    frame[0] = 0xB5;
+    frame[1] = 0x62;
+    frame[2] = message_class;
+    frame[3] = message_id;
+    frame[4] = static_cast<uint8_t>(payload_length);
+    frame[5] = static_cast<uint8_t>(payload_length >> 8);
+    auto ck  = format::checksum::fletcher8(frame.data() + 2, frame.size() - 4);
+    frame[frame.size() - 2] = static_cast<uint8_t>(ck);
+    frame[frame.size() - 1] = static_cast<uint8_t>(ck >> 8);
+    return frame;
+}
+
+static std::vector<uint8_t> nmea_frame() {
+    char const* sentence = "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n";
+    return std::vector<uint8_t>(sentence, sentence + strlen(sentence));
+}
+
+static void append(std::vector<uint8_t>& stream, std::vector<uint8_t> const& data) {
+    stream.insert(stream.end(), data.begin(), data.end());
+}
+
+TEST_CASE("Scan - find_frame_start matches reference") {
+    std::mt19937 rng(99);
+    uint8_t const alphabet[] = {0x00, 0xD3, 0xB5, 0x62, '$', 0x41, 0xFF};
+    for (size_t length = 0; length < 200; length++) {
+        std::vector<uint8_t> data(length);
+        for (auto& byte : data)
+            byte = alphabet[rng() % sizeof(alphabet)];
+        // make most buffers mostly noise so the vector path is exercised
+        if (length % 3 != 0) {
+            for (auto& byte : data)
+                if (byte != 0xB5 || rng() % 8 != 0) byte = static_cast<uint8_t>(byte & 0x0F);
+        }
+
+        for (uint32_t formats = 1; formats < 8; formats++) {
+            CAPTURE(length);
+            CAPTURE(formats);
+            CHECK(find_frame_start(data.data(), data.size(), formats) ==
+                  reference_frame_start(data, formats));
+        }
+
+        auto expected = data.size();
+        for (size_t i = 0; i < data.size(); i++) {
+            if (data[i] == '\n' || data[i] == '$') {
+                expected = i;
+                break;
+            }
+        }
+        CHECK(find_byte(data.data(), data.size(), '\n', '$') == expected);
+    }
+}
+
+TEST_CASE("Scan - parsers resynchronize after noise") {
+    std::vector<uint8_t> noise(300, 0x00);
+    noise[10]  = 0xD3;  // RTCM preamble with invalid padding bits
+    noise[11]  = 0xFF;
+    noise[100] = 0xB5;  // UBX sync char without the second byte
+    noise[200] = '$';   // NMEA start without a line ending before the next '$'
+
+    SUBCASE("rtcm") {
+        std::vector<uint8_t> stream = noise;
+        append(stream, rtcm_frame(1005, 19));
+        append(stream, noise);
+        append(stream, rtcm_frame(1077, 40));
+
+        format::rtcm::Parser parser;
+        parser.append(stream.data(), stream.size());
+        auto first  = parser.try_parse();
+        auto second = parser.try_parse();
+        REQUIRE(first != nullptr);
+        REQUIRE(second != nullptr);
+        CHECK(first->type() == 1005);
+        CHECK(second->type() == 1077);
+        CHECK(parser.try_parse() == nullptr);
+    }
+
+    SUBCASE("ubx") {
+        std::vector<uint8_t> stream = noise;
+        append(stream, ubx_frame(0x05, 0x01, 2));
+        append(stream, noise);
+        append(stream, ubx_frame(0x01, 0x99, 100));
+
+        format::ubx::Parser parser;
+        parser.append(stream.data(), stream.size());
+        auto first  = parser.try_parse();
+        auto second = parser.try_parse();
+        REQUIRE(first != nullptr);
+        REQUIRE(second != nullptr);
+        CHECK(first->message_class() == 0x05);
+        CHECK(second->message_id() == 0x99);
+        CHECK(parser.try_parse() == nullptr);
+    }
+
+    SUBCASE("nmea") {
+        std::vector<uint8_t> stream = noise;
+        append(stream, nmea_frame());
+        append(stream, noise);
+        append(stream, nmea_frame());
+
+        format::nmea::Parser parser;
+        parser.append(stream.data(), stream.size());
+        CHECK(parser.try_parse() != nullptr);
+        CHECK(parser.try_parse() != nullptr);
+        CHECK(parser.try_parse() == nullptr);
+    }
+}
+
+TEST_CASE("Scan - parser ring buffer wrap around") {
+    // Feed enough data that frames straddle the end of the parser ring buffer.
+    format::ubx::Parser  parser;
+    auto                 frame = ubx_frame(0x01, 0x98, 1000);
+    std::vector<uint8_t> garbage(333, 0x55);
+    size_t               parsed = 0;
+    for (int i = 0; i < 400; i++) {
+        parser.append(garbage.data(), garbage.size());
+        parser.append(frame.data(), frame.size());
+        while (auto message = parser.try_parse()) {
+            CHECK(message->message_class() == 0x01);
+            parsed++;
+        }
+    }
+    CHECK(parsed == 400);
+}
+
+TEST_CASE("Scan - demultiplexer") {
+    auto rtcm = rtcm_frame(1005, 19);
+    auto ubx  = ubx_frame(0x02, 0x15, 64);
+    auto nmea = nmea_frame();
+
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> noise(50, 0x24);  // '$' repeated, never a complete sentence
+    noise.back() = 0x00;
+
+    std::vector<uint32_t> expected;
+    for (int i = 0; i < 20; i++) {
+        append(stream, noise);
+        switch (i % 3) {
+        case 0:
+            append(stream, rtcm);
+            expected.push_back(FRAME_RTCM);
+            break;
+        case 1:
+            append(stream, ubx);
+            expected.push_back(FRAME_UBX);
+            break;
+        default:
+            append(stream, nmea);
+            expected.push_back(FRAME_NMEA);
+            break;
+        }
+    }
+
+    SUBCASE("all formats") {
+        Demultiplexer         demux{FRAME_RTCM | FRAME_UBX | FRAME_NMEA};
+        std::vector<uint32_t> formats;
+        // feed in odd sized chunks so frames are split across appends
+        for (size_t i = 0; i < stream.size(); i += 37) {
+            auto length = std::min<size_t>(37, stream.size() - i);
+            demux.append(stream.data() + i, length);
+            Frame frame{};
+            while (demux.next(frame)) {
+                formats.push_back(frame.format);
+                if (frame.format == FRAME_RTCM) CHECK(frame.length == rtcm.size());
+                if (frame.format == FRAME_UBX) CHECK(frame.length == ubx.size());
+                if (frame.format == FRAME_NMEA) CHECK(frame.length == nmea.size());
+            }
+        }
+        CHECK(formats.size() == expected.size());
+        CHECK(formats == expected);
+        CHECK(demux.discarded() == 20 * noise.size());
+    }
+
+    SUBCASE("subset") {
+        // The UBX sync chars inside the RTCM payload are only rejected once enough data has
+        // arrived to check the (bogus) length and checksum, so flush with padding.
+        std::vector<uint8_t> padding(8192, 0x00);
+        Demultiplexer        demux{FRAME_UBX};
+        demux.append(stream.data(), stream.size());
+        demux.append(padding.data(), padding.size());
+        Frame  frame{};
+        size_t count = 0;
+        while (demux.next(frame)) {
+            CHECK(frame.format == FRAME_UBX);
+            count++;
+        }
+        CHECK(count == 7);
+    }
+}
@@ -27,3 +27,22 @@ TEST_CASE("NMEA parser - incomplete message") {
     auto message = parser.try_parse();
     CHECK(message == nullptr);
 }
+
+TEST_CASE("NMEA parser - try_parse_into reuses message") {
+    format::nmea::Parser parser;
+    char const*          msg =
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+        "$GPRMC,123520,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*60\r\n";
+    parser.append(reinterpret_cast<uint8_t const*>(msg), std::strlen(msg));
+
+    std::unique_ptr<format::nmea::Message> message;
+    REQUIRE(parser.try_parse_into(message));
+    auto pointer = message.get();
+    CHECK(message->prefix() == "GPRMC");
+
+    REQUIRE(parser.try_parse_into(message));
+    CHECK(message.get() == pointer);
+    CHECK(message->payload().compare(0, 6, "123520") == 0);
+
+    CHECK(!parser.try_parse_into(message));
+}
@@ -2,6 +2,8 @@
 #include <format/rinex/nav_reader.hpp>
 
 #include <cmath>
+#include <cstdio>
+#include <string>
 
 static char const* TEST_NAV_FILE = "tests/corpus/rinex/nav_mixed.nav";
 
@@ -57,3 +59,30 @@ TEST_CASE("RINEX nav reader - nonexistent file") {
     CHECK(nav.gal.empty());
     CHECK(nav.bds.empty());
 }
+
+TEST_CASE("RINEX nav reader - snapshot") {
+    auto nav = format::rinex::parse_nav_file(TEST_NAV_FILE);
+
+    std::string snapshot_path = "/tmp/test_rinex_nav.snapshot";
+    remove(snapshot_path.c_str());
+
+    // The first load writes the snapshot and the second loads it
+    for (int i = 0; i < 2; i++) {
+        auto cached = format::rinex::parse_nav_file_cached(TEST_NAV_FILE, snapshot_path);
+        REQUIRE(cached.gps.size() == nav.gps.size());
+        REQUIRE(cached.gal.size() == nav.gal.size());
+        REQUIRE(cached.bds.size() == nav.bds.size());
+        for (size_t j = 0; j < nav.gps.size(); j++) {
+            CHECK(cached.gps[j].prn == nav.gps[j].prn);
+            CHECK(cached.gps[j].iodc == nav.gps[j].iodc);
+            CHECK(cached.gps[j].af0 == nav.gps[j].af0);
+            CHECK(cached.gps[j].a == nav.gps[j].a);
+        }
+        CHECK(cached.gal[0].iod_nav == nav.gal[0].iod_nav);
+        CHECK(cached.bds[0].toe == nav.bds[0].toe);
+        CHECK(cached.bds[0].toe_time.timestamp().seconds() ==
+              nav.bds[0].toe_time.timestamp().seconds());
+    }
+
+    remove(snapshot_path.c_str());
+}
@@ -1,7 +1,11 @@
 #include <doctest/doctest.h>
+#include <format/checksum/checksum.hpp>
 #include <format/rtcm/message.hpp>
 #include <format/rtcm/parser.hpp>
 
+#include <cstring>
+#include <vector>
+
 TEST_CASE("RTCM parser - invalid preamble") {
     format::rtcm::Parser parser;
     uint8_t const        msg[] = {0xFF, 0x00, 0x13, 0x3E, 0xD0};
@@ -25,3 +29,99 @@ TEST_CASE("RTCM parser - preamble only") {
     auto message = parser.try_parse();
     CHECK(message == nullptr);
 }
+
+static std::vector<uint8_t> rtcm_frame(uint16_t type, uint16_t payload_length, uint8_t fill) {
+    std::vector<uint8_t> frame(payload_length + 6u, fill);
+    frame[0] = 0xD3;
+    frame[1] = static_cast<uint8_t>((payload_length >> 8) & 0x03);
+    frame[2] = static_cast<uint8_t>(payload_length & 0xFF);
+    frame[3] = static_cast<uint8_t>(type >> 4);
+    frame[4] = static_cast<uint8_t>(((type & 0x0F) << 4) | (fill & 0x0F));
+    auto crc = format::checksum::crc24q(frame.data(), payload_length + 3u);
+    frame[payload_length + 3u] = static_cast<uint8_t>(crc >> 16);
+    frame[payload_length + 4u] = static_cast<uint8_t>(crc >> 8);
+    frame[payload_length + 5u] = static_cast<uint8_t>(crc);
+    return frame;
+}
+
+TEST_CASE("RTCM parser - try_parse_into reuses message") {
+    format::rtcm::Parser parser;
+    auto                 first  = rtcm_frame(1077, 40, 0x11);
+    auto                 second = rtcm_frame(1077, 60, 0x22);
+    auto                 other  = rtcm_frame(1127, 20, 0x33);
+    parser.append(first.data(), static_cast<uint32_t>(first.size()));
+    parser.append(second.data(), static_cast<uint32_t>(second.size()));
+    parser.append(other.data(), static_cast<uint32_t>(other.size()));
+    parser.append(first.data(), static_cast<uint32_t>(first.size()));
+
+    std::unique_ptr<format::rtcm::Message> message;
+    REQUIRE(parser.try_parse_into(message));
+    auto pointer = message.get();
+    CHECK(message->type() == 1077);
+    CHECK(message->data() == first);
+
+    REQUIRE(parser.try_parse_into(message));
+    CHECK(message.get() == pointer);
+    CHECK(message->data() == second);
+
+    REQUIRE(parser.try_parse_into(message));
+    CHECK(message.get() != pointer);
+    CHECK(message->type() == 1127);
+
+    REQUIRE(parser.try_parse_into(message));
+    CHECK(message.get() == pointer);
+    CHECK(message->data() == first);
+
+    CHECK(!parser.try_parse_into(message));
+}
+
+TEST_CASE("RTCM parser - pooled messages") {
+    auto                                   frame = rtcm_frame(1077, 100, 0x44);
+    std::unique_ptr<format::rtcm::Message> survivor;
+    {
+        format::rtcm::Parser parser;
+        parser.set_pooled(true);
+
+        for (int i = 0; i < 4; i++) {
+            parser.append(frame.data(), static_cast<uint32_t>(frame.size()));
+            auto message = parser.try_parse();
+            REQUIRE(message != nullptr);
+            CHECK(message->data() == frame);
+        }
+        CHECK(parser.pool()->stats().hits >= 3);
+
+        parser.append(frame.data(), static_cast<uint32_t>(frame.size()));
+        survivor = parser.try_parse();
+        REQUIRE(survivor != nullptr);
+    }
+
+    auto clone = survivor->clone();
+    survivor.reset();
+    CHECK(clone->type() == 1077);
+    CHECK(clone->data() == frame);
+}
+
+TEST_CASE("RTCM parser - read into write space") {
+    format::rtcm::Parser parser;
+    auto                 frame = rtcm_frame(1077, 40, 0x11);
+
+    // Write the frame in two parts, as two reads would
+    uint8_t* space  = nullptr;
+    auto     length = parser.write_space(space);
+    REQUIRE(length >= frame.size());
+    CHECK(parser.contains(space));
+    memcpy(space, frame.data(), 10);
+    parser.commit(10);
+    CHECK(parser.try_parse() == nullptr);
+
+    length = parser.write_space(space);
+    REQUIRE(length >= frame.size() - 10);
+    memcpy(space, frame.data() + 10, frame.size() - 10);
+    parser.commit(static_cast<uint32_t>(frame.size() - 10));
+    CHECK(parser.buffer_length() == frame.size());
+
+    auto message = parser.try_parse();
+    REQUIRE(message != nullptr);
+    CHECK(message->type() == 1077);
+    CHECK_FALSE(parser.contains(frame.data()));
+}
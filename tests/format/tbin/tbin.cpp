@@ -0,0 +1,341 @@
+#include <doctest/doctest.h>
+#include <format/tbin/block.hpp>
+#include <format/tbin/lz.hpp>
+#include <format/tbin/merger.hpp>
+#include <format/tbin/reader.hpp>
+#include <format/tbin/writer.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace format::tbin;
+
+// Something like a receiver stream, mostly repeated structure with a few changing bytes.
+static std::vector<Message> sample_messages(size_t count) {
+    std::mt19937         rng(7);
+    std::vector<Message> messages;
+    for (size_t i = 0; i < count; i++) {
+        Message message{};
+        message.timestamp_us = 1700000000000000ll + static_cast<int64_t>(i) * 50000;
+        message.data         = {0xB5, 0x62, 0x02, 0x15};
+        auto length          = 16 + (rng() % 200);
+        for (size_t j = 0; j < length; j++) {
+            message.data.push_back(j % 16 == 0 ? static_cast<uint8_t>(rng()) :
+                                                 static_cast<uint8_t>(j));
+        }
+        messages.push_back(std::move(message));
+    }
+    // Out of order timestamps must survive the delta encoding
+    messages[3].timestamp_us -= 1000000;
+    return messages;
+}
+
+static std::vector<Message> read_all(std::string const& path, Reader& reader) {
+    std::vector<Message> messages;
+    REQUIRE(reader.open(path));
+    Message message{};
+    while (reader.next(message)) {
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+static void check_equal(std::vector<Message> const& a, std::vector<Message> const& b) {
+    REQUIRE(a.size() == b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        CHECK(a[i].timestamp_us == b[i].timestamp_us);
+        CHECK(a[i].data == b[i].data);
+    }
+}
+
+static long file_size(std::string const& path) {
+    auto file = fopen(path.c_str(), "rb");
+    REQUIRE(file);
+    fseek(file, 0, SEEK_END);
+    auto size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+TEST_CASE("tbin lz - round trip") {
+    std::mt19937 rng(1);
+    for (size_t size : {0, 1, 3, 4, 15, 16, 100, 4096, 70000}) {
+        CAPTURE(size);
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++) {
+            // Alternate between random and repeating runs to exercise literals and matches
+            data[i] = (i / 64) % 2 ? static_cast<uint8_t>(rng()) : static_cast<uint8_t>(i % 7);
+        }
+
+        lz::Compressor       compressor;
+        std::vector<uint8_t> compressed(lz::compress_bound(size));
+        auto length = compressor.compress(data.data(), size, compressed.data(), compressed.size());
+        REQUIRE(length > 0);
+
+        std::vector<uint8_t> decompressed(size);
+        CHECK(lz::decompress(compressed.data(), length, decompressed.data(), size));
+        CHECK(decompressed == data);
+
+        // Truncated input must be rejected, not read out of bounds
+        if (length > 1) {
+            CHECK_FALSE(lz::decompress(compressed.data(), length - 1, decompressed.data(), size));
+        }
+    }
+}
+
+TEST_CASE("tbin - v1 and v2 round trip") {
+    auto messages = sample_messages(2000);
+
+    std::string v1_path = "/tmp/test_tbin_v1.tbin";
+    std::string v2_path = "/tmp/test_tbin_v2.tbin";
+
+    Writer v1;
+    REQUIRE(v1.open(v1_path, "ubx"));
+    Writer v2;
+    REQUIRE(v2.open(v2_path, "ubx", VERSION_2, 16 * 1024));
+    for (auto& message : messages) {
+        auto length = static_cast<uint32_t>(message.data.size());
+        v1.write(message.timestamp_us, message.data.data(), length);
+        v2.write(message.timestamp_us, message.data.data(), length);
+    }
+    v1.close();
+    v2.close();
+
+    Reader v1_reader;
+    check_equal(read_all(v1_path, v1_reader), messages);
+    CHECK(v1_reader.version() == 1);
+    CHECK(v1_reader.stream_id() == "ubx");
+
+    Reader v2_reader;
+    check_equal(read_all(v2_path, v2_reader), messages);
+    CHECK(v2_reader.version() == 2);
+    CHECK(v2_reader.stream_id() == "ubx");
+    CHECK(v2_reader.corrupt_blocks() == 0);
+
+    CHECK(file_size(v2_path) * 2 < file_size(v1_path));
+
+    remove(v1_path.c_str());
+    remove(v2_path.c_str());
+}
+
+TEST_CASE("tbin - v2 corrupt block is skipped") {
+    auto        messages = sample_messages(600);
+    std::string path     = "/tmp/test_tbin_corrupt.tbin";
+
+    Writer writer;
+    REQUIRE(writer.open(path, "ubx", VERSION_2, 1024));
+    for (auto& message : messages) {
+        writer.write(message.timestamp_us, message.data.data(),
+                     static_cast<uint32_t>(message.data.size()));
+    }
+    writer.close();
+
+    // Flip a byte in the body of the first block
+    auto file = fopen(path.c_str(), "r+b");
+    REQUIRE(file);
+    fseek(file, 6 + 3 + BLOCK_HEADER_SIZE + 10, SEEK_SET);
+    auto byte = fgetc(file);
+    fseek(file, -1, SEEK_CUR);
+    fputc(byte ^ 0xFF, file);
+    fclose(file);
+
+    Reader reader;
+    auto   read = read_all(path, reader);
+    CHECK(reader.corrupt_blocks() == 1);
+    REQUIRE(!read.empty());
+    CHECK(read.size() < messages.size());
+    CHECK(read.back().data == messages.back().data);
+
+    remove(path.c_str());
+}
+
+TEST_CASE("tbin - v2 damaged block header resyncs") {
+    auto        messages = sample_messages(600);
+    std::string path     = "/tmp/test_tbin_resync.tbin";
+
+    Writer writer;
+    REQUIRE(writer.open(path, "ubx", VERSION_2, 1024));
+    for (auto& message : messages) {
+        writer.write(message.timestamp_us, message.data.data(),
+                     static_cast<uint32_t>(message.data.size()));
+    }
+    writer.close();
+
+    // Break the magic and the stored size of the first block
+    auto file = fopen(path.c_str(), "r+b");
+    REQUIRE(file);
+    fseek(file, 6 + 3, SEEK_SET);
+    fputc('X', file);
+    fseek(file, 6 + 3 + 20, SEEK_SET);
+    fputc(0xFF, file);
+    fputc(0xFF, file);
+    fclose(file);
+
+    Reader reader;
+    auto   read = read_all(path, reader);
+    CHECK(reader.corrupt_blocks() == 1);
+    REQUIRE(!read.empty());
+    CHECK(read.size() < messages.size());
+    CHECK(read.back().data == messages.back().data);
+
+    remove(path.c_str());
+}
+
+TEST_CASE("tbin - v2 append") {
+    auto        messages = sample_messages(300);
+    std::string path     = "/tmp/test_tbin_append.tbin";
+    remove(path.c_str());
+
+    Writer first;
+    REQUIRE(first.append(path, "ubx", 2048));
+    for (size_t i = 0; i < 100; i++) {
+        first.write(messages[i].timestamp_us, messages[i].data.data(),
+                    static_cast<uint32_t>(messages[i].data.size()));
+    }
+    first.close();
+
+    // Simulate a crash in the middle of writing a block
+    auto file = fopen(path.c_str(), "ab");
+    REQUIRE(file);
+    fwrite("TBLK\x01\x02\x03", 1, 7, file);
+    fclose(file);
+
+    Writer second;
+    REQUIRE(second.append(path, "ubx", 2048));
+    for (size_t i = 100; i < messages.size(); i++) {
+        second.write(messages[i].timestamp_us, messages[i].data.data(),
+                     static_cast<uint32_t>(messages[i].data.size()));
+    }
+    second.close();
+
+    Reader reader;
+    check_equal(read_all(path, reader), messages);
+    CHECK(reader.corrupt_blocks() == 0);
+
+    SUBCASE("v1 files are not appended to") {
+        std::string v1_path = "/tmp/test_tbin_append_v1.tbin";
+        Writer      v1;
+        REQUIRE(v1.open(v1_path, "ubx"));
+        v1.close();
+
+        Writer writer;
+        CHECK_FALSE(writer.append(v1_path, "ubx"));
+
+        bool has_header = false;
+        CHECK_FALSE(prepare_append(v1_path, VERSION_2, has_header));
+        CHECK_FALSE(prepare_append(path, VERSION_1, has_header));
+        remove(v1_path.c_str());
+    }
+
+    SUBCASE("v1 partial record is truncated") {
+        std::string v1_path = "/tmp/test_tbin_append_v1.tbin";
+        Writer      v1;
+        REQUIRE(v1.open(v1_path, "ubx"));
+        v1.write(messages[0].timestamp_us, messages[0].data.data(),
+                 static_cast<uint32_t>(messages[0].data.size()));
+        v1.close();
+        auto size = file_size(v1_path);
+
+        auto partial = fopen(v1_path.c_str(), "ab");
+        REQUIRE(partial);
+        fwrite("\x01\x02\x03\x04\x05", 1, 5, partial);
+        fclose(partial);
+
+        bool has_header = false;
+        CHECK(prepare_append(v1_path, VERSION_1, has_header));
+        CHECK(has_header);
+        CHECK(file_size(v1_path) == size);
+        remove(v1_path.c_str());
+    }
+
+    SUBCASE("missing file needs a header") {
+        bool has_header = true;
+        CHECK(prepare_append("/tmp/test_tbin_append_missing.tbin", VERSION_1, has_header));
+        CHECK_FALSE(has_header);
+    }
+
+    remove(path.c_str());
+}
+
+TEST_CASE("tbin merger - k-way merge") {
+    constexpr size_t SOURCES = 5;
+
+    struct Expected {
+        int64_t timestamp_us;
+        size_t  source;
+        size_t  index;
+    };
+
+    std::mt19937                rng(3);
+    std::vector<std::string>    paths;
+    std::vector<Expected>       expected;
+    std::vector<Merger::Source> sources;
+    for (size_t i = 0; i < SOURCES; i++) {
+        auto path = "/tmp/test_tbin_merge_" + std::to_string(i) + ".tbin";
+        paths.push_back(path);
+
+        Writer writer;
+        REQUIRE(writer.open(path, "src", i % 2 ? VERSION_2 : VERSION_1, 512));
+
+        // Source 3 is empty, the others have increasing timestamps on a coarse grid to get ties
+        auto    count     = i == 3 ? 0 : 200 + rng() % 300;
+        int64_t timestamp = 0;
+        int64_t shift     = i == 4 ? 5000 : 0;
+        for (size_t j = 0; j < count; j++) {
+            timestamp += (rng() % 4) * 1000;
+            uint8_t data[2] = {static_cast<uint8_t>(i), static_cast<uint8_t>(j)};
+            writer.write(timestamp, data, 2);
+            expected.push_back({timestamp + shift, i, j});
+        }
+        writer.close();
+
+        Merger::Source source{};
+        source.path     = path;
+        source.shift_us = shift;
+        sources.push_back(source);
+    }
+
+    // Ties are delivered in source order
+    std::stable_sort(expected.begin(), expected.end(), [](Expected const& a, Expected const& b) {
+        return a.timestamp_us < b.timestamp_us ||
+               (a.timestamp_us == b.timestamp_us && a.source < b.source);
+    });
+
+    for (auto prefetch : {false, true}) {
+        CAPTURE(prefetch);
+        Merger::Options options{};
+        options.prefetch   = prefetch;
+        options.batch_size = 7;
+
+        Merger merger{options};
+        REQUIRE(merger.open(sources));
+        CHECK(merger.size() == SOURCES);
+
+        size_t i = 0;
+        size_t source;
+        for (;; i++) {
+            int64_t peeked;
+            auto    has_next = merger.peek(peeked);
+            auto    message  = merger.next(&source);
+            CHECK(has_next == (message != nullptr));
+            if (!message) break;
+
+            REQUIRE(i < expected.size());
+            CHECK(peeked == message->timestamp_us);
+            CHECK(message->timestamp_us == expected[i].timestamp_us);
+            CHECK(source == expected[i].source);
+            CHECK(message->data[0] == expected[i].source);
+            CHECK(message->data[1] == static_cast<uint8_t>(expected[i].index));
+        }
+        CHECK(i == expected.size());
+    }
+
+    Merger missing;
+    CHECK_FALSE(missing.open({Merger::Source{"/tmp/test_tbin_merge_missing.tbin", 0}}));
+
+    for (auto& path : paths)
+        remove(path.c_str());
+}
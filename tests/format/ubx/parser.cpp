@@ -1,7 +1,10 @@
 #include <doctest/doctest.h>
+#include <format/checksum/checksum.hpp>
 #include <format/ubx/message.hpp>
 #include <format/ubx/parser.hpp>
 
+#include <vector>
+
 TEST_CASE("UBX parser - valid ACK-ACK message") {
     format::ubx::Parser parser;
     uint8_t const       msg[] = {0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x01, 0x0F, 0x38};
@@ -29,3 +32,78 @@ TEST_CASE("UBX parser - incomplete message") {
     auto message = parser.try_parse();
     CHECK(message == nullptr);
 }
+
+static std::vector<uint8_t> ubx_frame(uint8_t message_class, uint8_t message_id,
+                                      uint16_t payload_length, uint8_t fill) {
+    std::vector<uint8_t> frame(payload_length + 8u, fill);
+    frame[0]      = 0xB5;
+    frame[1]      = 0x62;
+    frame[2]      = message_class;
+    frame[3]      = message_id;
+    frame[4]      = static_cast<uint8_t>(payload_length & 0xFF);
+    frame[5]      = static_cast<uint8_t>(payload_length >> 8);
+    auto checksum = format::checksum::fletcher8(frame.data() + 2, payload_length + 4u);
+    frame[payload_length + 6u] = static_cast<uint8_t>(checksum & 0xFF);
+    frame[payload_length + 7u] = static_cast<uint8_t>(checksum >> 8);
+    return frame;
+}
+
+TEST_CASE("UBX parser - try_parse_into reuses message") {
+    format::ubx::Parser parser;
+    auto                first  = ubx_frame(0x01, 0x98, 16, 0x11);
+    auto                second = ubx_frame(0x01, 0x98, 16, 0x22);
+    auto                other  = ubx_frame(0x01, 0x99, 8, 0x33);
+    parser.append(first.data(), static_cast<uint32_t>(first.size()));
+    parser.append(second.data(), static_cast<uint32_t>(second.size()));
+    parser.append(other.data(), static_cast<uint32_t>(other.size()));
+    parser.append(first.data(), static_cast<uint32_t>(first.size()));
+
+    std::unique_ptr<format::ubx::Message> message;
+    REQUIRE(parser.try_parse_into(message));
+    auto pointer = message.get();
+    CHECK(message->data() == first);
+
+    REQUIRE(parser.try_parse_into(message));
+    CHECK(message.get() == pointer);
+    CHECK(message->data() == second);
+
+    // a different class/id gets another object, the previous one is kept as a spare
+    REQUIRE(parser.try_parse_into(message));
+    CHECK(message.get() != pointer);
+    CHECK(message->message_id() == 0x99);
+
+    REQUIRE(parser.try_parse_into(message));
+    CHECK(message.get() == pointer);
+    CHECK(message->data() == first);
+
+    CHECK(!parser.try_parse_into(message));
+    CHECK(message.get() == pointer);
+}
+
+TEST_CASE("UBX parser - pooled messages") {
+    auto                                  frame = ubx_frame(0x01, 0x98, 32, 0x44);
+    std::unique_ptr<format::ubx::Message> survivor;
+    {
+        format::ubx::Parser parser;
+        parser.set_pooled(true);
+        REQUIRE(parser.pool() != nullptr);
+
+        for (int i = 0; i < 4; i++) {
+            parser.append(frame.data(), static_cast<uint32_t>(frame.size()));
+            auto message = parser.try_parse();
+            REQUIRE(message != nullptr);
+            CHECK(message->data() == frame);
+        }
+        CHECK(parser.pool()->stats().hits >= 3);
+
+        // messages may outlive the parser and its pool
+        parser.append(frame.data(), static_cast<uint32_t>(frame.size()));
+        survivor = parser.try_parse();
+        REQUIRE(survivor != nullptr);
+    }
+    CHECK(survivor->data() == frame);
+
+    auto clone = survivor->clone();
+    survivor.reset();
+    CHECK(clone->data() == frame);
+}
@@ -0,0 +1,148 @@
+#include <doctest/doctest.h>
+#include <generator/idokeido/least_squares.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace idokeido;
+
+namespace {
+struct Geometry {
+    Vector3              receiver;
+    Scalar               clock_bias;
+    std::vector<Vector3> satellites;
+};
+}  // namespace
+
+// Receiver near the surface with satellites at GNSS altitude above its horizon
+static Geometry make_geometry(std::mt19937& rng, size_t satellite_count) {
+    std::uniform_real_distribution<Scalar> unit(-1.0, 1.0);
+
+    Geometry geometry{};
+    geometry.receiver   = Vector3{3370658.0, 711877.0, 5349787.0};
+    geometry.clock_bias = 12345.678;
+
+    auto up = geometry.receiver.normalized();
+    while (geometry.satellites.size() < satellite_count) {
+        Vector3 direction{unit(rng), unit(rng), unit(rng)};
+        direction.normalize();
+        if (direction.dot(up) < 0.2) continue;
+        geometry.satellites.push_back(geometry.receiver + direction * 21000000.0);
+    }
+    return geometry;
+}
+
+// The solver used by SppEngine before the normal equations were accumulated
+static Vector4 reference_step(MatrixX const& design_matrix, MatrixX const& residuals, long rows) {
+    auto h_subset    = design_matrix.topRows(rows).eval();
+    auto r_subset    = residuals.topRows(rows).eval();
+    auto h_transpose = h_subset.transpose();
+    auto dTd         = h_transpose * h_subset;
+    auto dTr         = h_transpose * r_subset;
+    return dTd.ldlt().solve(dTr).eval();
+}
+
+TEST_CASE("NormalEquations - same Gauss-Newton steps as the dynamic solver") {
+    std::mt19937 rng(11);
+    for (size_t satellite_count : {4, 5, 8, 12, 30}) {
+        CAPTURE(satellite_count);
+        auto geometry = make_geometry(rng, satellite_count);
+
+        std::vector<Scalar> pseudo_ranges;
+        for (auto const& satellite : geometry.satellites) {
+            pseudo_ranges.push_back((satellite - geometry.receiver).norm() + geometry.clock_bias);
+        }
+
+        Vector4 reference{0, 0, 0, 0};
+        Vector4 current{0, 0, 0, 0};
+        for (size_t it = 0; it < 10; ++it) {
+            MatrixX residuals{satellite_count, 1};
+            MatrixX design_matrix{satellite_count, 4};
+
+            NormalEquations<4> normal_equations;
+            for (size_t i = 0; i < satellite_count; ++i) {
+                Vector3 position      = current.head<3>();
+                auto    line_of_sight = (geometry.satellites[i] - position).normalized();
+                auto    residual      = pseudo_ranges[i] -
+                                (geometry.satellites[i] - position).norm() - current(3);
+
+                design_matrix(i, 0) = -line_of_sight.x();
+                design_matrix(i, 1) = -line_of_sight.y();
+                design_matrix(i, 2) = -line_of_sight.z();
+                design_matrix(i, 3) = 1.0;
+                residuals(i, 0)     = residual;
+
+                Scalar design_row[4] = {-line_of_sight.x(), -line_of_sight.y(),
+                                        -line_of_sight.z(), 1.0};
+                normal_equations.add(design_row, residual);
+            }
+
+            auto expected = reference_step(design_matrix, residuals,
+                                           static_cast<long>(satellite_count));
+
+            Scalar delta[4];
+            REQUIRE(normal_equations.solve(delta));
+            for (long k = 0; k < 4; ++k) {
+                CHECK(delta[k] == doctest::Approx(expected(k)).epsilon(1e-9).scale(1e-3));
+            }
+
+            reference += expected;
+            current += Vector4{delta[0], delta[1], delta[2], delta[3]};
+            if (expected.norm() < 0.0001) break;
+        }
+
+        for (long k = 0; k < 3; ++k) {
+            CHECK(current(k) == doctest::Approx(reference(k)).epsilon(1e-12).scale(1e-6));
+            CHECK(current(k) == doctest::Approx(geometry.receiver(k)).epsilon(1e-12).scale(1e-6));
+        }
+        CHECK(current(3) == doctest::Approx(geometry.clock_bias).epsilon(1e-9).scale(1e-6));
+    }
+}
+
+TEST_CASE("NormalEquations - weighted with an inter-system bias") {
+    std::mt19937                           rng(5);
+    std::uniform_real_distribution<Scalar> value(-1.0, 1.0);
+
+    constexpr size_t ROWS = 9;
+    MatrixX          h{ROWS, 5};
+    VectorX          r{ROWS};
+    MatrixX          w = MatrixX::Zero(ROWS, ROWS);
+
+    NormalEquations<5> normal_equations;
+    for (long i = 0; i < static_cast<long>(ROWS); ++i) {
+        Scalar row[5] = {value(rng), value(rng), value(rng), 1.0, i % 2 ? 1.0 : 0.0};
+        for (long k = 0; k < 5; ++k)
+            h(i, k) = row[k];
+        r(i)    = 100.0 * value(rng);
+        w(i, i) = 0.5 + value(rng) * 0.4;
+        normal_equations.add(row, r(i), w(i, i));
+    }
+
+    MatrixX htw      = h.transpose() * w;
+    VectorX expected = (htw * h).ldlt().solve(htw * r);
+
+    Scalar x[5];
+    REQUIRE(normal_equations.solve(x));
+    for (long k = 0; k < 5; ++k) {
+        CHECK(x[k] == doctest::Approx(expected(k)).epsilon(1e-9));
+    }
+}
+
+TEST_CASE("NormalEquations - under-determined") {
+    NormalEquations<4> normal_equations;
+    Scalar             x[4];
+    CHECK_FALSE(normal_equations.solve(x));
+
+    // Three satellites can not determine four unknowns
+    Scalar rows[3][4] = {{1, 0, 0, 1}, {0, 1, 0, 1}, {0, 0, 1, 1}};
+    for (auto& row : rows) {
+        normal_equations.add(row, 1.0);
+    }
+    CHECK_FALSE(normal_equations.solve(x));
+
+    // A repeated row does not help
+    normal_equations.add(rows[0], 1.0);
+    CHECK(normal_equations.count() == 4);
+    CHECK_FALSE(normal_equations.solve(x));
+}
@@ -0,0 +1,141 @@
+#include <doctest/doctest.h>
+#include <generator/idokeido/correction.hpp>
+#include <generator/idokeido/eph.hpp>
+#include <generator/idokeido/spp.hpp>
+#include <time/gps.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace idokeido;
+
+static constexpr int64_t WEEK        = 2300;
+static constexpr int64_t TOE         = 7200;
+static constexpr size_t  EPOCH_COUNT = 40;
+
+static SppConfiguration configuration() {
+    SppConfiguration config{};
+    config.relativistic_model    = RelativisticModel::None;
+    config.ionospheric_mode      = IonosphericMode::None;
+    config.weight_function       = WeightFunction::None;
+    config.epoch_selection       = EpochSelection::FirstObservation;
+    config.gnss.gps              = true;
+    config.observation_window    = 0.5;
+    config.elevation_cutoff      = 5;
+    config.snr_cutoff            = 0;
+    config.outlier_cutoff        = 0;
+    config.reject_cycle_slip     = false;
+    config.reject_halfcycle_slip = false;
+    config.reject_outliers       = false;
+    return config;
+}
+
+// A circular constellation, 6 planes with 4 satellites each
+static void add_constellation(EphemerisEngine& engine) {
+    for (uint8_t prn = 1; prn <= 24; prn++) {
+        ephemeris::GpsEphemeris eph{};
+        eph.prn         = prn;
+        eph.week_number = static_cast<uint16_t>(WEEK);
+        eph.lpp_iod     = prn;
+        eph.iode        = prn;
+        eph.iodc        = prn;
+        eph.toe         = TOE;
+        eph.toc         = TOE;
+        eph.a           = 26560000.0;
+        eph.e           = 0.0;
+        eph.i0          = 55.0 * constant::K_D2R;
+        eph.omega0      = ((prn - 1) / 4) * 60.0 * constant::K_D2R;
+        eph.m0          = ((prn - 1) % 4) * 90.0 * constant::K_D2R + (prn - 1) / 4 * 15.0;
+        eph.omega_dot   = -8e-9;
+        engine.add(eph);
+    }
+}
+
+// Pseudo-ranges of the visible satellites, without light time, that is fine to compare solutions
+static std::vector<RawMeasurement> make_measurements(EphemerisEngine const& engine) {
+    Vector3 receiver{3370658.0, 711877.0, 5349787.0};
+    auto    up = receiver.normalized();
+
+    std::vector<RawMeasurement> measurements;
+    for (size_t epoch = 0; epoch < EPOCH_COUNT; epoch++) {
+        auto time = ts::Tai{ts::Gps::from_week_tow(WEEK, TOE + static_cast<int64_t>(epoch), 0.0)};
+        for (uint8_t prn = 1; prn <= 24; prn++) {
+            auto                      satellite_id = SatelliteId::from_gps_prn(prn);
+            EphemerisEngine::Satellite satellite{};
+            REQUIRE(engine.evaluate(satellite_id, time, RelativisticModel::None, satellite));
+
+            auto line_of_sight = satellite.position - receiver;
+            if (line_of_sight.normalized().dot(up) < 0.2) continue;
+
+            RawMeasurement measurement{};
+            measurement.time         = time;
+            measurement.satellite_id = satellite_id;
+            measurement.signal_id    = SignalId::GPS_L1_CA;
+            measurement.pseudo_range = line_of_sight.norm() + 1000.0 + 0.1 * epoch;
+            measurement.snr          = 40.0 + prn % 5;
+            measurements.push_back(measurement);
+        }
+    }
+    return measurements;
+}
+
+static void check_equal(std::vector<Solution> const& a, std::vector<Solution> const& b) {
+    REQUIRE(a.size() == b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        CAPTURE(i);
+        CHECK(a[i].status == b[i].status);
+        CHECK(a[i].time == b[i].time);
+        CHECK(a[i].latitude == b[i].latitude);
+        CHECK(a[i].longitude == b[i].longitude);
+        CHECK(a[i].altitude == b[i].altitude);
+        CHECK(a[i].satellite_count == b[i].satellite_count);
+    }
+}
+
+TEST_CASE("SppEngine - batch evaluation matches streaming") {
+    EphemerisEngine ephemeris_engine;
+    CorrectionCache correction_cache;
+    add_constellation(ephemeris_engine);
+    auto measurements = make_measurements(ephemeris_engine);
+    REQUIRE(!measurements.empty());
+
+    // One epoch at a time like the streaming processor
+    std::vector<Solution> streamed;
+    {
+        SppEngine engine{configuration(), ephemeris_engine, correction_cache};
+        for (size_t i = 0; i < measurements.size(); i++) {
+            engine.add_measurement(measurements[i]);
+            if (i + 1 == measurements.size() || measurements[i + 1].time != measurements[i].time) {
+                streamed.push_back(engine.evaluate());
+            }
+        }
+    }
+    REQUIRE(streamed.size() == EPOCH_COUNT);
+    for (auto& solution : streamed) {
+        CHECK(solution.status == Solution::Status::Standard);
+        CHECK(solution.satellite_count >= 4);
+    }
+
+    // Shuffled input, the batch sorts the measurements itself
+    auto shuffled = measurements;
+    for (size_t i = 0; i + 7 < shuffled.size(); i += 7) {
+        std::swap(shuffled[i], shuffled[shuffled.size() - 1 - i]);
+    }
+
+    for (size_t threads : {1, 3, 8}) {
+        CAPTURE(threads);
+        SppEngine             engine{configuration(), ephemeris_engine, correction_cache};
+        std::vector<Solution> batch;
+        engine.evaluate_batch(shuffled, threads, [&](Solution const& solution) {
+            batch.push_back(solution);
+        });
+        check_equal(batch, streamed);
+    }
+
+    SppEngine engine{configuration(), ephemeris_engine, correction_cache};
+    size_t    calls = 0;
+    engine.evaluate_batch({}, 4, [&](Solution const&) {
+        calls++;
+    });
+    CHECK(calls == 0);
+}
@@ -0,0 +1,110 @@
+#include <cstdlib>
+#include <doctest/doctest.h>
+#include <generator/spartn2/generator.hpp>
+
+#include <external_warnings.hpp>
+EXTERNAL_WARNINGS_PUSH
+#include <A-GNSS-ProvideAssistanceData.h>
+#include <GNSS-GenericAssistData.h>
+#include <GNSS-GenericAssistDataElement.h>
+#include <GNSS-ID.h>
+#include <GNSS-SSR-ClockCorrections-r15.h>
+#include <LPP-Message.h>
+#include <LPP-MessageBody.h>
+#include <ProvideAssistanceData-r9-IEs.h>
+#include <ProvideAssistanceData.h>
+#include <SSR-ClockCorrectionSatelliteElement-r15.h>
+EXTERNAL_WARNINGS_POP
+
+#define ALLOC_ZERO(type) reinterpret_cast<type*>(calloc(1, sizeof(type)))
+
+static constexpr long GPS_DAY = 16518;
+
+// LPP message with GPS clock corrections, `c0` for every satellite
+static LPP_Message* clock_message(long tod, long c0) {
+    auto clock                               = ALLOC_ZERO(GNSS_SSR_ClockCorrections_r15);
+    clock->epochTime_r15.gnss_TimeID.gnss_id = GNSS_ID__gnss_id_gps;
+    clock->epochTime_r15.gnss_DayNumber      = GPS_DAY;
+    clock->epochTime_r15.gnss_TimeOfDay      = tod;
+    clock->ssrUpdateInterval_r15             = 1;
+    clock->iod_ssr_r15                       = 3;
+    for (long id = 0; id < 8; id++) {
+        auto satellite                   = ALLOC_ZERO(SSR_ClockCorrectionSatelliteElement_r15);
+        satellite->svID_r15.satellite_id = id;
+        satellite->delta_Clock_C0_r15    = c0;
+        ASN_SEQUENCE_ADD(&clock->ssr_ClockCorrectionList_r15.list, satellite);
+    }
+
+    auto element             = ALLOC_ZERO(GNSS_GenericAssistDataElement);
+    element->gnss_ID.gnss_id = GNSS_ID__gnss_id_gps;
+    element->ext2 =
+        ALLOC_ZERO(GNSS_GenericAssistDataElement::GNSS_GenericAssistDataElement__ext2);
+    element->ext2->gnss_SSR_ClockCorrections_r15 = clock;
+
+    auto a_gnss                    = ALLOC_ZERO(A_GNSS_ProvideAssistanceData);
+    a_gnss->gnss_GenericAssistData = ALLOC_ZERO(GNSS_GenericAssistData);
+    ASN_SEQUENCE_ADD(&a_gnss->gnss_GenericAssistData->list, element);
+
+    auto message             = ALLOC_ZERO(LPP_Message);
+    message->lpp_MessageBody = ALLOC_ZERO(LPP_MessageBody);
+
+    auto body               = message->lpp_MessageBody;
+    body->present           = LPP_MessageBody_PR_c1;
+    body->choice.c1.present = LPP_MessageBody__c1_PR_provideAssistanceData;
+
+    auto& extensions   = body->choice.c1.choice.provideAssistanceData.criticalExtensions;
+    extensions.present = ProvideAssistanceData__criticalExtensions_PR_c1;
+    extensions.choice.c1.present =
+        ProvideAssistanceData__criticalExtensions__c1_PR_provideAssistanceData_r9;
+    extensions.choice.c1.choice.provideAssistanceData_r9.a_gnss_ProvideAssistanceData = a_gnss;
+    return message;
+}
+
+static std::vector<uint8_t> generate_ocb(generator::spartn::Generator& generator, long tod,
+                                         long c0) {
+    auto lpp      = clock_message(tod, c0);
+    auto messages = generator.generate(lpp);
+    ASN_STRUCT_FREE(asn_DEF_LPP_Message, lpp);
+
+    REQUIRE(messages.size() == 1);
+    CHECK(messages[0].message_type() == 0);
+    return messages[0].payload();
+}
+
+TEST_CASE("SPARTN generator - unchanged OCB reuses the encoded payload") {
+    generator::spartn::Generator generator;
+
+    auto first  = generate_ocb(generator, 100, 1000);
+    auto second = generate_ocb(generator, 105, 1000);
+    CHECK(second == first);
+    CHECK(generator.statistics().cached_messages == 1);
+    CHECK(generator.statistics().message_counts.at(0) == 2);
+}
+
+TEST_CASE("SPARTN generator - changed clocks are encoded again") {
+    generator::spartn::Generator generator;
+
+    auto first  = generate_ocb(generator, 100, 1000);
+    auto second = generate_ocb(generator, 105, 2000);
+    CHECK(second != first);
+    CHECK(generator.statistics().cached_messages == 0);
+
+    // Back to the first clocks, compared against the previous generation only
+    auto third = generate_ocb(generator, 110, 1000);
+    CHECK(third == first);
+    CHECK(generator.statistics().cached_messages == 0);
+}
+
+TEST_CASE("SPARTN generator - reconfiguration drops cached payloads") {
+    generator::spartn::Generator generator;
+
+    auto first = generate_ocb(generator, 100, 1000);
+    generator.set_ublox_clock_correction(true);
+    auto second = generate_ocb(generator, 105, 1000);
+    CHECK(second != first);
+    CHECK(generator.statistics().cached_messages == 0);
+
+    auto third = generate_ocb(generator, 110, 1000);
+    CHECK(third == second);
+    CHECK(generator.statistics().cached_messages == 1);
+}
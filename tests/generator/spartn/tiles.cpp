@@ -0,0 +1,172 @@
+#include <cstdlib>
+#include <doctest/doctest.h>
+#include <generator/spartn2/generator.hpp>
+
+#include <external_warnings.hpp>
+EXTERNAL_WARNINGS_PUSH
+#include <A-GNSS-ProvideAssistanceData.h>
+#include <GNSS-CommonAssistData.h>
+#include <GNSS-GenericAssistData.h>
+#include <GNSS-GenericAssistDataElement.h>
+#include <GNSS-ID.h>
+#include <GNSS-SSR-ClockCorrections-r15.h>
+#include <GNSS-SSR-CorrectionPoints-r16.h>
+#include <GNSS-SSR-STEC-Correction-r16.h>
+#include <LPP-Message.h>
+#include <LPP-MessageBody.h>
+#include <ProvideAssistanceData-r9-IEs.h>
+#include <ProvideAssistanceData.h>
+#include <SSR-ClockCorrectionSatelliteElement-r15.h>
+#include <STEC-SatElement-r16.h>
+EXTERNAL_WARNINGS_POP
+
+#include <map>
+#include <vector>
+
+#define ALLOC_ZERO(type) reinterpret_cast<type*>(calloc(1, sizeof(type)))
+
+static constexpr long GPS_DAY = 16518;
+
+static void epoch_time(GNSS_SystemTime& time, long tod) {
+    time.gnss_TimeID.gnss_id = GNSS_ID__gnss_id_gps;
+    time.gnss_DayNumber      = GPS_DAY;
+    time.gnss_TimeOfDay      = tod;
+}
+
+// LPP message for one tile: the correction point set, GPS clocks and STEC polynomials that
+// differ between the sets
+static LPP_Message* tile_message(long set_id, long tod) {
+    auto points                      = ALLOC_ZERO(GNSS_SSR_CorrectionPoints_r16);
+    points->correctionPointSetID_r16 = set_id;
+    points->correctionPoints_r16.present =
+        GNSS_SSR_CorrectionPoints_r16__correctionPoints_r16_PR_arrayOfCorrectionPoints_r16;
+    auto& choice = points->correctionPoints_r16.choice;
+    auto& array  = choice.arrayOfCorrectionPoints_r16;
+    array.referencePointLatitude_r16  = 1000 * set_id;
+    array.referencePointLongitude_r16 = 2000 * set_id;
+    array.numberOfStepsLatitude_r16   = 1;
+    array.numberOfStepsLongitude_r16  = 1;
+    array.stepOfLatitude_r16          = 100;
+    array.stepOfLongitude_r16         = 100;
+
+    auto common  = ALLOC_ZERO(GNSS_CommonAssistData);
+    common->ext2 = ALLOC_ZERO(GNSS_CommonAssistData::GNSS_CommonAssistData__ext2);
+    common->ext2->gnss_SSR_CorrectionPoints_r16 = points;
+
+    auto clock = ALLOC_ZERO(GNSS_SSR_ClockCorrections_r15);
+    epoch_time(clock->epochTime_r15, tod);
+    clock->ssrUpdateInterval_r15 = 1;
+    clock->iod_ssr_r15           = 3;
+
+    auto stec = ALLOC_ZERO(GNSS_SSR_STEC_Correction_r16);
+    epoch_time(stec->epochTime_r16, tod);
+    stec->ssrUpdateInterval_r16    = 1;
+    stec->iod_ssr_r16              = 3;
+    stec->correctionPointSetID_r16 = set_id;
+
+    for (long id = 0; id < 8; id++) {
+        auto satellite                   = ALLOC_ZERO(SSR_ClockCorrectionSatelliteElement_r15);
+        satellite->svID_r15.satellite_id = id;
+        satellite->delta_Clock_C0_r15    = 1000;
+        ASN_SEQUENCE_ADD(&clock->ssr_ClockCorrectionList_r15.list, satellite);
+
+        auto element                                  = ALLOC_ZERO(STEC_SatElement_r16);
+        element->svID_r16.satellite_id                = id;
+        element->stecQualityIndicator_r16.buf         = ALLOC_ZERO(uint8_t);
+        element->stecQualityIndicator_r16.size        = 1;
+        element->stecQualityIndicator_r16.bits_unused = 2;
+        element->stec_C00_r16                         = 100 * set_id + id;
+        ASN_SEQUENCE_ADD(&stec->stec_SatList_r16.list, element);
+    }
+
+    auto element             = ALLOC_ZERO(GNSS_GenericAssistDataElement);
+    element->gnss_ID.gnss_id = GNSS_ID__gnss_id_gps;
+    element->ext2 =
+        ALLOC_ZERO(GNSS_GenericAssistDataElement::GNSS_GenericAssistDataElement__ext2);
+    element->ext2->gnss_SSR_ClockCorrections_r15 = clock;
+    element->ext3 =
+        ALLOC_ZERO(GNSS_GenericAssistDataElement::GNSS_GenericAssistDataElement__ext3);
+    element->ext3->gnss_SSR_STEC_Correction_r16 = stec;
+
+    auto a_gnss                    = ALLOC_ZERO(A_GNSS_ProvideAssistanceData);
+    a_gnss->gnss_CommonAssistData  = common;
+    a_gnss->gnss_GenericAssistData = ALLOC_ZERO(GNSS_GenericAssistData);
+    ASN_SEQUENCE_ADD(&a_gnss->gnss_GenericAssistData->list, element);
+
+    auto message             = ALLOC_ZERO(LPP_Message);
+    message->lpp_MessageBody = ALLOC_ZERO(LPP_MessageBody);
+
+    auto body               = message->lpp_MessageBody;
+    body->present           = LPP_MessageBody_PR_c1;
+    body->choice.c1.present = LPP_MessageBody__c1_PR_provideAssistanceData;
+
+    auto& extensions   = body->choice.c1.choice.provideAssistanceData.criticalExtensions;
+    extensions.present = ProvideAssistanceData__criticalExtensions_PR_c1;
+    extensions.choice.c1.present =
+        ProvideAssistanceData__criticalExtensions__c1_PR_provideAssistanceData_r9;
+    extensions.choice.c1.choice.provideAssistanceData_r9.a_gnss_ProvideAssistanceData = a_gnss;
+    return message;
+}
+
+static std::vector<generator::spartn::Message>
+generate_tiles(generator::spartn::Generator& generator, long tiles, long tod) {
+    std::vector<LPP_Message*> batch;
+    for (long set_id = 1; set_id <= tiles; set_id++) {
+        batch.push_back(tile_message(set_id, tod));
+    }
+
+    auto messages = generator.generate(batch.data(), batch.size());
+    for (auto message : batch) {
+        ASN_STRUCT_FREE(asn_DEF_LPP_Message, message);
+    }
+    return messages;
+}
+
+TEST_CASE("SPARTN generator - tiles share OCB and tag GAD/HPAC with their set") {
+    generator::spartn::Generator generator;
+
+    auto messages = generate_tiles(generator, 3, 100);
+
+    size_t                  ocb_count = 0;
+    std::map<uint16_t, int> gad_sets;
+    std::map<uint16_t, int> hpac_sets;
+    for (auto& message : messages) {
+        if (message.message_type() == 0) {
+            CHECK(!message.has_set_id());
+            ocb_count++;
+        } else if (message.message_type() == 1) {
+            REQUIRE(message.has_set_id());
+            hpac_sets[message.set_id()]++;
+        } else if (message.message_type() == 2) {
+            REQUIRE(message.has_set_id());
+            gad_sets[message.set_id()]++;
+        }
+    }
+
+    // One GAD and one HPAC (GPS only) per tile
+    std::map<uint16_t, int> expected{{1, 1}, {2, 1}, {3, 1}};
+    CHECK(ocb_count == 1);
+    CHECK(gad_sets == expected);
+    CHECK(hpac_sets == expected);
+}
+
+TEST_CASE("SPARTN generator - parallel HPAC encoding matches the calling thread") {
+    generator::spartn::Generator sequential;
+    generator::spartn::Generator parallel;
+    parallel.set_hpac_threads(4);
+
+    for (long tod = 100; tod <= 110; tod += 5) {
+        auto expected = generate_tiles(sequential, 8, tod);
+        auto actual   = generate_tiles(parallel, 8, tod);
+
+        REQUIRE(actual.size() == expected.size());
+        for (size_t i = 0; i < actual.size(); i++) {
+            CHECK(actual[i].message_type() == expected[i].message_type());
+            CHECK(actual[i].message_subtype() == expected[i].message_subtype());
+            CHECK(actual[i].set_id() == expected[i].set_id());
+            CHECK(actual[i].payload() == expected[i].payload());
+        }
+    }
+
+    CHECK(parallel.statistics().cached_messages == sequential.statistics().cached_messages);
+}
@@ -0,0 +1,59 @@
+#include <doctest/doctest.h>
+#include <time/gps.hpp>
+
+#include "models/astro_cache.hpp"
+
+#include <cstring>
+
+using namespace generator::tokoro;
+
+static bool same_bits(double a, double b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static void check_same(SunMoonPosition const& a, SunMoonPosition const& b) {
+    CHECK(same_bits(a.sun.x, b.sun.x));
+    CHECK(same_bits(a.sun.y, b.sun.y));
+    CHECK(same_bits(a.sun.z, b.sun.z));
+    CHECK(same_bits(a.moon.x, b.moon.x));
+    CHECK(same_bits(a.moon.y, b.moon.y));
+    CHECK(same_bits(a.moon.z, b.moon.z));
+    CHECK(same_bits(a.gmst, b.gmst));
+}
+
+TEST_CASE("AstroCache - same as direct computation") {
+    AstroCache cache;
+    auto       start = ts::Tai{ts::Gps::from_ymdhms(2024, 3, 20, 12, 0, 0.0)};
+
+    // Two epochs with the current and next state of each, looked up by many satellites
+    for (int epoch = 0; epoch < 2; epoch++) {
+        auto current = start + static_cast<double>(epoch);
+        auto next    = current + ts::Timestamp{0.1};
+        for (int satellite = 0; satellite < 20; satellite++) {
+            check_same(cache.sun_and_moon_position_ecef(current),
+                       sun_and_moon_position_ecef(current));
+            check_same(cache.sun_and_moon_position_ecef(next), sun_and_moon_position_ecef(next));
+        }
+    }
+
+    CHECK(cache.misses() == 4);
+    CHECK(cache.hits() == 76);
+}
+
+TEST_CASE("AstroCache - evicts the oldest epoch") {
+    AstroCache cache;
+    auto       start = ts::Tai{ts::Gps::from_ymdhms(2025, 7, 1, 0, 0, 0.0)};
+
+    for (int i = 0; i < 20; i++) {
+        auto time = start + 30.0 * i;
+        check_same(cache.sun_and_moon_position_ecef(time), sun_and_moon_position_ecef(time));
+    }
+    CHECK(cache.misses() == 20);
+
+    // The most recent epochs are still cached, the first is not
+    check_same(cache.sun_and_moon_position_ecef(start + 30.0 * 19),
+               sun_and_moon_position_ecef(start + 30.0 * 19));
+    CHECK(cache.misses() == 20);
+    check_same(cache.sun_and_moon_position_ecef(start), sun_and_moon_position_ecef(start));
+    CHECK(cache.misses() == 21);
+}
@@ -0,0 +1,143 @@
+#include <doctest/doctest.h>
+#include <generator/tokoro/coordinate.hpp>
+#include <generator/tokoro/generator.hpp>
+#include <generator/tokoro/observation.hpp>
+#include <generator/tokoro/reference_ellipsoid.hpp>
+#include <time/gps.hpp>
+
+#include "coordinates/enu.hpp"
+#include "ground.hpp"
+#include "models/geoid.hpp"
+#include "models/helper.hpp"
+#include "models/mops.hpp"
+#include "satellite.hpp"
+
+#include <cstring>
+
+using namespace generator::tokoro;
+
+static bool same_bits(double a, double b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static void check_same(Float3 const& a, Float3 const& b) {
+    CHECK(same_bits(a.x, b.x));
+    CHECK(same_bits(a.y, b.y));
+    CHECK(same_bits(a.z, b.z));
+}
+
+// Stations at different latitudes and heights, including one below the ellipsoid
+static Float3 const STATIONS_LLH[] = {
+    {57.7 * constant::DEG2RAD, 11.9 * constant::DEG2RAD, 45.0},
+    {3.0 * constant::DEG2RAD, -60.0 * constant::DEG2RAD, 1200.0},
+    {-62.0 * constant::DEG2RAD, 150.0 * constant::DEG2RAD, -20.0},
+    {31.5 * constant::DEG2RAD, 35.4 * constant::DEG2RAD, 3500.0},
+};
+
+// Times in different seasons, the MOPS and Niell models depend on the day of year
+static ts::Tai const TIMES[] = {
+    ts::Tai{ts::Gps::from_ymdhms(2025, 1, 15, 6, 30, 0.0)},
+    ts::Tai{ts::Gps::from_ymdhms(2024, 7, 28, 18, 0, 0.0)},
+};
+
+TEST_CASE("GroundContext - station terms same as direct evaluation") {
+    for (auto const& station : STATIONS_LLH) {
+        for (auto const& time : TIMES) {
+            auto position = llh_to_ecef(station, ellipsoid::gWgs84);
+            CAPTURE(station.x * constant::RAD2DEG);
+            CAPTURE(time.rtklib_time_string());
+
+            GroundContext ground{position, time};
+
+            auto llh   = ecef_to_llh(position, ellipsoid::gWgs84);
+            auto geoid = Geoid::height(llh.x, llh.y, Geoid::Model::EMBEDDED);
+            check_same(ground.position, position);
+            check_same(ground.llh, llh);
+            CHECK(same_bits(ground.geoid_height, geoid));
+
+            // The receiver antenna basis is the ENU frame of the station
+            Float3 east, north, up;
+            enu_basis_from_llh(llh, east, north, up);
+            REQUIRE(ground.receiver_antenna_basis.valid);
+            check_same(ground.receiver_antenna_basis.x, east);
+            check_same(ground.receiver_antenna_basis.y, north);
+
+            HydrostaticAndWetDelay sea_level{};
+            HydrostaticAndWetDelay ellipsoidal_height{};
+            REQUIRE(mops_tropospheric_delay(time, llh.x, 0.0, geoid, sea_level));
+            REQUIRE(mops_tropospheric_delay(time, llh.x, llh.z, geoid, ellipsoidal_height));
+            REQUIRE(ground.mops_valid);
+            CHECK(same_bits(ground.mops_sea_level.hydrostatic, sea_level.hydrostatic));
+            CHECK(same_bits(ground.mops_sea_level.wet, sea_level.wet));
+            CHECK(same_bits(ground.mops_ellipsoidal_height.hydrostatic,
+                            ellipsoidal_height.hydrostatic));
+            CHECK(same_bits(ground.mops_ellipsoidal_height.wet, ellipsoidal_height.wet));
+
+            for (int degrees = 3; degrees <= 90; degrees += 7) {
+                auto elevation = degrees * constant::DEG2RAD;
+                for (auto apply_hydrostatic_delta : {true, false}) {
+                    auto expected =
+                        hydrostatic_mapping_function(time, llh, elevation, apply_hydrostatic_delta);
+                    auto mapping = hydrostatic_mapping_function(ground.niell, elevation,
+                                                                apply_hydrostatic_delta);
+                    CAPTURE(degrees);
+                    CHECK(same_bits(mapping.hydrostatic, expected.hydrostatic));
+                    CHECK(same_bits(mapping.wet, expected.wet));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("GroundContext - observation tropospheric terms same as direct evaluation") {
+    Generator generator;
+    auto      signal_id = SignalId::GPS_L1_CA;
+
+    for (auto const& station : STATIONS_LLH) {
+        for (auto const& time : TIMES) {
+            auto position = llh_to_ecef(station, ellipsoid::gWgs84);
+            CAPTURE(station.x * constant::RAD2DEG);
+            CAPTURE(time.rtklib_time_string());
+
+            GroundContext ground{position, time};
+            Satellite     satellite{SatelliteId::from_gps_prn(1), position, generator};
+
+            for (int degrees = 3; degrees <= 90; degrees += 7) {
+                auto elevation = degrees * constant::DEG2RAD;
+                CAPTURE(degrees);
+
+                // As `ReferenceStation::generate` does, the mapping is evaluated for all
+                // satellites from the coefficients of the ground context
+                double hydrostatic_mapping = 0.0;
+                double wet_mapping         = 0.0;
+                hydrostatic_mapping_functions(ground.niell, &elevation, 1, true,
+                                              &hydrostatic_mapping, &wet_mapping);
+                satellite.set_tropospheric_mapping({hydrostatic_mapping, wet_mapping});
+
+                Observation observation{satellite, signal_id, ground};
+                observation.compute_tropospheric_height(ground);
+                auto const& tropospheric = observation.tropospheric();
+
+                // What each observation evaluated for itself before the ground context
+                auto llh     = ecef_to_llh(position, ellipsoid::gWgs84);
+                auto geoid   = Geoid::height(llh.x, llh.y, Geoid::Model::EMBEDDED);
+                auto mapping = hydrostatic_mapping_function(time, llh, elevation, true);
+
+                HydrostaticAndWetDelay alt_0{};
+                HydrostaticAndWetDelay alt_eh{};
+                REQUIRE(mops_tropospheric_delay(time, llh.x, 0.0, geoid, alt_0));
+                REQUIRE(mops_tropospheric_delay(time, llh.x, llh.z, geoid, alt_eh));
+
+                CHECK(same_bits(tropospheric.mapping_hydrostatic, mapping.hydrostatic));
+                CHECK(same_bits(tropospheric.mapping_wet, mapping.wet));
+                REQUIRE(tropospheric.valid_height_mapping);
+                CHECK(same_bits(tropospheric.height_mapping_hydrostatic,
+                                alt_eh.hydrostatic / alt_0.hydrostatic));
+                CHECK(same_bits(tropospheric.height_mapping_wet, alt_eh.wet / alt_0.wet));
+                REQUIRE(tropospheric.valid_model);
+                CHECK(same_bits(tropospheric.model_hydrostatic, alt_eh.hydrostatic));
+                CHECK(same_bits(tropospheric.model_wet, alt_eh.wet));
+            }
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#include <doctest/doctest.h>
+#include <time/gps.hpp>
+
+#include "models/helper.hpp"
+
+#include <cstring>
+#include <vector>
+
+using namespace generator::tokoro;
+
+static bool same_bits(double a, double b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+TEST_CASE("Tropospheric mapping - batch same as scalar") {
+    auto time = ts::Tai{ts::Gps::from_ymdhms(2025, 1, 15, 6, 30, 0.0)};
+
+    // More elevations than one block, including some below the horizon
+    std::vector<double> elevations;
+    for (int i = 0; i < 150; i++) {
+        elevations.push_back((-10.0 + 0.67 * i) * constant::DEG2RAD);
+    }
+
+    std::vector<double> hydrostatic(elevations.size());
+    std::vector<double> wet(elevations.size());
+    for (auto latitude : {-62.0, 3.0, 57.7}) {
+        auto llh          = Float3{latitude * constant::DEG2RAD, 0.2, 120.0};
+        auto coefficients = niell_coefficients(time, llh);
+        for (auto apply_hydrostatic_delta : {true, false}) {
+            hydrostatic_mapping_functions(coefficients, elevations.data(), elevations.size(),
+                                          apply_hydrostatic_delta, hydrostatic.data(), wet.data());
+            for (size_t i = 0; i < elevations.size(); i++) {
+                auto expected =
+                    hydrostatic_mapping_function(time, llh, elevations[i], apply_hydrostatic_delta);
+                CAPTURE(elevations[i]);
+                CHECK(same_bits(hydrostatic[i], expected.hydrostatic));
+                CHECK(same_bits(wet[i], expected.wet));
+            }
+        }
+    }
+}
@@ -5,8 +5,11 @@
 
 #include "test_helper.hpp"
 
+#include <chrono>
 #include <cstring>
+#include <fcntl.h>
 #include <unistd.h>
+#include <vector>
 
 TEST_CASE("StreamInputAdapter - receives data") {
     int fds[2];
@@ -64,6 +67,89 @@ TEST_CASE("StreamOutputAdapter - writes data") {
     adapter.cancel();
 }
 
+TEST_CASE("StreamOutputAdapter - epoch drop policy") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL, 0) | O_NONBLOCK);
+    auto pipe_size = fcntl(fds[1], F_SETPIPE_SZ, 4096);
+    REQUIRE(pipe_size > 0);
+
+    io::FdConfig config;
+    config.fd                      = fds[1];
+    config.owns_fd                 = true;
+    auto                    stream = std::make_shared<io::FdStream>("test", config);
+    io::StreamOutputAdapter adapter(stream);
+    adapter.set_drop_policy(io::WriteBuffer::DropPolicy::Epoch);
+
+    // Fill the pipe so that every following message is buffered
+    std::vector<uint8_t> filler(static_cast<size_t>(pipe_size), 0x00);
+    adapter.write(filler.data(), filler.size());
+
+    // Two epochs of three messages do not fit in the 64 KiB write buffer
+    std::vector<uint8_t> message(16 * 1024, 0xAB);
+    for (int epoch = 0; epoch < 2; epoch++) {
+        for (int i = 0; i < 3; i++) {
+            adapter.write(message.data(), message.size());
+        }
+        adapter.end_epoch();
+    }
+
+    // The whole first epoch is dropped, not only the oldest messages
+    CHECK(stream->dropped_messages() == 3);
+    CHECK(stream->dropped_bytes() == 3 * message.size());
+    CHECK(stream->pending_writes() == 3 * message.size());
+
+    ::close(fds[0]);
+}
+
+TEST_CASE("StreamOutputAdapter - input-to-output latency") {
+    int in_fds[2];
+    int out_fds[2];
+    REQUIRE(pipe(in_fds) == 0);
+    REQUIRE(pipe(out_fds) == 0);
+
+    scheduler::ScopedScheduler sched;
+    io::FdConfig               in_config;
+    in_config.fd                    = in_fds[0];
+    in_config.owns_fd               = true;
+    in_config.read_config.timestamp = true;
+    auto                   input    = std::make_shared<io::FdStream>("in", in_config);
+    io::StreamInputAdapter input_adapter(input);
+
+    io::FdConfig out_config;
+    out_config.fd                  = out_fds[1];
+    out_config.owns_fd             = true;
+    auto                    output = std::make_shared<io::FdStream>("out", out_config);
+    io::StreamOutputAdapter output_adapter(output);
+
+    // Forward the input to the output, as the client does for a message parsed from it
+    std::chrono::steady_clock::time_point read_time;
+    input_adapter.callback = [&](io::Input& in, uint8_t* data, size_t len) {
+        read_time = in.read_time();
+        output_adapter.write(data, len);
+        output_adapter.record_output_latency(read_time);
+    };
+
+    REQUIRE(input_adapter.schedule(sched));
+    REQUIRE(output_adapter.schedule(sched));
+
+    ::write(in_fds[1], "hello", 5);
+    REQUIRE(run_until_or_timeout(sched, [&] {
+        return output->output_latency().count > 0;
+    }));
+
+    CHECK(read_time != std::chrono::steady_clock::time_point{});
+    CHECK(output->output_latency().count == 1);
+    CHECK(output->output_latency().last.count() >= 0);
+    CHECK(output->output_latency().max == output->output_latency().last);
+    CHECK(input->output_latency().count == 0);
+
+    ::close(in_fds[1]);
+    ::close(out_fds[0]);
+    input_adapter.cancel();
+    output_adapter.cancel();
+}
+
 TEST_CASE("StreamInputAdapter - on_complete called") {
     int fds[2];
     REQUIRE(pipe(fds) == 0);
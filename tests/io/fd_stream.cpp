@@ -280,3 +280,61 @@ TEST_CASE("FdStream - on_complete on closed fd") {
     }));
     CHECK(completed);
 }
+
+namespace {
+struct VectorTarget : public io::ReadTarget {
+    std::vector<uint8_t> buffer = std::vector<uint8_t>(16);
+    size_t               length = 0;
+
+    size_t read_space(uint8_t*& data) NOEXCEPT override {
+        data = buffer.data() + length;
+        return buffer.size() - length;
+    }
+    void commit_read(size_t bytes) NOEXCEPT override { length += bytes; }
+};
+}  // namespace
+
+TEST_CASE("FdStream - read target") {
+    int fds[2];
+    REQUIRE(pipe(fds) == 0);
+
+    scheduler::ScopedScheduler sched;
+    io::FdConfig               config;
+    config.fd      = fds[0];
+    config.owns_fd = true;
+    io::FdStream stream("test", config);
+
+    VectorTarget target;
+    stream.set_read_target(&target);
+
+    std::vector<uint8_t> received;
+    size_t               in_target = 0;
+    stream.on_read([&](io::Stream&, uint8_t* data, size_t len) {
+        // The callback sees the data where it was read to
+        if (data >= target.buffer.data() && data < target.buffer.data() + target.buffer.size()) {
+            in_target += len;
+        }
+        received.insert(received.end(), data, data + len);
+    });
+
+    REQUIRE(stream.schedule(sched));
+
+    ::write(fds[1], "hello", 5);
+    REQUIRE(run_until_or_timeout(sched, [&] {
+        return received.size() >= 5;
+    }));
+    CHECK(target.length == 5);
+    CHECK(in_target == 5);
+    CHECK(memcmp(target.buffer.data(), "hello", 5) == 0);
+
+    // When the target is full the stream reads into its own buffer
+    ::write(fds[1], "0123456789abcdef", 16);
+    REQUIRE(run_until_or_timeout(sched, [&] {
+        return received.size() >= 21;
+    }));
+    CHECK(target.length == 16);
+    CHECK(in_target == 16);
+    CHECK(memcmp(received.data() + 5, "0123456789abcdef", 16) == 0);
+
+    ::close(fds[1]);
+}
@@ -89,3 +89,78 @@ TEST_CASE("SerialStream - configured termios via PTY") {
     }));
     CHECK(memcmp(received.data(), "cfg", 3) == 0);
 }
+
+TEST_CASE("SerialStream - low-latency profile via PTY") {
+    scheduler::ScopedScheduler sched;
+
+    io::PtyConfig pty_config;
+    io::PtyStream pty("fake-serial-pty", pty_config);
+    REQUIRE(pty.schedule(sched));
+
+    // A PTY has no serial driver flags, only the termios part of the profile applies
+    io::SerialConfig serial_config;
+    serial_config.device                = pty.slave_path();
+    serial_config.low_latency           = true;
+    serial_config.read_config.min_bytes = 8;
+    serial_config.read_config.timeout   = std::chrono::milliseconds(20);
+    io::SerialStream serial("test-serial", serial_config);
+    REQUIRE(serial.schedule(sched));
+
+    std::vector<uint8_t> received;
+    std::vector<size_t>  chunks;
+    bool                 timestamped = true;
+    serial.on_read([&](io::Stream& stream, uint8_t* data, size_t len) {
+        received.insert(received.end(), data, data + len);
+        chunks.push_back(len);
+        auto age = std::chrono::steady_clock::now() - stream.last_read_time();
+        if (age < std::chrono::nanoseconds(0) || age > std::chrono::seconds(1)) timestamped = false;
+    });
+
+    // A whole frame wakes the reader once VMIN bytes are in the tty
+    pty.write(reinterpret_cast<uint8_t const*>("0123456789abcdef"), 16);
+    REQUIRE(run_until_or_timeout(sched, [&] {
+        return received.size() >= 16;
+    }));
+    for (auto length : chunks)
+        CHECK(length >= 8);
+
+    // Fewer bytes than VMIN never make the port readable, the read timeout picks them up
+    pty.write(reinterpret_cast<uint8_t const*>("xyz"), 3);
+    REQUIRE(run_until_or_timeout(sched, [&] {
+        return received.size() >= 19;
+    }));
+    CHECK(memcmp(received.data(), "0123456789abcdefxyz", 19) == 0);
+    CHECK(timestamped);
+
+    auto const& latency = serial.read_callback_latency();
+    CHECK(latency.count == chunks.size());
+    CHECK(latency.max >= latency.last);
+    CHECK(latency.mean() <= latency.max);
+}
+
+TEST_CASE("SerialStream - low-latency short trailing frame without read timeout") {
+    scheduler::ScopedScheduler sched;
+
+    io::PtyConfig pty_config;
+    io::PtyStream pty("fake-serial-pty", pty_config);
+    REQUIRE(pty.schedule(sched));
+
+    // Without a read timeout nothing would read the bytes below VMIN, the stream uses VMIN=1
+    io::SerialConfig serial_config;
+    serial_config.device                = pty.slave_path();
+    serial_config.low_latency           = true;
+    serial_config.read_config.min_bytes = 8;
+    io::SerialStream serial("test-serial", serial_config);
+    REQUIRE(serial.schedule(sched));
+
+    std::vector<uint8_t> received;
+    serial.on_read([&](io::Stream&, uint8_t* data, size_t len) {
+        received.insert(received.end(), data, data + len);
+    });
+
+    pty.write(reinterpret_cast<uint8_t const*>("xyz"), 3);
+    REQUIRE(run_until_or_timeout(sched, [&] {
+        return received.size() >= 3;
+    }));
+    CHECK(memcmp(received.data(), "xyz", 3) == 0);
+}
@@ -262,3 +262,69 @@ TEST_CASE("TcpServerStream - periodic client connections") {
     CHECK(disconnections == 100);
     CHECK(clients.empty());
 }
+
+TEST_CASE("TcpServerStream + TcpClientStream - io_uring completions") {
+    scheduler::ScopedScheduler scheduler{scheduler::Backend::IoUring};
+    if (!scheduler.completions()) MESSAGE("io_uring completions are not supported, using epoll");
+
+    auto                listener = std::make_unique<scheduler::TcpInetListenerTask>("127.0.0.1", 0);
+    io::TcpServerStream server("server", std::move(listener));
+    REQUIRE(server.schedule(scheduler));
+
+    io::TcpClientConfig client_config;
+    client_config.host = "127.0.0.1";
+    client_config.port = server.port();
+    io::TcpClientStream client("client", client_config);
+    REQUIRE(client.schedule(scheduler));
+
+    run_until_or_timeout(
+        scheduler,
+        [&] {
+            return client.state() == io::Stream::State::Connected;
+        },
+        std::chrono::milliseconds(2000));
+    REQUIRE(client.state() == io::Stream::State::Connected);
+
+    std::vector<uint8_t> server_recv;
+    std::vector<uint8_t> client_recv;
+    server.on_read([&](io::Stream&, uint8_t* data, size_t len) {
+        server_recv.insert(server_recv.end(), data, data + len);
+    });
+    client.on_read([&](io::Stream&, uint8_t* data, size_t len) {
+        client_recv.insert(client_recv.end(), data, data + len);
+    });
+
+    // Let the server accept the client before it writes
+    run_until_or_timeout(
+        scheduler,
+        [] {
+            return false;
+        },
+        std::chrono::milliseconds(50));
+
+    // Many messages per loop iteration, the writes in flight are batched into the next send and
+    // the reads span several provided buffers
+    size_t const         count = 400;
+    size_t const         size  = 200;
+    std::vector<uint8_t> expected;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t message[size];
+        for (size_t j = 0; j < size; j++)
+            message[j] = static_cast<uint8_t>(i + j);
+        expected.insert(expected.end(), message, message + size);
+        client.write(message, size);
+        server.write(message, size);
+    }
+
+    run_until_or_timeout(
+        scheduler,
+        [&] {
+            return server_recv.size() >= expected.size() && client_recv.size() >= expected.size();
+        },
+        std::chrono::milliseconds(2000));
+
+    CHECK(server_recv == expected);
+    CHECK(client_recv == expected);
+    CHECK(client.dropped_messages() == 0);
+    CHECK(server.dropped_messages() == 0);
+}
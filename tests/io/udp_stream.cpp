@@ -1,4 +1,5 @@
 #include <doctest/doctest.h>
+#include <io/datagram.hpp>
 #include <io/stream/udp_client.hpp>
 #include <io/stream/udp_server.hpp>
 #include <scheduler/scheduler.hpp>
@@ -6,7 +7,11 @@
 
 #include "test_helper.hpp"
 
+#include <arpa/inet.h>
 #include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 TEST_CASE("UdpServerStream + UdpClientStream - loopback") {
     scheduler::ScopedScheduler scheduler;
@@ -60,3 +65,244 @@ TEST_CASE("UdpServerStream + UdpClientStream - loopback") {
     REQUIRE(client_recv.size() == sizeof(msg2));
     CHECK(memcmp(client_recv.data(), msg2, sizeof(msg2)) == 0);
 }
+
+static int bind_loopback(uint16_t& port) {
+    auto fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    REQUIRE(fd >= 0);
+
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    socklen_t length = sizeof(addr);
+    REQUIRE(::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) == 0);
+    port = ntohs(addr.sin_port);
+    return fd;
+}
+
+TEST_CASE("DatagramBatch - receive and coalesce") {
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds) == 0);
+
+    uint8_t const a[] = {1, 2, 3};
+    uint8_t const b[] = {4, 5};
+    uint8_t const c[] = {6, 7, 8, 9};
+    REQUIRE(::send(fds[0], a, sizeof(a), 0) == sizeof(a));
+    REQUIRE(::send(fds[0], b, sizeof(b), 0) == sizeof(b));
+    REQUIRE(::send(fds[0], c, sizeof(c), 0) == sizeof(c));
+
+    io::DatagramBatch batch(2, 8);
+    REQUIRE(batch.receive(fds[1]) == 2);
+    CHECK(batch.length(0) == 3);
+    CHECK(batch.length(1) == 2);
+    REQUIRE(batch.coalesce() == 5);
+    for (uint8_t i = 0; i < 5; i++) {
+        CHECK(batch.buffer()[i] == i + 1);
+    }
+
+    REQUIRE(batch.receive(fds[1]) == 1);
+    CHECK(batch.data(0)[3] == 9);
+    CHECK(batch.receive(fds[1]) < 0);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_CASE("DatagramBatch - truncated datagram grows the slots") {
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds) == 0);
+
+    uint8_t const a[] = {1, 2};
+    uint8_t       large[20];
+    memset(large, 0xAA, sizeof(large));
+    uint8_t const b[] = {3};
+    REQUIRE(::send(fds[0], a, sizeof(a), 0) == sizeof(a));
+    REQUIRE(::send(fds[0], large, sizeof(large), 0) == sizeof(large));
+    REQUIRE(::send(fds[0], b, sizeof(b), 0) == sizeof(b));
+
+    // The large datagram is dropped, the others are delivered
+    io::DatagramBatch batch(4, 8);
+    REQUIRE(batch.receive(fds[1]) == 3);
+    CHECK(batch.truncated(1));
+    CHECK(batch.length(1) == 8);
+    CHECK(batch.truncated_count() == 1);
+    REQUIRE(batch.coalesce() == 3);
+    CHECK(batch.buffer()[0] == 1);
+    CHECK(batch.buffer()[2] == 3);
+
+    // The next receive fits it
+    REQUIRE(::send(fds[0], large, sizeof(large), 0) == sizeof(large));
+    REQUIRE(batch.receive(fds[1]) == 1);
+    CHECK(batch.datagram_size() == sizeof(large));
+    CHECK(!batch.truncated(0));
+    REQUIRE(batch.coalesce() == sizeof(large));
+    CHECK(memcmp(batch.buffer(), large, sizeof(large)) == 0);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_CASE("send_to_all and send_segments") {
+    uint16_t port_a = 0;
+    uint16_t port_b = 0;
+    auto     fd_a   = bind_loopback(port_a);
+    auto     fd_b   = bind_loopback(port_b);
+    auto     fd     = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    REQUIRE(fd >= 0);
+
+    io::DatagramDestination destinations[2];
+    REQUIRE(io::resolve_destination("127.0.0.1", port_a, destinations[0]));
+    REQUIRE(io::resolve_destination("127.0.0.1", port_b, destinations[1]));
+
+    uint8_t const message[] = "fanout";
+    CHECK(io::send_to_all(fd, message, sizeof(message), destinations, 2) == 2);
+
+    io::DatagramBatch batch(4, 64);
+    REQUIRE(batch.receive(fd_a) == 1);
+    CHECK(batch.length(0) == sizeof(message));
+    REQUIRE(batch.receive(fd_b) == 1);
+    CHECK(memcmp(batch.data(0), message, sizeof(message)) == 0);
+
+    // 10 bytes in segments of 4 are 3 datagrams, with or without GSO
+    uint8_t data[10];
+    for (uint8_t i = 0; i < 10; i++) {
+        data[i] = i;
+    }
+    auto gso = true;
+    CHECK(io::send_segments(fd, data, sizeof(data), 4, &destinations[0], gso) == 10);
+
+    REQUIRE(batch.receive(fd_a) == 3);
+    CHECK(batch.length(0) == 4);
+    CHECK(batch.length(1) == 4);
+    CHECK(batch.length(2) == 2);
+    REQUIRE(batch.coalesce() == 10);
+    CHECK(memcmp(batch.buffer(), data, sizeof(data)) == 0);
+
+    ::close(fd);
+    ::close(fd_a);
+    ::close(fd_b);
+}
+
+TEST_CASE("UdpClientStream - fanout") {
+    scheduler::ScopedScheduler scheduler;
+
+    auto                listener = std::make_unique<scheduler::UdpInetListenerTask>("127.0.0.1", 0);
+    io::UdpServerStream server("server", std::move(listener));
+    REQUIRE(server.schedule(scheduler));
+
+    uint16_t port  = 0;
+    auto     other = bind_loopback(port);
+
+    io::UdpClientConfig client_config;
+    client_config.host   = "127.0.0.1";
+    client_config.port   = server.port();
+    client_config.fanout = {"127.0.0.1:" + std::to_string(port)};
+    io::UdpClientStream client("client", client_config);
+    REQUIRE(client.schedule(scheduler));
+
+    std::vector<uint8_t> server_recv;
+    server.on_read([&](io::Stream&, uint8_t* data, size_t len) {
+        server_recv.insert(server_recv.end(), data, data + len);
+    });
+
+    uint8_t const msg[] = "to everyone";
+    client.write(msg, sizeof(msg));
+
+    run_until_or_timeout(
+        scheduler,
+        [&] {
+            return server_recv.size() >= sizeof(msg);
+        },
+        std::chrono::milliseconds(2000));
+    REQUIRE(server_recv.size() == sizeof(msg));
+
+    io::DatagramBatch batch(1, 64);
+    REQUIRE(batch.receive(other) == 1);
+    CHECK(memcmp(batch.data(0), msg, sizeof(msg)) == 0);
+    ::close(other);
+}
+
+TEST_CASE("UdpServerStream - large datagram with default slots") {
+    scheduler::ScopedScheduler scheduler;
+
+    auto                listener = std::make_unique<scheduler::UdpInetListenerTask>("127.0.0.1", 0);
+    io::UdpServerStream server("server", std::move(listener));
+    REQUIRE(server.schedule(scheduler));
+
+    io::DatagramDestination destination{};
+    REQUIRE(io::resolve_destination("127.0.0.1", server.port(), destination));
+
+    std::vector<uint8_t> received;
+    server.on_read([&](io::Stream&, uint8_t* data, size_t len) {
+        received.insert(received.end(), data, data + len);
+    });
+
+    uint16_t port = 0;
+    auto     fd   = bind_loopback(port);
+
+    // Larger than any GNSS message but a valid UDP payload, it must not be dropped
+    std::vector<uint8_t> large(60000);
+    for (size_t i = 0; i < large.size(); i++) {
+        large[i] = static_cast<uint8_t>(i);
+    }
+    REQUIRE(::sendto(fd, large.data(), large.size(), 0,
+                     reinterpret_cast<sockaddr*>(&destination.address),
+                     destination.length) == static_cast<ssize_t>(large.size()));
+
+    run_until_or_timeout(
+        scheduler,
+        [&] {
+            return received.size() >= large.size();
+        },
+        std::chrono::milliseconds(2000));
+    CHECK(received == large);
+    ::close(fd);
+}
+
+TEST_CASE("UdpServerStream - replies to the sender of each batch") {
+    scheduler::ScopedScheduler scheduler;
+
+    auto                listener = std::make_unique<scheduler::UdpInetListenerTask>("127.0.0.1", 0);
+    io::UdpServerStream server("server", std::move(listener));
+    REQUIRE(server.schedule(scheduler));
+
+    io::DatagramDestination destination{};
+    REQUIRE(io::resolve_destination("127.0.0.1", server.port(), destination));
+
+    uint16_t port_a = 0;
+    uint16_t port_b = 0;
+    auto     fd_a   = bind_loopback(port_a);
+    auto     fd_b   = bind_loopback(port_b);
+
+    // Echo every delivery, a batch with datagrams from both senders is split by sender
+    size_t deliveries = 0;
+    server.on_read([&](io::Stream& stream, uint8_t* data, size_t len) {
+        deliveries++;
+        stream.write(data, len);
+    });
+
+    uint8_t const from_a[] = {'a'};
+    uint8_t const from_b[] = {'b'};
+    REQUIRE(::sendto(fd_a, from_a, 1, 0, reinterpret_cast<sockaddr*>(&destination.address),
+                     destination.length) == 1);
+    REQUIRE(::sendto(fd_b, from_b, 1, 0, reinterpret_cast<sockaddr*>(&destination.address),
+                     destination.length) == 1);
+
+    run_until_or_timeout(
+        scheduler,
+        [&] {
+            return deliveries >= 2;
+        },
+        std::chrono::milliseconds(2000));
+    REQUIRE(deliveries == 2);
+
+    io::DatagramBatch batch(4, 64);
+    REQUIRE(batch.receive(fd_a) == 1);
+    CHECK(batch.data(0)[0] == 'a');
+    REQUIRE(batch.receive(fd_b) == 1);
+    CHECK(batch.data(0)[0] == 'b');
+
+    ::close(fd_a);
+    ::close(fd_b);
+}
@@ -1,6 +1,8 @@
 #include <doctest/doctest.h>
 #include <io/write_buffer.hpp>
 
+#include <sys/uio.h>
+
 TEST_CASE("WriteBuffer - enqueue and peek") {
     io::WriteBuffer buf(1024);
 
@@ -116,3 +118,105 @@ TEST_CASE("WriteBuffer - partial consume then enqueue") {
 
     CHECK(buf.size() == 4);
 }
+
+TEST_CASE("WriteBuffer - full buffer drops whole messages") {
+    io::WriteBuffer buf(10);
+
+    uint8_t a[] = {1, 2, 3, 4};
+    uint8_t b[] = {5, 6, 7};
+    uint8_t c[] = {8, 9, 10, 11, 12};
+    buf.enqueue_message(a, 4);
+    buf.enqueue_message(b, 3);
+    CHECK(buf.message_count() == 2);
+
+    buf.enqueue_message(c, 5);
+    CHECK(buf.size() == 8);
+    CHECK(buf.message_count() == 2);
+    CHECK(buf.dropped_messages() == 1);
+    CHECK(buf.dropped_bytes() == 4);
+
+    auto [ptr, len] = buf.peek();
+    CHECK(len == 3);
+    CHECK(ptr[0] == 5);
+
+    // A message larger than the buffer is dropped
+    uint8_t large[11] = {};
+    buf.enqueue_message(large, 11);
+    CHECK(buf.size() == 8);
+    CHECK(buf.dropped_messages() == 2);
+    CHECK(buf.dropped_bytes() == 15);
+}
+
+TEST_CASE("WriteBuffer - partially written message is kept") {
+    io::WriteBuffer buf(10);
+
+    uint8_t a[] = {1, 2, 3, 4, 5, 6};
+    buf.enqueue_message(a, 6, 2);
+    CHECK(buf.size() == 4);
+
+    uint8_t b[] = {7, 8, 9};
+    buf.enqueue_message(b, 3);
+    buf.consume(1);
+
+    // Only the message after the partially written one can be dropped
+    uint8_t c[] = {10, 11, 12, 13, 14};
+    buf.enqueue_message(c, 5);
+    CHECK(buf.dropped_messages() == 1);
+    CHECK(buf.message_count() == 2);
+
+    auto [ptr, len] = buf.peek();
+    CHECK(len == 3);
+    CHECK(ptr[0] == 4);
+
+    // When only the partially written message is left, the new message is dropped
+    uint8_t d[8] = {};
+    buf.enqueue_message(d, 8);
+    CHECK(buf.dropped_messages() == 3);
+    CHECK(buf.size() == 3);
+    CHECK(buf.message_count() == 1);
+}
+
+TEST_CASE("WriteBuffer - epoch drop policy") {
+    io::WriteBuffer buf(12);
+    buf.set_drop_policy(io::WriteBuffer::DropPolicy::Epoch);
+
+    uint8_t data[4] = {};
+    for (uint8_t i = 0; i < 3; i++) {
+        data[0] = i;
+        buf.enqueue_message(data, 4);
+        if (i == 1) buf.end_epoch();
+    }
+    CHECK(buf.size() == 12);
+
+    // The first epoch is dropped as a whole
+    data[0] = 3;
+    buf.enqueue_message(data, 4);
+    CHECK(buf.dropped_messages() == 2);
+    CHECK(buf.message_count() == 2);
+
+    auto [ptr, len] = buf.peek();
+    CHECK(len == 4);
+    CHECK(ptr[0] == 2);
+}
+
+TEST_CASE("WriteBuffer - gather") {
+    io::WriteBuffer buf(1024);
+
+    uint8_t a[] = {1, 2, 3};
+    uint8_t b[] = {4, 5};
+    buf.enqueue_message(a, 3);
+    buf.enqueue_message(b, 2);
+    buf.consume(1);
+
+    struct iovec iov[4];
+    REQUIRE(buf.gather(iov, 4) == 2);
+    CHECK(iov[0].iov_len == 2);
+    CHECK(static_cast<uint8_t*>(iov[0].iov_base)[0] == 2);
+    CHECK(iov[1].iov_len == 2);
+    CHECK(static_cast<uint8_t*>(iov[1].iov_base)[0] == 4);
+    CHECK(buf.gather(iov, 1) == 1);
+
+    buf.consume(3);
+    CHECK(buf.size() == 1);
+    CHECK(buf.message_count() == 1);
+}
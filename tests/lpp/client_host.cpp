@@ -0,0 +1,123 @@
+#include <doctest/doctest.h>
+#include <lpp/client.hpp>
+#include <lpp/client_host.hpp>
+#include <lpp/mock_server.hpp>
+#include <scheduler/scheduler.hpp>
+
+#include <chrono>
+#include <set>
+
+static lpp::PeriodicRequestAssistanceData osr_request() {
+    lpp::PeriodicRequestAssistanceData request{};
+    request.type                    = lpp::PeriodicRequestAssistanceData::Type::OSR;
+    request.gnss.gps                = true;
+    request.config.delivery_amount  = 32;
+    request.config.osr_observations = 1;
+    request.config.osr_residuals    = 1;
+    return request;
+}
+
+TEST_CASE("ClientHost - sessions against the mock location server") {
+    scheduler::ScopedScheduler scheduler;
+
+    lpp::MockLocationServer server{"127.0.0.1", 0};
+    server.set_period(std::chrono::milliseconds(50));
+    REQUIRE(server.schedule(scheduler));
+    REQUIRE(server.port() != 0);
+
+    constexpr uint32_t SESSIONS = 16;
+    lpp::ClientHost    host{"127.0.0.1", server.port(), osr_request()};
+
+    std::set<lpp::ClientHost::SessionId> started;
+    size_t                               shared_messages = 0;
+    size_t                               routed_messages = 0;
+    host.on_started = [&](lpp::ClientHost::SessionId id) {
+        started.insert(id);
+    };
+    host.on_message = [&](lpp::ClientHost::SessionId, lpp::Message message) {
+        CHECK(lpp::is_provide_assistance_data(message));
+        shared_messages++;
+    };
+
+    std::vector<lpp::ClientHost::SessionId> ids;
+    for (uint32_t i = 0; i < SESSIONS; i++) {
+        ids.push_back(host.add_session(supl::Identity::msisdn(919825098250 + i),
+                                       supl::Cell::lte(240, 1, 1, 3 + i)));
+    }
+    CHECK(host.size() == SESSIONS);
+
+    host.set_route(ids[0], [&](lpp::ClientHost::SessionId id, lpp::Message) {
+        CHECK(id == ids[0]);
+        routed_messages++;
+    });
+
+    host.schedule(&scheduler);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto done     = [&]() {
+        for (auto id : ids) {
+            auto stats = host.stats(id);
+            if (!stats || stats->messages < 3) return false;
+        }
+        return true;
+    };
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        scheduler.execute_timeout(std::chrono::milliseconds(50));
+    }
+
+    CHECK(done());
+    CHECK(host.connected() == SESSIONS);
+    CHECK(started.size() == SESSIONS);
+    CHECK(routed_messages >= 3);
+    CHECK(shared_messages >= 3 * (SESSIONS - 1));
+    CHECK(server.stats().established == SESSIONS);
+    CHECK(server.stats().requests == SESSIONS);
+
+    SUBCASE("remove session") {
+        CHECK(host.remove_session(ids[1]));
+        CHECK_FALSE(host.remove_session(ids[1]));
+        CHECK(host.client(ids[1]) == nullptr);
+        CHECK(host.size() == SESSIONS - 1);
+        CHECK(host.connected() == SESSIONS - 1);
+
+        scheduler.execute_timeout(std::chrono::milliseconds(200));
+        CHECK(server.stats().closed == 1);
+        CHECK(server.connections() == SESSIONS - 1);
+    }
+
+    host.cancel();
+    server.cancel();
+}
+
+TEST_CASE("ClientHost - padded messages from the mock location server") {
+    scheduler::ScopedScheduler scheduler;
+
+    lpp::MockLocationServer server{"127.0.0.1", 0};
+    server.set_period(std::chrono::milliseconds(20));
+    server.set_message_size(1500);
+    REQUIRE(server.schedule(scheduler));
+
+    lpp::ClientHost host{"127.0.0.1", server.port(), osr_request()};
+
+    std::vector<size_t> sizes;
+    host.on_decoded = [&](lpp::ClientHost::SessionId, size_t size,
+                          std::chrono::steady_clock::duration) {
+        sizes.push_back(size);
+    };
+
+    auto id = host.add_session(supl::Identity::msisdn(919825098250), supl::Cell::lte(240, 1, 1, 3));
+    host.schedule(&scheduler);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (host.stats(id)->messages < 3 && std::chrono::steady_clock::now() < deadline) {
+        scheduler.execute_timeout(std::chrono::milliseconds(50));
+    }
+
+    REQUIRE(host.stats(id)->messages >= 3);
+    // The last decoded messages are the padded assistance data, the handshake messages are small
+    CHECK(sizes.back() >= 1400);
+    CHECK(sizes.back() <= 1600);
+
+    host.cancel();
+    server.cancel();
+}
@@ -91,13 +91,14 @@ TEST_CASE("Event pool - update interests") {
     close(fd);
 }
 
-TEST_CASE("Event pool - pool exhaustion") {
+TEST_CASE("Event pool - pool growth") {
     scheduler::ScopedScheduler sched;
 
     std::vector<int>                       fds;
     std::vector<scheduler::ScheduledEvent> events;
 
-    for (int i = 0; i < scheduler::Scheduler::MAX_EVENT_SLOTS; i++) {
+    // More events than the previous fixed pool held
+    for (int i = 0; i < 300; i++) {
         int fd = eventfd(0, EFD_NONBLOCK);
         REQUIRE(fd >= 0);
         fds.push_back(fd);
@@ -111,15 +112,19 @@ TEST_CASE("Event pool - pool exhaustion") {
         events.push_back(event);
     }
 
-    int extra_fd = eventfd(0, EFD_NONBLOCK);
-    REQUIRE(extra_fd >= 0);
-    auto exhausted_event = sched.register_fd(
-        extra_fd, scheduler::EventInterest::Read,
+    // Freed slots are reused before the pool grows again
+    sched.unregister(events[10]);
+    sched.execute_once();
+
+    auto reused = sched.register_fd(
+        fds[10], scheduler::EventInterest::Read,
         [](scheduler::EventInterest) {
         },
-        "exhausted");
-    CHECK_FALSE(exhausted_event.valid());
-    close(extra_fd);
+        "reused");
+    REQUIRE(reused.valid());
+    CHECK(reused.index == events[10].index);
+    CHECK(reused.generation != events[10].generation);
+    events[10] = reused;
 
     for (auto& event : events) {
         sched.unregister(event);
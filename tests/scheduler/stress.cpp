@@ -1,3 +1,4 @@
+#include <cstdio>
 #include <cxx11_compat.hpp>
 #include <doctest/doctest.h>
 #include <memory>
@@ -5,6 +6,7 @@
 #include <scheduler/scheduler.hpp>
 #include <scheduler/timeout.hpp>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <vector>
 
@@ -131,3 +133,302 @@ TEST_CASE("Deferred callback before execute") {
 
     CHECK(deferred_count == 1);
 }
+
+TEST_CASE("Many socket pairs - backends") {
+    {
+        // io_uring is opt-in
+        scheduler::ScopedScheduler sched;
+        CHECK(sched.backend() == scheduler::Backend::Epoll);
+    }
+
+    for (auto backend : {scheduler::Backend::Epoll, scheduler::Backend::IoUring}) {
+        for (auto max_events : {1, 32}) {
+            CAPTURE(static_cast<int>(backend));
+            CAPTURE(max_events);
+            scheduler::ScopedScheduler sched{backend};
+            sched.set_max_events_per_wait(max_events);
+            if (backend == scheduler::Backend::Epoll) {
+                CHECK(sched.backend() == scheduler::Backend::Epoll);
+            }
+
+            int const                                                        N = 200;
+            std::vector<int>                                                 write_fds;
+            std::vector<std::unique_ptr<scheduler::OwnedFileDescriptorTask>> tasks;
+            int                                                              reads = 0;
+
+            for (int i = 0; i < N; i++) {
+                int pair[2];
+                REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) == 0);
+                write_fds.push_back(pair[1]);
+
+                // One byte per callback, the event must fire again while data is left
+                auto task     = std::make_unique<scheduler::OwnedFileDescriptorTask>(pair[0]);
+                task->on_read = [&reads](scheduler::OwnedFileDescriptorTask& t) {
+                    char buf[1];
+                    if (::read(t.fd(), buf, 1) == 1) reads++;
+                };
+                REQUIRE(task->schedule(sched));
+                tasks.push_back(std::move(task));
+            }
+
+            for (int round = 1; round <= 3; round++) {
+                for (auto fd : write_fds)
+                    REQUIRE(::write(fd, "xy", 2) == 2);
+                for (int i = 0; i < 200 && reads < round * 2 * N; i++)
+                    sched.execute_timeout(std::chrono::milliseconds(10));
+            }
+            CHECK(reads == 3 * 2 * N);
+
+            // Cancelled tasks are not called again
+            for (int i = 0; i < N; i += 2)
+                tasks[i]->cancel();
+            for (auto fd : write_fds)
+                REQUIRE(::write(fd, "z", 1) == 1);
+            sched.execute_timeout(std::chrono::milliseconds(100));
+            CHECK(reads == 3 * 2 * N + N / 2);
+
+            tasks.clear();
+            for (auto fd : write_fds)
+                ::close(fd);
+        }
+    }
+}
+
+TEST_CASE("Update interests - backends") {
+    for (auto backend : {scheduler::Backend::Epoll, scheduler::Backend::IoUring}) {
+        CAPTURE(static_cast<int>(backend));
+        scheduler::ScopedScheduler sched{backend};
+
+        int pair[2];
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) == 0);
+
+        int  writable = 0;
+        int  readable = 0;
+        auto event    = sched.register_fd(
+            pair[0], scheduler::EventInterest::Read,
+            [&](scheduler::EventInterest triggered) {
+                if (triggered & scheduler::EventInterest::Read) readable++;
+                if (triggered & scheduler::EventInterest::Write) writable++;
+            },
+            "pair");
+        REQUIRE(event.valid());
+
+        // Nothing to read yet
+        sched.execute_timeout(std::chrono::milliseconds(20));
+        CHECK(readable == 0);
+        CHECK(writable == 0);
+
+        // The socket is always writable, the event fires on every wait
+        sched.update_interests(event, scheduler::EventInterest::Write);
+        sched.execute_timeout(std::chrono::milliseconds(20));
+        CHECK(writable > 1);
+
+        auto writes = writable;
+        sched.update_interests(event, scheduler::EventInterest::Read);
+        REQUIRE(::write(pair[1], "x", 1) == 1);
+        sched.execute_timeout(std::chrono::milliseconds(20));
+        CHECK(readable > 1);
+        CHECK(writable == writes);
+
+        sched.unregister(event);
+        ::close(pair[0]);
+        ::close(pair[1]);
+    }
+}
+
+TEST_CASE("Register regular file - backends") {
+    for (auto backend : {scheduler::Backend::Epoll, scheduler::Backend::IoUring}) {
+        CAPTURE(static_cast<int>(backend));
+        scheduler::ScopedScheduler sched{backend};
+
+        // Regular files are always ready, epoll refuses them and so must the io_uring backend
+        FILE* file = tmpfile();
+        REQUIRE(file != nullptr);
+        auto event = sched.register_fd(
+            fileno(file), scheduler::EventInterest::Read, [](scheduler::EventInterest) {}, "file");
+        CHECK_FALSE(event.valid());
+        fclose(file);
+
+        auto invalid = sched.register_fd(
+            -1, scheduler::EventInterest::Read, [](scheduler::EventInterest) {}, "invalid");
+        CHECK_FALSE(invalid.valid());
+    }
+}
+
+static uint8_t pattern(int socket, size_t offset) {
+    return static_cast<uint8_t>(socket * 31 + offset * 7);
+}
+
+TEST_CASE("Receive completions - many socket pairs") {
+    for (auto backend : {scheduler::Backend::Epoll, scheduler::Backend::IoUring}) {
+        CAPTURE(static_cast<int>(backend));
+        scheduler::ScopedScheduler sched{backend};
+        sched.set_max_events_per_wait(32);
+
+        int const                                                        N = 64;
+        std::vector<int>                                                 write_fds;
+        std::vector<std::unique_ptr<scheduler::OwnedFileDescriptorTask>> tasks;
+        std::vector<size_t>                                              received(N, 0);
+        int                                                              mismatches = 0;
+        int                                                              reads      = 0;
+
+        for (int i = 0; i < N; i++) {
+            int pair[2];
+            REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) == 0);
+            write_fds.push_back(pair[1]);
+
+            auto task     = std::make_unique<scheduler::OwnedFileDescriptorTask>(pair[0]);
+            task->on_read = [&reads, &received, &mismatches, i](
+                                scheduler::OwnedFileDescriptorTask& t) {
+                uint8_t buffer[4096];
+                auto    result = ::read(t.fd(), buffer, sizeof(buffer));
+                for (ssize_t j = 0; j < result; j++) {
+                    if (buffer[j] != pattern(i, received[i] + j)) mismatches++;
+                }
+                if (result > 0) received[i] += static_cast<size_t>(result);
+                reads++;
+            };
+            REQUIRE(task->schedule(sched));
+            auto receiving = task->receive([&received, &mismatches, i](uint8_t* data,
+                                                                       ssize_t  result) {
+                if (result <= 0) {
+                    mismatches++;
+                    return;
+                }
+                for (ssize_t j = 0; j < result; j++) {
+                    if (data[j] != pattern(i, received[i] + j)) mismatches++;
+                }
+                received[i] += static_cast<size_t>(result);
+            });
+            CHECK(receiving == sched.completions());
+            tasks.push_back(std::move(task));
+        }
+        if (backend == scheduler::Backend::Epoll) CHECK_FALSE(sched.completions());
+
+        // More than the provided buffers hold, the receives run out of buffers and are re-armed
+        size_t const     size = 16 * 1024;
+        std::vector<int> written(N, 0);
+        for (int round = 1; round <= 3; round++) {
+            for (int i = 0; i < N; i++) {
+                uint8_t data[size];
+                for (size_t j = 0; j < size; j++)
+                    data[j] = pattern(i, written[i] + j);
+                REQUIRE(::write(write_fds[i], data, size) == static_cast<ssize_t>(size));
+                written[i] += static_cast<int>(size);
+            }
+
+            auto done = [&] {
+                for (auto count : received)
+                    if (count < round * size) return false;
+                return true;
+            };
+            for (int i = 0; i < 500 && !done(); i++)
+                sched.execute_timeout(std::chrono::milliseconds(10));
+            CHECK(done());
+        }
+        CHECK(mismatches == 0);
+        for (int i = 0; i < N; i++)
+            CHECK(received[i] == 3 * size);
+        // The socket is not reported as readable while it is received
+        if (sched.completions()) CHECK(reads == 0);
+
+        tasks.clear();
+        for (auto fd : write_fds)
+            ::close(fd);
+    }
+}
+
+TEST_CASE("Send completions - partial sends and unregister") {
+    scheduler::ScopedScheduler sched{scheduler::Backend::IoUring};
+    if (!sched.completions()) {
+        MESSAGE("io_uring completions are not supported");
+        return;
+    }
+
+    int pair[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) == 0);
+    scheduler::OwnedFileDescriptorTask task(pair[0]);
+    REQUIRE(task.schedule(sched));
+
+    // Larger than the socket buffer, the kernel sends it in parts while the peer reads
+    std::vector<uint8_t> first(256 * 1024);
+    std::vector<uint8_t> second(512 * 1024);
+    for (size_t i = 0; i < first.size(); i++)
+        first[i] = pattern(1, i);
+    for (size_t i = 0; i < second.size(); i++)
+        second[i] = pattern(1, first.size() + i);
+
+    struct iovec iov[2];
+    iov[0].iov_base = first.data();
+    iov[0].iov_len  = first.size();
+    iov[1].iov_base = second.data();
+    iov[1].iov_len  = second.size();
+
+    // Both sends are queued, each request reports the bytes it sent
+    ssize_t sent   = 0;
+    int     calls  = 0;
+    int     errors = 0;
+    auto    on_send = [&](ssize_t result) {
+        if (result > 0)
+            sent += result;
+        else
+            errors++;
+        calls++;
+    };
+    REQUIRE(task.send(iov, 2, on_send));
+    REQUIRE(task.send(iov, 1, on_send));
+    // The data has been copied
+    first.assign(first.size(), 0);
+
+    auto total = static_cast<ssize_t>(2 * iov[0].iov_len + iov[1].iov_len);
+    std::vector<uint8_t> peer;
+    for (int i = 0; i < 1000 && sent < total && errors == 0; i++) {
+        sched.execute_timeout(std::chrono::milliseconds(5));
+        uint8_t buffer[65536];
+        ssize_t result;
+        while ((result = ::read(pair[1], buffer, sizeof(buffer))) > 0)
+            peer.insert(peer.end(), buffer, buffer + result);
+    }
+    CHECK(errors == 0);
+    CHECK(calls > 0);
+    REQUIRE(sent == total);
+    uint8_t buffer[65536];
+    ssize_t result;
+    while ((result = ::read(pair[1], buffer, sizeof(buffer))) > 0)
+        peer.insert(peer.end(), buffer, buffer + result);
+    REQUIRE(peer.size() == static_cast<size_t>(sent));
+    int mismatches = 0;
+    for (size_t i = 0; i < peer.size(); i++) {
+        auto offset = i < first.size() + second.size() ? i : i - first.size() - second.size();
+        if (peer[i] != pattern(1, offset)) mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    // A send the peer never reads is cancelled when the event is unregistered and the callback is
+    // not called. The next registration can receive while the cancellation completes.
+    REQUIRE(task.send(iov + 1, 1, [&](ssize_t) {
+        calls++;
+    }));
+    // The first part fills the socket buffer and completes, the rest blocks
+    sched.execute_timeout(std::chrono::milliseconds(20));
+    auto before = calls;
+    task.cancel();
+    sched.execute_timeout(std::chrono::milliseconds(20));
+    CHECK(calls == before);
+
+    int other[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, other) == 0);
+    scheduler::OwnedFileDescriptorTask reused(other[0]);
+    REQUIRE(reused.schedule(sched));
+    std::vector<uint8_t> reused_received;
+    REQUIRE(reused.receive([&](uint8_t* data, ssize_t length) {
+        if (length > 0) reused_received.insert(reused_received.end(), data, data + length);
+    }));
+    REQUIRE(::write(other[1], "abc", 3) == 3);
+    for (int i = 0; i < 100 && reused_received.size() < 3; i++)
+        sched.execute_timeout(std::chrono::milliseconds(10));
+    CHECK(reused_received.size() == 3);
+
+    ::close(pair[1]);
+    ::close(other[1]);
+}
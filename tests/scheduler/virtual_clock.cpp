@@ -0,0 +1,124 @@
+#include <chrono>
+#include <doctest/doctest.h>
+#include <scheduler/periodic.hpp>
+#include <scheduler/scheduler.hpp>
+#include <scheduler/timeout.hpp>
+#include <scheduler/virtual_clock.hpp>
+#include <string>
+#include <vector>
+
+using scheduler::VirtualClock;
+
+namespace {
+struct VirtualClockGuard {
+    VirtualClockGuard() { VirtualClock::enable(); }
+    ~VirtualClockGuard() { VirtualClock::reset(); }
+};
+
+struct Fired {
+    std::string name;
+    int64_t     time_us;
+};
+}  // namespace
+
+static constexpr int64_t START_US = 1700000000000000ll;
+
+TEST_CASE("VirtualClock - timers expire in deadline order") {
+    VirtualClockGuard          guard;
+    scheduler::ScopedScheduler sched;
+
+    std::vector<Fired> fired;
+    int64_t            listener_us = 0;
+    VirtualClock::set_listener([&](int64_t now_us) {
+        listener_us = now_us;
+    });
+
+    // Armed before the clock is started, relative to the first timestamp
+    scheduler::PeriodicTask periodic(std::chrono::seconds(1));
+    periodic.callback = [&]() {
+        fired.push_back({"periodic", VirtualClock::now_us()});
+    };
+    REQUIRE(periodic.schedule(sched));
+
+    scheduler::TimeoutTask timeout(std::chrono::milliseconds(2500), [&]() {
+        fired.push_back({"timeout", VirtualClock::now_us()});
+    });
+    scheduler::TimeoutTask cancelled(std::chrono::milliseconds(1500), [&]() {
+        fired.push_back({"cancelled", VirtualClock::now_us()});
+    });
+    cancelled.cancel();
+
+    // Same deadline as the second expiration of the periodic task, expires before it because the
+    // periodic task is re-armed when it expires the first time
+    scheduler::RepeatableTimeoutTask repeatable(std::chrono::seconds(2));
+    repeatable.callback = [&]() {
+        fired.push_back({"repeatable", VirtualClock::now_us()});
+    };
+    repeatable.schedule();
+
+    // Not driven by the virtual clock
+    scheduler::RepeatableTimeoutTask monotonic(std::chrono::hours(1),
+                                               scheduler::TimerClock::Monotonic);
+    monotonic.schedule();
+    CHECK(VirtualClock::pending() == 3);
+
+    VirtualClock::advance_to(START_US);
+    CHECK(VirtualClock::started());
+    CHECK(listener_us == START_US);
+    CHECK(fired.empty());
+
+    VirtualClock::advance_to(START_US + 3200000);
+    CHECK(VirtualClock::now_us() == START_US + 3200000);
+    CHECK(listener_us == START_US + 3200000);
+
+    std::vector<Fired> expected = {
+        {"periodic", START_US + 1000000}, {"repeatable", START_US + 2000000},
+        {"periodic", START_US + 2000000}, {"timeout", START_US + 2500000},
+        {"periodic", START_US + 3000000},
+    };
+    REQUIRE(fired.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        CAPTURE(i);
+        CHECK(fired[i].name == expected[i].name);
+        CHECK(fired[i].time_us == expected[i].time_us);
+    }
+
+    // Time does not go backwards
+    VirtualClock::advance_to(START_US);
+    CHECK(VirtualClock::now_us() == START_US + 3200000);
+
+    // Restarting is relative to the virtual time
+    fired.clear();
+    repeatable.restart();
+    VirtualClock::advance_to(START_US + 5300000);
+    REQUIRE(fired.size() == 3);
+    CHECK(fired[0].name == "periodic");
+    CHECK(fired[1].name == "periodic");
+    CHECK(fired[2].name == "repeatable");
+    CHECK(fired[2].time_us == START_US + 5200000);
+}
+
+TEST_CASE("VirtualClock - a day of periodic timers") {
+    VirtualClockGuard          guard;
+    scheduler::ScopedScheduler sched;
+
+    int                     count = 0;
+    scheduler::PeriodicTask periodic(std::chrono::seconds(1));
+    periodic.callback = [&]() {
+        count++;
+    };
+    REQUIRE(periodic.schedule(sched));
+
+    auto start = std::chrono::steady_clock::now();
+    VirtualClock::advance_to(START_US);
+    for (int64_t hour = 1; hour <= 24; hour++) {
+        VirtualClock::advance_to(START_US + hour * 3600 * 1000000ll);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(count == 86400);
+    CHECK(elapsed < std::chrono::seconds(60));
+
+    CHECK(periodic.cancel());
+    CHECK(VirtualClock::pending() == 0);
+}
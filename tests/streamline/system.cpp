@@ -0,0 +1,194 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <memory>
+#include <scheduler/scheduler.hpp>
+#include <streamline/system.hpp>
+#include <vector>
+
+namespace {
+struct Value {
+    int value;
+};
+
+struct Recorder : public streamline::Consumer<std::unique_ptr<Value>> {
+    std::vector<int>& received;
+    Recorder(std::vector<int>& r) : received(r) {}
+    void consume(streamline::System&, DataType&& data, uint64_t) override {
+        received.push_back(data ? data->value : -1);
+    }
+    char const* name() const NOEXCEPT override { return "Recorder"; }
+};
+
+struct Watcher : public streamline::Inspector<std::unique_ptr<Value>> {
+    std::vector<int>& received;
+    Watcher(std::vector<int>& r) : received(r) {}
+    void inspect(streamline::System&, DataType const& data, uint64_t) override {
+        received.push_back(data->value);
+    }
+    char const* name() const NOEXCEPT override { return "Watcher"; }
+};
+
+struct SharedRecorder : public streamline::Consumer<streamline::Shared<Value>> {
+    std::vector<Value const*>& received;
+    SharedRecorder(std::vector<Value const*>& r) : received(r) {}
+    void consume(streamline::System&, DataType&& data, uint64_t) override {
+        received.push_back(data.get());
+    }
+    char const* name() const NOEXCEPT override { return "SharedRecorder"; }
+};
+struct Derived {
+    int value;
+};
+
+using TimePoint = std::chrono::steady_clock::time_point;
+
+/// Records the read time of every value and pushes a `Derived` message for it.
+struct Forwarder : public streamline::Consumer<std::unique_ptr<Value>> {
+    std::vector<TimePoint>& times;
+    Forwarder(std::vector<TimePoint>& t) : times(t) {}
+    void consume(streamline::System& system, DataType&& data, uint64_t) override {
+        times.push_back(system.read_time());
+        system.push(Derived{data->value});
+    }
+    char const* name() const NOEXCEPT override { return "Forwarder"; }
+};
+
+struct DerivedRecorder : public streamline::Consumer<Derived> {
+    std::vector<TimePoint>& times;
+    DerivedRecorder(std::vector<TimePoint>& t) : times(t) {}
+    void consume(streamline::System& system, DataType&&, uint64_t) override {
+        times.push_back(system.read_time());
+    }
+    char const* name() const NOEXCEPT override { return "DerivedRecorder"; }
+};
+}  // namespace
+
+namespace streamline {
+template <>
+struct Clone<std::unique_ptr<Value>> {
+    std::unique_ptr<Value> operator()(std::unique_ptr<Value> const& v) {
+        return std::unique_ptr<Value>(new Value{v->value});
+    }
+};
+}  // namespace streamline
+
+TEST_CASE("Channel push is delivered in one batch per tick") {
+    scheduler::ScopedScheduler sched;
+    streamline::System         system{sched};
+
+    std::vector<int> received;
+    system.add_consumer<Recorder>(received);
+
+    auto channel = system.channel<std::unique_ptr<Value>>();
+    REQUIRE(channel.valid());
+    REQUIRE(channel.has_listeners());
+
+    for (int i = 0; i < 100; i++) {
+        channel.push(std::unique_ptr<Value>(new Value{i}));
+    }
+
+    sched.execute_once();
+
+    REQUIRE(received.size() == 100);
+    for (int i = 0; i < 100; i++) {
+        CHECK(received[static_cast<size_t>(i)] == i);
+    }
+}
+
+TEST_CASE("Channel without listeners drops data") {
+    scheduler::ScopedScheduler sched;
+    streamline::System         system{sched};
+
+    auto channel = system.channel<std::unique_ptr<Value>>();
+    CHECK(channel.valid());
+    CHECK_FALSE(channel.has_listeners());
+    channel.push(std::unique_ptr<Value>(new Value{1}));
+}
+
+TEST_CASE("Channel in sync mode dispatches immediately") {
+    streamline::System system;
+    system.set_sync_mode(true);
+
+    std::vector<int> inspected;
+    std::vector<int> consumed;
+    system.add_inspector<Watcher>(inspected);
+    system.add_consumer<Recorder>(consumed);
+
+    auto channel = system.channel<std::unique_ptr<Value>>();
+    channel.push(std::unique_ptr<Value>(new Value{7}));
+
+    REQUIRE(inspected.size() == 1);
+    REQUIRE(consumed.size() == 1);
+    CHECK(inspected[0] == 7);
+    CHECK(consumed[0] == 7);
+}
+
+TEST_CASE("Every consumer receives a valid payload") {
+    scheduler::ScopedScheduler sched;
+    streamline::System         system{sched};
+
+    std::vector<int> a, b, c;
+    system.add_consumer<Recorder>(a);
+    system.add_consumer<Recorder>(b);
+    system.add_consumer<Recorder>(c);
+
+    system.push(std::unique_ptr<Value>(new Value{42}));
+    sched.execute_once();
+
+    REQUIRE(a.size() == 1);
+    REQUIRE(b.size() == 1);
+    REQUIRE(c.size() == 1);
+    CHECK(a[0] == 42);
+    CHECK(b[0] == 42);
+    CHECK(c[0] == 42);
+}
+
+TEST_CASE("Shared payloads are not copied between consumers") {
+    scheduler::ScopedScheduler sched;
+    streamline::System         system{sched};
+
+    std::vector<Value const*> a, b;
+    system.add_consumer<SharedRecorder>(a);
+    system.add_consumer<SharedRecorder>(b);
+
+    auto channel = system.channel<streamline::Shared<Value>>();
+    auto value   = streamline::make_shared<Value>(Value{3});
+    auto pointer = value.get();
+    channel.push(std::move(value));
+    sched.execute_once();
+
+    REQUIRE(a.size() == 1);
+    REQUIRE(b.size() == 1);
+    CHECK(a[0] == pointer);
+    CHECK(b[0] == pointer);
+}
+
+TEST_CASE("Read time is carried to derived messages") {
+    scheduler::ScopedScheduler sched;
+    streamline::System         system{sched};
+
+    std::vector<TimePoint> forwarded, derived;
+    system.add_consumer<Forwarder>(forwarded);
+    system.add_consumer<DerivedRecorder>(derived);
+    system.channel<Derived>();
+
+    auto first  = TimePoint{} + std::chrono::milliseconds(10);
+    auto second = TimePoint{} + std::chrono::milliseconds(20);
+    system.set_read_time(first);
+    system.push(std::unique_ptr<Value>(new Value{1}));
+    system.set_read_time(second);
+    system.push(std::unique_ptr<Value>(new Value{2}));
+    system.set_read_time({});
+
+    sched.execute_once();
+    REQUIRE(forwarded.size() == 2);
+    CHECK(forwarded[0] == first);
+    CHECK(forwarded[1] == second);
+    CHECK(system.read_time() == TimePoint{});
+
+    sched.execute_once();
+    REQUIRE(derived.size() == 2);
+    CHECK(derived[0] == first);
+    CHECK(derived[1] == second);
+    CHECK(system.read_time() == TimePoint{});
+}
@@ -0,0 +1,91 @@
+#include <doctest/doctest.h>
+#include <supl/pos.hpp>
+#include <supl/server.hpp>
+#include <supl/session.hpp>
+
+#include <chrono>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+static supl::POS lpp_pos(size_t size) {
+    supl::Payload payload{};
+    payload.type = supl::Payload::Type::LPP;
+    payload.data.assign(size, 0x55);
+
+    supl::POS pos{};
+    pos.payloads.push_back(std::move(payload));
+    return pos;
+}
+
+TEST_CASE("ServerSession - send queues instead of blocking on a full socket") {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+
+    int buffer_size = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+
+    uint8_t localhost[4] = {127, 0, 0, 1};
+    supl::ServerSession session{fds[0], supl::VERSION_2_1, supl::Identity::ipv4(localhost), 1};
+
+    // The peer does not read, the messages do not fit in the socket
+    constexpr size_t MESSAGES = 4;
+    auto             start    = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < MESSAGES; i++) {
+        REQUIRE(session.send(lpp_pos(30000)));
+    }
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    CHECK(session.wants_write());
+    CHECK(session.send_buffer().size() > 0);
+
+    // Reading on the peer side and flushing delivers every PDU whole and in order
+    std::vector<uint8_t> received;
+    uint8_t              buffer[8192];
+    auto                 deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (session.wants_write() && std::chrono::steady_clock::now() < deadline) {
+        auto result = ::read(fds[1], buffer, sizeof(buffer));
+        if (result > 0) received.insert(received.end(), buffer, buffer + result);
+        REQUIRE(session.flush());
+    }
+    for (;;) {
+        auto result = ::read(fds[1], buffer, sizeof(buffer));
+        if (result <= 0) break;
+        received.insert(received.end(), buffer, buffer + result);
+    }
+
+    CHECK_FALSE(session.wants_write());
+    CHECK(session.send_buffer().empty());
+    CHECK(session.send_buffer().dropped_messages() == 0);
+
+    size_t offset = 0;
+    size_t pdus   = 0;
+    while (offset < received.size()) {
+        auto length = supl::Session::pdu_length(received.data() + offset, received.size() - offset);
+        REQUIRE(length > 30000);
+        offset += length;
+        pdus++;
+    }
+    CHECK(offset == received.size());
+    CHECK(pdus == MESSAGES);
+
+    ::close(fds[1]);
+}
+
+TEST_CASE("ServerSession - flush fails once the peer is gone") {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) == 0);
+
+    int buffer_size = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+
+    uint8_t localhost[4] = {127, 0, 0, 1};
+    supl::ServerSession session{fds[0], supl::VERSION_2_1, supl::Identity::ipv4(localhost), 1};
+
+    REQUIRE(session.send(lpp_pos(30000)));
+    REQUIRE(session.wants_write());
+
+    ::close(fds[1]);
+    CHECK_FALSE(session.flush());
+}
@@ -0,0 +1,299 @@
+#include <doctest/doctest.h>
+#include <supl/pos.hpp>
+#include <supl/response.hpp>
+#include <supl/server.hpp>
+#include <supl/session.hpp>
+#include <supl/start.hpp>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <memory>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using Bytes = std::vector<uint8_t>;
+
+static bool wait_readable(int fd) {
+    struct pollfd pfd {};
+    pfd.fd     = fd;
+    pfd.events = POLLIN;
+    return ::poll(&pfd, 1, 1000) == 1;
+}
+
+static void write_all(int fd, Bytes const& bytes) {
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        auto result = ::write(fd, bytes.data() + offset, bytes.size() - offset);
+        REQUIRE(result > 0);
+        offset += static_cast<size_t>(result);
+    }
+}
+
+/// Read one whole ULP PDU from `fd`.
+static Bytes read_pdu(int fd) {
+    Bytes pdu;
+    for (;;) {
+        auto length = supl::Session::pdu_length(pdu.data(), pdu.size());
+        if (length != 0 && pdu.size() >= length) break;
+
+        uint8_t buffer[4096];
+        auto    wanted = length != 0 ? length - pdu.size() : 2 - pdu.size();
+        REQUIRE(wait_readable(fd));
+        auto result = ::read(fd, buffer, std::min(wanted, sizeof(buffer)));
+        REQUIRE(result > 0);
+        pdu.insert(pdu.end(), buffer, buffer + result);
+    }
+    return pdu;
+}
+
+static Bytes concat(Bytes a, Bytes const& b) {
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+static supl::POS lpp_pos(uint8_t value, size_t size) {
+    supl::Payload payload{};
+    payload.type = supl::Payload::Type::LPP;
+    payload.data.assign(size, value);
+
+    supl::POS pos{};
+    pos.payloads.push_back(std::move(payload));
+    return pos;
+}
+
+static bool payload_is(supl::POS const& pos, uint8_t value, size_t size) {
+    if (pos.payloads.size() != 1) return false;
+    auto const& payload = pos.payloads[0];
+    if (payload.size() != size) return false;
+    for (size_t i = 0; i < size; i++) {
+        if (payload.bytes()[i] != value) return false;
+    }
+    return true;
+}
+
+/// A `supl::Session` connected to a raw socket that plays the location server. The messages are
+/// encoded by a `supl::ServerSession` on a socketpair, so the test decides how the octets of each
+/// PDU reach the session.
+struct Connection {
+    supl::Session                        session;
+    int                                  listener = -1;
+    int                                  peer     = -1;
+    int                                  encoder_fds[2]{-1, -1};
+    std::unique_ptr<supl::ServerSession> encoder;
+
+    Connection() : session(supl::VERSION_2_1, supl::Identity::imsi(240010123456789)) {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        REQUIRE(listener >= 0);
+        struct sockaddr_in addr {};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port        = 0;
+        REQUIRE(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+        REQUIRE(::listen(listener, 1) == 0);
+        socklen_t addr_size = sizeof(addr);
+        REQUIRE(::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_size) == 0);
+
+        REQUIRE(session.connect("127.0.0.1", ntohs(addr.sin_port), "", supl::TlsConfig{}));
+        for (int i = 0; i < 100; i++) {
+            auto progress = session.handle_connection();
+            if (progress == supl::Session::ConnectProgress::Done) break;
+            REQUIRE(progress != supl::Session::ConnectProgress::Failed);
+            struct pollfd pfd {};
+            pfd.fd     = session.fd();
+            pfd.events = POLLIN | POLLOUT;
+            ::poll(&pfd, 1, 10);
+        }
+        REQUIRE(session.is_connected());
+        peer = ::accept(listener, nullptr, nullptr);
+        REQUIRE(peer >= 0);
+
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, encoder_fds) == 0);
+        uint8_t localhost[4] = {127, 0, 0, 1};
+        encoder              = std::unique_ptr<supl::ServerSession>(new supl::ServerSession(
+            encoder_fds[0], supl::VERSION_2_1, supl::Identity::ipv4(localhost), 7));
+
+        // The encoder learns the SET session from the START the session sends
+        supl::START start{};
+        auto&       capabilities = start.set_capabilities;
+        capabilities.pos_technology.agps_set_based        = true;
+        capabilities.pref_method                          = supl::PrefMethod::AgpsSETBasedPreferred;
+        capabilities.pos_protocol.lpp.enabled             = true;
+        capabilities.pos_protocol.lpp.major_version_field = 16;
+        start.application_id.name                         = "test";
+        start.location_id.cell                            = supl::Cell::lte(240, 1, 1, 1);
+        REQUIRE(session.handshake(start));
+        write_all(encoder_fds[1], read_pdu(peer));
+        REQUIRE(encoder->fill_receive_buffer());
+        supl::POS unused{};
+        REQUIRE(encoder->try_receive(unused) == supl::ServerSession::Received::START);
+
+        supl::RESPONSE response{};
+        response.pos_method = supl::RESPONSE::PosMethod::AgpsSETBased;
+        REQUIRE(encoder->send(response));
+        write_all(peer, read_pdu(encoder_fds[1]));
+        auto handshake = supl::Session::Handshake::NoData;
+        for (int i = 0; i < 100 && handshake == supl::Session::Handshake::NoData; i++) {
+            wait_readable(session.fd());
+            handshake = session.handle_handshake();
+        }
+        REQUIRE(handshake == supl::Session::Handshake::OK);
+    }
+
+    ~Connection() {
+        encoder.reset();
+        ::close(encoder_fds[1]);
+        ::close(peer);
+        ::close(listener);
+    }
+
+    Bytes encode(supl::POS const& pos) {
+        REQUIRE(encoder->send(pos));
+        return read_pdu(encoder_fds[1]);
+    }
+
+    /// Read what has arrived and try to receive a message.
+    supl::Session::Received receive(supl::POS& pos) {
+        wait_readable(session.fd());
+        REQUIRE(session.fill_receive_buffer());
+        return session.try_receive(nullptr, nullptr, &pos);
+    }
+
+    /// Receive until something other than NoData comes out, the reads may return partial data.
+    supl::Session::Received receive_next(supl::POS& pos) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            auto received = session.try_receive(nullptr, nullptr, &pos);
+            if (received != supl::Session::Received::NoData) return received;
+            if (!wait_readable(session.fd())) continue;
+            REQUIRE(session.fill_receive_buffer());
+        }
+        return supl::Session::Received::NoData;
+    }
+};
+
+TEST_CASE("Session - pdu_length") {
+    uint8_t data[4] = {0x01, 0x02, 0x00, 0x00};
+    CHECK(supl::Session::pdu_length(data, 0) == 0);
+    CHECK(supl::Session::pdu_length(data, 1) == 0);
+    CHECK(supl::Session::pdu_length(data, 2) == 0x0102);
+    CHECK(supl::Session::pdu_length(data, 4) == 0x0102);
+
+    uint8_t max[2] = {0xFF, 0xFF};
+    CHECK(supl::Session::pdu_length(max, 2) == 65535);
+}
+
+TEST_CASE("Session - a PDU split across reads is received once complete") {
+    Connection connection;
+    auto       pdu = connection.encode(lpp_pos(0x11, 3000));
+
+    // Only the first octet of the length field
+    supl::POS pos{};
+    write_all(connection.peer, Bytes(pdu.begin(), pdu.begin() + 1));
+    CHECK(connection.receive(pos) == supl::Session::Received::NoData);
+
+    // The length field but not the whole PDU
+    write_all(connection.peer, Bytes(pdu.begin() + 1, pdu.begin() + 1000));
+    CHECK(connection.receive(pos) == supl::Session::Received::NoData);
+
+    // All but the last octet
+    write_all(connection.peer, Bytes(pdu.begin() + 1000, pdu.end() - 1));
+    CHECK(connection.receive(pos) == supl::Session::Received::NoData);
+
+    write_all(connection.peer, Bytes(pdu.end() - 1, pdu.end()));
+    REQUIRE(connection.receive(pos) == supl::Session::Received::POS);
+    CHECK(payload_is(pos, 0x11, 3000));
+}
+
+TEST_CASE("Session - two PDUs in one read") {
+    Connection connection;
+    auto       first  = connection.encode(lpp_pos(0x11, 100));
+    auto       second = connection.encode(lpp_pos(0x22, 200));
+
+    write_all(connection.peer, concat(first, second));
+
+    supl::POS pos1{};
+    REQUIRE(connection.receive(pos1) == supl::Session::Received::POS);
+    CHECK(payload_is(pos1, 0x11, 100));
+
+    // The second PDU is already buffered
+    supl::POS pos2{};
+    REQUIRE(connection.session.try_receive(nullptr, nullptr, &pos2) ==
+            supl::Session::Received::POS);
+    CHECK(payload_is(pos2, 0x22, 200));
+
+    supl::POS pos3{};
+    CHECK(connection.session.try_receive(nullptr, nullptr, &pos3) ==
+          supl::Session::Received::NoData);
+}
+
+TEST_CASE("Session - a length below the PDU header discards the buffer") {
+    Connection connection;
+    auto       pdu = connection.encode(lpp_pos(0x33, 100));
+
+    // There is no way to find the next PDU, so a PDU read together with the bad length is lost
+    Bytes invalid = {0x00, 0x02, 0xAA, 0xBB};
+    write_all(connection.peer, concat(invalid, pdu));
+    supl::POS pos{};
+    CHECK(connection.receive(pos) == supl::Session::Received::NoData);
+    CHECK(connection.session.try_receive(nullptr, nullptr, &pos) ==
+          supl::Session::Received::NoData);
+
+    // The stream continues with the next PDU
+    write_all(connection.peer, pdu);
+    REQUIRE(connection.receive(pos) == supl::Session::Received::POS);
+    CHECK(payload_is(pos, 0x33, 100));
+}
+
+TEST_CASE("Session - a length larger than what has been read") {
+    Connection connection;
+    auto       pdu = connection.encode(lpp_pos(0x44, 100));
+
+    // The largest length the field can hold still fits in the receive buffer, the session waits
+    // for all of it, fails to decode it and continues with the PDU after it
+    Bytes garbage(65535, 0xFF);
+    write_all(connection.peer, Bytes(garbage.begin(), garbage.begin() + 1000));
+    supl::POS pos{};
+    CHECK(connection.receive(pos) == supl::Session::Received::NoData);
+
+    write_all(connection.peer, concat(Bytes(garbage.begin() + 1000, garbage.end()), pdu));
+    auto received = connection.receive_next(pos);
+    if (received != supl::Session::Received::POS) {
+        // The garbage may decode to some other message, which is skipped
+        received = connection.receive_next(pos);
+    }
+    REQUIRE(received == supl::Session::Received::POS);
+    CHECK(payload_is(pos, 0x44, 100));
+}
+
+TEST_CASE("Session - POS payloads stay valid after the receive buffer is reused") {
+    supl::POS kept{};
+    {
+        Connection connection;
+        auto       first  = connection.encode(lpp_pos(0x55, 2000));
+        auto       second = connection.encode(lpp_pos(0x66, 2000));
+
+        write_all(connection.peer, first);
+        REQUIRE(connection.receive(kept) == supl::Session::Received::POS);
+        REQUIRE(kept.pdu != nullptr);
+        REQUIRE(kept.payloads.size() == 1);
+        CHECK(kept.payloads[0].view != nullptr);
+        CHECK(kept.payloads[0].data.empty());
+
+        // The second PDU is read into the same part of the receive buffer
+        write_all(connection.peer, second);
+        supl::POS pos{};
+        REQUIRE(connection.receive(pos) == supl::Session::Received::POS);
+        CHECK(payload_is(pos, 0x66, 2000));
+        CHECK(pos.payloads[0].view != kept.payloads[0].view);
+        CHECK(payload_is(kept, 0x55, 2000));
+    }
+
+    // The view is kept alive by `pdu` alone, also after the session is gone
+    supl::POS copy = kept;
+    kept           = supl::POS{};
+    CHECK(payload_is(copy, 0x55, 2000));
+}